@@ -0,0 +1,407 @@
+/**
+ * Engine hot-path benchmarks.
+ *
+ * One JSON object per line on stdout, so runs can be diffed and tracked
+ * across releases:
+ *
+ *     {"suite":"tick","case":"native","n":64,"iterations":31250,"ns_per_op":812.4}
+ *
+ * Suites: tick (fan-out guards, native vs script), sync (script variable
+ * sync with N inputs), codec (v1 vs v2 per message type), load (YAML vs
+ * artifact, reference automata under tests/data).
+ *
+ * Usage: aetherium_bench [--filter <suite>] [--data <dir>]
+ */
+
+#include "engine/core/engine.hpp"
+#include "engine/core/protocol_v2.hpp"
+
+#if !defined(AETHERIUM_DISABLE_YAML_FRONTEND)
+#include "engine/core/automata_loader.hpp"
+#include "engine/core/bytecode_compiler.hpp"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef AETHERIUM_BENCH_DATA_DIR
+#define AETHERIUM_BENCH_DATA_DIR "tests/data"
+#endif
+
+namespace {
+
+using namespace aeth;
+
+#if defined(AETHERIUM_DISABLE_LUA_SCRIPT_ENGINE)
+constexpr const char* kScriptName = "simple";
+#else
+constexpr const char* kScriptName = "lua";
+#endif
+
+class FixedClock : public IClock {
+public:
+    Timestamp now() override { return 1000; }
+    void sleep(uint32_t) override {}
+};
+
+[[noreturn]] void fail(const std::string& what) {
+    std::fprintf(stderr, "[FAIL] %s\n", what.c_str());
+    std::exit(1);
+}
+
+void emit(const char* suite, const std::string& name, size_t n, size_t iterations, double ns,
+          const std::string& extra = {}) {
+    std::printf("{\"suite\":\"%s\",\"case\":\"%s\",\"n\":%zu,\"iterations\":%zu,\"ns_per_op\":%.1f%s}\n",
+                suite, name.c_str(), n, iterations, ns, extra.c_str());
+    std::fflush(stdout);
+}
+
+double nsPerOp(size_t iterations, const std::function<void()>& op) {
+    for (size_t i = 0; i < iterations / 10; ++i) {
+        op();
+    }
+    const auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        op();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+           static_cast<double>(iterations);
+}
+
+std::unique_ptr<Runtime> startRuntime(const Automata& automata, bool nativeGuards) {
+    auto runtime = std::make_unique<Runtime>(std::make_unique<FixedClock>(), std::make_unique<StdRandomSource>(1),
+                                             makeDefaultScriptEngine());
+    runtime->setNativeGuards(nativeGuards);
+    if (runtime->load(automata).isError() || runtime->start().isError()) {
+        fail(automata.config.name + " did not start");
+    }
+    return runtime;
+}
+
+// ============================================================================
+// tick: one state with N guarded transitions that never fire
+// ============================================================================
+
+Automata makeFanOut(size_t outgoing) {
+    Automata automata;
+    automata.config.name = "tick-bench";
+    automata.addVariable(VariableSpec(1, "level", ValueType::Int32, VariableDirection::Input, Value(int32_t{0})));
+    automata.addState(State(1, "Source"));
+    automata.addState(State(2, "Sink"));
+    automata.initialState = 1;
+    for (size_t i = 0; i < outgoing; ++i) {
+        Transition t(static_cast<TransitionId>(i + 1), "t" + std::to_string(i), 1, 2);
+        t.type = TransitionType::Classic;
+        t.classicConfig.condition.source = "value(\"level\") > " + std::to_string(1000 + i);
+        automata.addTransition(t);
+    }
+    return automata;
+}
+
+void benchTick() {
+    for (size_t outgoing : {1, 8, 64, 512}) {
+        const Automata automata = makeFanOut(outgoing);
+        for (bool native : {true, false}) {
+            auto runtime = startRuntime(automata, native);
+            if (native && runtime->nativeGuardCount() != outgoing) {
+                fail("tick guards did not compile natively");
+            }
+            const size_t iterations = std::max<size_t>(500, (native ? 4000000 : 400000) / outgoing);
+            int32_t level = 0;
+            const double ns = nsPerOp(iterations, [&] {
+                (void)runtime->setInput(VariableId{1}, Value(level++ % 1000));
+                if (runtime->tick()) {
+                    fail("tick guard fired");
+                }
+            });
+            emit("tick", native ? "native" : kScriptName, outgoing, iterations, ns);
+        }
+    }
+}
+
+// ============================================================================
+// sync: N inputs written every tick, read by one script guard
+// ============================================================================
+
+void benchSync() {
+    for (size_t count : {1, 16, 128}) {
+        Automata automata;
+        automata.config.name = "sync-bench";
+        std::vector<VariableUpdate> inputs;
+        for (size_t i = 0; i < count; ++i) {
+            const auto id = static_cast<VariableId>(i + 1);
+            automata.addVariable(VariableSpec(id, "v" + std::to_string(i), ValueType::Int32,
+                                              VariableDirection::Input, Value(int32_t{0})));
+            inputs.push_back(VariableUpdate{id, Value(int32_t{0})});
+        }
+        automata.addState(State(1, "Source"));
+        automata.addState(State(2, "Sink"));
+        automata.initialState = 1;
+        Transition t(1, "never", 1, 2);
+        t.type = TransitionType::Classic;
+        t.classicConfig.condition.source = "value(\"v0\") < 0";
+        automata.addTransition(t);
+
+        auto runtime = startRuntime(automata, false);
+        const size_t iterations = std::max<size_t>(500, 200000 / count);
+        int32_t next = 0;
+        uint64_t synced = 0;
+        const double ns = nsPerOp(iterations, [&] {
+            ++next;
+            for (auto& input : inputs) {
+                input.value = Value(next);
+            }
+            (void)runtime->setInputs(inputs);
+            runtime->tick();
+            synced += runtime->context().scriptValuesSynced;
+        });
+        std::ostringstream extra;
+        extra << ",\"synced_per_tick\":"
+              << static_cast<double>(synced) / static_cast<double>(iterations + iterations / 10);
+        emit("sync", kScriptName, count, iterations, ns, extra.str());
+    }
+}
+
+// ============================================================================
+// codec: the same message through both wire protocols
+// ============================================================================
+
+struct CodecSample {
+    const char* name;
+    std::unique_ptr<protocol::Message> v1;
+    protocolv2::Frame v2;
+};
+
+template <typename T>
+std::unique_ptr<T> stamped() {
+    auto msg = std::make_unique<T>();
+    msg->messageId = 4242;
+    msg->sourceId = 7;
+    msg->targetId = 1;
+    return msg;
+}
+
+protocolv2::Frame frame(protocol::MessageType type, protocolv2::Payload payload, bool withRun = true) {
+    protocolv2::Frame f;
+    f.type = type;
+    f.messageId = 4242;
+    f.sourceId = 7;
+    f.targetId = 1;
+    if (withRun) {
+        f.runId = 3;
+    }
+    f.payload = std::move(payload);
+    return f;
+}
+
+std::vector<CodecSample> makeCodecSamples() {
+    using protocol::MessageType;
+    std::vector<CodecSample> samples;
+
+    auto hello = stamped<protocol::HelloMessage>();
+    hello->deviceType = protocol::DeviceType::Desktop;
+    hello->versionMajor = 1;
+    hello->name = "bench-device";
+    samples.push_back({"hello", std::move(hello),
+                       frame(MessageType::Hello,
+                             protocolv2::HelloPayload{protocol::DeviceType::Desktop, 1, 0, 0, 0, "bench-device"},
+                             false)});
+
+    auto ping = stamped<protocol::PingMessage>();
+    ping->timestamp = 123456;
+    ping->sequenceNumber = 9;
+    samples.push_back({"ping", std::move(ping), frame(MessageType::Ping, protocolv2::PingPayload{123456, 9}, false)});
+
+    auto status = stamped<protocol::StatusMessage>();
+    status->runId = 3;
+    status->executionState = ExecutionState::Running;
+    status->currentState = 2;
+    status->tickCount = 100000;
+    status->transitionCount = 420;
+    protocolv2::StatusPayload statusPayload;
+    statusPayload.executionState = ExecutionState::Running;
+    statusPayload.currentState = 2;
+    statusPayload.tickCount = 100000;
+    statusPayload.transitionCount = 420;
+    samples.push_back({"status", std::move(status), frame(MessageType::Status, statusPayload)});
+
+    auto input = stamped<protocol::InputMessage>();
+    input->runId = 3;
+    input->variableId = 4;
+    input->variableName = "temperature";
+    input->value = Value(21.5);
+    samples.push_back({"input", std::move(input),
+                       frame(MessageType::Input, protocolv2::VariablePayload{4, "temperature", Value(21.5), 0})});
+
+    auto output = stamped<protocol::OutputMessage>();
+    output->runId = 3;
+    output->variableId = 5;
+    output->variableName = "fan_speed";
+    output->value = Value(int32_t{1200});
+    output->timestamp = 123456;
+    samples.push_back({"output", std::move(output),
+                       frame(MessageType::Output,
+                             protocolv2::VariablePayload{5, "fan_speed", Value(int32_t{1200}), 123456})});
+
+    auto change = stamped<protocol::StateChangeMessage>();
+    change->runId = 3;
+    change->previousState = 1;
+    change->newState = 2;
+    change->firedTransition = 7;
+    change->timestamp = 123456;
+    samples.push_back({"state_change", std::move(change),
+                       frame(MessageType::StateChange, protocolv2::StateChangePayload{1, 2, 7, 123456})});
+
+    auto telemetry = stamped<protocol::TelemetryMessage>();
+    telemetry->runId = 3;
+    telemetry->heapFree = 1 << 20;
+    telemetry->tickRate = 1000;
+    protocolv2::TelemetryPayload telemetryPayload;
+    telemetryPayload.heapFree = 1 << 20;
+    telemetryPayload.tickRate = 1000;
+    for (VariableId id = 0; id < 8; ++id) {
+        telemetry->variableSnapshot.emplace_back(id, Value(static_cast<double>(id) * 0.5));
+        telemetryPayload.variableSnapshot.emplace_back(id, Value(static_cast<double>(id) * 0.5));
+    }
+    samples.push_back({"telemetry", std::move(telemetry), frame(MessageType::Telemetry, telemetryPayload)});
+
+    auto debug = stamped<protocol::DebugMessage>();
+    debug->source = "engine";
+    debug->message = "tick overrun by 3ms";
+    protocolv2::DebugPayload debugPayload;
+    debugPayload.source = "engine";
+    debugPayload.message = "tick overrun by 3ms";
+    samples.push_back({"debug", std::move(debug), frame(MessageType::Debug, debugPayload, false)});
+
+    auto ack = stamped<protocol::AckMessage>();
+    ack->relatedMessageId = 99;
+    ack->info = "ok";
+    samples.push_back({"ack", std::move(ack), frame(MessageType::Ack, protocolv2::AckPayload{99, "ok"}, false)});
+
+    return samples;
+}
+
+void benchCodec() {
+    for (const auto& sample : makeCodecSamples()) {
+        const std::vector<uint8_t> v1Frame = sample.v1->serialize();
+        auto v2Encoded = protocolv2::ProtocolCodecV2::encode(sample.v2);
+        if (!protocol::MessageFactory::deserialize(v1Frame) || v2Encoded.isError() ||
+            protocolv2::ProtocolCodecV2::decode(v2Encoded.value()).isError()) {
+            fail(std::string("codec ") + sample.name + " does not round-trip");
+        }
+        const std::vector<uint8_t>& v2Frame = v2Encoded.value();
+        const size_t iterations = std::max<size_t>(2000, 200000000 / (std::max(v1Frame.size(), v2Frame.size()) * 64));
+        size_t sink = 0;
+
+        // n is the frame size in bytes
+        const std::string name = sample.name;
+        emit("codec", "v1_encode/" + name, v1Frame.size(), iterations,
+             nsPerOp(iterations, [&] { sink += sample.v1->serialize().size(); }));
+        emit("codec", "v1_decode/" + name, v1Frame.size(), iterations, nsPerOp(iterations, [&] {
+                 sink += protocol::MessageFactory::deserialize(v1Frame.data(), v1Frame.size()) != nullptr;
+             }));
+        emit("codec", "v2_encode/" + name, v2Frame.size(), iterations, nsPerOp(iterations, [&] {
+                 auto encoded = protocolv2::ProtocolCodecV2::encode(sample.v2);
+                 sink += encoded.isOk() ? encoded.value().size() : 0;
+             }));
+        emit("codec", "v2_decode/" + name, v2Frame.size(), iterations, nsPerOp(iterations, [&] {
+                 sink += protocolv2::ProtocolCodecV2::decode(v2Frame.data(), v2Frame.size()).isOk();
+             }));
+        if (sink == 0) {
+            fail(std::string("codec ") + sample.name + " produced nothing");
+        }
+    }
+}
+
+// ============================================================================
+// load: reference automata from YAML text and from a compiled artifact
+// ============================================================================
+
+void benchLoad(const std::string& dataDir) {
+#if defined(AETHERIUM_DISABLE_YAML_FRONTEND)
+    (void)dataDir;
+    std::fprintf(stderr, "[SKIP] load: built without the YAML frontend\n");
+#else
+    for (const char* file : {"bench_line.yaml", "bench_fanout.yaml"}) {
+        const std::string path = dataDir + "/" + file;
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            fail("cannot read " + path);
+        }
+        std::stringstream text;
+        text << in.rdbuf();
+        const std::string yaml = text.str();
+
+        AutomataLoader loader;
+        auto parsed = loader.loadFromString(yaml, dataDir, path);
+        if (parsed.isError() || !parsed.value().success()) {
+            fail(path + " does not load");
+        }
+        auto artifact = compileDeployArtifact(*parsed.value().automata, path);
+        auto bytes = artifact.isOk() ? ir::serializeArtifact(artifact.value())
+                                     : Result<std::vector<uint8_t>>::error(artifact.error());
+        if (bytes.isError()) {
+            fail(path + " does not compile: " + bytes.error());
+        }
+
+        Engine engine;
+        if (engine.initialize().isError()) {
+            fail("engine initialize failed");
+        }
+        // n is the input size in bytes
+        const size_t iterations = 200;
+        emit("load", std::string("yaml/") + file, yaml.size(), iterations, nsPerOp(iterations, [&] {
+                 if (engine.loadAutomataFromYaml(yaml, dataDir, protocolv2::LoadReplaceMode::HardReset).isError()) {
+                     fail(path + " YAML load failed");
+                 }
+             }));
+        emit("load", std::string("artifact/") + file, bytes.value().size(), iterations, nsPerOp(iterations, [&] {
+                 if (engine.loadAutomataFromBytes(bytes.value(), protocolv2::LoadReplaceMode::HardReset).isError()) {
+                     fail(path + " artifact load failed");
+                 }
+             }));
+    }
+#endif
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string filter;
+    std::string dataDir = AETHERIUM_BENCH_DATA_DIR;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--data") == 0 && i + 1 < argc) {
+            dataDir = argv[++i];
+        } else {
+            std::fprintf(stderr, "usage: %s [--filter tick|sync|codec|load] [--data <dir>]\n", argv[0]);
+            return 2;
+        }
+    }
+    const auto selected = [&](const char* suite) { return filter.empty() || filter == suite; };
+
+    if (selected("tick")) {
+        benchTick();
+    }
+    if (selected("sync")) {
+        benchSync();
+    }
+    if (selected("codec")) {
+        benchCodec();
+    }
+    if (selected("load")) {
+        benchLoad(dataDir);
+    }
+    return 0;
+}
@@ -0,0 +1,550 @@
+/**
+ * Load generator: how many messages per second one Engine takes before
+ * latency leaves the budget.
+ *
+ * Sends an open-loop stream (fixed schedule, so a slow engine builds a
+ * backlog instead of slowing the sender) of input / variable / status /
+ * ping commands, either straight through enqueueCommand/processCommandQueue
+ * or over a loopback WebSocketTransport, and reports p50/p99/p999 of:
+ *
+ *     ingress      command handled - received        (TraceRecord timestamps)
+ *     transition   state change - input received     (TraceRecord timestamps)
+ *     outbound     message sent - command received   (replies, and state
+ *                                                     changes from an input)
+ *     end_to_end   reply seen by the sender - scheduled send
+ *
+ * The engine runs on a microsecond clock with virtualTime, so every trace
+ * timestamp above is in µs. Timed transitions then run 1000x fast; the
+ * default automaton (tests/data/bench_fanout.yaml) has none. Status
+ * replies carry no request id and are only counted.
+ *
+ * One JSON object per run on stdout. --find-max raises the rate until the
+ * end_to_end p99 exceeds --budget-us or the engine falls behind, then
+ * bisects to the highest rate that still holds.
+ */
+
+#include "engine/core/engine.hpp"
+#include "engine/core/websocket_transport.hpp"
+
+#include <ixwebsocket/IXWebSocketServer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef AETHERIUM_BENCH_DATA_DIR
+#define AETHERIUM_BENCH_DATA_DIR "tests/data"
+#endif
+
+namespace {
+
+using namespace aeth;
+
+uint64_t steadyUs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// The engine clock: trace timestamps in µs
+class MicrosecondClock : public IClock {
+public:
+    Timestamp now() override { return steadyUs(); }
+    void sleep(uint32_t ms) override { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+};
+
+enum class Kind : uint8_t { Input, Variable, Status, Ping };
+constexpr size_t kKinds = 4;
+constexpr const char* kKindNames[kKinds] = {"input", "variable", "status", "ping"};
+
+struct Options {
+    std::string automaton = std::string(AETHERIUM_BENCH_DATA_DIR) + "/bench_fanout.yaml";
+    bool websocket = false;
+    int port = 18765;
+    uint32_t rate = 5000;        // Messages per second
+    uint32_t durationMs = 2000;
+    uint32_t weights[kKinds] = {70, 10, 10, 10};
+    std::string input = "level";      // Input messages write this (int, cycling 0..3199)
+    std::string variable = "armed";   // Variable messages write true to this (not an input)
+    uint64_t seed = 1;
+    uint64_t budgetUs = 1000;
+    bool findMax = false;
+};
+
+struct Samples {
+    std::vector<uint64_t> us;
+
+    void add(uint64_t value) { us.push_back(value); }
+
+    [[nodiscard]] std::string json() {
+        std::sort(us.begin(), us.end());
+        const auto at = [this](double q) {
+            return us.empty() ? 0 : us[std::min(us.size() - 1, static_cast<size_t>(q * static_cast<double>(us.size())))];
+        };
+        std::ostringstream out;
+        out << "{\"count\":" << us.size() << ",\"p50\":" << at(0.5) << ",\"p99\":" << at(0.99)
+            << ",\"p999\":" << at(0.999) << ",\"max\":" << (us.empty() ? 0 : us.back()) << "}";
+        return out.str();
+    }
+
+    [[nodiscard]] uint64_t p99() {
+        std::sort(us.begin(), us.end());
+        return us.empty() ? 0 : us[std::min(us.size() - 1, static_cast<size_t>(0.99 * static_cast<double>(us.size())))];
+    }
+};
+
+struct RunStats {
+    uint32_t rate = 0;
+    size_t sent = 0;
+    size_t answered = 0;
+    size_t naks = 0;
+    size_t perKind[kKinds] = {};
+    uint64_t elapsedUs = 0;
+    Samples ingress;
+    Samples transition;
+    Samples outbound;
+    Samples endToEnd;
+
+    [[nodiscard]] double achievedRate() const {
+        return elapsedUs > 0 ? static_cast<double>(sent) * 1e6 / static_cast<double>(elapsedUs) : 0.0;
+    }
+};
+
+[[noreturn]] void fail(const std::string& what) {
+    std::fprintf(stderr, "[FAIL] %s\n", what.c_str());
+    std::exit(1);
+}
+
+/**
+ * Turns the engine's trace records into the three engine-side latencies.
+ * Runs on the engine thread, in record order.
+ */
+class TraceLatencies {
+public:
+    explicit TraceLatencies(RunStats& stats) : stats_(stats) {}
+
+    void operator()(const TraceRecord& record) {
+        if (record.kind == "ingress_command" && record.handleTimestamp && record.receiveTimestamp &&
+            record.summary == "command handled") {
+            stats_.ingress.add(*record.handleTimestamp - *record.receiveTimestamp);
+            // Input handlers tick inline; state changes until the next command are its doing
+            handlingInput_ = record.messageType == inputType_;
+            handledReceive_ = *record.receiveTimestamp;
+        } else if (record.kind == "runtime_state_change" && handlingInput_ && record.handleTimestamp) {
+            stats_.transition.add(*record.handleTimestamp - handledReceive_);
+            stateChangeInputs_.push_back(handledReceive_);
+        } else if (record.kind == "egress_message" && record.summary == "message sent" && record.sendTimestamp) {
+            if (record.receiveTimestamp) {
+                stats_.outbound.add(*record.sendTimestamp - *record.receiveTimestamp);
+            } else if (record.messageType == stateChangeType_ && !stateChangeInputs_.empty()) {
+                stats_.outbound.add(*record.sendTimestamp - stateChangeInputs_.front());
+                stateChangeInputs_.pop_front();
+            }
+        }
+    }
+
+private:
+    RunStats& stats_;
+    const std::string inputType_ = LocalTraceStore::messageTypeName(protocol::MessageType::Input);
+    const std::string stateChangeType_ = LocalTraceStore::messageTypeName(protocol::MessageType::StateChange);
+    bool handlingInput_ = false;
+    Timestamp handledReceive_ = 0;
+    std::deque<Timestamp> stateChangeInputs_;  // Receive time of the input behind each pending state change
+};
+
+/**
+ * Deterministic message stream: message i (id i + 1) is due at
+ * start + i / rate and its kind is drawn from the weighted mix.
+ */
+class Schedule {
+public:
+    Schedule(const Options& options, uint32_t rate) : options_(options), rate_(rate) {
+        const uint64_t total = static_cast<uint64_t>(rate) * options.durationMs / 1000;
+        std::mt19937_64 rng(options.seed);
+        uint32_t sum = 0;
+        for (uint32_t w : options.weights) {
+            sum += w;
+        }
+        kinds_.reserve(total);
+        for (uint64_t i = 0; i < total; ++i) {
+            uint32_t pick = static_cast<uint32_t>(rng() % sum);
+            size_t k = 0;
+            while (pick >= options.weights[k]) {
+                pick -= options.weights[k++];
+            }
+            kinds_.push_back(static_cast<Kind>(k));
+        }
+        answered_.assign(total, false);
+    }
+
+    [[nodiscard]] size_t size() const { return kinds_.size(); }
+    [[nodiscard]] Kind kind(size_t i) const { return kinds_[i]; }
+    [[nodiscard]] uint64_t dueUs(size_t i) const { return startUs_ + i * 1000000ull / rate_; }
+    void start(uint64_t nowUs) { startUs_ = nowUs; }
+
+    [[nodiscard]] std::unique_ptr<protocol::Message> build(size_t i) const {
+        std::unique_ptr<protocol::Message> msg;
+        switch (kinds_[i]) {
+            case Kind::Input: {
+                auto input = std::make_unique<protocol::InputMessage>();
+                input->variableName = options_.input;
+                input->value = Value(static_cast<int32_t>((i * 97) % 3200));
+                msg = std::move(input);
+                break;
+            }
+            case Kind::Variable: {
+                auto variable = std::make_unique<protocol::VariableMessage>();
+                variable->variableName = options_.variable;
+                variable->value = Value(true);
+                msg = std::move(variable);
+                break;
+            }
+            case Kind::Status:
+                msg = std::make_unique<protocol::StatusMessage>();
+                break;
+            case Kind::Ping: {
+                auto ping = std::make_unique<protocol::PingMessage>();
+                ping->timestamp = dueUs(i);
+                ping->sequenceNumber = static_cast<uint32_t>(i + 1);
+                msg = std::move(ping);
+                break;
+            }
+        }
+        msg->messageId = static_cast<uint32_t>(i + 1);
+        msg->sourceId = 2;
+        return msg;
+    }
+
+    // Record the first reply to a request: end-to-end latency and naks
+    void answer(const protocol::Message& reply, uint64_t nowUs, RunStats& stats) {
+        uint32_t id = 0;
+        switch (reply.type()) {
+            case protocol::MessageType::Ack:
+                id = static_cast<const protocol::AckMessage&>(reply).relatedMessageId;
+                break;
+            case protocol::MessageType::Nak:
+                id = static_cast<const protocol::NakMessage&>(reply).relatedMessageId;
+                ++stats.naks;
+                break;
+            case protocol::MessageType::Pong:
+                id = static_cast<const protocol::PongMessage&>(reply).sequenceNumber;
+                break;
+            default:
+                return;
+        }
+        if (id == 0 || id > answered_.size() || answered_[id - 1]) {
+            return;
+        }
+        answered_[id - 1] = true;
+        ++stats.answered;
+        const uint64_t due = dueUs(id - 1);
+        stats.endToEnd.add(nowUs > due ? nowUs - due : 0);
+    }
+
+private:
+    const Options& options_;
+    uint32_t rate_;
+    uint64_t startUs_ = 0;
+    std::vector<Kind> kinds_;
+    std::vector<bool> answered_;
+};
+
+std::unique_ptr<Engine> startEngine(const Options& options) {
+    auto engine = std::make_unique<Engine>(std::make_unique<MicrosecondClock>(),
+                                           std::make_unique<StdRandomSource>(options.seed), makeDefaultScriptEngine());
+    EngineInitOptions init;
+    init.virtualTime = true;    // Stamp traces from the µs runtime clock
+    init.traceCapacity = 1024;  // The observer sees every record; keep little
+    if (auto result = engine->initialize(init); result.isError()) {
+        fail("initialize: " + result.error());
+    }
+    if (auto load = engine->loadAutomataFromFile(options.automaton, protocolv2::LoadReplaceMode::HardReset, true);
+        load.isError()) {
+        fail(options.automaton + ": " + load.error());
+    }
+    return engine;
+}
+
+// ============================================================================
+// Direct: the sender and the engine share one thread
+// ============================================================================
+
+RunStats runDirect(const Options& options, uint32_t rate) {
+    RunStats stats;
+    stats.rate = rate;
+    Schedule schedule(options, rate);
+    auto engine = startEngine(options);
+    engine->setTraceObserver(TraceLatencies(stats));
+
+    size_t next = 0;
+    schedule.start(steadyUs());
+    const auto answer = [&] {
+        auto replies = engine->processCommandQueue();
+        const uint64_t seen = steadyUs();
+        for (const auto& reply : replies) {
+            if (reply) {
+                schedule.answer(*reply, seen, stats);
+            }
+        }
+        return !replies.empty();
+    };
+    while (next < schedule.size()) {
+        const uint64_t now = steadyUs();
+        while (next < schedule.size() && schedule.dueUs(next) <= now) {
+            ++stats.perKind[static_cast<size_t>(schedule.kind(next))];
+            engine->enqueueCommand(schedule.build(next++));
+        }
+        answer();
+        if (next < schedule.size() && schedule.dueUs(next) > steadyUs() + 50) {
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+    }
+    while (answer()) {
+    }
+    stats.sent = next;
+    stats.elapsedUs = steadyUs() - schedule.dueUs(0);
+    engine->setTraceObserver(nullptr);
+    return stats;
+}
+
+// ============================================================================
+// WebSocket: the sender is a loopback server, the engine a client thread
+// ============================================================================
+
+RunStats runWebSocket(const Options& options, uint32_t rate) {
+    RunStats stats;
+    stats.rate = rate;
+    Schedule schedule(options, rate);
+
+    std::mutex answerMutex;  // Server callbacks vs. the final read
+    std::atomic<ix::WebSocket*> peer{nullptr};
+    ix::WebSocketServer server(options.port, "127.0.0.1");
+    server.disablePerMessageDeflate();
+    server.setOnClientMessageCallback(
+        [&](std::shared_ptr<ix::ConnectionState>, ix::WebSocket& socket, const ix::WebSocketMessagePtr& msg) {
+            if (msg->type == ix::WebSocketMessageType::Open) {
+                peer.store(&socket);
+            } else if (msg->type == ix::WebSocketMessageType::Close) {
+                peer.store(nullptr);
+            } else if (msg->type == ix::WebSocketMessageType::Message && msg->binary) {
+                const uint64_t seen = steadyUs();
+                auto reply = protocol::MessageFactory::deserialize(
+                    reinterpret_cast<const uint8_t*>(msg->str.data()), msg->str.size());
+                if (reply) {
+                    std::lock_guard<std::mutex> lock(answerMutex);
+                    schedule.answer(*reply, seen, stats);
+                }
+            }
+        });
+    auto listening = server.listen();
+    if (!listening.first) {
+        fail("listen on port " + std::to_string(options.port) + ": " + listening.second);
+    }
+    server.start();
+
+    auto engine = startEngine(options);
+    engine->setTraceObserver(TraceLatencies(stats));  // Engine thread only
+    WebSocketTransport transport("ws://127.0.0.1:" + std::to_string(options.port));
+    if (auto connected = transport.connect(); connected.isError() || !transport.isConnected()) {
+        fail("loopback transport did not connect");
+    }
+    while (!peer.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::atomic<bool> stop{false};
+    std::thread engineThread([&] {
+        while (!stop.load(std::memory_order_relaxed)) {
+            transport.drain([&](std::unique_ptr<protocol::Message> message) {
+                engine->enqueueCommand(std::move(message));
+            }, WebSocketTransport::INGRESS_CAPACITY);
+            for (auto& reply : engine->processCommandQueue()) {
+                if (reply) {
+                    transport.send(std::move(reply));
+                }
+            }
+            transport.waitForMessage(std::chrono::microseconds(200));
+        }
+    });
+
+    protocol::ByteWriter writer;
+    std::string frame;
+    schedule.start(steadyUs());
+    for (size_t i = 0; i < schedule.size(); ++i) {
+        const uint64_t due = schedule.dueUs(i);
+        while (steadyUs() < due) {
+            if (due - steadyUs() > 100) {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+        ++stats.perKind[static_cast<size_t>(schedule.kind(i))];
+        writer.clear();
+        schedule.build(i)->serializeInto(writer);
+        frame.assign(reinterpret_cast<const char*>(writer.data()), writer.size());
+        if (ix::WebSocket* socket = peer.load()) {
+            socket->sendBinary(frame);
+        }
+        stats.sent = i + 1;
+    }
+
+    // Give the backlog a bounded time to drain
+    const size_t answerable = stats.sent - stats.perKind[static_cast<size_t>(Kind::Status)];
+    const uint64_t deadline = steadyUs() + 2000000;
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(answerMutex);
+            if (stats.answered >= answerable) {
+                break;
+            }
+        }
+        if (steadyUs() > deadline) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    stats.elapsedUs = steadyUs() - schedule.dueUs(0);
+    stop.store(true);
+    engineThread.join();
+    engine->setTraceObserver(nullptr);
+    transport.disconnect();
+    server.stop();
+    std::lock_guard<std::mutex> lock(answerMutex);
+    return stats;
+}
+
+RunStats run(const Options& options, uint32_t rate) {
+    return options.websocket ? runWebSocket(options, rate) : runDirect(options, rate);
+}
+
+void report(const Options& options, RunStats& stats) {
+    std::ostringstream mix;
+    for (size_t k = 0; k < kKinds; ++k) {
+        mix << (k ? "," : "") << "\"" << kKindNames[k] << "\":" << stats.perKind[k];
+    }
+    std::printf("{\"mode\":\"%s\",\"rate\":%u,\"achieved\":%.1f,\"sent\":%zu,\"answered\":%zu,\"naks\":%zu,"
+                "\"mix\":{%s},\"ingress_us\":%s,\"transition_us\":%s,\"outbound_us\":%s,\"end_to_end_us\":%s}\n",
+                options.websocket ? "websocket" : "direct", stats.rate, stats.achievedRate(), stats.sent,
+                stats.answered, stats.naks, mix.str().c_str(), stats.ingress.json().c_str(),
+                stats.transition.json().c_str(), stats.outbound.json().c_str(), stats.endToEnd.json().c_str());
+    std::fflush(stdout);
+}
+
+bool holds(const Options& options, RunStats& stats) {
+    const size_t answerable = stats.sent - stats.perKind[static_cast<size_t>(Kind::Status)];
+    return stats.answered >= answerable && stats.endToEnd.p99() <= options.budgetUs &&
+           stats.achievedRate() >= 0.95 * static_cast<double>(stats.rate);
+}
+
+bool parseMix(const std::string& text, uint32_t (&weights)[kKinds]) {
+    uint32_t parsed[kKinds] = {};
+    std::stringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        const auto eq = item.find('=');
+        if (eq == std::string::npos) {
+            return false;
+        }
+        const std::string key = item.substr(0, eq);
+        size_t k = 0;
+        while (k < kKinds && key != kKindNames[k]) {
+            ++k;
+        }
+        if (k == kKinds) {
+            return false;
+        }
+        parsed[k] = static_cast<uint32_t>(std::strtoul(item.c_str() + eq + 1, nullptr, 10));
+    }
+    uint32_t sum = 0;
+    for (size_t k = 0; k < kKinds; ++k) {
+        weights[k] = parsed[k];
+        sum += parsed[k];
+    }
+    return sum > 0;
+}
+
+int usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "usage: %s [--websocket] [--port N] [--rate MSG_PER_S] [--duration MS]\n"
+                 "          [--mix input=70,variable=10,status=10,ping=10] [--automaton FILE]\n"
+                 "          [--input NAME] [--variable NAME] [--seed N] [--budget-us US] [--find-max]\n",
+                 argv0);
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--websocket") {
+            options.websocket = true;
+        } else if (arg == "--find-max") {
+            options.findMax = true;
+        } else if (arg == "--port" && hasValue) {
+            options.port = std::atoi(argv[++i]);
+        } else if (arg == "--rate" && hasValue) {
+            options.rate = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--duration" && hasValue) {
+            options.durationMs = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--mix" && hasValue) {
+            if (!parseMix(argv[++i], options.weights)) {
+                return usage(argv[0]);
+            }
+        } else if (arg == "--automaton" && hasValue) {
+            options.automaton = argv[++i];
+        } else if (arg == "--input" && hasValue) {
+            options.input = argv[++i];
+        } else if (arg == "--variable" && hasValue) {
+            options.variable = argv[++i];
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--budget-us" && hasValue) {
+            options.budgetUs = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (options.rate == 0 || options.durationMs == 0) {
+        return usage(argv[0]);
+    }
+
+    if (!options.findMax) {
+        RunStats stats = run(options, options.rate);
+        report(options, stats);
+        return 0;
+    }
+
+    // Double until it breaks, then bisect between the last rate that held and the first that did not
+    uint32_t good = 0;
+    uint32_t bad = 0;
+    for (uint32_t rate = options.rate; rate <= 50000000u; rate *= 2) {
+        RunStats stats = run(options, rate);
+        report(options, stats);
+        if (!holds(options, stats)) {
+            bad = rate;
+            break;
+        }
+        good = rate;
+    }
+    for (int step = 0; step < 5 && good > 0 && bad > good + good / 50; ++step) {
+        const uint32_t rate = good + (bad - good) / 2;
+        RunStats stats = run(options, rate);
+        report(options, stats);
+        (holds(options, stats) ? good : bad) = rate;
+    }
+    std::printf("{\"mode\":\"%s\",\"max_rate\":%u,\"budget_us\":%llu}\n", options.websocket ? "websocket" : "direct",
+                good, static_cast<unsigned long long>(options.budgetUs));
+    return good > 0 ? 0 : 1;
+}
@@ -0,0 +1,261 @@
+#include "engine/core/protocol.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace aeth;
+using namespace aeth::protocol;
+
+struct Sample {
+    const char* name;
+    std::unique_ptr<Message> message;
+};
+
+template <typename T>
+std::unique_ptr<T> stamped() {
+    auto msg = std::make_unique<T>();
+    msg->messageId = 4242;
+    msg->sourceId = 7;
+    msg->targetId = 1;
+    return msg;
+}
+
+DeploymentMetadataExtension sampleDeployment() {
+    DeploymentMetadataExtension deployment;
+    deployment.placement = "edge";
+    deployment.transport = "websocket";
+    deployment.controlPlaneInstance = "server-a";
+    deployment.targetClass = "desktop";
+    deployment.latencyBudgetMs = 50;
+    deployment.observedLatencyMs = 12;
+    deployment.sendTimestamp = 1700000000000ULL;
+    return deployment;
+}
+
+std::vector<NamedValueSnapshotEntry> sampleNamedSnapshot(size_t count) {
+    std::vector<NamedValueSnapshotEntry> snapshot;
+    for (size_t i = 0; i < count; ++i) {
+        snapshot.push_back({"signal_" + std::to_string(i), Value(static_cast<int32_t>(i * 3))});
+    }
+    return snapshot;
+}
+
+// One message per type, sized like real traffic (short names, a handful
+// of variables, a 4 KiB load chunk).
+std::vector<Sample> makeSamples() {
+    std::vector<Sample> samples;
+
+    auto hello = stamped<HelloMessage>();
+    hello->deviceType = DeviceType::Desktop;
+    hello->versionMajor = 1;
+    hello->name = "bench-device";
+    hello->deployment = sampleDeployment();
+    samples.push_back({"hello", std::move(hello)});
+
+    auto helloAck = stamped<HelloAckMessage>();
+    helloAck->assignedId = 7;
+    helloAck->serverTime = 1700000000000ULL;
+    samples.push_back({"hello_ack", std::move(helloAck)});
+
+    auto ping = stamped<PingMessage>();
+    ping->timestamp = 123456;
+    ping->sequenceNumber = 9;
+    samples.push_back({"ping", std::move(ping)});
+
+    auto pong = stamped<PongMessage>();
+    pong->originalTimestamp = 123456;
+    pong->responseTimestamp = 123460;
+    samples.push_back({"pong", std::move(pong)});
+
+    auto load = stamped<LoadAutomataMessage>();
+    load->runId = 3;
+    load->format = AutomataFormat::YAML;
+    load->isChunked = true;
+    load->totalChunks = 4;
+    load->data.assign(4096, 'a');
+    samples.push_back({"load_automata", std::move(load)});
+
+    auto loadAck = stamped<LoadAckMessage>();
+    loadAck->runId = 3;
+    loadAck->warnings = {"unused variable 'x'", "state 'Idle' has no exit"};
+    samples.push_back({"load_ack", std::move(loadAck)});
+
+    auto start = stamped<StartMessage>();
+    start->runId = 3;
+    start->startFromState = 2;
+    samples.push_back({"start", std::move(start)});
+
+    auto stop = stamped<StopMessage>();
+    stop->runId = 3;
+    samples.push_back({"stop", std::move(stop)});
+
+    auto reset = stamped<ResetMessage>();
+    reset->runId = 3;
+    samples.push_back({"reset", std::move(reset)});
+
+    auto status = stamped<StatusMessage>();
+    status->runId = 3;
+    status->executionState = ExecutionState::Running;
+    status->tickCount = 100000;
+    status->variableSnapshot = sampleNamedSnapshot(8);
+    status->deployment = sampleDeployment();
+    samples.push_back({"status", std::move(status)});
+
+    auto pause = stamped<PauseMessage>();
+    pause->runId = 3;
+    samples.push_back({"pause", std::move(pause)});
+
+    auto resume = stamped<ResumeMessage>();
+    resume->runId = 3;
+    samples.push_back({"resume", std::move(resume)});
+
+    auto restore = stamped<RestoreStateMessage>();
+    restore->runId = 3;
+    restore->targetState = "Running";
+    restore->variables = sampleNamedSnapshot(8);
+    samples.push_back({"restore_state", std::move(restore)});
+
+    auto input = stamped<InputMessage>();
+    input->runId = 3;
+    input->variableId = 4;
+    input->variableName = "temperature";
+    input->value = Value(21.5);
+    samples.push_back({"input", std::move(input)});
+
+    auto batch = stamped<InputBatchMessage>();
+    batch->runId = 3;
+    for (VariableId id = 0; id < 16; ++id) {
+        batch->inputs.push_back(VariableUpdate{id, Value(static_cast<int32_t>(id))});
+    }
+    samples.push_back({"input_batch", std::move(batch)});
+
+    auto output = stamped<OutputMessage>();
+    output->runId = 3;
+    output->variableId = 5;
+    output->variableName = "fan_speed";
+    output->value = Value(static_cast<int32_t>(1200));
+    output->timestamp = 123456;
+    samples.push_back({"output", std::move(output)});
+
+    auto variable = stamped<VariableMessage>();
+    variable->runId = 3;
+    variable->variableId = 6;
+    variable->variableName = "mode";
+    variable->value = Value("auto");
+    samples.push_back({"variable", std::move(variable)});
+
+    auto change = stamped<StateChangeMessage>();
+    change->runId = 3;
+    change->previousState = 1;
+    change->newState = 2;
+    change->firedTransition = 7;
+    change->timestamp = 123456;
+    samples.push_back({"state_change", std::move(change)});
+
+    auto telemetry = stamped<TelemetryMessage>();
+    telemetry->runId = 3;
+    telemetry->heapFree = 1 << 20;
+    telemetry->tickRate = 1000;
+    for (VariableId id = 0; id < 8; ++id) {
+        telemetry->variableSnapshot.emplace_back(id, Value(static_cast<double>(id) * 0.5));
+    }
+    telemetry->namedVariableSnapshot = sampleNamedSnapshot(8);
+    samples.push_back({"telemetry", std::move(telemetry)});
+
+    auto fired = stamped<TransitionFiredMessage>();
+    fired->runId = 3;
+    fired->transitionId = 7;
+    fired->timestamp = 123456;
+    samples.push_back({"transition_fired", std::move(fired)});
+
+    auto error = stamped<ErrorMessage>();
+    error->code = ErrorCode::InvalidState;
+    error->message = "state 'Missing' not found";
+    error->runId = 3;
+    samples.push_back({"error", std::move(error)});
+
+    auto debug = stamped<DebugMessage>();
+    debug->source = "engine";
+    debug->message = "tick overrun by 3ms";
+    samples.push_back({"debug", std::move(debug)});
+
+    auto ack = stamped<AckMessage>();
+    ack->relatedMessageId = 99;
+    ack->info = "ok";
+    samples.push_back({"ack", std::move(ack)});
+
+    auto nak = stamped<NakMessage>();
+    nak->relatedMessageId = 99;
+    nak->reasonCode = 3;
+    nak->reason = "engine not loaded";
+    samples.push_back({"nak", std::move(nak)});
+
+    auto raw = stamped<RawMessage>();
+    raw->rawType = MessageType::Vendor;
+    raw->payload.assign(256, 0x5A);
+    samples.push_back({"raw", std::move(raw)});
+
+    return samples;
+}
+
+double nsPerOp(size_t iterations, const std::function<void()>& op) {
+    for (size_t i = 0; i < iterations / 10; ++i) {
+        op();
+    }
+    const auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        op();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+           static_cast<double>(iterations);
+}
+
+void run(const Sample& sample) {
+    const Message& message = *sample.message;
+    const std::vector<uint8_t> frame = message.serialize();
+    if (message.serializedSize() != frame.size()) {
+        std::fprintf(stderr, "[FAIL] %s serializedSize=%zu encoded=%zu\n",
+                     sample.name, message.serializedSize(), frame.size());
+        std::exit(1);
+    }
+    auto decoded = MessageFactory::deserialize(frame);
+    if (!decoded || decoded->type() != message.type()) {
+        std::fprintf(stderr, "[FAIL] %s did not decode\n", sample.name);
+        std::exit(1);
+    }
+
+    const size_t iterations = std::max<size_t>(2000, 50000000 / (frame.size() * 64));
+    size_t sink = 0;
+
+    ByteWriter writer;
+    const double encodeInto = nsPerOp(iterations, [&] {
+        writer.clear();
+        message.serializeInto(writer);
+        sink += writer.size();
+    });
+    const double encode = nsPerOp(iterations, [&] { sink += message.serialize().size(); });
+    const double decode = nsPerOp(iterations, [&] {
+        sink += MessageFactory::deserialize(frame.data(), frame.size()) != nullptr;
+    });
+
+    std::printf("%-17s bytes=%-5zu %9.1f ns/encodeInto %9.1f ns/encode %9.1f ns/decode%s\n",
+                sample.name, frame.size(), encodeInto, encode, decode, sink == 0 ? " (empty)" : "");
+}
+
+} // namespace
+
+int main() {
+    for (const auto& sample : makeSamples()) {
+        run(sample);
+    }
+    return 0;
+}
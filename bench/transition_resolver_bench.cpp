@@ -0,0 +1,118 @@
+#include "engine/core/runtime.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+namespace {
+
+using namespace aeth;
+
+/**
+ * Guards are "true" or "false" literals; no Lua involved, so the numbers
+ * track resolver overhead rather than script cost.
+ */
+class LiteralScriptEngine : public IScriptEngine {
+public:
+    Result<void> initialize(VariableStore*) override { return Result<void>::ok(); }
+    Result<Value> execute(const CodeBlock&) override { return Result<Value>::ok(Value()); }
+    Result<bool> evaluateCondition(const CodeBlock& code) override {
+        return Result<bool>::ok(code.source == "true");
+    }
+    Result<double> evaluateWeight(const CodeBlock&) override { return Result<double>::ok(1.0); }
+    std::string lastError() const override { return {}; }
+    void clearError() override {}
+    void collectGarbage() override {}
+    void setLogHandler(std::function<void(const std::string&, const std::string&)>) override {}
+};
+
+class FixedClock : public IClock {
+public:
+    Timestamp now() override { return 1000; }
+    void sleep(uint32_t) override {}
+};
+
+enum class Scenario {
+    Guarded,   // One enabled classic guard at the end of the group
+    Weighted,  // Every transition enabled and probabilistic
+};
+
+const char* scenarioName(Scenario scenario) {
+    return scenario == Scenario::Guarded ? "guarded" : "weighted";
+}
+
+Automata makeFanOut(size_t outgoing, Scenario scenario) {
+    Automata automata;
+    automata.config.name = "resolver-bench";
+    automata.addState(State(1, "Source"));
+    automata.addState(State(2, "Sink"));
+    automata.initialState = 1;
+
+    for (size_t i = 0; i < outgoing; ++i) {
+        const auto id = static_cast<TransitionId>(i + 1);
+        Transition t(id, "t" + std::to_string(i), 1, 2);
+        if (scenario == Scenario::Guarded) {
+            t.type = TransitionType::Classic;
+            t.classicConfig.condition.source = (i + 1 == outgoing) ? "true" : "false";
+        } else {
+            t.type = TransitionType::Probabilistic;
+            t.probConfig.weight = static_cast<uint16_t>(100 + i);
+        }
+        automata.addTransition(t);
+    }
+    return automata;
+}
+
+void run(size_t outgoing, Scenario scenario) {
+    const Automata automata = makeFanOut(outgoing, scenario);
+    CompiledAutomata compiled;
+    compiled.build(automata);
+
+    FixedClock clock;
+    StdRandomSource random(1);
+    LiteralScriptEngine script;
+    TimerManager timers(&clock);
+    ExecutionContext context;
+    TransitionResolver resolver(&script, &random, &timers, &context.variables, &context);
+    resolver.reserve(compiled.maxGroupSize());
+
+    const size_t iterations = std::max<size_t>(1000, 2000000 / outgoing);
+
+    // Warm-up
+    for (size_t i = 0; i < iterations / 10; ++i) {
+        if (!resolver.resolve(compiled, 1)) {
+            std::fprintf(stderr, "[FAIL] %s/%zu resolved nothing\n", scenarioName(scenario), outgoing);
+            std::exit(1);
+        }
+    }
+
+    const auto begin = std::chrono::steady_clock::now();
+    size_t fired = 0;
+    for (size_t i = 0; i < iterations; ++i) {
+        fired += resolver.resolve(compiled, 1) != nullptr;
+    }
+    if (fired != iterations) {
+        std::fprintf(stderr, "[FAIL] %s/%zu missed resolves\n", scenarioName(scenario), outgoing);
+        std::exit(1);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+
+    const double ns = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    std::printf("%-10s outgoing=%-4zu iterations=%-8zu %10.1f ns/resolve\n",
+                scenarioName(scenario), outgoing, iterations, ns / static_cast<double>(iterations));
+}
+
+} // namespace
+
+int main() {
+    for (Scenario scenario : {Scenario::Guarded, Scenario::Weighted}) {
+        for (size_t outgoing : {1, 8, 64, 512}) {
+            run(outgoing, scenario);
+        }
+    }
+    return 0;
+}
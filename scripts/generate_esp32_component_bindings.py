@@ -1,9 +1,30 @@
 #!/usr/bin/env python3
+"""Emit constexpr component method tables for the embedded hardware services.
+
+Each manifest component becomes a ComponentDescriptor in flash whose methods
+call the class members through direct function pointers, plus a register_*
+helper that binds it to an instance. Methods may give their argument types
+either as a "signature" string (see ComponentMethodDescriptor) or as an
+"args" list such as ["int", "string", "number?"]; a trailing "?" marks an
+optional argument.
+"""
 
 import json
 import sys
 from pathlib import Path
 
+ARG_TYPES = {
+    "bool": "b",
+    "boolean": "b",
+    "int": "i",
+    "integer": "i",
+    "number": "n",
+    "float": "n",
+    "double": "n",
+    "string": "s",
+    "any": "v",
+}
+
 
 def sanitize(name: str) -> str:
     chars = []
@@ -12,32 +33,57 @@ def sanitize(name: str) -> str:
     return "".join(chars)
 
 
+def method_signature(component: str, method: dict) -> str:
+    if "signature" in method:
+        return method["signature"]
+
+    required = []
+    optional = []
+    for arg in method.get("args", []):
+        is_optional = arg.endswith("?")
+        type_name = arg[:-1] if is_optional else arg
+        if type_name not in ARG_TYPES:
+            raise ValueError(f"{component}.{method['name']}: unknown argument type '{arg}'")
+        if is_optional:
+            optional.append(ARG_TYPES[type_name])
+        elif optional:
+            raise ValueError(f"{component}.{method['name']}: required argument after an optional one")
+        else:
+            required.append(ARG_TYPES[type_name])
+    return "".join(required) + ("|" + "".join(optional) if optional else "")
+
+
 def render_component(component: dict) -> str:
     name = component["name"]
     symbol = sanitize(name)
+    cls = component["class"]
     methods = component.get("methods", [])
+    if not methods:
+        raise ValueError(f"{name}: a component needs at least one method")
 
     entries = []
     for method in methods:
         method_name = method["name"]
+        member = method.get("member", method_name)
+        signature = method_signature(name, method)
         entries.append(
-            f'''                {{"{method_name}", [instance](const std::vector<aeth::Value>& args) -> aeth::Result<aeth::Value> {{
-                    return instance->{method_name}(args);
-                }}}}'''
+            f'    {{"{method_name}", "{signature}", '
+            f"&aeth::invokeComponentMethod<&{cls}::{member}, {cls}>}}"
         )
 
-    entries_text = ",\n".join(entries) if entries else ""
+    entries_text = ",\n".join(entries)
     return f"""
-inline void register_{symbol}_component(
+inline constexpr aeth::ComponentMethodDescriptor k_{symbol}_methods[] = {{
+{entries_text},
+}};
+inline constexpr aeth::ComponentDescriptor k_{symbol}_component = {{"{name}", k_{symbol}_methods, {len(methods)}}};
+
+// `instance` must outlive the hardware service
+inline bool register_{symbol}_component(
     aeth::embedded::arduino::Esp32HardwareService& hardware,
-    std::shared_ptr<{component["class"]}> instance
+    {cls}& instance
 ) {{
-    hardware.registerComponent(std::make_unique<aeth::embedded::arduino::GenericComponent>(
-        "{name}",
-        std::vector<std::pair<std::string, aeth::embedded::arduino::GenericComponent::Handler>>{{
-{entries_text}
-        }}
-    ));
+    return hardware.registerComponent(k_{symbol}_component, &instance);
 }}
 """
 
@@ -52,16 +98,29 @@ def main() -> int:
     manifest = json.loads(manifest_path.read_text())
     components = manifest.get("components", [])
 
-    body = "\n".join(render_component(component) for component in components)
+    try:
+        body = "\n".join(render_component(component) for component in components)
+    except ValueError as error:
+        print(f"{manifest_path}: {error}", file=sys.stderr)
+        return 1
+
+    table = ",\n".join(f"    &k_{sanitize(component['name'])}_component" for component in components)
+    registry = ""
+    if components:
+        registry = f"""
+// Every component of the manifest, in manifest order
+inline constexpr const aeth::ComponentDescriptor* kComponents[] = {{
+{table},
+}};
+"""
+
     output = f"""#ifndef AETHERIUM_GENERATED_COMPONENT_BINDINGS_HPP
 #define AETHERIUM_GENERATED_COMPONENT_BINDINGS_HPP
 
 #include "engine/embedded/arduino/AetheriumEsp32Hardware.hpp"
-#include <memory>
-#include <vector>
 
 namespace aeth::generated {{
-{body}
+{body}{registry}
 }} // namespace aeth::generated
 
 #endif // AETHERIUM_GENERATED_COMPONENT_BINDINGS_HPP
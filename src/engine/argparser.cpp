@@ -16,6 +16,9 @@ bool ArgParser::parse(int argc, char* argv[]) {
     configFile.clear();
     serverUrl.clear();
     traceFile.clear();
+    convertTraceFile.clear();
+    analyzeTraceFile.clear();
+    hostFiles.clear();
     instanceId = "engine.local";
     placement = "host";
     transportName = "local";
@@ -24,6 +27,10 @@ bool ArgParser::parse(int argc, char* argv[]) {
     mode = detached;
     maxTransitions = 0;
     maxTicks = 0;
+    tickRate = 10;
+    minTickRate = 0;
+    workers = 0;
+    ioThreads = 0;
     seed = 0;
     seedProvided = false;
     faultDelayMs = 0;
@@ -34,6 +41,15 @@ bool ArgParser::parse(int argc, char* argv[]) {
     faultDuplicateProbability = 0.0;
     faultSuccessProbability = 1.0;
     faultIngressFlag = false;
+    reactiveFlag = false;
+    telemetryDeltaFlag = false;
+    idOnlyWireFlag = false;
+    hotSwapFlag = false;
+    profileFlag = false;
+    profileSort = "time";
+    gcMode.clear();
+    gcWatermarkKb = 0;
+    scriptMemoryKb = 0;
     batteryPresent = false;
     batteryExternalPower = true;
     batteryPercent = 100.0;
@@ -81,6 +97,29 @@ bool ArgParser::parse(int argc, char* argv[]) {
         {"battery-external-power", no_argument, NULL, 22},
         {"latency-budget-ms", required_argument, NULL, 23},
         {"latency-warning-ms", required_argument, NULL, 24},
+        {"reactive", no_argument, NULL, 25},
+        {"tick-rate", required_argument, NULL, 26},
+        {"host", required_argument, NULL, 27},
+        {"workers", required_argument, NULL, 28},
+        {"telemetry-delta", no_argument, NULL, 29},
+        {"id-only-wire", no_argument, NULL, 30},
+        {"hot-swap", no_argument, NULL, 31},
+        {"convert-trace", required_argument, NULL, 32},
+        {"profile", optional_argument, NULL, 33},
+        {"gc", required_argument, NULL, 34},
+        {"gc-watermark-kb", required_argument, NULL, 35},
+        {"script-memory-kb", required_argument, NULL, 36},
+        {"emit-flash-tables", required_argument, NULL, 37},
+        {"compile-artifact", required_argument, NULL, 38},
+        {"validate-cache", required_argument, NULL, 39},
+        {"virtual-time", no_argument, NULL, 40},
+        {"inputs", required_argument, NULL, 41},
+        {"sim-duration", required_argument, NULL, 42},
+        {"sim-every-tick", no_argument, NULL, 43},
+        {"monte-carlo", required_argument, NULL, 44},
+        {"io-threads", required_argument, NULL, 45},
+        {"analyze-trace", required_argument, NULL, 46},
+        {"min-tick-rate", required_argument, NULL, 47},
         {0, 0, 0, 0}
     };
 
@@ -254,6 +293,138 @@ bool ArgParser::parse(int argc, char* argv[]) {
             case 24:
                 latencyWarningMs = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
                 break;
+
+            case 25:
+                reactiveFlag = true;
+                break;
+
+            case 26:
+                tickRate = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+                break;
+
+            case 27:
+                hostFiles.emplace_back(optarg);
+                break;
+
+            case 28:
+                workers = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+                break;
+
+            case 29:
+                telemetryDeltaFlag = true;
+                break;
+
+            case 30:
+                idOnlyWireFlag = true;
+                break;
+
+            case 31:
+                hotSwapFlag = true;
+                break;
+
+            case 32:
+                if (!std::filesystem::exists(optarg)) {
+                    std::cout << "File not found: " << optarg << std::endl;
+                    printHelp();
+                    return false;
+                }
+                convertTraceFile = optarg;
+                break;
+
+            case 33:
+                if (optarg) {
+                    const std::string sort(optarg);
+                    if (sort != "time" && sort != "calls" && sort != "memory") {
+                        printHelp();
+                        return false;
+                    }
+                    profileSort = sort;
+                }
+                profileFlag = true;
+                break;
+
+            case 34:
+                gcMode = optarg;
+                if (gcMode != "full" && gcMode != "incremental" && gcMode != "generational") {
+                    printHelp();
+                    return false;
+                }
+                break;
+
+            case 35:
+                gcWatermarkKb = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+                break;
+
+            case 36:
+                scriptMemoryKb = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+                break;
+
+            case 37:
+                if (!std::filesystem::exists(optarg)) {
+                    std::cout << "File not found: " << optarg << std::endl;
+                    printHelp();
+                    return false;
+                }
+                flashTablesFile = optarg;
+                break;
+
+            case 38:
+                if (!std::filesystem::exists(optarg)) {
+                    std::cout << "File not found: " << optarg << std::endl;
+                    printHelp();
+                    return false;
+                }
+                compileArtifactFile = optarg;
+                break;
+
+            case 39:
+                validateCacheFile = optarg;
+                break;
+
+            case 40:
+                virtualTimeFlag = true;
+                break;
+
+            case 41:
+                if (!std::filesystem::exists(optarg)) {
+                    std::cout << "File not found: " << optarg << std::endl;
+                    printHelp();
+                    return false;
+                }
+                inputTimelineFile = optarg;
+                virtualTimeFlag = true;
+                break;
+
+            case 42:
+                simDurationMs = static_cast<uint64_t>(std::strtoull(optarg, nullptr, 10));
+                virtualTimeFlag = true;
+                break;
+
+            case 43:
+                simEveryTickFlag = true;
+                break;
+
+            case 44:
+                monteCarloRuns = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+                virtualTimeFlag = true;
+                break;
+
+            case 45:
+                ioThreads = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+                break;
+
+            case 46:
+                if (!std::filesystem::exists(optarg)) {
+                    std::cout << "File not found: " << optarg << std::endl;
+                    printHelp();
+                    return false;
+                }
+                analyzeTraceFile = optarg;
+                break;
+
+            case 47:
+                minTickRate = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+                break;
             
             default:
                 printHelp();
@@ -274,7 +445,7 @@ void ArgParser::printHelp() {
         "Options:\n"
         "  --help                       Show help and exit\n"
         "  --version                    Show version and exit\n"
-        "  --validate <file>            Validate an automata YAML and exit\n"
+        "  --validate <file|dir>        Validate an automata YAML, or every YAML under a directory, and exit\n"
         "  --verbose                    Enable verbose logging\n"
         "  --debug                      Enable debug logging\n"
         "  --run <file|- >              Runs automata (use '-' to wait for server deploy)\n"
@@ -282,8 +453,32 @@ void ArgParser::printHelp() {
         "  --config <file>              Provides configuration file if running in network mode.\n"
         "  --max-transitions, -n <N>    Maximum transitions before auto-stop (0 = unlimited)\n"
         "  --max-ticks, -t <N>          Maximum ticks before auto-stop (default: 10,000,000)\n"
+        "  --tick-rate <N>              Runtime ticks per second (default: 10, 0 = unlimited)\n"
+        "  --min-tick-rate <N>          Adapt the tick rate between N and --tick-rate to activity, battery and tick cost\n"
+        "  --reactive                   Re-evaluate transitions only when their inputs change\n"
+        "  --host <file>                Host an automaton in a shared process (repeatable)\n"
+        "  --workers <N>                Worker threads for --host and --validate <dir> (default: 0 = core count)\n"
+        "  --telemetry-delta            Send keyframe + changed-variable telemetry frames\n"
+        "  --id-only-wire               Send variable ids only; names go once in a symbol table\n"
+        "  --hot-swap                   Swap non-replacing reloads in at a tick boundary without stopping\n"
         "  --server, -s <url>           Server URL for network mode (default: ws://localhost:4000/socket/device/websocket)\n"
-        "  --trace-file <path>          Write local execution trace as JSONL\n"
+        "                               shm://<name> links to a process on this host through shared memory\n"
+        "  --io-threads <N>             Run ws:// links on N shared epoll threads, not a thread each (Linux; default: 0 = off)\n"
+        "  --trace-file <path>          Write local execution trace as JSONL (.aetr: stream compact binary)\n"
+        "  --convert-trace <file>       Rewrite a binary .aetr trace as JSONL (to --trace-file or <file>.jsonl) and exit\n"
+        "  --analyze-trace <file>       Report latency, budget, dwell and fault-action stats of a binary .aetr trace on --workers threads and exit\n"
+        "  --emit-flash-tables <file>   Write a bytecode artifact as flash-resident C++ tables (<file>.hpp) and exit\n"
+        "  --compile-artifact <file>    Validate a YAML automaton and write it as a bytecode artifact (<file>.aeth) and exit\n"
+        "  --validate-cache <file>      With --validate: fully load each file, reusing the verdicts of unchanged files from <file>\n"
+        "  --virtual-time               With --run: simulate on a virtual clock, jumping to the next tick, timer or input\n"
+        "  --inputs <file>              Scripted input timeline for --virtual-time (lines: <time> <variable> <value>)\n"
+        "  --sim-duration <ms>          Stop a --virtual-time run at this virtual time (default: when nothing is left to do)\n"
+        "  --sim-every-tick             With --virtual-time: run every tick slot instead of skipping idle ones\n"
+        "  --monte-carlo <N>            With --run: N seeded virtual-time runs on --workers threads, aggregated (needs --sim-duration or a limit)\n"
+        "  --profile[=<key>]            Print per-state/transition script cost at exit (key: time|calls|memory)\n"
+        "  --gc <mode>                  Script GC: full, incremental (default) or generational\n"
+        "  --gc-watermark-kb <N>        Step the GC during ticks while the Lua heap exceeds N KiB\n"
+        "  --script-memory-kb <N>       Cap each automaton's Lua heap at N KiB (default: 0 = unlimited)\n"
         "  --instance-id <id>           Deployment instance identifier for trace metadata\n"
         "  --placement <name>           Placement label for trace metadata (default: host)\n"
         "  --transport <name>           Transport label for trace metadata (default: local)\n"
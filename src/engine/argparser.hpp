@@ -2,6 +2,7 @@
 #define AETHERIUM_ARGPARSER_HPP
 #include <string>
 #include <cstdint>
+#include <vector>
 
 enum EngineMode{
     detached,
@@ -21,20 +22,42 @@ struct ArgParser {
     inline static bool validateAutomataFlag = false;
     inline static bool runFlag = false;
     inline static bool configProvidedFlag = false;
+    inline static bool reactiveFlag = false;
+    inline static bool telemetryDeltaFlag = false;
+    inline static bool idOnlyWireFlag = false;
+    inline static bool hotSwapFlag = false;
+    inline static bool profileFlag = false;
+    inline static bool virtualTimeFlag = false;   // --virtual-time (implied by --inputs / --sim-duration)
+    inline static bool simEveryTickFlag = false;  // Do not skip idle tick slots in virtual time
 
     inline static std::string automataFile;
     inline static std::string configFile;
     inline static std::string serverUrl;
     inline static std::string traceFile;
+    inline static std::string convertTraceFile;  // --convert-trace: binary trace to rewrite as JSONL
+    inline static std::string analyzeTraceFile;  // --analyze-trace: binary trace to report on
+    inline static std::string flashTablesFile;   // --emit-flash-tables: artifact to write as flash tables
+    inline static std::string compileArtifactFile;  // --compile-artifact: YAML to write as a bytecode artifact
+    inline static std::string validateCacheFile;  // Verdicts reused across --validate runs
+    inline static std::string inputTimelineFile;  // --inputs: scripted inputs for --virtual-time
+    inline static std::string profileSort = "time";  // --profile: time, calls or memory
+    inline static std::string gcMode;                // --gc: full, incremental or generational ("" = build default)
     inline static std::string instanceId = "engine.local";
     inline static std::string placement = "host";
     inline static std::string transportName = "local";
     inline static std::string controlPlaneInstance = "server";
     inline static std::string faultProfileName = "production";
+    inline static std::vector<std::string> hostFiles;  // --host, one automaton per instance
 
     inline static EngineMode mode = detached;
     inline static uint64_t maxTransitions = 0;  // 0 = unlimited
     inline static uint64_t maxTicks = 0;        // 0 = use default (10 million)
+    inline static uint32_t tickRate = 10;       // Ticks per second (0 = unlimited)
+    inline static uint32_t minTickRate = 0;     // Adaptive pacing floor (0 = fixed rate)
+    inline static uint64_t simDurationMs = 0;   // Virtual-time end (0 = run until idle)
+    inline static uint32_t workers = 0;         // Host worker threads (0 = core count)
+    inline static uint32_t ioThreads = 0;       // Shared epoll threads for ws:// links (0 = thread per link)
+    inline static uint32_t monteCarloRuns = 0;  // --monte-carlo: seeded runs (0 = single run)
     inline static uint64_t seed = 0;
     inline static bool seedProvided = false;
     inline static uint32_t faultDelayMs = 0;
@@ -53,6 +76,8 @@ struct ArgParser {
     inline static double batteryDrainPerMessagePercent = 0.0;
     inline static uint32_t latencyBudgetMs = 0;
     inline static uint32_t latencyWarningMs = 0;
+    inline static uint32_t gcWatermarkKb = 0;  // 0 = no watermark
+    inline static uint32_t scriptMemoryKb = 0;  // Script heap budget per automaton, 0 = unlimited
 };
 
 #endif //AETHERIUM_ARGPARSER_HPP
@@ -1,7 +1,10 @@
 #include "artifact.hpp"
+#include "byte_order.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cstring>
+#include <unordered_map>
 
 namespace aeth::ir {
 
@@ -9,6 +12,34 @@ namespace {
 
 constexpr std::array<uint8_t, 8> kMagic{{'A', 'E', 'T', 'H', 'I', 'R', 'V', '1'}};
 constexpr std::array<uint8_t, 8> kBytecodeMagic{{'A', 'E', 'T', 'H', 'B', 'C', '0', '1'}};
+// Magic + format + version (2x2) + payload kind + label length + payload length
+constexpr size_t kArtifactHeaderSize = 8 + 1 + 2 + 2 + 1 + 2 + 4;
+
+// Indexed (AETHBC02) layout: a fixed header, one fixed-stride table per
+// section and a string pool. Strings are (u32 offset, u32 length) refs
+// into the pool; values are a type byte plus an 8-byte slot.
+constexpr std::array<uint8_t, 8> kIndexedMagic{{'A', 'E', 'T', 'H', 'B', 'C', '0', '2'}};
+constexpr size_t kIndexedHeaderSize = 48;
+constexpr size_t kIndexedVariableSize = 24;
+// From BYTECODE_TELEMETRY_MINOR the TelemetryPolicy follows at offset 24
+constexpr size_t kIndexedTelemetryVariableSize = 48;
+constexpr size_t kIndexedStateSize = 36;
+constexpr size_t kIndexedTransitionSize = 80;
+constexpr size_t kStringRefSize = 8;
+constexpr size_t kFixedValueSize = 9;
+
+// Read-only bytes the readers below walk; built from a vector or a raw chunk
+struct ByteSpan {
+    const uint8_t* ptr = nullptr;
+    size_t len = 0;
+
+    ByteSpan(const uint8_t* p, size_t n) : ptr(p), len(n) {}
+    ByteSpan(const std::vector<uint8_t>& bytes) : ptr(bytes.data()), len(bytes.size()) {}
+
+    [[nodiscard]] const uint8_t* data() const { return ptr; }
+    [[nodiscard]] size_t size() const { return len; }
+    uint8_t operator[](size_t i) const { return ptr[i]; }
+};
 
 void appendU16(std::vector<uint8_t>& out, uint16_t value) {
     out.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
@@ -33,7 +64,19 @@ void appendF32(std::vector<uint8_t>& out, float value) {
     appendU32(out, bits);
 }
 
-bool readU16(const std::vector<uint8_t>& bytes, size_t& offset, uint16_t& out) {
+void appendU64(std::vector<uint8_t>& out, uint64_t value) {
+    appendU32(out, static_cast<uint32_t>(value >> 32));
+    appendU32(out, static_cast<uint32_t>(value & 0xFFFFFFFFu));
+}
+
+void appendF64(std::vector<uint8_t>& out, double value) {
+    uint64_t bits = 0;
+    static_assert(sizeof(bits) == sizeof(value), "unexpected double size");
+    std::memcpy(&bits, &value, sizeof(bits));
+    appendU64(out, bits);
+}
+
+bool readU16(ByteSpan bytes, size_t& offset, uint16_t& out) {
     if (offset + 2 > bytes.size()) return false;
     out = (static_cast<uint16_t>(bytes[offset]) << 8) |
           static_cast<uint16_t>(bytes[offset + 1]);
@@ -41,7 +84,7 @@ bool readU16(const std::vector<uint8_t>& bytes, size_t& offset, uint16_t& out) {
     return true;
 }
 
-bool readU32(const std::vector<uint8_t>& bytes, size_t& offset, uint32_t& out) {
+bool readU32(ByteSpan bytes, size_t& offset, uint32_t& out) {
     if (offset + 4 > bytes.size()) return false;
     out = (static_cast<uint32_t>(bytes[offset]) << 24) |
           (static_cast<uint32_t>(bytes[offset + 1]) << 16) |
@@ -51,14 +94,14 @@ bool readU32(const std::vector<uint8_t>& bytes, size_t& offset, uint32_t& out) {
     return true;
 }
 
-bool readI32(const std::vector<uint8_t>& bytes, size_t& offset, int32_t& out) {
+bool readI32(ByteSpan bytes, size_t& offset, int32_t& out) {
     uint32_t raw = 0;
     if (!readU32(bytes, offset, raw)) return false;
     out = static_cast<int32_t>(raw);
     return true;
 }
 
-bool readF32(const std::vector<uint8_t>& bytes, size_t& offset, float& out) {
+bool readF32(ByteSpan bytes, size_t& offset, float& out) {
     uint32_t raw = 0;
     if (!readU32(bytes, offset, raw)) return false;
     static_assert(sizeof(raw) == sizeof(out), "unexpected float size");
@@ -66,20 +109,30 @@ bool readF32(const std::vector<uint8_t>& bytes, size_t& offset, float& out) {
     return true;
 }
 
-bool readU8(const std::vector<uint8_t>& bytes, size_t& offset, uint8_t& out) {
+bool readU64(ByteSpan bytes, size_t& offset, uint64_t& out) {
+    uint32_t high = 0;
+    uint32_t low = 0;
+    if (offset + 8 > bytes.size()) return false;
+    readU32(bytes, offset, high);
+    readU32(bytes, offset, low);
+    out = (static_cast<uint64_t>(high) << 32) | low;
+    return true;
+}
+
+bool readU8(ByteSpan bytes, size_t& offset, uint8_t& out) {
     if (offset >= bytes.size()) return false;
     out = bytes[offset++];
     return true;
 }
 
-bool appendSizedString(std::vector<uint8_t>& out, const std::string& value) {
+bool appendSizedString(std::vector<uint8_t>& out, std::string_view value) {
     if (value.size() > 0xFFFF) return false;
     appendU16(out, static_cast<uint16_t>(value.size()));
     out.insert(out.end(), value.begin(), value.end());
     return true;
 }
 
-bool readSizedString(const std::vector<uint8_t>& bytes, size_t& offset, std::string& out) {
+bool readSizedString(ByteSpan bytes, size_t& offset, std::string& out) {
     uint16_t len = 0;
     if (!readU16(bytes, offset, len)) return false;
     if (offset + len > bytes.size()) return false;
@@ -104,9 +157,14 @@ Result<void> appendValue(std::vector<uint8_t>& out, const Value& value) {
         case ValueType::Float32:
             appendF32(out, value.get<float>());
             return Result<void>::ok();
+        case ValueType::Int64:
+            appendU64(out, static_cast<uint64_t>(value.get<int64_t>()));
+            return Result<void>::ok();
+        case ValueType::Float64:
+            appendF64(out, value.get<double>());
+            return Result<void>::ok();
         case ValueType::String: {
-            const auto& s = value.get<std::string>();
-            if (!appendSizedString(out, s)) {
+            if (!appendSizedString(out, value.str())) {
                 return Result<void>::error("bytecode value string too large");
             }
             return Result<void>::ok();
@@ -116,49 +174,273 @@ Result<void> appendValue(std::vector<uint8_t>& out, const Value& value) {
     }
 }
 
-Result<Value> readValue(const std::vector<uint8_t>& bytes, size_t& offset) {
+// ok(false) means the value is cut off at the end of `bytes`
+Result<bool> readValue(ByteSpan bytes, size_t& offset, Value& out) {
     uint8_t rawType = 0;
     if (!readU8(bytes, offset, rawType)) {
-        return Result<Value>::error("bytecode value type truncated");
+        return Result<bool>::ok(false);
     }
 
     const auto type = static_cast<ValueType>(rawType);
     switch (type) {
         case ValueType::Void:
-            return Result<Value>::ok(Value{});
+            out = Value{};
+            return Result<bool>::ok(true);
         case ValueType::Bool: {
             uint8_t raw = 0;
             if (!readU8(bytes, offset, raw)) {
-                return Result<Value>::error("bytecode bool value truncated");
+                return Result<bool>::ok(false);
             }
-            return Result<Value>::ok(Value(raw != 0));
+            out = Value(raw != 0);
+            return Result<bool>::ok(true);
         }
         case ValueType::Int32: {
             int32_t v = 0;
             if (!readI32(bytes, offset, v)) {
-                return Result<Value>::error("bytecode int32 value truncated");
+                return Result<bool>::ok(false);
             }
-            return Result<Value>::ok(Value(v));
+            out = Value(v);
+            return Result<bool>::ok(true);
         }
         case ValueType::Float32: {
             float v = 0;
             if (!readF32(bytes, offset, v)) {
-                return Result<Value>::error("bytecode float32 value truncated");
+                return Result<bool>::ok(false);
+            }
+            out = Value(v);
+            return Result<bool>::ok(true);
+        }
+        case ValueType::Int64:
+        case ValueType::Float64: {
+            uint64_t raw = 0;
+            if (!readU64(bytes, offset, raw)) {
+                return Result<bool>::ok(false);
+            }
+            if (type == ValueType::Int64) {
+                out = Value(static_cast<int64_t>(raw));
+            } else {
+                double v = 0;
+                std::memcpy(&v, &raw, sizeof(v));
+                out = Value(v);
             }
-            return Result<Value>::ok(Value(v));
+            return Result<bool>::ok(true);
         }
         case ValueType::String: {
-            std::string s;
-            if (!readSizedString(bytes, offset, s)) {
-                return Result<Value>::error("bytecode string value truncated");
+            std::string str;
+            if (!readSizedString(bytes, offset, str)) {
+                return Result<bool>::ok(false);
             }
-            return Result<Value>::ok(Value(std::move(s)));
+            out = Value(std::move(str));
+            return Result<bool>::ok(true);
+        }
+        default:
+            return Result<bool>::error("unsupported bytecode value type");
+    }
+}
+
+// Deduplicated string storage for an indexed payload
+class StringPool {
+public:
+    bool add(std::string_view value, uint8_t* refOut) {
+        if (value.size() > 0xFFFFFFFFu) {
+            return false;
+        }
+        uint32_t offset = 0;
+        const std::string key(value);
+        auto it = offsets_.find(key);
+        if (it != offsets_.end()) {
+            offset = it->second;
+        } else {
+            if (bytes_.size() + value.size() > 0xFFFFFFFFu) {
+                return false;
+            }
+            offset = static_cast<uint32_t>(bytes_.size());
+            bytes_.insert(bytes_.end(), value.begin(), value.end());
+            offsets_.emplace(key, offset);
+        }
+        byteorder::storeBig<uint32_t>(refOut, offset);
+        byteorder::storeBig<uint32_t>(refOut + 4, static_cast<uint32_t>(value.size()));
+        return true;
+    }
+
+    [[nodiscard]] const std::vector<uint8_t>& bytes() const { return bytes_; }
+
+private:
+    std::vector<uint8_t> bytes_;
+    std::unordered_map<std::string, uint32_t> offsets_;
+};
+
+Result<void> writeFixedValue(uint8_t* out, const Value& value, StringPool& pool) {
+    out[0] = static_cast<uint8_t>(value.type());
+    uint8_t* slot = out + 1;
+    std::memset(slot, 0, kFixedValueSize - 1);
+    switch (value.type()) {
+        case ValueType::Void:
+            return Result<void>::ok();
+        case ValueType::Bool:
+            slot[0] = value.get<bool>() ? 1 : 0;
+            return Result<void>::ok();
+        case ValueType::Int32:
+            byteorder::storeBig<uint32_t>(slot, static_cast<uint32_t>(value.get<int32_t>()));
+            return Result<void>::ok();
+        case ValueType::Float32: {
+            uint32_t bits = 0;
+            const float f = value.get<float>();
+            std::memcpy(&bits, &f, sizeof(bits));
+            byteorder::storeBig<uint32_t>(slot, bits);
+            return Result<void>::ok();
+        }
+        case ValueType::Int64:
+            byteorder::storeBig<uint64_t>(slot, static_cast<uint64_t>(value.get<int64_t>()));
+            return Result<void>::ok();
+        case ValueType::Float64: {
+            uint64_t bits = 0;
+            const double d = value.get<double>();
+            std::memcpy(&bits, &d, sizeof(bits));
+            byteorder::storeBig<uint64_t>(slot, bits);
+            return Result<void>::ok();
+        }
+        case ValueType::String:
+            if (!pool.add(value.str(), slot)) {
+                return Result<void>::error("bytecode value string too large");
+            }
+            return Result<void>::ok();
+        default:
+            return Result<void>::error("unsupported bytecode value type");
+    }
+}
+
+std::string_view poolString(const uint8_t* ref, const uint8_t* pool) {
+    const auto offset = byteorder::loadBig<uint32_t>(ref);
+    const auto length = byteorder::loadBig<uint32_t>(ref + 4);
+    return std::string_view(reinterpret_cast<const char*>(pool + offset), length);
+}
+
+bool refInPool(const uint8_t* ref, size_t poolSize) {
+    const auto offset = byteorder::loadBig<uint32_t>(ref);
+    const auto length = byteorder::loadBig<uint32_t>(ref + 4);
+    return offset <= poolSize && length <= poolSize - offset;
+}
+
+bool fixedValueValid(const uint8_t* at, size_t poolSize) {
+    switch (static_cast<ValueType>(at[0])) {
+        case ValueType::Void:
+        case ValueType::Bool:
+        case ValueType::Int32:
+        case ValueType::Float32:
+        case ValueType::Int64:
+        case ValueType::Float64:
+            return true;
+        case ValueType::String:
+            return refInPool(at + 1, poolSize);
+        default:
+            return false;
+    }
+}
+
+Value readFixedValue(const uint8_t* at, const uint8_t* pool) {
+    const uint8_t* slot = at + 1;
+    switch (static_cast<ValueType>(at[0])) {
+        case ValueType::Bool:
+            return Value(slot[0] != 0);
+        case ValueType::Int32:
+            return Value(static_cast<int32_t>(byteorder::loadBig<uint32_t>(slot)));
+        case ValueType::Float32: {
+            const uint32_t bits = byteorder::loadBig<uint32_t>(slot);
+            float f = 0;
+            std::memcpy(&f, &bits, sizeof(f));
+            return Value(f);
+        }
+        case ValueType::Int64:
+            return Value(static_cast<int64_t>(byteorder::loadBig<uint64_t>(slot)));
+        case ValueType::Float64: {
+            const uint64_t bits = byteorder::loadBig<uint64_t>(slot);
+            double d = 0;
+            std::memcpy(&d, &bits, sizeof(d));
+            return Value(d);
+        }
+        case ValueType::String: {
+            const auto str = poolString(slot, pool);
+            return Value(std::string_view(str.data(), str.size()));
         }
         default:
-            return Result<Value>::error("unsupported bytecode value type");
+            return Value{};
     }
 }
 
+BytecodeVariable decodeIndexedVariable(const uint8_t* record, const uint8_t* pool) {
+    BytecodeVariable v;
+    v.id = byteorder::loadBig<uint16_t>(record);
+    v.type = static_cast<ValueType>(record[2]);
+    v.direction = static_cast<VariableDirection>(record[3]);
+    v.name = std::string(poolString(record + 4, pool));
+    v.initialValue = readFixedValue(record + 12, pool);
+    return v;
+}
+
+BytecodeVariable decodeIndexedTelemetryVariable(const uint8_t* record, const uint8_t* pool) {
+    BytecodeVariable v = decodeIndexedVariable(record, pool);
+    v.telemetry.windowMs = byteorder::loadBig<uint32_t>(record + 24);
+    v.telemetry.slideMs = byteorder::loadBig<uint32_t>(record + 28);
+    const uint64_t bits = byteorder::loadBig<uint64_t>(record + 32);
+    std::memcpy(&v.telemetry.deadband, &bits, sizeof(bits));
+    v.telemetry.minIntervalMs = byteorder::loadBig<uint32_t>(record + 40);
+    return v;
+}
+
+MappedState decodeIndexedState(const uint8_t* record, const uint8_t* pool) {
+    MappedState st;
+    st.id = byteorder::loadBig<uint16_t>(record);
+    st.name = poolString(record + 4, pool);
+    st.onEnterSource = poolString(record + 12, pool);
+    st.bodySource = poolString(record + 20, pool);
+    st.onExitSource = poolString(record + 28, pool);
+    return st;
+}
+
+// Guards marked other than Contextual need a BYTECODE_CODE_KINDS_MINOR payload
+bool hasCodeKinds(const EngineBytecodeProgram& program) {
+    return std::any_of(program.transitions.begin(), program.transitions.end(),
+                       [](const BytecodeTransition& t) { return t.conditionKind != CodeKind::Contextual; });
+}
+
+// Variables with a reporting policy need a BYTECODE_TELEMETRY_MINOR payload
+bool hasTelemetryPolicies(const EngineBytecodeProgram& program) {
+    return std::any_of(program.variables.begin(), program.variables.end(),
+                       [](const BytecodeVariable& v) { return v.telemetry.enabled(); });
+}
+
+MappedTransition decodeIndexedTransition(const uint8_t* record, const uint8_t* pool) {
+    MappedTransition t;
+    t.id = byteorder::loadBig<uint16_t>(record);
+    t.from = byteorder::loadBig<uint16_t>(record + 2);
+    t.to = byteorder::loadBig<uint16_t>(record + 4);
+    t.kind = static_cast<BytecodeTransitionKind>(record[6]);
+    t.priority = record[7];
+    t.enabled = record[8] != 0;
+    t.eventSignalDirection = static_cast<VariableDirection>(record[9]);
+    t.eventTriggerType = static_cast<EventTrigger>(record[10]);
+    t.eventHasThreshold = record[11] != 0;
+    t.eventThresholdOp = static_cast<CompareOp>(record[12]);
+    t.eventThresholdOneShot = record[13] != 0;
+    t.weight = byteorder::loadBig<uint16_t>(record + 14);
+    t.delayMs = byteorder::loadBig<uint32_t>(record + 16);
+    t.eventThresholdValue = readFixedValue(record + 20, pool);
+    t.conditionExpression = poolString(record + 29, pool);
+    t.conditionKind = static_cast<CodeKind>(record[77]);
+    t.bodySource = poolString(record + 37, pool);
+    t.triggeredSource = poolString(record + 45, pool);
+    t.eventSignalName = poolString(record + 53, pool);
+    t.eventPattern = poolString(record + 61, pool);
+    t.name = poolString(record + 69, pool);
+    return t;
+}
+
+// Whether [offset, offset + count * stride) lies inside `size` bytes
+bool tableFits(uint64_t offset, uint64_t count, uint64_t stride, uint64_t size) {
+    return offset <= size && count * stride <= size - offset;
+}
+
 } // namespace
 
 Result<std::vector<uint8_t>> serializeArtifact(const AutomataArtifact& artifact) {
@@ -188,47 +470,68 @@ Result<std::vector<uint8_t>> serializeArtifact(const AutomataArtifact& artifact)
     return Result<std::vector<uint8_t>>::ok(std::move(out));
 }
 
-Result<AutomataArtifact> deserializeArtifact(const std::vector<uint8_t>& bytes) {
-    if (bytes.size() < kMagic.size() + 1 + 2 + 2 + 1 + 2 + 4) {
-        return Result<AutomataArtifact>::error("artifact too small");
+bool hasArtifactMagic(const uint8_t* data, size_t size) {
+    return size >= kMagic.size() && std::equal(kMagic.begin(), kMagic.end(), data);
+}
+
+Result<ArtifactView> viewArtifact(const uint8_t* data, size_t size) {
+    const ByteSpan bytes(data, size);
+    if (size < kArtifactHeaderSize) {
+        return Result<ArtifactView>::error("artifact too small");
     }
 
-    if (!std::equal(kMagic.begin(), kMagic.end(), bytes.begin())) {
-        return Result<AutomataArtifact>::error("invalid artifact magic");
+    if (!hasArtifactMagic(data, size)) {
+        return Result<ArtifactView>::error("invalid artifact magic");
     }
 
     size_t offset = kMagic.size();
     const auto format = static_cast<ArtifactFormat>(bytes[offset++]);
     if (format != ArtifactFormat::AethIrV1) {
-        return Result<AutomataArtifact>::error("unknown artifact format");
+        return Result<ArtifactView>::error("unknown artifact format");
     }
 
-    AutomataArtifact artifact;
-    artifact.header.format = format;
+    ArtifactView view;
+    view.header.format = format;
 
-    if (!readU16(bytes, offset, artifact.header.versionMajor) ||
-        !readU16(bytes, offset, artifact.header.versionMinor)) {
-        return Result<AutomataArtifact>::error("artifact header truncated");
+    if (!readU16(bytes, offset, view.header.versionMajor) ||
+        !readU16(bytes, offset, view.header.versionMinor)) {
+        return Result<ArtifactView>::error("artifact header truncated");
     }
 
-    if (offset >= bytes.size()) {
-        return Result<AutomataArtifact>::error("artifact payload kind missing");
+    if (offset >= size) {
+        return Result<ArtifactView>::error("artifact payload kind missing");
     }
-    artifact.payloadKind = static_cast<PayloadKind>(bytes[offset++]);
+    view.payloadKind = static_cast<PayloadKind>(bytes[offset++]);
 
     uint16_t sourceLabelLen = 0;
     uint32_t payloadLen = 0;
     if (!readU16(bytes, offset, sourceLabelLen) || !readU32(bytes, offset, payloadLen)) {
-        return Result<AutomataArtifact>::error("artifact lengths truncated");
+        return Result<ArtifactView>::error("artifact lengths truncated");
     }
 
-    if (offset + sourceLabelLen + payloadLen != bytes.size()) {
-        return Result<AutomataArtifact>::error("artifact size mismatch");
+    if (offset + sourceLabelLen + payloadLen != size) {
+        return Result<ArtifactView>::error("artifact size mismatch");
     }
 
-    artifact.sourceLabel.assign(reinterpret_cast<const char*>(bytes.data() + offset), sourceLabelLen);
+    view.sourceLabel = std::string_view(reinterpret_cast<const char*>(data + offset), sourceLabelLen);
     offset += sourceLabelLen;
-    artifact.payloadBytes.assign(bytes.begin() + static_cast<std::ptrdiff_t>(offset), bytes.end());
+    view.payload = data + offset;
+    view.payloadSize = payloadLen;
+
+    return Result<ArtifactView>::ok(view);
+}
+
+Result<AutomataArtifact> deserializeArtifact(const std::vector<uint8_t>& bytes) {
+    auto view = viewArtifact(bytes.data(), bytes.size());
+    if (view.isError()) {
+        return Result<AutomataArtifact>::error(view.error());
+    }
+
+    AutomataArtifact artifact;
+    artifact.header = view.value().header;
+    artifact.payloadKind = view.value().payloadKind;
+    artifact.sourceLabel.assign(view.value().sourceLabel.data(), view.value().sourceLabel.size());
+    artifact.payloadBytes.assign(view.value().payload, view.value().payload + view.value().payloadSize);
 
     return Result<AutomataArtifact>::ok(std::move(artifact));
 }
@@ -255,11 +558,26 @@ Result<std::vector<uint8_t>> serializeEngineBytecodeProgram(const EngineBytecode
         return Result<std::vector<uint8_t>>::error("bytecode program missing initial state");
     }
 
+    if (!program.luaChunks.empty() && (!program.luaTarget.valid() || program.luaChunks.size() > 0xFFFF)) {
+        return Result<std::vector<uint8_t>>::error("bytecode lua chunks invalid");
+    }
+    uint16_t versionMinor = program.luaChunks.empty()
+        ? program.versionMinor
+        : std::max(program.versionMinor, BYTECODE_LUA_CHUNKS_MINOR);
+    if (hasCodeKinds(program)) {
+        versionMinor = std::max(versionMinor, BYTECODE_CODE_KINDS_MINOR);
+    }
+    if (hasTelemetryPolicies(program)) {
+        versionMinor = std::max(versionMinor, BYTECODE_TELEMETRY_MINOR);
+    }
+    const bool withLua = versionMinor >= BYTECODE_LUA_CHUNKS_MINOR;
+    const bool withTelemetry = versionMinor >= BYTECODE_TELEMETRY_MINOR;
+
     std::vector<uint8_t> out;
     out.reserve(256);
     out.insert(out.end(), kBytecodeMagic.begin(), kBytecodeMagic.end());
     appendU16(out, program.versionMajor);
-    appendU16(out, program.versionMinor);
+    appendU16(out, versionMinor);
     if (!appendSizedString(out, program.name)) {
         return Result<std::vector<uint8_t>>::error("bytecode program name too large");
     }
@@ -282,6 +600,12 @@ Result<std::vector<uint8_t>> serializeEngineBytecodeProgram(const EngineBytecode
         if (valueRes.isError()) {
             return Result<std::vector<uint8_t>>::error(valueRes.error());
         }
+        if (withTelemetry) {
+            appendU32(out, v.telemetry.windowMs);
+            appendU32(out, v.telemetry.slideMs);
+            appendF64(out, v.telemetry.deadband);
+            appendU32(out, v.telemetry.minIntervalMs);
+        }
     }
 
     for (const auto& s : program.states) {
@@ -306,7 +630,7 @@ Result<std::vector<uint8_t>> serializeEngineBytecodeProgram(const EngineBytecode
         out.push_back(static_cast<uint8_t>(t.kind));
         out.push_back(t.priority);
         out.push_back(t.enabled ? 1 : 0);
-        out.push_back(0); // reserved
+        out.push_back(static_cast<uint8_t>(t.conditionKind)); // Reserved (0) before BYTECODE_CODE_KINDS_MINOR
         appendU16(out, t.weight);
         appendU32(out, t.delayMs);
         if (!appendSizedString(out, t.conditionExpression)) {
@@ -337,131 +661,614 @@ Result<std::vector<uint8_t>> serializeEngineBytecodeProgram(const EngineBytecode
         }
     }
 
+    if (withLua) {
+        appendU16(out, program.luaTarget.luaVersion);
+        out.push_back(program.luaTarget.wordSize);
+        out.push_back(program.luaTarget.integerSize);
+        out.push_back(program.luaTarget.numberSize);
+        appendU16(out, static_cast<uint16_t>(program.luaChunks.size()));
+        for (const auto& chunk : program.luaChunks) {
+            if (chunk.bytes.size() > 0xFFFFFFFFu) {
+                return Result<std::vector<uint8_t>>::error("bytecode lua chunk too large");
+            }
+            out.push_back(static_cast<uint8_t>(chunk.slot));
+            appendU16(out, chunk.ownerId);
+            appendU32(out, static_cast<uint32_t>(chunk.bytes.size()));
+            out.insert(out.end(), chunk.bytes.begin(), chunk.bytes.end());
+        }
+    }
+
     return Result<std::vector<uint8_t>>::ok(std::move(out));
 }
 
 Result<EngineBytecodeProgram> deserializeEngineBytecodeProgram(const std::vector<uint8_t>& bytes) {
-    if (bytes.size() < kBytecodeMagic.size() + 2 + 2 + 2 + 2 + 2 + 2 + 2) {
-        return Result<EngineBytecodeProgram>::error("bytecode payload too small");
+    BytecodeStreamDecoder decoder;
+    auto fed = decoder.feed(bytes.data(), bytes.size());
+    if (fed.isError()) {
+        return Result<EngineBytecodeProgram>::error(fed.error());
     }
-    if (!std::equal(kBytecodeMagic.begin(), kBytecodeMagic.end(), bytes.begin())) {
-        return Result<EngineBytecodeProgram>::error("invalid bytecode magic");
+    auto finished = decoder.finish();
+    if (finished.isError()) {
+        return Result<EngineBytecodeProgram>::error(finished.error());
     }
+    return Result<EngineBytecodeProgram>::ok(std::move(decoder.program()));
+}
 
-    size_t offset = kBytecodeMagic.size();
-    EngineBytecodeProgram program;
-    if (!readU16(bytes, offset, program.versionMajor) || !readU16(bytes, offset, program.versionMinor)) {
-        return Result<EngineBytecodeProgram>::error("bytecode version truncated");
-    }
-    if (!readSizedString(bytes, offset, program.name)) {
-        return Result<EngineBytecodeProgram>::error("bytecode program name truncated");
+Result<std::vector<uint8_t>> serializeIndexedBytecodeProgram(const EngineBytecodeProgram& program) {
+    using Bytes = Result<std::vector<uint8_t>>;
+    if (program.variables.size() > 0xFFFF || program.states.size() > 0xFFFF || program.transitions.size() > 0xFFFF) {
+        return Bytes::error("bytecode program section too large");
     }
-    if (!readU16(bytes, offset, program.initialState)) {
-        return Result<EngineBytecodeProgram>::error("bytecode initial state truncated");
+    if (program.initialState == INVALID_STATE) {
+        return Bytes::error("bytecode program missing initial state");
     }
 
-    uint16_t varCount = 0;
-    uint16_t stateCount = 0;
-    uint16_t transitionCount = 0;
-    if (!readU16(bytes, offset, varCount) || !readU16(bytes, offset, stateCount) || !readU16(bytes, offset, transitionCount)) {
-        return Result<EngineBytecodeProgram>::error("bytecode counts truncated");
+    uint16_t versionMinor = hasCodeKinds(program)
+        ? std::max(program.versionMinor, BYTECODE_CODE_KINDS_MINOR)
+        : program.versionMinor;
+    if (hasTelemetryPolicies(program)) {
+        versionMinor = std::max(versionMinor, BYTECODE_TELEMETRY_MINOR);
     }
+    const size_t variableSize = versionMinor >= BYTECODE_TELEMETRY_MINOR
+        ? kIndexedTelemetryVariableSize
+        : kIndexedVariableSize;
+
+    const size_t varTable = kIndexedHeaderSize;
+    const size_t stateTable = varTable + program.variables.size() * variableSize;
+    const size_t transitionTable = stateTable + program.states.size() * kIndexedStateSize;
+    const size_t poolOffset = transitionTable + program.transitions.size() * kIndexedTransitionSize;
+
+    std::vector<uint8_t> out(poolOffset, 0);
+    StringPool pool;
+    uint8_t* header = out.data();
+    std::copy(kIndexedMagic.begin(), kIndexedMagic.end(), header);
+    byteorder::storeBig<uint16_t>(header + 8, program.versionMajor);
+    byteorder::storeBig<uint16_t>(header + 10, versionMinor);
+    byteorder::storeBig<uint16_t>(header + 12, program.initialState);
+    byteorder::storeBig<uint16_t>(header + 14, static_cast<uint16_t>(program.variables.size()));
+    byteorder::storeBig<uint16_t>(header + 16, static_cast<uint16_t>(program.states.size()));
+    byteorder::storeBig<uint16_t>(header + 18, static_cast<uint16_t>(program.transitions.size()));
+    pool.add(program.name, header + 20);
 
-    program.variables.reserve(varCount);
-    for (uint16_t i = 0; i < varCount; ++i) {
-        BytecodeVariable v;
-        uint8_t rawType = 0;
-        uint8_t rawDir = 0;
-        if (!readU16(bytes, offset, v.id) || !readU8(bytes, offset, rawType) || !readU8(bytes, offset, rawDir) ||
-            !readSizedString(bytes, offset, v.name)) {
-            return Result<EngineBytecodeProgram>::error("bytecode variable entry truncated");
+    uint8_t* record = out.data() + varTable;
+    for (const auto& v : program.variables) {
+        byteorder::storeBig<uint16_t>(record, v.id);
+        record[2] = static_cast<uint8_t>(v.type);
+        record[3] = static_cast<uint8_t>(v.direction);
+        if (!pool.add(v.name, record + 4)) {
+            return Bytes::error("bytecode variable name too large");
         }
-        v.type = static_cast<ValueType>(rawType);
-        v.direction = static_cast<VariableDirection>(rawDir);
-        auto valueRes = readValue(bytes, offset);
+        auto valueRes = writeFixedValue(record + 12, v.initialValue, pool);
         if (valueRes.isError()) {
-            return Result<EngineBytecodeProgram>::error(valueRes.error());
-        }
-        v.initialValue = std::move(valueRes.value());
-        program.variables.push_back(std::move(v));
-    }
-
-    program.states.reserve(stateCount);
-    for (uint16_t i = 0; i < stateCount; ++i) {
-        BytecodeState s;
-        if (!readU16(bytes, offset, s.id) ||
-            !readSizedString(bytes, offset, s.name) ||
-            !readSizedString(bytes, offset, s.onEnterSource) ||
-            !readSizedString(bytes, offset, s.bodySource) ||
-            !readSizedString(bytes, offset, s.onExitSource)) {
-            return Result<EngineBytecodeProgram>::error("bytecode state entry truncated");
-        }
-        program.states.push_back(std::move(s));
-    }
-
-    program.transitions.reserve(transitionCount);
-    for (uint16_t i = 0; i < transitionCount; ++i) {
-        BytecodeTransition t;
-        uint8_t rawKind = 0;
-        uint8_t rawPriority = 0;
-        uint8_t rawEnabled = 0;
-        uint8_t ignoredReserved = 0;
-        uint16_t rawWeight = 0;
-        uint8_t rawSignalDirection = 0;
-        uint8_t rawTriggerType = 0;
-        uint8_t rawHasThreshold = 0;
-        uint8_t rawThresholdOp = 0;
-        uint8_t rawThresholdOneShot = 0;
-        uint8_t ignoredReserved2 = 0;
-        if (!readU16(bytes, offset, t.id) ||
-            !readU16(bytes, offset, t.from) ||
-            !readU16(bytes, offset, t.to) ||
-            !readU8(bytes, offset, rawKind) ||
-            !readU8(bytes, offset, rawPriority) ||
-            !readU8(bytes, offset, rawEnabled) ||
-            !readU8(bytes, offset, ignoredReserved) ||
-            !readU16(bytes, offset, rawWeight) ||
-            !readU32(bytes, offset, t.delayMs) ||
-            !readSizedString(bytes, offset, t.conditionExpression) ||
-            !readSizedString(bytes, offset, t.bodySource) ||
-            !readSizedString(bytes, offset, t.triggeredSource) ||
-            !readU8(bytes, offset, rawSignalDirection) ||
-            !readU8(bytes, offset, rawTriggerType) ||
-            !readU8(bytes, offset, rawHasThreshold) ||
-            !readU8(bytes, offset, rawThresholdOp) ||
-            !readU8(bytes, offset, rawThresholdOneShot) ||
-            !readU8(bytes, offset, ignoredReserved2)) {
-            return Result<EngineBytecodeProgram>::error("bytecode transition entry truncated");
-        }
-        auto thresholdValueRes = readValue(bytes, offset);
-        if (thresholdValueRes.isError()) {
-            return Result<EngineBytecodeProgram>::error(thresholdValueRes.error());
+            return Bytes::error(valueRes.error());
+        }
+        if (variableSize == kIndexedTelemetryVariableSize) {
+            byteorder::storeBig<uint32_t>(record + 24, v.telemetry.windowMs);
+            byteorder::storeBig<uint32_t>(record + 28, v.telemetry.slideMs);
+            uint64_t bits = 0;
+            std::memcpy(&bits, &v.telemetry.deadband, sizeof(bits));
+            byteorder::storeBig<uint64_t>(record + 32, bits);
+            byteorder::storeBig<uint32_t>(record + 40, v.telemetry.minIntervalMs);
         }
-        t.eventThresholdValue = std::move(thresholdValueRes.value());
-        if (!readSizedString(bytes, offset, t.eventSignalName) ||
-            !readSizedString(bytes, offset, t.eventPattern) ||
-            !readSizedString(bytes, offset, t.name)) {
-            return Result<EngineBytecodeProgram>::error("bytecode transition entry truncated");
+        record += variableSize;
+    }
+
+    for (const auto& st : program.states) {
+        if (st.name.empty()) {
+            return Bytes::error("bytecode state name cannot be empty");
         }
-        (void) ignoredReserved;
-        (void) ignoredReserved2;
-        t.kind = static_cast<BytecodeTransitionKind>(rawKind);
-        t.priority = rawPriority;
-        t.enabled = rawEnabled != 0;
-        t.weight = rawWeight;
-        t.eventSignalDirection = static_cast<VariableDirection>(rawSignalDirection);
-        t.eventTriggerType = static_cast<EventTrigger>(rawTriggerType);
-        t.eventHasThreshold = rawHasThreshold != 0;
-        t.eventThresholdOp = static_cast<CompareOp>(rawThresholdOp);
-        t.eventThresholdOneShot = rawThresholdOneShot != 0;
-        program.transitions.push_back(std::move(t));
+        byteorder::storeBig<uint16_t>(record, st.id);
+        if (!pool.add(st.name, record + 4) || !pool.add(st.onEnterSource, record + 12) ||
+            !pool.add(st.bodySource, record + 20) || !pool.add(st.onExitSource, record + 28)) {
+            return Bytes::error("bytecode string pool too large");
+        }
+        record += kIndexedStateSize;
     }
 
-    if (offset != bytes.size()) {
-        return Result<EngineBytecodeProgram>::error("bytecode payload trailing bytes");
+    for (const auto& t : program.transitions) {
+        byteorder::storeBig<uint16_t>(record, t.id);
+        byteorder::storeBig<uint16_t>(record + 2, t.from);
+        byteorder::storeBig<uint16_t>(record + 4, t.to);
+        record[6] = static_cast<uint8_t>(t.kind);
+        record[7] = t.priority;
+        record[8] = t.enabled ? 1 : 0;
+        record[9] = static_cast<uint8_t>(t.eventSignalDirection);
+        record[10] = static_cast<uint8_t>(t.eventTriggerType);
+        record[11] = t.eventHasThreshold ? 1 : 0;
+        record[12] = static_cast<uint8_t>(t.eventThresholdOp);
+        record[13] = t.eventThresholdOneShot ? 1 : 0;
+        byteorder::storeBig<uint16_t>(record + 14, t.weight);
+        byteorder::storeBig<uint32_t>(record + 16, t.delayMs);
+        auto thresholdRes = writeFixedValue(record + 20, t.eventThresholdValue, pool);
+        if (thresholdRes.isError()) {
+            return Bytes::error("bytecode transition threshold value unsupported");
+        }
+        if (!pool.add(t.conditionExpression, record + 29) || !pool.add(t.bodySource, record + 37) ||
+            !pool.add(t.triggeredSource, record + 45) || !pool.add(t.eventSignalName, record + 53) ||
+            !pool.add(t.eventPattern, record + 61) || !pool.add(t.name, record + 69)) {
+            return Bytes::error("bytecode string pool too large");
+        }
+        record[77] = static_cast<uint8_t>(t.conditionKind);
+        record += kIndexedTransitionSize;
     }
 
-    return Result<EngineBytecodeProgram>::ok(std::move(program));
+    if (pool.bytes().size() > 0xFFFFFFFFu - poolOffset) {
+        return Bytes::error("bytecode string pool too large");
+    }
+    byteorder::storeBig<uint32_t>(header + 28, static_cast<uint32_t>(varTable));
+    byteorder::storeBig<uint32_t>(header + 32, static_cast<uint32_t>(stateTable));
+    byteorder::storeBig<uint32_t>(header + 36, static_cast<uint32_t>(transitionTable));
+    byteorder::storeBig<uint32_t>(header + 40, static_cast<uint32_t>(poolOffset));
+    byteorder::storeBig<uint32_t>(header + 44, static_cast<uint32_t>(pool.bytes().size()));
+    out.insert(out.end(), pool.bytes().begin(), pool.bytes().end());
+    return Bytes::ok(std::move(out));
+}
+
+Result<MappedBytecodeProgram> MappedBytecodeProgram::open(const uint8_t* data, size_t size) {
+    using Mapped = Result<MappedBytecodeProgram>;
+    if (size < kIndexedHeaderSize) {
+        return Mapped::error("indexed bytecode payload too small");
+    }
+    if (!std::equal(kIndexedMagic.begin(), kIndexedMagic.end(), data)) {
+        return Mapped::error("invalid indexed bytecode magic");
+    }
+
+    const auto varCount = byteorder::loadBig<uint16_t>(data + 14);
+    const auto stateCount = byteorder::loadBig<uint16_t>(data + 16);
+    const auto transitionCount = byteorder::loadBig<uint16_t>(data + 18);
+    const auto varTable = byteorder::loadBig<uint32_t>(data + 28);
+    const auto stateTable = byteorder::loadBig<uint32_t>(data + 32);
+    const auto transitionTable = byteorder::loadBig<uint32_t>(data + 36);
+    const auto poolOffset = byteorder::loadBig<uint32_t>(data + 40);
+    const auto poolSize = byteorder::loadBig<uint32_t>(data + 44);
+    const bool withTelemetry = byteorder::loadBig<uint16_t>(data + 10) >= BYTECODE_TELEMETRY_MINOR;
+    const size_t variableSize = withTelemetry ? kIndexedTelemetryVariableSize : kIndexedVariableSize;
+
+    if (!tableFits(varTable, varCount, variableSize, size) ||
+        !tableFits(stateTable, stateCount, kIndexedStateSize, size) ||
+        !tableFits(transitionTable, transitionCount, kIndexedTransitionSize, size) ||
+        !tableFits(poolOffset, poolSize, 1, size)) {
+        return Mapped::error("indexed bytecode table out of bounds");
+    }
+
+    // One bounds pass so record access never has to check again
+    if (!refInPool(data + 20, poolSize)) {
+        return Mapped::error("indexed bytecode string out of bounds");
+    }
+    for (size_t i = 0; i < varCount; ++i) {
+        const uint8_t* record = data + varTable + i * variableSize;
+        if (!refInPool(record + 4, poolSize) || !fixedValueValid(record + 12, poolSize)) {
+            return Mapped::error("indexed bytecode variable entry invalid");
+        }
+    }
+    for (size_t i = 0; i < stateCount; ++i) {
+        const uint8_t* record = data + stateTable + i * kIndexedStateSize;
+        for (size_t ref = 4; ref < kIndexedStateSize; ref += kStringRefSize) {
+            if (!refInPool(record + ref, poolSize)) {
+                return Mapped::error("indexed bytecode state entry invalid");
+            }
+        }
+    }
+    for (size_t i = 0; i < transitionCount; ++i) {
+        const uint8_t* record = data + transitionTable + i * kIndexedTransitionSize;
+        if (!fixedValueValid(record + 20, poolSize) || record[77] > static_cast<uint8_t>(CodeKind::Statement)) {
+            return Mapped::error("indexed bytecode transition entry invalid");
+        }
+        for (size_t ref = 29; ref + kStringRefSize <= 77; ref += kStringRefSize) {
+            if (!refInPool(record + ref, poolSize)) {
+                return Mapped::error("indexed bytecode transition entry invalid");
+            }
+        }
+    }
+
+    const uint8_t* pool = data + poolOffset;
+    MappedBytecodeProgram program;
+    program.versionMajor = byteorder::loadBig<uint16_t>(data + 8);
+    program.versionMinor = byteorder::loadBig<uint16_t>(data + 10);
+    program.initialState = byteorder::loadBig<uint16_t>(data + 12);
+    program.name = poolString(data + 20, pool);
+    program.variables = MappedRecords<BytecodeVariable>(
+        data + varTable, varCount, variableSize, pool,
+        withTelemetry ? &decodeIndexedTelemetryVariable : &decodeIndexedVariable);
+    program.states = MappedRecords<MappedState>(
+        data + stateTable, stateCount, kIndexedStateSize, pool, &decodeIndexedState);
+    program.transitions = MappedRecords<MappedTransition>(
+        data + transitionTable, transitionCount, kIndexedTransitionSize, pool, &decodeIndexedTransition);
+    return Mapped::ok(program);
+}
+
+// ============================================================================
+// BytecodeStreamDecoder
+// ============================================================================
+
+Result<void> BytecodeStreamDecoder::feed(const uint8_t* data, size_t len) {
+    if (failed_) {
+        return Result<void>::error("bytecode stream already failed");
+    }
+
+    // Decode straight from the caller's bytes unless a record is pending.
+    if (!window_.empty()) {
+        window_.insert(window_.end(), data, data + len);
+        data = window_.data();
+        len = window_.size();
+    }
+
+    size_t offset = 0;
+    while (stage_ != Stage::Done) {
+        size_t cursor = offset;
+        auto step = parseNext(data, len, cursor);
+        if (step.isError()) {
+            failed_ = true;
+            return Result<void>::error(step.error());
+        }
+        if (!step.value()) {
+            break;
+        }
+        offset = cursor;
+    }
+
+    if (stage_ == Stage::Done && offset < len) {
+        failed_ = true;
+        return Result<void>::error("bytecode payload trailing bytes");
+    }
+
+    if (!window_.empty()) {
+        window_.erase(window_.begin(), window_.begin() + static_cast<std::ptrdiff_t>(offset));
+    } else {
+        window_.assign(data + offset, data + len);
+    }
+    peakWindow_ = std::max(peakWindow_, window_.size());
+    return Result<void>::ok();
+}
+
+Result<void> BytecodeStreamDecoder::finish() {
+    if (failed_) {
+        return Result<void>::error("bytecode stream already failed");
+    }
+    switch (stage_) {
+        case Stage::Header:
+            return Result<void>::error(window_.size() < kBytecodeMagic.size() + 14
+                ? "bytecode payload too small"
+                : "bytecode header truncated");
+        case Stage::Variables:
+            return Result<void>::error("bytecode variable entry truncated");
+        case Stage::States:
+            return Result<void>::error("bytecode state entry truncated");
+        case Stage::Transitions:
+            return Result<void>::error("bytecode transition entry truncated");
+        case Stage::LuaHeader:
+        case Stage::LuaChunks:
+            return Result<void>::error("bytecode lua chunk truncated");
+        case Stage::Done:
+            break;
+    }
+    return Result<void>::ok();
+}
+
+void BytecodeStreamDecoder::advanceSection() {
+    while (remaining_ == 0 && stage_ != Stage::Done) {
+        switch (stage_) {
+            case Stage::Header:
+            case Stage::Variables:
+                stage_ = Stage::States;
+                remaining_ = stateCount_;
+                break;
+            case Stage::States:
+                stage_ = Stage::Transitions;
+                remaining_ = transitionCount_;
+                break;
+            case Stage::Transitions:
+                if (program_.versionMinor >= BYTECODE_LUA_CHUNKS_MINOR) {
+                    stage_ = Stage::LuaHeader;
+                    return;
+                }
+                stage_ = Stage::Done;
+                break;
+            case Stage::LuaHeader:
+                stage_ = Stage::LuaChunks;
+                remaining_ = luaChunkCount_;
+                break;
+            case Stage::LuaChunks:
+            case Stage::Done:
+                stage_ = Stage::Done;
+                break;
+        }
+    }
+}
+
+Result<bool> BytecodeStreamDecoder::parseNext(const uint8_t* data, size_t size, size_t& offset) {
+    const ByteSpan bytes(data, size);
+
+    switch (stage_) {
+        case Stage::Header: {
+            if (size - offset < kBytecodeMagic.size()) {
+                return Result<bool>::ok(false);
+            }
+            if (!std::equal(kBytecodeMagic.begin(), kBytecodeMagic.end(), data + offset)) {
+                return Result<bool>::error("invalid bytecode magic");
+            }
+            offset += kBytecodeMagic.size();
+
+            uint16_t varCount = 0;
+            if (!readU16(bytes, offset, program_.versionMajor) || !readU16(bytes, offset, program_.versionMinor) ||
+                !readSizedString(bytes, offset, program_.name) ||
+                !readU16(bytes, offset, program_.initialState) ||
+                !readU16(bytes, offset, varCount) || !readU16(bytes, offset, stateCount_) ||
+                !readU16(bytes, offset, transitionCount_)) {
+                return Result<bool>::ok(false);
+            }
+            program_.variables.reserve(varCount);
+            program_.states.reserve(stateCount_);
+            program_.transitions.reserve(transitionCount_);
+            stage_ = Stage::Variables;
+            remaining_ = varCount;
+            advanceSection();
+            return Result<bool>::ok(true);
+        }
+
+        case Stage::Variables: {
+            BytecodeVariable v;
+            uint8_t rawType = 0;
+            uint8_t rawDir = 0;
+            if (!readU16(bytes, offset, v.id) || !readU8(bytes, offset, rawType) || !readU8(bytes, offset, rawDir) ||
+                !readSizedString(bytes, offset, v.name)) {
+                return Result<bool>::ok(false);
+            }
+            v.type = static_cast<ValueType>(rawType);
+            v.direction = static_cast<VariableDirection>(rawDir);
+            auto valueRes = readValue(bytes, offset, v.initialValue);
+            if (valueRes.isError() || !valueRes.value()) {
+                return valueRes;
+            }
+            if (program_.versionMinor >= BYTECODE_TELEMETRY_MINOR) {
+                uint64_t deadbandBits = 0;
+                if (!readU32(bytes, offset, v.telemetry.windowMs) || !readU32(bytes, offset, v.telemetry.slideMs) ||
+                    !readU64(bytes, offset, deadbandBits) || !readU32(bytes, offset, v.telemetry.minIntervalMs)) {
+                    return Result<bool>::ok(false);
+                }
+                std::memcpy(&v.telemetry.deadband, &deadbandBits, sizeof(deadbandBits));
+            }
+            program_.variables.push_back(std::move(v));
+            break;
+        }
+
+        case Stage::States: {
+            BytecodeState st;
+            if (!readU16(bytes, offset, st.id) ||
+                !readSizedString(bytes, offset, st.name) ||
+                !readSizedString(bytes, offset, st.onEnterSource) ||
+                !readSizedString(bytes, offset, st.bodySource) ||
+                !readSizedString(bytes, offset, st.onExitSource)) {
+                return Result<bool>::ok(false);
+            }
+            program_.states.push_back(std::move(st));
+            break;
+        }
+
+        case Stage::Transitions: {
+            BytecodeTransition t;
+            uint8_t rawKind = 0;
+            uint8_t rawPriority = 0;
+            uint8_t rawEnabled = 0;
+            uint8_t rawConditionKind = 0;
+            uint16_t rawWeight = 0;
+            uint8_t rawSignalDirection = 0;
+            uint8_t rawTriggerType = 0;
+            uint8_t rawHasThreshold = 0;
+            uint8_t rawThresholdOp = 0;
+            uint8_t rawThresholdOneShot = 0;
+            uint8_t ignoredReserved2 = 0;
+            if (!readU16(bytes, offset, t.id) ||
+                !readU16(bytes, offset, t.from) ||
+                !readU16(bytes, offset, t.to) ||
+                !readU8(bytes, offset, rawKind) ||
+                !readU8(bytes, offset, rawPriority) ||
+                !readU8(bytes, offset, rawEnabled) ||
+                !readU8(bytes, offset, rawConditionKind) ||
+                !readU16(bytes, offset, rawWeight) ||
+                !readU32(bytes, offset, t.delayMs) ||
+                !readSizedString(bytes, offset, t.conditionExpression) ||
+                !readSizedString(bytes, offset, t.bodySource) ||
+                !readSizedString(bytes, offset, t.triggeredSource) ||
+                !readU8(bytes, offset, rawSignalDirection) ||
+                !readU8(bytes, offset, rawTriggerType) ||
+                !readU8(bytes, offset, rawHasThreshold) ||
+                !readU8(bytes, offset, rawThresholdOp) ||
+                !readU8(bytes, offset, rawThresholdOneShot) ||
+                !readU8(bytes, offset, ignoredReserved2)) {
+                return Result<bool>::ok(false);
+            }
+            auto thresholdValueRes = readValue(bytes, offset, t.eventThresholdValue);
+            if (thresholdValueRes.isError() || !thresholdValueRes.value()) {
+                return thresholdValueRes;
+            }
+            if (!readSizedString(bytes, offset, t.eventSignalName) ||
+                !readSizedString(bytes, offset, t.eventPattern) ||
+                !readSizedString(bytes, offset, t.name)) {
+                return Result<bool>::ok(false);
+            }
+            (void) ignoredReserved2;
+            if (program_.versionMinor >= BYTECODE_CODE_KINDS_MINOR) {
+                if (rawConditionKind > static_cast<uint8_t>(CodeKind::Statement)) {
+                    return Result<bool>::error("bytecode transition code kind invalid");
+                }
+                t.conditionKind = static_cast<CodeKind>(rawConditionKind);
+            }
+            t.kind = static_cast<BytecodeTransitionKind>(rawKind);
+            t.priority = rawPriority;
+            t.enabled = rawEnabled != 0;
+            t.weight = rawWeight;
+            t.eventSignalDirection = static_cast<VariableDirection>(rawSignalDirection);
+            t.eventTriggerType = static_cast<EventTrigger>(rawTriggerType);
+            t.eventHasThreshold = rawHasThreshold != 0;
+            t.eventThresholdOp = static_cast<CompareOp>(rawThresholdOp);
+            t.eventThresholdOneShot = rawThresholdOneShot != 0;
+            program_.transitions.push_back(std::move(t));
+            break;
+        }
+
+        case Stage::LuaHeader: {
+            auto& target = program_.luaTarget;
+            if (!readU16(bytes, offset, target.luaVersion) || !readU8(bytes, offset, target.wordSize) ||
+                !readU8(bytes, offset, target.integerSize) || !readU8(bytes, offset, target.numberSize) ||
+                !readU16(bytes, offset, luaChunkCount_)) {
+                return Result<bool>::ok(false);
+            }
+            program_.luaChunks.reserve(luaChunkCount_);
+            advanceSection();
+            return Result<bool>::ok(true);
+        }
+
+        case Stage::LuaChunks: {
+            BytecodeLuaChunk chunk;
+            uint8_t rawSlot = 0;
+            uint32_t length = 0;
+            if (!readU8(bytes, offset, rawSlot) || !readU16(bytes, offset, chunk.ownerId) ||
+                !readU32(bytes, offset, length) || size - offset < length) {
+                return Result<bool>::ok(false);
+            }
+            if (rawSlot < static_cast<uint8_t>(LuaChunkSlot::StateOnEnter) ||
+                rawSlot > static_cast<uint8_t>(LuaChunkSlot::TransitionTriggered)) {
+                return Result<bool>::error("bytecode lua chunk slot invalid");
+            }
+            chunk.slot = static_cast<LuaChunkSlot>(rawSlot);
+            chunk.bytes.assign(data + offset, data + offset + length);
+            offset += length;
+            program_.luaChunks.push_back(std::move(chunk));
+            break;
+        }
+
+        case Stage::Done:
+            return Result<bool>::ok(false);
+    }
+
+    --remaining_;
+    advanceSection();
+    return Result<bool>::ok(true);
+}
+
+// ============================================================================
+// ArtifactStreamDecoder
+// ============================================================================
+
+Result<void> ArtifactStreamDecoder::feed(const uint8_t* data, size_t len) {
+    if (failed_) {
+        return Result<void>::error("artifact stream already failed");
+    }
+    bytesFed_ += len;
+    if (maxBytes_ != 0 && bytesFed_ > maxBytes_) {
+        failed_ = true;
+        return Result<void>::error("artifact exceeds load limit");
+    }
+
+    while (len > 0) {
+        switch (stage_) {
+            case Stage::Header: {
+                const size_t take = std::min(len, kArtifactHeaderSize - head_.size());
+                head_.insert(head_.end(), data, data + take);
+                data += take;
+                len -= take;
+                if (head_.size() == kArtifactHeaderSize) {
+                    auto header = parseHeader();
+                    if (header.isError()) {
+                        failed_ = true;
+                        return header;
+                    }
+                }
+                break;
+            }
+            case Stage::SourceLabel: {
+                const size_t take = std::min(len, sourceLabelLen_ - artifact_.sourceLabel.size());
+                artifact_.sourceLabel.append(reinterpret_cast<const char*>(data), take);
+                data += take;
+                len -= take;
+                if (artifact_.sourceLabel.size() == sourceLabelLen_) {
+                    stage_ = payloadLen_ == 0 ? Stage::Done : Stage::Payload;
+                }
+                break;
+            }
+            case Stage::Payload: {
+                const size_t take = std::min<size_t>(len, payloadLen_ - payloadSeen_);
+                if (artifact_.payloadKind == PayloadKind::EngineBytecode) {
+                    auto fed = bytecode_.feed(data, take);
+                    if (fed.isError()) {
+                        failed_ = true;
+                        return fed;
+                    }
+                } else {
+                    artifact_.payloadBytes.insert(artifact_.payloadBytes.end(), data, data + take);
+                }
+                data += take;
+                len -= take;
+                payloadSeen_ += static_cast<uint32_t>(take);
+                if (payloadSeen_ == payloadLen_) {
+                    stage_ = Stage::Done;
+                }
+                break;
+            }
+            case Stage::Done:
+                failed_ = true;
+                return Result<void>::error("artifact size mismatch");
+        }
+    }
+    return Result<void>::ok();
+}
+
+Result<void> ArtifactStreamDecoder::parseHeader() {
+    if (!std::equal(kMagic.begin(), kMagic.end(), head_.begin())) {
+        return Result<void>::error("invalid artifact magic");
+    }
+    size_t offset = kMagic.size();
+    artifact_.header.format = static_cast<ArtifactFormat>(head_[offset++]);
+    if (artifact_.header.format != ArtifactFormat::AethIrV1) {
+        return Result<void>::error("unknown artifact format");
+    }
+    readU16(head_, offset, artifact_.header.versionMajor);
+    readU16(head_, offset, artifact_.header.versionMinor);
+    artifact_.payloadKind = static_cast<PayloadKind>(head_[offset++]);
+    readU16(head_, offset, sourceLabelLen_);
+    readU32(head_, offset, payloadLen_);
+
+    if (artifact_.payloadKind != PayloadKind::YamlText && artifact_.payloadKind != PayloadKind::EngineBytecode &&
+        artifact_.payloadKind != PayloadKind::EngineBytecodeIndexed) {
+        return Result<void>::error("unsupported artifact payload kind");
+    }
+    if (maxBytes_ != 0 && kArtifactHeaderSize + sourceLabelLen_ + static_cast<size_t>(payloadLen_) > maxBytes_) {
+        return Result<void>::error("artifact exceeds load limit");
+    }
+    if (artifact_.payloadKind != PayloadKind::EngineBytecode) {
+        artifact_.payloadBytes.reserve(payloadLen_);
+    }
+    artifact_.sourceLabel.reserve(sourceLabelLen_);
+
+    stage_ = sourceLabelLen_ > 0 ? Stage::SourceLabel : (payloadLen_ > 0 ? Stage::Payload : Stage::Done);
+    return Result<void>::ok();
+}
+
+Result<void> ArtifactStreamDecoder::finish() {
+    if (failed_) {
+        return Result<void>::error("artifact stream already failed");
+    }
+    if (stage_ == Stage::Header) {
+        return Result<void>::error("artifact too small");
+    }
+    if (stage_ != Stage::Done) {
+        return Result<void>::error("artifact size mismatch");
+    }
+    if (artifact_.payloadKind == PayloadKind::EngineBytecode) {
+        auto finished = bytecode_.finish();
+        if (finished.isError()) {
+            return Result<void>::error("engine bytecode decode failed: " + finished.error());
+        }
+    }
+    return Result<void>::ok();
+}
+
+size_t ArtifactStreamDecoder::peakBufferedBytes() const {
+    if (artifact_.payloadKind == PayloadKind::EngineBytecode) {
+        return kArtifactHeaderSize + bytecode_.peakBufferedBytes();
+    }
+    return kArtifactHeaderSize + artifact_.payloadBytes.size();
 }
 
 Result<AutomataArtifact> makeEngineBytecodeArtifact(const EngineBytecodeProgram& program,
@@ -481,4 +1288,21 @@ Result<AutomataArtifact> makeEngineBytecodeArtifact(const EngineBytecodeProgram&
     return Result<AutomataArtifact>::ok(std::move(artifact));
 }
 
+Result<AutomataArtifact> makeIndexedBytecodeArtifact(const EngineBytecodeProgram& program,
+                                                     std::string sourceLabel) {
+    auto payload = serializeIndexedBytecodeProgram(program);
+    if (payload.isError()) {
+        return Result<AutomataArtifact>::error(payload.error());
+    }
+
+    AutomataArtifact artifact;
+    artifact.header.format = ArtifactFormat::AethIrV1;
+    artifact.header.versionMajor = 0;
+    artifact.header.versionMinor = 1;
+    artifact.payloadKind = PayloadKind::EngineBytecodeIndexed;
+    artifact.sourceLabel = sourceLabel.empty() ? "." : std::move(sourceLabel);
+    artifact.payloadBytes = std::move(payload.value());
+    return Result<AutomataArtifact>::ok(std::move(artifact));
+}
+
 } // namespace aeth::ir
@@ -1,10 +1,13 @@
 #ifndef AETHERIUM_ARTIFACT_HPP
 #define AETHERIUM_ARTIFACT_HPP
 
+#include "lua_chunk.hpp"
 #include "types.hpp"
+#include "variable.hpp"
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace aeth::ir {
@@ -15,7 +18,9 @@ enum class ArtifactFormat : uint8_t {
 
 enum class PayloadKind : uint8_t {
     YamlText = 1,
-    EngineBytecode = 2
+    EngineBytecode = 2,
+    // Offset-table layout (AETHBC02) that can be read in place from a mapping
+    EngineBytecodeIndexed = 3
 };
 
 struct ArtifactHeader {
@@ -45,6 +50,7 @@ struct BytecodeVariable {
     ValueType type = ValueType::Void;
     VariableDirection direction = VariableDirection::Internal;
     Value initialValue;
+    TelemetryPolicy telemetry;  // Carried from BYTECODE_TELEMETRY_MINOR
 };
 
 struct BytecodeState {
@@ -66,6 +72,7 @@ struct BytecodeTransition {
     uint16_t weight = 100;
     uint32_t delayMs = 0;
     std::string conditionExpression;
+    CodeKind conditionKind = CodeKind::Contextual;  // As parsed; Contextual compiles as an expression
     std::string bodySource;
     std::string triggeredSource;
     std::string eventSignalName;
@@ -76,8 +83,36 @@ struct BytecodeTransition {
     Value eventThresholdValue;
     bool eventThresholdOneShot = false;
     std::string eventPattern;
+
+    // Kind the guard is compiled as, here and by the engine at load
+    [[nodiscard]] CodeKind resolvedConditionKind() const {
+        return conditionKind == CodeKind::Contextual ? CodeKind::Expression : conditionKind;
+    }
+};
+
+// Code block a precompiled Lua chunk belongs to
+enum class LuaChunkSlot : uint8_t {
+    StateOnEnter = 1,
+    StateBody = 2,
+    StateOnExit = 3,
+    TransitionCondition = 4,  // Compiled as BytecodeTransition::resolvedConditionKind()
+    TransitionBody = 5,
+    TransitionTriggered = 6
 };
 
+struct BytecodeLuaChunk {
+    LuaChunkSlot slot = LuaChunkSlot::StateBody;
+    uint16_t ownerId = 0;  // StateId or TransitionId, by slot
+    std::vector<uint8_t> bytes;  // lua_dump output
+};
+
+// Payloads carrying Lua chunks are written with this minor version
+constexpr uint16_t BYTECODE_LUA_CHUNKS_MINOR = 2;
+// From this minor version a transition record carries its guard's CodeKind
+constexpr uint16_t BYTECODE_CODE_KINDS_MINOR = 3;
+// From this minor version a variable record carries its TelemetryPolicy
+constexpr uint16_t BYTECODE_TELEMETRY_MINOR = 4;
+
 struct EngineBytecodeProgram {
     uint16_t versionMajor = 0;
     uint16_t versionMinor = 1;
@@ -86,16 +121,206 @@ struct EngineBytecodeProgram {
     std::vector<BytecodeVariable> variables;
     std::vector<BytecodeState> states;
     std::vector<BytecodeTransition> transitions;
+    // Optional; sources stay authoritative when the target does not match
+    LuaChunkTarget luaTarget;
+    std::vector<BytecodeLuaChunk> luaChunks;
+};
+
+/**
+ * Records of an indexed payload as views into the payload bytes. Field
+ * names match BytecodeState / BytecodeTransition so converters can take
+ * either one.
+ */
+struct MappedState {
+    StateId id = INVALID_STATE;
+    std::string_view name;
+    std::string_view onEnterSource;
+    std::string_view bodySource;
+    std::string_view onExitSource;
+};
+
+struct MappedTransition {
+    TransitionId id = INVALID_TRANSITION;
+    std::string_view name;
+    StateId from = INVALID_STATE;
+    StateId to = INVALID_STATE;
+    BytecodeTransitionKind kind = BytecodeTransitionKind::Immediate;
+    uint8_t priority = 0;
+    bool enabled = true;
+    uint16_t weight = 100;
+    uint32_t delayMs = 0;
+    std::string_view conditionExpression;
+    CodeKind conditionKind = CodeKind::Contextual;
+    std::string_view bodySource;
+    std::string_view triggeredSource;
+    std::string_view eventSignalName;
+    VariableDirection eventSignalDirection = VariableDirection::Input;
+    EventTrigger eventTriggerType = EventTrigger::OnChange;
+    bool eventHasThreshold = false;
+    CompareOp eventThresholdOp = CompareOp::Gt;
+    Value eventThresholdValue;
+    bool eventThresholdOneShot = false;
+    std::string_view eventPattern;
+};
+
+/**
+ * Fixed-stride record table inside an indexed payload. Indexing decodes
+ * one record; nothing is copied up front.
+ */
+template <typename Record>
+class MappedRecords {
+public:
+    using Decoder = Record (*)(const uint8_t* record, const uint8_t* pool);
+
+    class Iterator {
+    public:
+        Iterator(const MappedRecords* records, size_t index) : records_(records), index_(index) {}
+        Record operator*() const { return (*records_)[index_]; }
+        Iterator& operator++() {
+            ++index_;
+            return *this;
+        }
+        bool operator!=(const Iterator& other) const { return index_ != other.index_; }
+
+    private:
+        const MappedRecords* records_;
+        size_t index_;
+    };
+
+    MappedRecords() = default;
+    MappedRecords(const uint8_t* base, size_t count, size_t stride, const uint8_t* pool, Decoder decode)
+        : base_(base), count_(count), stride_(stride), pool_(pool), decode_(decode) {}
+
+    [[nodiscard]] size_t size() const { return count_; }
+    [[nodiscard]] bool empty() const { return count_ == 0; }
+    Record operator[](size_t i) const { return decode_(base_ + i * stride_, pool_); }
+    [[nodiscard]] Iterator begin() const { return Iterator(this, 0); }
+    [[nodiscard]] Iterator end() const { return Iterator(this, count_); }
+
+private:
+    const uint8_t* base_ = nullptr;
+    size_t count_ = 0;
+    size_t stride_ = 0;
+    const uint8_t* pool_ = nullptr;
+    Decoder decode_ = nullptr;
+};
+
+/**
+ * An indexed (AETHBC02) payload read in place. open() bounds-checks every
+ * record and string once; afterwards records decode on access and their
+ * strings point into the payload, which must outlive this view and
+ * anything built from it.
+ */
+struct MappedBytecodeProgram {
+    uint16_t versionMajor = 0;
+    uint16_t versionMinor = 1;
+    std::string_view name;
+    StateId initialState = INVALID_STATE;
+    MappedRecords<BytecodeVariable> variables;  // Small; decoded to owning records
+    MappedRecords<MappedState> states;
+    MappedRecords<MappedTransition> transitions;
+
+    static Result<MappedBytecodeProgram> open(const uint8_t* data, size_t size);
+};
+
+/**
+ * Envelope of a serialized artifact without copying its payload.
+ */
+struct ArtifactView {
+    ArtifactHeader header;
+    PayloadKind payloadKind = PayloadKind::YamlText;
+    std::string_view sourceLabel;
+    const uint8_t* payload = nullptr;
+    size_t payloadSize = 0;
 };
 
+Result<ArtifactView> viewArtifact(const uint8_t* data, size_t size);
+[[nodiscard]] bool hasArtifactMagic(const uint8_t* data, size_t size);
+
 Result<std::vector<uint8_t>> serializeArtifact(const AutomataArtifact& artifact);
 Result<AutomataArtifact> deserializeArtifact(const std::vector<uint8_t>& bytes);
 Result<std::vector<uint8_t>> serializeEngineBytecodeProgram(const EngineBytecodeProgram& program);
 Result<EngineBytecodeProgram> deserializeEngineBytecodeProgram(const std::vector<uint8_t>& bytes);
+Result<std::vector<uint8_t>> serializeIndexedBytecodeProgram(const EngineBytecodeProgram& program);
+
+/**
+ * Incremental decoder for an engine bytecode payload. Records (variables,
+ * states, transitions) are decoded as soon as their last byte arrives;
+ * only a record that straddles two feed() calls is buffered.
+ */
+class BytecodeStreamDecoder {
+public:
+    Result<void> feed(const uint8_t* data, size_t len);
+    // Fails if the payload ended mid-record or before the last section
+    Result<void> finish();
+
+    [[nodiscard]] EngineBytecodeProgram& program() { return program_; }
+    [[nodiscard]] size_t peakBufferedBytes() const { return peakWindow_; }
+
+private:
+    enum class Stage : uint8_t { Header, Variables, States, Transitions, LuaHeader, LuaChunks, Done };
+
+    Result<bool> parseNext(const uint8_t* data, size_t size, size_t& offset);
+    void advanceSection();
+
+    EngineBytecodeProgram program_;
+    Stage stage_ = Stage::Header;
+    uint16_t remaining_ = 0;  // Records left in the current section
+    uint16_t stateCount_ = 0;
+    uint16_t transitionCount_ = 0;
+    uint16_t luaChunkCount_ = 0;
+    std::vector<uint8_t> window_;
+    size_t peakWindow_ = 0;
+    bool failed_ = false;
+};
+
+/**
+ * Incremental decoder for a serialized artifact (AETHIRV1 envelope). Used
+ * by chunked loads so the artifact never has to be reassembled: bytecode
+ * payloads go straight to a BytecodeStreamDecoder. YAML and indexed
+ * payloads cannot be parsed incrementally and are accumulated in
+ * payloadBytes().
+ */
+class ArtifactStreamDecoder {
+public:
+    // maxBytes bounds the whole artifact; 0 = unlimited
+    explicit ArtifactStreamDecoder(size_t maxBytes = 0) : maxBytes_(maxBytes) {}
+
+    Result<void> feed(const uint8_t* data, size_t len);
+    Result<void> finish();
+
+    [[nodiscard]] PayloadKind payloadKind() const { return artifact_.payloadKind; }
+    [[nodiscard]] const std::string& sourceLabel() const { return artifact_.sourceLabel; }
+    // After finish(): YAML text or indexed payload (empty for streamed bytecode)
+    [[nodiscard]] std::vector<uint8_t>& payloadBytes() { return artifact_.payloadBytes; }
+    // After finish(): decoded program (bytecode payloads)
+    [[nodiscard]] EngineBytecodeProgram& program() { return bytecode_.program(); }
+    [[nodiscard]] size_t bytesFed() const { return bytesFed_; }
+    // Largest amount of undecoded input held at once
+    [[nodiscard]] size_t peakBufferedBytes() const;
+
+private:
+    enum class Stage : uint8_t { Header, SourceLabel, Payload, Done };
+
+    Result<void> parseHeader();
+
+    size_t maxBytes_ = 0;
+    size_t bytesFed_ = 0;
+    Stage stage_ = Stage::Header;
+    std::vector<uint8_t> head_;
+    AutomataArtifact artifact_;
+    uint16_t sourceLabelLen_ = 0;
+    uint32_t payloadLen_ = 0;
+    uint32_t payloadSeen_ = 0;
+    BytecodeStreamDecoder bytecode_;
+    bool failed_ = false;
+};
 
 AutomataArtifact makeYamlArtifact(std::string yaml, std::string sourceLabel = ".");
 Result<AutomataArtifact> makeEngineBytecodeArtifact(const EngineBytecodeProgram& program,
                                                     std::string sourceLabel = ".");
+Result<AutomataArtifact> makeIndexedBytecodeArtifact(const EngineBytecodeProgram& program,
+                                                     std::string sourceLabel = ".");
 
 } // namespace aeth::ir
 
@@ -0,0 +1,953 @@
+#include "automata_analysis.hpp"
+
+#include "work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string_view>
+
+namespace aeth {
+
+namespace {
+
+constexpr size_t kTransitionChunk = 1024;
+constexpr size_t kStateChunk = 512;
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+// ============================================================================
+// Structural hash
+// ============================================================================
+
+struct Hasher {
+    uint64_t value = 14695981039346656037ull;
+
+    void bytes(const void* data, size_t len) {
+        const auto* p = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < len; ++i) {
+            value = (value ^ p[i]) * 1099511628211ull;
+        }
+    }
+    template <typename T>
+    void pod(T v) {
+        bytes(&v, sizeof(v));
+    }
+    void text(std::string_view s) {
+        pod<uint64_t>(s.size());
+        bytes(s.data(), s.size());
+    }
+    void code(const CodeBlock& c) {
+        text(c.source.empty() ? c.mappedSource : std::string_view(c.source));
+        pod(c.kind);
+        pod<uint64_t>(c.bytecode.size());
+        bytes(c.bytecode.data(), c.bytecode.size());
+    }
+    void constant(const Value& v) {
+        pod(v.type());
+        if (v.is<std::string>()) {
+            text(v.str());
+        } else {
+            pod(v.toDouble());
+        }
+    }
+};
+
+// ============================================================================
+// Transition conditions
+// ============================================================================
+
+// Values of one variable (or of time in state) a condition allows
+struct Interval {
+    double lo = -kInf;
+    double hi = kInf;
+    bool loOpen = false;
+    bool hiOpen = false;
+
+    [[nodiscard]] bool empty() const { return lo > hi || (lo == hi && (loOpen || hiOpen)); }
+};
+
+Interval intervalOf(CompareOp op, double c, bool integral) {
+    Interval range;
+    switch (op) {
+        case CompareOp::Gt: range.lo = c; range.loOpen = true; break;
+        case CompareOp::Ge: range.lo = c; break;
+        case CompareOp::Lt: range.hi = c; range.hiOpen = true; break;
+        case CompareOp::Le: range.hi = c; break;
+        case CompareOp::Eq: range.lo = c; range.hi = c; break;
+        case CompareOp::Ne: break;  // Not an interval; callers don't ask
+    }
+    if (integral) {
+        // Closed integer bounds, so x > 1 and x < 2 come out empty
+        range.lo = range.loOpen ? std::floor(range.lo) + 1 : std::ceil(range.lo);
+        range.hi = range.hiOpen ? std::ceil(range.hi) - 1 : std::floor(range.hi);
+        range.loOpen = range.hiOpen = false;
+    }
+    return range;
+}
+
+Interval intersect(const Interval& a, const Interval& b) {
+    Interval out = a;
+    if (b.lo > out.lo || (b.lo == out.lo && b.loOpen)) {
+        out.lo = b.lo;
+        out.loOpen = b.loOpen;
+    }
+    if (b.hi < out.hi || (b.hi == out.hi && b.hiOpen)) {
+        out.hi = b.hi;
+        out.hiOpen = b.hiOpen;
+    }
+    return out;
+}
+
+// Conjunction of per-variable intervals, sorted by variable
+using Box = std::vector<std::pair<VariableId, Interval>>;
+
+// False when the intersection is empty
+bool intersect(const Box& a, const Box& b, Box& out) {
+    out.clear();
+    size_t i = 0;
+    size_t j = 0;
+    while (i < a.size() || j < b.size()) {
+        if (j == b.size() || (i < a.size() && a[i].first < b[j].first)) {
+            out.push_back(a[i++]);
+        } else if (i == a.size() || b[j].first < a[i].first) {
+            out.push_back(b[j++]);
+        } else {
+            const Interval both = intersect(a[i++].second, b[j++].second);
+            if (both.empty()) {
+                return false;
+            }
+            out.emplace_back(a[i - 1].first, both);
+        }
+    }
+    return true;
+}
+
+struct Condition {
+    enum class Kind : uint8_t {
+        Never,   // Can never be enabled
+        Known,   // Enabled exactly when time in state is in `time` and the variables in `box`
+        Opaque,  // Script guard, timer or edge: satisfiable, not compared
+    };
+
+    Kind kind = Kind::Known;
+    Interval time{0, kInf};
+    Box box;
+    const char* never = nullptr;  // Why a Never condition never holds
+
+    [[nodiscard]] bool always() const {
+        return kind == Kind::Known && box.empty() && time.lo <= 0 && time.hi == kInf;
+    }
+};
+
+// A native guard program read back as a constant, a box, or neither
+class GuardReader {
+public:
+    explicit GuardReader(const std::vector<uint8_t>& integral) : integral_(integral) {}
+
+    // Fills `out` with Known (possibly Never) or Opaque
+    void read(ArrayView<GuardInstr> program, Condition& out) {
+        stack_.clear();
+        for (const GuardInstr& instr : program) {
+            if (!step(instr)) {
+                out.kind = Condition::Kind::Opaque;
+                return;
+            }
+        }
+        if (stack_.size() != 1) {
+            out.kind = Condition::Kind::Opaque;
+            return;
+        }
+        Term& result = stack_.back();
+        if (result.kind == Term::Variable && result.boolean) {
+            result = atom(result.variable, CompareOp::Eq, 1.0);
+        }
+        if (result.kind == Term::Number) {
+            if (result.number == 0.0) {
+                out.kind = Condition::Kind::Never;
+                out.never = "its guard is always false";
+            }
+            return;
+        }
+        if (result.kind == Term::Empty) {
+            out.kind = Condition::Kind::Never;
+            out.never = "its guard contradicts itself";
+            return;
+        }
+        if (result.kind != Term::Atoms) {
+            out.kind = Condition::Kind::Opaque;
+            return;
+        }
+        out.box = std::move(result.box);
+    }
+
+private:
+    struct Term {
+        enum Kind : uint8_t { Number, Variable, Atoms, Empty, Unknown };
+        Kind kind = Unknown;
+        double number = 0.0;
+        VariableId variable = INVALID_VARIABLE;
+        bool boolean = false;
+        Box box;
+
+        static Term constant(double value) {
+            Term term;
+            term.kind = Number;
+            term.number = value;
+            return term;
+        }
+        static Term of(Kind kind) {
+            Term term;
+            term.kind = kind;
+            return term;
+        }
+    };
+
+    [[nodiscard]] bool integral(VariableId id) const { return id < integral_.size() && integral_[id]; }
+
+    Term atom(VariableId id, CompareOp op, double c) const {
+        Term term;
+        const Interval range = intervalOf(op, c, integral(id));
+        term.kind = range.empty() ? Term::Empty : Term::Atoms;
+        term.box.emplace_back(id, range);
+        return term;
+    }
+
+    Term compare(const Term& a, const Term& b, CompareOp op) const {
+        Term term;
+        if (a.kind == Term::Number && b.kind == Term::Number) {
+            term.kind = Term::Number;
+            term.number = detail::compareGuardNumbers(a.number, b.number, op) ? 1.0 : 0.0;
+            return term;
+        }
+        const bool varLeft = a.kind == Term::Variable && b.kind == Term::Number;
+        const bool varRight = a.kind == Term::Number && b.kind == Term::Variable;
+        if (!varLeft && !varRight) {
+            return term;
+        }
+        const Term& var = varLeft ? a : b;
+        const double c = varLeft ? b.number : a.number;
+        if (!varLeft) {
+            // c <op> x is x <flipped op> c
+            switch (op) {
+                case CompareOp::Gt: op = CompareOp::Lt; break;
+                case CompareOp::Ge: op = CompareOp::Le; break;
+                case CompareOp::Lt: op = CompareOp::Gt; break;
+                case CompareOp::Le: op = CompareOp::Ge; break;
+                default: break;
+            }
+        }
+        if (op == CompareOp::Ne) {
+            if (!var.boolean || (c != 0.0 && c != 1.0)) {
+                return term;
+            }
+            return atom(var.variable, CompareOp::Eq, 1.0 - c);
+        }
+        return atom(var.variable, op, c);
+    }
+
+    Term conjoin(Term a, Term b) const {
+        for (Term* t : {&a, &b}) {
+            if (t->kind == Term::Variable && t->boolean) {
+                *t = atom(t->variable, CompareOp::Eq, 1.0);
+            }
+        }
+        if (a.kind == Term::Number || b.kind == Term::Number) {
+            const Term& constant = a.kind == Term::Number ? a : b;
+            const Term& other = a.kind == Term::Number ? b : a;
+            if (constant.number == 0.0) {
+                return constant;
+            }
+            return other.kind == Term::Number ? Term::constant(1.0) : other;
+        }
+        if (a.kind == Term::Empty || b.kind == Term::Empty) {
+            return Term::of(Term::Empty);
+        }
+        if (a.kind != Term::Atoms || b.kind != Term::Atoms) {
+            return Term{};
+        }
+        Term term;
+        term.kind = intersect(a.box, b.box, term.box) ? Term::Atoms : Term::Empty;
+        return term;
+    }
+
+    Term disjoin(const Term& a, const Term& b) const {
+        if (a.kind == Term::Number && b.kind == Term::Number) {
+            return Term::constant((a.number != 0.0 || b.number != 0.0) ? 1.0 : 0.0);
+        }
+        if (a.kind == Term::Number || b.kind == Term::Number) {
+            const Term& constant = a.kind == Term::Number ? a : b;
+            return constant.number != 0.0 ? Term::constant(1.0) : (a.kind == Term::Number ? b : a);
+        }
+        return Term{};
+    }
+
+    bool step(const GuardInstr& instr) {
+        switch (instr.op) {
+            case GuardOp::Number:
+                stack_.push_back(Term::constant(instr.number));
+                return true;
+            case GuardOp::Load:
+            case GuardOp::LoadBool: {
+                Term term;
+                term.kind = Term::Variable;
+                term.variable = instr.variable;
+                term.boolean = instr.op == GuardOp::LoadBool;
+                stack_.push_back(std::move(term));
+                return true;
+            }
+            case GuardOp::Changed:
+                stack_.push_back(Term{});
+                return true;
+            default:
+                break;
+        }
+
+        if (instr.op == GuardOp::Neg || instr.op == GuardOp::Not) {
+            if (stack_.empty()) {
+                return false;
+            }
+            Term& a = stack_.back();
+            if (a.kind == Term::Number) {
+                a.number = instr.op == GuardOp::Neg ? -a.number : (a.number == 0.0 ? 1.0 : 0.0);
+            } else if (instr.op == GuardOp::Not && a.kind == Term::Variable && a.boolean) {
+                a = atom(a.variable, CompareOp::Eq, 0.0);
+            } else {
+                a = Term{};
+            }
+            return true;
+        }
+
+        if (stack_.size() < 2) {
+            return false;
+        }
+        Term b = std::move(stack_.back());
+        stack_.pop_back();
+        Term a = std::move(stack_.back());
+        stack_.pop_back();
+        switch (instr.op) {
+            case GuardOp::Compare:
+                stack_.push_back(compare(a, b, instr.cmp));
+                break;
+            case GuardOp::And:
+                stack_.push_back(conjoin(std::move(a), std::move(b)));
+                break;
+            case GuardOp::Or:
+                stack_.push_back(disjoin(a, b));
+                break;
+            default: {
+                // Arithmetic folds between constants only
+                Term term;
+                if (a.kind == Term::Number && b.kind == Term::Number) {
+                    term.kind = Term::Number;
+                    switch (instr.op) {
+                        case GuardOp::Add: term.number = a.number + b.number; break;
+                        case GuardOp::Sub: term.number = a.number - b.number; break;
+                        case GuardOp::Mul: term.number = a.number * b.number; break;
+                        case GuardOp::Div: term.number = a.number / b.number; break;
+                        default: term.kind = Term::Unknown; break;
+                    }
+                }
+                stack_.push_back(std::move(term));
+                break;
+            }
+        }
+        return true;
+    }
+
+    const std::vector<uint8_t>& integral_;
+    std::vector<Term> stack_;
+};
+
+Condition conditionOf(const CompiledAutomata& compiled, const CompiledTransition& entry, GuardReader& reader) {
+    const Transition& t = *entry.transition;
+    Condition condition;
+    const CodeBlock* guard = nullptr;
+
+    switch (t.type) {
+        case TransitionType::Immediate:
+        case TransitionType::Probabilistic:
+            return condition;
+        case TransitionType::Classic:
+            guard = &t.classicConfig.condition;
+            if (t.classicConfig.onRisingEdge) {
+                condition.kind = Condition::Kind::Opaque;
+            }
+            break;
+        case TransitionType::Timed: {
+            guard = &t.timedConfig.additionalCondition;
+            const TimedConfig& timed = t.timedConfig;
+            switch (timed.mode) {
+                case TimedMode::After:
+                case TimedMode::Timeout:
+                    condition.time.lo = timed.delayMs;
+                    break;
+                case TimedMode::At:
+                    if (timed.delayMs > 0) {
+                        condition.time.lo = timed.delayMs;
+                    } else {
+                        condition.kind = Condition::Kind::Opaque;
+                    }
+                    break;
+                case TimedMode::Every:
+                    condition.kind = Condition::Kind::Opaque;
+                    break;
+                case TimedMode::Window:
+                    condition.time.lo = timed.delayMs;
+                    condition.time.hi = timed.windowEndMs > 0 ? timed.windowEndMs : kInf;
+                    if (condition.time.empty()) {
+                        condition.kind = Condition::Kind::Never;
+                        condition.never = "its window closes before it opens";
+                        return condition;
+                    }
+                    break;
+            }
+            break;
+        }
+        case TransitionType::Event: {
+            guard = &t.eventConfig.additionalCondition;
+            condition.kind = Condition::Kind::Opaque;
+            const auto triggers = compiled.triggers(entry);
+            size_t unknown = 0;
+            for (const CompiledTrigger& trigger : triggers) {
+                unknown += trigger.signal == INVALID_VARIABLE ? 1 : 0;
+            }
+            if (triggers.empty() && !t.eventConfig.requireAll) {
+                condition.kind = Condition::Kind::Never;
+                condition.never = "it has no triggers";
+                return condition;
+            }
+            if ((t.eventConfig.requireAll && unknown > 0) || (!triggers.empty() && unknown == triggers.size())) {
+                condition.kind = Condition::Kind::Never;
+                condition.never = "it triggers on unknown signals";
+                return condition;
+            }
+            break;
+        }
+    }
+
+    if (!guard || guard->isEmpty()) {
+        return condition;
+    }
+    const ArrayView<GuardInstr> program = compiled.guard(entry);
+    if (program.empty()) {
+        condition.kind = Condition::Kind::Opaque;
+        return condition;
+    }
+    Condition read;
+    reader.read(program, read);
+    if (read.kind == Condition::Kind::Never) {
+        return read;
+    }
+    if (condition.kind == Condition::Kind::Known) {
+        condition.kind = read.kind;
+        condition.box = std::move(read.box);
+    }
+    return condition;
+}
+
+bool overlaps(const Condition& a, const Condition& b) {
+    if (a.kind != Condition::Kind::Known || b.kind != Condition::Kind::Known) {
+        return false;
+    }
+    if (intersect(a.time, b.time).empty()) {
+        return false;
+    }
+    Box both;
+    return intersect(a.box, b.box, both);
+}
+
+template <typename Fn>
+void forEachChunk(WorkStealingPool* pool, size_t count, size_t chunk, const Fn& fn) {
+    if (!pool) {
+        for (size_t c = 0, begin = 0; begin < count; ++c, begin += chunk) {
+            fn(c, begin, std::min(count, begin + chunk));
+        }
+        return;
+    }
+    for (size_t c = 0, begin = 0; begin < count; ++c, begin += chunk) {
+        const size_t end = std::min(count, begin + chunk);
+        pool->submit([&fn, c, begin, end] { fn(c, begin, end); });
+    }
+    pool->waitIdle();
+}
+
+std::string quoted(const std::string& name) {
+    return "'" + name + "'";
+}
+
+bool testBit(const std::vector<uint64_t>& bits, size_t i) {
+    return (bits[i / 64] >> (i % 64)) & 1;
+}
+
+void setBit(std::vector<uint64_t>& bits, size_t i) {
+    bits[i / 64] |= uint64_t{1} << (i % 64);
+}
+
+unsigned lowestBit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(word));
+#else
+    unsigned n = 0;
+    while ((word & 1u) == 0) {
+        word >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+AutomataAnalysis analyzeWithHash(const Automata& automata, const CompiledAutomata& compiled,
+                                 const AnalysisOptions& options, uint64_t hash) {
+    AutomataAnalysis report;
+    report.hash = hash;
+    report.states = compiled.stateCount();
+    report.transitions = compiled.transitionCount();
+    const size_t stateCount = compiled.stateCount();
+    const size_t transitionCount = compiled.transitionCount();
+    const uint32_t initial = compiled.stateIndex(automata.initialState);
+    if (initial == CompiledAutomata::INVALID_INDEX) {
+        return report;  // validate() reports it
+    }
+
+    std::vector<uint8_t> integral;
+    for (const auto& spec : automata.variables) {
+        if (spec.id >= integral.size()) {
+            integral.resize(static_cast<size_t>(spec.id) + 1, 0);
+        }
+        integral[spec.id] = spec.type == ValueType::Bool || spec.type == ValueType::Int32 ||
+                            spec.type == ValueType::Int64;
+    }
+
+    std::unique_ptr<WorkStealingPool> pool;
+    if (options.workers != 1 && transitionCount >= options.parallelTransitions) {
+        pool = std::make_unique<WorkStealingPool>(options.workers);
+    }
+
+    // What enables each transition
+    std::vector<Condition> conditions(transitionCount);
+    forEachChunk(pool.get(), transitionCount, kTransitionChunk, [&](size_t, size_t begin, size_t end) {
+        GuardReader reader(integral);
+        for (size_t k = begin; k < end; ++k) {
+            conditions[k] = conditionOf(compiled, compiled.transitionAt(static_cast<uint32_t>(k)), reader);
+        }
+    });
+
+    // Per state: which transitions can ever fire, and the findings about them
+    std::vector<uint8_t> viable(transitionCount, 0);
+    const size_t stateChunks = (stateCount + kStateChunk - 1) / kStateChunk;
+    std::vector<std::vector<AnalysisFinding>> stateFindings(stateChunks);
+    forEachChunk(pool.get(), stateCount, kStateChunk, [&](size_t c, size_t begin, size_t end) {
+        auto& findings = stateFindings[c];
+        for (size_t s = begin; s < end; ++s) {
+            const CompiledState& state = compiled.stateAt(static_cast<uint32_t>(s));
+            const StateId stateId = state.state->id;
+            const Transition* blocker = nullptr;  // Higher-priority group that always decides
+            const char* blockedBy = nullptr;
+
+            for (const PriorityGroup& group : compiled.groups(state)) {
+                // Resolution takes the first enabled candidate of an unweighted
+                // group and only falls back to timeouts when none is enabled
+                bool weighted = false;
+                uint32_t alwaysAt = group.end;
+                for (uint32_t k = group.begin; k < group.end; ++k) {
+                    const CompiledTransition& entry = compiled.transitionAt(k);
+                    weighted = weighted || entry.weighted;
+                    if (alwaysAt == group.end && !entry.timeout && conditions[k].always()) {
+                        alwaysAt = k;
+                    }
+                }
+                const Transition* alwaysFirst =
+                    alwaysAt < group.end ? compiled.transitionAt(alwaysAt).transition : nullptr;
+
+                for (uint32_t k = group.begin; k < group.end; ++k) {
+                    const CompiledTransition& entry = compiled.transitionAt(k);
+                    const Transition& t = *entry.transition;
+                    const Condition& condition = conditions[k];
+                    AnalysisFinding finding;
+                    finding.kind = FindingKind::UnreachableTransition;
+                    finding.state = stateId;
+                    finding.transition = t.id;
+
+                    if (condition.kind == Condition::Kind::Never) {
+                        finding.message = "transition " + quoted(t.name) + " can never fire: " + condition.never;
+                    } else if (blocker) {
+                        finding.other = blocker->id;
+                        finding.message = "transition " + quoted(t.name) + " is never evaluated: " +
+                                          quoted(blocker->name) + blockedBy;
+                    } else if (alwaysFirst && (entry.timeout || (k > alwaysAt && !weighted))) {
+                        finding.other = alwaysFirst->id;
+                        finding.message = "transition " + quoted(t.name) + " never wins: " +
+                                          quoted(alwaysFirst->name) +
+                                          " of the same priority is always enabled and resolved first";
+                    } else {
+                        viable[k] = 1;
+                        continue;
+                    }
+                    findings.push_back(std::move(finding));
+                }
+
+                if (!blocker && alwaysFirst) {
+                    blocker = alwaysFirst;
+                    blockedBy = " of higher priority is always enabled";
+                } else if (!blocker && group.hasTimed) {
+                    for (uint32_t k = group.begin; k < group.end; ++k) {
+                        if (compiled.transitionAt(k).timed) {
+                            blocker = compiled.transitionAt(k).transition;
+                            break;
+                        }
+                    }
+                    blockedBy = " of higher priority is timed and holds lower priorities back";
+                }
+            }
+
+            // Overlapping guards of one unweighted group
+            for (const PriorityGroup& group : compiled.groups(state)) {
+                bool weighted = false;
+                for (uint32_t k = group.begin; k < group.end; ++k) {
+                    weighted = weighted || compiled.transitionAt(k).weighted;
+                }
+                if (weighted) {
+                    continue;
+                }
+                for (uint32_t i = group.begin; i < group.end; ++i) {
+                    if (!viable[i]) {
+                        continue;
+                    }
+                    for (uint32_t j = i + 1; j < group.end; ++j) {
+                        const CompiledTransition& a = compiled.transitionAt(i);
+                        const CompiledTransition& b = compiled.transitionAt(j);
+                        if (!viable[j] || a.timeout != b.timeout || !overlaps(conditions[i], conditions[j])) {
+                            continue;
+                        }
+                        AnalysisFinding finding;
+                        finding.kind = FindingKind::Nondeterminism;
+                        finding.state = stateId;
+                        finding.transition = a.transition->id;
+                        finding.other = b.transition->id;
+                        finding.message = "transitions " + quoted(a.transition->name) + " and " +
+                                          quoted(b.transition->name) + " from " + quoted(state.state->name) +
+                                          " share priority " + std::to_string(group.priority) +
+                                          " and can be enabled together; resolution order picks " +
+                                          quoted(a.transition->name);
+                        findings.push_back(std::move(finding));
+                    }
+                }
+            }
+        }
+    });
+
+    // Reachability: BFS over a bitset frontier along the viable transitions
+    const size_t words = (stateCount + 63) / 64;
+    std::vector<uint64_t> reached(words, 0);
+    std::vector<uint64_t> frontier(words, 0);
+    std::vector<uint64_t> next(words, 0);
+    setBit(reached, initial);
+    setBit(frontier, initial);
+    for (bool more = true; more;) {
+        more = false;
+        std::fill(next.begin(), next.end(), 0);
+        for (size_t w = 0; w < words; ++w) {
+            for (uint64_t bits = frontier[w]; bits != 0; bits &= bits - 1) {
+                const CompiledState& state = compiled.stateAt(static_cast<uint32_t>(w * 64 + lowestBit(bits)));
+                for (uint32_t k = state.transitionsBegin; k < state.transitionsEnd; ++k) {
+                    const uint32_t target = compiled.transitionAt(k).targetIndex;
+                    if (viable[k] && target != CompiledAutomata::INVALID_INDEX && !testBit(reached, target)) {
+                        setBit(reached, target);
+                        setBit(next, target);
+                        more = true;
+                    }
+                }
+            }
+        }
+        frontier.swap(next);
+    }
+
+    for (size_t s = 0; s < stateCount; ++s) {
+        const CompiledState& state = compiled.stateAt(static_cast<uint32_t>(s));
+        AnalysisFinding finding;
+        finding.state = state.state->id;
+        if (!testBit(reached, s)) {
+            finding.kind = FindingKind::UnreachableState;
+            finding.message = "state " + quoted(state.state->name) + " is unreachable from the initial state";
+            report.findings.push_back(std::move(finding));
+            continue;
+        }
+        ++report.reachableStates;
+        const bool exits = std::any_of(viable.begin() + state.transitionsBegin, viable.begin() + state.transitionsEnd,
+                                       [](uint8_t v) { return v != 0; });
+        if (!state.terminal && !exits) {
+            finding.kind = FindingKind::DeadState;
+            finding.message = "state " + quoted(state.state->name) +
+                              " has transitions but none can ever fire, so a run waits there forever";
+            report.findings.push_back(std::move(finding));
+        }
+    }
+    for (auto& findings : stateFindings) {
+        for (auto& finding : findings) {
+            if (testBit(reached, compiled.stateIndex(finding.state))) {
+                report.findings.push_back(std::move(finding));
+            }
+        }
+    }
+
+    // Components of the reachable graph (iterative Tarjan); closed loops
+    // that never return to the initial state and hold no terminal are traps
+    constexpr uint32_t kUnvisited = ~uint32_t{0};
+    std::vector<uint32_t> index(stateCount, kUnvisited);
+    std::vector<uint32_t> low(stateCount, 0);
+    std::vector<uint8_t> onStack(stateCount, 0);
+    std::vector<uint32_t> component(stateCount, kUnvisited);
+    std::vector<uint32_t> members;
+    std::vector<std::pair<uint32_t, uint32_t>> calls;  // State, next transition to follow
+    uint32_t counter = 0;
+    std::vector<uint32_t> componentBegin;  // Into `order`
+    std::vector<uint32_t> order;
+
+    for (uint32_t root = 0; root < stateCount; ++root) {
+        if (!testBit(reached, root) || index[root] != kUnvisited) {
+            continue;
+        }
+        calls.emplace_back(root, compiled.stateAt(root).transitionsBegin);
+        index[root] = low[root] = counter++;
+        members.push_back(root);
+        onStack[root] = 1;
+        while (!calls.empty()) {
+            auto& [s, k] = calls.back();
+            const CompiledState& state = compiled.stateAt(s);
+            bool descended = false;
+            while (k < state.transitionsEnd) {
+                const uint32_t edge = k++;
+                const uint32_t target = compiled.transitionAt(edge).targetIndex;
+                if (!viable[edge] || target == CompiledAutomata::INVALID_INDEX) {
+                    continue;
+                }
+                if (index[target] == kUnvisited) {
+                    index[target] = low[target] = counter++;
+                    members.push_back(target);
+                    onStack[target] = 1;
+                    calls.emplace_back(target, compiled.stateAt(target).transitionsBegin);
+                    descended = true;
+                    break;
+                }
+                if (onStack[target]) {
+                    low[s] = std::min(low[s], index[target]);
+                }
+            }
+            if (descended) {
+                continue;
+            }
+            const uint32_t done = s;
+            calls.pop_back();
+            if (!calls.empty()) {
+                low[calls.back().first] = std::min(low[calls.back().first], low[done]);
+            }
+            if (low[done] == index[done]) {
+                const auto id = static_cast<uint32_t>(componentBegin.size());
+                componentBegin.push_back(static_cast<uint32_t>(order.size()));
+                uint32_t member = 0;
+                do {
+                    member = members.back();
+                    members.pop_back();
+                    onStack[member] = 0;
+                    component[member] = id;
+                    order.push_back(member);
+                } while (member != done);
+            }
+        }
+    }
+    report.components = componentBegin.size();
+    componentBegin.push_back(static_cast<uint32_t>(order.size()));
+
+    for (size_t c = 0; c + 1 < componentBegin.size(); ++c) {
+        const uint32_t* first = order.data() + componentBegin[c];
+        const uint32_t* last = order.data() + componentBegin[c + 1];
+        bool closed = true;
+        bool cyclic = last - first > 1;
+        bool holdsExit = false;
+        for (const uint32_t* s = first; s != last; ++s) {
+            const CompiledState& state = compiled.stateAt(*s);
+            holdsExit = holdsExit || state.terminal || *s == initial;
+            for (uint32_t k = state.transitionsBegin; k < state.transitionsEnd && closed; ++k) {
+                const uint32_t target = compiled.transitionAt(k).targetIndex;
+                if (!viable[k] || target == CompiledAutomata::INVALID_INDEX) {
+                    continue;
+                }
+                closed = component[target] == c;
+                cyclic = cyclic || target == *s;
+            }
+        }
+        if (!closed || !cyclic || holdsExit) {
+            continue;
+        }
+        std::vector<const State*> states;
+        for (const uint32_t* s = first; s != last; ++s) {
+            states.push_back(compiled.stateAt(*s).state);
+        }
+        std::sort(states.begin(), states.end(), [](const State* a, const State* b) { return a->id < b->id; });
+        AnalysisFinding finding;
+        finding.kind = FindingKind::Trap;
+        finding.state = states.front()->id;
+        finding.message = "states";
+        for (size_t i = 0; i < std::min<size_t>(states.size(), 4); ++i) {
+            finding.message += (i == 0 ? " " : ", ") + quoted(states[i]->name);
+        }
+        if (states.size() > 4) {
+            finding.message += " and " + std::to_string(states.size() - 4) + " more";
+        }
+        finding.message += " form a closed loop with no terminal state and no way back to the initial state";
+        report.findings.push_back(std::move(finding));
+    }
+
+    std::sort(report.findings.begin(), report.findings.end(), [](const AnalysisFinding& a, const AnalysisFinding& b) {
+        if (a.kind != b.kind) return a.kind < b.kind;
+        if (a.state != b.state) return a.state < b.state;
+        if (a.transition != b.transition) return a.transition < b.transition;
+        return a.other < b.other;
+    });
+    return report;
+}
+
+} // namespace
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+size_t AutomataAnalysis::count(FindingKind kind) const {
+    return static_cast<size_t>(std::count_if(findings.begin(), findings.end(),
+                                             [kind](const AnalysisFinding& f) { return f.kind == kind; }));
+}
+
+const char* findingKindName(FindingKind kind) {
+    switch (kind) {
+        case FindingKind::UnreachableState: return "unreachable_state";
+        case FindingKind::DeadState: return "dead_state";
+        case FindingKind::Trap: return "trap";
+        case FindingKind::UnreachableTransition: return "unreachable_transition";
+        case FindingKind::Nondeterminism: return "nondeterminism";
+    }
+    return "unknown";
+}
+
+uint64_t automataHash(const Automata& automata) {
+    Hasher h;
+    h.pod(automata.initialState);
+    for (const auto& spec : automata.variables) {
+        h.pod(spec.id);
+        h.text(spec.name);
+        h.pod(spec.type);
+        h.pod(spec.direction);
+    }
+
+    std::vector<StateId> stateIds;
+    stateIds.reserve(automata.states.size());
+    for (const auto& [id, state] : automata.states) {
+        stateIds.push_back(id);
+    }
+    std::sort(stateIds.begin(), stateIds.end());
+    for (StateId id : stateIds) {
+        h.pod(id);
+        h.text(automata.states.at(id).name);
+    }
+
+    std::vector<TransitionId> transitionIds;
+    transitionIds.reserve(automata.transitions.size());
+    for (const auto& [id, t] : automata.transitions) {
+        transitionIds.push_back(id);
+    }
+    std::sort(transitionIds.begin(), transitionIds.end());
+    for (TransitionId id : transitionIds) {
+        const Transition& t = automata.transitions.at(id);
+        h.pod(t.id);
+        h.text(t.name);
+        h.pod(t.from);
+        h.pod(t.to);
+        h.pod(t.type);
+        h.pod(t.priority);
+        h.pod(t.weight);
+        h.pod(t.enabled);
+        switch (t.type) {
+            case TransitionType::Classic:
+                h.code(t.classicConfig.condition);
+                h.pod(t.classicConfig.onRisingEdge);
+                break;
+            case TransitionType::Timed:
+                h.pod(t.timedConfig.mode);
+                h.pod(t.timedConfig.delayMs);
+                h.pod(t.timedConfig.windowEndMs);
+                h.code(t.timedConfig.additionalCondition);
+                break;
+            case TransitionType::Event:
+                h.pod(t.eventConfig.requireAll);
+                h.pod<uint64_t>(t.eventConfig.triggers.size());
+                for (const auto& trigger : t.eventConfig.triggers) {
+                    h.text(trigger.signalName);
+                    h.pod(trigger.triggerType);
+                    h.pod(trigger.threshold.has_value());
+                    if (trigger.threshold) {
+                        h.pod(trigger.threshold->op);
+                        h.constant(trigger.threshold->value);
+                    }
+                    h.text(trigger.pattern);
+                }
+                h.code(t.eventConfig.additionalCondition);
+                break;
+            case TransitionType::Probabilistic:
+                h.pod(t.probConfig.isDynamic);
+                h.pod(t.probConfig.weight);
+                break;
+            case TransitionType::Immediate:
+                break;
+        }
+    }
+    return h.value;
+}
+
+AutomataAnalysis analyzeAutomata(const Automata& automata, const CompiledAutomata& compiled,
+                                 const AnalysisOptions& options) {
+    return analyzeWithHash(automata, compiled, options, automataHash(automata));
+}
+
+AutomataAnalysis analyzeAutomata(const Automata& automata, const AnalysisOptions& options) {
+    CompiledAutomata compiled;
+    compiled.build(automata);
+    return analyzeAutomata(automata, compiled, options);
+}
+
+std::shared_ptr<const AutomataAnalysis> AnalysisCache::analyze(const Automata& automata,
+                                                               const CompiledAutomata& compiled,
+                                                               const AnalysisOptions& options) {
+    const uint64_t hash = automataHash(automata);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(hash);
+        if (it != entries_.end()) {
+            ++hits_;
+            return it->second;
+        }
+        ++misses_;
+    }
+
+    auto analysis = std::make_shared<const AutomataAnalysis>(analyzeWithHash(automata, compiled, options, hash));
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.emplace(hash, analysis).second) {
+        order_.push_back(hash);
+        while (order_.size() > std::max<size_t>(capacity_, 1)) {
+            entries_.erase(order_.front());
+            order_.erase(order_.begin());
+        }
+    }
+    return analysis;
+}
+
+uint64_t AnalysisCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+uint64_t AnalysisCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+} // namespace aeth
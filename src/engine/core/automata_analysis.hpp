@@ -0,0 +1,115 @@
+/**
+ * Aetherium Automata - Static Analysis
+ *
+ * Graph checks over the compiled index form (CompiledAutomata), cheap
+ * enough to run on every deploy:
+ * - unreachable states: no path from the initial state;
+ * - dead states: reachable, with outgoing transitions none of which can
+ *   ever be enabled, so the run waits there forever;
+ * - traps: closed loops without a terminal state that, once entered, never
+ *   lead back to the initial state;
+ * - unreachable transitions: never enabled (a constant-false guard, an
+ *   empty window, triggers on unknown signals) or shadowed by an
+ *   always-enabled transition of higher priority;
+ * - nondeterminism: two unweighted transitions of one priority group whose
+ *   guards can hold at once, so resolution order alone decides.
+ *
+ * Guards are read from their native programs (native_guard.hpp): constants
+ * fold, and conjunctions of variable-vs-constant comparisons become boxes
+ * of intervals. Opaque guards are assumed satisfiable and never reported
+ * as overlapping. Reachability is a BFS over bitsets of states, components
+ * come from one iterative Tarjan pass, and the per-transition and per-state
+ * checks run in chunks on a work-stealing pool for large graphs. Results
+ * are keyed by a structural hash of the automata, so an AnalysisCache
+ * answers a re-deploy of the same artifact without redoing the work.
+ */
+
+#ifndef AETHERIUM_AUTOMATA_ANALYSIS_HPP
+#define AETHERIUM_AUTOMATA_ANALYSIS_HPP
+
+#include "compiled_automata.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace aeth {
+
+enum class FindingKind : uint8_t {
+    UnreachableState,
+    DeadState,
+    Trap,
+    UnreachableTransition,
+    Nondeterminism
+};
+
+struct AnalysisFinding {
+    FindingKind kind = FindingKind::UnreachableState;
+    StateId state = INVALID_STATE;                  // The state concerned, or the source state
+    TransitionId transition = INVALID_TRANSITION;
+    TransitionId other = INVALID_TRANSITION;        // Nondeterminism: the overlapping transition
+    std::string message;
+};
+
+struct AnalysisOptions {
+    size_t workers = 0;                 // 0 = one per hardware thread
+    size_t parallelTransitions = 4096;  // Smaller automata are analyzed on the calling thread
+};
+
+struct AutomataAnalysis {
+    uint64_t hash = 0;  // automataHash of the analyzed automata
+    size_t states = 0;
+    size_t transitions = 0;
+    size_t reachableStates = 0;
+    size_t components = 0;  // Strongly connected components among the reachable states
+
+    // By kind, then state id, then transition id
+    std::vector<AnalysisFinding> findings;
+
+    [[nodiscard]] size_t count(FindingKind kind) const;
+    [[nodiscard]] bool clean() const { return findings.empty(); }
+};
+
+[[nodiscard]] const char* findingKindName(FindingKind kind);
+
+/**
+ * FNV-1a over everything the analysis reads: states, transitions with
+ * their configuration and code, variables and the initial state, in id
+ * order. Equal automata hash equal regardless of container order.
+ */
+[[nodiscard]] uint64_t automataHash(const Automata& automata);
+
+// `compiled` must have been built from `automata`
+AutomataAnalysis analyzeAutomata(const Automata& automata, const CompiledAutomata& compiled,
+                                 const AnalysisOptions& options = {});
+AutomataAnalysis analyzeAutomata(const Automata& automata, const AnalysisOptions& options = {});
+
+/**
+ * Analyses by automata hash, the newest `capacity` kept. Thread-safe;
+ * concurrent misses on one hash may both analyze.
+ */
+class AnalysisCache {
+public:
+    explicit AnalysisCache(size_t capacity = 16) : capacity_(capacity) {}
+
+    std::shared_ptr<const AutomataAnalysis> analyze(const Automata& automata, const CompiledAutomata& compiled,
+                                                    const AnalysisOptions& options = {});
+
+    [[nodiscard]] uint64_t hits() const;
+    [[nodiscard]] uint64_t misses() const;
+
+private:
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, std::shared_ptr<const AutomataAnalysis>> entries_;
+    std::vector<uint64_t> order_;  // Insertion order, oldest first
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
+
+} // namespace aeth
+
+#endif // AETHERIUM_AUTOMATA_ANALYSIS_HPP
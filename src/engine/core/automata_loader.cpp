@@ -1,11 +1,29 @@
 #include "automata_loader.hpp"
 
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
 #include <sstream>
 
 namespace aeth {
 
+void AutomataLoader::setIncremental(bool enabled) {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    if (!enabled) {
+        cache_.reset();
+    } else if (!cache_) {
+        cache_ = std::make_unique<ParseCache>();
+    }
+}
+
+ParseCache::Stats AutomataLoader::lastParseStats() const {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    return cache_ ? cache_->stats : ParseCache::Stats{};
+}
+
 Result<AutomataLoadResult> AutomataLoader::loadFromFile(const std::string& filePath) const {
-    AutomataParser parser;
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    AutomataParser parser(cache_.get());
     auto parseResult = parser.parseFile(filePath);
     return fromParseResult(std::move(parseResult), filePath);
 }
@@ -13,11 +31,24 @@ Result<AutomataLoadResult> AutomataLoader::loadFromFile(const std::string& fileP
 Result<AutomataLoadResult> AutomataLoader::loadFromString(const std::string& yaml,
                                                           const std::string& basePath,
                                                           const std::string& sourceLabel) const {
-    AutomataParser parser;
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    AutomataParser parser(cache_.get());
     auto parseResult = parser.parseString(yaml, basePath);
     return fromParseResult(std::move(parseResult), sourceLabel);
 }
 
+std::vector<Result<AutomataLoadResult>> AutomataLoader::loadFromFiles(const std::vector<std::string>& filePaths,
+                                                                     size_t workers) const {
+    AutomataParser parser;
+    auto parsed = parser.parseFiles(filePaths, workers);
+    std::vector<Result<AutomataLoadResult>> loaded;
+    loaded.reserve(parsed.size());
+    for (size_t i = 0; i < parsed.size(); ++i) {
+        loaded.push_back(fromParseResult(std::move(parsed[i]), filePaths[i]));
+    }
+    return loaded;
+}
+
 Result<void> AutomataLoader::validateFile(const std::string& filePath,
                                           std::vector<std::string>* warnings,
                                           std::vector<std::string>* errors) const {
@@ -66,4 +97,145 @@ Result<AutomataLoadResult> AutomataLoader::fromParseResult(ParseResult parseResu
     return Result<AutomataLoadResult>::ok(std::move(loaded));
 }
 
+// ============================================================================
+// ValidationCache
+// ============================================================================
+
+namespace {
+
+constexpr const char* kValidationCacheHeader = "aetherium-validation-cache 1";
+
+uint64_t fnv1a(const char* data, size_t len, uint64_t hash) {
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// One line per record; diagnostics never need their line breaks back
+std::string singleLine(std::string text) {
+    std::replace(text.begin(), text.end(), '\n', ' ');
+    return text;
+}
+
+} // namespace
+
+Result<void> ValidationCache::load() {
+    verdicts_.clear();
+    std::ifstream in(path_);
+    if (!in.is_open()) {
+        return Result<void>::ok();
+    }
+    std::string line;
+    if (!std::getline(in, line) || line != kValidationCacheHeader) {
+        // Unknown format: start over rather than trust it
+        return Result<void>::ok();
+    }
+
+    Verdict* current = nullptr;
+    while (std::getline(in, line)) {
+        if (line.size() < 2 || line[1] != ' ') {
+            continue;
+        }
+        const std::string rest = line.substr(2);
+        switch (line[0]) {
+            case 'F': {
+                // F <fingerprint> <valid> <path>
+                std::istringstream fields(rest);
+                Verdict verdict;
+                int valid = 0;
+                std::string file;
+                fields >> std::hex >> verdict.fingerprint >> std::dec >> valid;
+                std::getline(fields >> std::ws, file);
+                if (file.empty()) {
+                    current = nullptr;
+                    break;
+                }
+                verdict.valid = valid != 0;
+                current = &(verdicts_[file] = std::move(verdict));
+                break;
+            }
+            case 'E':
+                if (current) current->errors.push_back(rest);
+                break;
+            case 'W':
+                if (current) current->warnings.push_back(rest);
+                break;
+            default:
+                break;
+        }
+    }
+    return Result<void>::ok();
+}
+
+Result<void> ValidationCache::save() const {
+    const std::string staging = path_ + ".tmp";
+    {
+        std::ofstream out(staging, std::ios::trunc);
+        if (!out.is_open()) {
+            return Result<void>::error("cannot write validation cache: " + staging);
+        }
+        out << kValidationCacheHeader << "\n";
+        for (const auto& [file, verdict] : verdicts_) {
+            out << "F " << std::hex << verdict.fingerprint << std::dec << " " << (verdict.valid ? 1 : 0) << " "
+                << file << "\n";
+            for (const auto& error : verdict.errors) {
+                out << "E " << singleLine(error) << "\n";
+            }
+            for (const auto& warning : verdict.warnings) {
+                out << "W " << singleLine(warning) << "\n";
+            }
+        }
+        if (!out) {
+            return Result<void>::error("cannot write validation cache: " + staging);
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(staging, path_, ec);
+    if (ec) {
+        return Result<void>::error("cannot replace validation cache: " + ec.message());
+    }
+    return Result<void>::ok();
+}
+
+const ValidationCache::Verdict* ValidationCache::find(const std::string& file, uint64_t fingerprint) const {
+    auto it = verdicts_.find(file);
+    return it != verdicts_.end() && it->second.fingerprint == fingerprint ? &it->second : nullptr;
+}
+
+void ValidationCache::store(const std::string& file, Verdict verdict) {
+    verdicts_[file] = std::move(verdict);
+}
+
+Result<uint64_t> ValidationCache::fingerprint(const std::string& file) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in.is_open()) {
+        return Result<uint64_t>::error("Failed to open file: " + file);
+    }
+    std::ostringstream bytes;
+    bytes << in.rdbuf();
+    const std::string content = bytes.str();
+    uint64_t hash = fnv1a(content.data(), content.size(), 14695981039346656037ull);
+
+    std::vector<std::filesystem::path> sidecars;
+    std::error_code ec;
+    const auto folder = std::filesystem::path(file).parent_path();
+    for (const auto& entry : std::filesystem::directory_iterator(folder.empty() ? "." : folder, ec)) {
+        if (entry.path().extension() == ".lua") {
+            sidecars.push_back(entry.path());
+        }
+    }
+    std::sort(sidecars.begin(), sidecars.end());
+    for (const auto& sidecar : sidecars) {
+        const std::string name = sidecar.filename().string();
+        const auto size = static_cast<uint64_t>(std::filesystem::file_size(sidecar, ec));
+        const auto mtime = static_cast<int64_t>(std::filesystem::last_write_time(sidecar, ec).time_since_epoch().count());
+        hash = fnv1a(name.data(), name.size(), hash);
+        hash = fnv1a(reinterpret_cast<const char*>(&size), sizeof(size), hash);
+        hash = fnv1a(reinterpret_cast<const char*>(&mtime), sizeof(mtime), hash);
+    }
+    return Result<uint64_t>::ok(hash);
+}
+
 } // namespace aeth
@@ -4,8 +4,12 @@
 #include "parser.hpp"
 #include "types.hpp"
 
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace aeth {
@@ -25,11 +29,22 @@ class AutomataLoader {
 public:
     AutomataLoader() = default;
 
+    /**
+     * Keep a ParseCache across loadFromFile/loadFromString calls, so that
+     * reloading an edited document re-parses only what changed
+     */
+    void setIncremental(bool enabled);
+    [[nodiscard]] ParseCache::Stats lastParseStats() const;
+
     Result<AutomataLoadResult> loadFromFile(const std::string& filePath) const;
     Result<AutomataLoadResult> loadFromString(const std::string& yaml,
                                               const std::string& basePath,
                                               const std::string& sourceLabel = "<memory>") const;
 
+    // Parsed concurrently; one result per path, in input order
+    std::vector<Result<AutomataLoadResult>> loadFromFiles(const std::vector<std::string>& filePaths,
+                                                          size_t workers = 0) const;
+
     Result<void> validateFile(const std::string& filePath,
                               std::vector<std::string>* warnings = nullptr,
                               std::vector<std::string>* errors = nullptr) const;
@@ -37,6 +52,40 @@ public:
 private:
     static Result<AutomataLoadResult> fromParseResult(ParseResult parseResult,
                                                       const std::string& sourceLabel);
+
+    mutable std::mutex cacheMutex_;
+    mutable std::unique_ptr<ParseCache> cache_;
+};
+
+/**
+ * Verdicts of earlier validations, persisted between CLI runs. A file's
+ * fingerprint covers its bytes and the size and mtime of the Lua files
+ * beside it (folder layouts read those), so an unchanged project answers
+ * without being parsed.
+ */
+class ValidationCache {
+public:
+    struct Verdict {
+        uint64_t fingerprint = 0;
+        bool valid = false;
+        std::vector<std::string> errors;
+        std::vector<std::string> warnings;
+    };
+
+    explicit ValidationCache(std::string path) : path_(std::move(path)) {}
+
+    // A missing cache file is an empty cache
+    Result<void> load();
+    Result<void> save() const;
+
+    [[nodiscard]] const Verdict* find(const std::string& file, uint64_t fingerprint) const;
+    void store(const std::string& file, Verdict verdict);
+
+    static Result<uint64_t> fingerprint(const std::string& file);
+
+private:
+    std::string path_;
+    std::unordered_map<std::string, Verdict> verdicts_;
 };
 
 } // namespace aeth
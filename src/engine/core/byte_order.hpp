@@ -0,0 +1,60 @@
+/**
+ * Aetherium Automata - Byte Order
+ *
+ * Big-endian (network order) loads and stores used by both wire codecs.
+ * One memcpy plus a byte-swap intrinsic on little-endian hosts; the
+ * memcpy keeps unaligned access legal on every target.
+ */
+
+#ifndef AETHERIUM_BYTE_ORDER_HPP
+#define AETHERIUM_BYTE_ORDER_HPP
+
+#include <cstdint>
+#include <cstring>
+
+namespace aeth {
+namespace byteorder {
+
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+inline uint16_t toBig(uint16_t v) { return v; }
+inline uint32_t toBig(uint32_t v) { return v; }
+inline uint64_t toBig(uint64_t v) { return v; }
+#elif defined(__GNUC__) || defined(__clang__)
+inline uint16_t toBig(uint16_t v) { return __builtin_bswap16(v); }
+inline uint32_t toBig(uint32_t v) { return __builtin_bswap32(v); }
+inline uint64_t toBig(uint64_t v) { return __builtin_bswap64(v); }
+#else
+inline uint16_t toBig(uint16_t v) {
+    return static_cast<uint16_t>((v >> 8) | (v << 8));
+}
+inline uint32_t toBig(uint32_t v) {
+    return ((v & 0x000000FFu) << 24) | ((v & 0x0000FF00u) << 8) |
+           ((v & 0x00FF0000u) >> 8) | ((v & 0xFF000000u) >> 24);
+}
+inline uint64_t toBig(uint64_t v) {
+    return (static_cast<uint64_t>(toBig(static_cast<uint32_t>(v))) << 32) |
+           toBig(static_cast<uint32_t>(v >> 32));
+}
+#endif
+
+// The swap is its own inverse
+template <typename T>
+inline T fromBig(T v) { return toBig(v); }
+
+template <typename T>
+inline void storeBig(uint8_t* out, T v) {
+    v = toBig(v);
+    std::memcpy(out, &v, sizeof(v));
+}
+
+template <typename T>
+inline T loadBig(const uint8_t* in) {
+    T v;
+    std::memcpy(&v, in, sizeof(v));
+    return fromBig(v);
+}
+
+} // namespace byteorder
+} // namespace aeth
+
+#endif // AETHERIUM_BYTE_ORDER_HPP
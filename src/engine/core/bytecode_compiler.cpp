@@ -0,0 +1,182 @@
+#include "bytecode_compiler.hpp"
+#include "script_vm.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+namespace aeth {
+
+namespace {
+
+using Out = Result<ir::EngineBytecodeProgram>;
+
+// Source text of a block; a block known only by its precompiled bytes is
+// tied to one script engine and cannot be lowered
+bool blockSource(const CodeBlock& block, std::string& out) {
+    out = block.text();
+    return !out.empty() || block.bytecode.empty();
+}
+
+// Hooks and bodies always load as statements; only guards carry a kind
+bool statementBlock(const CodeBlock& block) {
+    return block.resolvedKind(CodeKind::Statement) == CodeKind::Statement;
+}
+
+std::string describe(const Transition& t) {
+    return "transition " + (t.name.empty() ? std::to_string(t.id) : t.name);
+}
+
+Result<void> lowerTransition(const Transition& t, ir::BytecodeTransition& out) {
+    using R = Result<void>;
+    out.id = t.id;
+    out.name = t.name;
+    out.from = t.from;
+    out.to = t.to;
+    out.priority = t.priority;
+    out.enabled = t.enabled;
+    out.weight = t.weight;
+    if (!blockSource(t.body, out.bodySource) || !blockSource(t.triggered, out.triggeredSource)) {
+        return R::error(describe(t) + ": code block has no source");
+    }
+    if (!statementBlock(t.body) || !statementBlock(t.triggered)) {
+        return R::error(describe(t) + ": expression-kind bodies are not representable");
+    }
+
+    const CodeBlock* condition = nullptr;
+    switch (t.type) {
+        case TransitionType::Immediate:
+            out.kind = ir::BytecodeTransitionKind::Immediate;
+            break;
+        case TransitionType::Probabilistic:
+            if (t.probConfig.isDynamic) {
+                return R::error(describe(t) + ": dynamic weights are not representable");
+            }
+            out.kind = ir::BytecodeTransitionKind::Immediate;
+            out.weight = t.probConfig.weight;
+            break;
+        case TransitionType::Classic:
+            if (t.classicConfig.onRisingEdge) {
+                return R::error(describe(t) + ": rising-edge guards are not representable");
+            }
+            // An empty guard always holds, which is what Immediate means
+            out.kind = t.classicConfig.condition.isEmpty() ? ir::BytecodeTransitionKind::Immediate
+                                                           : ir::BytecodeTransitionKind::ClassicCondition;
+            condition = &t.classicConfig.condition;
+            break;
+        case TransitionType::Timed:
+            if (t.timedConfig.mode != TimedMode::After && t.timedConfig.mode != TimedMode::Timeout) {
+                return R::error(describe(t) + ": only after/timeout timing is representable");
+            }
+            if (t.timedConfig.jitterMs != 0) {
+                return R::error(describe(t) + ": timing jitter is not representable");
+            }
+            out.kind = t.timedConfig.mode == TimedMode::After ? ir::BytecodeTransitionKind::TimedAfter
+                                                              : ir::BytecodeTransitionKind::TimedTimeout;
+            out.delayMs = t.timedConfig.delayMs;
+            condition = &t.timedConfig.additionalCondition;
+            break;
+        case TransitionType::Event: {
+            if (t.eventConfig.triggers.size() != 1 || t.eventConfig.debounceMs != 0) {
+                return R::error(describe(t) + ": only single-trigger events without debounce are representable");
+            }
+            const SignalTrigger& trigger = t.eventConfig.triggers.front();
+            out.kind = ir::BytecodeTransitionKind::EventSignal;
+            out.eventSignalName = trigger.signalName;
+            out.eventSignalDirection = trigger.signalType;
+            out.eventTriggerType = trigger.triggerType;
+            if (trigger.threshold) {
+                out.eventHasThreshold = true;
+                out.eventThresholdOp = trigger.threshold->op;
+                out.eventThresholdValue = trigger.threshold->value;
+                out.eventThresholdOneShot = trigger.threshold->oneShot;
+            }
+            out.eventPattern = trigger.pattern;
+            condition = &t.eventConfig.additionalCondition;
+            break;
+        }
+    }
+
+    if (condition) {
+        if (!blockSource(*condition, out.conditionExpression)) {
+            return R::error(describe(t) + ": guard has no source");
+        }
+        out.conditionKind = condition->kind;
+    }
+    return R::ok();
+}
+
+} // namespace
+
+Result<ir::EngineBytecodeProgram> engineBytecodeFromAutomata(const Automata& automata) {
+    const auto errors = automata.validate();
+    if (!errors.empty()) {
+        std::ostringstream oss;
+        for (size_t i = 0; i < errors.size(); ++i) {
+            oss << (i > 0 ? "; " : "") << errors[i];
+        }
+        return Out::error("automata invalid: " + oss.str());
+    }
+
+    ir::EngineBytecodeProgram program;
+    program.name = automata.config.name.empty() ? program.name : automata.config.name;
+    program.initialState = automata.initialState;
+
+    program.variables.reserve(automata.variables.size());
+    for (const auto& spec : automata.variables) {
+        program.variables.push_back(
+            ir::BytecodeVariable{spec.id, spec.name, spec.type, spec.direction, spec.initialValue, spec.telemetry});
+    }
+
+    std::vector<const State*> states;
+    states.reserve(automata.states.size());
+    for (const auto& entry : automata.states) {
+        states.push_back(&entry.second);
+    }
+    std::sort(states.begin(), states.end(), [](const State* a, const State* b) { return a->id < b->id; });
+    program.states.reserve(states.size());
+    for (const State* st : states) {
+        ir::BytecodeState out;
+        out.id = st->id;
+        out.name = st->name;
+        if (!blockSource(st->onEnter, out.onEnterSource) || !blockSource(st->body, out.bodySource) ||
+            !blockSource(st->onExit, out.onExitSource)) {
+            return Out::error("state " + st->name + ": code block has no source");
+        }
+        if (!statementBlock(st->onEnter) || !statementBlock(st->body) || !statementBlock(st->onExit)) {
+            return Out::error("state " + st->name + ": expression-kind hooks are not representable");
+        }
+        program.states.push_back(std::move(out));
+    }
+
+    // dependsOn hints are not carried; reactive mode analyses the guard source instead
+    std::vector<const Transition*> transitions;
+    transitions.reserve(automata.transitions.size());
+    for (const auto& entry : automata.transitions) {
+        transitions.push_back(&entry.second);
+    }
+    std::sort(transitions.begin(), transitions.end(),
+              [](const Transition* a, const Transition* b) { return a->id < b->id; });
+    program.transitions.reserve(transitions.size());
+    for (const Transition* t : transitions) {
+        ir::BytecodeTransition out;
+        auto lowered = lowerTransition(*t, out);
+        if (lowered.isError()) {
+            return Out::error(lowered.error());
+        }
+        program.transitions.push_back(std::move(out));
+    }
+
+    return Out::ok(std::move(program));
+}
+
+Result<ir::AutomataArtifact> compileDeployArtifact(const Automata& automata, std::string sourceLabel) {
+    auto program = engineBytecodeFromAutomata(automata);
+    if (program.isError()) {
+        return Result<ir::AutomataArtifact>::error(program.error());
+    }
+    // Leaves the program untouched when a block is outside the VM subset
+    compileScriptVmChunks(program.value());
+    return ir::makeEngineBytecodeArtifact(program.value(), std::move(sourceLabel));
+}
+
+} // namespace aeth
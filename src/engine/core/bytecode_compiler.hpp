@@ -0,0 +1,37 @@
+/**
+ * Aetherium Automata - Deploy Compiler
+ *
+ * Lowers a parsed Automata to the engine bytecode program, the binary
+ * deploy format. The toolchain runs it once (`--compile-artifact`); engines
+ * then load the artifact without a YAML parser, and the result is the same
+ * Automata the YAML loader would have produced.
+ *
+ * Model features the bytecode cannot carry are rejected rather than
+ * dropped: At/Every/Window timing, jitter, rising-edge guards, dynamic
+ * weights, multi-trigger or debounced events, precompiled-only blocks and
+ * hooks or bodies marked as expressions. A guard keeps its CodeKind.
+ */
+
+#ifndef AETHERIUM_BYTECODE_COMPILER_HPP
+#define AETHERIUM_BYTECODE_COMPILER_HPP
+
+#include "artifact.hpp"
+#include "model.hpp"
+
+#include <string>
+
+namespace aeth {
+
+// States and transitions come out in id order, so equal inputs give equal bytes
+Result<ir::EngineBytecodeProgram> engineBytecodeFromAutomata(const Automata& automata);
+
+/**
+ * Validated deploy artifact for `automata`. Script VM chunks are attached
+ * when every code block compiles for the VM; otherwise the sources alone
+ * travel and the engine compiles them at load.
+ */
+Result<ir::AutomataArtifact> compileDeployArtifact(const Automata& automata, std::string sourceLabel = ".");
+
+} // namespace aeth
+
+#endif // AETHERIUM_BYTECODE_COMPILER_HPP
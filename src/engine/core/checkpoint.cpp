@@ -0,0 +1,293 @@
+#include "checkpoint.hpp"
+#include "protocol.hpp"
+
+#include <algorithm>
+
+namespace aeth {
+
+namespace {
+
+constexpr uint8_t kMagic[4] = {'A', 'E', 'C', 'P'};
+constexpr uint8_t kVersion = 1;
+
+void writeBlob(protocol::ByteWriter& writer, const std::vector<uint8_t>& blob) {
+    writer.writeU32(static_cast<uint32_t>(blob.size()));
+    writer.writeRaw(blob.data(), blob.size());
+}
+
+std::optional<ByteView> readBlob(protocol::ByteReader& reader) {
+    auto size = reader.readU32();
+    return size ? reader.readRaw(*size) : std::nullopt;
+}
+
+struct SavedVariable {
+    VariableId id = INVALID_VARIABLE;
+    Value value;
+    Value previous;
+    bool changed = false;
+};
+
+struct SavedTimer {
+    Timer timer;
+    uint64_t sinceStart = 0;
+    uint64_t untilTarget = 0;  // Modular: a timer already due but not yet collected wraps
+};
+
+} // namespace
+
+// ============================================================================
+// Runtime
+// ============================================================================
+
+Result<RuntimeCheckpoint> Runtime::checkpoint() {
+    using R = Result<RuntimeCheckpoint>;
+    if (!isLoaded()) {
+        return R::error("No automata loaded");
+    }
+    if (ctx_.state != ExecutionState::Running && ctx_.state != ExecutionState::Paused) {
+        return R::error("Checkpoints need a running or paused automata");
+    }
+    auto globals = script_->saveGlobals();
+    if (globals.isError()) {
+        return R::error("script globals: " + globals.error());
+    }
+
+    const Timestamp now = clock_->now();
+    // Paused timers are frozen at pausedAt_; measure them from there
+    const Timestamp ref = ctx_.state == ExecutionState::Paused && pausedAt_ > 0 ? pausedAt_ : now;
+
+    protocol::ByteWriter w(256);
+    w.writeRaw(kMagic, sizeof(kMagic));
+    w.writeU8(kVersion);
+    w.writeString(automata_->config.name);
+    w.writeU16(static_cast<uint16_t>(automata_->states.size()));
+    w.writeU16(static_cast<uint16_t>(ctx_.variables.size()));
+
+    w.writeU8(static_cast<uint8_t>(ctx_.state));
+    w.writeU16(ctx_.currentState);
+    w.writeU16(ctx_.previousState);
+    w.writeU64(ctx_.tickCount);
+    w.writeU64(ctx_.transitionCount);
+    w.writeU32(ctx_.errorCount);
+    w.writeU64(ctx_.stateEntryTickCount);
+    w.writeU64(ref - ctx_.startTime);
+    w.writeU64(ref - ctx_.stateEntryTime);
+    w.writeU64(ref - ctx_.lastTickTime);
+
+    w.writeU16(static_cast<uint16_t>(ctx_.variables.size()));
+    ctx_.variables.forEach([&w](const Variable& var) {
+        w.writeU16(var.id());
+        protocol::writeValue(w, var.value());
+        protocol::writeValue(w, var.previousValue());
+        w.writeU8(var.hasChanged() ? 1 : 0);
+    });
+
+    const auto timers = timers_->snapshot();
+    w.writeU16(static_cast<uint16_t>(timers.size()));
+    for (const Timer& t : timers) {
+        w.writeU16(t.transitionId);
+        w.writeU64(ref - t.startTime);
+        w.writeU64(t.targetTime - ref);
+        w.writeU32(t.repeatCount);
+        w.writeU32(t.currentRepeat);
+        w.writeU8(t.fired ? 1 : 0);
+    }
+
+    writeBlob(w, random_->saveState());
+    writeBlob(w, globals.value());
+
+    RuntimeCheckpoint out;
+    out.at = now;
+    out.tickCount = ctx_.tickCount;
+    out.bytes = w.finish();
+    return R::ok(std::move(out));
+}
+
+Result<void> Runtime::restoreCheckpoint(const RuntimeCheckpoint& checkpoint) {
+    using R = Result<void>;
+    if (!isLoaded()) {
+        return R::error("No automata loaded");
+    }
+    const auto corrupt = [] { return R::error("Checkpoint is truncated or corrupt"); };
+
+    // Decode everything before touching the run, so a bad blob changes nothing
+    protocol::ByteReader r(checkpoint.bytes.data(), checkpoint.bytes.size());
+    for (uint8_t expected : kMagic) {
+        auto b = r.readU8();
+        if (!b || *b != expected) {
+            return R::error("Not a runtime checkpoint");
+        }
+    }
+    auto version = r.readU8();
+    if (!version || *version != kVersion) {
+        return R::error("Unsupported checkpoint version");
+    }
+    auto name = r.readString();
+    auto stateCount = r.readU16();
+    auto variableCount = r.readU16();
+    if (!name || !stateCount || !variableCount) {
+        return corrupt();
+    }
+    if (*name != automata_->config.name || *stateCount != automata_->states.size() ||
+        *variableCount != ctx_.variables.size()) {
+        return R::error("Checkpoint was taken with a different automata");
+    }
+
+    auto execState = r.readU8();
+    auto current = r.readU16();
+    auto previous = r.readU16();
+    auto ticks = r.readU64();
+    auto transitions = r.readU64();
+    auto errors = r.readU32();
+    auto entryTicks = r.readU64();
+    auto sinceStart = r.readU64();
+    auto sinceEntry = r.readU64();
+    auto sinceTick = r.readU64();
+    if (!sinceTick) {
+        return corrupt();
+    }
+    const auto savedState = static_cast<ExecutionState>(*execState);
+    const State* target = automata_->getState(*current);
+    if (!target ||
+        (savedState != ExecutionState::Running && savedState != ExecutionState::Paused)) {
+        return corrupt();
+    }
+
+    auto savedCount = r.readU16();
+    if (!savedCount) {
+        return corrupt();
+    }
+    std::vector<SavedVariable> variables(*savedCount);
+    for (auto& v : variables) {
+        auto id = r.readU16();
+        auto value = id ? protocol::readValue(r) : std::nullopt;
+        auto prev = value ? protocol::readValue(r) : std::nullopt;
+        auto changed = prev ? r.readU8() : std::nullopt;
+        if (!changed || !ctx_.variables.get(*id)) {
+            return corrupt();
+        }
+        v = SavedVariable{*id, std::move(*value), std::move(*prev), *changed != 0};
+    }
+
+    auto timerCount = r.readU16();
+    if (!timerCount) {
+        return corrupt();
+    }
+    std::vector<SavedTimer> timers(*timerCount);
+    for (auto& saved : timers) {
+        auto id = r.readU16();
+        auto start = r.readU64();
+        auto until = r.readU64();
+        auto repeats = r.readU32();
+        auto repeat = r.readU32();
+        auto fired = r.readU8();
+        if (!fired || *id >= compiled_.transitionIdLimit()) {
+            return corrupt();
+        }
+        saved.timer.transitionId = *id;
+        saved.timer.repeatCount = *repeats;
+        saved.timer.currentRepeat = *repeat;
+        saved.timer.fired = *fired != 0;
+        saved.sinceStart = *start;
+        saved.untilTarget = *until;
+    }
+
+    auto randomState = readBlob(r);
+    auto globals = randomState ? readBlob(r) : std::nullopt;
+    if (!globals || r.hasMore()) {
+        return corrupt();
+    }
+    if (!random_->restoreState(randomState->data, randomState->size)) {
+        return R::error("Random source cannot restore this checkpoint");
+    }
+
+    // Apply. Paused during the swap, as restoreState does
+    exitChildren();
+    timers_->cancelAll();
+    const Timestamp now = clock_->now();
+    ctx_.state = ExecutionState::Paused;
+    pausedAt_ = now;
+    ctx_.currentState = *current;
+    ctx_.previousState = *previous;
+    ctx_.tickCount = *ticks;
+    ctx_.transitionCount = *transitions;
+    ctx_.errorCount = *errors;
+    ctx_.stateEntryTickCount = *entryTicks;
+    ctx_.startTime = now - *sinceStart;
+    ctx_.stateEntryTime = now - *sinceEntry;
+    ctx_.lastTickTime = now - *sinceTick;
+
+    for (auto& v : variables) {
+        ctx_.variables.restoreValue(v.id, std::move(v.value), std::move(v.previous), v.changed);
+    }
+    for (auto& saved : timers) {
+        saved.timer.startTime = now - saved.sinceStart;
+        saved.timer.targetTime = now + saved.untilTarget;
+        timers_->restoreTimer(saved.timer);
+    }
+
+    // Re-drive hardware for the restored state, then put back the globals the replay may have touched
+    script_->setReplayMode(true);
+    executeOnEnter(*target);
+    script_->setReplayMode(false);
+    auto restored = script_->restoreGlobals(globals->data, globals->size);
+    enterChildren(target->id);
+    flushActuation();
+    reactiveResync_ = true;
+    // The run's outputs are restored, not changed
+    ctx_.variables.clearJournal();
+
+    if (savedState == ExecutionState::Running) {
+        resume();
+    }
+    if (restored.isError()) {
+        return R::error("script globals: " + restored.error());
+    }
+    return R::ok();
+}
+
+// ============================================================================
+// CheckpointRing
+// ============================================================================
+
+void CheckpointRing::push(RuntimeCheckpoint checkpoint) {
+    if (capacity_ == 0) {
+        return;
+    }
+    while (entries_.size() >= capacity_) {
+        entries_.pop_front();
+    }
+    entries_.push_back(std::move(checkpoint));
+}
+
+const RuntimeCheckpoint* CheckpointRing::nearest(Timestamp at) const {
+    for (auto it = entries_.rbegin(); it != entries_.rend(); ++it) {
+        if (it->at <= at) {
+            return &*it;
+        }
+    }
+    return nullptr;
+}
+
+void CheckpointRing::dropAfter(Timestamp at) {
+    while (!entries_.empty() && entries_.back().at > at) {
+        entries_.pop_back();
+    }
+}
+
+void CheckpointRing::setCapacity(size_t capacity) {
+    capacity_ = capacity;
+    while (entries_.size() > capacity_) {
+        entries_.pop_front();
+    }
+}
+
+size_t CheckpointRing::byteSize() const {
+    size_t total = 0;
+    for (const auto& entry : entries_) {
+        total += entry.bytes.size();
+    }
+    return total;
+}
+
+} // namespace aeth
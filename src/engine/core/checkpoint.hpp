@@ -0,0 +1,62 @@
+/**
+ * Aetherium Automata - Runtime Checkpoints
+ *
+ * Runtime::checkpoint writes the complete resumable state of a run into one
+ * versioned binary blob:
+ *
+ *     "AECP" u8 version
+ *     automata name, state count, variable count   (checked on restore)
+ *     execution state, current/previous state, tick/transition/error counters
+ *     run, state-entry and last-tick times as ms before the checkpoint
+ *     variables: id, value, previous value, changed flag
+ *     timers: transition, ms since start, ms to target, repeats, fired
+ *     random source state, script globals          (u32 length + opaque bytes)
+ *
+ * Restoring it into a Runtime with the same automata loaded continues the
+ * run exactly, random draws included, so seeking in a long run becomes
+ * restore-the-nearest-checkpoint plus a short replay of the inputs since.
+ */
+
+#ifndef AETHERIUM_CHECKPOINT_HPP
+#define AETHERIUM_CHECKPOINT_HPP
+
+#include "runtime.hpp"
+
+#include <deque>
+
+namespace aeth {
+
+/**
+ * Bounded in-memory ring of checkpoints, oldest first. Pushing into a
+ * full ring evicts the oldest; times are expected to be non-decreasing.
+ */
+class CheckpointRing {
+public:
+    explicit CheckpointRing(size_t capacity = 32) : capacity_(capacity) {}
+
+    void push(RuntimeCheckpoint checkpoint);
+
+    // Newest checkpoint taken at or before `at`; nullptr if none is that old
+    [[nodiscard]] const RuntimeCheckpoint* nearest(Timestamp at) const;
+
+    // Forget checkpoints newer than `at` (after seeking, they belong to another future)
+    void dropAfter(Timestamp at);
+
+    void clear() { entries_.clear(); }
+    void setCapacity(size_t capacity);
+
+    [[nodiscard]] size_t size() const { return entries_.size(); }
+    [[nodiscard]] size_t capacity() const { return capacity_; }
+    [[nodiscard]] bool empty() const { return entries_.empty(); }
+    [[nodiscard]] const std::deque<RuntimeCheckpoint>& entries() const { return entries_; }
+    // Bytes held by all checkpoints
+    [[nodiscard]] size_t byteSize() const;
+
+private:
+    std::deque<RuntimeCheckpoint> entries_;
+    size_t capacity_;
+};
+
+} // namespace aeth
+
+#endif // AETHERIUM_CHECKPOINT_HPP
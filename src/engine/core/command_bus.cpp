@@ -4,23 +4,54 @@
 
 namespace aeth {
 
+CommandLane commandLaneOf(protocol::MessageType type) {
+    using protocol::MessageType;
+    switch (type) {
+        case MessageType::Hello:
+        case MessageType::Discover:
+        case MessageType::Provision:
+        case MessageType::Goodbye:
+        case MessageType::Ping:
+        case MessageType::LoadAutomata:
+        case MessageType::Start:
+        case MessageType::Stop:
+        case MessageType::Reset:
+        case MessageType::Status:
+        case MessageType::Pause:
+        case MessageType::Resume:
+        case MessageType::RestoreState:
+        case MessageType::PeerWiring:
+            return CommandLane::Control;
+        case MessageType::Input:
+        case MessageType::InputBatch:
+        case MessageType::Variable:
+            return CommandLane::Input;
+        default:
+            return CommandLane::Bulk;
+    }
+}
+
 void CommandBus::registerHandler(protocol::MessageType type, Handler handler) {
-    handlers_[type] = std::move(handler);
+    handlers_[static_cast<uint8_t>(type)] = std::move(handler);
 }
 
 void CommandBus::setDefaultHandler(Handler handler) {
     defaultHandler_ = std::move(handler);
 }
 
-CommandBus::Replies CommandBus::route(Engine& engine, const protocol::Message& message) const {
-    auto it = handlers_.find(message.type());
-    if (it != handlers_.end()) {
-        return it->second(engine, message);
+void CommandBus::route(Engine& engine, const protocol::Message& message, Replies& out) const {
+    const Handler& handler = handlers_[static_cast<uint8_t>(message.type())];
+    if (handler) {
+        handler(engine, message, out);
+    } else if (defaultHandler_) {
+        defaultHandler_(engine, message, out);
     }
-    if (defaultHandler_) {
-        return defaultHandler_(engine, message);
-    }
-    return {};
+}
+
+CommandBus::Replies CommandBus::route(Engine& engine, const protocol::Message& message) const {
+    Replies replies;
+    route(engine, message, replies);
+    return replies;
 }
 
 } // namespace aeth
@@ -3,26 +3,49 @@
 
 #include "protocol.hpp"
 
+#include <array>
 #include <functional>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 
 namespace aeth {
 
 class Engine;
 
+/**
+ * Ingress priority lanes, drained in this order by Engine::processCommandQueue:
+ * run control and liveness, then inputs, then everything else (telemetry,
+ * logs, vendor and informational messages).
+ */
+enum class CommandLane : uint8_t {
+    Control = 0,
+    Input = 1,
+    Bulk = 2,
+};
+
+constexpr size_t COMMAND_LANE_COUNT = 3;
+
+CommandLane commandLaneOf(protocol::MessageType type);
+
+/**
+ * Routes a command to its handler through a flat table indexed by the
+ * MessageType byte. Handlers append their replies to a caller-owned sink,
+ * so a batch of commands can share one reply buffer.
+ */
 class CommandBus {
 public:
     using Replies = std::vector<std::unique_ptr<protocol::Message>>;
-    using Handler = std::function<Replies(Engine&, const protocol::Message&)>;
+    using Handler = std::function<void(Engine&, const protocol::Message&, Replies&)>;
 
     void registerHandler(protocol::MessageType type, Handler handler);
     void setDefaultHandler(Handler handler);
+
+    // Appends the handler's replies to out; existing entries are kept
+    void route(Engine& engine, const protocol::Message& message, Replies& out) const;
     Replies route(Engine& engine, const protocol::Message& message) const;
 
 private:
-    std::unordered_map<protocol::MessageType, Handler> handlers_;
+    std::array<Handler, 256> handlers_;
     Handler defaultHandler_;
 };
 
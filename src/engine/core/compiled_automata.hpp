@@ -0,0 +1,601 @@
+/**
+ * Aetherium Automata - Compiled Automata
+ *
+ * Flat, index-addressed form of an Automata, built once after load.
+ * The runtime hot path works on this form only:
+ * - Dense state/transition indices instead of hash lookups
+ * - Per-state outgoing transitions stored contiguously, sorted and
+ *   grouped by priority
+ * - Terminal-state flag and per-transition flags precomputed
+ * - Per-transition variable dependencies for reactive tick mode
+ * - Native programs for guards in the simple expression subset
+ * - A specialized evaluator per transition and event signals resolved to
+ *   variable ids, so resolving a state is a run of direct calls
+ *
+ * The compiled form points into the source Automata, which must outlive it.
+ */
+
+#ifndef AETHERIUM_COMPILED_AUTOMATA_HPP
+#define AETHERIUM_COMPILED_AUTOMATA_HPP
+
+#include "model.hpp"
+#include "native_guard.hpp"
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace aeth {
+
+// ============================================================================
+// Array View
+// ============================================================================
+
+/**
+ * Non-owning view over a contiguous run of compiled entries
+ */
+template <typename T>
+struct ArrayView {
+    const T* first = nullptr;
+    const T* last = nullptr;
+
+    [[nodiscard]] const T* begin() const { return first; }
+    [[nodiscard]] const T* end() const { return last; }
+    [[nodiscard]] size_t size() const { return static_cast<size_t>(last - first); }
+    [[nodiscard]] bool empty() const { return first == last; }
+    [[nodiscard]] const T& operator[](size_t index) const { return first[index]; }
+};
+
+// ============================================================================
+// Compiled Entries
+// ============================================================================
+
+class CompiledAutomata;
+class TransitionResolver;
+struct CompiledTransition;
+struct CompiledTrigger;
+
+/**
+ * Evaluator for one (type, mode, trigger) combination, chosen when the
+ * automata is compiled. Returns whether the transition is enabled and may
+ * replace its selection weight.
+ */
+using TransitionEvaluator = bool (*)(TransitionResolver& resolver, const CompiledAutomata& automata,
+                                     const CompiledTransition& entry, double& weight);
+
+// Whether one event trigger fired this tick
+using TriggerEvaluator = bool (*)(const TransitionResolver& resolver, const CompiledTrigger& trigger);
+
+// Defined with the resolver (runtime.cpp)
+TransitionEvaluator selectTransitionEvaluator(const Transition& t);
+TriggerEvaluator selectTriggerEvaluator(const SignalTrigger& trigger);
+
+/**
+ * Event trigger with its signal resolved to a variable id and its constant
+ * converted, so firing needs no string or Value work
+ */
+struct CompiledTrigger {
+    const SignalTrigger* trigger = nullptr;
+    TriggerEvaluator fired = nullptr;
+    VariableId signal = INVALID_VARIABLE;  // Unknown signals never fire
+    double threshold = 0;                  // OnThreshold constant
+    std::string_view pattern;              // OnMatch pattern, viewing the trigger's string
+};
+
+/**
+ * Outgoing transition with flags precomputed from its configuration
+ */
+struct CompiledTransition {
+    const Transition* transition = nullptr;
+    TransitionEvaluator evaluate = nullptr;
+    uint32_t targetIndex = 0;  // Dense index of the target state
+    bool timed = false;
+    bool timeout = false;      // Timed transition in Timeout mode (fallback)
+    bool weighted = false;
+    bool reactive = false;     // Result depends only on the listed variables
+    uint32_t dependenciesBegin = 0;  // Range in CompiledAutomata's dependency array
+    uint32_t dependenciesEnd = 0;
+    uint32_t guardBegin = 0;   // Native guard program; empty = ask the script
+    uint32_t guardEnd = 0;
+    uint32_t triggersBegin = 0;  // Range in CompiledAutomata's trigger array
+    uint32_t triggersEnd = 0;
+};
+
+/**
+ * Run of outgoing transitions sharing one priority
+ */
+struct PriorityGroup {
+    uint32_t begin = 0;  // Range in CompiledAutomata's transition array
+    uint32_t end = 0;
+    uint8_t priority = 0;
+    bool hasTimed = false;  // A pending timed transition holds lower groups back
+};
+
+/**
+ * State with its outgoing transition and priority group ranges
+ */
+struct CompiledState {
+    const State* state = nullptr;
+    uint32_t transitionsBegin = 0;
+    uint32_t transitionsEnd = 0;
+    uint32_t groupsBegin = 0;
+    uint32_t groupsEnd = 0;
+    bool terminal = true;  // No enabled outgoing transitions
+};
+
+// ============================================================================
+// Dependency Analysis
+// ============================================================================
+
+/**
+ * Collect the automata variables a guard reads, by scanning its source for
+ * variable names (bare or as string arguments such as check("x")).
+ *
+ * Returns false when the guard may also depend on something that is not an
+ * automata variable (time, randomness, hardware, script globals); such
+ * guards must be evaluated every tick.
+ */
+bool collectGuardDependencies(const CodeBlock& code, const Automata& automata,
+                              std::vector<VariableId>& out);
+
+// ============================================================================
+// Compiled Automata
+// ============================================================================
+
+class CompiledAutomata {
+public:
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+    CompiledAutomata() = default;
+
+    /**
+     * Rebuild from an automata. Transition order within a priority group
+     * matches Automata::getTransitionsFrom.
+     */
+    void build(const Automata& automata);
+    void clear();
+
+    [[nodiscard]] bool empty() const { return states_.empty(); }
+    [[nodiscard]] size_t stateCount() const { return states_.size(); }
+    [[nodiscard]] size_t transitionCount() const { return transitions_.size(); }
+
+    // One past the largest state / transition id
+    [[nodiscard]] size_t stateIdLimit() const { return stateIndexById_.size(); }
+    [[nodiscard]] size_t transitionIdLimit() const { return transitionIndexById_.size(); }
+
+    // Largest priority group; bounds the resolver's candidate storage
+    [[nodiscard]] size_t maxGroupSize() const { return maxGroupSize_; }
+
+    // Dense index lookup (INVALID_INDEX if unknown)
+    [[nodiscard]] uint32_t stateIndex(StateId id) const;
+    [[nodiscard]] uint32_t transitionIndex(TransitionId id) const;
+
+    [[nodiscard]] const CompiledState* state(StateId id) const;
+    [[nodiscard]] const CompiledState& stateAt(uint32_t index) const { return states_[index]; }
+    [[nodiscard]] const CompiledTransition& transitionAt(uint32_t index) const { return transitions_[index]; }
+
+    // Outgoing transitions of a state, sorted by priority
+    [[nodiscard]] ArrayView<CompiledTransition> outgoing(const CompiledState& state) const;
+
+    // Priority groups of a state, highest priority first
+    [[nodiscard]] ArrayView<PriorityGroup> groups(const CompiledState& state) const;
+
+    // Transitions of one priority group
+    [[nodiscard]] ArrayView<CompiledTransition> members(const PriorityGroup& group) const;
+
+    // Variables a reactive transition must see change before re-evaluation
+    [[nodiscard]] ArrayView<VariableId> dependencies(const CompiledTransition& entry) const;
+
+    // Native program for the transition's guard (see native_guard.hpp)
+    [[nodiscard]] ArrayView<GuardInstr> guard(const CompiledTransition& entry) const;
+
+    // Event triggers of the transition, in declaration order
+    [[nodiscard]] ArrayView<CompiledTrigger> triggers(const CompiledTransition& entry) const;
+
+    // Transitions whose guard compiled to a native program
+    [[nodiscard]] size_t nativeGuardCount() const { return nativeGuards_; }
+
+private:
+    // Fill the reactive flag and dependency range of a transition
+    void compileDependencies(const Automata& automata, CompiledTransition& entry);
+
+    // Fill the native guard range of a transition
+    void compileGuard(const Automata& automata, CompiledTransition& entry);
+
+    // Fill the trigger range of an event transition
+    void compileTriggers(const Automata& automata, CompiledTransition& entry);
+
+    std::vector<CompiledState> states_;
+    std::vector<CompiledTransition> transitions_;
+    std::vector<PriorityGroup> groups_;
+    std::vector<VariableId> dependencies_;
+    std::vector<GuardInstr> guards_;
+    std::vector<CompiledTrigger> triggers_;
+    std::vector<uint32_t> stateIndexById_;
+    std::vector<uint32_t> transitionIndexById_;
+    size_t maxGroupSize_ = 0;
+    size_t nativeGuards_ = 0;
+};
+
+// ============================================================================
+// Implementation: Dependency Analysis
+// ============================================================================
+
+namespace detail {
+
+inline bool isLuaKeyword(std::string_view word) {
+    static const std::unordered_set<std::string_view> keywords = {
+        "and", "break", "do", "else", "elseif", "end", "false", "for",
+        "function", "goto", "if", "in", "local", "nil", "not", "or",
+        "repeat", "return", "then", "true", "until", "while",
+    };
+    return keywords.count(word) > 0;
+}
+
+// Globals whose result depends only on their arguments and the variable store
+inline bool isPureScriptGlobal(std::string_view word) {
+    static const std::unordered_set<std::string_view> globals = {
+        "math", "string", "table", "tonumber", "tostring", "type",
+        "pairs", "ipairs", "select", "clamp", "check", "changed", "value",
+        "getInput",
+    };
+    return globals.count(word) > 0;
+}
+
+inline void addDependency(std::vector<VariableId>& out, VariableId id) {
+    if (std::find(out.begin(), out.end(), id) == out.end()) {
+        out.push_back(id);
+    }
+}
+
+} // namespace detail
+
+inline bool collectGuardDependencies(const CodeBlock& code, const Automata& automata,
+                                     std::vector<VariableId>& out) {
+    // Reads a mapped block in place; nothing is materialized for analysis
+    const std::string_view src = code.source.empty() ? code.mappedSource : std::string_view(code.source);
+    if (src.empty()) {
+        return !code.hasBytecode();
+    }
+
+    const size_t n = src.size();
+    std::vector<std::string_view> locals;
+    bool declaringLocal = false;
+    char previous = 0;  // Last significant character before the current token
+
+    auto skipLongBracket = [&](size_t i) -> size_t {
+        const size_t close = src.find("]]", i);
+        return close == std::string::npos ? n : close + 2;
+    };
+
+    size_t i = 0;
+    while (i < n) {
+        const char c = src[i];
+
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            ++i;
+            continue;
+        }
+
+        // Comments
+        if (c == '-' && i + 1 < n && src[i + 1] == '-') {
+            if (src.compare(i + 2, 2, "[[") == 0) {
+                i = skipLongBracket(i + 4);
+            } else {
+                const size_t eol = src.find('\n', i);
+                i = eol == std::string::npos ? n : eol + 1;
+            }
+            continue;
+        }
+
+        // String literals; a literal naming a variable counts as a read
+        if (c == '"' || c == '\'') {
+            size_t j = i + 1;
+            while (j < n && src[j] != c) {
+                j += (src[j] == '\\') ? 2 : 1;
+            }
+            const std::string literal(src.substr(i + 1, std::min(j, n) - i - 1));
+            if (const auto* spec = automata.getVariableSpecByName(literal)) {
+                detail::addDependency(out, spec->id);
+            }
+            i = j + 1;
+            previous = c;
+            declaringLocal = false;
+            continue;
+        }
+        if (c == '[' && i + 1 < n && src[i + 1] == '[') {
+            i = skipLongBracket(i + 2);
+            previous = ']';
+            declaringLocal = false;
+            continue;
+        }
+
+        // Numbers
+        if (std::isdigit(static_cast<unsigned char>(c))) {
+            while (i < n && (std::isalnum(static_cast<unsigned char>(src[i])) || src[i] == '.')) {
+                ++i;
+            }
+            previous = '0';
+            declaringLocal = false;
+            continue;
+        }
+
+        // Identifiers
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            size_t j = i;
+            while (j < n && (std::isalnum(static_cast<unsigned char>(src[j])) || src[j] == '_')) {
+                ++j;
+            }
+            const std::string_view word(src.data() + i, j - i);
+            const bool isField = (previous == '.' && !(i >= 2 && src[i - 2] == '.')) ||
+                                 previous == ':';
+            i = j;
+            previous = 'a';
+
+            if (isField) {
+                declaringLocal = false;
+                continue;
+            }
+            if (detail::isLuaKeyword(word)) {
+                declaringLocal = word == "local";
+                continue;
+            }
+            if (declaringLocal) {
+                locals.push_back(word);
+                continue;
+            }
+            if (std::find(locals.begin(), locals.end(), word) != locals.end()) {
+                continue;
+            }
+            if (const auto* spec = automata.getVariableSpecByName(std::string(word))) {
+                detail::addDependency(out, spec->id);
+                continue;
+            }
+            if (detail::isPureScriptGlobal(word)) {
+                continue;
+            }
+            return false;
+        }
+
+        // Punctuation; a comma keeps a `local a, b` declaration going
+        if (c != ',') {
+            declaringLocal = false;
+        }
+        previous = c;
+        ++i;
+    }
+
+    return true;
+}
+
+// ============================================================================
+// Implementation: Compiled Automata
+// ============================================================================
+
+inline void CompiledAutomata::build(const Automata& automata) {
+    clear();
+
+    std::vector<StateId> stateIds;
+    stateIds.reserve(automata.states.size());
+    for (const auto& [id, state] : automata.states) {
+        stateIds.push_back(id);
+    }
+    std::sort(stateIds.begin(), stateIds.end());
+
+    const StateId maxStateId = stateIds.empty() ? 0 : stateIds.back();
+    stateIndexById_.assign(static_cast<size_t>(maxStateId) + 1, INVALID_INDEX);
+    states_.reserve(stateIds.size());
+    for (StateId id : stateIds) {
+        stateIndexById_[id] = static_cast<uint32_t>(states_.size());
+        CompiledState compiled;
+        compiled.state = automata.getState(id);
+        states_.push_back(compiled);
+    }
+
+    TransitionId maxTransitionId = 0;
+    for (const auto& [id, transition] : automata.transitions) {
+        maxTransitionId = std::max(maxTransitionId, id);
+    }
+    transitionIndexById_.assign(static_cast<size_t>(maxTransitionId) + 1, INVALID_INDEX);
+    transitions_.reserve(automata.transitions.size());
+
+    // One pass buckets the transitions by source state; each bucket is then
+    // sorted exactly as getTransitionsFrom sorts, without a scan per state.
+    std::vector<std::vector<const Transition*>> outgoing(states_.size());
+    for (const auto& [id, t] : automata.transitions) {
+        const uint32_t from = stateIndex(t.from);
+        if (t.enabled && from != INVALID_INDEX) {
+            outgoing[from].push_back(&t);
+        }
+    }
+
+    for (auto& compiled : states_) {
+        compiled.transitionsBegin = static_cast<uint32_t>(transitions_.size());
+        compiled.groupsBegin = static_cast<uint32_t>(groups_.size());
+
+        auto& fromHere = outgoing[&compiled - states_.data()];
+        std::sort(fromHere.begin(), fromHere.end(), [](const Transition* a, const Transition* b) {
+            return a->priority < b->priority;
+        });
+        for (const Transition* t : fromHere) {
+            const auto index = static_cast<uint32_t>(transitions_.size());
+            if (groups_.size() == compiled.groupsBegin || groups_.back().priority != t->priority) {
+                PriorityGroup group;
+                group.begin = index;
+                group.priority = t->priority;
+                groups_.push_back(group);
+            }
+
+            CompiledTransition entry;
+            entry.transition = t;
+            entry.evaluate = selectTransitionEvaluator(*t);
+            entry.targetIndex = stateIndex(t->to);
+            entry.timed = t->type == TransitionType::Timed;
+            entry.timeout = entry.timed && t->timedConfig.mode == TimedMode::Timeout;
+            entry.weighted = t->isWeighted();
+            compileDependencies(automata, entry);
+            compileGuard(automata, entry);
+            compileTriggers(automata, entry);
+            transitions_.push_back(entry);
+            transitionIndexById_[t->id] = index;
+
+            auto& group = groups_.back();
+            group.end = index + 1;
+            group.hasTimed = group.hasTimed || entry.timed;
+            maxGroupSize_ = std::max<size_t>(maxGroupSize_, group.end - group.begin);
+        }
+
+        compiled.transitionsEnd = static_cast<uint32_t>(transitions_.size());
+        compiled.groupsEnd = static_cast<uint32_t>(groups_.size());
+        compiled.terminal = compiled.transitionsBegin == compiled.transitionsEnd;
+    }
+}
+
+inline void CompiledAutomata::compileDependencies(const Automata& automata,
+                                                  CompiledTransition& entry) {
+    const Transition& t = *entry.transition;
+    entry.dependenciesBegin = static_cast<uint32_t>(dependencies_.size());
+    entry.dependenciesEnd = entry.dependenciesBegin;
+
+    std::vector<VariableId> deps;
+
+    // Explicit declaration replaces source analysis of the guard
+    auto collectGuard = [&](const CodeBlock& guard) {
+        if (t.dependsOn.empty()) {
+            return collectGuardDependencies(guard, automata, deps);
+        }
+        for (const auto& name : t.dependsOn) {
+            const auto* spec = automata.getVariableSpecByName(name);
+            if (!spec) {
+                return false;
+            }
+            detail::addDependency(deps, spec->id);
+        }
+        return true;
+    };
+
+    bool analyzable = false;
+    if (t.type == TransitionType::Classic) {
+        analyzable = !t.classicConfig.condition.isEmpty() &&
+                     collectGuard(t.classicConfig.condition);
+    } else if (t.type == TransitionType::Event) {
+        // Triggers need a change on their signal; unknown signals never trigger.
+        for (const auto& trigger : t.eventConfig.triggers) {
+            if (const auto* spec = automata.getVariableSpecByName(trigger.signalName)) {
+                detail::addDependency(deps, spec->id);
+            }
+        }
+        analyzable = collectGuard(t.eventConfig.additionalCondition);
+    }
+
+    // Timed, immediate and probabilistic transitions are always evaluated.
+    if (!analyzable) {
+        return;
+    }
+
+    entry.reactive = true;
+    dependencies_.insert(dependencies_.end(), deps.begin(), deps.end());
+    entry.dependenciesEnd = static_cast<uint32_t>(dependencies_.size());
+}
+
+inline void CompiledAutomata::compileGuard(const Automata& automata, CompiledTransition& entry) {
+    const Transition& t = *entry.transition;
+    entry.guardBegin = static_cast<uint32_t>(guards_.size());
+    entry.guardEnd = entry.guardBegin;
+
+    const CodeBlock* guard = nullptr;
+    switch (t.type) {
+        case TransitionType::Classic: guard = &t.classicConfig.condition; break;
+        case TransitionType::Timed: guard = &t.timedConfig.additionalCondition; break;
+        case TransitionType::Event: guard = &t.eventConfig.additionalCondition; break;
+        default: break;
+    }
+    if (!guard || guard->isEmpty() || !compileNativeGuard(*guard, automata, guards_)) {
+        return;
+    }
+    entry.guardEnd = static_cast<uint32_t>(guards_.size());
+    ++nativeGuards_;
+}
+
+inline void CompiledAutomata::compileTriggers(const Automata& automata, CompiledTransition& entry) {
+    const Transition& t = *entry.transition;
+    entry.triggersBegin = static_cast<uint32_t>(triggers_.size());
+    if (t.type == TransitionType::Event) {
+        for (const auto& trigger : t.eventConfig.triggers) {
+            CompiledTrigger compiled;
+            compiled.trigger = &trigger;
+            compiled.fired = selectTriggerEvaluator(trigger);
+            if (const auto* spec = automata.getVariableSpecByName(trigger.signalName)) {
+                compiled.signal = spec->id;
+            }
+            if (trigger.threshold) {
+                compiled.threshold = trigger.threshold->value.toDouble();
+            }
+            compiled.pattern = trigger.pattern;
+            triggers_.push_back(compiled);
+        }
+    }
+    entry.triggersEnd = static_cast<uint32_t>(triggers_.size());
+}
+
+inline void CompiledAutomata::clear() {
+    states_.clear();
+    transitions_.clear();
+    groups_.clear();
+    dependencies_.clear();
+    guards_.clear();
+    triggers_.clear();
+    stateIndexById_.clear();
+    transitionIndexById_.clear();
+    maxGroupSize_ = 0;
+    nativeGuards_ = 0;
+}
+
+inline uint32_t CompiledAutomata::stateIndex(StateId id) const {
+    return id < stateIndexById_.size() ? stateIndexById_[id] : INVALID_INDEX;
+}
+
+inline uint32_t CompiledAutomata::transitionIndex(TransitionId id) const {
+    return id < transitionIndexById_.size() ? transitionIndexById_[id] : INVALID_INDEX;
+}
+
+inline const CompiledState* CompiledAutomata::state(StateId id) const {
+    const uint32_t index = stateIndex(id);
+    return index != INVALID_INDEX ? &states_[index] : nullptr;
+}
+
+inline ArrayView<CompiledTransition> CompiledAutomata::outgoing(const CompiledState& state) const {
+    const auto* base = transitions_.data();
+    return {base + state.transitionsBegin, base + state.transitionsEnd};
+}
+
+inline ArrayView<PriorityGroup> CompiledAutomata::groups(const CompiledState& state) const {
+    const auto* base = groups_.data();
+    return {base + state.groupsBegin, base + state.groupsEnd};
+}
+
+inline ArrayView<CompiledTransition> CompiledAutomata::members(const PriorityGroup& group) const {
+    const auto* base = transitions_.data();
+    return {base + group.begin, base + group.end};
+}
+
+inline ArrayView<VariableId> CompiledAutomata::dependencies(const CompiledTransition& entry) const {
+    const auto* base = dependencies_.data();
+    return {base + entry.dependenciesBegin, base + entry.dependenciesEnd};
+}
+
+inline ArrayView<GuardInstr> CompiledAutomata::guard(const CompiledTransition& entry) const {
+    const auto* base = guards_.data();
+    return {base + entry.guardBegin, base + entry.guardEnd};
+}
+
+inline ArrayView<CompiledTrigger> CompiledAutomata::triggers(const CompiledTransition& entry) const {
+    const auto* base = triggers_.data();
+    return {base + entry.triggersBegin, base + entry.triggersEnd};
+}
+
+} // namespace aeth
+
+#endif // AETHERIUM_COMPILED_AUTOMATA_HPP
@@ -0,0 +1,43 @@
+/**
+ * Aetherium Automata - CRC-32
+ *
+ * IEEE 802.3 CRC-32 (same as zlib / Erlang's :erlang.crc32). Nibble-table
+ * variant: 64 bytes of table, which suits the embedded targets better than
+ * the usual 1 KiB byte table.
+ */
+
+#ifndef AETHERIUM_CRC32_HPP
+#define AETHERIUM_CRC32_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace aeth {
+
+/**
+ * Continue a CRC over `len` more bytes. Start with crc = 0; feeding a
+ * buffer in pieces gives the same result as feeding it whole.
+ */
+inline uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len) {
+    static constexpr uint32_t kTable[16] = {
+        0x00000000u, 0x1DB71064u, 0x3B6E20C8u, 0x26D930ACu,
+        0x76DC4190u, 0x6B6B51F4u, 0x4DB26158u, 0x5005713Cu,
+        0xEDB88320u, 0xF00F9344u, 0xD6D6A3E8u, 0xCB61B38Cu,
+        0x9B64C2B0u, 0x86D3D2D4u, 0xA00AE278u, 0xBDBDF21Cu,
+    };
+    crc = ~crc;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ kTable[crc & 0x0F];
+        crc = (crc >> 4) ^ kTable[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+inline uint32_t crc32(const uint8_t* data, size_t len) {
+    return crc32Update(0, data, len);
+}
+
+} // namespace aeth
+
+#endif // AETHERIUM_CRC32_HPP
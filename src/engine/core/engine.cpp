@@ -1,7 +1,11 @@
 #include "engine.hpp"
+#include "crc32.hpp"
 #include "script_engine.hpp"
 
-#if !defined(AETHERIUM_RUNTIME_CORE_ONLY)
+// Runtime-core and YAML-less builds load bytecode artifacts only
+#if defined(AETHERIUM_RUNTIME_CORE_ONLY) || defined(AETHERIUM_DISABLE_YAML_FRONTEND)
+#define AETHERIUM_ENGINE_WITHOUT_YAML 1
+#else
 #include "automata_loader.hpp"
 #endif
 
@@ -11,12 +15,15 @@
 
 #if defined(ARDUINO) || defined(AETHERIUM_PLATFORM_MCXN947)
 #include "engine/embedded/platform/EmbeddedPlatformHooks.hpp"
+#else
+#include "mapped_file.hpp"
 #endif
 
 #ifdef abs
 #undef abs
 #endif
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <limits>
@@ -27,8 +34,11 @@
 
 namespace aeth {
 
-#if !defined(AETHERIUM_RUNTIME_CORE_ONLY)
+#if !defined(AETHERIUM_ENGINE_WITHOUT_YAML)
 struct EngineFrontendLoaderHandle {
+    // Deploys from an editor reload the same document with small edits
+    EngineFrontendLoaderHandle() { loader.setIncremental(true); }
+
     AutomataLoader loader;
 };
 #else
@@ -50,6 +60,11 @@ uint16_t toReasonCode(protocol::ErrorCode code) {
     return static_cast<uint16_t>(code);
 }
 
+// Heap order for the fault-delay heap: earliest release on top, arrival order on ties
+constexpr auto releasesLater = [](const auto& a, const auto& b) {
+    return a.releaseAt != b.releaseAt ? a.releaseAt > b.releaseAt : a.sequence > b.sequence;
+};
+
 double clampProbability(double value) {
     if (std::isnan(value)) {
         return 0.0;
@@ -104,9 +119,75 @@ void deriveBlackBoxPorts(Automata& automata) {
     }
 }
 
-Result<std::unique_ptr<Automata>> automataFromEngineBytecode(const ir::EngineBytecodeProgram& program) {
+void assignSource(CodeBlock& block, const std::string& source) {
+    block.source = source;
+}
+
+// Mapped programs leave code in the artifact; it is copied out on first use
+void assignSource(CodeBlock& block, std::string_view source) {
+    block.mappedSource = source;
+}
+
+// The block a precompiled chunk is for, or nullptr if the owner is unknown
+CodeBlock* luaChunkBlock(Automata& automata, const ir::BytecodeLuaChunk& chunk) {
+    switch (chunk.slot) {
+        case ir::LuaChunkSlot::StateOnEnter:
+        case ir::LuaChunkSlot::StateBody:
+        case ir::LuaChunkSlot::StateOnExit: {
+            State* state = automata.getState(chunk.ownerId);
+            if (!state) {
+                return nullptr;
+            }
+            if (chunk.slot == ir::LuaChunkSlot::StateOnEnter) return &state->onEnter;
+            if (chunk.slot == ir::LuaChunkSlot::StateBody) return &state->body;
+            return &state->onExit;
+        }
+        case ir::LuaChunkSlot::TransitionCondition:
+        case ir::LuaChunkSlot::TransitionBody:
+        case ir::LuaChunkSlot::TransitionTriggered: {
+            Transition* tr = automata.getTransition(chunk.ownerId);
+            if (!tr) {
+                return nullptr;
+            }
+            if (chunk.slot == ir::LuaChunkSlot::TransitionBody) return &tr->body;
+            if (chunk.slot == ir::LuaChunkSlot::TransitionTriggered) return &tr->triggered;
+            switch (tr->type) {
+                case TransitionType::Classic: return &tr->classicConfig.condition;
+                case TransitionType::Timed: return &tr->timedConfig.additionalCondition;
+                case TransitionType::Event: return &tr->eventConfig.additionalCondition;
+                default: return nullptr;
+            }
+        }
+    }
+    return nullptr;
+}
+
+// Tagged so the script engine can fall back to source on a Lua mismatch
+Result<void> attachLuaChunks(Automata& automata, const ir::EngineBytecodeProgram& program) {
+    for (const auto& chunk : program.luaChunks) {
+        CodeBlock* block = luaChunkBlock(automata, chunk);
+        if (!block) {
+            return Result<void>::error("bytecode lua chunk references unknown code block");
+        }
+        // Same kind the chunk was compiled as; the block's kind is already restored
+        const CodeKind kind = block->resolvedKind(chunk.slot == ir::LuaChunkSlot::TransitionCondition
+            ? CodeKind::Expression
+            : CodeKind::Statement);
+        block->bytecode = tagLuaChunk(program.luaTarget, kind, chunk.bytes);
+    }
+    return Result<void>::ok();
+}
+
+// Indexed payloads carry no chunks
+Result<void> attachLuaChunks(Automata&, const ir::MappedBytecodeProgram&) {
+    return Result<void>::ok();
+}
+
+// Program is ir::EngineBytecodeProgram or ir::MappedBytecodeProgram
+template<typename Program>
+Result<std::unique_ptr<Automata>> automataFromEngineBytecode(const Program& program) {
     auto automata = std::make_unique<Automata>();
-    automata->config.name = program.name;
+    automata->config.name = std::string(program.name);
     automata->initialState = program.initialState;
 
     std::unordered_set<StateId> stateIds;
@@ -122,10 +203,10 @@ Result<std::unique_ptr<Automata>> automataFromEngineBytecode(const ir::EngineByt
         if (!stateIds.insert(s.id).second) {
             return Result<std::unique_ptr<Automata>>::error("duplicate bytecode state id");
         }
-        State state{s.id, s.name};
-        state.onEnter.source = s.onEnterSource;
-        state.body.source = s.bodySource;
-        state.onExit.source = s.onExitSource;
+        State state{s.id, std::string(s.name)};
+        assignSource(state.onEnter, s.onEnterSource);
+        assignSource(state.body, s.bodySource);
+        assignSource(state.onExit, s.onExitSource);
         automata->addState(std::move(state));
     }
 
@@ -151,6 +232,7 @@ Result<std::unique_ptr<Automata>> automataFromEngineBytecode(const ir::EngineByt
         spec.type = v.type;
         spec.direction = v.direction;
         spec.initialValue = v.initialValue;
+        spec.telemetry = v.telemetry;
         automata->addVariable(std::move(spec));
     }
 
@@ -167,12 +249,12 @@ Result<std::unique_ptr<Automata>> automataFromEngineBytecode(const ir::EngineByt
             return Result<std::unique_ptr<Automata>>::error("bytecode transition references unknown state");
         }
 
-        Transition tr(t.id, t.name.empty() ? ("t" + std::to_string(t.id)) : t.name, t.from, t.to);
+        Transition tr(t.id, t.name.empty() ? ("t" + std::to_string(t.id)) : std::string(t.name), t.from, t.to);
         tr.priority = t.priority;
         tr.enabled = t.enabled;
         tr.weight = t.weight;
-        tr.body.source = t.bodySource;
-        tr.triggered.source = t.triggeredSource;
+        assignSource(tr.body, t.bodySource);
+        assignSource(tr.triggered, t.triggeredSource);
 
         switch (t.kind) {
             case ir::BytecodeTransitionKind::Immediate:
@@ -182,20 +264,23 @@ Result<std::unique_ptr<Automata>> automataFromEngineBytecode(const ir::EngineByt
                 tr.type = TransitionType::Timed;
                 tr.timedConfig.mode = TimedMode::After;
                 tr.timedConfig.delayMs = t.delayMs;
-                tr.timedConfig.additionalCondition.source = t.conditionExpression;
+                assignSource(tr.timedConfig.additionalCondition, t.conditionExpression);
+                tr.timedConfig.additionalCondition.kind = t.conditionKind;
                 break;
             case ir::BytecodeTransitionKind::TimedTimeout:
                 tr.type = TransitionType::Timed;
                 tr.timedConfig.mode = TimedMode::Timeout;
                 tr.timedConfig.delayMs = t.delayMs;
-                tr.timedConfig.additionalCondition.source = t.conditionExpression;
+                assignSource(tr.timedConfig.additionalCondition, t.conditionExpression);
+                tr.timedConfig.additionalCondition.kind = t.conditionKind;
                 break;
             case ir::BytecodeTransitionKind::ClassicCondition:
                 if (t.conditionExpression.empty()) {
                     return Result<std::unique_ptr<Automata>>::error("classic bytecode transition missing condition");
                 }
                 tr.type = TransitionType::Classic;
-                tr.classicConfig.condition.source = t.conditionExpression;
+                assignSource(tr.classicConfig.condition, t.conditionExpression);
+                tr.classicConfig.condition.kind = t.conditionKind;
                 break;
             case ir::BytecodeTransitionKind::EventSignal: {
                 if (t.eventSignalName.empty()) {
@@ -213,7 +298,7 @@ Result<std::unique_ptr<Automata>> automataFromEngineBytecode(const ir::EngineByt
                 }
                 tr.type = TransitionType::Event;
                 SignalTrigger trigger;
-                trigger.signalName = t.eventSignalName;
+                trigger.signalName = std::string(t.eventSignalName);
                 trigger.signalType = t.eventSignalDirection;
                 trigger.triggerType = t.eventTriggerType;
                 if (t.eventTriggerType == EventTrigger::OnThreshold) {
@@ -230,11 +315,12 @@ Result<std::unique_ptr<Automata>> automataFromEngineBytecode(const ir::EngineByt
                     if (t.eventPattern.empty()) {
                         return Result<std::unique_ptr<Automata>>::error("match event bytecode transition missing pattern");
                     }
-                    trigger.pattern = t.eventPattern;
+                    trigger.pattern = std::string(t.eventPattern);
                 }
                 tr.eventConfig.requireAll = false;
                 tr.eventConfig.debounceMs = 0;
-                tr.eventConfig.additionalCondition.source = t.conditionExpression;
+                assignSource(tr.eventConfig.additionalCondition, t.conditionExpression);
+                tr.eventConfig.additionalCondition.kind = t.conditionKind;
                 tr.eventConfig.triggers.push_back(std::move(trigger));
                 break;
             }
@@ -245,6 +331,11 @@ Result<std::unique_ptr<Automata>> automataFromEngineBytecode(const ir::EngineByt
         automata->addTransition(std::move(tr));
     }
 
+    auto chunks = attachLuaChunks(*automata, program);
+    if (chunks.isError()) {
+        return Result<std::unique_ptr<Automata>>::error(chunks.error());
+    }
+
     const auto errors = automata->validate();
     if (!errors.empty()) {
         return Result<std::unique_ptr<Automata>>::error("bytecode automata invalid: " + joinErrors(errors));
@@ -255,6 +346,8 @@ Result<std::unique_ptr<Automata>> automataFromEngineBytecode(const ir::EngineByt
     return Result<std::unique_ptr<Automata>>::ok(std::move(automata));
 }
 
+} // namespace
+
 std::unique_ptr<IScriptEngine> makeDefaultScriptEngine() {
 #if defined(AETHERIUM_DISABLE_LUA_SCRIPT_ENGINE)
     return std::make_unique<SimpleScriptEngine>();
@@ -263,8 +356,6 @@ std::unique_ptr<IScriptEngine> makeDefaultScriptEngine() {
 #endif
 }
 
-} // namespace
-
 Engine::Engine()
     : runtime_(std::make_unique<StdClock>(),
                std::make_unique<StdRandomSource>(),
@@ -287,20 +378,39 @@ Engine::Engine(std::unique_ptr<IClock> clock,
 
 Engine::~Engine() = default;
 
+Timestamp Engine::eventTimeMs() const {
+    return virtualTime_ ? runtime_.now() : wallClockMs();
+}
+
 Result<void> Engine::initialize(const EngineInitOptions& options) {
     runtime_.setMaxTickRate(options.maxTickRate);
+    runtime_.setTickMode(options.tickMode);
+    runtime_.setGcPolicy(options.gcPolicy);
+    runtime_.setScriptMemoryBudget(options.scriptMemoryBudget);
+    runtime_.warmScriptEngines(options.spareScriptEngines);
     logHub_.setCapacity(options.logCapacity);
     deviceId_ = options.deviceId;
     deviceName_ = options.deviceName;
     deployment_ = options.deployment;
     setFaultProfile(options.faultProfile);
     traceOutputPath_ = options.traceOutputPath;
+    virtualTime_ = options.virtualTime;
+    traceEnabled_ = options.traceEnabled;
+    checkpointEveryTicks_ = options.checkpointEveryTicks;
+    checkpoints_.setCapacity(options.checkpointCapacity);
+    checkpoints_.clear();
+    maxLoadBytes_ = options.maxLoadBytes;
     if (options.faultRandomSeed) {
         faultRandom_.seed(*options.faultRandomSeed);
     }
     batteryPercent_ = std::clamp(options.deployment.battery.chargePercent, 0.0, 100.0);
+    pacer_.configure(deployment_.pacing, options.maxTickRate);
     traceStore_.setMaxRecords(options.traceCapacity);
     traceStore_.clear();
+    auto traceStream = openTraceStream();
+    if (traceStream.isError()) {
+        return traceStream;
+    }
     traceLifecycleEvent("engine initialized", "engine");
     return Result<void>::ok();
 }
@@ -309,12 +419,32 @@ Result<RunId> Engine::loadAutomataFromFile(const std::string& filePath,
                                            protocolv2::LoadReplaceMode mode,
                                            bool startAfterLoad,
                                            std::optional<RunId> requestedRunId) {
-#if defined(AETHERIUM_RUNTIME_CORE_ONLY)
+#if !defined(ARDUINO) && !defined(AETHERIUM_PLATFORM_MCXN947)
+    // Binary artifacts are mapped, not parsed; indexed payloads load in place
+    auto mapped = MappedFile::open(filePath);
+    if (mapped.isOk() && ir::hasArtifactMagic(mapped.value()->data(), mapped.value()->size())) {
+        auto view = ir::viewArtifact(mapped.value()->data(), mapped.value()->size());
+        if (view.isError()) {
+            return Result<RunId>::error(view.error());
+        }
+        if (view.value().payloadKind == ir::PayloadKind::EngineBytecodeIndexed) {
+            return loadIndexedBytecode(view.value().payload, view.value().payloadSize, mapped.value(),
+                                       mode, startAfterLoad, requestedRunId);
+        }
+        ir::AutomataArtifact artifact;
+        artifact.header = view.value().header;
+        artifact.payloadKind = view.value().payloadKind;
+        artifact.sourceLabel = std::string(view.value().sourceLabel);
+        artifact.payloadBytes.assign(view.value().payload, view.value().payload + view.value().payloadSize);
+        return loadAutomataFromArtifact(artifact, mode, startAfterLoad, requestedRunId);
+    }
+#endif
+#if defined(AETHERIUM_ENGINE_WITHOUT_YAML)
     (void) filePath;
     (void) mode;
     (void) startAfterLoad;
     (void) requestedRunId;
-    return Result<RunId>::error("runtime_core build does not include file/YAML loader");
+    return Result<RunId>::error("this build loads bytecode artifacts only (no file/YAML loader)");
 #else
     if (!frontendLoader_) {
         return Result<RunId>::error("loader frontend unavailable");
@@ -335,13 +465,13 @@ Result<RunId> Engine::loadAutomataFromYaml(const std::string& yaml,
                                            protocolv2::LoadReplaceMode mode,
                                            bool startAfterLoad,
                                            std::optional<RunId> requestedRunId) {
-#if defined(AETHERIUM_RUNTIME_CORE_ONLY)
+#if defined(AETHERIUM_ENGINE_WITHOUT_YAML)
     (void) yaml;
     (void) basePath;
     (void) mode;
     (void) startAfterLoad;
     (void) requestedRunId;
-    return Result<RunId>::error("runtime_core build does not include YAML loader");
+    return Result<RunId>::error("this build loads bytecode artifacts only (no YAML loader)");
 #else
     if (!frontendLoader_) {
         return Result<RunId>::error("loader frontend unavailable");
@@ -378,11 +508,34 @@ Result<RunId> Engine::loadAutomataFromArtifact(const ir::AutomataArtifact& artif
             }
             return applyLoadedAutomata(std::move(automata.value()), mode, startAfterLoad, requestedRunId);
         }
+        case ir::PayloadKind::EngineBytecodeIndexed: {
+            auto storage = std::make_shared<std::vector<uint8_t>>(artifact.payloadBytes);
+            return loadIndexedBytecode(storage->data(), storage->size(), storage,
+                                       mode, startAfterLoad, requestedRunId);
+        }
     }
 
     return Result<RunId>::error("unsupported artifact payload kind");
 }
 
+Result<RunId> Engine::loadIndexedBytecode(const uint8_t* data,
+                                          size_t size,
+                                          std::shared_ptr<const void> storage,
+                                          protocolv2::LoadReplaceMode mode,
+                                          bool startAfterLoad,
+                                          std::optional<RunId> requestedRunId) {
+    auto program = ir::MappedBytecodeProgram::open(data, size);
+    if (program.isError()) {
+        return Result<RunId>::error("engine bytecode decode failed: " + program.error());
+    }
+    auto automata = automataFromEngineBytecode(program.value());
+    if (automata.isError()) {
+        return Result<RunId>::error(automata.error());
+    }
+    automata.value()->codeStorage = std::move(storage);
+    return applyLoadedAutomata(std::move(automata.value()), mode, startAfterLoad, requestedRunId);
+}
+
 Result<RunId> Engine::loadAutomataFromBytes(const std::vector<uint8_t>& bytes,
                                             protocolv2::LoadReplaceMode mode,
                                             bool startAfterLoad,
@@ -398,6 +551,18 @@ Result<RunId> Engine::applyLoadedAutomata(std::unique_ptr<Automata> automata,
                                           protocolv2::LoadReplaceMode mode,
                                           bool startAfterLoad,
                                           std::optional<RunId> requestedRunId) {
+    hotSwap_.reset();  // A newer load supersedes one still warming up
+
+    if (mode == protocolv2::LoadReplaceMode::HotSwap) {
+        if (runtime_.state() == ExecutionState::Running || runtime_.state() == ExecutionState::Paused) {
+            if (auto script = runtime_.createScriptEngine()) {
+                return stageHotSwap(std::move(automata), std::move(script), requestedRunId);
+            }
+        }
+        // Nothing running to keep alive, or no second script engine: plain carry-over
+        mode = protocolv2::LoadReplaceMode::CarryOverCompatible;
+    }
+
     std::unordered_map<std::string, std::pair<VariableSpec, Value>> oldValues;
 
     if (mode == protocolv2::LoadReplaceMode::CarryOverCompatible && runtime_.isLoaded() && loadedAutomata_) {
@@ -423,6 +588,9 @@ Result<RunId> Engine::applyLoadedAutomata(std::unique_ptr<Automata> automata,
 
     RunId runId = requestedRunId.value_or(loadResult.value());
     activeRunId_ = runId;
+    telemetryDelta_.reset();  // Variable set may have changed
+    peerLinks_.bind(runtime_.context().variables);
+    telemetryAggregator_.bind(loadedAutomata_->variables, runtime_.context().variables, eventTimeMs());
 
     if (!oldValues.empty()) {
         for (const auto& spec : loadedAutomata_->variables) {
@@ -453,6 +621,120 @@ Result<RunId> Engine::applyLoadedAutomata(std::unique_ptr<Automata> automata,
 
     logHub_.event(EventKind::Lifecycle, LogLevel::Info, "engine", "automata loaded", runId);
     traceLifecycleEvent("automata loaded", "engine", runId);
+    traceLoadedContract(runId);
+    analyzeLoadedAutomata(runId);
+    return Result<RunId>::ok(runId);
+}
+
+Result<RunId> Engine::stageHotSwap(std::unique_ptr<Automata> automata,
+                                   std::unique_ptr<IScriptEngine> script,
+                                   std::optional<RunId> requestedRunId) {
+    // Validation errors still belong in the LoadAck
+    auto errors = automata->validate();
+    if (!errors.empty()) {
+        return Result<RunId>::error("Validation failed: " + errors[0]);
+    }
+    deriveBlackBoxPorts(*automata);
+
+    auto pending = std::make_unique<PendingHotSwap>();
+    pending->automata = std::move(automata);
+    pending->requestedRunId = requestedRunId;
+    pending->stagedAt = std::chrono::steady_clock::now();
+
+    PendingHotSwap* staged = pending.get();
+    auto warmUp = [staged, script = std::move(script)]() mutable {
+        auto prepared = Runtime::prepare(*staged->automata, std::move(script));
+        if (prepared.isOk()) {
+            staged->prepared = std::move(prepared.value());
+        } else {
+            staged->error = prepared.error();
+        }
+        staged->preparedAt = std::chrono::steady_clock::now();
+        staged->ready.store(true, std::memory_order_release);
+    };
+#if defined(ARDUINO) || defined(AETHERIUM_PLATFORM_MCXN947)
+    warmUp();  // No threads; the swap itself still waits for a tick boundary
+#else
+    staged->worker = std::thread(std::move(warmUp));
+#endif
+
+    const RunId runId = requestedRunId.value_or(runtime_.nextRunId());
+    const std::string name = pending->automata->config.name;
+    hotSwap_ = std::move(pending);
+    traceRuntimeEvent("hot_swap_staged", "engine", "hot swap staged: " + name, runId);
+    return Result<RunId>::ok(runId);
+}
+
+void Engine::applyPendingHotSwap() {
+    if (!hotSwap_ || !hotSwap_->ready.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::unique_ptr<PendingHotSwap> pending = std::move(hotSwap_);
+#if !defined(ARDUINO) && !defined(AETHERIUM_PLATFORM_MCXN947)
+    pending->worker.join();
+#endif
+
+    if (!pending->prepared) {
+        logHub_.log(LogLevel::Error, "engine", "hot swap failed: " + pending->error);
+        traceRuntimeEvent("hot_swap_failed", "engine", "hot swap failed: " + pending->error, activeRunId_);
+        return;
+    }
+
+    const auto swapBegin = std::chrono::steady_clock::now();
+    auto swapped = runtime_.swapIn(*pending->prepared);
+    const auto swapEnd = std::chrono::steady_clock::now();
+    if (swapped.isError()) {
+        logHub_.log(LogLevel::Error, "engine", "hot swap failed: " + swapped.error());
+        traceRuntimeEvent("hot_swap_failed", "engine", "hot swap failed: " + swapped.error(), activeRunId_);
+        return;
+    }
+
+    // pending keeps the old automata alive until the retired run is freed
+    std::swap(loadedAutomata_, pending->automata);
+    const RunId runId = pending->requestedRunId.value_or(swapped.value());
+    activeRunId_ = runId;
+    telemetryDelta_.reset();  // Variable set may have changed
+    peerLinks_.bind(runtime_.context().variables);
+    telemetryAggregator_.bind(loadedAutomata_->variables, runtime_.context().variables, eventTimeMs());
+
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    std::ostringstream summary;
+    summary << "hot swap applied in " << duration_cast<microseconds>(swapEnd - swapBegin).count()
+            << " us (warm-up " << duration_cast<microseconds>(pending->preparedAt - pending->stagedAt).count()
+            << " us, staged " << duration_cast<microseconds>(swapEnd - pending->stagedAt).count() << " us ago)";
+    retiredHotSwap_ = std::move(pending);
+
+    logHub_.event(EventKind::Lifecycle, LogLevel::Info, "engine", "automata hot-swapped", runId);
+    traceRuntimeEvent("hot_swap", "engine", summary.str(), runId);
+    traceLoadedContract(runId);
+    analyzeLoadedAutomata(runId);
+    if (idOnlyWire_) {
+        if (auto table = buildSymbolTable()) {
+            queueEvent(std::move(table));
+        }
+    }
+}
+
+void Engine::analyzeLoadedAutomata(RunId runId) {
+#if !defined(ARDUINO) && !defined(AETHERIUM_PLATFORM_MCXN947)
+    // A warning per finding, capped so a large generated automata can't flood the log
+    constexpr size_t kLoggedFindings = 20;
+    analysis_ = analysisCache_.analyze(*loadedAutomata_, runtime_.compiled());
+    const auto& findings = analysis_->findings;
+    for (size_t i = 0; i < std::min(findings.size(), kLoggedFindings); ++i) {
+        logHub_.log(LogLevel::Warn, "analysis", findings[i].message, runId);
+    }
+    if (findings.size() > kLoggedFindings) {
+        logHub_.log(LogLevel::Warn, "analysis",
+                    std::to_string(findings.size() - kLoggedFindings) + " more analysis findings", runId);
+    }
+#else
+    (void) runId;
+#endif
+}
+
+void Engine::traceLoadedContract(RunId runId) {
     if (!loadedAutomata_->blackBox.ports.empty() ||
         !loadedAutomata_->blackBox.observableStates.empty() ||
         !loadedAutomata_->blackBox.resources.empty()) {
@@ -492,15 +774,13 @@ Result<RunId> Engine::applyLoadedAutomata(std::unique_ptr<Automata> automata,
                               runId);
         }
     }
-    return Result<RunId>::ok(runId);
 }
 
 void Engine::resetPendingChunkedLoad() {
     pendingChunkedLoad_ = PendingChunkedLoad{};
 }
 
-Result<bool> Engine::appendChunkedLoad(const protocol::LoadAutomataMessage& load,
-                                       std::vector<uint8_t>& assembledData) {
+Result<bool> Engine::appendChunkedLoad(const protocol::LoadAutomataMessage& load) {
     if (load.totalChunks == 0) {
         resetPendingChunkedLoad();
         return Result<bool>::error("chunked load has zero total_chunks");
@@ -509,6 +789,10 @@ Result<bool> Engine::appendChunkedLoad(const protocol::LoadAutomataMessage& load
         resetPendingChunkedLoad();
         return Result<bool>::error("chunked load index out of range");
     }
+    if (load.chunkCrc && crc32(load.data.data(), load.data.size()) != *load.chunkCrc) {
+        resetPendingChunkedLoad();
+        return Result<bool>::error("chunked load chunk " + std::to_string(load.chunkIndex) + " failed CRC check");
+    }
 
     auto& pending = pendingChunkedLoad_;
     const bool beginNew = (load.chunkIndex == 0);
@@ -527,7 +811,9 @@ Result<bool> Engine::appendChunkedLoad(const protocol::LoadAutomataMessage& load
         pending.totalChunks = load.totalChunks;
         pending.nextChunkIndex = 0;
         pending.totalBytes = 0;
-        pending.data.clear();
+        if (load.format == protocol::AutomataFormat::Binary) {
+            pending.artifact = std::make_unique<ir::ArtifactStreamDecoder>(maxLoadBytes_);
+        }
     } else {
         if (load.sourceId != pending.sourceId ||
             load.runId != pending.runId ||
@@ -545,29 +831,67 @@ Result<bool> Engine::appendChunkedLoad(const protocol::LoadAutomataMessage& load
         return Result<bool>::error("chunked load arrived out of order");
     }
 
-    if (pending.totalBytes + load.data.size() > kMaxChunkedLoadBytes) {
+    if (pending.totalBytes + load.data.size() > maxLoadBytes_) {
         resetPendingChunkedLoad();
         return Result<bool>::error("chunked load exceeds assembly limit");
     }
 
-    pending.data.insert(pending.data.end(), load.data.begin(), load.data.end());
+    if (pending.artifact) {
+        // Decode as it arrives; only a record split across chunks is kept.
+        auto fed = pending.artifact->feed(load.data.data(), load.data.size());
+        if (fed.isError()) {
+            resetPendingChunkedLoad();
+            return Result<bool>::error("chunked load rejected: " + fed.error());
+        }
+    } else {
+        pending.text.insert(pending.text.end(), load.data.begin(), load.data.end());
+    }
     pending.totalBytes += load.data.size();
     pending.nextChunkIndex++;
 
-    if (pending.nextChunkIndex < pending.totalChunks) {
-        return Result<bool>::ok(false);
-    }
+    return Result<bool>::ok(pending.nextChunkIndex == pending.totalChunks);
+}
 
-    assembledData.swap(pending.data);
+Result<RunId> Engine::finishChunkedLoad(const protocol::LoadAutomataMessage& load) {
+    PendingChunkedLoad pending = std::move(pendingChunkedLoad_);
     resetPendingChunkedLoad();
-    return Result<bool>::ok(true);
+
+    const auto mode = protocolReplaceMode(load.replaceExisting);
+
+    if (pending.artifact) {
+        auto finished = pending.artifact->finish();
+        if (finished.isError()) {
+            return Result<RunId>::error(finished.error());
+        }
+        return loadDecodedArtifact(*pending.artifact, mode, load.startAfterLoad, load.runId);
+    }
+    return applyProtocolLoad(load, pending.text);
+}
+
+Result<RunId> Engine::loadDecodedArtifact(ir::ArtifactStreamDecoder& artifact,
+                                          protocolv2::LoadReplaceMode mode,
+                                          bool startAfterLoad,
+                                          std::optional<RunId> requestedRunId) {
+    if (artifact.payloadKind() == ir::PayloadKind::YamlText) {
+        const std::string yaml(artifact.payloadBytes().begin(), artifact.payloadBytes().end());
+        const std::string basePath = artifact.sourceLabel().empty() ? "." : artifact.sourceLabel();
+        return loadAutomataFromYaml(yaml, basePath, mode, startAfterLoad, requestedRunId);
+    }
+    if (artifact.payloadKind() == ir::PayloadKind::EngineBytecodeIndexed) {
+        auto storage = std::make_shared<std::vector<uint8_t>>(std::move(artifact.payloadBytes()));
+        return loadIndexedBytecode(storage->data(), storage->size(), storage,
+                                   mode, startAfterLoad, requestedRunId);
+    }
+    auto automata = automataFromEngineBytecode(artifact.program());
+    if (automata.isError()) {
+        return Result<RunId>::error(automata.error());
+    }
+    return applyLoadedAutomata(std::move(automata.value()), mode, startAfterLoad, requestedRunId);
 }
 
 Result<RunId> Engine::applyProtocolLoad(const protocol::LoadAutomataMessage& load,
                                         const std::vector<uint8_t>& data) {
-    const auto mode = load.replaceExisting
-        ? protocolv2::LoadReplaceMode::HardReset
-        : protocolv2::LoadReplaceMode::CarryOverCompatible;
+    const auto mode = protocolReplaceMode(load.replaceExisting);
 
     switch (load.format) {
         case protocol::AutomataFormat::YAML: {
@@ -581,6 +905,14 @@ Result<RunId> Engine::applyProtocolLoad(const protocol::LoadAutomataMessage& loa
     }
 }
 
+protocolv2::LoadReplaceMode Engine::protocolReplaceMode(bool replaceExisting) const {
+    if (replaceExisting) {
+        return protocolv2::LoadReplaceMode::HardReset;
+    }
+    return hotSwapLoads_ ? protocolv2::LoadReplaceMode::HotSwap
+                         : protocolv2::LoadReplaceMode::CarryOverCompatible;
+}
+
 Result<void> Engine::start(std::optional<StateId> from) {
     auto result = runtime_.start(from);
     if (result.isOk()) {
@@ -614,9 +946,14 @@ Result<void> Engine::resume() {
 }
 
 Result<void> Engine::reset() {
+    const auto begin = std::chrono::steady_clock::now();
     auto result = runtime_.reset();
+    const auto end = std::chrono::steady_clock::now();
     if (result.isOk()) {
-        traceLifecycleEvent("runtime reset", "runtime", activeRunId_);
+        std::ostringstream summary;
+        summary << "runtime reset in " << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
+                << " us (script globals " << runtime_.lastScriptResetUs() << " us)";
+        traceLifecycleEvent(summary.str(), "runtime", activeRunId_);
     }
     return result;
 }
@@ -629,6 +966,10 @@ Result<void> Engine::setInput(VariableId id, Value value) {
     return runtime_.setInput(id, std::move(value));
 }
 
+Result<void> Engine::setInputs(const std::vector<VariableUpdate>& inputs) {
+    return runtime_.setInputs(inputs);
+}
+
 Result<void> Engine::setVariable(const std::string& name, Value value) {
     return runtime_.setVariable(name, std::move(value));
 }
@@ -645,6 +986,12 @@ EngineStatus Engine::status() const {
     s.tickCount = runtime_.context().tickCount;
     s.transitionCount = runtime_.context().transitionCount;
     s.errorCount = runtime_.context().errorCount;
+    s.scriptValuesSynced = runtime_.context().scriptValuesSynced;
+    s.transitionsEvaluated = runtime_.context().transitionsEvaluated;
+    s.messageAllocations = protocol::messageHeapAllocations();
+    s.scriptMemory = runtime_.scriptMemory();
+    s.tickRate = tickRate();
+    s.pacingDecision = pacer_.decision();
     if (runtime_.context().startTime > 0 && runtime_.context().lastTickTime >= runtime_.context().startTime) {
         s.uptime = runtime_.context().lastTickTime - runtime_.context().startTime;
     }
@@ -659,8 +1006,18 @@ void Engine::streamLogs(EventStreamCallback callback) {
     logHub_.stream(std::move(callback));
 }
 
+void Engine::streamLogs(EventStreamCallback callback, const StreamOptions& options) {
+    logHub_.stream(std::move(callback), options);
+}
+
 void Engine::setDeploymentDescriptor(DeploymentDescriptor descriptor) {
     deployment_ = std::move(descriptor);
+    pacer_.configure(deployment_.pacing, runtime_.maxTickRate());
+}
+
+void Engine::setIdOnlyWire(bool enabled) {
+    idOnlyWire_ = enabled;
+    telemetryDelta_.setIncludeNames(!enabled);
 }
 
 void Engine::setFaultProfile(FaultProfile profile) {
@@ -672,25 +1029,135 @@ void Engine::setFaultProfile(FaultProfile profile) {
 
 void Engine::setTraceOutputPath(std::optional<std::string> path) {
     traceOutputPath_ = std::move(path);
+    auto traceStream = openTraceStream();
+    if (traceStream.isError()) {
+        logHub_.log(LogLevel::Warn, "engine", traceStream.error(), activeRunId_);
+    }
+}
+
+Result<void> Engine::openTraceStream() {
+    traceStore_.closeStream();
+    if (!traceOutputPath_ || !LocalTraceStore::isBinaryTracePath(*traceOutputPath_)) {
+        return Result<void>::ok();
+    }
+    return traceStore_.streamBinary(*traceOutputPath_);
 }
 
 Result<void> Engine::writeTrace() const {
     if (!traceOutputPath_ || traceOutputPath_->empty()) {
         return Result<void>::ok();
     }
+    if (traceStore_.streaming()) {
+        return traceStore_.flushStream();
+    }
     return traceStore_.writeJsonLines(*traceOutputPath_);
 }
 
 void Engine::tick() {
+    const auto begin = std::chrono::steady_clock::now();
+    applyPendingHotSwap();
     runtime_.tick();
+    if (!telemetryAggregator_.empty()) {
+        flushTelemetryWindows();
+    }
+    if (retiredHotSwap_) {
+        // Old script engine and automata, outside the swap itself
+        if (retiredHotSwap_->prepared) {
+            runtime_.recycleScriptEngine(std::move(retiredHotSwap_->prepared->script));
+        }
+        retiredHotSwap_.reset();
+    }
     consumeBattery(deployment_.battery.drainPerTickPercent);
+    if (checkpointEveryTicks_ > 0 && runtime_.isRunning() &&
+        (runtime_.context().tickCount - lastCheckpointTick_ >= checkpointEveryTicks_ ||
+         checkpointRunId_ != activeRunId_)) {
+        (void)takeCheckpoint();
+    }
+    pace(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin).count()));
+}
+
+void Engine::pace(uint64_t tickCostUs) {
+    // Activity: a transition fired or a variable changed (inputs included) since the last tick
+    const ExecutionContext& context = runtime_.context();
+    const bool active = context.transitionCount != pacedTransitions_ ||
+                        context.variables.revision() != pacedRevision_;
+    pacedTransitions_ = context.transitionCount;
+    pacedRevision_ = context.variables.revision();
+    if (pacer_.observe(active, tickCostUs, batteryLow())) {
+        logHub_.log(LogLevel::Info, "pacing",
+                    "tick rate " + std::to_string(pacer_.rate()) + "/s (" +
+                    pacingDecisionName(pacer_.decision()) + ", tick cost " +
+                    std::to_string(pacer_.costUs()) + " us)",
+                    activeRunId_);
+    }
+}
+
+Result<void> Engine::takeCheckpoint() {
+    auto taken = runtime_.checkpoint();
+    if (taken.isError()) {
+        return Result<void>::error(taken.error());
+    }
+    if (checkpointRunId_ != activeRunId_) {
+        checkpoints_.clear();
+        checkpointRunId_ = activeRunId_;
+    }
+    RuntimeCheckpoint checkpoint = std::move(taken.value());
+    checkpoint.at = eventTimeMs();
+    lastCheckpointTick_ = checkpoint.tickCount;
+    checkpoints_.push(std::move(checkpoint));
+    return Result<void>::ok();
+}
+
+Result<Timestamp> Engine::seekToCheckpoint(Timestamp at) {
+    using R = Result<Timestamp>;
+    const RuntimeCheckpoint* nearest = checkpointRunId_ == activeRunId_ ? checkpoints_.nearest(at) : nullptr;
+    if (!nearest) {
+        return R::error("No checkpoint at or before " + std::to_string(at));
+    }
+    auto restored = runtime_.restoreCheckpoint(*nearest);
+    if (restored.isError()) {
+        return R::error(restored.error());
+    }
+    const Timestamp takenAt = nearest->at;
+    lastCheckpointTick_ = nearest->tickCount;
+    checkpoints_.dropAfter(takenAt);
+    traceLifecycleEvent("checkpoint restored", "runtime", activeRunId_);
+    return R::ok(takenAt);
+}
+
+size_t Engine::pollPeerLinks(size_t max) {
+    bool applied = false;
+    const size_t count = peerLinks_.drain([&](std::unique_ptr<protocol::Message> message) {
+        Result<void> result = Result<void>::ok();
+        if (message->type() == protocol::MessageType::Input) {
+            const auto& input = static_cast<const protocol::InputMessage&>(*message);
+            result = input.variableName.empty() ? setInput(input.variableId, input.value)
+                                                : setInput(input.variableName, input.value);
+        } else if (message->type() == protocol::MessageType::InputBatch) {
+            result = setInputs(static_cast<const protocol::InputBatchMessage&>(*message).inputs);
+        } else {
+            return;  // Peers only drive inputs
+        }
+        if (result.isError()) {
+            logHub_.log(LogLevel::Warn, "peer",
+                        "input from peer " + std::to_string(message->sourceId) + " rejected: " + result.error());
+            return;
+        }
+        applied = true;
+    }, max);
+    // One evaluation for everything the peers sent, as for an InputBatch
+    if (applied && isRunning()) {
+        tick();
+    }
+    return count;
 }
 
 void Engine::enqueueCommand(std::unique_ptr<protocol::Message> message) {
     if (!message) {
         return;
     }
-    const Timestamp receivedAt = wallClockMs();
+    const Timestamp receivedAt = eventTimeMs();
     traceMessageEvent(*message,
                       "ingress_command",
                       "ingress",
@@ -713,7 +1180,11 @@ void Engine::enqueueCommand(std::unique_ptr<protocol::Message> message) {
         return;
     }
 
-    const auto serialized = message->serialize();
+    // Only fault-injected duplicates need a serialized copy.
+    std::vector<uint8_t> serialized;
+    if (decision.copies > 1) {
+        serialized = message->serialize();
+    }
     for (uint32_t i = 0; i < decision.copies; ++i) {
         std::unique_ptr<protocol::Message> staged;
         if (i == 0) {
@@ -726,48 +1197,48 @@ void Engine::enqueueCommand(std::unique_ptr<protocol::Message> message) {
             continue;
         }
 
-        ingressQueue_.push_back(
-            ScheduledIngressMessage{
-                decision.releaseTimestamp,
-                std::move(staged),
-                receivedAt,
-                decision.actions
-            });
+        ScheduledIngressMessage scheduled{
+            decision.releaseTimestamp,
+            std::move(staged),
+            receivedAt,
+            decision.actions,
+            ingressSequence_++
+        };
+        if (scheduled.releaseAt > receivedAt) {
+            delayedIngress_.push_back(std::move(scheduled));
+            std::push_heap(delayedIngress_.begin(), delayedIngress_.end(), releasesLater);
+        } else {
+            ingressLanes_[static_cast<size_t>(commandLaneOf(scheduled.message->type()))].push_back(std::move(scheduled));
+        }
     }
 }
 
 Engine::Replies Engine::processCommandQueue() {
     Replies replies;
 
-    const Timestamp now = wallClockMs();
-    auto ingressIt = ingressQueue_.begin();
-    while (ingressIt != ingressQueue_.end()) {
-        if (ingressIt->releaseAt > now || !ingressIt->message) {
-            ++ingressIt;
-            continue;
-        }
+    // Fault-delayed commands join their lane once due, in release order
+    const Timestamp now = eventTimeMs();
+    while (!delayedIngress_.empty() && delayedIngress_.front().releaseAt <= now) {
+        std::pop_heap(delayedIngress_.begin(), delayedIngress_.end(), releasesLater);
+        auto& due = delayedIngress_.back();
+        ingressLanes_[static_cast<size_t>(commandLaneOf(due.message->type()))].push_back(std::move(due));
+        delayedIngress_.pop_back();
+    }
 
-        auto msg = std::move(ingressIt->message);
-        const Timestamp handledAt = wallClockMs();
-        traceMessageEvent(*msg,
-                          "ingress_command",
-                          "ingress",
-                          "command handled",
-                          ingressIt->receiveTimestamp,
-                          handledAt,
-                          std::nullopt,
-                          ingressIt->faultActions);
-        auto routed = dispatch(*msg);
-        for (auto& reply : routed) {
-            if (reply) {
-                stageOutbound(std::move(reply), ingressIt->receiveTimestamp, handledAt);
-            }
+    // Take each lane's share first; handlers then share one reply buffer
+    for (size_t lane = 0; lane < COMMAND_LANE_COUNT; ++lane) {
+        auto& queue = ingressLanes_[lane];
+        const size_t budget = laneBudgets_[lane];
+        const size_t take = budget == 0 ? queue.size() : std::min(budget, queue.size());
+        for (size_t i = 0; i < take; ++i) {
+            ingressBatch_.push_back(std::move(queue.front()));
+            queue.pop_front();
         }
-
-        ingressIt = ingressQueue_.erase(ingressIt);
     }
+    dispatchBatch(ingressBatch_);
+    runtime_.publishOutputs();  // Writes made by commands outside a tick
 
-    while (!eventQueue_.empty()) {
+    while (!eventBackpressure_ && !eventQueue_.empty()) {
         auto evt = std::move(eventQueue_.front());
         eventQueue_.pop_front();
         if (evt) {
@@ -779,15 +1250,170 @@ Engine::Replies Engine::processCommandQueue() {
     return replies;
 }
 
+std::optional<Timestamp> Engine::nextReleaseAt() const {
+    std::optional<Timestamp> next;
+    auto consider = [&next](Timestamp at) {
+        if (!next || at < *next) {
+            next = at;
+        }
+    };
+    for (const auto& lane : ingressLanes_) {
+        if (!lane.empty()) {
+            consider(eventTimeMs());
+            break;
+        }
+    }
+    if (!delayedIngress_.empty()) {
+        consider(delayedIngress_.front().releaseAt);
+    }
+    for (const auto& scheduled : delayedOutboundQueue_) {
+        consider(scheduled.releaseAt);
+    }
+    return next;
+}
+
+void Engine::queueOutputs(const std::vector<const Variable*>& outputs, Timestamp eventAt) {
+    const RunId runId = activeRunId_;
+    auto superseded = [&outputs](VariableId id) {
+        return std::any_of(outputs.begin(), outputs.end(), [id](const Variable* var) { return var->id() == id; });
+    };
+
+    // One pass over the queue drops the pending values these replace
+    for (auto it = eventQueue_.begin(); it != eventQueue_.end();) {
+        auto* pending = it->get();
+        if (pending && pending->type() == protocol::MessageType::Output) {
+            const auto* output = static_cast<const protocol::OutputMessage*>(pending);
+            if (output->runId == runId && superseded(output->variableId)) {
+                it = eventQueue_.erase(it);
+                continue;
+            }
+        } else if (pending && pending->type() == protocol::MessageType::OutputBatch) {
+            auto* batch = static_cast<protocol::OutputBatchMessage*>(pending);
+            if (batch->runId == runId) {
+                auto& entries = batch->outputs;
+                entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                             [&](const VariableUpdate& entry) { return superseded(entry.id); }),
+                              entries.end());
+                if (entries.empty()) {
+                    it = eventQueue_.erase(it);
+                    continue;
+                }
+            }
+        }
+        ++it;
+    }
+
+    if (outputBatching_) {
+        auto batch = std::make_unique<protocol::OutputBatchMessage>();
+        batch->runId = runId;
+        batch->timestamp = eventAt;
+        batch->outputs.reserve(outputs.size());
+        for (const Variable* var : outputs) {
+            batch->outputs.push_back(VariableUpdate{var->id(), var->value()});
+        }
+        queueEvent(std::move(batch));
+        return;
+    }
+    for (const Variable* var : outputs) {
+        auto msg = std::make_unique<protocol::OutputMessage>();
+        msg->runId = runId;
+        msg->variableId = var->id();
+        if (!idOnlyWire_) {
+            msg->variableName = var->name();
+        }
+        msg->value = var->value();
+        msg->timestamp = eventAt;
+        queueEvent(std::move(msg));
+    }
+}
+
+void Engine::flushTelemetryWindows() {
+    const Timestamp now = eventTimeMs();
+    releasedOutputs_.clear();
+    closedWindows_.clear();
+    telemetryAggregator_.poll(now, releasedOutputs_, closedWindows_);
+
+    if (!releasedOutputs_.empty()) {
+        serverOutputs_.clear();
+        for (VariableId id : releasedOutputs_) {
+            if (const Variable* var = runtime_.context().variables.get(id)) {
+                serverOutputs_.push_back(var);
+            }
+        }
+        queueOutputs(serverOutputs_, now);
+    }
+    for (auto& window : closedWindows_) {
+        auto msg = std::make_unique<protocol::OutputAggregateMessage>(std::move(window));
+        msg->runId = activeRunId_;
+        if (idOnlyWire_) {
+            msg->variableName.clear();
+        }
+        queueEvent(std::move(msg));
+    }
+}
+
+void Engine::queueEvent(std::unique_ptr<protocol::Message> event) {
+    eventQueue_.push_back(std::move(event));
+    while (eventQueueLimit_ > 0 && eventQueue_.size() > eventQueueLimit_) {
+        // Symbol tables are never dropped: later id-only events need them
+        auto victim = std::find_if(eventQueue_.begin(), eventQueue_.end(), [](const auto& evt) {
+            return evt && evt->type() == protocol::MessageType::TransitionFired;
+        });
+        if (victim == eventQueue_.end()) {
+            victim = std::find_if(eventQueue_.begin(), eventQueue_.end(), [](const auto& evt) {
+                return !evt || evt->type() != protocol::MessageType::SymbolTable;
+            });
+        }
+        if (victim == eventQueue_.end()) {
+            return;
+        }
+        eventQueue_.erase(victim);
+        ++droppedEvents_;
+    }
+}
+
 Engine::Replies Engine::dispatch(const protocol::Message& message) {
-    return commandBus_.route(*this, message);
+    Replies replies;
+    dispatch(message, replies);
+    return replies;
+}
+
+void Engine::dispatch(const protocol::Message& message, Replies& out) {
+    const uint64_t start = ProfileClock::now();
+    commandBus_.route(*this, message, out);
+    dispatchLatency_.record(ProfileClock::now() - start);
+}
+
+void Engine::dispatchBatch(std::vector<ScheduledIngressMessage>& batch) {
+    for (auto& scheduled : batch) {
+        const Timestamp handledAt = eventTimeMs();
+        traceMessageEvent(*scheduled.message,
+                          "ingress_command",
+                          "ingress",
+                          "command handled",
+                          scheduled.receiveTimestamp,
+                          handledAt,
+                          std::nullopt,
+                          scheduled.faultActions);
+        dispatch(*scheduled.message, replyScratch_);
+        for (auto& reply : replyScratch_) {
+            if (reply) {
+                stageOutbound(std::move(reply), scheduled.receiveTimestamp, handledAt);
+            }
+        }
+        replyScratch_.clear();
+    }
+    batch.clear();
 }
 
 void Engine::configureRuntimeCallbacks() {
     RuntimeCallbacks callbacks;
 
     callbacks.onStateChange = [this](StateId from, StateId to, TransitionId via) {
-        const Timestamp eventAt = wallClockMs();
+        const Timestamp eventAt = eventTimeMs();
+        if (stateObserver_) {
+            stateObserver_(from, to, via, eventAt);
+        }
         logHub_.stateChange(from, to, via, activeRunId_);
         std::optional<std::string> observableState;
         if (loadedAutomata_) {
@@ -814,59 +1440,56 @@ void Engine::configureRuntimeCallbacks() {
         msg.newState = to;
         msg.firedTransition = via;
         msg.timestamp = eventAt;
-        eventQueue_.push_back(std::make_unique<protocol::StateChangeMessage>(msg));
+        queueEvent(std::make_unique<protocol::StateChangeMessage>(msg));
 
         protocol::TransitionFiredMessage tf;
         tf.runId = activeRunId_;
         tf.transitionId = via;
         tf.timestamp = eventAt;
-        eventQueue_.push_back(std::make_unique<protocol::TransitionFiredMessage>(tf));
+        queueEvent(std::make_unique<protocol::TransitionFiredMessage>(tf));
     };
 
-    callbacks.onOutputChange = [this](const Variable& var) {
-        const Timestamp eventAt = wallClockMs();
-        logHub_.outputChange(var.name(), var.value(), activeRunId_);
-        std::optional<std::string> portName;
-        std::optional<std::string> portDirection;
-        if (loadedAutomata_) {
-            if (const auto* port = loadedAutomata_->getBlackBoxPort(var.name())) {
-                portName = port->name;
-                portDirection = directionName(port->direction);
-            }
-        }
-        traceRuntimeEvent("runtime_output_change",
-                          "output",
-                          "output changed: " + var.name(),
-                          activeRunId_,
-                          eventAt,
-                          std::nullopt,
-                          {},
-                          portName,
-                          portDirection);
-
-        protocol::OutputMessage msg;
-        msg.runId = activeRunId_;
-        msg.variableId = var.id();
-        msg.variableName = var.name();
-        msg.value = var.value();
-        msg.timestamp = eventAt;
-
-        for (auto it = eventQueue_.begin(); it != eventQueue_.end();) {
-            if (*it && (*it)->type() == protocol::MessageType::Output) {
-                const auto* pending = static_cast<const protocol::OutputMessage*>(it->get());
-                if (pending->runId == msg.runId && pending->variableId == msg.variableId) {
-                    it = eventQueue_.erase(it);
-                    continue;
+    callbacks.onOutputBatch = [this](const std::vector<const Variable*>& outputs) {
+        const Timestamp eventAt = eventTimeMs();
+        for (const Variable* var : outputs) {
+            logHub_.outputChange(var->name(), var->value(), activeRunId_);
+            std::optional<std::string> portName;
+            std::optional<std::string> portDirection;
+            if (loadedAutomata_) {
+                if (const auto* port = loadedAutomata_->getBlackBoxPort(var->name())) {
+                    portName = port->name;
+                    portDirection = directionName(port->direction);
                 }
             }
-            ++it;
+            traceRuntimeEvent("runtime_output_change",
+                              "output",
+                              "output changed: " + var->name(),
+                              activeRunId_,
+                              eventAt,
+                              std::nullopt,
+                              {},
+                              portName,
+                              portDirection);
+        }
+        if (peerLinks_.empty() && telemetryAggregator_.empty()) {
+            queueOutputs(outputs, eventAt);
+            return;
+        }
+        // Wired outputs went to their peers and shaped ones to their
+        // telemetry windows; the server gets the rest
+        serverOutputs_.clear();
+        for (const Variable* var : outputs) {
+            if (peerLinks_.forward(*var) && telemetryAggregator_.offer(*var, eventAt)) {
+                serverOutputs_.push_back(var);
+            }
+        }
+        if (!serverOutputs_.empty()) {
+            queueOutputs(serverOutputs_, eventAt);
         }
-
-        eventQueue_.push_back(std::make_unique<protocol::OutputMessage>(msg));
     };
 
     callbacks.onError = [this](const std::string& error) {
-        const Timestamp eventAt = wallClockMs();
+        const Timestamp eventAt = eventTimeMs();
         logHub_.event(EventKind::Error, LogLevel::Error, "runtime", error, activeRunId_);
         traceRuntimeEvent("runtime_error", "runtime", error, activeRunId_, eventAt, std::nullopt);
 
@@ -874,11 +1497,11 @@ void Engine::configureRuntimeCallbacks() {
         msg.code = protocol::ErrorCode::Unknown;
         msg.message = error;
         msg.runId = activeRunId_;
-        eventQueue_.push_back(std::make_unique<protocol::ErrorMessage>(msg));
+        queueEvent(std::make_unique<protocol::ErrorMessage>(msg));
     };
 
     callbacks.onDebug = [this](const std::string& debug) {
-        const Timestamp eventAt = wallClockMs();
+        const Timestamp eventAt = eventTimeMs();
         logHub_.log(LogLevel::Debug, "runtime", debug, activeRunId_);
         traceRuntimeEvent("runtime_debug", "runtime", debug, activeRunId_, eventAt, std::nullopt);
         // streamLogs (registered in main.cpp) sends DebugMessages from logHub_ immediately;
@@ -891,7 +1514,7 @@ void Engine::configureRuntimeCallbacks() {
 void Engine::traceLifecycleEvent(const std::string& summary,
                                  const std::string& category,
                                  std::optional<RunId> runId) {
-    traceRuntimeEvent("lifecycle", category, summary, runId, wallClockMs(), std::nullopt);
+    traceRuntimeEvent("lifecycle", category, summary, runId, eventTimeMs(), std::nullopt);
 }
 
 void Engine::traceRuntimeEvent(const std::string& kind,
@@ -904,6 +1527,9 @@ void Engine::traceRuntimeEvent(const std::string& kind,
                                std::optional<std::string> portName,
                                std::optional<std::string> portDirection,
                                std::optional<std::string> observableState) {
+    if (!traceEnabled_) {
+        return;
+    }
     TraceRecord record;
     record.kind = kind;
     record.boundary = "runtime";
@@ -922,9 +1548,17 @@ void Engine::traceRuntimeEvent(const std::string& kind,
     record.observableState = std::move(observableState);
     record.faultActions = std::move(faultActions);
     applyDeploymentMetrics(record);
+    if (traceObserver_) {
+        traceObserver_(record);
+    }
     traceStore_.push(std::move(record));
 }
 
+void Engine::setSeed(uint64_t runtimeSeed, uint64_t faultSeed) {
+    runtime_.setSeed(runtimeSeed);
+    faultRandom_.seed(faultSeed);
+}
+
 void Engine::traceMessageEvent(const protocol::Message& message,
                                const std::string& kind,
                                const std::string& boundary,
@@ -933,6 +1567,9 @@ void Engine::traceMessageEvent(const protocol::Message& message,
                                std::optional<Timestamp> handleTimestamp,
                                std::optional<Timestamp> sendTimestamp,
                                std::vector<std::string> faultActions) {
+    if (!traceEnabled_) {
+        return;
+    }
     TraceRecord record;
     record.kind = kind;
     record.boundary = boundary;
@@ -957,9 +1594,10 @@ void Engine::traceMessageEvent(const protocol::Message& message,
         switch (message.type()) {
             case protocol::MessageType::Input: {
                 const auto& input = static_cast<const protocol::InputMessage&>(message);
-                const std::string& variableName = input.variableName;
-                if (!variableName.empty()) {
-                    if (const auto* port = loadedAutomata_->getBlackBoxPort(variableName)) {
+                const std::string* variableName =
+                    input.variableName.empty() ? variableNameById(input.variableId) : &input.variableName;
+                if (variableName) {
+                    if (const auto* port = loadedAutomata_->getBlackBoxPort(*variableName)) {
                         record.portName = port->name;
                         record.portDirection = directionName(port->direction);
                     }
@@ -969,12 +1607,21 @@ void Engine::traceMessageEvent(const protocol::Message& message,
             case protocol::MessageType::Output:
             case protocol::MessageType::Variable: {
                 const std::string* variableName = nullptr;
+                VariableId variableId = INVALID_VARIABLE;
                 if (message.type() == protocol::MessageType::Output) {
-                    variableName = &static_cast<const protocol::OutputMessage&>(message).variableName;
+                    const auto& output = static_cast<const protocol::OutputMessage&>(message);
+                    variableName = &output.variableName;
+                    variableId = output.variableId;
                 } else {
-                    variableName = &static_cast<const protocol::VariableMessage&>(message).variableName;
+                    const auto& variable = static_cast<const protocol::VariableMessage&>(message);
+                    variableName = &variable.variableName;
+                    variableId = variable.variableId;
+                }
+                if (variableName->empty()) {
+                    // Id-only wire: names are resolved here, at the trace edge.
+                    variableName = variableNameById(variableId);
                 }
-                if (variableName && !variableName->empty()) {
+                if (variableName) {
                     if (const auto* port = loadedAutomata_->getBlackBoxPort(*variableName)) {
                         record.portName = port->name;
                         record.portDirection = directionName(port->direction);
@@ -1005,6 +1652,9 @@ void Engine::traceMessageEvent(const protocol::Message& message,
         observedLatencyMs = static_cast<uint32_t>(*sendTimestamp - *receiveTimestamp);
     }
     applyDeploymentMetrics(record, observedLatencyMs);
+    if (traceObserver_) {
+        traceObserver_(record);
+    }
     traceStore_.push(std::move(record));
 }
 
@@ -1012,7 +1662,7 @@ void Engine::applyDeploymentMetrics(TraceRecord& record,
                                     std::optional<uint32_t> observedLatencyMs) const {
     if (deployment_.battery.present) {
         record.batteryPercent = std::clamp(batteryPercent_, 0.0, 100.0);
-        record.batteryLow = batteryPercent_ <= deployment_.battery.lowThresholdPercent;
+        record.batteryLow = batteryLow();
     }
     if (deployment_.latency.budgetMs > 0) {
         record.latencyBudgetMs = deployment_.latency.budgetMs;
@@ -1035,6 +1685,10 @@ void Engine::consumeBattery(double percent) {
     batteryPercent_ = std::max(0.0, batteryPercent_ - percent);
 }
 
+bool Engine::batteryLow() const {
+    return deployment_.battery.present && batteryPercent_ <= deployment_.battery.lowThresholdPercent;
+}
+
 FaultDecision Engine::decideFaultDelivery(bool forIngress, Timestamp now) {
     FaultDecision decision;
     decision.releaseTimestamp = now;
@@ -1043,12 +1697,14 @@ FaultDecision Engine::decideFaultDelivery(bool forIngress, Timestamp now) {
     if (!faultProfile_.hasActiveEffects() || !enabled) {
         return decision;
     }
+    ++faultStats_.decisions;
 
     if (faultProfile_.disconnectPeriodMs > 0 &&
         faultProfile_.disconnectDurationMs > 0 &&
         (now % faultProfile_.disconnectPeriodMs) < faultProfile_.disconnectDurationMs) {
         decision.dropped = true;
         decision.actions.push_back("disconnect_window");
+        ++faultStats_.disconnected;
         return decision;
     }
 
@@ -1067,24 +1723,28 @@ FaultDecision Engine::decideFaultDelivery(bool forIngress, Timestamp now) {
         decision.releaseTimestamp = now + decision.appliedDelayMs;
         if (decision.appliedDelayMs > 0) {
             decision.actions.push_back("delay");
+            ++faultStats_.delayed;
         }
     }
 
     if (faultProfile_.successProbability < 1.0 && dist(faultRandom_) > faultProfile_.successProbability) {
         decision.dropped = true;
         decision.actions.push_back("degraded_success");
+        ++faultStats_.degraded;
         return decision;
     }
 
     if (faultProfile_.dropProbability > 0.0 && dist(faultRandom_) < faultProfile_.dropProbability) {
         decision.dropped = true;
         decision.actions.push_back("drop");
+        ++faultStats_.dropped;
         return decision;
     }
 
     if (faultProfile_.duplicateProbability > 0.0 && dist(faultRandom_) < faultProfile_.duplicateProbability) {
         decision.copies = 2;
         decision.actions.push_back("duplicate");
+        ++faultStats_.duplicated;
     }
 
     return decision;
@@ -1097,7 +1757,7 @@ void Engine::stageOutbound(std::unique_ptr<protocol::Message> message,
         return;
     }
 
-    const Timestamp now = wallClockMs();
+    const Timestamp now = eventTimeMs();
     auto decision = decideFaultDelivery(false, now);
 
     traceMessageEvent(*message,
@@ -1113,7 +1773,11 @@ void Engine::stageOutbound(std::unique_ptr<protocol::Message> message,
         return;
     }
 
-    const auto serialized = message->serialize();
+    // Only fault-injected duplicates need a serialized copy.
+    std::vector<uint8_t> serialized;
+    if (decision.copies > 1) {
+        serialized = message->serialize();
+    }
     for (uint32_t i = 0; i < decision.copies; ++i) {
         std::unique_ptr<protocol::Message> outbound;
         if (i == 0) {
@@ -1140,7 +1804,7 @@ void Engine::stageOutbound(std::unique_ptr<protocol::Message> message,
 }
 
 void Engine::releaseReadyOutbound(Replies& replies) {
-    const Timestamp now = wallClockMs();
+    const Timestamp now = eventTimeMs();
     auto it = delayedOutboundQueue_.begin();
     while (it != delayedOutboundQueue_.end()) {
         if (it->releaseAt > now || !it->message) {
@@ -1174,33 +1838,28 @@ void Engine::releaseReadyOutbound(Replies& replies) {
     }
 }
 
-Engine::Replies Engine::ackWithStatus(const protocol::Message& request, const std::string& info) {
-    Replies replies;
-
-    protocol::AckMessage ack;
-    ack.targetId = request.sourceId;
-    ack.relatedMessageId = request.messageId;
-    ack.info = info;
-    replies.push_back(std::make_unique<protocol::AckMessage>(ack));
+void Engine::ackWithStatus(Replies& out, const protocol::Message& request, const std::string& info) {
+    auto ack = std::make_unique<protocol::AckMessage>();
+    ack->targetId = request.sourceId;
+    ack->relatedMessageId = request.messageId;
+    ack->info = info;
+    out.push_back(std::move(ack));
 
-    replies.push_back(buildStatusMessage(request.sourceId));
-    return replies;
+    out.push_back(buildStatusMessage(request.sourceId));
 }
 
-Engine::Replies Engine::nakWithStatus(const protocol::Message& request,
-                                      uint16_t reasonCode,
-                                      const std::string& reason) {
-    Replies replies;
-
-    protocol::NakMessage nak;
-    nak.targetId = request.sourceId;
-    nak.relatedMessageId = request.messageId;
-    nak.reasonCode = reasonCode;
-    nak.reason = reason;
-    replies.push_back(std::make_unique<protocol::NakMessage>(nak));
-
-    replies.push_back(buildStatusMessage(request.sourceId));
-    return replies;
+void Engine::nakWithStatus(Replies& out,
+                           const protocol::Message& request,
+                           uint16_t reasonCode,
+                           const std::string& reason) {
+    auto nak = std::make_unique<protocol::NakMessage>();
+    nak->targetId = request.sourceId;
+    nak->relatedMessageId = request.messageId;
+    nak->reasonCode = reasonCode;
+    nak->reason = reason;
+    out.push_back(std::move(nak));
+
+    out.push_back(buildStatusMessage(request.sourceId));
 }
 
 std::unique_ptr<protocol::StatusMessage> Engine::buildStatusMessage(DeviceId target) const {
@@ -1222,16 +1881,152 @@ std::unique_ptr<protocol::TelemetryMessage> Engine::buildTelemetryMessage(Device
     auto telemetry = std::make_unique<protocol::TelemetryMessage>();
     telemetry->targetId = target;
     telemetry->runId = activeRunId_;
-    telemetry->timestamp = wallClockMs();
-    telemetry->heapFree = 0;
-    telemetry->heapTotal = 0;
-    telemetry->cpuUsage = 0.0f;
-    telemetry->tickRate = 0;
-    telemetry->namedVariableSnapshot = collectNamedVariableSnapshot();
+    telemetry->timestamp = eventTimeMs();
+    // The script heap: its budget, or what the allocator reserved if unlimited
+    const ScriptMemoryStats memory = runtime_.scriptMemory();
+    const size_t heapTotal = memory.budget > 0 ? memory.budget : std::max(memory.reserved, memory.inUse);
+    telemetry->heapTotal = static_cast<uint32_t>(std::min<size_t>(heapTotal, UINT32_MAX));
+    telemetry->heapFree = static_cast<uint32_t>(std::min<size_t>(heapTotal - std::min(heapTotal, memory.inUse), UINT32_MAX));
+    telemetry->cpuUsage = std::min(pacer_.loadPercent(), 100.0f);  // Share of time spent ticking
+    telemetry->tickRate = tickRate();
+    telemetry->scriptValuesSynced = runtime_.context().scriptValuesSynced;
+    if (idOnlyWire_) {
+        if (runtime_.isLoaded()) {
+            runtime_.context().variables.forEach([&telemetry](const Variable& var) {
+                telemetry->variableSnapshot.emplace_back(var.id(), var.value());
+            });
+        }
+    } else {
+        telemetry->namedVariableSnapshot = collectNamedVariableSnapshot();
+    }
     telemetry->deployment = collectDeploymentMetadataExtension();
     return telemetry;
 }
 
+std::unique_ptr<protocol::TelemetryDeltaMessage> Engine::buildTelemetryDelta(DeviceId target) {
+    if (!runtime_.isLoaded()) {
+        return nullptr;
+    }
+    auto delta = std::make_unique<protocol::TelemetryDeltaMessage>();
+    if (!telemetryDelta_.build(runtime_.context().variables, *delta)) {
+        return nullptr;
+    }
+    delta->targetId = target;
+    delta->runId = activeRunId_;
+    delta->timestamp = eventTimeMs();
+    return delta;
+}
+
+std::unique_ptr<protocol::SymbolTableMessage> Engine::buildSymbolTable(DeviceId target) const {
+    if (!loadedAutomata_ || !runtime_.isLoaded()) {
+        return nullptr;
+    }
+    auto table = std::make_unique<protocol::SymbolTableMessage>();
+    table->targetId = target;
+    table->runId = activeRunId_;
+    table->variables.reserve(loadedAutomata_->variables.size());
+    for (const auto& variable : loadedAutomata_->variables) {
+        table->variables.push_back(protocol::SymbolEntry{variable.id, variable.name});
+    }
+    table->states.reserve(loadedAutomata_->states.size());
+    for (const auto& [id, state] : loadedAutomata_->states) {
+        table->states.push_back(protocol::SymbolEntry{id, state.name});
+    }
+    auto byId = [](const protocol::SymbolEntry& a, const protocol::SymbolEntry& b) { return a.id < b.id; };
+    std::sort(table->variables.begin(), table->variables.end(), byId);
+    std::sort(table->states.begin(), table->states.end(), byId);
+    return table;
+}
+
+std::unique_ptr<protocol::ProfileMessage> Engine::buildProfileMessage(DeviceId target,
+                                                                     CodeCostOrder order) const {
+    auto profile = std::make_unique<protocol::ProfileMessage>();
+    profile->targetId = target;
+    profile->runId = activeRunId_;
+    profile->order = static_cast<uint8_t>(order);
+    profile->timestamp = eventTimeMs();
+    if (!ProfileClock::enabled) {
+        return profile;
+    }
+
+    const RuntimeProfile& runtimeProfile = runtime_.profile();
+    profile->phases.reserve(TICK_PHASE_COUNT);
+    for (size_t i = 0; i < TICK_PHASE_COUNT; ++i) {
+        const PhaseCounter counter = runtimeProfile.phase(static_cast<TickPhase>(i));
+        profile->phases.push_back(protocol::ProfilePhaseEntry{static_cast<uint8_t>(i), counter.totalNs, counter.calls});
+    }
+
+    auto addHistogram = [&profile](ProfileHistogramKind kind, const LatencyHistogram& histogram) {
+        protocol::ProfileHistogramEntry entry;
+        entry.kind = static_cast<uint8_t>(kind);
+        entry.count = histogram.count();
+        entry.sumNs = histogram.sum();
+        entry.minNs = histogram.min();
+        entry.maxNs = histogram.max();
+        for (size_t bucket = 0; bucket < LatencyHistogram::BUCKETS; ++bucket) {
+            if (const uint32_t count = histogram.bucketCount(bucket)) {
+                entry.buckets.push_back(protocol::ProfileBucket{static_cast<uint16_t>(bucket), count});
+            }
+        }
+        profile->histograms.push_back(std::move(entry));
+    };
+    addHistogram(ProfileHistogramKind::Tick, runtimeProfile.tick);
+    addHistogram(ProfileHistogramKind::Guard, runtimeProfile.guard);
+    addHistogram(ProfileHistogramKind::Dispatch, dispatchLatency_);
+
+    auto blocks = runtimeProfile.scripts.entries();
+    sortCodeCosts(blocks, order);
+    if (blocks.size() > protocol::PROFILE_MAX_CODE_BLOCKS) {
+        blocks.resize(protocol::PROFILE_MAX_CODE_BLOCKS);
+    }
+    profile->codeBlocks.reserve(blocks.size());
+    for (const auto& block : blocks) {
+        profile->codeBlocks.push_back(protocol::ProfileCodeBlockEntry{
+            static_cast<uint8_t>(block.site), block.ownerId, block.cost.totalNs, block.cost.calls,
+            block.cost.allocatedBytes});
+    }
+    return profile;
+}
+
+std::vector<ScriptCostRow> Engine::scriptCosts(CodeCostOrder order) const {
+    auto entries = runtime_.profile().scripts.entries();
+    sortCodeCosts(entries, order);
+
+    const Automata* automata = runtime_.context().automata;
+    std::vector<ScriptCostRow> rows;
+    rows.reserve(entries.size());
+    for (const auto& entry : entries) {
+        ScriptCostRow row{entry, {}};
+        if (automata) {
+            if (isStateSite(entry.site)) {
+                if (const State* state = automata->getState(entry.ownerId)) {
+                    row.owner = state->name;
+                }
+            } else if (const Transition* transition = automata->getTransition(entry.ownerId)) {
+                row.owner = transition->name;
+            }
+        }
+        if (row.owner.empty()) {
+            row.owner = "#" + std::to_string(entry.ownerId);
+        }
+        rows.push_back(std::move(row));
+    }
+    return rows;
+}
+
+void Engine::resetProfile() {
+    runtime_.resetProfile();
+    dispatchLatency_.reset();
+}
+
+const std::string* Engine::variableNameById(VariableId id) const {
+    if (!runtime_.isLoaded()) {
+        return nullptr;
+    }
+    const Variable* variable = runtime_.context().variables.get(id);
+    return variable ? &variable->name() : nullptr;
+}
+
 std::vector<protocol::NamedValueSnapshotEntry> Engine::collectNamedVariableSnapshot() const {
     std::vector<protocol::NamedValueSnapshotEntry> snapshot;
     if (!loadedAutomata_ || !runtime_.isLoaded()) {
@@ -1240,7 +2035,7 @@ std::vector<protocol::NamedValueSnapshotEntry> Engine::collectNamedVariableSnaps
 
     snapshot.reserve(loadedAutomata_->variables.size());
     for (const auto& variable : loadedAutomata_->variables) {
-        if (const auto value = runtime_.context().variables.getValue(variable.name)) {
+        if (const auto value = runtime_.context().variables.getValue(variable.id)) {
             snapshot.push_back(protocol::NamedValueSnapshotEntry{variable.name, *value});
         }
     }
@@ -1255,8 +2050,7 @@ protocol::DeploymentMetadataExtension Engine::collectDeploymentMetadataExtension
     deployment.controlPlaneInstance = deployment_.controlPlaneInstance;
     deployment.targetClass = deployment_.targetClass;
     deployment.batteryPresent = deployment_.battery.present;
-    deployment.batteryLow =
-        deployment_.battery.present && batteryPercent_ <= deployment_.battery.lowThresholdPercent;
+    deployment.batteryLow = batteryLow();
     deployment.batteryExternalPower = deployment_.battery.externalPower;
     deployment.batteryPercent = batteryPercent_;
     deployment.latencyBudgetMs = deployment_.latency.budgetMs;
@@ -1269,7 +2063,7 @@ protocol::DeploymentMetadataExtension Engine::collectDeploymentMetadataExtension
     deployment.handleTimestamp = lastHandleTimestamp_;
     deployment.traceFile = traceOutputPath_.value_or("");
     deployment.faultProfile = faultProfile_.name;
-    deployment.traceEventCount = static_cast<uint32_t>(traceStore_.records().size());
+    deployment.traceEventCount = static_cast<uint32_t>(traceStore_.totalRecorded());
     return deployment;
 }
 
@@ -1301,8 +2095,20 @@ std::optional<RunId> Engine::extractRunId(const protocol::Message& message) {
             return static_cast<const protocol::ResumeMessage&>(message).runId;
         case protocol::MessageType::Input:
             return static_cast<const protocol::InputMessage&>(message).runId;
+        case protocol::MessageType::InputBatch:
+            return static_cast<const protocol::InputBatchMessage&>(message).runId;
+        case protocol::MessageType::TelemetryDelta:
+            return static_cast<const protocol::TelemetryDeltaMessage&>(message).runId;
+        case protocol::MessageType::TelemetryAck:
+            return static_cast<const protocol::TelemetryAckMessage&>(message).runId;
+        case protocol::MessageType::Profile:
+            return static_cast<const protocol::ProfileMessage&>(message).runId;
         case protocol::MessageType::Output:
             return static_cast<const protocol::OutputMessage&>(message).runId;
+        case protocol::MessageType::OutputBatch:
+            return static_cast<const protocol::OutputBatchMessage&>(message).runId;
+        case protocol::MessageType::OutputAggregate:
+            return static_cast<const protocol::OutputAggregateMessage&>(message).runId;
         case protocol::MessageType::Variable:
             return static_cast<const protocol::VariableMessage&>(message).runId;
         case protocol::MessageType::StateChange:
@@ -1313,73 +2119,72 @@ std::optional<RunId> Engine::extractRunId(const protocol::Message& message) {
             return static_cast<const protocol::TransitionFiredMessage&>(message).runId;
         case protocol::MessageType::RestoreState:
             return static_cast<const protocol::RestoreStateMessage&>(message).runId;
+        case protocol::MessageType::SymbolTable:
+            return static_cast<const protocol::SymbolTableMessage&>(message).runId;
+        case protocol::MessageType::PeerWiring:
+            return static_cast<const protocol::PeerWiringMessage&>(message).runId;
         default:
             return std::nullopt;
     }
 }
 
 void Engine::registerCommandHandlers() {
-    commandBus_.setDefaultHandler([](Engine& engine, const protocol::Message& request) {
-        return engine.nakWithStatus(request, toReasonCode(protocol::ErrorCode::InvalidMessage), "unsupported command");
+    commandBus_.setDefaultHandler([](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
+        engine.nakWithStatus(out, request, toReasonCode(protocol::ErrorCode::InvalidMessage), "unsupported command");
     });
 
-    commandBus_.registerHandler(protocol::MessageType::Hello, [](Engine& engine, const protocol::Message& request) {
+    commandBus_.registerHandler(protocol::MessageType::Hello, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
         protocol::HelloAckMessage ack;
         ack.targetId = request.sourceId;
         ack.assignedId = engine.deviceId();
-        ack.serverTime = wallClockMs();
+        ack.serverTime = engine.eventTimeMs();
         ack.accepted = true;
-        Engine::Replies replies;
-        replies.push_back(std::make_unique<protocol::HelloAckMessage>(ack));
-        replies.push_back(engine.buildStatusMessage(request.sourceId));
-        return replies;
+        out.push_back(std::make_unique<protocol::HelloAckMessage>(ack));
+        out.push_back(engine.buildStatusMessage(request.sourceId));
     });
 
-    commandBus_.registerHandler(protocol::MessageType::HelloAck, [](Engine& engine, const protocol::Message& request) {
-        return engine.ackWithStatus(request, "hello_ack_received");
+    commandBus_.registerHandler(protocol::MessageType::HelloAck, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
+        engine.ackWithStatus(out, request, "hello_ack_received");
     });
 
-    commandBus_.registerHandler(protocol::MessageType::Discover, [](Engine& engine, const protocol::Message& request) {
-        return engine.ackWithStatus(request, "discover_ack");
+    commandBus_.registerHandler(protocol::MessageType::Discover, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
+        engine.ackWithStatus(out, request, "discover_ack");
     });
 
-    commandBus_.registerHandler(protocol::MessageType::Ping, [](Engine& engine, const protocol::Message& request) {
+    commandBus_.registerHandler(protocol::MessageType::Ping, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
         protocol::PongMessage pong;
         pong.targetId = request.sourceId;
         const auto& ping = static_cast<const protocol::PingMessage&>(request);
         pong.originalTimestamp = ping.timestamp;
         pong.sequenceNumber = ping.sequenceNumber;
-        pong.responseTimestamp = wallClockMs();
-        Engine::Replies replies;
-        replies.push_back(std::make_unique<protocol::PongMessage>(pong));
-        replies.push_back(engine.buildStatusMessage(request.sourceId));
-        return replies;
+        pong.responseTimestamp = engine.eventTimeMs();
+        out.push_back(std::make_unique<protocol::PongMessage>(pong));
+        out.push_back(engine.buildStatusMessage(request.sourceId));
     });
 
-    commandBus_.registerHandler(protocol::MessageType::Pong, [](Engine& engine, const protocol::Message& request) {
-        return engine.ackWithStatus(request, "pong_received");
+    commandBus_.registerHandler(protocol::MessageType::Pong, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
+        engine.ackWithStatus(out, request, "pong_received");
     });
 
-    commandBus_.registerHandler(protocol::MessageType::Provision, [](Engine& engine, const protocol::Message& request) {
-        return engine.ackWithStatus(request, "provision_ack");
+    commandBus_.registerHandler(protocol::MessageType::Provision, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
+        engine.ackWithStatus(out, request, "provision_ack");
     });
 
-    commandBus_.registerHandler(protocol::MessageType::Goodbye, [](Engine& engine, const protocol::Message& request) {
+    commandBus_.registerHandler(protocol::MessageType::Goodbye, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
         if (engine.runtime_.state() == ExecutionState::Running || engine.runtime_.state() == ExecutionState::Paused) {
             engine.stop();
         }
-        return engine.ackWithStatus(request, "goodbye_ack");
+        engine.ackWithStatus(out, request, "goodbye_ack");
     });
 
-    commandBus_.registerHandler(protocol::MessageType::LoadAutomata, [](Engine& engine, const protocol::Message& request) {
+    commandBus_.registerHandler(protocol::MessageType::LoadAutomata, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
         const auto* load = &static_cast<const protocol::LoadAutomataMessage&>(request);
 
         Result<RunId> result = Result<RunId>::error("unsupported automata format");
         const bool chunked = load->isChunked || load->totalChunks > 1;
 
         if (chunked) {
-            std::vector<uint8_t> assembledData;
-            auto appendResult = engine.appendChunkedLoad(*load, assembledData);
+            auto appendResult = engine.appendChunkedLoad(*load);
             if (appendResult.isError()) {
                 protocol::LoadAckMessage loadAck;
                 loadAck.targetId = request.sourceId;
@@ -1387,17 +2192,16 @@ void Engine::registerCommandHandlers() {
                 loadAck.success = false;
                 loadAck.errorMessage = appendResult.error();
 
-                Engine::Replies replies;
-                replies.push_back(std::make_unique<protocol::LoadAckMessage>(loadAck));
-                replies.push_back(engine.buildStatusMessage(request.sourceId));
-                return replies;
+                out.push_back(std::make_unique<protocol::LoadAckMessage>(loadAck));
+                out.push_back(engine.buildStatusMessage(request.sourceId));
+                return;
             }
 
             if (!appendResult.value()) {
-                return engine.ackWithStatus(request, "load_chunk_received");
+                return engine.ackWithStatus(out, request, "load_chunk_received");
             }
 
-            result = engine.applyProtocolLoad(*load, assembledData);
+            result = engine.finishChunkedLoad(*load);
         } else {
             engine.resetPendingChunkedLoad();
             result = engine.applyProtocolLoad(*load, load->data);
@@ -1413,26 +2217,30 @@ void Engine::registerCommandHandlers() {
             loadAck.success = true;
         }
 
-        Engine::Replies replies;
-        replies.push_back(std::make_unique<protocol::LoadAckMessage>(loadAck));
-        replies.push_back(engine.buildStatusMessage(request.sourceId));
-        return replies;
+        out.push_back(std::make_unique<protocol::LoadAckMessage>(loadAck));
+        // A pending hot swap sends its table when it swaps in
+        if (result.isOk() && engine.idOnlyWire_ && !engine.hotSwap_) {
+            if (auto table = engine.buildSymbolTable(request.sourceId)) {
+                out.push_back(std::move(table));
+            }
+        }
+        out.push_back(engine.buildStatusMessage(request.sourceId));
     });
 
-    commandBus_.registerHandler(protocol::MessageType::LoadAck, [](Engine& engine, const protocol::Message& request) {
-        return engine.ackWithStatus(request, "load_ack_received");
+    commandBus_.registerHandler(protocol::MessageType::LoadAck, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
+        engine.ackWithStatus(out, request, "load_ack_received");
     });
 
-    commandBus_.registerHandler(protocol::MessageType::Start, [](Engine& engine, const protocol::Message& request) {
+    commandBus_.registerHandler(protocol::MessageType::Start, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
         if (!engine.runIdMatches(request)) {
             engine.logHub_.log(LogLevel::Warn, "command",
                                "start requested with stale run_id; applying to active run");
         }
         if (!engine.isLoaded()) {
-            return engine.nakWithStatus(request, toReasonCode(protocol::ErrorCode::NotLoaded), "no automata loaded");
+            return engine.nakWithStatus(out, request, toReasonCode(protocol::ErrorCode::NotLoaded), "no automata loaded");
         }
         if (engine.runtime_.state() == ExecutionState::Running) {
-            return engine.ackWithStatus(request, "already_running");
+            return engine.ackWithStatus(out, request, "already_running");
         }
 
         std::optional<StateId> from;
@@ -1441,75 +2249,73 @@ void Engine::registerCommandHandlers() {
 
         auto result = engine.start(from);
         if (result.isError()) {
-            return engine.nakWithStatus(request, toReasonCode(protocol::ErrorCode::InvalidState), result.error());
+            return engine.nakWithStatus(out, request, toReasonCode(protocol::ErrorCode::InvalidState), result.error());
         }
-        return engine.ackWithStatus(request, "started");
+        engine.ackWithStatus(out, request, "started");
     });
 
-    commandBus_.registerHandler(protocol::MessageType::Stop, [](Engine& engine, const protocol::Message& request) {
+    commandBus_.registerHandler(protocol::MessageType::Stop, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
         if (!engine.runIdMatches(request)) {
             engine.logHub_.log(LogLevel::Warn, "command",
                                "stop requested with stale run_id; applying to active run");
         }
         if (!engine.isLoaded() || engine.runtime_.state() == ExecutionState::Stopped) {
-            return engine.ackWithStatus(request, "already_stopped");
+            return engine.ackWithStatus(out, request, "already_stopped");
         }
 
         auto result = engine.stop();
         if (result.isError()) {
-            return engine.nakWithStatus(request, toReasonCode(protocol::ErrorCode::NotRunning), result.error());
+            return engine.nakWithStatus(out, request, toReasonCode(protocol::ErrorCode::NotRunning), result.error());
         }
-        return engine.ackWithStatus(request, "stopped");
+        engine.ackWithStatus(out, request, "stopped");
     });
 
-    commandBus_.registerHandler(protocol::MessageType::Reset, [](Engine& engine, const protocol::Message& request) {
+    commandBus_.registerHandler(protocol::MessageType::Reset, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
         if (!engine.isLoaded()) {
-            return engine.nakWithStatus(request, toReasonCode(protocol::ErrorCode::NotLoaded), "no automata loaded");
+            return engine.nakWithStatus(out, request, toReasonCode(protocol::ErrorCode::NotLoaded), "no automata loaded");
         }
         auto result = engine.reset();
         if (result.isError()) {
-            return engine.nakWithStatus(request, toReasonCode(protocol::ErrorCode::InvalidState), result.error());
+            return engine.nakWithStatus(out, request, toReasonCode(protocol::ErrorCode::InvalidState), result.error());
         }
-        return engine.ackWithStatus(request, "reset");
+        engine.ackWithStatus(out, request, "reset");
     });
 
-    commandBus_.registerHandler(protocol::MessageType::Status, [](Engine& engine, const protocol::Message& request) {
-        Engine::Replies replies;
-        replies.push_back(engine.buildStatusMessage(request.sourceId));
-        return replies;
+    commandBus_.registerHandler(protocol::MessageType::Status, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
+        out.push_back(engine.buildStatusMessage(request.sourceId));
     });
 
-    commandBus_.registerHandler(protocol::MessageType::Pause, [](Engine& engine, const protocol::Message& request) {
+    commandBus_.registerHandler(protocol::MessageType::Pause, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
         if (!engine.isLoaded()) {
-            return engine.nakWithStatus(request, toReasonCode(protocol::ErrorCode::NotLoaded), "no automata loaded");
+            return engine.nakWithStatus(out, request, toReasonCode(protocol::ErrorCode::NotLoaded), "no automata loaded");
         }
         if (engine.runtime_.state() == ExecutionState::Paused) {
-            return engine.ackWithStatus(request, "already_paused");
+            return engine.ackWithStatus(out, request, "already_paused");
         }
         auto result = engine.pause();
         if (result.isError()) {
-            return engine.nakWithStatus(request, toReasonCode(protocol::ErrorCode::NotRunning), result.error());
+            return engine.nakWithStatus(out, request, toReasonCode(protocol::ErrorCode::NotRunning), result.error());
         }
-        return engine.ackWithStatus(request, "paused");
+        engine.ackWithStatus(out, request, "paused");
     });
 
-    commandBus_.registerHandler(protocol::MessageType::Resume, [](Engine& engine, const protocol::Message& request) {
+    commandBus_.registerHandler(protocol::MessageType::Resume, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
         if (!engine.isLoaded()) {
-            return engine.nakWithStatus(request, toReasonCode(protocol::ErrorCode::NotLoaded), "no automata loaded");
+            return engine.nakWithStatus(out, request, toReasonCode(protocol::ErrorCode::NotLoaded), "no automata loaded");
         }
         if (engine.runtime_.state() == ExecutionState::Running) {
-            return engine.ackWithStatus(request, "already_running");
+            return engine.ackWithStatus(out, request, "already_running");
         }
         auto result = engine.resume();
         if (result.isError()) {
-            return engine.nakWithStatus(request, toReasonCode(protocol::ErrorCode::InvalidState), result.error());
+            return engine.nakWithStatus(out, request, toReasonCode(protocol::ErrorCode::InvalidState), result.error());
         }
-        return engine.ackWithStatus(request, "resumed");
+        engine.ackWithStatus(out, request, "resumed");
     });
 
-    commandBus_.registerHandler(protocol::MessageType::RestoreState, [](Engine& engine, const protocol::Message& request) {
+    commandBus_.registerHandler(protocol::MessageType::RestoreState, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
         if (!engine.isLoaded()) {
-            return engine.nakWithStatus(request, toReasonCode(protocol::ErrorCode::NotLoaded), "no automata loaded");
+            return engine.nakWithStatus(out, request, toReasonCode(protocol::ErrorCode::NotLoaded), "no automata loaded");
         }
         const auto& msg = static_cast<const protocol::RestoreStateMessage&>(request);
         std::vector<std::pair<std::string, Value>> vars;
@@ -1519,14 +2325,38 @@ void Engine::registerCommandHandlers() {
         }
         auto result = engine.runtime_.restoreState(msg.targetState, vars);
         if (result.isError()) {
-            return engine.nakWithStatus(request, toReasonCode(protocol::ErrorCode::InvalidState), result.error());
+            return engine.nakWithStatus(out, request, toReasonCode(protocol::ErrorCode::InvalidState), result.error());
         }
         engine.traceRuntimeEvent("restore_state", "time_travel",
                                  "restored to " + msg.targetState, engine.activeRunId_);
-        return engine.ackWithStatus(request, "state_restored");
+        engine.ackWithStatus(out, request, "state_restored");
+    });
+
+    commandBus_.registerHandler(protocol::MessageType::SymbolTable, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
+        // Any SymbolTable sent to the device is a request for its own.
+        auto table = engine.buildSymbolTable(request.sourceId);
+        if (!table) {
+            return engine.nakWithStatus(out, request, toReasonCode(protocol::ErrorCode::NotLoaded), "no automata loaded");
+        }
+        out.push_back(std::move(table));
+    });
+
+    commandBus_.registerHandler(protocol::MessageType::PeerWiring, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
+        const auto& wiring = static_cast<const protocol::PeerWiringMessage&>(request);
+        auto result = engine.peerLinks_.configure(engine.deviceId_, wiring.wires, wiring.sampleEvery);
+        if (result.isError()) {
+            return engine.nakWithStatus(out, request, toReasonCode(protocol::ErrorCode::InvalidMessage), result.error());
+        }
+        if (engine.isLoaded()) {
+            engine.peerLinks_.bind(engine.runtime_.context().variables);
+        }
+        engine.logHub_.log(LogLevel::Info, "command",
+                           "peer wiring: " + std::to_string(engine.peerLinks_.routeCount()) + " routes over " +
+                           std::to_string(engine.peerLinks_.linkCount()) + " links");
+        engine.ackWithStatus(out, request, "peer_wiring_applied");
     });
 
-    commandBus_.registerHandler(protocol::MessageType::Input, [](Engine& engine, const protocol::Message& request) {
+    commandBus_.registerHandler(protocol::MessageType::Input, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
         if (!engine.runIdMatches(request)) {
             engine.logHub_.log(LogLevel::Warn, "command",
                                "input requested with stale run_id; applying to active run");
@@ -1536,7 +2366,7 @@ void Engine::registerCommandHandlers() {
             ? engine.setInput(input->variableId, input->value)
             : engine.setInput(input->variableName, input->value);
         if (result.isError()) {
-            return engine.nakWithStatus(request, toReasonCode(protocol::ErrorCode::InvalidVariable), result.error());
+            return engine.nakWithStatus(out, request, toReasonCode(protocol::ErrorCode::InvalidVariable), result.error());
         }
         if (engine.isRunning()) {
             engine.tick();
@@ -1547,16 +2377,45 @@ void Engine::registerCommandHandlers() {
         ack.relatedMessageId = request.messageId;
         ack.info = "input_set";
 
-        Engine::Replies replies;
-        replies.push_back(std::make_unique<protocol::AckMessage>(ack));
-        return replies;
+        out.push_back(std::make_unique<protocol::AckMessage>(ack));
+    });
+
+    commandBus_.registerHandler(protocol::MessageType::InputBatch, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
+        if (!engine.runIdMatches(request)) {
+            engine.logHub_.log(LogLevel::Warn, "command",
+                               "input batch requested with stale run_id; applying to active run");
+        }
+        const auto& batch = static_cast<const protocol::InputBatchMessage&>(request);
+        auto result = engine.setInputs(batch.inputs);
+        if (result.isError()) {
+            return engine.nakWithStatus(out, request, toReasonCode(protocol::ErrorCode::InvalidVariable), result.error());
+        }
+        // One evaluation for the whole sample.
+        if (engine.isRunning()) {
+            engine.tick();
+        }
+
+        protocol::AckMessage ack;
+        ack.targetId = request.sourceId;
+        ack.relatedMessageId = request.messageId;
+        ack.info = "input_batch_set";
+
+        out.push_back(std::make_unique<protocol::AckMessage>(ack));
+    });
+
+    commandBus_.registerHandler(protocol::MessageType::Output, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
+        engine.ackWithStatus(out, request, "output_received");
+    });
+
+    commandBus_.registerHandler(protocol::MessageType::OutputBatch, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
+        engine.ackWithStatus(out, request, "output_batch_received");
     });
 
-    commandBus_.registerHandler(protocol::MessageType::Output, [](Engine& engine, const protocol::Message& request) {
-        return engine.ackWithStatus(request, "output_received");
+    commandBus_.registerHandler(protocol::MessageType::OutputAggregate, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
+        engine.ackWithStatus(out, request, "output_aggregate_received");
     });
 
-    commandBus_.registerHandler(protocol::MessageType::Variable, [](Engine& engine, const protocol::Message& request) {
+    commandBus_.registerHandler(protocol::MessageType::Variable, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
         if (!engine.runIdMatches(request)) {
             engine.logHub_.log(LogLevel::Warn, "command",
                                "variable requested with stale run_id; applying to active run");
@@ -1566,53 +2425,71 @@ void Engine::registerCommandHandlers() {
             ? engine.setVariable(variable->variableId, variable->value)
             : engine.setVariable(variable->variableName, variable->value);
         if (result.isError()) {
-            return engine.nakWithStatus(request, toReasonCode(protocol::ErrorCode::InvalidVariable), result.error());
+            return engine.nakWithStatus(out, request, toReasonCode(protocol::ErrorCode::InvalidVariable), result.error());
         }
         protocol::AckMessage ack;
         ack.targetId = request.sourceId;
         ack.relatedMessageId = request.messageId;
         ack.info = "variable_set";
 
-        Engine::Replies replies;
-        replies.push_back(std::make_unique<protocol::AckMessage>(ack));
-        return replies;
+        out.push_back(std::make_unique<protocol::AckMessage>(ack));
+    });
+
+    commandBus_.registerHandler(protocol::MessageType::StateChange, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
+        engine.ackWithStatus(out, request, "state_change_received");
+    });
+
+    commandBus_.registerHandler(protocol::MessageType::Telemetry, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
+        engine.ackWithStatus(out, request, "telemetry_received");
     });
 
-    commandBus_.registerHandler(protocol::MessageType::StateChange, [](Engine& engine, const protocol::Message& request) {
-        return engine.ackWithStatus(request, "state_change_received");
+    commandBus_.registerHandler(protocol::MessageType::TelemetryAck, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
+        const auto& ack = static_cast<const protocol::TelemetryAckMessage&>(request);
+        if (ack.requestKeyframe || !engine.runIdMatches(request)) {
+            // Controller lost its mirror (reconnect) or tracks another run.
+            engine.telemetryDelta_.reset();
+            if (auto keyframe = engine.buildTelemetryDelta(request.sourceId)) {
+                out.push_back(std::move(keyframe));
+            }
+            return;
+        }
+        // Acks are not acknowledged themselves.
+        engine.telemetryDelta_.acknowledge(ack.sequence);
     });
 
-    commandBus_.registerHandler(protocol::MessageType::Telemetry, [](Engine& engine, const protocol::Message& request) {
-        return engine.ackWithStatus(request, "telemetry_received");
+    commandBus_.registerHandler(protocol::MessageType::Profile, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
+        // Any Profile sent to the device is a request for its own.
+        const auto& profileRequest = static_cast<const protocol::ProfileMessage&>(request);
+        out.push_back(engine.buildProfileMessage(
+            request.sourceId, static_cast<CodeCostOrder>(std::min(profileRequest.order, static_cast<uint8_t>(CodeCostOrder::Memory)))));
+        if (profileRequest.reset) {
+            engine.resetProfile();
+        }
     });
 
-    commandBus_.registerHandler(protocol::MessageType::TransitionFired, [](Engine& engine, const protocol::Message& request) {
-        return engine.ackWithStatus(request, "transition_received");
+    commandBus_.registerHandler(protocol::MessageType::TransitionFired, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
+        engine.ackWithStatus(out, request, "transition_received");
     });
 
-    commandBus_.registerHandler(protocol::MessageType::Vendor, [](Engine& engine, const protocol::Message& request) {
-        return engine.ackWithStatus(request, "vendor_received");
+    commandBus_.registerHandler(protocol::MessageType::Vendor, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
+        engine.ackWithStatus(out, request, "vendor_received");
     });
 
-    commandBus_.registerHandler(protocol::MessageType::Debug, [](Engine& engine, const protocol::Message& request) {
+    commandBus_.registerHandler(protocol::MessageType::Debug, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
         const auto& debug = static_cast<const protocol::DebugMessage&>(request);
         engine.logHub_.log(LogLevel::Debug, debug.source.empty() ? "remote" : debug.source, debug.message);
-        return engine.ackWithStatus(request, "debug_received");
+        engine.ackWithStatus(out, request, "debug_received");
     });
 
-    commandBus_.registerHandler(protocol::MessageType::Error, [](Engine& engine, const protocol::Message& request) {
+    commandBus_.registerHandler(protocol::MessageType::Error, [](Engine& engine, const protocol::Message& request, Engine::Replies& out) {
         const auto& error = static_cast<const protocol::ErrorMessage&>(request);
         engine.logHub_.event(EventKind::Error, LogLevel::Error, "remote", error.message, error.runId);
-        return engine.ackWithStatus(request, "error_received");
+        engine.ackWithStatus(out, request, "error_received");
     });
 
-    commandBus_.registerHandler(protocol::MessageType::Ack, [](Engine&, const protocol::Message&) {
-        return Engine::Replies{};
-    });
+    commandBus_.registerHandler(protocol::MessageType::Ack, [](Engine&, const protocol::Message&, Engine::Replies&) {});
 
-    commandBus_.registerHandler(protocol::MessageType::Nak, [](Engine&, const protocol::Message&) {
-        return Engine::Replies{};
-    });
+    commandBus_.registerHandler(protocol::MessageType::Nak, [](Engine&, const protocol::Message&, Engine::Replies&) {});
 }
 
 } // namespace aeth
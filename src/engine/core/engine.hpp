@@ -2,27 +2,81 @@
 #define AETHERIUM_ENGINE_HPP
 
 #include "artifact.hpp"
+#include "checkpoint.hpp"
 #include "command_bus.hpp"
 #include "execution_trace.hpp"
+#include "peer_links.hpp"
+#include "telemetry_aggregator.hpp"
 #include "protocol.hpp"
 #include "protocol_v2.hpp"
 #include "runtime.hpp"
+#include "telemetry_delta.hpp"
 #include "telemetry_log_hub.hpp"
+#include "tick_pacer.hpp"
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <deque>
+#include <functional>
 #include <random>
 #include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
+#if !defined(ARDUINO) && !defined(AETHERIUM_PLATFORM_MCXN947)
+#include "automata_analysis.hpp"
+
+#include <thread>
+#endif
+
+// Largest automaton accepted through LoadAutomata, per target. Binary
+// artifacts are decoded as chunks arrive, so this bounds the artifact, not
+// a reassembly buffer (YAML text is still buffered whole).
+#ifndef AETHERIUM_MAX_LOAD_BYTES
+#if defined(ARDUINO) || defined(AETHERIUM_PLATFORM_MCXN947)
+#define AETHERIUM_MAX_LOAD_BYTES (128u * 1024u)
+#else
+#define AETHERIUM_MAX_LOAD_BYTES (4u * 1024u * 1024u)
+#endif
+#endif
+
+// Runtime events held while the link is congested; past this the oldest
+// events are dropped (see Engine::setEventBackpressure). 0 = unbounded.
+#ifndef AETHERIUM_EVENT_QUEUE_LIMIT
+#if defined(ARDUINO) || defined(AETHERIUM_PLATFORM_MCXN947)
+#define AETHERIUM_EVENT_QUEUE_LIMIT 64u
+#else
+#define AETHERIUM_EVENT_QUEUE_LIMIT 4096u
+#endif
+#endif
+
+// Commands handled per processCommandQueue call from the input and bulk
+// lanes; the rest wait for the next call. Control is never capped. 0 = unbounded.
+#ifndef AETHERIUM_INPUT_LANE_BUDGET
+#if defined(ARDUINO) || defined(AETHERIUM_PLATFORM_MCXN947)
+#define AETHERIUM_INPUT_LANE_BUDGET 16u
+#else
+#define AETHERIUM_INPUT_LANE_BUDGET 256u
+#endif
+#endif
+
+#ifndef AETHERIUM_BULK_LANE_BUDGET
+#if defined(ARDUINO) || defined(AETHERIUM_PLATFORM_MCXN947)
+#define AETHERIUM_BULK_LANE_BUDGET 4u
+#else
+#define AETHERIUM_BULK_LANE_BUDGET 64u
+#endif
+#endif
+
 namespace aeth {
 
 struct EngineFrontendLoaderHandle;
 
 struct EngineInitOptions {
     uint32_t maxTickRate = 10;
+    TickMode tickMode = TickMode::Polling;
     size_t logCapacity = 2048;
     // Max trace records kept in LocalTraceStore. 0 = unlimited (host default).
     // Set to a small non-zero value on embedded to prevent heap exhaustion.
@@ -30,9 +84,28 @@ struct EngineInitOptions {
     DeviceId deviceId = 1;
     std::string deviceName = "cpp-engine";
     std::optional<uint64_t> faultRandomSeed = std::nullopt;
-    std::optional<std::string> traceOutputPath = std::nullopt;
+    std::optional<std::string> traceOutputPath = std::nullopt;  // ".aetr" streams a binary trace while running
     DeploymentDescriptor deployment;
     FaultProfile faultProfile;
+    size_t maxLoadBytes = AETHERIUM_MAX_LOAD_BYTES;
+    GcPolicy gcPolicy;
+    // Script heap cap for the loaded automaton; allocations past it fail as
+    // Lua memory errors. 0 = unlimited.
+    size_t scriptMemoryBudget = 0;
+    // Script engines kept initialized for hot swaps (Runtime::warmScriptEngines)
+#if defined(ARDUINO) || defined(AETHERIUM_PLATFORM_MCXN947)
+    size_t spareScriptEngines = 0;
+#else
+    size_t spareScriptEngines = 1;
+#endif
+    // Timestamp traces and messages from the runtime clock instead of the
+    // wall clock, so a simulated run on a VirtualClock traces virtual time
+    bool virtualTime = false;
+    // Record trace records at all (batch runners turn this off)
+    bool traceEnabled = true;
+    // Runtime checkpoint every N ticks into a ring of checkpointCapacity. 0 = off.
+    uint32_t checkpointEveryTicks = 0;
+    size_t checkpointCapacity = 32;
 };
 
 struct EngineStatus {
@@ -43,8 +116,23 @@ struct EngineStatus {
     uint64_t transitionCount = 0;
     uint32_t errorCount = 0;
     Timestamp uptime = 0;
+    uint32_t scriptValuesSynced = 0;  // Variable values synced with the script engine last tick
+    uint32_t transitionsEvaluated = 0;  // Outgoing transitions evaluated last tick
+    uint64_t messageAllocations = 0;  // Pooled protocol messages taken from the heap (process-wide)
+    ScriptMemoryStats scriptMemory;   // Script VM allocator counters
+    uint32_t tickRate = 0;            // Current ticks per second (paced or configured)
+    PacingDecision pacingDecision = PacingDecision::Hold;  // Why the paced rate last changed
+};
+
+// One line of the script cost report: a code block and the state or transition it belongs to
+struct ScriptCostRow {
+    CodeCostEntry entry;
+    std::string owner;  // State or transition name
 };
 
+// Lua when built with it, otherwise the simple expression engine
+std::unique_ptr<IScriptEngine> makeDefaultScriptEngine();
+
 class Engine {
 public:
     using Replies = std::vector<std::unique_ptr<protocol::Message>>;
@@ -86,42 +174,195 @@ public:
 
     Result<void> setInput(const std::string& name, Value value);
     Result<void> setInput(VariableId id, Value value);
+    Result<void> setInputs(const std::vector<VariableUpdate>& inputs);
     Result<void> setVariable(const std::string& name, Value value);
     Result<void> setVariable(VariableId id, Value value);
 
     [[nodiscard]] EngineStatus status() const;
     [[nodiscard]] std::vector<LogEvent> getLogs(const LogQuery& query = {}) const;
     void streamLogs(EventStreamCallback callback);
+    void streamLogs(EventStreamCallback callback, const StreamOptions& options);
+    // Per-subscriber delivery and drop counters; not part of status(), which runs every tick
+    [[nodiscard]] std::vector<LogStreamStats> logStreamStats() const { return logHub_.streamStats(); }
     [[nodiscard]] const DeploymentDescriptor& deploymentDescriptor() const { return deployment_; }
     [[nodiscard]] const FaultProfile& faultProfile() const { return faultProfile_; }
+    [[nodiscard]] const FaultStats& faultStats() const { return faultStats_; }
+
+    // Reseed the runtime's random source (probabilistic transitions) and the fault decisions
+    void setSeed(uint64_t runtimeSeed, uint64_t faultSeed);
+
+    /**
+     * Called on every state change with the event timestamp, straight from
+     * the runtime (fault injection cannot drop it). One observer; empty clears.
+     */
+    using StateObserver = std::function<void(StateId from, StateId to, TransitionId via, Timestamp at)>;
+    void setStateObserver(StateObserver observer) { stateObserver_ = std::move(observer); }
+
+    /**
+     * Called with every trace record as it is recorded, before the store
+     * keeps (or evicts) it. One observer; empty clears.
+     */
+    using TraceObserver = std::function<void(const TraceRecord&)>;
+    void setTraceObserver(TraceObserver observer) { traceObserver_ = std::move(observer); }
     [[nodiscard]] const LocalTraceStore& traceStore() const { return traceStore_; }
 
+    /**
+     * Checkpoints of the current run, stamped with eventTimeMs() (so they
+     * line up with trace timestamps). Taken automatically every
+     * checkpointEveryTicks ticks, or on demand.
+     */
+    [[nodiscard]] const CheckpointRing& checkpoints() const { return checkpoints_; }
+    Result<void> takeCheckpoint();
+
+    /**
+     * Restore the newest checkpoint at or before `at` and drop the later
+     * ones. Returns the checkpoint's time; replaying the inputs traced
+     * after it lands the run on `at`.
+     */
+    Result<Timestamp> seekToCheckpoint(Timestamp at);
+
     void setDeploymentDescriptor(DeploymentDescriptor descriptor);
     void setFaultProfile(FaultProfile profile);
     void setTraceOutputPath(std::optional<std::string> path);
+
+    /**
+     * Send data-plane messages by id only. The names go out once per load
+     * in a SymbolTable message instead of on every output and telemetry.
+     */
+    void setIdOnlyWire(bool enabled);
+    [[nodiscard]] bool idOnlyWire() const { return idOnlyWire_; }
+
+    /**
+     * Treat non-replacing protocol loads (replaceExisting = false) as
+     * LoadReplaceMode::HotSwap while a run is active.
+     */
+    void setHotSwapLoads(bool enabled) { hotSwapLoads_ = enabled; }
+    [[nodiscard]] bool hotSwapLoads() const { return hotSwapLoads_; }
+    // A hot-swap load is warming up or waiting for the next tick
+    [[nodiscard]] bool hotSwapPending() const { return hotSwap_ != nullptr; }
+
+#if !defined(ARDUINO) && !defined(AETHERIUM_PLATFORM_MCXN947)
+    /**
+     * Static analysis of the automata loaded last (see automata_analysis.hpp).
+     * Runs on every load and hot swap, answered from a cache when the same
+     * automata was analyzed before; findings are logged as warnings.
+     */
+    [[nodiscard]] std::shared_ptr<const AutomataAnalysis> lastAnalysis() const { return analysis_; }
+    [[nodiscard]] const AnalysisCache& analysisCache() const { return analysisCache_; }
+#endif
     Result<void> writeTrace() const;
 
     void tick();
+    [[nodiscard]] uint32_t maxTickRate() const { return runtime_.maxTickRate(); }
+    /**
+     * The rate hosts should tick at: the pacer's while the deployment
+     * enables pacing (PacingProfile), maxTickRate() otherwise.
+     */
+    [[nodiscard]] uint32_t tickRate() const { return pacer_.enabled() ? pacer_.rate() : maxTickRate(); }
+    [[nodiscard]] const TickPacer& pacer() const { return pacer_; }
+
+    // Milliseconds until the runtime's next timer is due (nullopt if none)
+    [[nodiscard]] std::optional<uint32_t> msUntilNextTimer() { return runtime_.msUntilNextTimer(); }
+    [[nodiscard]] ScriptMemoryStats scriptMemory() const { return runtime_.scriptMemory(); }
+    // Script GC steps in idle time; see Runtime::collectGarbageIdle
+    bool collectGarbageIdle(uint32_t budgetUs) { return runtime_.collectGarbageIdle(budgetUs); }
 
     void enqueueCommand(std::unique_ptr<protocol::Message> message);
+    /**
+     * Handles due commands lane by lane (see CommandLane): every control
+     * command, then up to the input and bulk budgets, so a Stop never waits
+     * behind an input flood. Leftovers keep their order for the next call.
+     */
     Replies processCommandQueue();
+    // Earliest release time of a fault-delayed ingress or outbound message
+    // (now, while a lane still holds commands past its budget)
+    [[nodiscard]] std::optional<Timestamp> nextReleaseAt() const;
+    void setLaneBudget(CommandLane lane, size_t perCall) { laneBudgets_[static_cast<size_t>(lane)] = perCall; }
+    [[nodiscard]] size_t laneBudget(CommandLane lane) const { return laneBudgets_[static_cast<size_t>(lane)]; }
+    // Commands due and waiting in a lane (fault-delayed ones are not counted)
+    [[nodiscard]] size_t pendingCommandCount(CommandLane lane) const {
+        return ingressLanes_[static_cast<size_t>(lane)].size();
+    }
+
+    /**
+     * While set, processCommandQueue still answers commands but leaves
+     * runtime events queued: repeated outputs of a variable keep collapsing
+     * into the latest value, and past the queue limit the oldest events go
+     * (transition-fired first, since state changes carry the transition).
+     */
+    void setEventBackpressure(bool congested) { eventBackpressure_ = congested; }
+    [[nodiscard]] bool eventBackpressure() const { return eventBackpressure_; }
+    void setEventQueueLimit(size_t limit) { eventQueueLimit_ = limit; }  // Applies from the next event
+
+    /**
+     * Send each tick's changed outputs as one OutputBatch frame instead of an
+     * Output per variable. Off by default: controllers that only decode
+     * Output need the per-variable frames.
+     */
+    void setOutputBatching(bool on) { outputBatching_ = on; }
+    [[nodiscard]] bool outputBatching() const { return outputBatching_; }
+    /**
+     * Deploy-time engine-to-engine wiring (PEER_WIRING). The platform layer
+     * supplies the transports; pollPeerLinks() applies the inputs peers sent
+     * (without acking them) and ticks once if any landed.
+     */
+    void setPeerTransportFactory(PeerLinks::TransportFactory factory) {
+        peerLinks_.setTransportFactory(std::move(factory));
+    }
+    [[nodiscard]] const PeerLinks& peerLinks() const { return peerLinks_; }
+    size_t pollPeerLinks(size_t max);
+    // Outputs whose YAML `telemetry:` policy shapes what the server gets
+    [[nodiscard]] const TelemetryAggregator& telemetryAggregator() const { return telemetryAggregator_; }
+    // Drop outputs that end a tick back at their pre-tick value (see Runtime::setSuppressOutputFlips)
+    void setSuppressOutputFlips(bool suppress) { runtime_.setSuppressOutputFlips(suppress); }
+    [[nodiscard]] size_t pendingEventCount() const { return eventQueue_.size(); }
+    [[nodiscard]] uint64_t droppedEventCount() const { return droppedEvents_; }
 
     Replies dispatch(const protocol::Message& message);
+    // Appends the replies to out, so callers can reuse one buffer
+    void dispatch(const protocol::Message& message, Replies& out);
 
     [[nodiscard]] bool isLoaded() const { return runtime_.isLoaded(); }
     [[nodiscard]] bool isRunning() const { return runtime_.isRunning(); }
     [[nodiscard]] RunId activeRunId() const { return activeRunId_; }
+    [[nodiscard]] const VariableStore& variables() const { return runtime_.context().variables; }
+    [[nodiscard]] const Automata* automata() const { return runtime_.context().automata; }
+    // Milliseconds on the clock traces and messages are stamped with
+    [[nodiscard]] Timestamp eventTimeMs() const;
 
     [[nodiscard]] DeviceId deviceId() const { return deviceId_; }
     [[nodiscard]] const std::string& deviceName() const { return deviceName_; }
     [[nodiscard]] std::unique_ptr<protocol::TelemetryMessage> buildTelemetryMessage(DeviceId target = 0) const;
 
+    /**
+     * Next delta-encoded telemetry frame (keyframe until one is acked).
+     * Returns nullptr when nothing changed since the acknowledged base.
+     */
+    [[nodiscard]] std::unique_ptr<protocol::TelemetryDeltaMessage> buildTelemetryDelta(DeviceId target = 0);
+
+    // Id-to-name table for the loaded run (nullptr if nothing is loaded)
+    [[nodiscard]] std::unique_ptr<protocol::SymbolTableMessage> buildSymbolTable(DeviceId target = 0) const;
+
+    // Tick phases, tick/guard/dispatch latency and the costliest code blocks
+    // by `order`; empty with AETHERIUM_PROFILING=0
+    [[nodiscard]] std::unique_ptr<protocol::ProfileMessage> buildProfileMessage(
+        DeviceId target = 0, CodeCostOrder order = CodeCostOrder::Time) const;
+    // Every code block that ran since the last reset or load, most expensive first
+    [[nodiscard]] std::vector<ScriptCostRow> scriptCosts(CodeCostOrder order = CodeCostOrder::Time) const;
+    [[nodiscard]] const RuntimeProfile& runtimeProfile() const { return runtime_.profile(); }
+    [[nodiscard]] const LatencyHistogram& dispatchLatency() const { return dispatchLatency_; }
+    void resetProfile();
+
+    // RunId carried by a message, if its type has one (used for routing)
+    static std::optional<RunId> extractRunId(const protocol::Message& message);
+
 private:
     struct ScheduledIngressMessage {
         Timestamp releaseAt = 0;
         std::unique_ptr<protocol::Message> message;
         Timestamp receiveTimestamp = 0;
         std::vector<std::string> faultActions;
+        uint64_t sequence = 0;  // Arrival order; breaks releaseAt ties in the delay heap
     };
 
     struct ScheduledOutboundMessage {
@@ -142,26 +383,62 @@ private:
         uint16_t totalChunks = 0;
         uint16_t nextChunkIndex = 0;
         size_t totalBytes = 0;
-        std::vector<uint8_t> data;
+        std::unique_ptr<ir::ArtifactStreamDecoder> artifact;  // Binary format
+        std::vector<uint8_t> text;                           // YAML format
     };
 
-    static constexpr size_t kMaxChunkedLoadBytes = 128 * 1024;
+    /**
+     * A HotSwap load between LoadAck and the swap. The worker fills
+     * `prepared` (or `error`) and then sets `ready`; tick() swaps it in.
+     */
+    struct PendingHotSwap {
+        std::unique_ptr<Automata> automata;  // Old automata once swapped
+        std::unique_ptr<PreparedLoad> prepared;
+        std::string error;
+        std::atomic<bool> ready{false};
+        std::optional<RunId> requestedRunId;
+        std::chrono::steady_clock::time_point stagedAt;
+        std::chrono::steady_clock::time_point preparedAt;
+#if !defined(ARDUINO) && !defined(AETHERIUM_PLATFORM_MCXN947)
+        std::thread worker;
+
+        ~PendingHotSwap() {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+#endif
+    };
 
     void configureRuntimeCallbacks();
     void registerCommandHandlers();
     void resetPendingChunkedLoad();
-    Result<bool> appendChunkedLoad(const protocol::LoadAutomataMessage& load,
-                                   std::vector<uint8_t>& assembledData);
+    Result<bool> appendChunkedLoad(const protocol::LoadAutomataMessage& load);
+    Result<RunId> finishChunkedLoad(const protocol::LoadAutomataMessage& load);
+    // `storage` owns `data` and ends up in Automata::codeStorage
+    Result<RunId> loadIndexedBytecode(const uint8_t* data,
+                                      size_t size,
+                                      std::shared_ptr<const void> storage,
+                                      protocolv2::LoadReplaceMode mode,
+                                      bool startAfterLoad,
+                                      std::optional<RunId> requestedRunId);
+    Result<RunId> loadDecodedArtifact(ir::ArtifactStreamDecoder& artifact,
+                                      protocolv2::LoadReplaceMode mode,
+                                      bool startAfterLoad,
+                                      std::optional<RunId> requestedRunId);
     Result<RunId> applyProtocolLoad(const protocol::LoadAutomataMessage& load,
                                     const std::vector<uint8_t>& data);
 
-    Replies ackWithStatus(const protocol::Message& request, const std::string& info = "ok");
-    Replies nakWithStatus(const protocol::Message& request,
-                          uint16_t reasonCode,
-                          const std::string& reason);
+    void ackWithStatus(Replies& out, const protocol::Message& request, const std::string& info = "ok");
+    void nakWithStatus(Replies& out,
+                       const protocol::Message& request,
+                       uint16_t reasonCode,
+                       const std::string& reason);
     std::unique_ptr<protocol::StatusMessage> buildStatusMessage(DeviceId target) const;
     std::vector<protocol::NamedValueSnapshotEntry> collectNamedVariableSnapshot() const;
     protocol::DeploymentMetadataExtension collectDeploymentMetadataExtension() const;
+    // Attaches the binary trace writer when traceOutputPath_ is an .aetr path
+    Result<void> openTraceStream();
     void traceLifecycleEvent(const std::string& summary,
                              const std::string& category,
                              std::optional<RunId> runId = std::nullopt);
@@ -186,24 +463,39 @@ private:
     void applyDeploymentMetrics(TraceRecord& record,
                                 std::optional<uint32_t> observedLatencyMs = std::nullopt) const;
     void consumeBattery(double percent);
+    [[nodiscard]] bool batteryLow() const;
+    void pace(uint64_t tickCostUs);
     FaultDecision decideFaultDelivery(bool forIngress, Timestamp now);
     void stageOutbound(std::unique_ptr<protocol::Message> message,
                        std::optional<Timestamp> receiveTimestamp = std::nullopt,
                        std::optional<Timestamp> handleTimestamp = std::nullopt);
     void releaseReadyOutbound(Replies& replies);
+    // Handles a drained ingress batch in order and leaves it empty
+    void dispatchBatch(std::vector<ScheduledIngressMessage>& batch);
+    void queueEvent(std::unique_ptr<protocol::Message> event);
+    void queueOutputs(const std::vector<const Variable*>& outputs, Timestamp eventAt);
+    void flushTelemetryWindows();
 
     Result<RunId> applyLoadedAutomata(std::unique_ptr<Automata> automata,
                                       protocolv2::LoadReplaceMode mode,
                                       bool startAfterLoad,
                                       std::optional<RunId> requestedRunId);
+    Result<RunId> stageHotSwap(std::unique_ptr<Automata> automata,
+                               std::unique_ptr<IScriptEngine> script,
+                               std::optional<RunId> requestedRunId);
+    void applyPendingHotSwap();
+    void traceLoadedContract(RunId runId);
+    void analyzeLoadedAutomata(RunId runId);
+    protocolv2::LoadReplaceMode protocolReplaceMode(bool replaceExisting) const;
 
     bool runIdMatches(const protocol::Message& message) const;
-    static std::optional<RunId> extractRunId(const protocol::Message& message);
+    const std::string* variableNameById(VariableId id) const;
 
     Runtime runtime_;
     std::unique_ptr<EngineFrontendLoaderHandle> frontendLoader_;
     TelemetryLogHub logHub_;
     CommandBus commandBus_;
+    TelemetryDeltaTracker telemetryDelta_;
 
     std::unique_ptr<Automata> loadedAutomata_;
 
@@ -213,9 +505,25 @@ private:
     DeploymentDescriptor deployment_;
     FaultProfile faultProfile_;
     LocalTraceStore traceStore_;
+    bool traceEnabled_ = true;
+    CheckpointRing checkpoints_;
+    uint32_t checkpointEveryTicks_ = 0;
+    uint64_t lastCheckpointTick_ = 0;
+    RunId checkpointRunId_ = 0;  // Run the ring's checkpoints belong to
+    FaultStats faultStats_;
+    StateObserver stateObserver_;
+    TraceObserver traceObserver_;
+    LatencyHistogram dispatchLatency_;
     std::optional<std::string> traceOutputPath_;
+    bool idOnlyWire_ = false;
+    bool hotSwapLoads_ = false;
+    bool virtualTime_ = false;
+    size_t maxLoadBytes_ = AETHERIUM_MAX_LOAD_BYTES;
     std::mt19937_64 faultRandom_{std::random_device{}()};
     double batteryPercent_ = 100.0;
+    TickPacer pacer_;
+    uint64_t pacedTransitions_ = 0;  // Transition count and variable revision at the last paced tick
+    uint64_t pacedRevision_ = 0;
     uint32_t lastObservedLatencyMs_ = 0;
     uint32_t lastIngressLatencyMs_ = 0;
     uint32_t lastEgressLatencyMs_ = 0;
@@ -223,10 +531,30 @@ private:
     Timestamp lastReceiveTimestamp_ = 0;
     Timestamp lastHandleTimestamp_ = 0;
 
-    std::deque<ScheduledIngressMessage> ingressQueue_;
+    std::array<std::deque<ScheduledIngressMessage>, COMMAND_LANE_COUNT> ingressLanes_;
+    std::vector<ScheduledIngressMessage> delayedIngress_;  // Min-heap on (releaseAt, sequence)
+    uint64_t ingressSequence_ = 0;
+    std::array<size_t, COMMAND_LANE_COUNT> laneBudgets_{0, AETHERIUM_INPUT_LANE_BUDGET, AETHERIUM_BULK_LANE_BUDGET};
+    std::vector<ScheduledIngressMessage> ingressBatch_;  // Reused by processCommandQueue
+    Replies replyScratch_;                               // Reused by dispatchBatch
     std::deque<std::unique_ptr<protocol::Message>> eventQueue_;
+    size_t eventQueueLimit_ = AETHERIUM_EVENT_QUEUE_LIMIT;
+    uint64_t droppedEvents_ = 0;
+    bool eventBackpressure_ = false;
+    bool outputBatching_ = false;
+    PeerLinks peerLinks_;
+    std::vector<const Variable*> serverOutputs_;  // Reused when peer links or telemetry filter outputs
+    TelemetryAggregator telemetryAggregator_;
+    std::vector<VariableId> releasedOutputs_;
+    std::vector<protocol::OutputAggregateMessage> closedWindows_;
     std::deque<ScheduledOutboundMessage> delayedOutboundQueue_;
     PendingChunkedLoad pendingChunkedLoad_;
+    std::unique_ptr<PendingHotSwap> hotSwap_;
+    std::unique_ptr<PendingHotSwap> retiredHotSwap_;  // Swapped-out run, freed after the tick
+#if !defined(ARDUINO) && !defined(AETHERIUM_PLATFORM_MCXN947)
+    AnalysisCache analysisCache_;
+    std::shared_ptr<const AutomataAnalysis> analysis_;
+#endif
 };
 
 } // namespace aeth
@@ -0,0 +1,288 @@
+#include "engine_host.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+
+namespace aeth {
+
+EngineHost::EngineHost(EngineHostOptions options)
+    : options_(std::move(options))
+    , pool_(options_.workers) {}
+
+EngineHost::~EngineHost() {
+    pool_.waitIdle();
+}
+
+Result<size_t> EngineHost::addInstance(const std::string& name) {
+    auto instance = std::make_unique<Instance>();
+    instance->index = instances_.size();
+    instance->name = name;
+    instance->engine = std::make_unique<Engine>();
+
+    EngineInitOptions init = options_.instanceDefaults;
+    init.deviceId = options_.firstDeviceId + static_cast<DeviceId>(instance->index);
+    init.deviceName = options_.instanceDefaults.deviceName + "-" + std::to_string(instance->index);
+    auto result = instance->engine->initialize(init);
+    if (result.isError()) {
+        return Result<size_t>::error("instance '" + name + "': " + result.error());
+    }
+    if (options_.peerTransportFactory) {
+        instance->engine->setPeerTransportFactory(options_.peerTransportFactory);
+    }
+    instance->deviceId.store(instance->engine->deviceId(), std::memory_order_relaxed);
+    instance->scheduler.setRate(instance->engine->tickRate());
+    instance->tickRate.store(instance->scheduler.rate(), std::memory_order_relaxed);
+
+    instances_.push_back(std::move(instance));
+    return Result<size_t>::ok(instances_.size() - 1);
+}
+
+Result<size_t> EngineHost::addInstanceFromFile(const std::string& filePath, bool startAfterLoad) {
+    auto added = addInstance(std::filesystem::path(filePath).stem().string());
+    if (added.isError()) {
+        return added;
+    }
+
+    Instance& instance = *instances_[added.value()];
+    // RunIds restart at 1 per Engine; use the device id so they stay unique
+    // across instances and RunId routing is unambiguous.
+    auto load = instance.engine->loadAutomataFromFile(filePath,
+                                                      protocolv2::LoadReplaceMode::HardReset,
+                                                      startAfterLoad,
+                                                      static_cast<RunId>(instance.engine->deviceId()));
+    if (load.isError()) {
+        instances_.pop_back();
+        return Result<size_t>::error(filePath + ": " + load.error());
+    }
+    instance.runId.store(instance.engine->activeRunId(), std::memory_order_relaxed);
+    instance.peerLinks.store(instance.engine->peerLinks().linkCount(), std::memory_order_relaxed);
+    instance.running.store(instance.engine->isRunning(), std::memory_order_release);
+    return added;
+}
+
+size_t EngineHost::route(std::unique_ptr<protocol::Message> message) {
+    if (!message || instances_.empty()) {
+        return 0;
+    }
+
+    if (message->targetId != 0) {
+        for (auto& instance : instances_) {
+            if (instance->deviceId.load(std::memory_order_acquire) == message->targetId) {
+                deliver(*instance, std::move(message));
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    const auto runId = Engine::extractRunId(*message);
+    if (runId && *runId != 0) {
+        for (auto& instance : instances_) {
+            if (instance->runId.load(std::memory_order_acquire) == *runId) {
+                deliver(*instance, std::move(message));
+                return 1;
+            }
+        }
+    }
+
+    // Broadcast: every instance but the last gets a decoded copy.
+    const auto bytes = message->serialize();
+    for (size_t i = 0; i + 1 < instances_.size(); ++i) {
+        if (auto copy = protocol::MessageFactory::deserialize(bytes)) {
+            copy->sourceId = message->sourceId;
+            copy->targetId = message->targetId;
+            deliver(*instances_[i], std::move(copy));
+        }
+    }
+    deliver(*instances_.back(), std::move(message));
+    return instances_.size();
+}
+
+void EngineHost::deliver(Instance& instance, std::unique_ptr<protocol::Message> message) {
+    std::lock_guard<std::mutex> lock(instance.inboxMutex);
+    instance.inbox.push_back(std::move(message));
+    instance.hasInbox.store(true, std::memory_order_release);
+}
+
+size_t EngineHost::schedule(uint64_t nowUs) {
+    size_t submitted = 0;
+    for (auto& entry : instances_) {
+        Instance& instance = *entry;
+        if (instance.busy.load(std::memory_order_acquire)) {
+            continue;
+        }
+
+        const bool hasInbox = instance.hasInbox.load(std::memory_order_acquire) ||
+                              instance.engine->peerLinks().hasMessage();
+        const bool tickDue = instance.running.load(std::memory_order_acquire) &&
+                             instance.scheduler.due(nowUs, instance.engine->msUntilNextTimer());
+        if (!hasInbox && !tickDue) {
+            continue;
+        }
+
+        instance.busy.store(true, std::memory_order_relaxed);
+        pool_.submit([this, &instance, tickDue] { runInstance(instance, tickDue); });
+        ++submitted;
+    }
+    return submitted;
+}
+
+void EngineHost::runInstance(Instance& instance, bool tickDue) {
+    Engine& engine = *instance.engine;
+
+    std::vector<std::unique_ptr<protocol::Message>> inbox;
+    {
+        std::lock_guard<std::mutex> lock(instance.inboxMutex);
+        inbox.swap(instance.inbox);
+        instance.hasInbox.store(false, std::memory_order_release);
+    }
+    for (auto& message : inbox) {
+        engine.enqueueCommand(std::move(message));
+    }
+    engine.pollPeerLinks(PEER_INPUT_BATCH);
+
+    // Commands (and releasing staged outbound) before the tick, as in the
+    // single-engine loop.
+    Replies replies = engine.processCommandQueue();
+
+    if (tickDue && engine.isRunning()) {
+        const uint64_t begin = steadyUs();
+        engine.tick();
+        const uint64_t end = steadyUs();
+        instance.scheduler.ticked(end);
+
+        const uint64_t elapsed = end - begin;
+        instance.lastTickUs.store(elapsed, std::memory_order_relaxed);
+        instance.totalTickUs.store(instance.totalTickUs.load(std::memory_order_relaxed) + elapsed,
+                                   std::memory_order_relaxed);
+        if (elapsed > instance.maxTickUs.load(std::memory_order_relaxed)) {
+            instance.maxTickUs.store(elapsed, std::memory_order_relaxed);
+        }
+        const uint64_t ticks = instance.ticks.load(std::memory_order_relaxed) + 1;
+        instance.ticks.store(ticks, std::memory_order_relaxed);
+
+        const ScriptMemoryStats memory = engine.scriptMemory();
+        instance.scriptHeapBytes.store(memory.inUse, std::memory_order_relaxed);
+        instance.scriptHeapPeak.store(memory.peak, std::memory_order_relaxed);
+        instance.scriptAllocFailures.store(memory.failures, std::memory_order_relaxed);
+
+        if (maxTicks_ > 0 && engine.status().tickCount >= maxTicks_) {
+            engine.stop();
+        } else {
+            // Step the script collector in part of the slack before this instance's next tick
+            const uint64_t slackUs = instance.scheduler.waitUs(end, engine.msUntilNextTimer(), UINT32_MAX);
+            engine.collectGarbageIdle(static_cast<uint32_t>(slackUs / 2));
+        }
+    }
+
+    // Follow the engine's pacer; input commands tick too, so check after them as well
+    if (engine.tickRate() != instance.scheduler.rate()) {
+        instance.scheduler.retune(engine.tickRate());
+        instance.tickRate.store(engine.tickRate(), std::memory_order_relaxed);
+    }
+
+    instance.deviceId.store(engine.deviceId(), std::memory_order_release);
+    instance.runId.store(engine.activeRunId(), std::memory_order_release);
+    instance.peerLinks.store(engine.peerLinks().linkCount(), std::memory_order_release);
+    instance.running.store(engine.isRunning(), std::memory_order_release);
+
+    if (!replies.empty()) {
+        std::lock_guard<std::mutex> lock(repliesMutex_);
+        for (auto& reply : replies) {
+            if (reply) {
+                replies_.push_back(std::move(reply));
+            }
+        }
+    }
+
+    instance.busy.store(false, std::memory_order_release);
+}
+
+uint64_t EngineHost::waitUs(uint64_t nowUs, uint64_t maxWaitUs) {
+    uint64_t wait = maxWaitUs;
+    for (auto& entry : instances_) {
+        Instance& instance = *entry;
+        if (instance.busy.load(std::memory_order_acquire)) {
+            wait = std::min(wait, BUSY_POLL_US);
+            continue;
+        }
+        if (instance.hasInbox.load(std::memory_order_acquire)) {
+            return 0;
+        }
+        if (!instance.running.load(std::memory_order_acquire)) {
+            continue;
+        }
+        wait = std::min(wait, instance.scheduler.waitUs(nowUs, instance.engine->msUntilNextTimer(), wait));
+        if (wait == 0) {
+            return 0;
+        }
+    }
+    return wait;
+}
+
+EngineHost::Replies EngineHost::takeReplies() {
+    std::lock_guard<std::mutex> lock(repliesMutex_);
+    Replies out;
+    out.swap(replies_);
+    return out;
+}
+
+bool EngineHost::anyRunning() const {
+    for (const auto& instance : instances_) {
+        if (instance->running.load(std::memory_order_acquire) ||
+            instance->busy.load(std::memory_order_acquire)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool EngineHost::anyPeerLinks() const {
+    for (const auto& instance : instances_) {
+        if (instance->peerLinks.load(std::memory_order_acquire) > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<HostInstanceStats> EngineHost::stats() const {
+    std::vector<HostInstanceStats> out;
+    out.reserve(instances_.size());
+    for (const auto& instance : instances_) {
+        HostInstanceStats stats;
+        stats.index = instance->index;
+        stats.name = instance->name;
+        stats.deviceId = instance->deviceId.load(std::memory_order_acquire);
+        stats.runId = instance->runId.load(std::memory_order_acquire);
+        stats.ticks = instance->ticks.load(std::memory_order_relaxed);
+        stats.lastTickUs = instance->lastTickUs.load(std::memory_order_relaxed);
+        stats.maxTickUs = instance->maxTickUs.load(std::memory_order_relaxed);
+        stats.totalTickUs = instance->totalTickUs.load(std::memory_order_relaxed);
+        stats.scriptHeapBytes = instance->scriptHeapBytes.load(std::memory_order_relaxed);
+        stats.scriptHeapPeak = instance->scriptHeapPeak.load(std::memory_order_relaxed);
+        stats.scriptAllocFailures = instance->scriptAllocFailures.load(std::memory_order_relaxed);
+        stats.tickRate = instance->tickRate.load(std::memory_order_relaxed);
+        out.push_back(std::move(stats));
+    }
+    return out;
+}
+
+void EngineHost::stopAll() {
+    pool_.waitIdle();
+    for (auto& instance : instances_) {
+        Engine& engine = *instance->engine;
+        if (engine.isRunning() || engine.status().executionState == ExecutionState::Paused) {
+            engine.stop();
+        }
+        instance->running.store(false, std::memory_order_release);
+    }
+}
+
+uint64_t EngineHost::steadyUs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace aeth
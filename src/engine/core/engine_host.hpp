@@ -0,0 +1,181 @@
+/**
+ * Aetherium Automata - Engine Host
+ *
+ * Runs many automata in one process. Each instance is a full Engine (own
+ * Runtime, VariableStore and script state); instance work (commands plus
+ * the next tick) is scheduled on a shared work-stealing pool, and a single
+ * transport is shared by routing messages on targetId/RunId.
+ *
+ * Threading: route(), schedule() and takeReplies() are called from one
+ * host thread. An instance runs on at most one worker at a time; route()
+ * and stats() read the device id and RunId it published after its last
+ * batch, never the engine itself.
+ */
+
+#ifndef AETHERIUM_ENGINE_HOST_HPP
+#define AETHERIUM_ENGINE_HOST_HPP
+
+#include "engine.hpp"
+#include "tick_scheduler.hpp"
+#include "work_stealing_pool.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace aeth {
+
+struct EngineHostOptions {
+    size_t workers = 0;                  // 0 = one per hardware thread
+    DeviceId firstDeviceId = 1;          // Instance i gets firstDeviceId + i
+    EngineInitOptions instanceDefaults;  // deviceId/deviceName set per instance
+    PeerLinks::TransportFactory peerTransportFactory;  // For PEER_WIRING; empty = no peer links
+};
+
+/**
+ * Per-instance tick latency, to spot automata that hog workers
+ */
+struct HostInstanceStats {
+    size_t index = 0;
+    std::string name;
+    DeviceId deviceId = 0;
+    RunId runId = 0;
+    uint64_t ticks = 0;
+    uint64_t lastTickUs = 0;
+    uint64_t maxTickUs = 0;
+    uint64_t totalTickUs = 0;
+    uint64_t scriptHeapBytes = 0;  // Script VM heap after the last tick
+    uint64_t scriptHeapPeak = 0;
+    uint64_t scriptAllocFailures = 0;
+    uint32_t tickRate = 0;  // Scheduled ticks per second; moves with the engine's pacer
+
+    [[nodiscard]] double meanTickUs() const {
+        return ticks > 0 ? static_cast<double>(totalTickUs) / static_cast<double>(ticks) : 0.0;
+    }
+};
+
+class EngineHost {
+public:
+    using Replies = Engine::Replies;
+
+    explicit EngineHost(EngineHostOptions options = {});
+    ~EngineHost();
+
+    EngineHost(const EngineHost&) = delete;
+    EngineHost& operator=(const EngineHost&) = delete;
+
+    /**
+     * Create and initialize an instance; returns its index
+     */
+    Result<size_t> addInstance(const std::string& name);
+
+    /**
+     * Create an instance and load (optionally start) an automata file
+     */
+    Result<size_t> addInstanceFromFile(const std::string& filePath, bool startAfterLoad = true);
+
+    [[nodiscard]] size_t instanceCount() const { return instances_.size(); }
+    [[nodiscard]] size_t workerCount() const { return pool_.workerCount(); }
+
+    /**
+     * Direct access for setup; only safe while no work is scheduled
+     */
+    [[nodiscard]] Engine& instance(size_t index) { return *instances_[index]->engine; }
+
+    /**
+     * Route an inbound message: targetId selects an instance by device id,
+     * otherwise a RunId selects the instance running it, otherwise the
+     * message is delivered to every instance. Returns the delivery count.
+     */
+    size_t route(std::unique_ptr<protocol::Message> message);
+
+    /**
+     * Submit every instance that has inbound commands or a due tick.
+     * Returns the number of instances submitted.
+     */
+    size_t schedule(uint64_t nowUs);
+
+    /**
+     * Microseconds until some instance needs work, capped at maxWaitUs
+     */
+    [[nodiscard]] uint64_t waitUs(uint64_t nowUs, uint64_t maxWaitUs);
+
+    /**
+     * Block until scheduled work has finished
+     */
+    void waitIdle() { pool_.waitIdle(); }
+
+    /**
+     * Collect replies produced by instance commands
+     */
+    Replies takeReplies();
+
+    /**
+     * Stop instances that reached the tick limit (0 = no limit)
+     */
+    void setMaxTicksPerInstance(uint64_t maxTicks) { maxTicks_ = maxTicks; }
+
+    [[nodiscard]] bool anyRunning() const;
+    // Some instance has peer links to poll; safe while instances are scheduled
+    [[nodiscard]] bool anyPeerLinks() const;
+    [[nodiscard]] std::vector<HostInstanceStats> stats() const;
+
+    // Stop every instance (waits for scheduled work first)
+    void stopAll();
+
+private:
+    struct Instance {
+        size_t index = 0;
+        std::string name;
+        std::unique_ptr<Engine> engine;
+        TickScheduler scheduler;
+
+        std::mutex inboxMutex;
+        std::vector<std::unique_ptr<protocol::Message>> inbox;
+        std::atomic<bool> hasInbox{false};
+        std::atomic<bool> busy{false};
+        std::atomic<bool> running{false};
+
+        // Snapshots for route() and stats() on the host thread; the engine's
+        // own fields change under a worker (LoadAutomata sets a new RunId)
+        std::atomic<DeviceId> deviceId{0};
+        std::atomic<RunId> runId{0};
+        std::atomic<size_t> peerLinks{0};
+
+        // Written by the worker running the instance, read by stats()
+        std::atomic<uint64_t> ticks{0};
+        std::atomic<uint64_t> lastTickUs{0};
+        std::atomic<uint64_t> maxTickUs{0};
+        std::atomic<uint64_t> totalTickUs{0};
+        std::atomic<uint64_t> scriptHeapBytes{0};
+        std::atomic<uint64_t> scriptHeapPeak{0};
+        std::atomic<uint64_t> scriptAllocFailures{0};
+        std::atomic<uint32_t> tickRate{0};
+    };
+
+    void deliver(Instance& instance, std::unique_ptr<protocol::Message> message);
+    void runInstance(Instance& instance, bool tickDue);
+    static uint64_t steadyUs();
+
+    // Wait bound while an instance is still on a worker
+    static constexpr uint64_t BUSY_POLL_US = 1000;
+    // Peer messages an instance applies per run on a worker
+    static constexpr size_t PEER_INPUT_BATCH = 64;
+
+    EngineHostOptions options_;
+    std::vector<std::unique_ptr<Instance>> instances_;
+    uint64_t maxTicks_ = 0;
+
+    std::mutex repliesMutex_;
+    Replies replies_;
+
+    // Declared last: workers are joined before instances are destroyed
+    WorkStealingPool pool_;
+};
+
+} // namespace aeth
+
+#endif // AETHERIUM_ENGINE_HOST_HPP
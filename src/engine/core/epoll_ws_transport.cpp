@@ -0,0 +1,787 @@
+/**
+ * Aetherium Automata - Event-Loop WebSocket Transport Implementation
+ */
+
+#include "epoll_ws_transport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace aeth {
+
+namespace {
+
+constexpr uint32_t MIN_BACKOFF_MS = 100;
+constexpr uint32_t MAX_BACKOFF_MS = 5000;  // As the IXWebSocket transport
+constexpr uint64_t CONNECT_TIMEOUT_MS = 5000;
+constexpr uint64_t PING_INTERVAL_MS = 30000;
+constexpr size_t READ_CHUNK = 64 * 1024;
+constexpr size_t MAX_HANDSHAKE_BYTES = 16 * 1024;
+
+constexpr uint8_t OP_CONTINUATION = 0x0;
+constexpr uint8_t OP_TEXT = 0x1;
+constexpr uint8_t OP_BINARY = 0x2;
+constexpr uint8_t OP_CLOSE = 0x8;
+constexpr uint8_t OP_PING = 0x9;
+constexpr uint8_t OP_PONG = 0xA;
+
+// SHA-1 for the handshake's Sec-WebSocket-Accept check (RFC 6455 4.2.2)
+std::array<uint8_t, 20> sha1(const std::string& input) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    std::vector<uint8_t> data(input.begin(), input.end());
+    const uint64_t bits = static_cast<uint64_t>(data.size()) * 8;
+    data.push_back(0x80);
+    while (data.size() % 64 != 56) {
+        data.push_back(0);
+    }
+    for (int i = 7; i >= 0; --i) {
+        data.push_back(static_cast<uint8_t>(bits >> (i * 8)));
+    }
+    auto rotl = [](uint32_t v, int n) { return (v << n) | (v >> (32 - n)); };
+    for (size_t block = 0; block < data.size(); block += 64) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = (uint32_t{data[block + i * 4]} << 24) | (uint32_t{data[block + i * 4 + 1]} << 16) |
+                   (uint32_t{data[block + i * 4 + 2]} << 8) | uint32_t{data[block + i * 4 + 3]};
+        }
+        for (int i = 16; i < 80; ++i) {
+            w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; ++i) {
+            uint32_t f;
+            uint32_t k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            const uint32_t temp = rotl(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = rotl(b, 30);
+            b = a;
+            a = temp;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+    std::array<uint8_t, 20> digest{};
+    for (int i = 0; i < 20; ++i) {
+        digest[i] = static_cast<uint8_t>(h[i / 4] >> (24 - (i % 4) * 8));
+    }
+    return digest;
+}
+
+std::string base64(const uint8_t* data, size_t len) {
+    static constexpr char TABLE[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((len + 2) / 3 * 4);
+    for (size_t i = 0; i < len; i += 3) {
+        const uint32_t chunk = (uint32_t{data[i]} << 16) | (i + 1 < len ? uint32_t{data[i + 1]} << 8 : 0) |
+                               (i + 2 < len ? uint32_t{data[i + 2]} : 0);
+        out.push_back(TABLE[(chunk >> 18) & 0x3F]);
+        out.push_back(TABLE[(chunk >> 12) & 0x3F]);
+        out.push_back(i + 1 < len ? TABLE[(chunk >> 6) & 0x3F] : '=');
+        out.push_back(i + 2 < len ? TABLE[chunk & 0x3F] : '=');
+    }
+    return out;
+}
+
+uint64_t xorshift(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+uint64_t seedFromDevice() {
+    std::random_device device;
+    const uint64_t seed = (uint64_t{device()} << 32) | device();
+    return seed != 0 ? seed : 0x9E3779B97F4A7C15ull;
+}
+
+// Value of header `name` (case-insensitive) in an HTTP response head
+std::string headerValue(const std::string& head, const std::string& name) {
+    size_t lineStart = head.find("\r\n");
+    while (lineStart != std::string::npos && lineStart + 2 < head.size()) {
+        lineStart += 2;
+        const size_t lineEnd = head.find("\r\n", lineStart);
+        const std::string line = head.substr(lineStart, lineEnd - lineStart);
+        const size_t colon = line.find(':');
+        if (colon == name.size() &&
+            std::equal(name.begin(), name.end(), line.begin(), [](char a, char b) {
+                return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+            })) {
+            const size_t valueStart = line.find_first_not_of(' ', colon + 1);
+            return valueStart == std::string::npos ? std::string() : line.substr(valueStart);
+        }
+        lineStart = lineEnd;
+    }
+    return {};
+}
+
+} // namespace
+
+EpollWebSocketTransport::EpollWebSocketTransport(std::string url, IoEventLoop& loop)
+    : url_(std::move(url)), loop_(loop), rng_(seedFromDevice()), maskState_(seedFromDevice()) {}
+
+EpollWebSocketTransport::~EpollWebSocketTransport() {
+    disconnect();
+}
+
+Result<void> EpollWebSocketTransport::connect() {
+    if (attached_) {
+        return Result<void>::ok();
+    }
+    static constexpr const char* SCHEME = "ws://";
+    if (url_.rfind(SCHEME, 0) != 0) {
+        return Result<void>::error("event-loop WebSocket transport supports ws:// URLs only: " + url_);
+    }
+    const std::string rest = url_.substr(std::strlen(SCHEME));
+    const size_t slash = rest.find('/');
+    const std::string authority = rest.substr(0, slash);
+    path_ = slash == std::string::npos ? "/" : rest.substr(slash);
+    if (!authority.empty() && authority.front() == '[') {
+        // [v6-literal]:port
+        const size_t close = authority.find(']');
+        if (close == std::string::npos) {
+            return Result<void>::error("malformed host in " + url_);
+        }
+        host_ = authority.substr(1, close - 1);
+        port_ = close + 1 < authority.size() && authority[close + 1] == ':' ? authority.substr(close + 2) : "80";
+    } else {
+        const size_t colon = authority.rfind(':');
+        host_ = authority.substr(0, colon);
+        port_ = colon == std::string::npos ? "80" : authority.substr(colon + 1);
+    }
+    if (host_.empty() || port_.empty()) {
+        return Result<void>::error("malformed host in " + url_);
+    }
+
+    std::cout << "[WS] Connecting to " << url_ << " (event loop)" << std::endl;
+    state_ = TransportState::Connecting;
+    notifyStateChange(state_);
+    attached_ = true;
+    loop_.add(*this);
+    return Result<void>::ok();
+}
+
+void EpollWebSocketTransport::disconnect() {
+    if (!attached_) {
+        return;
+    }
+    loop_.remove(*this);
+    attached_ = false;
+    state_ = TransportState::Disconnected;
+    notifyStateChange(state_);
+    {
+        // Wake a consumer blocked in waitForMessage
+        std::lock_guard<std::mutex> lock(waitMutex_);
+        cv_.notify_all();
+    }
+    std::cout << "[WS] Disconnected" << std::endl;
+}
+
+// ============================================================================
+// I/O thread
+// ============================================================================
+
+void EpollWebSocketTransport::onAttach() {
+    backoffMs_ = 0;
+    startConnect();
+}
+
+void EpollWebSocketTransport::onDetach() {
+    closeSocket();
+    phase_ = Phase::Idle;
+    setDeadline(0);
+}
+
+void EpollWebSocketTransport::startConnect() {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* results = nullptr;
+    // Blocks this I/O thread for a DNS lookup; numeric hosts return at once
+    const int lookup = getaddrinfo(host_.c_str(), port_.c_str(), &hints, &results);
+    if (lookup != 0 || results == nullptr) {
+        return fail("resolve " + host_ + ": " + gai_strerror(lookup));
+    }
+
+    int fd = -1;
+    int error = 0;
+    for (addrinfo* candidate = results; candidate != nullptr; candidate = candidate->ai_next) {
+        fd = ::socket(candidate->ai_family, candidate->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                      candidate->ai_protocol);
+        if (fd < 0) {
+            error = errno;
+            continue;
+        }
+        if (::connect(fd, candidate->ai_addr, candidate->ai_addrlen) == 0 || errno == EINPROGRESS) {
+            break;
+        }
+        error = errno;
+        ::close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(results);
+    if (fd < 0) {
+        return fail("connect " + host_ + ":" + port_ + ": " + std::strerror(error));
+    }
+
+    const int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    {
+        std::lock_guard<std::mutex> lock(sendMutex_);
+        fd_ = fd;
+        writable_ = false;
+        wantWrite_ = true;
+        outBuffer_.clear();
+        outPos_ = 0;
+    }
+    inBuffer_.clear();
+    inPos_ = 0;
+    fragment_.clear();
+    phase_ = Phase::Connecting;
+    watch(fd, EPOLLOUT | EPOLLRDHUP);
+    setDeadline(IoEventLoop::nowMs() + CONNECT_TIMEOUT_MS);
+}
+
+void EpollWebSocketTransport::closeSocket() {
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    if (fd_ >= 0) {
+        unwatch(fd_);
+        ::close(fd_);
+        fd_ = -1;
+    }
+    writable_ = false;
+    wantWrite_ = false;
+    outBuffer_.clear();
+    outPos_ = 0;
+}
+
+void EpollWebSocketTransport::fail(const std::string& reason) {
+    closeSocket();
+    if (backoffMs_ == 0) {
+        // First failure since the last good connection; retries stay quiet
+        std::cerr << "[WS] " << url_ << ": " << reason << std::endl;
+    }
+    state_ = TransportState::Error;
+    notifyStateChange(state_);
+
+    // Exponential backoff with jitter, reset by a successful handshake
+    backoffMs_ = backoffMs_ == 0 ? MIN_BACKOFF_MS : std::min(backoffMs_ * 2, MAX_BACKOFF_MS);
+    const uint32_t jitter = static_cast<uint32_t>(xorshift(rng_) % (backoffMs_ / 4 + 1));
+    phase_ = Phase::Backoff;
+    setDeadline(IoEventLoop::nowMs() + backoffMs_ + jitter);
+}
+
+void EpollWebSocketTransport::onTimer(uint64_t nowMs) {
+    switch (phase_) {
+        case Phase::Backoff:
+            reconnects_.fetch_add(1, std::memory_order_relaxed);
+            state_ = TransportState::Connecting;
+            notifyStateChange(state_);
+            startConnect();
+            break;
+        case Phase::Connecting:
+        case Phase::Handshake:
+            fail("connection timed out");
+            break;
+        case Phase::Open: {
+            std::lock_guard<std::mutex> lock(sendMutex_);
+            queueFrameLocked(OP_PING, nullptr, 0);
+            flushLocked();
+            setDeadline(nowMs + PING_INTERVAL_MS);
+            break;
+        }
+        case Phase::Idle:
+            break;
+    }
+}
+
+void EpollWebSocketTransport::onIo(uint32_t events) {
+    if (phase_ == Phase::Connecting) {
+        int error = 0;
+        socklen_t length = sizeof(error);
+        getsockopt(fd_, SOL_SOCKET, SO_ERROR, &error, &length);
+        if (error != 0 || (events & (EPOLLERR | EPOLLHUP))) {
+            return fail("connect " + host_ + ":" + port_ + ": " + std::strerror(error != 0 ? error : ECONNREFUSED));
+        }
+        if (!(events & EPOLLOUT)) {
+            return;
+        }
+        uint8_t nonce[16];
+        for (size_t i = 0; i < sizeof(nonce); i += 8) {
+            const uint64_t bits = xorshift(rng_);
+            std::memcpy(nonce + i, &bits, 8);
+        }
+        handshakeKey_ = base64(nonce, sizeof(nonce));
+        const std::string request = "GET " + path_ + " HTTP/1.1\r\n"
+                                    "Host: " + host_ + ":" + port_ + "\r\n"
+                                    "Upgrade: websocket\r\n"
+                                    "Connection: Upgrade\r\n"
+                                    "Sec-WebSocket-Key: " + handshakeKey_ + "\r\n"
+                                    "Sec-WebSocket-Version: 13\r\n\r\n";
+        phase_ = Phase::Handshake;
+        std::lock_guard<std::mutex> lock(sendMutex_);
+        outBuffer_.assign(request.begin(), request.end());
+        outPos_ = 0;
+        flushLocked();
+        return;
+    }
+
+    if (events & EPOLLOUT) {
+        std::lock_guard<std::mutex> lock(sendMutex_);
+        flushLocked();
+    }
+    if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+        if (phase_ == Phase::Handshake) {
+            readHandshake();
+        } else if (phase_ == Phase::Open) {
+            readFrames();
+        }
+    }
+}
+
+void EpollWebSocketTransport::onWake() {
+    if (phase_ != Phase::Open) {
+        return;
+    }
+    // The consumer made room: hand over the held message, finish the
+    // buffered bytes, then listen to the socket again
+    if (!readPaused_.load(std::memory_order_acquire) || (stalled_ && !inRing_.tryPush(std::move(stalled_)))) {
+        return;
+    }
+    stalled_.reset();
+    readPaused_.store(false, std::memory_order_release);
+    notifyConsumer();
+    if (parseFrames()) {
+        updateInterest();
+    }
+}
+
+void EpollWebSocketTransport::readHandshake() {
+    uint8_t chunk[4096];
+    while (true) {
+        const ssize_t got = ::read(fd_, chunk, sizeof(chunk));
+        if (got > 0) {
+            inBuffer_.insert(inBuffer_.end(), chunk, chunk + got);
+            continue;
+        }
+        if (got == 0) {
+            return fail("connection closed during handshake");
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        if (errno != EINTR) {
+            return fail(std::string("read: ") + std::strerror(errno));
+        }
+    }
+
+    static constexpr char END[] = "\r\n\r\n";
+    const auto end = std::search(inBuffer_.begin(), inBuffer_.end(), END, END + 4);
+    if (end == inBuffer_.end()) {
+        if (inBuffer_.size() > MAX_HANDSHAKE_BYTES) {
+            fail("oversized handshake response");
+        }
+        return;
+    }
+    const std::string head(inBuffer_.begin(), end + 4);
+    if (head.rfind("HTTP/1.1 101", 0) != 0) {
+        return fail("handshake refused: " + head.substr(0, head.find("\r\n")));
+    }
+    const auto digest = sha1(handshakeKey_ + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11");
+    if (headerValue(head, "Sec-WebSocket-Accept") != base64(digest.data(), digest.size())) {
+        return fail("handshake accept key mismatch");
+    }
+    inBuffer_.erase(inBuffer_.begin(), end + 4);
+    inPos_ = 0;
+    opened();
+    if (!inBuffer_.empty()) {
+        parseFrames();
+    }
+}
+
+void EpollWebSocketTransport::opened() {
+    phase_ = Phase::Open;
+    backoffMs_ = 0;
+    {
+        std::lock_guard<std::mutex> lock(sendMutex_);
+        writable_ = true;
+    }
+    setDeadline(IoEventLoop::nowMs() + PING_INTERVAL_MS);
+    state_ = TransportState::Connected;
+    notifyStateChange(state_);
+    std::cout << "[WS] Connected to " << url_ << std::endl;
+    if (sendHello_) {
+        sendHelloMessage();
+    }
+}
+
+void EpollWebSocketTransport::readFrames() {
+    if (readPaused_.load(std::memory_order_acquire)) {
+        return;
+    }
+    while (true) {
+        // Compact once the parsed prefix dominates the buffer
+        if (inPos_ > 0 && inPos_ * 2 >= inBuffer_.size()) {
+            inBuffer_.erase(inBuffer_.begin(), inBuffer_.begin() + static_cast<std::ptrdiff_t>(inPos_));
+            inPos_ = 0;
+        }
+        const size_t used = inBuffer_.size();
+        inBuffer_.resize(used + READ_CHUNK);
+        const ssize_t got = ::read(fd_, inBuffer_.data() + used, READ_CHUNK);
+        inBuffer_.resize(used + static_cast<size_t>(std::max<ssize_t>(got, 0)));
+        if (got > 0) {
+            if (!parseFrames() || phase_ != Phase::Open) {
+                return;
+            }
+            continue;
+        }
+        if (got == 0) {
+            return fail("connection closed by peer");
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return;
+        }
+        if (errno != EINTR) {
+            return fail(std::string("read: ") + std::strerror(errno));
+        }
+    }
+}
+
+bool EpollWebSocketTransport::parseFrames() {
+    while (phase_ == Phase::Open) {
+        const uint8_t* p = inBuffer_.data() + inPos_;
+        const size_t available = inBuffer_.size() - inPos_;
+        if (available < 2) {
+            return true;
+        }
+        const bool fin = (p[0] & 0x80) != 0;
+        const uint8_t opcode = p[0] & 0x0F;
+        const bool masked = (p[1] & 0x80) != 0;
+        uint64_t length = p[1] & 0x7F;
+        size_t header = 2;
+        if (length == 126) {
+            if (available < 4) {
+                return true;
+            }
+            length = (uint64_t{p[2]} << 8) | p[3];
+            header = 4;
+        } else if (length == 127) {
+            if (available < 10) {
+                return true;
+            }
+            length = 0;
+            for (int i = 0; i < 8; ++i) {
+                length = (length << 8) | p[2 + i];
+            }
+            header = 10;
+        }
+        if (length > protocol::MAX_MESSAGE_SIZE * 16) {
+            fail("oversized frame");
+            return false;
+        }
+        const size_t maskBytes = masked ? 4 : 0;
+        if (available < header + maskBytes + length) {
+            return true;
+        }
+        uint8_t* payload = inBuffer_.data() + inPos_ + header + maskBytes;
+        if (masked) {
+            const uint8_t* key = p + header;
+            for (size_t i = 0; i < length; ++i) {
+                payload[i] ^= key[i & 3];
+            }
+        }
+        inPos_ += header + maskBytes + static_cast<size_t>(length);
+
+        switch (opcode) {
+            case OP_BINARY:
+            case OP_TEXT:
+            case OP_CONTINUATION:
+                if (opcode != OP_CONTINUATION) {
+                    fragment_.clear();
+                    fragment_.push_back(opcode);  // Remember the message type
+                }
+                if (fragment_.empty()) {
+                    break;  // Continuation without a start
+                }
+                if (!fin) {
+                    fragment_.insert(fragment_.end(), payload, payload + length);
+                    break;
+                }
+                if (fragment_[0] == OP_TEXT) {
+                    std::cout << "[WS] Text: "
+                              << std::string(fragment_.begin() + 1, fragment_.end())
+                              << std::string(payload, payload + length) << std::endl;
+                    fragment_.clear();
+                    break;
+                }
+                if (fragment_.size() == 1) {
+                    fragment_.clear();
+                    if (!deliver(payload, static_cast<size_t>(length))) {
+                        return false;
+                    }
+                } else {
+                    fragment_.insert(fragment_.end(), payload, payload + length);
+                    std::vector<uint8_t> message;
+                    message.swap(fragment_);
+                    if (!deliver(message.data() + 1, message.size() - 1)) {
+                        return false;
+                    }
+                }
+                break;
+            case OP_PING: {
+                std::lock_guard<std::mutex> lock(sendMutex_);
+                queueFrameLocked(OP_PONG, payload, static_cast<size_t>(length));
+                flushLocked();
+                break;
+            }
+            case OP_PONG:
+                break;
+            case OP_CLOSE: {
+                {
+                    std::lock_guard<std::mutex> lock(sendMutex_);
+                    queueFrameLocked(OP_CLOSE, payload, std::min<size_t>(static_cast<size_t>(length), 2));
+                    flushLocked();
+                }
+                fail("connection closed by server");
+                return false;
+            }
+            default:
+                fail("unknown frame opcode");
+                return false;
+        }
+    }
+    return true;
+}
+
+bool EpollWebSocketTransport::deliver(const uint8_t* data, size_t len) {
+    auto message = protocol::MessageFactory::deserialize(data, len);
+    if (!message) {
+        std::cerr << "[WS] Failed to deserialize message, size=" << len << std::endl;
+        return true;
+    }
+    if (message->type() == protocol::MessageType::HelloAck) {
+        assignedId_ = static_cast<const protocol::HelloAckMessage&>(*message).assignedId;
+    }
+    if (!inRing_.tryPush(std::move(message))) {
+        // Ring full: stop reading this socket (TCP backpressure) without
+        // holding up the other connections on this thread.
+        stalled_ = std::move(message);
+        ingressStalls_.fetch_add(1, std::memory_order_relaxed);
+        readPaused_.store(true, std::memory_order_release);
+        updateInterest();
+        notifyConsumer();
+        return false;
+    }
+    notifyConsumer();
+    return true;
+}
+
+void EpollWebSocketTransport::updateInterest() {
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    if (fd_ < 0) {
+        return;
+    }
+    rewatch(fd_, interestLocked());
+}
+
+uint32_t EpollWebSocketTransport::interestLocked() const {
+    uint32_t events = EPOLLRDHUP;
+    if (!readPaused_.load(std::memory_order_acquire)) {
+        events |= EPOLLIN;
+    }
+    if (wantWrite_) {
+        events |= EPOLLOUT;
+    }
+    return events;
+}
+
+// ============================================================================
+// Sending (any thread)
+// ============================================================================
+
+bool EpollWebSocketTransport::queueFrameLocked(uint8_t opcode, const uint8_t* data, size_t len) {
+    if (fd_ < 0 || outBuffer_.size() - outPos_ + len > MAX_PENDING_SEND_BYTES) {
+        return false;
+    }
+    if (outPos_ == outBuffer_.size()) {
+        outBuffer_.clear();
+        outPos_ = 0;
+    }
+    outBuffer_.push_back(static_cast<uint8_t>(0x80 | opcode));
+    if (len < 126) {
+        outBuffer_.push_back(static_cast<uint8_t>(0x80 | len));
+    } else if (len <= 0xFFFF) {
+        outBuffer_.push_back(0x80 | 126);
+        outBuffer_.push_back(static_cast<uint8_t>(len >> 8));
+        outBuffer_.push_back(static_cast<uint8_t>(len));
+    } else {
+        outBuffer_.push_back(0x80 | 127);
+        for (int i = 7; i >= 0; --i) {
+            outBuffer_.push_back(static_cast<uint8_t>(static_cast<uint64_t>(len) >> (i * 8)));
+        }
+    }
+    // Client frames are masked (RFC 6455 5.3)
+    uint8_t key[4];
+    const uint32_t mask = static_cast<uint32_t>(xorshift(maskState_));
+    std::memcpy(key, &mask, sizeof(key));
+    outBuffer_.insert(outBuffer_.end(), key, key + 4);
+    const size_t start = outBuffer_.size();
+    outBuffer_.resize(start + len);
+    for (size_t i = 0; i < len; ++i) {
+        outBuffer_[start + i] = data[i] ^ key[i & 3];
+    }
+    return true;
+}
+
+void EpollWebSocketTransport::flushLocked() {
+    while (fd_ >= 0 && outPos_ < outBuffer_.size()) {
+        const ssize_t wrote = ::send(fd_, outBuffer_.data() + outPos_, outBuffer_.size() - outPos_, MSG_NOSIGNAL);
+        if (wrote > 0) {
+            outPos_ += static_cast<size_t>(wrote);
+            continue;
+        }
+        if (wrote < 0 && errno == EINTR) {
+            continue;
+        }
+        break;  // EAGAIN, or an error the read side will report
+    }
+    const bool pending = fd_ >= 0 && outPos_ < outBuffer_.size();
+    if (pending != wantWrite_ && fd_ >= 0) {
+        wantWrite_ = pending;
+        rewatch(fd_, interestLocked());
+    }
+}
+
+void EpollWebSocketTransport::sendHelloMessage() {
+    protocol::HelloMessage hello;
+    hello.messageId = nextMsgId_++;
+    hello.deviceType = protocol::DeviceType::Desktop;
+    hello.versionMajor = 0;
+    hello.versionMinor = 2;
+    hello.versionPatch = 0;
+    hello.name = deviceName_;
+    hello.capabilities.setLua(true);
+    hello.capabilities.setTimed(true);
+    hello.capabilities.setProbabilistic(true);
+    hello.deployment = helloDeployment_;
+
+    send(std::make_unique<protocol::HelloMessage>(hello));
+}
+
+bool EpollWebSocketTransport::send(std::unique_ptr<protocol::Message> msg) {
+    if (!isConnected()) {
+        return false;
+    }
+    if (msg->messageId == 0) {
+        msg->messageId = nextMsgId_++;
+    }
+    if (msg->sourceId == 0 && assignedId_ != 0 && msg->type() != protocol::MessageType::Hello) {
+        msg->sourceId = assignedId_;
+    }
+
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    sendWriter_.clear();
+    msg->serializeInto(sendWriter_);
+    if (!writable_ || !queueFrameLocked(OP_BINARY, sendWriter_.data(), sendWriter_.size())) {
+        return false;
+    }
+    // Written here when the socket takes it; a remainder arms EPOLLOUT
+    flushLocked();
+    return true;
+}
+
+bool EpollWebSocketTransport::sendRaw(const uint8_t* data, size_t len) {
+    if (!isConnected()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    if (!writable_ || !queueFrameLocked(OP_BINARY, data, len)) {
+        return false;
+    }
+    flushLocked();
+    return true;
+}
+
+// ============================================================================
+// Receiving (engine loop)
+// ============================================================================
+
+void EpollWebSocketTransport::notifyConsumer() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (consumerWaiting_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(waitMutex_);
+        cv_.notify_one();
+    }
+}
+
+void EpollWebSocketTransport::resumeIfPaused() {
+    if (readPaused_.load(std::memory_order_acquire) && attached_) {
+        loop_.wake(*this);
+    }
+}
+
+std::unique_ptr<protocol::Message> EpollWebSocketTransport::receive() {
+    std::unique_ptr<protocol::Message> msg;
+    inRing_.tryPop(msg);
+    resumeIfPaused();
+    return msg;
+}
+
+bool EpollWebSocketTransport::hasMessage() const {
+    return !inRing_.empty();
+}
+
+size_t EpollWebSocketTransport::drain(const MessageCallback& fn, size_t max) {
+    const size_t count = inRing_.drain([&fn](std::unique_ptr<protocol::Message>&& msg) { fn(std::move(msg)); }, max);
+    resumeIfPaused();
+    return count;
+}
+
+bool EpollWebSocketTransport::waitForMessage(std::chrono::microseconds timeout) {
+    if (!inRing_.empty()) {
+        return true;
+    }
+    std::unique_lock<std::mutex> lock(waitMutex_);
+    consumerWaiting_.store(true, std::memory_order_relaxed);
+    // Pairs with the fence in notifyConsumer (no lost wakeup).
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const bool ready = cv_.wait_for(lock, timeout, [this] {
+        return !inRing_.empty() || !attached_;
+    }) && !inRing_.empty();
+    consumerWaiting_.store(false, std::memory_order_relaxed);
+    return ready;
+}
+
+std::string EpollWebSocketTransport::info() const {
+    return "WebSocket Transport (event loop): " + url_;
+}
+
+} // namespace aeth
@@ -0,0 +1,142 @@
+/**
+ * Aetherium Automata - Event-Loop WebSocket Transport
+ *
+ * WebSocket client that runs on a shared IoEventLoop instead of a thread of
+ * its own: connect() returns at once, the handshake, reads, keep-alive and
+ * reconnect backoff all happen on the loop's I/O thread, and decoded frames
+ * land in a per-connection ingress ring the engine loop drains. Plain ws://
+ * only (no TLS). Linux only.
+ */
+
+#ifndef AETHERIUM_EPOLL_WS_TRANSPORT_HPP
+#define AETHERIUM_EPOLL_WS_TRANSPORT_HPP
+
+#include "io_event_loop.hpp"
+#include "spsc_ring.hpp"
+#include "transport.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace aeth {
+
+class EpollWebSocketTransport : public ITransport, private IoChannel {
+public:
+    static constexpr size_t INGRESS_CAPACITY = 4096;
+    static constexpr size_t MAX_PENDING_SEND_BYTES = 4 << 20;  // Sends fail past this backlog
+
+    EpollWebSocketTransport(std::string url, IoEventLoop& loop);
+    ~EpollWebSocketTransport() override;
+
+    EpollWebSocketTransport(const EpollWebSocketTransport&) = delete;
+    EpollWebSocketTransport& operator=(const EpollWebSocketTransport&) = delete;
+
+    // ITransport interface
+    Result<void> connect() override;
+    void disconnect() override;
+    [[nodiscard]] TransportState state() const override { return state_; }
+
+    bool send(std::unique_ptr<protocol::Message> msg) override;
+    bool sendRaw(const uint8_t* data, size_t len) override;
+    std::unique_ptr<protocol::Message> receive() override;
+    [[nodiscard]] bool hasMessage() const override;
+    bool waitForMessage(std::chrono::microseconds timeout) override;
+    [[nodiscard]] bool canWait() const override { return true; }
+    size_t drain(const MessageCallback& fn, size_t max) override;
+    [[nodiscard]] uint32_t assignedId() const override { return assignedId_; }
+
+    [[nodiscard]] std::string info() const override;
+    [[nodiscard]] std::string name() const override { return "websocket-epoll"; }
+
+    void setSendHello(bool on) { sendHello_ = on; }
+    void setDeviceName(const std::string& name) { deviceName_ = name; }
+    void setHelloDeploymentMetadata(protocol::DeploymentMetadataExtension deployment) {
+        helloDeployment_ = std::move(deployment);
+    }
+
+    // Times reading paused because the ingress ring was full
+    [[nodiscard]] uint64_t ingressStalls() const { return ingressStalls_.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t reconnects() const { return reconnects_.load(std::memory_order_relaxed); }
+
+private:
+    enum class Phase : uint8_t { Idle, Connecting, Handshake, Open, Backoff };
+
+    // IoChannel (I/O thread)
+    void onAttach() override;
+    void onIo(uint32_t events) override;
+    void onWake() override;
+    void onTimer(uint64_t nowMs) override;
+    void onDetach() override;
+
+    void startConnect();
+    void fail(const std::string& reason);
+    void closeSocket();
+    void readHandshake();
+    void readFrames();
+    // Parse buffered bytes; false once the ring is full (reading pauses)
+    bool parseFrames();
+    bool deliver(const uint8_t* data, size_t len);
+    void opened();
+    void updateInterest();
+
+    // Any thread; callers hold sendMutex_
+    bool queueFrameLocked(uint8_t opcode, const uint8_t* data, size_t len);
+    [[nodiscard]] uint32_t interestLocked() const;  // epoll mask for the socket
+    void flushLocked();
+    void sendHelloMessage();
+    void notifyConsumer();
+    void resumeIfPaused();
+
+    std::string url_;
+    std::string host_;
+    std::string port_;
+    std::string path_;
+    IoEventLoop& loop_;
+
+    bool sendHello_ = true;
+    std::string deviceName_ = "cpp-engine";
+    protocol::DeploymentMetadataExtension helloDeployment_;
+
+    std::atomic<TransportState> state_{TransportState::Disconnected};
+    bool attached_ = false;
+
+    // I/O thread only
+    Phase phase_ = Phase::Idle;
+    std::string handshakeKey_;
+    std::vector<uint8_t> inBuffer_;
+    size_t inPos_ = 0;
+    std::vector<uint8_t> fragment_;  // Payload of an unfinished fragmented message
+    uint32_t backoffMs_ = 0;
+    uint64_t rng_ = 0;
+
+    // Ingress: I/O thread produces, engine loop consumes. readPaused_ is set
+    // when the ring filled up; the consumer wakes the loop once it drained.
+    SpscRing<std::unique_ptr<protocol::Message>> inRing_{INGRESS_CAPACITY};
+    std::unique_ptr<protocol::Message> stalled_;
+    std::atomic<bool> readPaused_{false};
+    std::mutex waitMutex_;
+    std::condition_variable cv_;
+    std::atomic<bool> consumerWaiting_{false};
+    std::atomic<uint64_t> ingressStalls_{0};
+    std::atomic<uint64_t> reconnects_{0};
+
+    // Guards the socket and the outbound backlog: several threads send
+    std::mutex sendMutex_;
+    int fd_ = -1;
+    bool writable_ = false;       // Handshake done; data frames may go out
+    bool wantWrite_ = false;      // EPOLLOUT armed
+    std::vector<uint8_t> outBuffer_;
+    size_t outPos_ = 0;
+    protocol::ByteWriter sendWriter_;
+    uint64_t maskState_ = 0;
+
+    std::atomic<uint32_t> nextMsgId_{1};
+    std::atomic<uint32_t> assignedId_{0};
+};
+
+} // namespace aeth
+
+#endif // AETHERIUM_EPOLL_WS_TRANSPORT_HPP
@@ -1,8 +1,19 @@
 #include "execution_trace.hpp"
+#include "trace_format.hpp"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
-#include <sstream>
+#include <unordered_map>
+
+#if !defined(ARDUINO) && !defined(AETHERIUM_PLATFORM_MCXN947)
+#define AETHERIUM_TRACE_STREAMING 1
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
 
 namespace aeth {
 
@@ -16,25 +27,235 @@ bool FaultProfile::hasActiveEffects() const {
             (disconnectPeriodMs > 0 && disconnectDurationMs > 0));
 }
 
+namespace {
+
+using namespace trace_format;
+
+void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void putDouble(std::string& out, double value) {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<char>((bits >> (8 * i)) & 0xFF));
+    }
+}
+
+// Appends string and record frames; strings are interned across the whole file
+class TraceBinaryEncoder {
+public:
+    void encode(const TraceRecord& record, std::string& out) {
+        payload_.clear();
+        putVarint(payload_, record.seq);
+
+        uint32_t mask = 0;
+        if (record.messageId) mask |= HasMessageId;
+        if (record.relatedMessageId) mask |= HasRelatedMessageId;
+        if (record.runId) mask |= HasRunId;
+        if (record.receiveTimestamp) mask |= HasReceiveTimestamp;
+        if (record.handleTimestamp) mask |= HasHandleTimestamp;
+        if (record.sendTimestamp) mask |= HasSendTimestamp;
+        if (record.portName) mask |= HasPortName;
+        if (record.portDirection) mask |= HasPortDirection;
+        if (record.observableState) mask |= HasObservableState;
+        if (record.batteryPercent) mask |= HasBatteryPercent;
+        if (record.batteryLow) mask |= HasBatteryLow;
+        if (record.latencyBudgetMs) mask |= HasLatencyBudget;
+        if (record.latencyWarningMs) mask |= HasLatencyWarning;
+        if (record.observedLatencyMs) mask |= HasObservedLatency;
+        if (record.latencyBudgetExceeded) mask |= HasLatencyExceeded;
+        putVarint(payload_, mask);
+
+        for (const std::string* field : {&record.kind, &record.boundary, &record.category, &record.messageType,
+                                         &record.sourceInstance, &record.targetInstance, &record.transport,
+                                         &record.placement}) {
+            putVarint(payload_, intern(*field, out));
+        }
+        putVarint(payload_, record.summary.size());
+        payload_.append(record.summary);
+
+        if (record.messageId) putVarint(payload_, *record.messageId);
+        if (record.relatedMessageId) putVarint(payload_, *record.relatedMessageId);
+        if (record.runId) putVarint(payload_, *record.runId);
+        if (record.receiveTimestamp) putVarint(payload_, *record.receiveTimestamp);
+        if (record.handleTimestamp) putVarint(payload_, *record.handleTimestamp);
+        if (record.sendTimestamp) putVarint(payload_, *record.sendTimestamp);
+        if (record.portName) putVarint(payload_, intern(*record.portName, out));
+        if (record.portDirection) putVarint(payload_, intern(*record.portDirection, out));
+        if (record.observableState) putVarint(payload_, intern(*record.observableState, out));
+        if (record.batteryPercent) putDouble(payload_, *record.batteryPercent);
+        if (record.batteryLow) payload_.push_back(*record.batteryLow ? 1 : 0);
+        if (record.latencyBudgetMs) putVarint(payload_, *record.latencyBudgetMs);
+        if (record.latencyWarningMs) putVarint(payload_, *record.latencyWarningMs);
+        if (record.observedLatencyMs) putVarint(payload_, *record.observedLatencyMs);
+        if (record.latencyBudgetExceeded) payload_.push_back(*record.latencyBudgetExceeded ? 1 : 0);
+
+        putVarint(payload_, record.faultActions.size());
+        for (const auto& action : record.faultActions) {
+            putVarint(payload_, intern(action, out));
+        }
+
+        out.push_back(static_cast<char>(FRAME_RECORD));
+        putVarint(out, payload_.size());
+        out.append(payload_);
+    }
+
+private:
+    uint32_t intern(const std::string& text, std::string& out) {
+        auto it = ids_.find(text);
+        if (it != ids_.end()) {
+            return it->second;
+        }
+        const auto id = static_cast<uint32_t>(ids_.size());
+        ids_.emplace(text, id);
+        out.push_back(static_cast<char>(FRAME_STRING));
+        putVarint(out, text.size());
+        out.append(text);
+        return id;
+    }
+
+    std::unordered_map<std::string, uint32_t> ids_;
+    std::string payload_;
+};
+
+} // namespace
+
+#if defined(AETHERIUM_TRACE_STREAMING)
+class TraceStreamWriter {
+public:
+    explicit TraceStreamWriter(std::ofstream out) : out_(std::move(out)), thread_([this] { run(); }) {}
+
+    ~TraceStreamWriter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        thread_.join();
+    }
+
+    void push(const TraceRecord& record) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back(record);
+        ++pushed_;
+        if (pending_.size() == 1) {
+            wake_.notify_one();
+        }
+    }
+
+    Result<void> flush() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        written_cv_.wait(lock, [this] { return written_ == pushed_; });
+        if (!error_.empty()) {
+            return Result<void>::error(error_);
+        }
+        return Result<void>::ok();
+    }
+
+private:
+    void run() {
+        std::vector<TraceRecord> batch;
+        std::string buffer;
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            wake_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+            if (pending_.empty()) {
+                return;
+            }
+            batch.swap(pending_);
+            lock.unlock();
+
+            buffer.clear();
+            for (const auto& record : batch) {
+                encoder_.encode(record, buffer);
+            }
+            out_.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            out_.flush();
+            const bool good = out_.good();
+            const size_t count = batch.size();
+            batch.clear();
+
+            lock.lock();
+            if (!good && error_.empty()) {
+                error_ = "failed while writing binary trace";
+            }
+            written_ += count;
+            written_cv_.notify_all();
+        }
+    }
+
+    std::ofstream out_;
+    TraceBinaryEncoder encoder_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable written_cv_;
+    std::vector<TraceRecord> pending_;
+    uint64_t pushed_ = 0;
+    uint64_t written_ = 0;
+    bool stopping_ = false;
+    std::string error_;
+    std::thread thread_;  // Last: starts once everything above is constructed
+};
+#else
+class TraceStreamWriter {
+public:
+    void push(const TraceRecord&) {}
+    Result<void> flush() { return Result<void>::ok(); }
+};
+#endif
+
+LocalTraceStore::LocalTraceStore() = default;
+LocalTraceStore::~LocalTraceStore() = default;
+
 void LocalTraceStore::clear() {
     records_.clear();
+    head_ = 0;
     nextSeq_ = 1;
 }
 
 void LocalTraceStore::push(TraceRecord record) {
-    if (maxRecords_ > 0) {
-        if (records_.size() >= maxRecords_) {
-            // Ring-buffer: evict oldest to stay within limit.
-            records_.erase(records_.begin());
-        }
-    }
     record.seq = nextSeq_++;
+    if (stream_) {
+        stream_->push(record);
+    }
+    if (maxRecords_ > 0 && records_.size() >= maxRecords_) {
+        // Overwrite the oldest slot; its strings keep their capacity
+        records_[head_] = std::move(record);
+        head_ = (head_ + 1) % records_.size();
+        return;
+    }
     records_.push_back(std::move(record));
 }
 
-Result<void> LocalTraceStore::writeJsonLines(const std::string& path) const {
-    namespace fs = std::filesystem;
+void LocalTraceStore::setMaxRecords(size_t max) {
+    if (head_ != 0) {
+        std::rotate(records_.begin(), records_.begin() + static_cast<std::ptrdiff_t>(head_), records_.end());
+        head_ = 0;
+    }
+    maxRecords_ = max;
+    if (max > 0 && records_.size() > max) {
+        records_.erase(records_.begin(), records_.end() - static_cast<std::ptrdiff_t>(max));
+    }
+}
 
+std::vector<TraceRecord> LocalTraceStore::records() const {
+    std::vector<TraceRecord> ordered;
+    ordered.reserve(records_.size());
+    ordered.insert(ordered.end(), records_.begin() + static_cast<std::ptrdiff_t>(head_), records_.end());
+    ordered.insert(ordered.end(), records_.begin(), records_.begin() + static_cast<std::ptrdiff_t>(head_));
+    return ordered;
+}
+
+namespace {
+
+Result<void> createParentDirectory(const std::string& path) {
+    namespace fs = std::filesystem;
     std::error_code ec;
     const fs::path outputPath(path);
     if (outputPath.has_parent_path()) {
@@ -43,91 +264,299 @@ Result<void> LocalTraceStore::writeJsonLines(const std::string& path) const {
             return Result<void>::error("failed to create trace directory: " + ec.message());
         }
     }
+    return Result<void>::ok();
+}
+
+} // namespace
+
+Result<void> LocalTraceStore::streamBinary(const std::string& path) {
+#if defined(AETHERIUM_TRACE_STREAMING)
+    closeStream();
+    auto dir = createParentDirectory(path);
+    if (dir.isError()) {
+        return dir;
+    }
+    std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return Result<void>::error("failed to open trace output: " + path);
+    }
+    out.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    if (maxRecords_ == 0) {
+        setMaxRecords(AETHERIUM_TRACE_STREAM_WINDOW);
+    }
+    stream_ = std::make_unique<TraceStreamWriter>(std::move(out));
+    return Result<void>::ok();
+#else
+    (void)path;
+    return Result<void>::error("binary trace streaming is not available on this target");
+#endif
+}
+
+Result<void> LocalTraceStore::flushStream() const {
+    if (!stream_) {
+        return Result<void>::ok();
+    }
+    return stream_->flush();
+}
+
+void LocalTraceStore::closeStream() {
+    stream_.reset();
+}
+
+bool LocalTraceStore::isBinaryTracePath(const std::string& path) {
+    static constexpr char ext[] = ".aetr";
+    constexpr size_t len = sizeof(ext) - 1;
+    return path.size() > len && path.compare(path.size() - len, len, ext) == 0;
+}
+
+Result<void> LocalTraceStore::writeJsonLines(const std::string& path) const {
+    auto dir = createParentDirectory(path);
+    if (dir.isError()) {
+        return dir;
+    }
 
     std::ofstream out(path, std::ios::out | std::ios::trunc);
     if (!out.is_open()) {
         return Result<void>::error("failed to open trace output: " + path);
     }
 
-    for (const auto& record : records_) {
-        std::ostringstream line;
-        line << "{";
-        line << "\"seq\":" << record.seq;
-        line << ",\"kind\":\"" << escapeJson(record.kind) << "\"";
-        line << ",\"boundary\":\"" << escapeJson(record.boundary) << "\"";
-        line << ",\"category\":\"" << escapeJson(record.category) << "\"";
-        line << ",\"summary\":\"" << escapeJson(record.summary) << "\"";
-        line << ",\"message_type\":\"" << escapeJson(record.messageType) << "\"";
-        line << ",\"source_instance\":\"" << escapeJson(record.sourceInstance) << "\"";
-        line << ",\"target_instance\":\"" << escapeJson(record.targetInstance) << "\"";
-        line << ",\"transport\":\"" << escapeJson(record.transport) << "\"";
-        line << ",\"placement\":\"" << escapeJson(record.placement) << "\"";
+    std::string line;
+    auto write = [&](const TraceRecord& record) {
+        line.clear();
+        appendJson(line, record);
+        out << line;
+    };
+    for (size_t i = head_; i < records_.size(); ++i) {
+        write(records_[i]);
+    }
+    for (size_t i = 0; i < head_; ++i) {
+        write(records_[i]);
+    }
+
+    if (!out.good()) {
+        return Result<void>::error("failed while writing trace output: " + path);
+    }
 
-        if (record.messageId) {
-            line << ",\"message_id\":" << *record.messageId;
-        }
-        if (record.relatedMessageId) {
-            line << ",\"related_message_id\":" << *record.relatedMessageId;
-        }
-        if (record.runId) {
-            line << ",\"run_id\":" << *record.runId;
-        }
-        if (record.receiveTimestamp) {
-            line << ",\"receive_timestamp\":" << *record.receiveTimestamp;
-        }
-        if (record.handleTimestamp) {
-            line << ",\"handle_timestamp\":" << *record.handleTimestamp;
+    return Result<void>::ok();
+}
+
+Result<uint64_t> LocalTraceStore::convertBinaryToJsonLines(const std::string& binaryPath,
+                                                           const std::string& jsonPath) {
+    TraceBinaryReader reader;
+    auto opened = reader.open(binaryPath);
+    if (opened.isError()) {
+        return Result<uint64_t>::error(opened.error());
+    }
+    auto dir = createParentDirectory(jsonPath);
+    if (dir.isError()) {
+        return Result<uint64_t>::error(dir.error());
+    }
+    std::ofstream out(jsonPath, std::ios::out | std::ios::trunc);
+    if (!out.is_open()) {
+        return Result<uint64_t>::error("failed to open trace output: " + jsonPath);
+    }
+
+    uint64_t count = 0;
+    TraceRecord record;
+    std::string line;
+    for (;;) {
+        auto more = reader.next(record);
+        if (more.isError()) {
+            return Result<uint64_t>::error(more.error());
         }
-        if (record.sendTimestamp) {
-            line << ",\"send_timestamp\":" << *record.sendTimestamp;
+        if (!more.value()) {
+            break;
         }
-        if (record.portName) {
-            line << ",\"port_name\":\"" << escapeJson(*record.portName) << "\"";
+        line.clear();
+        appendJson(line, record);
+        out << line;
+        ++count;
+    }
+
+    if (!out.good()) {
+        return Result<uint64_t>::error("failed while writing trace output: " + jsonPath);
+    }
+    return Result<uint64_t>::ok(count);
+}
+
+Result<void> TraceBinaryReader::open(const std::string& path) {
+    in_.open(path, std::ios::in | std::ios::binary);
+    if (!in_.is_open()) {
+        return Result<void>::error("failed to open binary trace: " + path);
+    }
+    char magic[sizeof(TRACE_MAGIC)] = {};
+    in_.read(magic, sizeof(magic));
+    if (in_.gcount() != static_cast<std::streamsize>(sizeof(magic)) ||
+        std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0) {
+        return Result<void>::error("not a binary trace: " + path);
+    }
+    strings_.clear();
+    return Result<void>::ok();
+}
+
+Result<bool> TraceBinaryReader::next(TraceRecord& record) {
+    auto readVarint = [this](uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const int ch = in_.get();
+            if (ch == std::char_traits<char>::eof()) {
+                return false;
+            }
+            value |= static_cast<uint64_t>(ch & 0x7F) << shift;
+            if ((ch & 0x80) == 0) {
+                return true;
+            }
         }
-        if (record.portDirection) {
-            line << ",\"port_direction\":\"" << escapeJson(*record.portDirection) << "\"";
+        return false;
+    };
+
+    for (;;) {
+        const int tag = in_.get();
+        if (tag == std::char_traits<char>::eof()) {
+            return Result<bool>::ok(false);
         }
-        if (record.observableState) {
-            line << ",\"observable_state\":\"" << escapeJson(*record.observableState) << "\"";
+        uint64_t len = 0;
+        if (!readVarint(len) || len > MAX_FRAME_BYTES) {
+            return Result<bool>::error("binary trace: bad frame length");
         }
-        if (record.batteryPercent) {
-            line << ",\"battery_percent\":" << *record.batteryPercent;
+        frame_.resize(static_cast<size_t>(len));
+        in_.read(reinterpret_cast<char*>(frame_.data()), static_cast<std::streamsize>(len));
+        if (in_.gcount() != static_cast<std::streamsize>(len)) {
+            return Result<bool>::error("binary trace: truncated frame");
         }
-        if (record.batteryLow) {
-            line << ",\"battery_low\":" << (*record.batteryLow ? "true" : "false");
+
+        if (tag == FRAME_STRING) {
+            strings_.emplace_back(reinterpret_cast<const char*>(frame_.data()), frame_.size());
+            continue;
         }
-        if (record.latencyBudgetMs) {
-            line << ",\"latency_budget_ms\":" << *record.latencyBudgetMs;
+        if (tag != FRAME_RECORD) {
+            continue;  // Unknown frame kinds are skipped
         }
-        if (record.latencyWarningMs) {
-            line << ",\"latency_warning_ms\":" << *record.latencyWarningMs;
+
+        FrameCursor cursor{frame_.data(), frame_.data() + frame_.size()};
+        auto string = [&](std::string& out) {
+            const uint64_t id = cursor.varint();
+            if (id >= strings_.size()) {
+                cursor.ok = false;
+                return;
+            }
+            out = strings_[static_cast<size_t>(id)];
+        };
+        auto optionalString = [&](std::optional<std::string>& out, uint32_t mask, uint32_t bit) {
+            out.reset();
+            if (mask & bit) {
+                out.emplace();
+                string(*out);
+            }
+        };
+
+        record = TraceRecord{};
+        record.seq = cursor.varint();
+        const auto mask = static_cast<uint32_t>(cursor.varint());
+        for (std::string* field : {&record.kind, &record.boundary, &record.category, &record.messageType,
+                                   &record.sourceInstance, &record.targetInstance, &record.transport,
+                                   &record.placement}) {
+            string(*field);
         }
-        if (record.observedLatencyMs) {
-            line << ",\"observed_latency_ms\":" << *record.observedLatencyMs;
+        record.summary = cursor.text(static_cast<size_t>(cursor.varint()));
+
+        if (mask & HasMessageId) record.messageId = static_cast<uint32_t>(cursor.varint());
+        if (mask & HasRelatedMessageId) record.relatedMessageId = static_cast<uint32_t>(cursor.varint());
+        if (mask & HasRunId) record.runId = static_cast<RunId>(cursor.varint());
+        if (mask & HasReceiveTimestamp) record.receiveTimestamp = static_cast<Timestamp>(cursor.varint());
+        if (mask & HasHandleTimestamp) record.handleTimestamp = static_cast<Timestamp>(cursor.varint());
+        if (mask & HasSendTimestamp) record.sendTimestamp = static_cast<Timestamp>(cursor.varint());
+        optionalString(record.portName, mask, HasPortName);
+        optionalString(record.portDirection, mask, HasPortDirection);
+        optionalString(record.observableState, mask, HasObservableState);
+        if (mask & HasBatteryPercent) record.batteryPercent = cursor.float64();
+        if (mask & HasBatteryLow) record.batteryLow = cursor.byte() != 0;
+        if (mask & HasLatencyBudget) record.latencyBudgetMs = static_cast<uint32_t>(cursor.varint());
+        if (mask & HasLatencyWarning) record.latencyWarningMs = static_cast<uint32_t>(cursor.varint());
+        if (mask & HasObservedLatency) record.observedLatencyMs = static_cast<uint32_t>(cursor.varint());
+        if (mask & HasLatencyExceeded) record.latencyBudgetExceeded = cursor.byte() != 0;
+
+        const uint64_t actions = cursor.varint();
+        if (actions > frame_.size()) {
+            cursor.ok = false;
         }
-        if (record.latencyBudgetExceeded) {
-            line << ",\"latency_budget_exceeded\":"
-                 << (*record.latencyBudgetExceeded ? "true" : "false");
+        for (uint64_t i = 0; cursor.ok && i < actions; ++i) {
+            record.faultActions.emplace_back();
+            string(record.faultActions.back());
         }
 
-        line << ",\"fault_actions\":[";
-        for (size_t i = 0; i < record.faultActions.size(); ++i) {
-            if (i > 0) {
-                line << ",";
-            }
-            line << "\"" << escapeJson(record.faultActions[i]) << "\"";
+        if (!cursor.ok) {
+            return Result<bool>::error("binary trace: malformed record");
         }
-        line << "]";
-        line << "}\n";
-
-        out << line.str();
+        return Result<bool>::ok(true);
     }
+}
 
-    if (!out.good()) {
-        return Result<void>::error("failed while writing trace output: " + path);
+void LocalTraceStore::appendJson(std::string& line, const TraceRecord& record) {
+    auto text = [&line](const char* key, const std::string& value) {
+        line += ",\"";
+        line += key;
+        line += "\":\"";
+        appendEscaped(line, value);
+        line += '"';
+    };
+    auto number = [&line](const char* key, uint64_t value) {
+        line += ",\"";
+        line += key;
+        line += "\":";
+        line += std::to_string(value);
+    };
+    auto flag = [&line](const char* key, bool value) {
+        line += ",\"";
+        line += key;
+        line += "\":";
+        line += value ? "true" : "false";
+    };
+
+    line += "{\"seq\":";
+    line += std::to_string(record.seq);
+    text("kind", record.kind);
+    text("boundary", record.boundary);
+    text("category", record.category);
+    text("summary", record.summary);
+    text("message_type", record.messageType);
+    text("source_instance", record.sourceInstance);
+    text("target_instance", record.targetInstance);
+    text("transport", record.transport);
+    text("placement", record.placement);
+
+    if (record.messageId) number("message_id", *record.messageId);
+    if (record.relatedMessageId) number("related_message_id", *record.relatedMessageId);
+    if (record.runId) number("run_id", *record.runId);
+    if (record.receiveTimestamp) number("receive_timestamp", *record.receiveTimestamp);
+    if (record.handleTimestamp) number("handle_timestamp", *record.handleTimestamp);
+    if (record.sendTimestamp) number("send_timestamp", *record.sendTimestamp);
+    if (record.portName) text("port_name", *record.portName);
+    if (record.portDirection) text("port_direction", *record.portDirection);
+    if (record.observableState) text("observable_state", *record.observableState);
+    if (record.batteryPercent) {
+        // %g matches the default ostream formatting the format was defined with
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%g", *record.batteryPercent);
+        line += ",\"battery_percent\":";
+        line += buf;
     }
+    if (record.batteryLow) flag("battery_low", *record.batteryLow);
+    if (record.latencyBudgetMs) number("latency_budget_ms", *record.latencyBudgetMs);
+    if (record.latencyWarningMs) number("latency_warning_ms", *record.latencyWarningMs);
+    if (record.observedLatencyMs) number("observed_latency_ms", *record.observedLatencyMs);
+    if (record.latencyBudgetExceeded) flag("latency_budget_exceeded", *record.latencyBudgetExceeded);
 
-    return Result<void>::ok();
+    line += ",\"fault_actions\":[";
+    for (size_t i = 0; i < record.faultActions.size(); ++i) {
+        if (i > 0) {
+            line += ',';
+        }
+        line += '"';
+        appendEscaped(line, record.faultActions[i]);
+        line += '"';
+    }
+    line += "]}\n";
 }
 
 const char* LocalTraceStore::messageTypeName(protocol::MessageType type) {
@@ -148,12 +577,20 @@ const char* LocalTraceStore::messageTypeName(protocol::MessageType type) {
         case MessageType::Status: return "status";
         case MessageType::Pause: return "pause";
         case MessageType::Resume: return "resume";
+        case MessageType::SymbolTable: return "symbol_table";
+        case MessageType::PeerWiring: return "peer_wiring";
         case MessageType::Input: return "input";
+        case MessageType::InputBatch: return "input_batch";
         case MessageType::Output: return "output";
         case MessageType::Variable: return "variable";
         case MessageType::StateChange: return "state_change";
         case MessageType::Telemetry: return "telemetry";
         case MessageType::TransitionFired: return "transition_fired";
+        case MessageType::TelemetryDelta: return "telemetry_delta";
+        case MessageType::TelemetryAck: return "telemetry_ack";
+        case MessageType::Profile: return "profile";
+        case MessageType::OutputBatch: return "output_batch";
+        case MessageType::OutputAggregate: return "output_aggregate";
         case MessageType::Vendor: return "vendor";
         case MessageType::Debug: return "debug";
         case MessageType::Error: return "error";
@@ -163,35 +600,33 @@ const char* LocalTraceStore::messageTypeName(protocol::MessageType type) {
     }
 }
 
-std::string LocalTraceStore::escapeJson(const std::string& input) {
-    std::ostringstream out;
+void LocalTraceStore::appendEscaped(std::string& out, const std::string& input) {
     for (char ch : input) {
         switch (ch) {
             case '\\':
-                out << "\\\\";
+                out += "\\\\";
                 break;
             case '"':
-                out << "\\\"";
+                out += "\\\"";
                 break;
             case '\n':
-                out << "\\n";
+                out += "\\n";
                 break;
             case '\r':
-                out << "\\r";
+                out += "\\r";
                 break;
             case '\t':
-                out << "\\t";
+                out += "\\t";
                 break;
             default:
                 if (static_cast<unsigned char>(ch) < 0x20) {
-                    out << "?";
+                    out += '?';
                 } else {
-                    out << ch;
+                    out += ch;
                 }
                 break;
         }
     }
-    return out.str();
 }
 
 } // namespace aeth
@@ -2,13 +2,21 @@
 #define AETHERIUM_EXECUTION_TRACE_HPP
 
 #include "protocol.hpp"
+#include "tick_pacer.hpp"
 #include "types.hpp"
 
 #include <cstdint>
+#include <fstream>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
+// In-memory window kept when records stream to a binary trace and no cap is set
+#ifndef AETHERIUM_TRACE_STREAM_WINDOW
+#define AETHERIUM_TRACE_STREAM_WINDOW 1024
+#endif
+
 namespace aeth {
 
 struct BatteryProfile {
@@ -33,6 +41,7 @@ struct DeploymentDescriptor {
     std::string targetClass = "host-runtime";
     BatteryProfile battery;
     LatencyProfile latency;
+    PacingProfile pacing;  // Adaptive tick rate bounds (TickPacer)
 };
 
 struct FaultProfile {
@@ -59,6 +68,26 @@ struct FaultDecision {
     std::vector<std::string> actions;
 };
 
+// Outcomes of the fault decisions taken while a profile was active
+struct FaultStats {
+    uint64_t decisions = 0;
+    uint64_t delayed = 0;
+    uint64_t dropped = 0;       // Drop probability
+    uint64_t degraded = 0;      // Missed the success probability
+    uint64_t disconnected = 0;  // Inside a disconnect window
+    uint64_t duplicated = 0;
+
+    FaultStats& operator+=(const FaultStats& other) {
+        decisions += other.decisions;
+        delayed += other.delayed;
+        dropped += other.dropped;
+        degraded += other.degraded;
+        disconnected += other.disconnected;
+        duplicated += other.duplicated;
+        return *this;
+    }
+};
+
 struct TraceRecord {
     uint64_t seq = 0;
     std::string kind;
@@ -88,26 +117,78 @@ struct TraceRecord {
     std::vector<std::string> faultActions;
 };
 
+/**
+ * Binary trace (".aetr"): the magic "AETHTR01", then frames of a tag byte
+ * and a varint length. A string frame (tag 1) defines the next id in the
+ * string table; a record frame (tag 2) holds one TraceRecord with the
+ * repetitive fields as string ids, the summary inline, and optional fields
+ * behind a presence mask. Integers are LEB128 varints, doubles raw
+ * little-endian.
+ */
+class TraceBinaryReader {
+public:
+    Result<void> open(const std::string& path);
+
+    // Reads the next record; false once the file ends cleanly
+    Result<bool> next(TraceRecord& record);
+
+private:
+    std::ifstream in_;
+    std::vector<std::string> strings_;
+    std::vector<uint8_t> frame_;
+};
+
+class TraceStreamWriter;
+
 class LocalTraceStore {
 public:
+    LocalTraceStore();
+    ~LocalTraceStore();
+
+    LocalTraceStore(const LocalTraceStore&) = delete;
+    LocalTraceStore& operator=(const LocalTraceStore&) = delete;
+
     void clear();
     void push(TraceRecord record);
 
     // Limit the number of records retained. 0 = unlimited; N>0 = ring buffer keeping newest N.
-    void setMaxRecords(size_t max) { maxRecords_ = max; }
-
-    [[nodiscard]] const std::vector<TraceRecord>& records() const { return records_; }
+    void setMaxRecords(size_t max);
+
+    /**
+     * Also append every pushed record to a binary trace at `path`, encoded
+     * and written by a background thread. Unless a cap is set, memory then
+     * keeps only the newest AETHERIUM_TRACE_STREAM_WINDOW records. Host
+     * builds only.
+     */
+    Result<void> streamBinary(const std::string& path);
+    // Waits until every record pushed so far is on disk
+    Result<void> flushStream() const;
+    void closeStream();
+    [[nodiscard]] bool streaming() const { return stream_ != nullptr; }
+
+    // Retained records, oldest first
+    [[nodiscard]] std::vector<TraceRecord> records() const;
+    [[nodiscard]] size_t size() const { return records_.size(); }
+    // Records pushed since clear(), including evicted ones
+    [[nodiscard]] uint64_t totalRecorded() const { return nextSeq_ - 1; }
 
     Result<void> writeJsonLines(const std::string& path) const;
 
     static const char* messageTypeName(protocol::MessageType type);
+    static bool isBinaryTracePath(const std::string& path);
+    // Rewrites a binary trace as the JSONL that writeJsonLines produces; returns the record count
+    static Result<uint64_t> convertBinaryToJsonLines(const std::string& binaryPath, const std::string& jsonPath);
 
 private:
-    static std::string escapeJson(const std::string& input);
+    static void appendJson(std::string& line, const TraceRecord& record);
+    static void appendEscaped(std::string& out, const std::string& input);
 
     uint64_t nextSeq_ = 1;
     size_t maxRecords_ = 0;  // 0 = unlimited
+    // Capped mode is a ring: once full, head_ is the oldest record and the next to be overwritten
     std::vector<TraceRecord> records_;
+    size_t head_ = 0;
+    std::unique_ptr<TraceStreamWriter> stream_;
 };
 
 } // namespace aeth
@@ -0,0 +1,295 @@
+#include "flash_automata.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <sstream>
+#include <utility>
+
+namespace aeth {
+
+namespace {
+
+const char* flashTypeName(ValueType type) {
+    switch (type) {
+        case ValueType::Bool: return "Bool";
+        case ValueType::Int32: return "Int32";
+        case ValueType::Int64: return "Int64";
+        case ValueType::Float32: return "Float32";
+        case ValueType::Float64: return "Float64";
+        default: return nullptr;  // Not representable in the tables
+    }
+}
+
+const char* directionName(VariableDirection direction) {
+    switch (direction) {
+        case VariableDirection::Input: return "Input";
+        case VariableDirection::Output: return "Output";
+        case VariableDirection::Internal: return "Internal";
+    }
+    return "Internal";
+}
+
+const char* kindName(ir::BytecodeTransitionKind kind) {
+    switch (kind) {
+        case ir::BytecodeTransitionKind::Immediate: return "Immediate";
+        case ir::BytecodeTransitionKind::TimedAfter: return "TimedAfter";
+        case ir::BytecodeTransitionKind::ClassicCondition: return "ClassicCondition";
+        case ir::BytecodeTransitionKind::EventSignal: return "EventSignal";
+        case ir::BytecodeTransitionKind::TimedTimeout: return "TimedTimeout";
+    }
+    return "Immediate";
+}
+
+const char* triggerName(EventTrigger trigger) {
+    switch (trigger) {
+        case EventTrigger::OnChange: return "OnChange";
+        case EventTrigger::OnRise: return "OnRise";
+        case EventTrigger::OnFall: return "OnFall";
+        case EventTrigger::OnThreshold: return "OnThreshold";
+        case EventTrigger::OnMatch: return "OnMatch";
+    }
+    return "OnChange";
+}
+
+const char* compareName(CompareOp op) {
+    switch (op) {
+        case CompareOp::Eq: return "Eq";
+        case CompareOp::Ne: return "Ne";
+        case CompareOp::Lt: return "Lt";
+        case CompareOp::Le: return "Le";
+        case CompareOp::Gt: return "Gt";
+        case CompareOp::Ge: return "Ge";
+    }
+    return "Gt";
+}
+
+bool isIdentifier(std::string_view text) {
+    if (text.empty() || std::isdigit(static_cast<unsigned char>(text.front()))) {
+        return false;
+    }
+    return std::all_of(text.begin(), text.end(), [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    });
+}
+
+std::string cString(std::string_view text) {
+    std::string out = "\"";
+    for (char c : text) {
+        const auto uc = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (uc < 0x20 || uc >= 0x7F) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\%03o", uc);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+// Round-trips through strtod and always reads as a double literal
+std::string doubleLiteral(double value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.17g", value);
+    std::string out(text);
+    if (out.find_first_of(".en") == std::string::npos) {
+        out += ".0";
+    }
+    return out;
+}
+
+std::string codeLiteral(const FlashCode& code) {
+    return "{" + std::to_string(code.offset) + "u, " + std::to_string(code.size) + "u}";
+}
+
+} // namespace
+
+Result<std::string> emitFlashTables(const ir::EngineBytecodeProgram& source, std::string_view symbol) {
+    using Out = Result<std::string>;
+    if (!isIdentifier(symbol)) {
+        return Out::error("flash tables symbol must be a C++ identifier");
+    }
+
+    ir::EngineBytecodeProgram program = source;
+    auto compiled = compileScriptVmChunks(program);
+    if (compiled.isError()) {
+        return Out::error(compiled.error());
+    }
+
+    // Code blob: every chunk body back to back
+    std::vector<uint8_t> blob;
+    std::map<std::pair<ir::LuaChunkSlot, uint16_t>, FlashCode> codes;
+    uint16_t maxChunkSize = 0;
+    for (const auto& chunk : program.luaChunks) {
+        if (chunk.bytes.size() > 0xFFFF) {
+            return Out::error("flash tables: code block too large");
+        }
+        FlashCode code;
+        code.offset = static_cast<uint32_t>(blob.size());
+        code.size = static_cast<uint16_t>(chunk.bytes.size());
+        maxChunkSize = std::max(maxChunkSize, code.size);
+        blob.insert(blob.end(), chunk.bytes.begin(), chunk.bytes.end());
+        codes[{chunk.slot, chunk.ownerId}] = code;
+    }
+    auto codeOf = [&](ir::LuaChunkSlot slot, uint16_t owner) {
+        auto it = codes.find({slot, owner});
+        return it == codes.end() ? FlashCode{} : it->second;
+    };
+
+    for (const auto& v : program.variables) {
+        if (!flashTypeName(v.type)) {
+            return Out::error("flash tables: variable " + v.name + " is not a number or boolean");
+        }
+    }
+    auto variableByName = [&](const std::string& name) -> const ir::BytecodeVariable* {
+        for (const auto& v : program.variables) {
+            if (v.name == name) return &v;
+        }
+        return nullptr;
+    };
+
+    std::map<StateId, uint16_t> stateIndex;
+    for (const auto& st : program.states) {
+        if (!stateIndex.emplace(st.id, static_cast<uint16_t>(stateIndex.size())).second) {
+            return Out::error("flash tables: duplicate state id");
+        }
+    }
+    auto initial = stateIndex.find(program.initialState);
+    if (initial == stateIndex.end()) {
+        return Out::error("flash tables: initial state not found");
+    }
+
+    // Outgoing transitions per state, in the order the runtime tries them
+    std::vector<const ir::BytecodeTransition*> ordered;
+    for (const auto& t : program.transitions) {
+        if (!t.enabled) {
+            continue;
+        }
+        if (stateIndex.count(t.from) == 0 || stateIndex.count(t.to) == 0) {
+            return Out::error("flash tables: transition references unknown state");
+        }
+        if (t.weight != 100) {
+            return Out::error("flash tables: weighted transitions are not supported");
+        }
+        if (t.kind == ir::BytecodeTransitionKind::ClassicCondition && t.conditionExpression.empty()) {
+            return Out::error("flash tables: classic transition missing condition");
+        }
+        if (t.kind == ir::BytecodeTransitionKind::EventSignal) {
+            if (t.eventTriggerType == EventTrigger::OnMatch) {
+                return Out::error("flash tables: OnMatch events are not supported");
+            }
+            if (!variableByName(t.eventSignalName)) {
+                return Out::error("flash tables: unknown event signal " + t.eventSignalName);
+            }
+        }
+        ordered.push_back(&t);
+    }
+    std::stable_sort(ordered.begin(), ordered.end(), [&](const auto* a, const auto* b) {
+        const uint16_t fromA = stateIndex[a->from];
+        const uint16_t fromB = stateIndex[b->from];
+        if (fromA != fromB) return fromA < fromB;
+        if (a->priority != b->priority) return a->priority < b->priority;
+        return a->id < b->id;
+    });
+
+    std::ostringstream out;
+    out << "// Generated by emitFlashTables from " << cString(program.name) << "; do not edit.\n"
+        << "#pragma once\n\n"
+        << "#include \"engine/core/flash_automata.hpp\"\n\n"
+        << "namespace " << symbol << "_tables {\n\n"
+        << "inline constexpr char kName[] AETHERIUM_FLASH = " << cString(program.name) << ";\n";
+
+    for (size_t i = 0; i < program.variables.size(); ++i) {
+        out << "inline constexpr char kVariable" << i << "[] AETHERIUM_FLASH = "
+            << cString(program.variables[i].name) << ";\n";
+    }
+    for (size_t i = 0; i < program.states.size(); ++i) {
+        out << "inline constexpr char kState" << i << "[] AETHERIUM_FLASH = "
+            << cString(program.states[i].name) << ";\n";
+    }
+
+    if (!blob.empty()) {
+        out << "\ninline constexpr uint8_t kCode[] AETHERIUM_FLASH = {";
+        for (size_t i = 0; i < blob.size(); ++i) {
+            char byte[8];
+            std::snprintf(byte, sizeof(byte), "0x%02X", blob[i]);
+            out << (i % 16 == 0 ? "\n    " : " ") << byte << (i + 1 < blob.size() ? "," : "");
+        }
+        out << "\n};\n";
+    }
+
+    if (!program.variables.empty()) {
+        out << "\ninline constexpr aeth::FlashVariable kVariables[] AETHERIUM_FLASH = {\n";
+        for (size_t i = 0; i < program.variables.size(); ++i) {
+            const auto& v = program.variables[i];
+            const double initial = v.initialValue.type() == ValueType::Void ? 0.0 : v.initialValue.toDouble();
+            if (!std::isfinite(initial)) {
+                return Out::error("flash tables: initial value of " + v.name + " is not finite");
+            }
+            out << "    {" << v.id << ", aeth::ValueType::" << flashTypeName(v.type)
+                << ", aeth::VariableDirection::" << directionName(v.direction)
+                << ", kVariable" << i << ", " << doubleLiteral(initial) << "},\n";
+        }
+        out << "};\n";
+    }
+
+    if (!ordered.empty()) {
+        out << "\ninline constexpr aeth::FlashTransition kTransitions[] AETHERIUM_FLASH = {\n";
+        for (const auto* t : ordered) {
+            const ir::BytecodeVariable* signal = t->kind == ir::BytecodeTransitionKind::EventSignal
+                ? variableByName(t->eventSignalName) : nullptr;
+            const double threshold = t->eventHasThreshold ? t->eventThresholdValue.toDouble() : 0.0;
+            if (!std::isfinite(threshold)) {
+                return Out::error("flash tables: event threshold is not finite");
+            }
+            out << "    {" << t->id << ", " << stateIndex[t->to] << ", aeth::ir::BytecodeTransitionKind::"
+                << kindName(t->kind) << ", " << static_cast<int>(t->priority) << ", " << t->delayMs << "u, "
+                << codeLiteral(codeOf(ir::LuaChunkSlot::TransitionCondition, t->id)) << ", "
+                << codeLiteral(codeOf(ir::LuaChunkSlot::TransitionBody, t->id)) << ", "
+                << codeLiteral(codeOf(ir::LuaChunkSlot::TransitionTriggered, t->id)) << ", "
+                << (signal ? signal->id : INVALID_VARIABLE) << ", aeth::EventTrigger::"
+                << triggerName(t->eventTriggerType) << ", aeth::CompareOp::" << compareName(t->eventThresholdOp)
+                << ", " << doubleLiteral(threshold) << "},\n";
+        }
+        out << "};\n";
+    }
+
+    out << "\ninline constexpr aeth::FlashState kStates[] AETHERIUM_FLASH = {\n";
+    size_t next = 0;
+    for (size_t i = 0; i < program.states.size(); ++i) {
+        const auto& st = program.states[i];
+        const size_t begin = next;
+        while (next < ordered.size() && ordered[next]->from == st.id) {
+            ++next;
+        }
+        out << "    {" << st.id << ", kState" << i << ", "
+            << codeLiteral(codeOf(ir::LuaChunkSlot::StateOnEnter, st.id)) << ", "
+            << codeLiteral(codeOf(ir::LuaChunkSlot::StateBody, st.id)) << ", "
+            << codeLiteral(codeOf(ir::LuaChunkSlot::StateOnExit, st.id)) << ", "
+            << begin << ", " << next << "},\n";
+    }
+    out << "};\n\n} // namespace " << symbol << "_tables\n\n";
+
+    out << "inline constexpr aeth::FlashAutomata " << symbol << " AETHERIUM_FLASH = {\n"
+        << "    " << symbol << "_tables::kName, " << initial->second << ",\n"
+        << "    " << (program.variables.empty() ? "nullptr" : std::string(symbol) + "_tables::kVariables")
+        << ", " << program.variables.size() << ",\n"
+        << "    " << symbol << "_tables::kStates, " << program.states.size() << ",\n"
+        << "    " << (ordered.empty() ? "nullptr" : std::string(symbol) + "_tables::kTransitions")
+        << ", " << ordered.size() << ",\n"
+        << "    " << (blob.empty() ? "nullptr" : std::string(symbol) + "_tables::kCode")
+        << ", " << blob.size() << "u, " << maxChunkSize << "};\n";
+
+    if (program.states.size() > 0xFFFF || ordered.size() > 0xFFFF || program.variables.size() > 0xFFFF) {
+        return Out::error("flash tables: automaton too large");
+    }
+    return Out::ok(out.str());
+}
+
+} // namespace aeth
@@ -0,0 +1,360 @@
+/**
+ * Aetherium Automata - Flash-Resident Automata
+ *
+ * Constant tables describing an automaton, generated at build time
+ * (emitFlashTables, `--emit-flash-tables`) and linked into the firmware,
+ * plus FlashRuntime, which executes straight from them. Names, transition
+ * tables and script VM chunks stay in flash (PROGMEM on AVR, XIP on ESP32
+ * and MCXN947); RAM holds the variables, the current state and one entry
+ * time. Scripts run on the script VM, so the tables need no Lua.
+ *
+ * Covers the bytecode transition kinds except weighted selection and
+ * OnMatch events; the generator rejects anything else.
+ */
+
+#ifndef AETHERIUM_FLASH_AUTOMATA_HPP
+#define AETHERIUM_FLASH_AUTOMATA_HPP
+
+#include "artifact.hpp"
+#include "script_vm.hpp"
+#include "variable.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define AETHERIUM_FLASH PROGMEM
+#else
+#define AETHERIUM_FLASH
+#endif
+
+namespace aeth {
+
+// ============================================================================
+// Tables
+// ============================================================================
+
+// VM chunk body in the code blob; size 0 = no code
+struct FlashCode {
+    uint32_t offset = 0;
+    uint16_t size = 0;
+};
+
+struct FlashVariable {
+    VariableId id = INVALID_VARIABLE;
+    ValueType type = ValueType::Void;
+    VariableDirection direction = VariableDirection::Internal;
+    const char* name = nullptr;  // In flash
+    double initial = 0.0;        // Coerced to `type` at start
+};
+
+struct FlashState {
+    StateId id = INVALID_STATE;
+    const char* name = nullptr;  // In flash
+    FlashCode onEnter;
+    FlashCode body;
+    FlashCode onExit;
+    uint16_t transitionsBegin = 0;  // Outgoing range, sorted by priority
+    uint16_t transitionsEnd = 0;
+};
+
+struct FlashTransition {
+    TransitionId id = INVALID_TRANSITION;
+    uint16_t targetIndex = 0;
+    ir::BytecodeTransitionKind kind = ir::BytecodeTransitionKind::Immediate;
+    uint8_t priority = 0;
+    uint32_t delayMs = 0;
+    FlashCode condition;
+    FlashCode body;
+    FlashCode triggered;
+    VariableId signal = INVALID_VARIABLE;  // Event signal
+    EventTrigger trigger = EventTrigger::OnChange;
+    CompareOp thresholdOp = CompareOp::Gt;
+    double threshold = 0.0;
+};
+
+struct FlashAutomata {
+    const char* name = nullptr;
+    uint16_t initialState = 0;  // Index into states
+    const FlashVariable* variables = nullptr;
+    uint16_t variableCount = 0;
+    const FlashState* states = nullptr;
+    uint16_t stateCount = 0;
+    const FlashTransition* transitions = nullptr;
+    uint16_t transitionCount = 0;
+    const uint8_t* code = nullptr;
+    uint32_t codeSize = 0;
+    uint16_t maxChunkSize = 0;  // Largest chunk; sizes the AVR copy buffer
+};
+
+// Copy a table entry out of flash
+template <typename T>
+inline T flashRead(const T* entry) {
+#if defined(__AVR__)
+    T out;
+    memcpy_P(&out, entry, sizeof(T));
+    return out;
+#else
+    return *entry;
+#endif
+}
+
+inline std::string flashString(const char* text) {
+    if (!text) {
+        return {};
+    }
+#if defined(__AVR__)
+    std::string out(strlen_P(text), '\0');
+    memcpy_P(&out[0], text, out.size());
+    return out;
+#else
+    return text;
+#endif
+}
+
+/**
+ * Generate a C++ header defining `<symbol>` as a FlashAutomata for
+ * `program`. Every code block must compile for the script VM.
+ */
+Result<std::string> emitFlashTables(const ir::EngineBytecodeProgram& program, std::string_view symbol);
+
+// ============================================================================
+// Runtime
+// ============================================================================
+
+class FlashRuntime {
+public:
+    // `tables` is the generated FlashAutomata, itself in flash
+    explicit FlashRuntime(const FlashAutomata* tables) : tables_(flashRead(tables)) {}
+
+    Result<void> start(Timestamp now);
+    void stop() { running_ = false; }
+
+    /**
+     * One tick: fire the first enabled transition of the current state, or
+     * run its body. Returns true if a transition fired.
+     */
+    bool tick(Timestamp now);
+
+    [[nodiscard]] bool isRunning() const { return running_; }
+    [[nodiscard]] StateId currentState() const;
+    [[nodiscard]] std::string currentStateName() const;
+    [[nodiscard]] uint64_t transitionCount() const { return transitionCount_; }
+    [[nodiscard]] const std::string& lastError() const { return lastError_; }
+
+    VariableStore& variables() { return variables_; }
+    const VariableStore& variables() const { return variables_; }
+
+private:
+    bool enabled(const FlashTransition& t, Timestamp now);
+    bool eventTriggered(const FlashTransition& t) const;
+    void fire(const FlashTransition& t, Timestamp now);
+    bool run(const FlashCode& code, ScriptVmResult& result);
+    void execute(const FlashCode& code);
+
+    FlashAutomata tables_;
+    VariableStore variables_;
+    uint16_t current_ = 0;
+    Timestamp enteredAt_ = 0;
+    bool entryTick_ = false;
+    bool running_ = false;
+    uint64_t transitionCount_ = 0;
+    std::string lastError_;
+#if defined(__AVR__)
+    std::vector<uint8_t> chunk_;  // Harvard flash cannot be read in place
+#endif
+};
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+inline Result<void> FlashRuntime::start(Timestamp now) {
+    if (tables_.initialState >= tables_.stateCount) {
+        return Result<void>::error("flash automata has no initial state");
+    }
+
+    variables_.clear();
+    for (uint16_t i = 0; i < tables_.variableCount; ++i) {
+        const FlashVariable v = flashRead(tables_.variables + i);
+        Value initial;
+        if (!detail::vmValue(v.initial, v.type, initial)) {
+            return Result<void>::error("flash variable type unsupported");
+        }
+        variables_.addVariable(VariableSpec(v.id, flashString(v.name), v.type, v.direction, std::move(initial)));
+    }
+#if defined(__AVR__)
+    chunk_.resize(tables_.maxChunkSize);
+#endif
+
+    current_ = tables_.initialState;
+    transitionCount_ = 0;
+    running_ = true;
+    enteredAt_ = now;
+    entryTick_ = true;
+    execute(flashRead(tables_.states + current_).onEnter);
+    return Result<void>::ok();
+}
+
+inline StateId FlashRuntime::currentState() const {
+    return current_ < tables_.stateCount ? flashRead(tables_.states + current_).id : INVALID_STATE;
+}
+
+inline std::string FlashRuntime::currentStateName() const {
+    return current_ < tables_.stateCount ? flashString(flashRead(tables_.states + current_).name) : std::string();
+}
+
+inline bool FlashRuntime::tick(Timestamp now) {
+    if (!running_) {
+        return false;
+    }
+    const FlashState state = flashRead(tables_.states + current_);
+    if (state.transitionsBegin == state.transitionsEnd) {
+        running_ = false;  // Terminal state
+        return false;
+    }
+
+    // Same selection as the full runtime without weights: the first enabled
+    // transition of the best priority group, timeouts only as fallback, and
+    // a pending timed transition holds lower groups back.
+    uint16_t index = state.transitionsBegin;
+    while (index < state.transitionsEnd) {
+        const uint8_t priority = flashRead(tables_.transitions + index).priority;
+        bool hasTimed = false;
+        int fallback = -1;
+        for (; index < state.transitionsEnd; ++index) {
+            const FlashTransition t = flashRead(tables_.transitions + index);
+            if (t.priority != priority) {
+                break;
+            }
+            const bool timeout = t.kind == ir::BytecodeTransitionKind::TimedTimeout;
+            hasTimed = hasTimed || timeout || t.kind == ir::BytecodeTransitionKind::TimedAfter;
+            if ((timeout && fallback >= 0) || !enabled(t, now)) {
+                continue;
+            }
+            if (!timeout) {
+                entryTick_ = false;
+                fire(t, now);
+                return true;
+            }
+            fallback = index;
+        }
+        if (fallback >= 0) {
+            entryTick_ = false;
+            fire(flashRead(tables_.transitions + fallback), now);
+            return true;
+        }
+        if (hasTimed) {
+            break;
+        }
+    }
+
+    entryTick_ = false;
+    execute(state.body);
+    variables_.clearAllChanged();
+    return false;
+}
+
+inline bool FlashRuntime::enabled(const FlashTransition& t, Timestamp now) {
+    switch (t.kind) {
+        case ir::BytecodeTransitionKind::Immediate:
+            return true;
+        case ir::BytecodeTransitionKind::TimedAfter:
+        case ir::BytecodeTransitionKind::TimedTimeout:
+            if (now < enteredAt_ || now - enteredAt_ < static_cast<Timestamp>(t.delayMs)) {
+                return false;
+            }
+            break;
+        case ir::BytecodeTransitionKind::EventSignal:
+            if (!eventTriggered(t)) {
+                return false;
+            }
+            break;
+        case ir::BytecodeTransitionKind::ClassicCondition:
+            break;
+    }
+    if (t.condition.size == 0) {
+        return true;
+    }
+    ScriptVmResult result;
+    return run(t.condition, result) && result.value != 0.0;
+}
+
+inline bool FlashRuntime::eventTriggered(const FlashTransition& t) const {
+    const Variable* var = variables_.get(t.signal);
+    if (!var) {
+        return false;
+    }
+    switch (t.trigger) {
+        case EventTrigger::OnChange:
+            return var->hasChanged();
+        case EventTrigger::OnRise:
+        case EventTrigger::OnFall: {
+            if (!var->hasChanged()) {
+                return false;
+            }
+            auto previous = var->previousValue().tryGet<bool>();
+            auto current = var->value().tryGet<bool>();
+            const bool rise = t.trigger == EventTrigger::OnRise;
+            return previous && current && *previous != rise && *current == rise;
+        }
+        case EventTrigger::OnThreshold: {
+            if (!var->hasChanged() && !entryTick_) {
+                return false;
+            }
+            const double value = var->value().toDouble();
+            switch (t.thresholdOp) {
+                case CompareOp::Gt: return value > t.threshold;
+                case CompareOp::Ge: return value >= t.threshold;
+                case CompareOp::Lt: return value < t.threshold;
+                case CompareOp::Le: return value <= t.threshold;
+                case CompareOp::Eq: return value == t.threshold;
+                case CompareOp::Ne: return value != t.threshold;
+            }
+            return false;
+        }
+        default:
+            return false;
+    }
+}
+
+inline void FlashRuntime::fire(const FlashTransition& t, Timestamp now) {
+    execute(flashRead(tables_.states + current_).onExit);
+    execute(t.body);
+    execute(t.triggered);
+    current_ = t.targetIndex;
+    enteredAt_ = now;
+    entryTick_ = true;
+    ++transitionCount_;
+    execute(flashRead(tables_.states + current_).onEnter);
+    variables_.clearAllChanged();
+}
+
+inline bool FlashRuntime::run(const FlashCode& code, ScriptVmResult& result) {
+#if defined(__AVR__)
+    memcpy_P(chunk_.data(), tables_.code + code.offset, code.size);
+    const uint8_t* body = chunk_.data();
+#else
+    const uint8_t* body = tables_.code + code.offset;
+#endif
+    result = runScriptVm(body, code.size, variables_);
+    if (!result.ok) {
+        lastError_ = result.error;
+    }
+    return result.ok;
+}
+
+inline void FlashRuntime::execute(const FlashCode& code) {
+    if (code.size > 0) {
+        ScriptVmResult result;
+        run(code, result);
+    }
+}
+
+} // namespace aeth
+
+#endif // AETHERIUM_FLASH_AUTOMATA_HPP
@@ -0,0 +1,852 @@
+#include "fleet.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__)
+#define AETHERIUM_FLEET_SIMD_AVX2 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define AETHERIUM_FLEET_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace aeth {
+
+namespace {
+
+constexpr size_t kLaneBlock = 256;
+constexpr uint32_t kNoChoice = 0xFFFFFFFF;
+
+bool isNumeric(ValueType type) {
+    switch (type) {
+        case ValueType::Bool:
+        case ValueType::Int32:
+        case ValueType::Int64:
+        case ValueType::Float32:
+        case ValueType::Float64:
+            return true;
+        default:
+            return false;
+    }
+}
+
+Value numericValue(ValueType type, double number) {
+    switch (type) {
+        case ValueType::Bool: return Value(number != 0.0);
+        case ValueType::Int32: return Value(static_cast<int32_t>(number));
+        case ValueType::Int64: return Value(static_cast<int64_t>(number));
+        case ValueType::Float32: return Value(static_cast<float>(number));
+        default: return Value(number);
+    }
+}
+
+// ============================================================================
+// Lane kernels
+// ============================================================================
+
+#if defined(AETHERIUM_FLEET_SIMD_AVX2)
+template <int Predicate, bool Broadcast>
+size_t compareBlock(const double* a, const double* b, double* out, size_t count) {
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d scalar = _mm256_set1_pd(Broadcast ? *b : 0.0);
+    size_t j = 0;
+    for (; j + 4 <= count; j += 4) {
+        const __m256d rhs = Broadcast ? scalar : _mm256_loadu_pd(b + j);
+        const __m256d mask = _mm256_cmp_pd(_mm256_loadu_pd(a + j), rhs, Predicate);
+        _mm256_storeu_pd(out + j, _mm256_and_pd(mask, one));
+    }
+    return j;
+}
+
+template <bool Broadcast>
+size_t compareVector(const double* a, const double* b, double* out, size_t count, CompareOp op) {
+    switch (op) {
+        case CompareOp::Eq: return compareBlock<_CMP_EQ_OQ, Broadcast>(a, b, out, count);
+        case CompareOp::Ne: return compareBlock<_CMP_NEQ_UQ, Broadcast>(a, b, out, count);
+        case CompareOp::Lt: return compareBlock<_CMP_LT_OQ, Broadcast>(a, b, out, count);
+        case CompareOp::Le: return compareBlock<_CMP_LE_OQ, Broadcast>(a, b, out, count);
+        case CompareOp::Gt: return compareBlock<_CMP_GT_OQ, Broadcast>(a, b, out, count);
+        case CompareOp::Ge: return compareBlock<_CMP_GE_OQ, Broadcast>(a, b, out, count);
+    }
+    return 0;
+}
+#elif defined(AETHERIUM_FLEET_SIMD_NEON)
+template <CompareOp Op, bool Broadcast>
+size_t compareBlock(const double* a, const double* b, double* out, size_t count) {
+    const uint64x2_t one = vreinterpretq_u64_f64(vdupq_n_f64(1.0));
+    const float64x2_t scalar = vdupq_n_f64(Broadcast ? *b : 0.0);
+    size_t j = 0;
+    for (; j + 2 <= count; j += 2) {
+        const float64x2_t lhs = vld1q_f64(a + j);
+        const float64x2_t rhs = Broadcast ? scalar : vld1q_f64(b + j);
+        uint64x2_t mask;
+        if constexpr (Op == CompareOp::Eq) {
+            mask = vceqq_f64(lhs, rhs);
+        } else if constexpr (Op == CompareOp::Ne) {
+            mask = veorq_u64(vceqq_f64(lhs, rhs), vdupq_n_u64(~uint64_t{0}));
+        } else if constexpr (Op == CompareOp::Lt) {
+            mask = vcltq_f64(lhs, rhs);
+        } else if constexpr (Op == CompareOp::Le) {
+            mask = vcleq_f64(lhs, rhs);
+        } else if constexpr (Op == CompareOp::Gt) {
+            mask = vcgtq_f64(lhs, rhs);
+        } else {
+            mask = vcgeq_f64(lhs, rhs);
+        }
+        vst1q_f64(out + j, vreinterpretq_f64_u64(vandq_u64(mask, one)));
+    }
+    return j;
+}
+
+template <bool Broadcast>
+size_t compareVector(const double* a, const double* b, double* out, size_t count, CompareOp op) {
+    switch (op) {
+        case CompareOp::Eq: return compareBlock<CompareOp::Eq, Broadcast>(a, b, out, count);
+        case CompareOp::Ne: return compareBlock<CompareOp::Ne, Broadcast>(a, b, out, count);
+        case CompareOp::Lt: return compareBlock<CompareOp::Lt, Broadcast>(a, b, out, count);
+        case CompareOp::Le: return compareBlock<CompareOp::Le, Broadcast>(a, b, out, count);
+        case CompareOp::Gt: return compareBlock<CompareOp::Gt, Broadcast>(a, b, out, count);
+        case CompareOp::Ge: return compareBlock<CompareOp::Ge, Broadcast>(a, b, out, count);
+    }
+    return 0;
+}
+#else
+template <bool Broadcast>
+size_t compareVector(const double*, const double*, double*, size_t, CompareOp) {
+    return 0;
+}
+#endif
+
+/**
+ * out[j] = a[j] <op> b[j] as 1.0 / 0.0; with Broadcast, *b is compared
+ * against every lane. `out` may alias `a`.
+ */
+template <bool Broadcast>
+void compareLanes(const double* a, const double* b, double* out, size_t count, CompareOp op) {
+    for (size_t j = compareVector<Broadcast>(a, b, out, count, op); j < count; ++j) {
+        out[j] = detail::compareGuardNumbers(a[j], Broadcast ? *b : b[j], op) ? 1.0 : 0.0;
+    }
+}
+
+void gather(const std::vector<double>& column, const uint32_t* lanes, size_t count, double* out) {
+    for (size_t j = 0; j < count; ++j) {
+        out[j] = column[lanes[j]];
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Per-instance storage
+// ============================================================================
+
+struct Fleet::Column {
+    const VariableSpec* spec = nullptr;
+    bool numeric = false;
+    std::vector<double> current;        // Every instance's value as a number
+    std::vector<double> previous;
+    std::vector<uint8_t> changed;
+    std::vector<Value> boxed;           // Non-numeric variables keep the values themselves
+    std::vector<Value> boxedPrevious;
+};
+
+// How one compiled transition is evaluated over a block of lanes
+struct Fleet::Plan {
+    enum class Ready : uint8_t {
+        Always,    // Immediate, classic, probabilistic
+        Elapsed,   // Time in state >= fromMs
+        Window,    // Time in state within [fromMs, toMs]; toMs 0 = open
+        Triggers   // Event triggers, any or all
+    };
+
+    Ready ready = Ready::Always;
+    bool requireAll = false;
+    Timestamp fromMs = 0;
+    Timestamp toMs = 0;
+    const CodeBlock* guard = nullptr;   // Null when unguarded
+    bool nativeGuard = false;
+    const CodeBlock* weight = nullptr;  // Dynamic weight expression
+    double fixedWeight = 100;
+};
+
+struct Fleet::ScriptLane {
+    VariableStore variables;
+    std::unique_ptr<IScriptEngine> engine;
+    bool synced = false;   // variables match the columns as of syncedTick
+    uint64_t syncedTick = 0;
+};
+
+Fleet::Fleet() = default;
+Fleet::~Fleet() = default;
+
+// ============================================================================
+// Loading
+// ============================================================================
+
+Result<void> Fleet::load(const Automata& automata, size_t instances, std::unique_ptr<IScriptEngine> script,
+                         const FleetOptions& options) {
+    auto errors = automata.validate();
+    if (!errors.empty()) {
+        return Result<void>::error("Validation failed: " + errors[0]);
+    }
+    for (const auto& [id, t] : automata.transitions) {
+        if (t.type == TransitionType::Timed && t.timedConfig.jitterMs > 0) {
+            return Result<void>::error("fleet: timed transition '" + t.name +
+                                       "' has jitter, which fleet mode does not model");
+        }
+    }
+
+    automata_ = &automata;
+    options_ = options;
+    compiled_.build(automata);
+    initial_.clear();
+    VariableId maxId = 0;
+    for (const auto& spec : automata.variables) {
+        initial_.addVariable(spec);
+        maxId = std::max(maxId, spec.id);
+    }
+
+    count_ = instances;
+    tick_ = 0;
+    columns_.clear();
+    columns_.resize(automata.variables.empty() ? 0 : static_cast<size_t>(maxId) + 1);
+    for (const auto& spec : automata.variables) {
+        Column& column = columns_[spec.id];
+        column.spec = &spec;
+        column.numeric = isNumeric(spec.type);
+        const Value& initial = initial_.get(spec.id)->value();
+        column.current.assign(count_, initial.toDouble());
+        column.previous.assign(count_, initial.toDouble());
+        column.changed.assign(count_, 0);
+        if (!column.numeric) {
+            column.boxed.assign(count_, initial);
+            column.boxedPrevious.assign(count_, initial);
+        }
+    }
+
+    state_.assign(count_, 0);
+    entryTime_.assign(count_, 0);
+    entryTick_.assign(count_, 0);
+    running_.assign(count_, 0);
+    choice_.assign(count_, kNoChoice);
+    random_.resize(count_);
+    for (size_t i = 0; i < count_; ++i) {
+        random_[i] = options.seed + i * 0xD1B54A32D192ED03ull;
+    }
+    scripts_.clear();
+    scripts_.resize(count_);
+
+    planTransitions();
+    if (needsScript_) {
+        if (!script) {
+            return Result<void>::error("fleet: " + automata.config.name +
+                                       " has code outside the native subset and needs a script engine");
+        }
+        if (!script->createInstance()) {
+            return Result<void>::error("fleet: the script engine cannot create per-instance engines");
+        }
+    }
+    prototype_ = std::move(script);
+
+    const size_t groupSize = std::max<size_t>(1, compiled_.maxGroupSize());
+    open_.resize(kLaneBlock);
+    enabled_.resize(groupSize * kLaneBlock);
+    weights_.resize(groupSize * kLaneBlock);
+    stack_.resize(GUARD_MAX_STACK * kLaneBlock);
+    scratch_.resize(2 * kLaneBlock);
+    mask_.resize(kLaneBlock);
+
+    stats_ = {};
+    lastError_.clear();
+    return Result<void>::ok();
+}
+
+void Fleet::planTransitions() {
+    needsScript_ = false;
+    for (const auto& [id, state] : automata_->states) {
+        if (!state.onEnter.isEmpty() || !state.body.isEmpty() || !state.onExit.isEmpty()) {
+            needsScript_ = true;
+        }
+    }
+
+    plans_.assign(compiled_.transitionCount(), Plan{});
+    for (size_t index = 0; index < plans_.size(); ++index) {
+        const CompiledTransition& entry = compiled_.transitionAt(static_cast<uint32_t>(index));
+        const Transition& t = *entry.transition;
+        Plan& plan = plans_[index];
+        plan.fixedWeight = t.weight;
+
+        switch (t.type) {
+            case TransitionType::Classic:
+                plan.guard = &t.classicConfig.condition;
+                break;
+            case TransitionType::Timed:
+                // Timers count from state entry, so every mode but the window is time in state
+                plan.ready = t.timedConfig.mode == TimedMode::Window ? Plan::Ready::Window : Plan::Ready::Elapsed;
+                plan.fromMs = t.timedConfig.delayMs;
+                plan.toMs = t.timedConfig.windowEndMs;
+                plan.guard = &t.timedConfig.additionalCondition;
+                break;
+            case TransitionType::Event:
+                plan.ready = Plan::Ready::Triggers;
+                plan.requireAll = t.eventConfig.requireAll;
+                plan.guard = &t.eventConfig.additionalCondition;
+                break;
+            case TransitionType::Probabilistic:
+                if (t.probConfig.isDynamic && !t.probConfig.weightExpression.isEmpty()) {
+                    plan.weight = &t.probConfig.weightExpression;
+                    needsScript_ = true;
+                } else {
+                    plan.fixedWeight = t.probConfig.weight;
+                }
+                break;
+            case TransitionType::Immediate:
+                break;
+        }
+
+        if (plan.guard && plan.guard->isEmpty()) {
+            plan.guard = nullptr;
+        }
+        if (plan.guard) {
+            const ArrayView<GuardInstr> program = compiled_.guard(entry);
+            plan.nativeGuard = options_.nativeGuards && !program.empty();
+            for (const GuardInstr& instr : program) {
+                const bool reads = instr.op == GuardOp::Load || instr.op == GuardOp::LoadBool ||
+                                   instr.op == GuardOp::Changed;
+                if (reads && (instr.variable >= columns_.size() || !columns_[instr.variable].spec ||
+                              (instr.op != GuardOp::Changed && !columns_[instr.variable].numeric))) {
+                    plan.nativeGuard = false;
+                }
+            }
+            needsScript_ = needsScript_ || !plan.nativeGuard;
+        }
+        if (!t.body.isEmpty() || !t.triggered.isEmpty()) {
+            needsScript_ = true;
+        }
+    }
+}
+
+// ============================================================================
+// Execution
+// ============================================================================
+
+Result<void> Fleet::start(Timestamp now) {
+    if (!automata_) {
+        return Result<void>::error("No automata loaded");
+    }
+    const uint32_t initial = compiled_.stateIndex(automata_->initialState);
+    if (initial == CompiledAutomata::INVALID_INDEX) {
+        return Result<void>::error("Invalid start state");
+    }
+    tick_ = 0;
+    now_ = now;
+    const State& state = *compiled_.stateAt(initial).state;
+    for (size_t i = 0; i < count_; ++i) {
+        state_[i] = initial;
+        entryTime_[i] = now;
+        entryTick_[i] = 0;
+        running_[i] = 1;
+        runHook(i, state.onEnter, "on_enter");
+    }
+    return Result<void>::ok();
+}
+
+size_t Fleet::tick(Timestamp now) {
+    ++tick_;
+    ++stats_.ticks;
+    now_ = now;
+
+    // Group the running instances by state (counting sort, instance order kept)
+    const size_t states = compiled_.stateCount();
+    bucketBegin_.assign(states + 1, 0);
+    for (size_t i = 0; i < count_; ++i) {
+        bucketBegin_[state_[i] + 1] += running_[i];
+    }
+    for (size_t s = 0; s < states; ++s) {
+        bucketBegin_[s + 1] += bucketBegin_[s];
+    }
+    order_.resize(bucketBegin_[states]);
+    cursor_.assign(bucketBegin_.begin(), bucketBegin_.end() - 1);
+    for (size_t i = 0; i < count_; ++i) {
+        if (running_[i]) {
+            order_[cursor_[state_[i]]++] = static_cast<uint32_t>(i);
+        }
+    }
+
+    std::fill(choice_.begin(), choice_.end(), kNoChoice);
+    for (uint32_t s = 0; s < states; ++s) {
+        for (size_t b = bucketBegin_[s]; b < bucketBegin_[s + 1]; b += kLaneBlock) {
+            resolveBlock(s, order_.data() + b, std::min<size_t>(kLaneBlock, bucketBegin_[s + 1] - b));
+        }
+    }
+
+    size_t fired = 0;
+    for (size_t i = 0; i < count_; ++i) {
+        if (!running_[i]) {
+            continue;
+        }
+        if (choice_[i] != kNoChoice) {
+            fire(i, choice_[i]);
+            ++fired;
+            continue;
+        }
+        const CompiledState& state = compiled_.stateAt(state_[i]);
+        if (state.terminal) {
+            running_[i] = 0;
+            continue;
+        }
+        runHook(i, state.state->body, "body");
+    }
+
+    for (Column& column : columns_) {
+        std::fill(column.changed.begin(), column.changed.end(), 0);
+    }
+    return fired;
+}
+
+void Fleet::resolveBlock(uint32_t stateIndex, const uint32_t* lanes, size_t count) {
+    const CompiledState& state = compiled_.stateAt(stateIndex);
+    if (state.terminal) {
+        return;
+    }
+    uint32_t* open = open_.data();
+    std::copy(lanes, lanes + count, open);
+    size_t openCount = count;
+
+    for (const auto& group : compiled_.groups(state)) {
+        const size_t members = group.end - group.begin;
+        for (size_t k = 0; k < members; ++k) {
+            evaluate(group.begin + static_cast<uint32_t>(k), open, openCount, enabled_.data() + k * kLaneBlock,
+                     weights_.data() + k * kLaneBlock);
+        }
+
+        size_t kept = 0;
+        for (size_t j = 0; j < openCount; ++j) {
+            // Candidates first; timeout transitions only when no candidate is enabled
+            uint32_t chosen = kNoChoice;
+            for (int pass = 0; pass < 2 && chosen == kNoChoice; ++pass) {
+                const bool fallback = pass == 1;
+                size_t enabledCount = 0;
+                size_t first = 0;
+                bool weighted = false;
+                double total = 0;
+                for (size_t k = 0; k < members; ++k) {
+                    const CompiledTransition& entry = compiled_.transitionAt(group.begin + static_cast<uint32_t>(k));
+                    if (entry.timeout != fallback || !enabled_[k * kLaneBlock + j]) {
+                        continue;
+                    }
+                    first = enabledCount == 0 ? k : first;
+                    ++enabledCount;
+                    weighted = weighted || entry.weighted;
+                    total += weights_[k * kLaneBlock + j];
+                }
+                if (enabledCount == 0) {
+                    continue;
+                }
+                chosen = group.begin + static_cast<uint32_t>(first);
+                if (enabledCount == 1 || !weighted || total <= 0) {
+                    continue;
+                }
+                const double r = random(open[j]) * total;
+                double cumulative = 0;
+                for (size_t k = 0; k < members; ++k) {
+                    const CompiledTransition& entry = compiled_.transitionAt(group.begin + static_cast<uint32_t>(k));
+                    if (entry.timeout != fallback || !enabled_[k * kLaneBlock + j]) {
+                        continue;
+                    }
+                    chosen = group.begin + static_cast<uint32_t>(k);
+                    cumulative += weights_[k * kLaneBlock + j];
+                    if (r < cumulative) {
+                        break;
+                    }
+                }
+            }
+
+            if (chosen != kNoChoice) {
+                choice_[open[j]] = chosen;
+            } else if (!group.hasTimed) {
+                // A pending timed transition holds lower-priority groups back
+                open[kept++] = open[j];
+            }
+        }
+        openCount = kept;
+        if (openCount == 0) {
+            break;
+        }
+    }
+}
+
+void Fleet::evaluate(uint32_t transitionIndex, const uint32_t* lanes, size_t count, uint8_t* enabled,
+                     double* weights) {
+    const CompiledTransition& entry = compiled_.transitionAt(transitionIndex);
+    const Plan& plan = plans_[transitionIndex];
+    stats_.laneEvaluations += count;
+
+    double* elapsed = scratch_.data();
+    double* result = scratch_.data() + kLaneBlock;
+    switch (plan.ready) {
+        case Plan::Ready::Always:
+            std::fill(enabled, enabled + count, 1);
+            break;
+        case Plan::Ready::Elapsed:
+        case Plan::Ready::Window: {
+            for (size_t j = 0; j < count; ++j) {
+                elapsed[j] = static_cast<double>(now_ - entryTime_[lanes[j]]);
+            }
+            const double from = static_cast<double>(plan.fromMs);
+            compareLanes<true>(elapsed, &from, result, count, CompareOp::Ge);
+            for (size_t j = 0; j < count; ++j) {
+                enabled[j] = result[j] != 0.0;
+            }
+            if (plan.ready == Plan::Ready::Window && plan.toMs > 0) {
+                const double to = static_cast<double>(plan.toMs);
+                compareLanes<true>(elapsed, &to, result, count, CompareOp::Le);
+                for (size_t j = 0; j < count; ++j) {
+                    enabled[j] &= result[j] != 0.0;
+                }
+            }
+            break;
+        }
+        case Plan::Ready::Triggers:
+            evaluateTriggers(entry, plan.requireAll, lanes, count, enabled);
+            break;
+    }
+
+    if (plan.guard) {
+        if (plan.nativeGuard) {
+            evaluateGuard(compiled_.guard(entry), lanes, count, mask_.data());
+            for (size_t j = 0; j < count; ++j) {
+                enabled[j] &= mask_[j];
+            }
+        } else {
+            for (size_t j = 0; j < count; ++j) {
+                if (!enabled[j]) {
+                    continue;
+                }
+                IScriptEngine* engine = script(lanes[j]);
+                if (!engine) {
+                    enabled[j] = 0;
+                    continue;
+                }
+                ++stats_.scriptCalls;
+                auto met = engine->evaluateCondition(*plan.guard);
+                enabled[j] = met.isOk() && met.value();
+            }
+        }
+    }
+
+    std::fill(weights, weights + count, plan.fixedWeight);
+    if (plan.weight) {
+        for (size_t j = 0; j < count; ++j) {
+            IScriptEngine* engine = script(lanes[j]);
+            if (!engine) {
+                continue;
+            }
+            ++stats_.scriptCalls;
+            auto weight = engine->evaluateWeight(*plan.weight);
+            if (weight.isOk()) {
+                weights[j] = static_cast<uint16_t>(std::clamp(weight.value() * 100, 0.0, 10000.0));
+            }
+        }
+    }
+}
+
+void Fleet::evaluateTriggers(const CompiledTransition& entry, bool all, const uint32_t* lanes, size_t count,
+                             uint8_t* out) {
+    // No trigger: any-of is never met, all-of always is
+    std::fill(out, out + count, all ? 1 : 0);
+    uint8_t* fired = mask_.data();
+    double* values = scratch_.data();
+    double* result = scratch_.data() + kLaneBlock;
+
+    for (const auto& trigger : compiled_.triggers(entry)) {
+        const Column* column = trigger.signal < columns_.size() && columns_[trigger.signal].spec
+            ? &columns_[trigger.signal]
+            : nullptr;
+        const SignalTrigger& signal = *trigger.trigger;
+        std::fill(fired, fired + count, 0);
+
+        if (!column) {
+            // Unknown signals never fire
+        } else if (signal.triggerType == EventTrigger::OnChange) {
+            for (size_t j = 0; j < count; ++j) {
+                fired[j] = column->changed[lanes[j]];
+            }
+        } else if (signal.triggerType == EventTrigger::OnRise || signal.triggerType == EventTrigger::OnFall) {
+            if (column->spec->type == ValueType::Bool) {
+                const bool rise = signal.triggerType == EventTrigger::OnRise;
+                for (size_t j = 0; j < count; ++j) {
+                    const uint32_t lane = lanes[j];
+                    const bool before = column->previous[lane] != 0.0;
+                    const bool now = column->current[lane] != 0.0;
+                    fired[j] = column->changed[lane] && (rise ? (!before && now) : (before && !now));
+                }
+            }
+        } else if (signal.triggerType == EventTrigger::OnThreshold) {
+            if (signal.threshold) {
+                gather(column->current, lanes, count, values);
+                compareLanes<true>(values, &trigger.threshold, result, count, signal.threshold->op);
+                for (size_t j = 0; j < count; ++j) {
+                    // A threshold already met on state entry fires on the entry tick
+                    const uint32_t lane = lanes[j];
+                    fired[j] = result[j] != 0.0 && (column->changed[lane] || tick_ == entryTick_[lane] + 1);
+                }
+            }
+        } else if (!column->numeric) {
+            for (size_t j = 0; j < count; ++j) {
+                const Value& value = column->boxed[lanes[j]];
+                fired[j] = column->changed[lanes[j]] && value.is<std::string>() && value.str() == trigger.pattern;
+            }
+        }
+
+        for (size_t j = 0; j < count; ++j) {
+            out[j] = all ? (out[j] & fired[j]) : (out[j] | fired[j]);
+        }
+    }
+}
+
+void Fleet::evaluateGuard(ArrayView<GuardInstr> program, const uint32_t* lanes, size_t count, uint8_t* out) {
+    // The postfix program of native_guard.hpp with a block of lanes per stack slot
+    double* stack = stack_.data();
+    size_t top = 0;
+    for (const GuardInstr& instr : program) {
+        double* slot = stack + top * kLaneBlock;
+        switch (instr.op) {
+            case GuardOp::Number:
+                std::fill(slot, slot + count, instr.number);
+                ++top;
+                break;
+            case GuardOp::Load:
+            case GuardOp::LoadBool:
+                gather(columns_[instr.variable].current, lanes, count, slot);
+                ++top;
+                break;
+            case GuardOp::Changed: {
+                const auto& changed = columns_[instr.variable].changed;
+                for (size_t j = 0; j < count; ++j) {
+                    slot[j] = changed[lanes[j]] ? 1.0 : 0.0;
+                }
+                ++top;
+                break;
+            }
+            case GuardOp::Neg: {
+                double* a = slot - kLaneBlock;
+                for (size_t j = 0; j < count; ++j) {
+                    a[j] = -a[j];
+                }
+                break;
+            }
+            case GuardOp::Not: {
+                double* a = slot - kLaneBlock;
+                for (size_t j = 0; j < count; ++j) {
+                    a[j] = a[j] == 0.0 ? 1.0 : 0.0;
+                }
+                break;
+            }
+            default: {
+                const double* b = slot - kLaneBlock;
+                double* a = slot - 2 * kLaneBlock;
+                --top;
+                switch (instr.op) {
+                    case GuardOp::Add:
+                        for (size_t j = 0; j < count; ++j) a[j] = a[j] + b[j];
+                        break;
+                    case GuardOp::Sub:
+                        for (size_t j = 0; j < count; ++j) a[j] = a[j] - b[j];
+                        break;
+                    case GuardOp::Mul:
+                        for (size_t j = 0; j < count; ++j) a[j] = a[j] * b[j];
+                        break;
+                    case GuardOp::Div:
+                        for (size_t j = 0; j < count; ++j) a[j] = a[j] / b[j];
+                        break;
+                    case GuardOp::Compare:
+                        compareLanes<false>(a, b, a, count, instr.cmp);
+                        break;
+                    case GuardOp::And:
+                        for (size_t j = 0; j < count; ++j) a[j] = (a[j] != 0.0 && b[j] != 0.0) ? 1.0 : 0.0;
+                        break;
+                    case GuardOp::Or:
+                        for (size_t j = 0; j < count; ++j) a[j] = (a[j] != 0.0 || b[j] != 0.0) ? 1.0 : 0.0;
+                        break;
+                    default:
+                        break;
+                }
+                break;
+            }
+        }
+    }
+    for (size_t j = 0; j < count; ++j) {
+        out[j] = stack[j] != 0.0;
+    }
+}
+
+void Fleet::fire(size_t instance, uint32_t transitionIndex) {
+    const CompiledTransition& entry = compiled_.transitionAt(transitionIndex);
+    const Transition& t = *entry.transition;
+    const State& from = *compiled_.stateAt(state_[instance]).state;
+    const State& to = *compiled_.stateAt(entry.targetIndex).state;
+
+    runHook(instance, from.onExit, "on_exit");
+    runHook(instance, t.body, "transition body");
+    runHook(instance, t.triggered, "triggered");
+    state_[instance] = entry.targetIndex;
+    entryTime_[instance] = now_;
+    entryTick_[instance] = tick_;
+    runHook(instance, to.onEnter, "on_enter");
+
+    ++stats_.transitions;
+    if (stateChange_) {
+        stateChange_(instance, t.from, t.to, t.id);
+    }
+}
+
+double Fleet::random(size_t instance) {
+    // splitmix64
+    uint64_t z = (random_[instance] += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    return static_cast<double>(z >> 11) * 0x1.0p-53;
+}
+
+// ============================================================================
+// Script fallback
+// ============================================================================
+
+IScriptEngine* Fleet::script(size_t instance) {
+    auto& lane = scripts_[instance];
+    if (!lane) {
+        auto engine = prototype_ ? prototype_->createInstance() : nullptr;
+        if (!engine) {
+            lastError_ = "instance " + std::to_string(instance) + ": no script engine";
+            return nullptr;
+        }
+        auto created = std::make_unique<ScriptLane>();
+        created->variables = initial_;
+        auto init = engine->initialize(&created->variables);
+        if (init.isError()) {
+            lastError_ = "instance " + std::to_string(instance) + ": script init failed: " + init.error();
+            return nullptr;
+        }
+        engine->prepare(*automata_);
+        created->engine = std::move(engine);
+        lane = std::move(created);
+        ++stats_.scriptInstances;
+    }
+    if (!lane->synced || lane->syncedTick != tick_) {
+        syncToScript(instance, *lane);
+    }
+    return lane->engine.get();
+}
+
+void Fleet::runHook(size_t instance, const CodeBlock& code, const char* site) {
+    if (code.isEmpty()) {
+        return;
+    }
+    IScriptEngine* engine = script(instance);
+    if (!engine) {
+        return;
+    }
+    ++stats_.scriptCalls;
+    auto result = engine->execute(code);
+    if (result.isError()) {
+        lastError_ = "instance " + std::to_string(instance) + ": " + site + " error: " + result.error();
+    }
+    syncFromScript(instance, *scripts_[instance]);
+}
+
+void Fleet::syncToScript(size_t instance, ScriptLane& lane) {
+    for (const Column& column : columns_) {
+        if (!column.spec) {
+            continue;
+        }
+        const VariableId id = column.spec->id;
+        const bool input = column.spec->direction == VariableDirection::Input;
+        auto put = [&](Value value) {
+            return input ? lane.variables.setExternalValue(id, std::move(value))
+                         : lane.variables.setValue(id, std::move(value));
+        };
+        // Previous value then current, so the store's change flag comes out as ours
+        put(box(column, instance, column.changed[instance] != 0));
+        put(box(column, instance, false));
+    }
+    lane.synced = true;
+    lane.syncedTick = tick_;
+}
+
+void Fleet::syncFromScript(size_t instance, ScriptLane& lane) {
+    for (Column& column : columns_) {
+        if (!column.spec) {
+            continue;
+        }
+        const Variable* var = lane.variables.get(column.spec->id);
+        if (!var) {
+            continue;
+        }
+        column.current[instance] = var->value().toDouble();
+        column.previous[instance] = var->previousValue().toDouble();
+        column.changed[instance] = var->hasChanged();
+        if (!column.numeric) {
+            column.boxed[instance] = var->value();
+            column.boxedPrevious[instance] = var->previousValue();
+        }
+    }
+}
+
+// ============================================================================
+// Values
+// ============================================================================
+
+void Fleet::write(Column& column, size_t instance, const Value& value) {
+    const double number = value.toDouble();
+    column.previous[instance] = column.current[instance];
+    column.current[instance] = number;
+    if (column.numeric) {
+        column.changed[instance] = number != column.previous[instance];
+        return;
+    }
+    column.boxedPrevious[instance] = std::move(column.boxed[instance]);
+    column.boxed[instance] = value;
+    column.changed[instance] = column.boxed[instance] != column.boxedPrevious[instance];
+}
+
+Value Fleet::box(const Column& column, size_t instance, bool previous) const {
+    if (!column.numeric) {
+        return previous ? column.boxedPrevious[instance] : column.boxed[instance];
+    }
+    return numericValue(column.spec->type, previous ? column.previous[instance] : column.current[instance]);
+}
+
+bool Fleet::setValue(size_t instance, VariableId id, const Value& value) {
+    if (instance >= count_ || id >= columns_.size() || !columns_[id].spec) {
+        return false;
+    }
+    Column& column = columns_[id];
+    if (column.spec->direction == VariableDirection::Output || (column.numeric && !isNumeric(value.type()))) {
+        return false;
+    }
+    write(column, instance, value);
+    if (scripts_[instance]) {
+        scripts_[instance]->synced = false;
+    }
+    return true;
+}
+
+Value Fleet::value(size_t instance, VariableId id) const {
+    if (instance >= count_ || id >= columns_.size() || !columns_[id].spec) {
+        return Value();
+    }
+    return box(columns_[id], instance, false);
+}
+
+StateId Fleet::state(size_t instance) const {
+    return instance < count_ ? compiled_.stateAt(state_[instance]).state->id : INVALID_STATE;
+}
+
+size_t Fleet::runningCount() const {
+    return static_cast<size_t>(std::count(running_.begin(), running_.end(), uint8_t{1}));
+}
+
+} // namespace aeth
@@ -0,0 +1,166 @@
+/**
+ * Aetherium Automata - Fleet
+ *
+ * Runs many instances of one automaton that differ only in their variable
+ * values, e.g. one per conveyor segment, without a Runtime and script VM
+ * each. The automaton is compiled once; per-instance state lives in
+ * columns (structure of arrays): current state, state entry time and tick,
+ * and for every variable its value, previous value and change flag.
+ *
+ * A tick buckets the running instances by state and resolves each bucket
+ * together, a block of lanes at a time: native guards run as one program
+ * over the block, and time-in-state conditions and change / rise / fall /
+ * threshold triggers are scans over gathered columns, with the comparisons
+ * in AVX2 (AETHERIUM_FLEET_AVX2) or NEON (AArch64) and scalar elsewhere.
+ * Code outside the native subset (state and transition hooks, other
+ * guards, dynamic weights) runs on a script engine owned by that instance,
+ * created the first time the instance needs one.
+ *
+ * Resolution follows TransitionResolver: priority groups, timeout
+ * transitions as fallbacks, a pending timed transition holding lower groups
+ * back, weighted choice. Timers are reduced to time in state, so timed
+ * transitions with jitter are refused at load. Ticks run on the caller's
+ * thread with the caller's clock; weighted choices draw from a stream per
+ * instance, so a fleet run is reproducible from its seed.
+ */
+
+#ifndef AETHERIUM_FLEET_HPP
+#define AETHERIUM_FLEET_HPP
+
+#include "compiled_automata.hpp"
+#include "runtime.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace aeth {
+
+struct FleetOptions {
+    bool nativeGuards = true;  // Off: every guard asks the instance's script engine
+    uint64_t seed = 1;         // Instance i draws weighted choices from a stream seeded by (seed, i)
+};
+
+struct FleetStats {
+    uint64_t ticks = 0;
+    uint64_t transitions = 0;     // Fired, over all instances
+    uint64_t laneEvaluations = 0; // Transition evaluations done in blocks, one per instance
+    uint64_t scriptCalls = 0;     // Code run on per-instance script engines
+    size_t scriptInstances = 0;   // Instances that own a script engine
+};
+
+class Fleet {
+public:
+    // Instance, from, to, via
+    using StateChangeCallback = std::function<void(size_t, StateId, StateId, TransitionId)>;
+
+    Fleet();
+    ~Fleet();
+
+    Fleet(const Fleet&) = delete;
+    Fleet& operator=(const Fleet&) = delete;
+
+    /**
+     * Compile `automata` (which must outlive the fleet) for `instances`
+     * copies, all at their initial values. `script` is the prototype the
+     * per-instance engines are created from (createInstance); it may be
+     * null when everything the automaton runs is in the native subset.
+     */
+    Result<void> load(const Automata& automata, size_t instances,
+                      std::unique_ptr<IScriptEngine> script = nullptr, const FleetOptions& options = {});
+
+    // Put every instance in the initial state at `now` and run its on_enter
+    Result<void> start(Timestamp now);
+
+    // One step of every running instance; returns how many fired a transition
+    size_t tick(Timestamp now);
+
+    /**
+     * Write an input or internal variable of one instance, as an external
+     * source would. False for an unknown instance or variable, an output,
+     * or a non-numeric value for a numeric variable.
+     */
+    bool setValue(size_t instance, VariableId id, const Value& value);
+
+    [[nodiscard]] Value value(size_t instance, VariableId id) const;
+    [[nodiscard]] StateId state(size_t instance) const;
+    [[nodiscard]] bool running(size_t instance) const { return instance < count_ && running_[instance] != 0; }
+
+    [[nodiscard]] size_t size() const { return count_; }
+    [[nodiscard]] size_t runningCount() const;
+
+    // Whether the automaton has code outside the native subset
+    [[nodiscard]] bool usesScripts() const { return needsScript_; }
+    [[nodiscard]] const FleetStats& stats() const { return stats_; }
+
+    // Last script error, "instance N: ..."; empty if none
+    [[nodiscard]] const std::string& lastError() const { return lastError_; }
+
+    void onStateChange(StateChangeCallback callback) { stateChange_ = std::move(callback); }
+
+private:
+    struct Column;
+    struct Plan;
+    struct ScriptLane;
+
+    void planTransitions();
+    void resolveBlock(uint32_t stateIndex, const uint32_t* lanes, size_t count);
+    void evaluate(uint32_t transitionIndex, const uint32_t* lanes, size_t count, uint8_t* enabled, double* weights);
+    void evaluateTriggers(const CompiledTransition& entry, bool all, const uint32_t* lanes, size_t count,
+                          uint8_t* out);
+    void evaluateGuard(ArrayView<GuardInstr> program, const uint32_t* lanes, size_t count, uint8_t* out);
+    void fire(size_t instance, uint32_t transitionIndex);
+
+    IScriptEngine* script(size_t instance);
+    void runHook(size_t instance, const CodeBlock& code, const char* site);
+    void syncToScript(size_t instance, ScriptLane& lane);
+    void syncFromScript(size_t instance, ScriptLane& lane);
+    void write(Column& column, size_t instance, const Value& value);
+    [[nodiscard]] Value box(const Column& column, size_t instance, bool previous) const;
+    double random(size_t instance);
+
+    const Automata* automata_ = nullptr;
+    CompiledAutomata compiled_;
+    FleetOptions options_;
+    std::unique_ptr<IScriptEngine> prototype_;
+    VariableStore initial_;  // Initial values, and the layout every script lane copies
+    bool needsScript_ = false;
+
+    size_t count_ = 0;
+    uint64_t tick_ = 0;
+    Timestamp now_ = 0;
+
+    // Per instance
+    std::vector<uint32_t> state_;       // Dense state index
+    std::vector<Timestamp> entryTime_;
+    std::vector<uint64_t> entryTick_;
+    std::vector<uint8_t> running_;
+    std::vector<uint64_t> random_;
+    std::vector<uint32_t> choice_;      // Transition index picked this tick
+    std::vector<std::unique_ptr<ScriptLane>> scripts_;
+
+    std::vector<Column> columns_;       // By variable id; holes have no spec
+    std::vector<Plan> plans_;           // By compiled transition index
+
+    // Per tick
+    std::vector<uint32_t> order_;       // Running instances grouped by state
+    std::vector<uint32_t> bucketBegin_; // By state index, into order_
+    std::vector<uint32_t> cursor_;
+
+    // Per block of lanes
+    std::vector<uint32_t> open_;
+    std::vector<uint8_t> enabled_;      // maxGroupSize x block
+    std::vector<double> weights_;
+    std::vector<double> stack_;         // GUARD_MAX_STACK x block
+    std::vector<double> scratch_;
+    std::vector<uint8_t> mask_;
+
+    FleetStats stats_;
+    std::string lastError_;
+    StateChangeCallback stateChange_;
+};
+
+} // namespace aeth
+
+#endif // AETHERIUM_FLEET_HPP
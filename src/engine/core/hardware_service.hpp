@@ -3,13 +3,83 @@
 
 #include "types.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 namespace aeth {
 
+// Borrowed call arguments; the caller keeps them alive for the call
+class ValueSpan {
+public:
+    ValueSpan() = default;
+    ValueSpan(const Value* data, size_t size) : data_(data), size_(size) {}
+    ValueSpan(const std::vector<Value>& values) : data_(values.data()), size_(values.size()) {}
+
+    [[nodiscard]] size_t size() const { return size_; }
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+    const Value& operator[](size_t index) const { return data_[index]; }
+    [[nodiscard]] const Value& front() const { return data_[0]; }
+    [[nodiscard]] const Value* begin() const { return data_; }
+    [[nodiscard]] const Value* end() const { return data_ + size_; }
+
+private:
+    const Value* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Argument storage for one call: on the stack up to N, on the heap past it
+template <size_t N = 8>
+class InlineValueArgs {
+public:
+    explicit InlineValueArgs(size_t count) : count_(count) {
+        if (count > N) {
+            spill_.resize(count);
+        }
+    }
+
+    Value& operator[](size_t index) { return count_ > N ? spill_[index] : inline_[index]; }
+    [[nodiscard]] ValueSpan span() const {
+        return ValueSpan(count_ > N ? spill_.data() : inline_.data(), count_);
+    }
+
+private:
+    std::array<Value, N> inline_{};
+    std::vector<Value> spill_;
+    size_t count_ = 0;
+};
+
+// Index of a component method, from IComponent::resolve
+using ComponentMethod = uint16_t;
+constexpr ComponentMethod INVALID_COMPONENT_METHOD = 0xFFFF;
+
+/**
+ * A component's method table as constant data, for boards whose components
+ * are fixed at build time (scripts/generate_esp32_component_bindings.py
+ * emits these). Each method calls straight through `fn` with the instance
+ * as `self`. `signature` lists the argument types, one letter each:
+ * b bool, i integer, n number, s string, v any; letters after a '|' are
+ * optional. Lives in flash on the boards: nothing is built at boot.
+ */
+struct ComponentMethodDescriptor {
+    const char* name;
+    const char* signature;
+    Result<Value> (*fn)(void* self, ValueSpan args);
+};
+
+struct ComponentDescriptor {
+    const char* name;
+    const ComponentMethodDescriptor* methods;
+    uint16_t methodCount;
+};
+
 class IComponent {
 public:
     virtual ~IComponent() = default;
@@ -17,6 +87,173 @@ public:
     virtual const std::string& name() const = 0;
     virtual std::vector<std::string> methods() const = 0;
     virtual Result<Value> invoke(const std::string& method, const std::vector<Value>& args) = 0;
+
+    /**
+     * Resolve a method name once (the script bindings do it when a script
+     * first asks for the component) and call it by index with borrowed
+     * arguments: no name compare and no argument vector per call.
+     *
+     * The defaults index methods() and forward to invoke(); components on
+     * a hot path override both.
+     */
+    virtual ComponentMethod resolve(std::string_view method) const {
+        const auto names = methods();
+        for (size_t i = 0; i < names.size() && i < INVALID_COMPONENT_METHOD; ++i) {
+            if (names[i] == method) {
+                return static_cast<ComponentMethod>(i);
+            }
+        }
+        return INVALID_COMPONENT_METHOD;
+    }
+
+    virtual Result<Value> call(ComponentMethod method, ValueSpan args) {
+        const auto names = methods();
+        if (method >= names.size()) {
+            return Result<Value>::error("unknown component method");
+        }
+        return invoke(names[method], std::vector<Value>(args.begin(), args.end()));
+    }
+
+    // Constant method table, if the component has one; the script
+    // bindings walk it instead of building methods()
+    [[nodiscard]] virtual const ComponentDescriptor* descriptor() const { return nullptr; }
+};
+
+// resolve() over a fixed name table, for components that override it
+template <size_t N>
+ComponentMethod resolveMethod(const std::array<const char*, N>& names, std::string_view method) {
+    for (size_t i = 0; i < N; ++i) {
+        if (method == names[i]) {
+            return static_cast<ComponentMethod>(i);
+        }
+    }
+    return INVALID_COMPONENT_METHOD;
+}
+
+// Check `args` against a method's signature
+inline Result<void> checkComponentArgs(const ComponentDescriptor& component,
+                                       const ComponentMethodDescriptor& method, ValueSpan args) {
+    auto fail = [&](const std::string& what) {
+        return Result<void>::error(std::string(component.name) + "." + method.name + ": " + what);
+    };
+    size_t index = 0;
+    size_t required = 0;
+    bool optional = false;
+    for (const char* type = method.signature; *type; ++type) {
+        if (*type == '|') {
+            optional = true;
+            continue;
+        }
+        if (!optional) {
+            ++required;
+        }
+        if (index >= args.size()) {
+            continue;
+        }
+        const ValueType actual = args[index++].type();
+        const bool numeric = actual == ValueType::Int32 || actual == ValueType::Int64 ||
+                             actual == ValueType::Float32 || actual == ValueType::Float64;
+        bool ok = true;
+        switch (*type) {
+            case 'b': ok = actual == ValueType::Bool || numeric; break;
+            case 'i':
+            case 'n': ok = numeric; break;
+            case 's': ok = actual == ValueType::String; break;
+            default: break;
+        }
+        if (!ok) {
+            return fail("argument " + std::to_string(index) + " has the wrong type");
+        }
+    }
+    auto count = [](size_t n) { return std::to_string(n) + (n == 1 ? " argument" : " arguments"); };
+    if (args.size() < required) {
+        return fail("expects at least " + count(required));
+    }
+    if (args.size() > index) {
+        return fail(index == 0 ? "takes no arguments" : "expects at most " + count(index));
+    }
+    return Result<void>::ok();
+}
+
+/**
+ * ComponentMethodDescriptor::fn for a member function of T. Members may
+ * take no arguments, a ValueSpan, or (older bindings) a std::vector<Value>,
+ * which costs a copy per call.
+ */
+template <auto Method, typename T>
+Result<Value> invokeComponentMethod(void* self, ValueSpan args) {
+    T& instance = *static_cast<T*>(self);
+    if constexpr (std::is_invocable_v<decltype(Method), T&>) {
+        (void)args;
+        return (instance.*Method)();
+    } else if constexpr (std::is_invocable_v<decltype(Method), T&, ValueSpan>) {
+        return (instance.*Method)(args);
+    } else {
+        return (instance.*Method)(std::vector<Value>(args.begin(), args.end()));
+    }
+}
+
+/**
+ * IComponent over a ComponentDescriptor and the instance its methods run
+ * on: two pointers, no allocation. The name string is only built if
+ * someone asks for name().
+ */
+class StaticComponent final : public IComponent {
+public:
+    StaticComponent() = default;
+    StaticComponent(const ComponentDescriptor& descriptor, void* self)
+        : descriptor_(&descriptor), self_(self) {}
+
+    const std::string& name() const override {
+        if (name_.empty() && descriptor_) {
+            name_ = descriptor_->name;
+        }
+        return name_;
+    }
+
+    std::vector<std::string> methods() const override {
+        std::vector<std::string> names;
+        for (uint16_t i = 0; descriptor_ && i < descriptor_->methodCount; ++i) {
+            names.emplace_back(descriptor_->methods[i].name);
+        }
+        return names;
+    }
+
+    Result<Value> invoke(const std::string& method, const std::vector<Value>& args) override {
+        const ComponentMethod index = resolve(method);
+        if (index == INVALID_COMPONENT_METHOD) {
+            return Result<Value>::error("unknown component method: " + method);
+        }
+        return call(index, args);
+    }
+
+    ComponentMethod resolve(std::string_view method) const override {
+        for (uint16_t i = 0; descriptor_ && i < descriptor_->methodCount; ++i) {
+            if (method == descriptor_->methods[i].name) {
+                return static_cast<ComponentMethod>(i);
+            }
+        }
+        return INVALID_COMPONENT_METHOD;
+    }
+
+    Result<Value> call(ComponentMethod method, ValueSpan args) override {
+        if (!descriptor_ || method >= descriptor_->methodCount) {
+            return Result<Value>::error("unknown component method");
+        }
+        const ComponentMethodDescriptor& entry = descriptor_->methods[method];
+        if (auto checked = checkComponentArgs(*descriptor_, entry, args); checked.isError()) {
+            return Result<Value>::error(checked.error());
+        }
+        return entry.fn(self_, args);
+    }
+
+    [[nodiscard]] const ComponentDescriptor* descriptor() const override { return descriptor_; }
+    [[nodiscard]] bool named(std::string_view name) const { return descriptor_ && name == descriptor_->name; }
+
+private:
+    const ComponentDescriptor* descriptor_ = nullptr;
+    void* self_ = nullptr;
+    mutable std::string name_;
 };
 
 class IHardwareService {
@@ -36,9 +273,19 @@ public:
 
     virtual Result<void> i2cOpen(int bus, int sdaPin, int sclPin, int frequencyHz) = 0;
     virtual Result<std::vector<int>> i2cScan(int bus) = 0;
+    virtual Result<void> i2cWrite(int bus, int address, const std::vector<uint8_t>& data) {
+        (void)bus;
+        (void)address;
+        (void)data;
+        return Result<void>::error("i2c write unsupported");
+    }
 
     virtual std::vector<std::string> componentNames() const = 0;
     virtual IComponent* component(const std::string& name) = 0;
+
+    // Apply writes staged since the last flush; the runtime calls it at the
+    // end of every tick. Unbuffered services have nothing to do.
+    virtual Result<void> flush() { return Result<void>::ok(); }
 };
 
 inline IHardwareService*& hardwareServiceSlot() {
@@ -67,6 +314,177 @@ public:
     IComponent* component(const std::string&) override { return nullptr; }
 };
 
+/**
+ * Per-tick actuation buffer in front of a board's service. GPIO, PWM and
+ * DAC writes are staged with the last write per pin/channel winning, and
+ * I2C writes are kept in order per device; flush() applies them together,
+ * devices grouped by bus and address. Reads of a staged pin see the staged
+ * level. Configuration calls (mode, attach, open) flush first so they keep
+ * their order relative to the writes around them.
+ *
+ * Write errors surface from flush() rather than from the staging call.
+ */
+class BufferedHardwareService final : public IHardwareService {
+public:
+    explicit BufferedHardwareService(IHardwareService& inner) : inner_(inner) {}
+
+    struct Stats {
+        uint64_t staged = 0;     // Writes accepted
+        uint64_t coalesced = 0;  // Writes superseded before a flush
+        uint64_t applied = 0;    // Writes and I2C transactions sent to the board
+        uint64_t flushes = 0;
+    };
+
+    // Disabled, every call goes straight through (pending writes flush first)
+    void setEnabled(bool enabled) {
+        if (!enabled) {
+            applyStaged();
+        }
+        enabled_ = enabled;
+    }
+    [[nodiscard]] bool enabled() const { return enabled_; }
+    [[nodiscard]] const Stats& stats() const { return stats_; }
+    [[nodiscard]] size_t pendingWrites() const { return gpio_.size() + pwm_.size() + dac_.size() + i2c_.size(); }
+    IHardwareService& inner() { return inner_; }
+
+    Result<void> gpioMode(int pin, const std::string& mode) override {
+        applyStaged();
+        return inner_.gpioMode(pin, mode);
+    }
+    Result<void> gpioWrite(int pin, bool high) override {
+        if (!enabled_) return inner_.gpioWrite(pin, high);
+        stage(gpio_, pin, high ? 1 : 0);
+        return Result<void>::ok();
+    }
+    Result<int64_t> gpioRead(int pin) override {
+        for (const auto& write : gpio_) {
+            if (write.key == pin) {
+                return Result<int64_t>::ok(write.value);
+            }
+        }
+        return inner_.gpioRead(pin);
+    }
+
+    Result<void> pwmAttach(int channel, int pin, int frequencyHz, int resolutionBits) override {
+        applyStaged();
+        return inner_.pwmAttach(channel, pin, frequencyHz, resolutionBits);
+    }
+    Result<void> pwmWrite(int channel, int duty) override {
+        if (!enabled_) return inner_.pwmWrite(channel, duty);
+        stage(pwm_, channel, duty);
+        return Result<void>::ok();
+    }
+
+    Result<int64_t> adcRead(int pin) override { return inner_.adcRead(pin); }
+    Result<int64_t> adcReadMilliVolts(int pin) override { return inner_.adcReadMilliVolts(pin); }
+    Result<void> dacWrite(int pin, int value) override {
+        if (!enabled_) return inner_.dacWrite(pin, value);
+        stage(dac_, pin, value);
+        return Result<void>::ok();
+    }
+
+    Result<void> i2cOpen(int bus, int sdaPin, int sclPin, int frequencyHz) override {
+        applyStaged();
+        return inner_.i2cOpen(bus, sdaPin, sclPin, frequencyHz);
+    }
+    Result<std::vector<int>> i2cScan(int bus) override {
+        applyStaged();
+        return inner_.i2cScan(bus);
+    }
+    Result<void> i2cWrite(int bus, int address, const std::vector<uint8_t>& data) override {
+        if (!enabled_) return inner_.i2cWrite(bus, address, data);
+        ++stats_.staged;
+        // A repeat of the device's previous payload changes nothing on it
+        for (auto it = i2c_.rbegin(); it != i2c_.rend(); ++it) {
+            if (it->bus == bus && it->address == address) {
+                if (it->data == data) {
+                    ++stats_.coalesced;
+                    return Result<void>::ok();
+                }
+                break;
+            }
+        }
+        i2c_.push_back(I2cWrite{bus, address, data});
+        return Result<void>::ok();
+    }
+
+    std::vector<std::string> componentNames() const override { return inner_.componentNames(); }
+    IComponent* component(const std::string& name) override { return inner_.component(name); }
+
+    // Applies everything staged even past a failure; returns the first error,
+    // including one deferred from a flush ahead of a configuration call
+    Result<void> flush() override {
+        applyStaged();
+        auto innerResult = inner_.flush();
+        if (deferredError_.empty() && innerResult.isError()) {
+            deferredError_ = innerResult.error();
+        }
+        if (deferredError_.empty()) {
+            return Result<void>::ok();
+        }
+        auto failed = Result<void>::error(std::move(deferredError_));
+        deferredError_.clear();
+        return failed;
+    }
+
+private:
+    struct Write {
+        int key = 0;
+        int64_t value = 0;
+    };
+    struct I2cWrite {
+        int bus = 0;
+        int address = 0;
+        std::vector<uint8_t> data;
+    };
+
+    // Staged lists stay a handful of entries, so a scan beats a map here
+    void stage(std::vector<Write>& writes, int key, int64_t value) {
+        ++stats_.staged;
+        for (auto& write : writes) {
+            if (write.key == key) {
+                write.value = value;
+                ++stats_.coalesced;
+                return;
+            }
+        }
+        writes.push_back(Write{key, value});
+    }
+
+    void applyStaged() {
+        if (pendingWrites() == 0) {
+            return;
+        }
+        ++stats_.flushes;
+        auto apply = [this](Result<void> result) {
+            ++stats_.applied;
+            if (result.isError() && deferredError_.empty()) {
+                deferredError_ = result.error();
+            }
+        };
+        for (const auto& write : gpio_) apply(inner_.gpioWrite(write.key, write.value != 0));
+        for (const auto& write : pwm_) apply(inner_.pwmWrite(write.key, static_cast<int>(write.value)));
+        for (const auto& write : dac_) apply(inner_.dacWrite(write.key, static_cast<int>(write.value)));
+        std::stable_sort(i2c_.begin(), i2c_.end(), [](const I2cWrite& a, const I2cWrite& b) {
+            return a.bus != b.bus ? a.bus < b.bus : a.address < b.address;
+        });
+        for (const auto& write : i2c_) apply(inner_.i2cWrite(write.bus, write.address, write.data));
+        gpio_.clear();
+        pwm_.clear();
+        dac_.clear();
+        i2c_.clear();
+    }
+
+    IHardwareService& inner_;
+    bool enabled_ = true;
+    Stats stats_;
+    std::string deferredError_;
+    std::vector<Write> gpio_;
+    std::vector<Write> pwm_;
+    std::vector<Write> dac_;
+    std::vector<I2cWrite> i2c_;
+};
+
 } // namespace aeth
 
 #endif // AETHERIUM_HARDWARE_SERVICE_HPP
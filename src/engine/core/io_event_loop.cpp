@@ -0,0 +1,210 @@
+/**
+ * Aetherium Automata - I/O Event Loop Implementation
+ */
+
+#include "io_event_loop.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace aeth {
+
+namespace {
+
+constexpr int MAX_EVENTS = 64;
+constexpr int IDLE_TIMEOUT_MS = 1000;  // Re-check deadlines at least this often
+
+} // namespace
+
+bool IoChannel::watch(int fd, uint32_t events) {
+    epoll_event event{};
+    event.events = events;
+    event.data.ptr = this;
+    return epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+bool IoChannel::rewatch(int fd, uint32_t events) {
+    epoll_event event{};
+    event.events = events;
+    event.data.ptr = this;
+    return epoll_ctl(epollFd_, EPOLL_CTL_MOD, fd, &event) == 0;
+}
+
+void IoChannel::unwatch(int fd) {
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+IoEventLoop::IoEventLoop(size_t threads) {
+    threads = std::max<size_t>(threads, 1);
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        auto worker = std::make_unique<Worker>();
+        worker->epollFd = epoll_create1(EPOLL_CLOEXEC);
+        worker->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;  // The wake fd; channels are never null
+        epoll_ctl(worker->epollFd, EPOLL_CTL_ADD, worker->wakeFd, &event);
+        workers_.push_back(std::move(worker));
+    }
+    for (auto& worker : workers_) {
+        Worker* raw = worker.get();
+        worker->thread = std::thread([this, raw] { run(*raw); });
+    }
+}
+
+IoEventLoop::~IoEventLoop() {
+    stopping_.store(true, std::memory_order_release);
+    for (auto& worker : workers_) {
+        signal(*worker);
+    }
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+        // Finish queued adds/removes, then detach what is left, now that no I/O thread runs
+        handleCommands(*worker);
+        for (IoChannel* channel : worker->channels) {
+            channel->onDetach();
+        }
+        ::close(worker->wakeFd);
+        ::close(worker->epollFd);
+    }
+}
+
+uint64_t IoEventLoop::nowMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void IoEventLoop::add(IoChannel& channel) {
+    auto least = std::min_element(workers_.begin(), workers_.end(), [](const auto& a, const auto& b) {
+        return a->load.load(std::memory_order_relaxed) < b->load.load(std::memory_order_relaxed);
+    });
+    Worker& worker = **least;
+    worker.load.fetch_add(1, std::memory_order_relaxed);
+    channel.worker_ = static_cast<size_t>(least - workers_.begin());
+    channel.epollFd_ = worker.epollFd;
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.commands.push_back(Command{Command::Kind::Add, &channel});
+    }
+    signal(worker);
+}
+
+void IoEventLoop::remove(IoChannel& channel) {
+    Worker& worker = *workers_[channel.worker_];
+    bool done = false;
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.commands.push_back(Command{Command::Kind::Remove, &channel, &done});
+    }
+    signal(worker);
+    std::unique_lock<std::mutex> lock(removeMutex_);
+    removed_.wait(lock, [&] { return done; });
+}
+
+void IoEventLoop::wake(IoChannel& channel) {
+    if (channel.wakePending_.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+    Worker& worker = *workers_[channel.worker_];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.wakes.push_back(&channel);
+    }
+    signal(worker);
+}
+
+void IoEventLoop::signal(Worker& worker) {
+    const uint64_t one = 1;
+    (void)!::write(worker.wakeFd, &one, sizeof(one));
+}
+
+bool IoEventLoop::handleCommands(Worker& worker) {
+    uint64_t count = 0;
+    (void)!::read(worker.wakeFd, &count, sizeof(count));
+
+    std::vector<Command> commands;
+    std::vector<IoChannel*> wakes;
+    bool removed = false;
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        commands.swap(worker.commands);
+        wakes.swap(worker.wakes);
+    }
+    for (const Command& command : commands) {
+        IoChannel* channel = command.channel;
+        if (command.kind == Command::Kind::Add) {
+            worker.channels.push_back(channel);
+            channel->onAttach();
+            continue;
+        }
+        auto it = std::find(worker.channels.begin(), worker.channels.end(), channel);
+        if (it != worker.channels.end()) {
+            worker.channels.erase(it);
+            channel->onDetach();
+            removed = true;
+            worker.load.fetch_sub(1, std::memory_order_relaxed);
+        }
+        wakes.erase(std::remove(wakes.begin(), wakes.end(), channel), wakes.end());
+        {
+            std::lock_guard<std::mutex> lock(removeMutex_);
+            *command.done = true;
+        }
+        removed_.notify_all();
+    }
+    for (IoChannel* channel : wakes) {
+        channel->wakePending_.store(false, std::memory_order_release);
+        channel->onWake();
+    }
+    return removed;
+}
+
+void IoEventLoop::run(Worker& worker) {
+    epoll_event events[MAX_EVENTS];
+    while (!stopping_.load(std::memory_order_acquire)) {
+        // Sleep until I/O, a command, or the earliest channel deadline
+        const uint64_t now = nowMs();
+        uint64_t next = now + IDLE_TIMEOUT_MS;
+        for (const IoChannel* channel : worker.channels) {
+            if (channel->deadlineMs() != 0) {
+                next = std::min(next, channel->deadlineMs());
+            }
+        }
+        const int timeout = next <= now ? 0 : static_cast<int>(std::min<uint64_t>(next - now, INT_MAX));
+
+        const int ready = epoll_wait(worker.epollFd, events, MAX_EVENTS, timeout);
+        // Commands first: a channel removed now must not see the rest of the batch
+        bool removed = false;
+        for (int i = 0; i < ready; ++i) {
+            if (events[i].data.ptr == nullptr) {
+                removed = handleCommands(worker);
+            }
+        }
+        for (int i = 0; i < ready; ++i) {
+            auto* channel = static_cast<IoChannel*>(events[i].data.ptr);
+            if (channel == nullptr ||
+                (removed && std::find(worker.channels.begin(), worker.channels.end(), channel) == worker.channels.end())) {
+                continue;
+            }
+            channel->onIo(events[i].events);
+        }
+
+        const uint64_t after = nowMs();
+        for (size_t i = 0; i < worker.channels.size(); ++i) {
+            IoChannel* channel = worker.channels[i];
+            if (channel->deadlineMs() != 0 && channel->deadlineMs() <= after) {
+                channel->setDeadline(0);
+                channel->onTimer(after);
+            }
+        }
+    }
+}
+
+} // namespace aeth
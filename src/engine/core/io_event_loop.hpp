@@ -0,0 +1,115 @@
+/**
+ * Aetherium Automata - I/O Event Loop
+ *
+ * A few epoll threads that multiplex every network connection of the
+ * process, instead of a thread per connection. Linux only.
+ */
+
+#ifndef AETHERIUM_IO_EVENT_LOOP_HPP
+#define AETHERIUM_IO_EVENT_LOOP_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace aeth {
+
+class IoEventLoop;
+
+/**
+ * A connection driven by the loop. Every callback runs on the channel's
+ * own I/O thread, so a channel needs no locking against itself.
+ */
+class IoChannel {
+public:
+    virtual ~IoChannel() = default;
+
+    // First call on the I/O thread after IoEventLoop::add()
+    virtual void onAttach() = 0;
+    // Readiness of the channel's descriptor (EPOLLIN/OUT/ERR/HUP)
+    virtual void onIo(uint32_t events) = 0;
+    // After IoEventLoop::wake() (coalesced: one call for several wakes)
+    virtual void onWake() = 0;
+    // When the deadline the channel asked for has passed
+    virtual void onTimer(uint64_t nowMs) = 0;
+    // Last call on the I/O thread, from IoEventLoop::remove()
+    virtual void onDetach() = 0;
+
+    // Steady-clock ms the channel next wants onTimer() (0 = none)
+    [[nodiscard]] uint64_t deadlineMs() const { return deadlineMs_; }
+
+protected:
+    void setDeadline(uint64_t atMs) { deadlineMs_ = atMs; }
+    // Register, change or drop the channel's descriptor (one at a time)
+    bool watch(int fd, uint32_t events);
+    bool rewatch(int fd, uint32_t events);
+    void unwatch(int fd);
+
+private:
+    friend class IoEventLoop;
+    int epollFd_ = -1;
+    uint64_t deadlineMs_ = 0;
+    std::atomic<bool> wakePending_{false};
+    size_t worker_ = 0;
+};
+
+class IoEventLoop {
+public:
+    // threads: I/O threads to spread channels over (at least one)
+    explicit IoEventLoop(size_t threads = 1);
+    ~IoEventLoop();
+
+    IoEventLoop(const IoEventLoop&) = delete;
+    IoEventLoop& operator=(const IoEventLoop&) = delete;
+
+    /**
+     * Hand a channel to the least loaded thread; onAttach() follows there.
+     * The channel must stay alive until remove() returns.
+     */
+    void add(IoChannel& channel);
+    // Runs onDetach() on the channel's thread and waits for it
+    void remove(IoChannel& channel);
+    // Schedule onWake() on the channel's thread; cheap when already pending
+    void wake(IoChannel& channel);
+
+    [[nodiscard]] size_t threadCount() const { return workers_.size(); }
+    // Steady clock the loop's deadlines use
+    static uint64_t nowMs();
+
+private:
+    struct Command {
+        enum class Kind : uint8_t { Add, Remove } kind;
+        IoChannel* channel;
+        bool* done = nullptr;  // Remove: set under removeMutex_ once detached
+    };
+
+    struct Worker {
+        int epollFd = -1;
+        int wakeFd = -1;  // eventfd: commands or wakes queued
+        std::mutex mutex;
+        std::vector<Command> commands;
+        std::vector<IoChannel*> wakes;
+        std::vector<IoChannel*> channels;
+        std::atomic<size_t> load{0};
+        std::thread thread;
+    };
+
+    void run(Worker& worker);
+    void signal(Worker& worker);
+    bool handleCommands(Worker& worker);  // Whether a channel was removed
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool> stopping_{false};
+
+    // remove() waits here for the worker to run onDetach()
+    std::mutex removeMutex_;
+    std::condition_variable removed_;
+};
+
+} // namespace aeth
+
+#endif // AETHERIUM_IO_EVENT_LOOP_HPP
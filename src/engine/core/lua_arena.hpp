@@ -0,0 +1,199 @@
+/**
+ * Aetherium Automata - Lua Arena Allocator
+ *
+ * lua_Alloc backed by size-class pools. Blocks up to MAX_POOLED bytes are
+ * carved from fixed-size slabs and recycled through one free list per
+ * class, so a long-running state stops churning the system heap and the
+ * heap sees only slab-sized requests. Slabs are kept until the arena is
+ * destroyed (after lua_close). Larger blocks go to malloc directly.
+ *
+ * An optional byte budget caps what the state may hold; a growing request
+ * past it fails, which Lua reports as a memory error to the script after
+ * an emergency collection. Shrinks and frees are never refused.
+ *
+ * Not thread-safe: one arena per lua_State, used from that state's thread.
+ */
+
+#ifndef AETHERIUM_LUA_ARENA_HPP
+#define AETHERIUM_LUA_ARENA_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+// Slab size for pooled blocks; smaller on embedded to bound slack per class
+#ifndef AETHERIUM_LUA_ARENA_SLAB_BYTES
+#if defined(ARDUINO) || defined(AETHERIUM_PLATFORM_MCXN947)
+#define AETHERIUM_LUA_ARENA_SLAB_BYTES 2048
+#else
+#define AETHERIUM_LUA_ARENA_SLAB_BYTES 16384
+#endif
+#endif
+
+namespace aeth {
+
+struct ScriptMemoryStats {
+    size_t inUse = 0;         // Bytes the VM holds
+    size_t peak = 0;          // Highest inUse since creation
+    size_t budget = 0;        // 0 = unlimited
+    size_t reserved = 0;      // Slabs plus large blocks taken from the heap
+    uint64_t allocated = 0;   // Bytes handed out since creation, never decreasing
+    uint64_t allocations = 0;
+    uint64_t failures = 0;    // Requests refused by the budget or the heap
+};
+
+class LuaArena {
+public:
+    static constexpr size_t MAX_POOLED = 512;
+    static constexpr size_t CLASS_COUNT = 14;
+    static constexpr size_t SLAB_BYTES = AETHERIUM_LUA_ARENA_SLAB_BYTES;
+
+    explicit LuaArena(size_t budget = 0) { stats_.budget = budget; }
+    ~LuaArena() {
+        while (slabs_) {
+            Slab* next = slabs_->next;
+            std::free(slabs_);
+            slabs_ = next;
+        }
+    }
+
+    LuaArena(const LuaArena&) = delete;
+    LuaArena& operator=(const LuaArena&) = delete;
+
+    // May be lowered below inUse; only later growth is refused then
+    void setBudget(size_t budget) { stats_.budget = budget; }
+
+    [[nodiscard]] const ScriptMemoryStats& stats() const { return stats_; }
+
+    // lua_Alloc; `ud` is the arena
+    static void* alloc(void* ud, void* ptr, size_t osize, size_t nsize) {
+        return static_cast<LuaArena*>(ud)->reallocate(ptr, ptr ? osize : 0, nsize);
+    }
+
+    // Block sizes of the classes: 8-byte steps to 64, then half-powers of two
+    static constexpr std::array<uint16_t, CLASS_COUNT> CLASS_SIZES = {
+        8, 16, 24, 32, 40, 48, 56, 64, 96, 128, 192, 256, 384, 512};
+
+    static size_t classOf(size_t size) {
+        if (size <= 64) {
+            return size == 0 ? 0 : (size - 1) / 8;
+        }
+        size_t index = 8;
+        while (CLASS_SIZES[index] < size) {
+            ++index;
+        }
+        return index;
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    // Slabs are chained through a header so growing the arena never allocates elsewhere
+    struct Slab {
+        Slab* next;
+    };
+    static constexpr size_t SLAB_HEADER = alignof(std::max_align_t);
+
+    void* reallocate(void* ptr, size_t osize, size_t nsize) {
+        if (nsize == 0) {
+            release(ptr, osize);
+            stats_.inUse -= std::min(stats_.inUse, osize);
+            return nullptr;
+        }
+        if (nsize > osize && stats_.budget > 0 && stats_.inUse - osize + nsize > stats_.budget) {
+            ++stats_.failures;
+            return nullptr;
+        }
+
+        void* result = nullptr;
+        if (ptr && osize > MAX_POOLED && nsize > MAX_POOLED) {
+            result = std::realloc(ptr, nsize);
+            if (result) {
+                stats_.reserved = stats_.reserved - osize + nsize;
+            }
+        } else if (ptr && osize <= MAX_POOLED && nsize <= MAX_POOLED && classOf(osize) == classOf(nsize)) {
+            result = ptr;  // Still fits its block
+        } else {
+            result = acquire(nsize);
+            if (result && ptr) {
+                std::memcpy(result, ptr, std::min(osize, nsize));
+                release(ptr, osize);
+            }
+        }
+
+        if (!result) {
+            ++stats_.failures;
+            return nullptr;
+        }
+        if (nsize > osize) {
+            stats_.allocated += nsize - osize;
+        }
+        ++stats_.allocations;
+        stats_.inUse = stats_.inUse - osize + nsize;
+        stats_.peak = std::max(stats_.peak, stats_.inUse);
+        return result;
+    }
+
+    void* acquire(size_t size) {
+        if (size > MAX_POOLED) {
+            void* block = std::malloc(size);
+            if (block) {
+                stats_.reserved += size;
+            }
+            return block;
+        }
+        const size_t index = classOf(size);
+        if (!freeLists_[index] && !refill(index)) {
+            return nullptr;
+        }
+        FreeBlock* block = freeLists_[index];
+        freeLists_[index] = block->next;
+        return block;
+    }
+
+    void release(void* ptr, size_t size) {
+        if (!ptr) {
+            return;
+        }
+        if (size > MAX_POOLED) {
+            std::free(ptr);
+            stats_.reserved -= std::min(stats_.reserved, size);
+            return;
+        }
+        const size_t index = classOf(size);
+        auto* block = static_cast<FreeBlock*>(ptr);
+        block->next = freeLists_[index];
+        freeLists_[index] = block;
+    }
+
+    // Carve a new slab into blocks of one class
+    bool refill(size_t index) {
+        const size_t blockSize = CLASS_SIZES[index];
+        auto* slab = static_cast<unsigned char*>(std::malloc(SLAB_BYTES));
+        if (!slab) {
+            return false;
+        }
+        reinterpret_cast<Slab*>(slab)->next = slabs_;
+        slabs_ = reinterpret_cast<Slab*>(slab);
+        stats_.reserved += SLAB_BYTES;
+        for (size_t offset = SLAB_HEADER; offset + blockSize <= SLAB_BYTES; offset += blockSize) {
+            auto* block = reinterpret_cast<FreeBlock*>(slab + offset);
+            block->next = freeLists_[index];
+            freeLists_[index] = block;
+        }
+        return true;
+    }
+
+    std::array<FreeBlock*, CLASS_COUNT> freeLists_{};
+    Slab* slabs_ = nullptr;
+    ScriptMemoryStats stats_;
+};
+
+} // namespace aeth
+
+#endif // AETHERIUM_LUA_ARENA_HPP
@@ -0,0 +1,95 @@
+/**
+ * Aetherium Automata - Precompiled Lua Chunks
+ *
+ * lua_dump output is only loadable by a Lua with the same version and
+ * type sizes. Artifacts record the layout they were compiled for; a code
+ * block carries its chunk behind a small tag so a script engine can tell,
+ * without calling into Lua, whether to load the chunk or the source.
+ *
+ * Tagged chunk: 'L', u16 version (big-endian), word size, integer size,
+ * number size, CodeKind, then the dump bytes.
+ */
+
+#ifndef AETHERIUM_LUA_CHUNK_HPP
+#define AETHERIUM_LUA_CHUNK_HPP
+
+#include "model.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aeth {
+
+struct LuaChunkTarget {
+    uint16_t luaVersion = 0;  // LUA_VERSION_NUM
+    uint8_t wordSize = 0;     // sizeof(void*)
+    uint8_t integerSize = 0;  // sizeof(lua_Integer)
+    uint8_t numberSize = 0;   // sizeof(lua_Number)
+
+    [[nodiscard]] bool valid() const { return luaVersion != 0; }
+
+    bool operator==(const LuaChunkTarget& other) const {
+        return luaVersion == other.luaVersion && wordSize == other.wordSize &&
+               integerSize == other.integerSize && numberSize == other.numberSize;
+    }
+    bool operator!=(const LuaChunkTarget& other) const { return !(*this == other); }
+};
+
+// Layout of the Lua this translation unit is built against
+template <typename LuaInteger, typename LuaNumber>
+constexpr LuaChunkTarget luaChunkTarget(int luaVersionNum) {
+    return LuaChunkTarget{static_cast<uint16_t>(luaVersionNum), static_cast<uint8_t>(sizeof(void*)),
+                          static_cast<uint8_t>(sizeof(LuaInteger)), static_cast<uint8_t>(sizeof(LuaNumber))};
+}
+
+constexpr size_t LUA_CHUNK_TAG_SIZE = 7;
+
+inline std::vector<uint8_t> tagLuaChunk(const LuaChunkTarget& target,
+                                        CodeKind kind,
+                                        const std::vector<uint8_t>& dump) {
+    std::vector<uint8_t> out;
+    out.reserve(LUA_CHUNK_TAG_SIZE + dump.size());
+    out.push_back('L');
+    out.push_back(static_cast<uint8_t>(target.luaVersion >> 8));
+    out.push_back(static_cast<uint8_t>(target.luaVersion & 0xFF));
+    out.push_back(target.wordSize);
+    out.push_back(target.integerSize);
+    out.push_back(target.numberSize);
+    out.push_back(static_cast<uint8_t>(kind));
+    out.insert(out.end(), dump.begin(), dump.end());
+    return out;
+}
+
+struct LuaChunkView {
+    LuaChunkTarget target;
+    CodeKind kind = CodeKind::Contextual;
+    const char* data = nullptr;
+    size_t size = 0;
+};
+
+/**
+ * The dump in `code.bytecode` if it was compiled for `target` as `kind`;
+ * false means the caller should compile the source instead.
+ */
+inline bool loadableLuaChunk(const CodeBlock& code,
+                             const LuaChunkTarget& target,
+                             CodeKind kind,
+                             LuaChunkView& out) {
+    const auto& bytes = code.bytecode;
+    if (bytes.size() <= LUA_CHUNK_TAG_SIZE || bytes[0] != 'L') {
+        return false;
+    }
+    out.target.luaVersion = static_cast<uint16_t>((bytes[1] << 8) | bytes[2]);
+    out.target.wordSize = bytes[3];
+    out.target.integerSize = bytes[4];
+    out.target.numberSize = bytes[5];
+    out.kind = static_cast<CodeKind>(bytes[6]);
+    out.data = reinterpret_cast<const char*>(bytes.data() + LUA_CHUNK_TAG_SIZE);
+    out.size = bytes.size() - LUA_CHUNK_TAG_SIZE;
+    return out.target == target && out.kind == kind;
+}
+
+} // namespace aeth
+
+#endif // AETHERIUM_LUA_CHUNK_HPP
@@ -4,6 +4,8 @@
 
 #include "lua_engine.hpp"
 #include "hardware_service.hpp"
+#include "lua_chunk.hpp"
+#include "protocol.hpp"
 
 #define SOL_ALL_SAFETIES_ON 1
 #define SOL_USE_LUA_HPP 0
@@ -15,6 +17,7 @@ extern "C" {
 #include <sol/sol.hpp>
 #include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <random>
 #include <stdexcept>
 #if defined(ARDUINO)
@@ -25,6 +28,15 @@ namespace aeth {
 
 namespace {
 
+const LuaChunkTarget kLuaTarget = luaChunkTarget<lua_Integer, lua_Number>(LUA_VERSION_NUM);
+
+int appendDump(lua_State*, const void* data, size_t size, void* userData) {
+    auto* out = static_cast<std::vector<uint8_t>*>(userData);
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    out->insert(out->end(), bytes, bytes + size);
+    return 0;
+}
+
 Timestamp nowMs() {
     const auto now = std::chrono::steady_clock::now().time_since_epoch();
     return static_cast<Timestamp>(std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
@@ -91,8 +103,146 @@ Value coerceToType(const sol::object& obj, ValueType type) {
     throw std::runtime_error("Lua value cannot be coerced to required variable type");
 }
 
+// Tags of the saveGlobals encoding
+enum : uint8_t {
+    kLuaFalse = 0,
+    kLuaTrue = 1,
+    kLuaInteger = 2,
+    kLuaNumber = 3,
+    kLuaString = 4,
+    kLuaTable = 5,   // Key/value pairs follow, then kLuaTableEnd
+    kLuaTableEnd = 6,
+};
+constexpr int kMaxSavedDepth = 16;
+
+// Registry field holding the shallow copy of the globals after initialize()
+constexpr const char* kBaselineKey = "aetherium.baseline";
+
+bool isSavedType(int type) {
+    return type == LUA_TBOOLEAN || type == LUA_TNUMBER || type == LUA_TSTRING || type == LUA_TTABLE;
+}
+
+// Append the value at `index`; false (output unspecified) for anything not saved
+bool encodeLuaValue(lua_State* L, int index, protocol::ByteWriter& out, int depth) {
+    index = lua_absindex(L, index);
+    switch (lua_type(L, index)) {
+        case LUA_TBOOLEAN:
+            out.writeU8(lua_toboolean(L, index) ? kLuaTrue : kLuaFalse);
+            return true;
+        case LUA_TNUMBER: {
+#if LUA_VERSION_NUM >= 503
+            if (lua_isinteger(L, index)) {
+                out.writeU8(kLuaInteger);
+                out.writeU64(static_cast<uint64_t>(lua_tointeger(L, index)));
+                return true;
+            }
+#endif
+            const double number = static_cast<double>(lua_tonumber(L, index));
+            uint64_t bits;
+            std::memcpy(&bits, &number, sizeof(bits));
+            out.writeU8(kLuaNumber);
+            out.writeU64(bits);
+            return true;
+        }
+        case LUA_TSTRING: {
+            size_t len = 0;
+            const char* s = lua_tolstring(L, index, &len);
+            out.writeU8(kLuaString);
+            out.writeU32(static_cast<uint32_t>(len));
+            out.writeRaw(reinterpret_cast<const uint8_t*>(s), len);
+            return true;
+        }
+        case LUA_TTABLE:
+            // The depth cap also cuts reference cycles
+            if (depth >= kMaxSavedDepth || !lua_checkstack(L, 3)) {
+                return false;
+            }
+            out.writeU8(kLuaTable);
+            lua_pushnil(L);
+            while (lua_next(L, index) != 0) {
+                const size_t mark = out.size();
+                if (!encodeLuaValue(L, -2, out, depth + 1) || !encodeLuaValue(L, -1, out, depth + 1)) {
+                    out.truncate(mark);  // Drop the pair, keep the rest of the table
+                }
+                lua_pop(L, 1);
+            }
+            out.writeU8(kLuaTableEnd);
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Push the value whose tag was just read; false on a malformed buffer (nothing pushed)
+bool decodeLuaValue(lua_State* L, protocol::ByteReader& in, uint8_t tag, int depth) {
+    if (!lua_checkstack(L, 3)) {
+        return false;
+    }
+    switch (tag) {
+        case kLuaFalse:
+        case kLuaTrue:
+            lua_pushboolean(L, tag == kLuaTrue);
+            return true;
+        case kLuaInteger: {
+            auto v = in.readU64();
+            if (!v) return false;
+            lua_pushinteger(L, static_cast<lua_Integer>(static_cast<int64_t>(*v)));
+            return true;
+        }
+        case kLuaNumber: {
+            auto bits = in.readU64();
+            if (!bits) return false;
+            double number;
+            std::memcpy(&number, &*bits, sizeof(number));
+            lua_pushnumber(L, static_cast<lua_Number>(number));
+            return true;
+        }
+        case kLuaString: {
+            auto len = in.readU32();
+            auto bytes = len ? in.readRaw(*len) : std::nullopt;
+            if (!bytes) return false;
+            lua_pushlstring(L, reinterpret_cast<const char*>(bytes->data), bytes->size);
+            return true;
+        }
+        case kLuaTable: {
+            if (depth >= kMaxSavedDepth) return false;
+            lua_newtable(L);
+            for (auto keyTag = in.readU8(); keyTag; keyTag = in.readU8()) {
+                if (*keyTag == kLuaTableEnd) {
+                    return true;
+                }
+                if (!decodeLuaValue(L, in, *keyTag, depth + 1)) {
+                    break;
+                }
+                auto valueTag = in.readU8();
+                if (!valueTag || !decodeLuaValue(L, in, *valueTag, depth + 1)) {
+                    lua_pop(L, 1);
+                    break;
+                }
+                lua_rawset(L, -3);
+            }
+            lua_pop(L, 1);
+            return false;
+        }
+        default:
+            return false;
+    }
+}
+
 } // namespace
 
+/**
+ * Variable values live in a shadow table reached through the globals
+ * metatable rather than as raw globals, so every script assignment to a
+ * variable name hits __newindex and is recorded as dirty.
+ */
+struct LuaScriptEngine::VariableMirror {
+    sol::table values;
+    std::vector<VariableId> dirty;
+    std::vector<VariableId> pending;  // Scratch for syncVariablesFromLua
+    uint64_t syncedRevision = 0;      // VariableStore revision mirrored into values
+};
+
 LuaScriptEngine::LuaScriptEngine() = default;
 
 LuaScriptEngine::~LuaScriptEngine() = default;
@@ -100,10 +250,34 @@ LuaScriptEngine::~LuaScriptEngine() = default;
 Result<void> LuaScriptEngine::initialize(VariableStore* variables) {
     variables_ = variables;
 
+    if (lua_ && mirror_) {
+        // The VM and its builtins are up already (a reload, or a pre-warmed
+        // spare): put the globals back instead of building a new state
+        try {
+            chunks_.clear();  // Keyed by block address, which the next automata may reuse
+            auto restored = restoreBaseline();
+            if (restored.isError()) {
+                lastError_ = restored.error();
+                return restored;
+            }
+            installVariableMirror();
+            syncVariablesToLua();
+            clearError();
+            return Result<void>::ok();
+        } catch (const std::exception& e) {
+            lastError_ = e.what();
+            return Result<void>::error(lastError_);
+        }
+    }
+
     try {
         // Delay Lua VM creation until engine initialization so embedded targets
         // do not allocate the VM during global static construction.
-        lua_ = std::make_unique<sol::state>();
+        chunks_.clear();
+        mirror_.reset();
+        lua_.reset();  // Frees the old state before the budget sees the new one
+        lua_ = std::make_unique<sol::state>(sol::default_at_panic, &LuaArena::alloc, &arena_);
+        setGcMode(gcMode_);
         pumpEmbeddedWatchdog();
 
         lua_->open_libraries(
@@ -115,13 +289,35 @@ Result<void> LuaScriptEngine::initialize(VariableStore* variables) {
         pumpEmbeddedWatchdog();
 
         setupBuiltins();
+        installVariableMirror();
         pumpEmbeddedWatchdog();
         syncVariablesToLua();
         clearError();
 
+        // Everything defined so far belongs to the engine, not to a run.
+        // A shallow copy in the registry is what resets restore.
+        baseGlobals_.clear();
+        lua_State* L = lua_->lua_state();
+        lua_newtable(L);
+        lua_pushglobaltable(L);
+        lua_pushnil(L);
+        while (lua_next(L, -2) != 0) {
+            if (lua_type(L, -2) == LUA_TSTRING) {
+                size_t len = 0;
+                const char* key = lua_tolstring(L, -2, &len);
+                baseGlobals_.emplace(key, len);
+            }
+            lua_pushvalue(L, -2);
+            lua_insert(L, -2);
+            lua_rawset(L, -5);
+        }
+        lua_pop(L, 1);
+        lua_setfield(L, LUA_REGISTRYINDEX, kBaselineKey);
+
         return Result<void>::ok();
     } catch (const std::exception& e) {
         lastError_ = e.what();
+        mirror_.reset();
         lua_.reset();
         return Result<void>::error(lastError_);
     }
@@ -144,7 +340,7 @@ void LuaScriptEngine::setupBuiltins() {
             case ValueType::Int64: return sol::make_object(*lua_, val.get<int64_t>());
             case ValueType::Float32: return sol::make_object(*lua_, val.get<float>());
             case ValueType::Float64: return sol::make_object(*lua_, val.get<double>());
-            case ValueType::String: return sol::make_object(*lua_, val.get<std::string>());
+            case ValueType::String: return sol::make_object(*lua_, val.str());
             default: return sol::make_object(*lua_, sol::lua_nil);
         }
     };
@@ -180,7 +376,7 @@ void LuaScriptEngine::setupBuiltins() {
             throw std::runtime_error("setVal cannot write input variable: " + name);
         }
         auto value = coerceToType(obj, var->type());
-        if (!variables_ || !variables_->setValue(name, std::move(value))) {
+        if (!storeFromLua(name, std::move(value))) {
             throw std::runtime_error("setVal rejected write: " + name);
         }
         setLuaGlobalValue(name, var->value());
@@ -223,7 +419,7 @@ void LuaScriptEngine::setupBuiltins() {
             throw std::runtime_error("setOutput expects output variable: " + name);
         }
         auto value = coerceToType(obj, var->type());
-        if (!variables_ || !variables_->setValue(name, std::move(value))) {
+        if (!storeFromLua(name, std::move(value))) {
             throw std::runtime_error("setOutput rejected write: " + name);
         }
         setLuaGlobalValue(name, var->value());
@@ -257,59 +453,65 @@ void LuaScriptEngine::setupBuiltins() {
         return *service;
     };
 
-    auto makeComponentTable = [this](sol::this_state ts, IComponent& component) -> sol::table {
+    // Method ids are resolved when the table is built; a call only packs
+    // its arguments on the stack and dispatches by index.
+    auto callComponent = [](sol::this_state ts, IComponent& component, ComponentMethod method,
+                            sol::variadic_args va) -> sol::object {
         sol::state_view lua(ts);
-        sol::table table = lua.create_table();
+        InlineValueArgs<> args(va.size());
+        size_t index = 0;
+        for (auto arg : va) {
+            args[index++] = toRuntimeValue(sol::object(arg));
+        }
+        auto result = component.call(method, args.span());
+        if (result.isError()) {
+            throw std::runtime_error(result.error());
+        }
 
-        table.set_function("invoke", [&component](sol::this_state innerTs, const std::string& method, sol::variadic_args va) -> sol::object {
-            sol::state_view lua(innerTs);
-            std::vector<Value> args;
-            args.reserve(va.size());
-            for (auto arg : va) {
-                args.push_back(toRuntimeValue(sol::object(arg)));
-            }
-            auto result = component.invoke(method, args);
-            if (result.isError()) {
-                throw std::runtime_error(result.error());
-            }
+        const auto& value = result.value();
+        switch (value.type()) {
+            case ValueType::Bool: return sol::make_object(lua, value.get<bool>());
+            case ValueType::Int32: return sol::make_object(lua, value.get<int32_t>());
+            case ValueType::Int64: return sol::make_object(lua, value.get<int64_t>());
+            case ValueType::Float32: return sol::make_object(lua, value.get<float>());
+            case ValueType::Float64: return sol::make_object(lua, value.get<double>());
+            case ValueType::String: return sol::make_object(lua, value.str());
+            default: return sol::make_object(lua, sol::lua_nil);
+        }
+    };
+
+    auto makeComponentTable = [callComponent](sol::this_state ts, IComponent& component) -> sol::table {
+        sol::state_view lua(ts);
+        sol::table table = lua.create_table();
 
-            const auto& value = result.value();
-            switch (value.type()) {
-                case ValueType::Bool: return sol::make_object(lua, value.get<bool>());
-                case ValueType::Int32: return sol::make_object(lua, value.get<int32_t>());
-                case ValueType::Int64: return sol::make_object(lua, value.get<int64_t>());
-                case ValueType::Float32: return sol::make_object(lua, value.get<float>());
-                case ValueType::Float64: return sol::make_object(lua, value.get<double>());
-                case ValueType::String: return sol::make_object(lua, value.get<std::string>());
-                default: return sol::make_object(lua, sol::lua_nil);
+        table.set_function("invoke", [&component, callComponent](sol::this_state innerTs, const std::string& method, sol::variadic_args va) {
+            const ComponentMethod id = component.resolve(method);
+            if (id == INVALID_COMPONENT_METHOD) {
+                throw std::runtime_error("unknown component method: " + method);
             }
+            return callComponent(innerTs, component, id, va);
         });
 
-        for (const auto& method : component.methods()) {
-            table.set_function(method, [&component, method](sol::this_state innerTs, sol::variadic_args va) -> sol::object {
-                sol::state_view lua(innerTs);
-                std::vector<Value> args;
-                args.reserve(va.size());
-                for (auto arg : va) {
-                    args.push_back(toRuntimeValue(sol::object(arg)));
-                }
-                auto result = component.invoke(method, args);
-                if (result.isError()) {
-                    throw std::runtime_error(result.error());
-                }
-                const auto& value = result.value();
-                switch (value.type()) {
-                    case ValueType::Bool: return sol::make_object(lua, value.get<bool>());
-                    case ValueType::Int32: return sol::make_object(lua, value.get<int32_t>());
-                    case ValueType::Int64: return sol::make_object(lua, value.get<int64_t>());
-                    case ValueType::Float32: return sol::make_object(lua, value.get<float>());
-                    case ValueType::Float64: return sol::make_object(lua, value.get<double>());
-                    case ValueType::String: return sol::make_object(lua, value.get<std::string>());
-                    default: return sol::make_object(lua, sol::lua_nil);
-                }
+        auto bindMethod = [&](const char* method, ComponentMethod id) {
+            table.set_function(method, [&component, id, callComponent](sol::this_state innerTs, sol::variadic_args va) {
+                return callComponent(innerTs, component, id, va);
             });
+        };
+        if (const ComponentDescriptor* descriptor = component.descriptor()) {
+            // Method table in flash: index = method id, no name vector
+            for (uint16_t i = 0; i < descriptor->methodCount; ++i) {
+                bindMethod(descriptor->methods[i].name, static_cast<ComponentMethod>(i));
+            }
+        } else {
+            for (const auto& method : component.methods()) {
+                const ComponentMethod id = component.resolve(method);
+                if (id != INVALID_COMPONENT_METHOD) {
+                    bindMethod(method.c_str(), id);
+                }
+            }
         }
 
+        table["__component"] = static_cast<void*>(&component);
         return table;
     };
 
@@ -380,70 +582,287 @@ void LuaScriptEngine::setupBuiltins() {
         }
         return table;
     });
+    i2c.set_function("write", [requireHardware](int bus, int address, sol::variadic_args va) {
+        std::vector<uint8_t> data;
+        data.reserve(va.size());
+        for (auto arg : va) {
+            data.push_back(static_cast<uint8_t>(arg.as<int>()));
+        }
+        auto result = requireHardware().i2cWrite(bus, address, data);
+        if (result.isError()) throw std::runtime_error(result.error());
+    });
     (*lua_)["i2c"] = i2c;
 
+    // One table per component and Lua state, rebuilt only if the hardware
+    // service hands back a different instance for the name
     lua_->set_function("component", [requireHardware, makeComponentTable](sol::this_state ts, const std::string& name) {
         auto* instance = requireHardware().component(name);
         if (!instance) {
             throw std::runtime_error("unknown component: " + name);
         }
-        return makeComponentTable(ts, *instance);
+        sol::state_view lua(ts);
+        sol::object cacheObject = lua.registry()["aetherium.components"];
+        sol::table cache = cacheObject.is<sol::table>() ? cacheObject.as<sol::table>() : lua.create_table();
+        if (!cacheObject.is<sol::table>()) {
+            lua.registry()["aetherium.components"] = cache;
+        }
+        sol::object cached = cache[name];
+        if (cached.is<sol::table>()) {
+            sol::table table = cached.as<sol::table>();
+            sol::object owner = table["__component"];
+            if (owner.is<void*>() && owner.as<void*>() == static_cast<void*>(instance)) {
+                return table;
+            }
+        }
+        sol::table table = makeComponentTable(ts, *instance);
+        cache[name] = table;
+        return table;
     });
 }
 
+void LuaScriptEngine::installVariableMirror() {
+    mirror_ = std::make_unique<VariableMirror>();
+    mirror_->values = lua_->create_table();
+
+    sol::table meta = lua_->create_table();
+    meta[sol::meta_function::index] = mirror_->values;
+    meta[sol::meta_function::new_index] = [this](sol::table globals, sol::object key, sol::object value) {
+        if (variables_ && key.is<std::string>()) {
+            if (const auto* var = variables_->getByName(key.as<std::string>())) {
+                mirror_->values.raw_set(key, value);
+                auto& dirty = mirror_->dirty;
+                if (std::find(dirty.begin(), dirty.end(), var->id()) == dirty.end()) {
+                    dirty.push_back(var->id());
+                }
+                return;
+            }
+        }
+        globals.raw_set(key, value);
+    };
+    lua_->globals()[sol::metatable_key] = meta;
+}
+
 void LuaScriptEngine::syncVariablesToLua() {
-    if (!variables_) return;
-    
-    for (auto* var : variables_->all()) {
-        setLuaGlobalValue(var->name(), var->value());
-    }
+    if (!variables_ || !mirror_) return;
+
+    variables_->forEachChangedSince(mirror_->syncedRevision, [this](const Variable& var) {
+        setLuaGlobalValue(var.name(), var.value());
+        ++syncedValues_;
+    });
+    mirror_->syncedRevision = variables_->revision();
 }
 
 void LuaScriptEngine::setLuaGlobalValue(const std::string& name, const Value& value) {
-    if (!lua_) {
+    if (!mirror_) {
         return;
     }
 
+    auto& values = mirror_->values;
+
     switch (value.type()) {
         case ValueType::Bool:
-            (*lua_)[name] = value.get<bool>();
+            values[name] = value.get<bool>();
             break;
         case ValueType::Int32:
-            (*lua_)[name] = value.get<int32_t>();
+            values[name] = value.get<int32_t>();
             break;
         case ValueType::Int64:
-            (*lua_)[name] = value.get<int64_t>();
+            values[name] = value.get<int64_t>();
             break;
         case ValueType::Float32:
-            (*lua_)[name] = value.get<float>();
+            values[name] = value.get<float>();
             break;
         case ValueType::Float64:
-            (*lua_)[name] = value.get<double>();
+            values[name] = value.get<double>();
             break;
         case ValueType::String:
-            (*lua_)[name] = value.get<std::string>();
+            values[name] = value.get<std::string>();
             break;
         default:
             break;
     }
 }
 
+bool LuaScriptEngine::storeFromLua(const std::string& name, Value value) {
+    if (!variables_) {
+        return false;
+    }
+
+    // The mirror already holds this value; keep it current unless something
+    // else changed in the store meanwhile (e.g. from a change callback).
+    const uint64_t before = variables_->revision();
+    const bool mirrorCurrent = mirror_ && mirror_->syncedRevision == before;
+    if (!variables_->setValue(name, std::move(value))) {
+        return false;
+    }
+    if (mirrorCurrent && variables_->revision() <= before + 1) {
+        mirror_->syncedRevision = variables_->revision();
+    }
+    return true;
+}
+
 void LuaScriptEngine::syncVariablesFromLua() {
-    if (!variables_) return;
-    
-    for (auto* var : variables_->all()) {
-        if (var->direction() == VariableDirection::Input) continue;
-        
-        const std::string& name = var->name();
-        sol::object obj = (*lua_)[name];
-        
-        if (obj.valid() && obj.get_type() != sol::type::lua_nil) {
-            auto value = coerceToType(obj, var->type());
-            if (!variables_->setValue(name, std::move(value))) {
-                throw std::runtime_error("syncVariablesFromLua rejected write: " + name);
-            }
+    if (!variables_ || !mirror_ || mirror_->dirty.empty()) return;
+
+    auto& pending = mirror_->pending;
+    pending.swap(mirror_->dirty);
+    for (VariableId id : pending) {
+        auto* var = variables_->get(id);
+        if (!var) continue;
+        ++syncedValues_;
+
+        sol::object obj = mirror_->values[var->name()];
+        if (var->direction() == VariableDirection::Input ||
+            !obj.valid() || obj.get_type() == sol::type::lua_nil) {
+            // Scripts cannot write inputs or clear variables; restore the store value.
+            setLuaGlobalValue(var->name(), var->value());
+            continue;
+        }
+
+        auto value = coerceToType(obj, var->type());
+        if (!storeFromLua(var->name(), std::move(value))) {
+            pending.clear();
+            throw std::runtime_error("syncVariablesFromLua rejected write: " + var->name());
         }
     }
+    pending.clear();
+}
+
+void LuaScriptEngine::discardScriptWrites() {
+    if (!variables_ || !mirror_) return;
+
+    for (VariableId id : mirror_->dirty) {
+        if (const auto* var = variables_->get(id)) {
+            setLuaGlobalValue(var->name(), var->value());
+        }
+    }
+    mirror_->dirty.clear();
+}
+
+struct LuaScriptEngine::CompiledChunk {
+    std::string source;
+    std::vector<uint8_t> bytecode;  // Set instead of source when loaded precompiled
+    CodeKind kind = CodeKind::Statement;
+    sol::protected_function function;
+    std::string error;  // Compile error; set instead of function
+
+    [[nodiscard]] bool ok() const { return error.empty(); }
+
+    [[nodiscard]] bool matches(const CodeBlock& code) const {
+        return bytecode.empty() ? source == code.text() : bytecode == code.bytecode;
+    }
+};
+
+const LuaScriptEngine::CompiledChunk& LuaScriptEngine::compiled(const CodeBlock& code, CodeKind kind) {
+    auto& slot = chunks_[&code];
+    // Keyed by address; the content check catches a block that was rewritten
+    // in place or an address reused by a later automata.
+    if (slot && slot->kind == kind && slot->matches(code)) {
+        return *slot;
+    }
+
+    auto chunk = std::make_unique<CompiledChunk>();
+    chunk->kind = kind;
+
+    LuaChunkView precompiled;
+    if (loadableLuaChunk(code, kLuaTarget, kind, precompiled)) {
+        sol::load_result loaded = lua_->load(std::string_view(precompiled.data, precompiled.size),
+                                             "=precompiled", sol::load_mode::binary);
+        if (loaded.valid()) {
+            chunk->bytecode = code.bytecode;
+            chunk->function = loaded.get<sol::protected_function>();
+            slot = std::move(chunk);
+            return *slot;
+        }
+        // A dump the header check passed but Lua refused: use the source
+    }
+
+    const std::string& source = code.text();
+    chunk->source = source;
+    sol::load_result loaded = kind == CodeKind::Expression
+        ? lua_->load("return (" + source + ")")
+        : lua_->load(source);
+    if (loaded.valid()) {
+        chunk->function = loaded.get<sol::protected_function>();
+    } else {
+        sol::error err = loaded;
+        chunk->error = err.what();
+    }
+
+    slot = std::move(chunk);
+    return *slot;
+}
+
+Result<void> precompileLuaChunks(ir::EngineBytecodeProgram& program, bool stripDebug) {
+    std::unique_ptr<lua_State, void (*)(lua_State*)> L(luaL_newstate(), &lua_close);
+    if (!L) {
+        return Result<void>::error("lua precompile: cannot create state");
+    }
+
+    std::vector<ir::BytecodeLuaChunk> chunks;
+    std::string error;
+    auto dump = [&](ir::LuaChunkSlot slot, uint16_t ownerId, const std::string& source, CodeKind kind) {
+        if (source.empty() || !error.empty()) {
+            return;
+        }
+        // Same text (and chunk name) the engine would compile from source
+        const std::string text = kind == CodeKind::Expression ? "return (" + source + ")" : source;
+        if (luaL_loadbufferx(L.get(), text.data(), text.size(), text.c_str(), "t") != LUA_OK) {
+            error = lua_tostring(L.get(), -1);
+            lua_pop(L.get(), 1);
+            return;
+        }
+        ir::BytecodeLuaChunk chunk;
+        chunk.slot = slot;
+        chunk.ownerId = ownerId;
+        lua_dump(L.get(), appendDump, &chunk.bytes, stripDebug ? 1 : 0);
+        lua_pop(L.get(), 1);
+        chunks.push_back(std::move(chunk));
+    };
+
+    for (const auto& st : program.states) {
+        dump(ir::LuaChunkSlot::StateOnEnter, st.id, st.onEnterSource, CodeKind::Statement);
+        dump(ir::LuaChunkSlot::StateBody, st.id, st.bodySource, CodeKind::Statement);
+        dump(ir::LuaChunkSlot::StateOnExit, st.id, st.onExitSource, CodeKind::Statement);
+    }
+    for (const auto& t : program.transitions) {
+        dump(ir::LuaChunkSlot::TransitionCondition, t.id, t.conditionExpression, t.resolvedConditionKind());
+        dump(ir::LuaChunkSlot::TransitionBody, t.id, t.bodySource, CodeKind::Statement);
+        dump(ir::LuaChunkSlot::TransitionTriggered, t.id, t.triggeredSource, CodeKind::Statement);
+    }
+    if (!error.empty()) {
+        return Result<void>::error("lua precompile failed: " + error);
+    }
+
+    program.luaTarget = kLuaTarget;
+    program.luaChunks = std::move(chunks);
+    return Result<void>::ok();
+}
+
+void LuaScriptEngine::prepare(const Automata& automata) {
+    if (!lua_) {
+        return;
+    }
+
+    auto warm = [this](const CodeBlock& code, CodeKind contextual) {
+        if (!code.isEmpty()) {
+            compiled(code, code.resolvedKind(contextual));
+        }
+    };
+
+    for (const auto& [id, state] : automata.states) {
+        warm(state.onEnter, CodeKind::Statement);
+        warm(state.body, CodeKind::Statement);
+        warm(state.onExit, CodeKind::Statement);
+    }
+    for (const auto& [id, transition] : automata.transitions) {
+        warm(transition.classicConfig.condition, CodeKind::Expression);
+        warm(transition.timedConfig.additionalCondition, CodeKind::Expression);
+        warm(transition.eventConfig.additionalCondition, CodeKind::Expression);
+        warm(transition.probConfig.weightExpression, CodeKind::Expression);
+        warm(transition.body, CodeKind::Statement);
+        warm(transition.triggered, CodeKind::Statement);
+    }
 }
 
 Result<Value> LuaScriptEngine::execute(const CodeBlock& code) {
@@ -458,9 +877,15 @@ Result<Value> LuaScriptEngine::execute(const CodeBlock& code) {
     syncVariablesToLua();
     
     try {
-        auto result = lua_->safe_script(code.source, sol::script_pass_on_error);
-        
+        const auto& chunk = compiled(code, code.resolvedKind(CodeKind::Statement));
+        if (!chunk.ok()) {
+            lastError_ = chunk.error;
+            return Result<Value>::error(lastError_);
+        }
+
+        sol::protected_function_result result = chunk.function();
         if (!result.valid()) {
+            discardScriptWrites();
             sol::error err = result;
             lastError_ = err.what();
             return Result<Value>::error(lastError_);
@@ -504,18 +929,23 @@ Result<bool> LuaScriptEngine::evaluateCondition(const CodeBlock& code) {
     syncVariablesToLua();
     
     try {
-        // Wrap expression to ensure it returns a value
-        std::string expr = "return (" + code.source + ")";
-        auto result = lua_->safe_script(expr, sol::script_pass_on_error);
-        
+        const auto& chunk = compiled(code, code.resolvedKind(CodeKind::Expression));
+        if (!chunk.ok()) {
+            lastError_ = chunk.error;
+            return Result<bool>::error(lastError_);
+        }
+
+        // Guards are side-effect free: global writes never reach the store.
+        sol::protected_function_result result = chunk.function();
+        discardScriptWrites();
         if (!result.valid()) {
-            // Try executing as-is (might be a statement that sets variables)
-            result = lua_->safe_script(code.source, sol::script_pass_on_error);
-            if (!result.valid()) {
-                sol::error err = result;
-                lastError_ = err.what();
-                return Result<bool>::error(lastError_);
-            }
+            sol::error err = result;
+            lastError_ = err.what();
+            return Result<bool>::error(lastError_);
+        }
+
+        // A statement guard that returns nothing does not block the transition.
+        if (result.return_count() == 0) {
             return Result<bool>::ok(true);
         }
         
@@ -550,9 +980,14 @@ Result<double> LuaScriptEngine::evaluateWeight(const CodeBlock& code) {
     syncVariablesToLua();
     
     try {
-        std::string expr = "return (" + code.source + ")";
-        auto result = lua_->safe_script(expr, sol::script_pass_on_error);
-        
+        const auto& chunk = compiled(code, code.resolvedKind(CodeKind::Expression));
+        if (!chunk.ok()) {
+            lastError_ = chunk.error;
+            return Result<double>::error(lastError_);
+        }
+
+        sol::protected_function_result result = chunk.function();
+        discardScriptWrites();
         if (!result.valid()) {
             sol::error err = result;
             lastError_ = err.what();
@@ -593,4 +1028,185 @@ void LuaScriptEngine::collectGarbage() {
     }
 }
 
+Result<std::vector<uint8_t>> LuaScriptEngine::saveGlobals() {
+    using R = Result<std::vector<uint8_t>>;
+    if (!lua_) {
+        return R::ok({});
+    }
+    lua_State* L = lua_->lua_state();
+    const int top = lua_gettop(L);
+    try {
+        protocol::ByteWriter out(64);
+        lua_pushglobaltable(L);
+        lua_pushnil(L);
+        while (lua_next(L, -2) != 0) {
+            if (lua_type(L, -2) == LUA_TSTRING && isSavedType(lua_type(L, -1))) {
+                size_t len = 0;
+                const char* key = lua_tolstring(L, -2, &len);
+                if (baseGlobals_.count(std::string(key, len)) == 0) {
+                    const size_t mark = out.size();
+                    out.writeU32(static_cast<uint32_t>(len));
+                    out.writeRaw(reinterpret_cast<const uint8_t*>(key), len);
+                    if (!encodeLuaValue(L, -1, out, 0)) {
+                        out.truncate(mark);
+                    }
+                }
+            }
+            lua_pop(L, 1);
+        }
+        lua_settop(L, top);
+        return R::ok(out.finish());
+    } catch (const std::exception& e) {
+        lua_settop(L, top);
+        return R::error(e.what());
+    }
+}
+
+Result<void> LuaScriptEngine::restoreGlobals(const uint8_t* data, size_t size) {
+    using R = Result<void>;
+    if (!lua_) {
+        return size == 0 ? R::ok() : R::error("Lua state not initialized");
+    }
+    lua_State* L = lua_->lua_state();
+    const int top = lua_gettop(L);
+    try {
+        lua_pushglobaltable(L);
+
+        // Data globals the run created since; functions stay
+        std::vector<std::string> stale;
+        lua_pushnil(L);
+        while (lua_next(L, -2) != 0) {
+            if (lua_type(L, -2) == LUA_TSTRING && isSavedType(lua_type(L, -1))) {
+                size_t len = 0;
+                const char* key = lua_tolstring(L, -2, &len);
+                std::string name(key, len);
+                if (baseGlobals_.count(name) == 0) {
+                    stale.push_back(std::move(name));
+                }
+            }
+            lua_pop(L, 1);
+        }
+        for (const auto& name : stale) {
+            lua_pushlstring(L, name.data(), name.size());
+            lua_pushnil(L);
+            lua_rawset(L, -3);
+        }
+
+        protocol::ByteReader in(data, size);
+        while (in.hasMore()) {
+            auto len = in.readU32();
+            auto key = len ? in.readRaw(*len) : std::nullopt;
+            auto tag = key ? in.readU8() : std::nullopt;
+            if (!tag) {
+                lua_settop(L, top);
+                return R::error("saved script globals are corrupt");
+            }
+            lua_pushlstring(L, reinterpret_cast<const char*>(key->data), key->size);
+            if (!decodeLuaValue(L, in, *tag, 0)) {
+                lua_settop(L, top);
+                return R::error("saved script globals are corrupt");
+            }
+            lua_rawset(L, -3);
+        }
+        lua_settop(L, top);
+        return R::ok();
+    } catch (const std::exception& e) {
+        lua_settop(L, top);
+        return R::error(e.what());
+    }
+}
+
+Result<void> LuaScriptEngine::resetGlobals() {
+    if (!lua_) {
+        return Result<void>::ok();
+    }
+    try {
+        auto restored = restoreBaseline();
+        if (restored.isError()) {
+            return restored;
+        }
+        if (mirror_) {
+            // Scripts may have written variables the store never took back
+            mirror_->dirty.clear();
+            mirror_->syncedRevision = 0;
+            syncVariablesToLua();
+        }
+        clearError();
+        return Result<void>::ok();
+    } catch (const std::exception& e) {
+        return Result<void>::error(e.what());
+    }
+}
+
+Result<void> LuaScriptEngine::restoreBaseline() {
+    lua_State* L = lua_->lua_state();
+    const int top = lua_gettop(L);
+    lua_getfield(L, LUA_REGISTRYINDEX, kBaselineKey);
+    if (!lua_istable(L, -1)) {
+        lua_settop(L, top);
+        return Result<void>::error("Lua baseline globals missing");
+    }
+    lua_pushglobaltable(L);
+
+    // Globals the baseline does not have go, overwritten ones get their
+    // value back. Both only touch existing fields, which lua_next allows.
+    lua_pushnil(L);
+    while (lua_next(L, -2) != 0) {  // baseline, globals, key, value
+        lua_pushvalue(L, -2);
+        lua_rawget(L, -5);
+        if (lua_isnil(L, -1)) {
+            lua_pop(L, 1);
+            lua_pushvalue(L, -2);
+            lua_pushnil(L);
+            lua_rawset(L, -5);
+        } else if (!lua_rawequal(L, -1, -2)) {
+            lua_pushvalue(L, -3);
+            lua_insert(L, -2);
+            lua_rawset(L, -5);
+        } else {
+            lua_pop(L, 1);
+        }
+        lua_pop(L, 1);
+    }
+
+    // Baseline globals a script set to nil
+    lua_pushnil(L);
+    while (lua_next(L, -3) != 0) {  // baseline, globals, key, value
+        lua_pushvalue(L, -2);
+        lua_rawget(L, -4);
+        if (lua_isnil(L, -1)) {
+            lua_pop(L, 1);
+            lua_pushvalue(L, -2);
+            lua_insert(L, -2);
+            lua_rawset(L, -4);
+        } else {
+            lua_pop(L, 2);
+        }
+    }
+    lua_settop(L, top);
+    return Result<void>::ok();
+}
+
+void LuaScriptEngine::setGcMode(GcMode mode) {
+    gcMode_ = mode;
+    if (!lua_) {
+        return;
+    }
+#if defined(LUA_GCGEN)
+    // Zero keeps Lua's default tuning parameters
+    if (mode == GcMode::Generational) {
+        lua_gc(lua_->lua_state(), LUA_GCGEN, 0, 0);
+    } else {
+        lua_gc(lua_->lua_state(), LUA_GCINC, 0, 0, 0);
+    }
+#endif
+}
+
+bool LuaScriptEngine::stepGarbage(uint32_t stepKb) {
+    if (!lua_) {
+        return true;
+    }
+    return lua_gc(lua_->lua_state(), LUA_GCSTEP, static_cast<int>(stepKb)) != 0;
+}
+
 } // namespace aeth
@@ -7,8 +7,13 @@
 #ifndef AETHERIUM_LUA_ENGINE_HPP
 #define AETHERIUM_LUA_ENGINE_HPP
 
+#include "artifact.hpp"
+#include "lua_arena.hpp"
 #include "runtime.hpp"
 
+#include <unordered_map>
+#include <unordered_set>
+
 // Forward declare sol types to avoid header pollution
 namespace sol {
     class state;
@@ -28,32 +33,99 @@ public:
     Result<Value> execute(const CodeBlock& code) override;
     Result<bool> evaluateCondition(const CodeBlock& code) override;
     Result<double> evaluateWeight(const CodeBlock& code) override;
+
+    /**
+     * Compile every hook, body and guard of the automata into cached chunks.
+     * Later calls with the same block reuse the compiled function.
+     */
+    void prepare(const Automata& automata) override;
+
+    std::unique_ptr<IScriptEngine> createInstance() const override {
+        return std::make_unique<LuaScriptEngine>();
+    }
+
+    // Builtins reach the store through variables_, so a move only needs the pointer
+    void rebindVariables(VariableStore* variables) override { variables_ = variables; }
+
     std::string lastError() const override;
     void clearError() override;
     void setLogHandler(std::function<void(const std::string& level,
                                           const std::string& message)> handler) override;
     
     /**
-     * Run Lua garbage collection to free memory.
-     * Call periodically (e.g., every 100 ticks) to prevent memory buildup.
+     * Run a full Lua garbage collection. The runtime only does this in
+     * GcMode::Full; otherwise it steps the collector in idle time.
      */
     void collectGarbage() override;
 
+    // LUA_GCGEN / LUA_GCINC where the Lua has them (5.4+)
+    void setGcMode(GcMode mode) override;
+    bool stepGarbage(uint32_t stepKb) override;
+    [[nodiscard]] size_t memoryInUse() const override { return arena_.stats().inUse; }
+
     void setReplayMode(bool enabled) override { replayMode_ = enabled; }
 
+    [[nodiscard]] uint64_t syncedValueCount() const override { return syncedValues_; }
+
+    // The state allocates from arena_, which keeps these counters
+    [[nodiscard]] uint64_t allocatedBytes() const override { return arena_.stats().allocated; }
+    void setMemoryBudget(size_t bytes) override { arena_.setBudget(bytes); }
+    [[nodiscard]] ScriptMemoryStats memoryStats() const override { return arena_.stats(); }
+
+    /**
+     * Globals scripts created: booleans, numbers, strings and tables of
+     * them (nested up to 16 deep). Functions and the globals present after
+     * initialize() (libraries, builtins) are not saved; restoring clears
+     * the other data globals first.
+     */
+    Result<std::vector<uint8_t>> saveGlobals() override;
+    Result<void> restoreGlobals(const uint8_t* data, size_t size) override;
+
+    /**
+     * Back to the globals initialize() left: anything scripts added is
+     * removed and overwritten or deleted entries get their value back.
+     * Shallow: fields scripts changed inside library tables stay changed.
+     * Compiled chunks and builtins are kept, and initialize() on a live
+     * VM takes this path too (dropping the chunks) instead of rebuilding.
+     */
+    Result<void> resetGlobals() override;
+
 private:
+    struct CompiledChunk;
+    struct VariableMirror;
+
+    const CompiledChunk& compiled(const CodeBlock& code, CodeKind kind);
     void setupBuiltins();
+    void installVariableMirror();
     void setLuaGlobalValue(const std::string& name, const Value& value);
+    bool storeFromLua(const std::string& name, Value value);
     void syncVariablesToLua();
     void syncVariablesFromLua();
+    void discardScriptWrites();
+    Result<void> restoreBaseline();
 
+    // Declared before lua_: lua_close still frees through it
+    LuaArena arena_;
     std::unique_ptr<sol::state> lua_;
+    // Declared after lua_ so cached functions are released before the state.
+    std::unordered_map<const CodeBlock*, std::unique_ptr<CompiledChunk>> chunks_;
+    std::unique_ptr<VariableMirror> mirror_;
     VariableStore* variables_ = nullptr;
     std::string lastError_;
     std::function<void(const std::string&, const std::string&)> logHandler_;
     bool replayMode_ = false;
+    uint64_t syncedValues_ = 0;
+    std::unordered_set<std::string> baseGlobals_;  // Keys present after initialize()
+    GcMode gcMode_ = GcPolicy{}.mode;
 };
 
+/**
+ * Artifact build step: lua_dump every hook, body and guard of `program`
+ * with this build's Lua. Engines whose Lua matches program.luaTarget load
+ * the chunks instead of parsing the sources. Fails on a syntax error.
+ */
+Result<void> precompileLuaChunks(ir::EngineBytecodeProgram& program, bool stripDebug = false);
+
 } // namespace aeth
 
 #endif // AETHERIUM_LUA_ENGINE_HPP
@@ -0,0 +1,94 @@
+/**
+ * Aetherium Automata - Mapped File
+ *
+ * Read-only view of a whole file. On POSIX hosts the file is mmap'd so a
+ * large artifact costs page faults only for the parts that are touched;
+ * elsewhere (or when mapping fails) the contents are read into memory.
+ */
+
+#ifndef AETHERIUM_MAPPED_FILE_HPP
+#define AETHERIUM_MAPPED_FILE_HPP
+
+#include "types.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if !defined(ARDUINO) && !defined(AETHERIUM_PLATFORM_MCXN947) && !defined(_WIN32)
+#define AETHERIUM_MAPPED_FILE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace aeth {
+
+class MappedFile {
+public:
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+#if defined(AETHERIUM_MAPPED_FILE_MMAP)
+        if (mapped_ != nullptr) {
+            ::munmap(mapped_, size_);
+        }
+#endif
+    }
+
+    static Result<std::shared_ptr<MappedFile>> open(const std::string& path) {
+        std::shared_ptr<MappedFile> file(new MappedFile());
+#if defined(AETHERIUM_MAPPED_FILE_MMAP)
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return Result<std::shared_ptr<MappedFile>>::error("cannot open file: " + path);
+        }
+        struct stat info {};
+        if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+            ::close(fd);
+            return Result<std::shared_ptr<MappedFile>>::error("not a regular file: " + path);
+        }
+        if (info.st_size > 0) {
+            void* addr = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                file->mapped_ = addr;
+                file->size_ = static_cast<size_t>(info.st_size);
+                file->data_ = static_cast<const uint8_t*>(addr);
+            }
+        }
+        ::close(fd);
+        if (file->mapped_ != nullptr || info.st_size == 0) {
+            return Result<std::shared_ptr<MappedFile>>::ok(std::move(file));
+        }
+#endif
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            return Result<std::shared_ptr<MappedFile>>::error("cannot open file: " + path);
+        }
+        file->buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        file->data_ = file->buffer_.data();
+        file->size_ = file->buffer_.size();
+        return Result<std::shared_ptr<MappedFile>>::ok(std::move(file));
+    }
+
+    [[nodiscard]] const uint8_t* data() const { return data_; }
+    [[nodiscard]] size_t size() const { return size_; }
+    [[nodiscard]] bool mapped() const { return mapped_ != nullptr; }
+
+private:
+    MappedFile() = default;
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    void* mapped_ = nullptr;
+    std::vector<uint8_t> buffer_;
+};
+
+} // namespace aeth
+
+#endif // AETHERIUM_MAPPED_FILE_HPP
@@ -0,0 +1,135 @@
+/**
+ * Aetherium Automata - Message Pool
+ *
+ * Class-level allocation for hot protocol messages. A message type derives
+ * from PooledMessage<T>; `new T` / `std::make_unique<T>` then take a block
+ * from a per-thread free list and deleting the object (through
+ * unique_ptr<Message> or otherwise) puts the block back. Existing
+ * ownership (Replies, ITransport::send) is unchanged.
+ *
+ * Blocks freed on another thread than the one that allocated them land on
+ * the freeing thread's list; each list is capped so that pattern stays
+ * bounded. Embedded targets are single-threaded and use plain statics.
+ */
+
+#ifndef AETHERIUM_MESSAGE_POOL_HPP
+#define AETHERIUM_MESSAGE_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#if defined(ARDUINO) || defined(AETHERIUM_PLATFORM_MCXN947)
+#define AETHERIUM_POOL_THREAD_LOCAL
+#else
+#include <atomic>
+#define AETHERIUM_POOL_THREAD_LOCAL thread_local
+#endif
+
+namespace aeth {
+namespace protocol {
+
+// ============================================================================
+// Counters
+// ============================================================================
+
+namespace detail {
+#if defined(ARDUINO) || defined(AETHERIUM_PLATFORM_MCXN947)
+inline uint64_t g_messageHeapAllocations = 0;
+inline void countMessageHeapAllocation() { ++g_messageHeapAllocations; }
+inline uint64_t loadMessageHeapAllocations() { return g_messageHeapAllocations; }
+#else
+inline std::atomic<uint64_t> g_messageHeapAllocations{0};
+inline void countMessageHeapAllocation() {
+    g_messageHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+}
+inline uint64_t loadMessageHeapAllocations() {
+    return g_messageHeapAllocations.load(std::memory_order_relaxed);
+}
+#endif
+} // namespace detail
+
+/**
+ * Pooled messages that had to come from the heap (process-wide). Flat
+ * once every pool has warmed up.
+ */
+inline uint64_t messageHeapAllocations() {
+    return detail::loadMessageHeapAllocations();
+}
+
+// ============================================================================
+// PooledMessage
+// ============================================================================
+
+template <typename T>
+class PooledMessage {
+public:
+    // Blocks kept per type per thread; extra frees go back to the heap
+    static constexpr size_t MAX_CACHED = 256;
+
+    static void* operator new(size_t size) {
+        if (size == sizeof(T) && !listDestroyed()) {
+            FreeList& list = freeList();
+            if (list.head) {
+                Block* block = list.head;
+                list.head = block->next;
+                --list.count;
+                return block;
+            }
+        }
+        detail::countMessageHeapAllocation();
+        return ::operator new(size < sizeof(Block) ? sizeof(Block) : size);
+    }
+
+    static void operator delete(void* ptr, size_t size) noexcept {
+        if (!ptr) {
+            return;
+        }
+        if (size == sizeof(T) && !listDestroyed()) {
+            FreeList& list = freeList();
+            if (list.count < MAX_CACHED) {
+                Block* block = static_cast<Block*>(ptr);
+                block->next = list.head;
+                list.head = block;
+                ++list.count;
+                return;
+            }
+        }
+        ::operator delete(ptr);
+    }
+
+private:
+    struct Block {
+        Block* next;
+    };
+
+    struct FreeList {
+        Block* head = nullptr;
+        size_t count = 0;
+
+        ~FreeList() {
+            while (head) {
+                Block* next = head->next;
+                ::operator delete(head);
+                head = next;
+            }
+            listDestroyed() = true;
+        }
+    };
+
+    static FreeList& freeList() {
+        static AETHERIUM_POOL_THREAD_LOCAL FreeList list;
+        return list;
+    }
+
+    // Trivially destructible, so still readable while thread-locals are torn down
+    static bool& listDestroyed() {
+        static AETHERIUM_POOL_THREAD_LOCAL bool destroyed = false;
+        return destroyed;
+    }
+};
+
+} // namespace protocol
+} // namespace aeth
+
+#endif // AETHERIUM_MESSAGE_POOL_HPP
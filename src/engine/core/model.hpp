@@ -14,8 +14,10 @@
 #include "types.hpp"
 #include "variable.hpp"
 #include <algorithm>
+#include <memory>
 #include <vector>
 #include <optional>
+#include <string_view>
 #include <unordered_map>
 
 namespace aeth {
@@ -24,16 +26,42 @@ namespace aeth {
 // Code Block (Lua code reference)
 // ============================================================================
 
+/**
+ * How a code block's source is compiled.
+ * Contextual blocks are expressions when used as guards/weights and
+ * statements when used as hooks/bodies.
+ */
+enum class CodeKind : uint8_t {
+    Contextual = 0,
+    Expression = 1,  // Compiled as `return (<source>)`
+    Statement = 2    // Compiled as-is; an explicit `return` supplies the result
+};
+
 /**
  * Represents executable code (Lua source or bytecode reference)
  */
 struct CodeBlock {
-    std::string source;           // Lua source code
+    mutable std::string source;   // Lua source code (filled from mappedSource by text())
     std::vector<uint8_t> bytecode; // Compiled bytecode (optional)
     ValueType returnType = ValueType::Void;
+    CodeKind kind = CodeKind::Contextual;
+    // Source left in place in a mapped artifact (Automata::codeStorage keeps it alive)
+    std::string_view mappedSource;
+
+    [[nodiscard]] CodeKind resolvedKind(CodeKind contextual) const {
+        return kind == CodeKind::Contextual ? contextual : kind;
+    }
+
+    // Source text; a mapped block is copied out the first time it is asked for
+    [[nodiscard]] const std::string& text() const {
+        if (source.empty() && !mappedSource.empty()) {
+            source.assign(mappedSource.data(), mappedSource.size());
+        }
+        return source;
+    }
 
     [[nodiscard]] bool isEmpty() const { 
-        return source.empty() && bytecode.empty(); 
+        return source.empty() && mappedSource.empty() && bytecode.empty(); 
     }
 
     [[nodiscard]] bool hasBytecode() const { 
@@ -203,6 +231,9 @@ struct Transition {
     // Enabled state
     bool enabled = true;
 
+    // Variables the guard reads; overrides source analysis in reactive tick mode
+    std::vector<std::string> dependsOn;
+
     // Metadata
     std::string description;
 
@@ -272,6 +303,9 @@ public:
     std::optional<AutomataId> parentId;
     std::vector<AutomataId> nestedIds;
 
+    // Owner of the bytes CodeBlock::mappedSource points into (mapped file or buffer)
+    std::shared_ptr<const void> codeStorage;
+
     // ========================================================================
     // Accessors
     // ========================================================================
@@ -516,6 +550,13 @@ inline std::vector<std::string> Automata::validate() const {
         if (states.find(t.to) == states.end()) {
             errors.push_back("Transition " + t.name + " references non-existent target state");
         }
+        if (t.type == TransitionType::Event) {
+            for (const auto& trigger : t.eventConfig.triggers) {
+                if (!getVariableSpecByName(trigger.signalName)) {
+                    errors.push_back("Transition " + t.name + " triggers on unknown signal " + trigger.signalName);
+                }
+            }
+        }
     }
 
     for (const auto& port : blackBox.ports) {
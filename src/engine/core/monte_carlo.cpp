@@ -0,0 +1,271 @@
+#include "monte_carlo.hpp"
+#include "work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+namespace aeth {
+
+namespace {
+
+constexpr size_t kMaxReportedErrors = 8;
+
+// What one run leaves behind; everything else goes with the reset
+struct RunOutcome {
+    bool ok = false;
+    std::string error;
+    std::vector<uint64_t> visits;            // Per state slot
+    std::vector<Timestamp> firstVisit;       // Per state slot, kNever if not reached
+    FaultStats faults;
+    uint64_t ticks = 0;
+    uint64_t transitions = 0;
+    uint64_t inputsRefused = 0;
+};
+
+constexpr Timestamp kNever = ~Timestamp{0};
+
+Timestamp percentile(const std::vector<Timestamp>& sorted, double q) {
+    const size_t index = static_cast<size_t>(q * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+FaultStats operator-(const FaultStats& a, const FaultStats& b) {
+    FaultStats out;
+    out.decisions = a.decisions - b.decisions;
+    out.delayed = a.delayed - b.delayed;
+    out.dropped = a.dropped - b.dropped;
+    out.degraded = a.degraded - b.degraded;
+    out.disconnected = a.disconnected - b.disconnected;
+    out.duplicated = a.duplicated - b.duplicated;
+    return out;
+}
+
+} // namespace
+
+uint64_t monteCarloRunSeed(uint64_t baseSeed, size_t run) {
+    // splitmix64: neighbouring runs get unrelated seeds
+    uint64_t z = baseSeed + 0x9E3779B97F4A7C15ull * (static_cast<uint64_t>(run) + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+const StateVisitStats* MonteCarloReport::findState(const std::string& name) const {
+    for (const auto& state : states) {
+        if (state.name == name) {
+            return &state;
+        }
+    }
+    return nullptr;
+}
+
+std::string MonteCarloReport::summary() const {
+    std::ostringstream oss;
+    oss << "Runs: " << runs << " (" << failedRuns << " failed)\n";
+    oss << "Ticks: " << ticks << ", transitions: " << transitions << "\n";
+    oss << "State visits (runs reaching it, first entry min/p50/p90/max ms):\n";
+    for (const auto& s : states) {
+        oss << "  " << std::left << std::setw(16) << s.name << std::right << " visits " << s.visits << ", "
+            << s.runsVisited << "/" << runs;
+        if (s.runsVisited > 0) {
+            oss << ", first " << s.firstMinMs << "/" << s.firstP50Ms << "/" << s.firstP90Ms << "/" << s.firstMaxMs;
+        }
+        oss << "\n";
+    }
+    if (faults.decisions > 0) {
+        oss << "Faults: " << faults.decisions << " decisions, " << faults.delayed << " delayed, " << faults.dropped
+            << " dropped, " << faults.degraded << " degraded, " << faults.disconnected << " disconnected, "
+            << faults.duplicated << " duplicated\n";
+    }
+    if (inputsRefused > 0) {
+        oss << "Inputs refused: " << inputsRefused << "\n";
+    }
+    for (const auto& error : errors) {
+        oss << "Error: " << error << "\n";
+    }
+    return oss.str();
+}
+
+Result<MonteCarloReport> runMonteCarlo(const std::string& automataFile,
+                                       const InputTimeline& timeline,
+                                       const MonteCarloOptions& options) {
+    using R = Result<MonteCarloReport>;
+    const SimulationOptions& sim = options.simulation;
+    if (sim.durationMs == 0 && sim.maxTicks == 0 && sim.maxTransitions == 0) {
+        return R::error("Monte-Carlo runs need a duration, tick or transition limit");
+    }
+    if (options.runs == 0) {
+        return R::error("Monte-Carlo needs at least one run");
+    }
+
+    EngineInitOptions engineOptions = options.engine;
+    engineOptions.virtualTime = true;
+    engineOptions.traceEnabled = false;
+    engineOptions.traceOutputPath.reset();
+    engineOptions.spareScriptEngines = 0;  // Runs reset in place, nothing is hot-swapped
+
+    std::vector<RunOutcome> outcomes(options.runs);
+    std::vector<StateId> stateIds;  // Slot -> id, filled by the first worker to load
+    std::vector<std::string> stateNames;
+    std::mutex setupMutex;
+    std::string setupError;
+    std::atomic<size_t> nextRun{0};
+
+    WorkStealingPool pool(options.workers);
+    const size_t workers = std::min(pool.workerCount(), options.runs);
+
+    for (size_t w = 0; w < workers; ++w) {
+        pool.submit([&] {
+            auto clockOwner = std::make_unique<VirtualClock>();
+            VirtualClock& clock = *clockOwner;
+            Engine engine(std::move(clockOwner), std::make_unique<StdRandomSource>(), makeDefaultScriptEngine());
+            auto fail = [&](const std::string& error) {
+                std::lock_guard<std::mutex> lock(setupMutex);
+                if (setupError.empty()) {
+                    setupError = error;
+                }
+                nextRun.store(options.runs);  // Stop the other workers too
+            };
+            if (auto init = engine.initialize(engineOptions); init.isError()) {
+                return fail("initialize: " + init.error());
+            }
+            auto load = engine.loadAutomataFromFile(automataFile, protocolv2::LoadReplaceMode::HardReset);
+            if (load.isError()) {
+                return fail(load.error());
+            }
+
+            // Slots in state id order, the same in every worker
+            std::vector<StateId> ids;
+            for (const auto& entry : engine.automata()->states) {
+                ids.push_back(entry.first);
+            }
+            std::sort(ids.begin(), ids.end());
+            {
+                std::lock_guard<std::mutex> lock(setupMutex);
+                if (stateIds.empty()) {
+                    stateIds = ids;
+                    for (StateId id : ids) {
+                        stateNames.push_back(engine.automata()->states.at(id).name);
+                    }
+                }
+            }
+            std::unordered_map<StateId, size_t> slotOf;
+            for (size_t i = 0; i < ids.size(); ++i) {
+                slotOf[ids[i]] = i;
+            }
+
+            RunOutcome* current = nullptr;
+            Timestamp runStart = 0;
+            auto enter = [&](StateId state, Timestamp at) {
+                auto it = slotOf.find(state);
+                if (it == slotOf.end()) {
+                    return;
+                }
+                ++current->visits[it->second];
+                Timestamp& first = current->firstVisit[it->second];
+                if (first == kNever) {
+                    first = at - runStart;
+                }
+            };
+            engine.setStateObserver(
+                [&](StateId, StateId to, TransitionId, Timestamp at) { enter(to, at); });
+
+            for (size_t run = nextRun++; run < options.runs; run = nextRun++) {
+                RunOutcome& outcome = outcomes[run];
+                outcome.visits.assign(ids.size(), 0);
+                outcome.firstVisit.assign(ids.size(), kNever);
+                current = &outcome;
+
+                if (engine.isRunning()) {
+                    engine.stop();
+                }
+                const uint64_t seed = monteCarloRunSeed(options.baseSeed, run);
+                engine.setSeed(seed, seed);
+                if (auto reset = engine.reset(); reset.isError()) {
+                    outcome.error = "reset: " + reset.error();
+                    continue;
+                }
+                const EngineStatus before = engine.status();
+                const FaultStats faultsBefore = engine.faultStats();
+                runStart = clock.now();
+                if (auto start = engine.start(); start.isError()) {
+                    outcome.error = "start: " + start.error();
+                    continue;
+                }
+                enter(engine.status().currentState, runStart);
+
+                auto simulated = runSimulation(engine, clock, timeline, sim);
+                if (simulated.isError()) {
+                    // Same timeline for every run: no point trying the next one
+                    return fail(simulated.error());
+                }
+                const EngineStatus after = engine.status();
+                outcome.ok = true;
+                outcome.ticks = simulated.value().ticks;
+                outcome.transitions = after.transitionCount - before.transitionCount;
+                outcome.inputsRefused = simulated.value().inputErrors.size();
+                outcome.faults = engine.faultStats() - faultsBefore;
+            }
+            engine.setStateObserver(nullptr);
+        });
+    }
+    pool.waitIdle();
+
+    if (!setupError.empty()) {
+        return R::error(setupError);
+    }
+
+    MonteCarloReport report;
+    report.runs = options.runs;
+    std::vector<std::vector<Timestamp>> firsts(stateIds.size());
+    report.states.resize(stateIds.size());
+    for (size_t i = 0; i < stateIds.size(); ++i) {
+        report.states[i].state = stateIds[i];
+        report.states[i].name = stateNames[i];
+    }
+    for (size_t run = 0; run < outcomes.size(); ++run) {
+        const RunOutcome& outcome = outcomes[run];
+        if (!outcome.ok) {
+            ++report.failedRuns;
+            if (report.errors.size() < kMaxReportedErrors) {
+                report.errors.push_back("run " + std::to_string(run) + ": " + outcome.error);
+            }
+            continue;
+        }
+        report.ticks += outcome.ticks;
+        report.transitions += outcome.transitions;
+        report.inputsRefused += outcome.inputsRefused;
+        report.faults += outcome.faults;
+        for (size_t i = 0; i < stateIds.size(); ++i) {
+            report.states[i].visits += outcome.visits[i];
+            if (outcome.firstVisit[i] != kNever) {
+                ++report.states[i].runsVisited;
+                firsts[i].push_back(outcome.firstVisit[i]);
+            }
+        }
+    }
+    for (size_t i = 0; i < stateIds.size(); ++i) {
+        auto& times = firsts[i];
+        if (times.empty()) {
+            continue;
+        }
+        std::sort(times.begin(), times.end());
+        StateVisitStats& s = report.states[i];
+        s.firstMinMs = times.front();
+        s.firstMaxMs = times.back();
+        s.firstP50Ms = percentile(times, 0.5);
+        s.firstP90Ms = percentile(times, 0.9);
+        double sum = 0.0;
+        for (Timestamp t : times) {
+            sum += static_cast<double>(t);
+        }
+        s.firstMeanMs = sum / static_cast<double>(times.size());
+    }
+    return R::ok(std::move(report));
+}
+
+} // namespace aeth
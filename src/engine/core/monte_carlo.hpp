@@ -0,0 +1,80 @@
+/**
+ * Aetherium Automata - Monte-Carlo Runner
+ *
+ * Runs one automaton thousands of times in virtual time, each run with its
+ * own seed for probabilistic transitions and fault injection, and reports
+ * how the runs went in aggregate: how often each state was entered, in how
+ * many runs, how long until it was first reached, and what the fault
+ * profile did to the messages.
+ *
+ * Each worker owns one Engine (runtime and script state), loads the
+ * automaton once and resets it between runs. Runs keep no trace; only the
+ * per-run counters survive. Results are merged in run order, so a report
+ * does not depend on the worker count.
+ */
+
+#ifndef AETHERIUM_MONTE_CARLO_HPP
+#define AETHERIUM_MONTE_CARLO_HPP
+
+#include "simulation.hpp"
+
+#include <string>
+#include <vector>
+
+namespace aeth {
+
+struct MonteCarloOptions {
+    size_t runs = 1000;
+    size_t workers = 0;  // 0 = one per hardware thread
+    uint64_t baseSeed = 1;
+    // Needs durationMs, maxTicks or maxTransitions: a probabilistic loop never settles
+    SimulationOptions simulation;
+    // Per-worker engine; virtualTime is forced on and tracing off
+    EngineInitOptions engine;
+};
+
+struct StateVisitStats {
+    StateId state = INVALID_STATE;
+    std::string name;
+    uint64_t visits = 0;       // Entries over all runs, the initial entry included
+    uint64_t runsVisited = 0;  // Runs that entered the state at least once
+    // Virtual ms from run start to the first entry, over the runs that reached it
+    Timestamp firstMinMs = 0;
+    Timestamp firstP50Ms = 0;
+    Timestamp firstP90Ms = 0;
+    Timestamp firstMaxMs = 0;
+    double firstMeanMs = 0.0;
+};
+
+struct MonteCarloReport {
+    size_t runs = 0;
+    size_t failedRuns = 0;
+    std::vector<std::string> errors;     // First few failures, "run N: ..."
+    std::vector<StateVisitStats> states; // State id order
+    FaultStats faults;                   // Summed over all runs
+    uint64_t ticks = 0;
+    uint64_t transitions = 0;
+    uint64_t inputsRefused = 0;
+
+    [[nodiscard]] const StateVisitStats* findState(const std::string& name) const;
+    [[nodiscard]] std::string summary() const;
+};
+
+/**
+ * Seed of run `run`. `--run <file> --virtual-time --seed <it>` with the
+ * same inputs and fault flags replays that run on its own.
+ */
+uint64_t monteCarloRunSeed(uint64_t baseSeed, size_t run);
+
+/**
+ * Run `options.runs` simulations of `automataFile` against `timeline`.
+ * Errors when the automaton does not load, a timeline event does not
+ * resolve or no limit is set; a run that fails midway only counts as failed.
+ */
+Result<MonteCarloReport> runMonteCarlo(const std::string& automataFile,
+                                       const InputTimeline& timeline,
+                                       const MonteCarloOptions& options);
+
+} // namespace aeth
+
+#endif // AETHERIUM_MONTE_CARLO_HPP
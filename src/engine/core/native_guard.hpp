@@ -0,0 +1,506 @@
+/**
+ * Aetherium Automata - Native Guards
+ *
+ * Compiles the common guard subset into a small postfix program that reads
+ * the VariableStore by id, so evaluating it skips the script call and the
+ * variable sync. The subset is:
+ * - Number and boolean literals
+ * - Automata variables, bare or as value("x"); changed("x") / check("x")
+ * - + - * / and unary minus on numbers
+ * - == ~= < <= > >= on numbers, == and ~= on booleans
+ * - and / or / not on booleans, parentheses
+ *
+ * Anything else (strings, other calls, locals, comments, a non-boolean
+ * result) is left to the script engine, so the compiled program agrees
+ * with the Lua result. Numbers are evaluated as double, which is exact for
+ * integers up to 2^53.
+ */
+
+#ifndef AETHERIUM_NATIVE_GUARD_HPP
+#define AETHERIUM_NATIVE_GUARD_HPP
+
+#include "model.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace aeth {
+
+enum class GuardOp : uint8_t {
+    Number = 0,    // Push a literal (booleans as 0 / 1)
+    Load = 1,      // Push a numeric variable
+    LoadBool = 2,  // Push a boolean variable
+    Changed = 3,   // Push whether a variable changed
+    Neg = 4,
+    Not = 5,
+    Add = 6,
+    Sub = 7,
+    Mul = 8,
+    Div = 9,
+    Compare = 10,  // Pop b, a; push a <cmp> b
+    And = 11,
+    Or = 12
+};
+
+struct GuardInstr {
+    GuardOp op = GuardOp::Number;
+    CompareOp cmp = CompareOp::Eq;
+    VariableId variable = INVALID_VARIABLE;
+    double number = 0.0;
+};
+
+static constexpr size_t GUARD_MAX_STACK = 16;
+static constexpr size_t GUARD_MAX_INSTRUCTIONS = 64;
+
+/**
+ * Append the program for a guard to `out`. Returns false, leaving `out`
+ * unchanged, when the guard is outside the native subset.
+ */
+bool compileNativeGuard(const CodeBlock& code, const Automata& automata,
+                        std::vector<GuardInstr>& out);
+
+/**
+ * Run a compiled program. nullopt when a variable is missing or does not
+ * hold the type it was compiled for; the caller then asks the script.
+ */
+std::optional<bool> evaluateNativeGuard(const GuardInstr* program, size_t size,
+                                        const VariableStore& variables);
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+namespace detail {
+
+class GuardCompiler {
+public:
+    GuardCompiler(std::string_view src, const Automata& automata, std::vector<GuardInstr>& out)
+        : src_(src), automata_(automata), out_(out), begin_(out.size()) {}
+
+    bool compile(bool statement) {
+        // A comment would otherwise read as a double minus
+        if (src_.find("--") != std::string_view::npos) {
+            return false;
+        }
+        if (statement != keyword("return")) {
+            return false;
+        }
+        if (parseOr() != Kind::Bool) {
+            return false;
+        }
+        symbol(';');
+        skipSpace();
+        return pos_ == src_.size() && out_.size() - begin_ <= GUARD_MAX_INSTRUCTIONS &&
+               maxDepth_ <= GUARD_MAX_STACK;
+    }
+
+private:
+    enum class Kind : uint8_t { Invalid, Number, Bool };
+
+    Kind parseOr() {
+        Kind lhs = parseAnd();
+        while (lhs == Kind::Bool && keyword("or")) {
+            if (parseAnd() != Kind::Bool) {
+                return Kind::Invalid;
+            }
+            emit(GuardOp::Or);
+        }
+        return lhs;
+    }
+
+    Kind parseAnd() {
+        Kind lhs = parseComparison();
+        while (lhs == Kind::Bool && keyword("and")) {
+            if (parseComparison() != Kind::Bool) {
+                return Kind::Invalid;
+            }
+            emit(GuardOp::And);
+        }
+        return lhs;
+    }
+
+    Kind parseComparison() {
+        const Kind lhs = parseAdditive();
+        CompareOp op = CompareOp::Eq;
+        if (lhs == Kind::Invalid || !compareOp(op)) {
+            return lhs;
+        }
+        const Kind rhs = parseAdditive();
+        if (rhs != lhs || (lhs == Kind::Bool && op != CompareOp::Eq && op != CompareOp::Ne)) {
+            return Kind::Invalid;
+        }
+        GuardInstr instr;
+        instr.op = GuardOp::Compare;
+        instr.cmp = op;
+        emit(instr);
+        // `a < b < c` compares a boolean with a number
+        return compareOp(op) ? Kind::Invalid : Kind::Bool;
+    }
+
+    Kind parseAdditive() {
+        Kind lhs = parseMultiplicative();
+        while (lhs == Kind::Number) {
+            GuardOp op;
+            if (symbol('+')) {
+                op = GuardOp::Add;
+            } else if (symbol('-')) {
+                op = GuardOp::Sub;
+            } else {
+                break;
+            }
+            if (parseMultiplicative() != Kind::Number) {
+                return Kind::Invalid;
+            }
+            emit(op);
+        }
+        return lhs;
+    }
+
+    Kind parseMultiplicative() {
+        Kind lhs = parseUnary();
+        while (lhs == Kind::Number) {
+            GuardOp op;
+            if (symbol('*')) {
+                op = GuardOp::Mul;
+            } else if (peek() == '/' && peek(1) != '/' && symbol('/')) {
+                op = GuardOp::Div;
+            } else {
+                break;
+            }
+            if (parseUnary() != Kind::Number) {
+                return Kind::Invalid;
+            }
+            emit(op);
+        }
+        return lhs;
+    }
+
+    Kind parseUnary() {
+        if (keyword("not")) {
+            if (parseUnary() != Kind::Bool) {
+                return Kind::Invalid;
+            }
+            emit(GuardOp::Not);
+            return Kind::Bool;
+        }
+        if (symbol('-')) {
+            if (parseUnary() != Kind::Number) {
+                return Kind::Invalid;
+            }
+            emit(GuardOp::Neg);
+            return Kind::Number;
+        }
+        return parsePrimary();
+    }
+
+    Kind parsePrimary() {
+        skipSpace();
+        const char c = peek();
+        if (c == '(') {
+            ++pos_;
+            const Kind inner = parseOr();
+            return symbol(')') ? inner : Kind::Invalid;
+        }
+        if (std::isdigit(static_cast<unsigned char>(c)) ||
+            (c == '.' && std::isdigit(static_cast<unsigned char>(peek(1))))) {
+            return parseNumber();
+        }
+        if (!isIdentStart(c)) {
+            return Kind::Invalid;
+        }
+
+        const std::string_view word = identifier();
+        if (word == "true" || word == "false") {
+            GuardInstr instr;
+            instr.number = word == "true" ? 1.0 : 0.0;
+            emit(instr);
+            return Kind::Bool;
+        }
+        if (word == "value" || word == "changed" || word == "check") {
+            const auto name = callArgument();
+            if (!name) {
+                return Kind::Invalid;
+            }
+            if (word == "value") {
+                return load(*name);
+            }
+            const auto* spec = automata_.getVariableSpecByName(*name);
+            if (!spec) {
+                return Kind::Invalid;
+            }
+            GuardInstr instr;
+            instr.op = GuardOp::Changed;
+            instr.variable = spec->id;
+            emit(instr);
+            return Kind::Bool;
+        }
+        return load(std::string(word));
+    }
+
+    Kind load(const std::string& name) {
+        const auto* spec = automata_.getVariableSpecByName(name);
+        if (!spec) {
+            return Kind::Invalid;
+        }
+        GuardInstr instr;
+        instr.variable = spec->id;
+        switch (spec->type) {
+            case ValueType::Bool:
+                instr.op = GuardOp::LoadBool;
+                emit(instr);
+                return Kind::Bool;
+            case ValueType::Int32:
+            case ValueType::Int64:
+            case ValueType::Float32:
+            case ValueType::Float64:
+                instr.op = GuardOp::Load;
+                emit(instr);
+                return Kind::Number;
+            default:
+                return Kind::Invalid;
+        }
+    }
+
+    Kind parseNumber() {
+        const size_t start = pos_;
+        const bool hex = peek() == '0' && (peek(1) == 'x' || peek(1) == 'X');
+        while (pos_ < src_.size()) {
+            const char c = src_[pos_];
+            const char prev = pos_ > start ? src_[pos_ - 1] : '\0';
+            const bool exponentSign = (c == '+' || c == '-') &&
+                (hex ? (prev == 'p' || prev == 'P') : (prev == 'e' || prev == 'E'));
+            if (!std::isalnum(static_cast<unsigned char>(c)) && c != '.' && !exponentSign) {
+                break;
+            }
+            ++pos_;
+        }
+        const std::string token(src_.substr(start, pos_ - start));
+        char* end = nullptr;
+        GuardInstr instr;
+        instr.number = std::strtod(token.c_str(), &end);
+        if (end != token.c_str() + token.size()) {
+            return Kind::Invalid;
+        }
+        emit(instr);
+        return Kind::Number;
+    }
+
+    // The string literal of a one-argument call such as value("x")
+    std::optional<std::string> callArgument() {
+        if (!symbol('(')) {
+            return std::nullopt;
+        }
+        skipSpace();
+        const char quote = peek();
+        if (quote != '"' && quote != '\'') {
+            return std::nullopt;
+        }
+        const size_t close = src_.find(quote, pos_ + 1);
+        if (close == std::string_view::npos) {
+            return std::nullopt;
+        }
+        std::string name(src_.substr(pos_ + 1, close - pos_ - 1));
+        pos_ = close + 1;
+        if (name.find('\\') != std::string::npos || !symbol(')')) {
+            return std::nullopt;
+        }
+        return name;
+    }
+
+    bool compareOp(CompareOp& op) {
+        skipSpace();
+        const char c = peek();
+        const bool equals = peek(1) == '=';
+        if (c == '=' && equals) op = CompareOp::Eq;
+        else if (c == '~' && equals) op = CompareOp::Ne;
+        else if (c == '<') op = equals ? CompareOp::Le : CompareOp::Lt;
+        else if (c == '>') op = equals ? CompareOp::Ge : CompareOp::Gt;
+        else return false;
+        // `<<` and `>>` are shifts
+        if (!equals && (peek(1) == '<' || peek(1) == '>')) {
+            return false;
+        }
+        pos_ += equals ? 2 : 1;
+        return true;
+    }
+
+    bool keyword(std::string_view word) {
+        skipSpace();
+        if (src_.compare(pos_, word.size(), word) != 0 || isIdentChar(peek(word.size()))) {
+            return false;
+        }
+        pos_ += word.size();
+        return true;
+    }
+
+    bool symbol(char c) {
+        skipSpace();
+        if (peek() != c) {
+            return false;
+        }
+        ++pos_;
+        return true;
+    }
+
+    std::string_view identifier() {
+        const size_t start = pos_;
+        while (isIdentChar(peek())) {
+            ++pos_;
+        }
+        return src_.substr(start, pos_ - start);
+    }
+
+    void emit(GuardOp op) {
+        GuardInstr instr;
+        instr.op = op;
+        emit(instr);
+    }
+
+    void emit(const GuardInstr& instr) {
+        switch (instr.op) {
+            case GuardOp::Number:
+            case GuardOp::Load:
+            case GuardOp::LoadBool:
+            case GuardOp::Changed:
+                maxDepth_ = std::max(maxDepth_, ++depth_);
+                break;
+            case GuardOp::Neg:
+            case GuardOp::Not:
+                break;
+            default:
+                --depth_;
+                break;
+        }
+        out_.push_back(instr);
+    }
+
+    void skipSpace() {
+        while (std::isspace(static_cast<unsigned char>(peek()))) {
+            ++pos_;
+        }
+    }
+
+    [[nodiscard]] char peek(size_t ahead = 0) const {
+        return pos_ + ahead < src_.size() ? src_[pos_ + ahead] : '\0';
+    }
+
+    static bool isIdentStart(char c) {
+        return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    static bool isIdentChar(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    std::string_view src_;
+    const Automata& automata_;
+    std::vector<GuardInstr>& out_;
+    size_t begin_;  // This program starts here; out_ holds the earlier ones too
+    size_t pos_ = 0;
+    size_t depth_ = 0;
+    size_t maxDepth_ = 0;
+};
+
+inline bool guardOperand(const Value& value, bool boolean, double& out) {
+    switch (value.type()) {
+        case ValueType::Bool:
+            out = value.get<bool>() ? 1.0 : 0.0;
+            return boolean;
+        case ValueType::Int32: out = value.get<int32_t>(); return !boolean;
+        case ValueType::Int64: out = static_cast<double>(value.get<int64_t>()); return !boolean;
+        case ValueType::Float32: out = value.get<float>(); return !boolean;
+        case ValueType::Float64: out = value.get<double>(); return !boolean;
+        default: return false;
+    }
+}
+
+inline bool compareGuardNumbers(double a, double b, CompareOp op) {
+    switch (op) {
+        case CompareOp::Gt: return a > b;
+        case CompareOp::Ge: return a >= b;
+        case CompareOp::Lt: return a < b;
+        case CompareOp::Le: return a <= b;
+        case CompareOp::Eq: return a == b;
+        case CompareOp::Ne: return a != b;
+    }
+    return false;
+}
+
+} // namespace detail
+
+inline bool compileNativeGuard(const CodeBlock& code, const Automata& automata,
+                               std::vector<GuardInstr>& out) {
+    const std::string_view src = code.source.empty() ? code.mappedSource : std::string_view(code.source);
+    if (src.empty()) {
+        return false;
+    }
+    const size_t mark = out.size();
+    detail::GuardCompiler compiler(src, automata, out);
+    if (!compiler.compile(code.resolvedKind(CodeKind::Expression) == CodeKind::Statement)) {
+        out.resize(mark);
+        return false;
+    }
+    return true;
+}
+
+inline std::optional<bool> evaluateNativeGuard(const GuardInstr* program, size_t size,
+                                               const VariableStore& variables) {
+    double stack[GUARD_MAX_STACK];
+    size_t top = 0;
+    for (const GuardInstr* instr = program; instr != program + size; ++instr) {
+        switch (instr->op) {
+            case GuardOp::Number:
+                stack[top++] = instr->number;
+                break;
+            case GuardOp::Load:
+            case GuardOp::LoadBool:
+            case GuardOp::Changed: {
+                const Variable* var = variables.get(instr->variable);
+                if (!var) {
+                    return std::nullopt;
+                }
+                double value = 0.0;
+                if (instr->op == GuardOp::Changed) {
+                    value = var->hasChanged() ? 1.0 : 0.0;
+                } else if (!detail::guardOperand(var->value(), instr->op == GuardOp::LoadBool, value)) {
+                    return std::nullopt;
+                }
+                stack[top++] = value;
+                break;
+            }
+            case GuardOp::Neg:
+                stack[top - 1] = -stack[top - 1];
+                break;
+            case GuardOp::Not:
+                stack[top - 1] = stack[top - 1] == 0.0 ? 1.0 : 0.0;
+                break;
+            default: {
+                const double b = stack[--top];
+                double& a = stack[top - 1];
+                switch (instr->op) {
+                    case GuardOp::Add: a = a + b; break;
+                    case GuardOp::Sub: a = a - b; break;
+                    case GuardOp::Mul: a = a * b; break;
+                    case GuardOp::Div: a = a / b; break;
+                    case GuardOp::Compare: a = detail::compareGuardNumbers(a, b, instr->cmp) ? 1.0 : 0.0; break;
+                    case GuardOp::And: a = (a != 0.0 && b != 0.0) ? 1.0 : 0.0; break;
+                    case GuardOp::Or: a = (a != 0.0 || b != 0.0) ? 1.0 : 0.0; break;
+                    default: return std::nullopt;
+                }
+                break;
+            }
+        }
+    }
+    if (top != 1) {
+        return std::nullopt;
+    }
+    return stack[0] != 0.0;
+}
+
+} // namespace aeth
+
+#endif // AETHERIUM_NATIVE_GUARD_HPP
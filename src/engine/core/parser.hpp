@@ -2,7 +2,8 @@
  * Aetherium Automata - YAML Parser
  * 
  * Parses automata definitions from YAML format into the core model.
- * Supports both inline and folder layouts.
+ * Supports both inline and folder layouts. Host-side only; batches of
+ * files and large folder layouts are read on a worker pool.
  */
 
 #ifndef AETHERIUM_PARSER_HPP
@@ -10,6 +11,7 @@
 
 #include "types.hpp"
 #include "model.hpp"
+#include "work_stealing_pool.hpp"
 #include <ryml.hpp>
 #include <filesystem>
 #include <string>
@@ -17,7 +19,11 @@
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <cmath>
+#include <cstdint>
 #include <limits>
+#include <optional>
+#include <unordered_map>
 
 namespace aeth {
 
@@ -33,6 +39,59 @@ struct ParseResult {
     [[nodiscard]] bool success() const { return automata != nullptr && errors.empty(); }
 };
 
+// ============================================================================
+// Incremental Parse Cache
+// ============================================================================
+
+/**
+ * What the previous parse of a document produced, for edit loops that
+ * re-parse the same file on every save. States and transitions are keyed
+ * by name and the hash of their YAML subtree; an unchanged entry is copied
+ * instead of parsed, with ids and variable references re-derived, so the
+ * result is the one a full parse gives. Entries absent from the latest
+ * parse are dropped. Not thread-safe.
+ */
+struct ParseCache {
+    struct StateEntry {
+        uint64_t hash = 0;
+        uint64_t generation = 0;
+        State state;  // As parsed: before id assignment and folder-layout code
+        std::vector<std::string> inputs;
+        std::vector<std::string> outputs;
+        std::vector<std::string> variables;
+    };
+
+    struct TransitionEntry {
+        uint64_t hash = 0;
+        uint64_t generation = 0;
+        Transition transition;
+        std::vector<std::string> errors;  // Emitted while parsing it; replayed on reuse
+        std::vector<std::string> warnings;
+    };
+
+    struct Stats {
+        bool documentReused = false;
+        size_t parsedStates = 0;
+        size_t reusedStates = 0;
+        size_t parsedTransitions = 0;
+        size_t reusedTransitions = 0;
+    };
+
+    std::unordered_map<std::string, StateEntry> states;
+    std::unordered_map<std::string, TransitionEntry> transitions;
+
+    // Last successful inline-layout parse, returned as-is for identical input
+    uint64_t documentHash = 0;
+    std::string documentBasePath;
+    std::optional<Automata> document;
+    std::vector<std::string> documentWarnings;
+
+    uint64_t generation = 0;
+    Stats stats;
+
+    void clear() { *this = ParseCache{}; }
+};
+
 // ============================================================================
 // YAML Parser
 // ============================================================================
@@ -41,6 +100,9 @@ class AutomataParser {
 public:
     AutomataParser() = default;
 
+    // Reuse unchanged entries from `cache` in parseFile/parseString (nullptr = off)
+    explicit AutomataParser(ParseCache* cache) : cache_(cache) {}
+
     /**
      * Parse automata from YAML file
      */
@@ -51,6 +113,16 @@ public:
      */
     ParseResult parseString(const std::string& yaml, const std::string& basePath = "");
 
+    /**
+     * Parse several files on a worker pool (0 = one per hardware thread).
+     * Each file gets its own tree and id space, so results come back in
+     * input order and equal what parseFile gives one file at a time.
+     */
+    std::vector<ParseResult> parseFiles(const std::vector<std::string>& filePaths, size_t workers = 0);
+
+    // Folder layouts with at least this many code files read them concurrently
+    static constexpr size_t PARALLEL_READ_THRESHOLD = 16;
+
 private:
     enum class DurationDefaultUnit {
         Milliseconds,
@@ -89,10 +161,13 @@ private:
 
     // Detail parsing
     State parseState(ryml::ConstNodeRef node, const std::string& name, Automata& automata, ParseContext& ctx);
+    State parseStateEntry(ryml::ConstNodeRef node, const std::string& name, Automata& automata, ParseContext& ctx);
+    Transition parseTransitionEntry(ryml::ConstNodeRef node, const std::string& name, ParseContext& ctx);
     Transition parseTransition(ryml::ConstNodeRef node, const std::string& name, 
                                ParseContext& ctx);
     VariableSpec parseVariableSpec(ryml::ConstNodeRef node, ParseContext& ctx);
     VariableSpec parseVariableShort(const std::string& spec, ParseContext& ctx);
+    TelemetryPolicy parseTelemetryPolicy(ryml::ConstNodeRef node, const std::string& name, ParseContext& ctx);
     CodeBlock parseCode(ryml::ConstNodeRef node);
     BlackBoxPort parseBlackBoxPort(ryml::ConstNodeRef node, ParseContext& ctx);
     BlackBoxResource parseBlackBoxResource(ryml::ConstNodeRef node, ParseContext& ctx);
@@ -123,13 +198,21 @@ private:
 
     std::optional<ryml::ConstNodeRef> findChild(ryml::ConstNodeRef node, const char* key);
     std::string nodeKey(ryml::ConstNodeRef node);
+    StateId findStateRef(ryml::ConstNodeRef node, const char* key, const ParseContext& ctx);
+    static uint64_t hashBytes(const char* data, size_t len, uint64_t hash = 14695981039346656037ull);
+    static uint64_t hashNode(ryml::ConstNodeRef node, uint64_t hash = 14695981039346656037ull);
+    std::vector<std::string> stringList(ryml::ConstNodeRef node, const char* key);
     VariableId ensureVariable(const std::string& specText,
                               VariableDirection direction,
                               Automata& automata,
                               ParseContext& ctx);
     VariableId ensureVariable(VariableSpec spec, Automata& automata, ParseContext& ctx);
     void resolveFolderLayoutCode(Automata& automata, ParseContext& ctx);
-    std::string readTextFile(const std::filesystem::path& path, ParseContext& ctx);
+    static bool readTextFile(const std::filesystem::path& path, std::string& out);
+    std::vector<std::string> readTextFiles(const std::vector<std::filesystem::path>& paths, ParseContext& ctx);
+
+    ParseCache* cache_ = nullptr;
+    bool parallelReads_ = true;  // Off inside parseFiles, which is already on the pool
 };
 
 // ============================================================================
@@ -165,6 +248,20 @@ inline ParseResult AutomataParser::parseString(const std::string& yaml,
     ParseContext ctx;
     ctx.basePath = basePath;
 
+    uint64_t documentHash = 0;
+    if (cache_) {
+        cache_->stats = ParseCache::Stats{};
+        ++cache_->generation;
+        documentHash = hashBytes(yaml.data(), yaml.size());
+        if (cache_->document && cache_->documentHash == documentHash && cache_->documentBasePath == basePath) {
+            cache_->stats.documentReused = true;
+            result.automata = std::make_unique<Automata>(*cache_->document);
+            result.warnings = cache_->documentWarnings;
+            return result;
+        }
+        cache_->document.reset();
+    }
+
     try {
         // Convert std::string to c4::csubstr explicitly
         c4::csubstr yamlView(yaml.c_str(), yaml.size());
@@ -184,9 +281,52 @@ inline ParseResult AutomataParser::parseString(const std::string& yaml,
         result.errors.push_back(std::string("YAML parse error: ") + e.what());
     }
 
+    if (cache_) {
+        const uint64_t generation = cache_->generation;
+        auto prune = [generation](auto& entries) {
+            for (auto it = entries.begin(); it != entries.end();) {
+                it = it->second.generation == generation ? std::next(it) : entries.erase(it);
+            }
+        };
+        prune(cache_->states);
+        prune(cache_->transitions);
+        // Folder layouts also depend on the code files, so only inline documents are kept whole
+        if (result.success() && result.automata->config.layout == LayoutType::Inline) {
+            cache_->documentHash = documentHash;
+            cache_->documentBasePath = basePath;
+            cache_->document = *result.automata;
+            cache_->documentWarnings = result.warnings;
+        }
+    }
+
     return result;
 }
 
+inline std::vector<ParseResult> AutomataParser::parseFiles(const std::vector<std::string>& filePaths,
+                                                          size_t workers) {
+    std::vector<ParseResult> results(filePaths.size());
+    if (filePaths.size() <= 1) {
+        for (size_t i = 0; i < filePaths.size(); ++i) {
+            results[i] = parseFile(filePaths[i]);
+        }
+        return results;
+    }
+
+    if (workers == 0) {
+        workers = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    WorkStealingPool pool(std::min(workers, filePaths.size()));
+    for (size_t i = 0; i < filePaths.size(); ++i) {
+        pool.submit([&filePaths, &results, i] {
+            AutomataParser parser;
+            parser.parallelReads_ = false;
+            results[i] = parser.parseFile(filePaths[i]);
+        });
+    }
+    pool.waitIdle();
+    return results;
+}
+
 inline void AutomataParser::parseRoot(ryml::ConstNodeRef root, Automata& automata, 
                                        ParseContext& ctx) {
     // Handle both list-of-singletons and direct map formats
@@ -338,7 +478,7 @@ inline void AutomataParser::parseStates(ryml::ConstNodeRef node, Automata& autom
                 continue;
             }
 
-            State state = parseState(stateNode, name, automata, ctx);
+            State state = parseStateEntry(stateNode, name, automata, ctx);
             state.id = ctx.nextStateId++;
             ctx.stateIds[name] = state.id;
 
@@ -362,7 +502,7 @@ inline void AutomataParser::parseStates(ryml::ConstNodeRef node, Automata& autom
                 continue;
             }
 
-            State state = parseState(stateNode, name, automata, ctx);
+            State state = parseStateEntry(stateNode, name, automata, ctx);
             state.id = ctx.nextStateId++;
             ctx.stateIds[name] = state.id;
             automata.states[state.id] = std::move(state);
@@ -420,6 +560,76 @@ inline State AutomataParser::parseState(ryml::ConstNodeRef node, const std::stri
     return state;
 }
 
+inline State AutomataParser::parseStateEntry(ryml::ConstNodeRef node, const std::string& name,
+                                              Automata& automata, ParseContext& ctx) {
+    if (!cache_) {
+        return parseState(node, name, automata, ctx);
+    }
+
+    const uint64_t hash = hashNode(node);
+    auto& entry = cache_->states[name];
+    if (entry.generation != 0 && entry.hash == hash) {
+        entry.generation = cache_->generation;
+        ++cache_->stats.reusedStates;
+        // Same ensureVariable calls in the same order as parseState, so ids match a full parse
+        State state = entry.state;
+        state.inputIds.clear();
+        state.outputIds.clear();
+        state.variableIds.clear();
+        for (const auto& text : entry.inputs) {
+            state.inputIds.push_back(ensureVariable(text, VariableDirection::Input, automata, ctx));
+        }
+        for (const auto& text : entry.outputs) {
+            state.outputIds.push_back(ensureVariable(text, VariableDirection::Output, automata, ctx));
+        }
+        for (const auto& text : entry.variables) {
+            state.variableIds.push_back(ensureVariable(text, VariableDirection::Internal, automata, ctx));
+        }
+        return state;
+    }
+
+    ++cache_->stats.parsedStates;
+    State state = parseState(node, name, automata, ctx);
+    entry.hash = hash;
+    entry.generation = cache_->generation;
+    entry.state = state;
+    entry.inputs = stringList(node, "inputs");
+    entry.outputs = stringList(node, "outputs");
+    entry.variables = stringList(node, "variables");
+    return state;
+}
+
+inline Transition AutomataParser::parseTransitionEntry(ryml::ConstNodeRef node, const std::string& name,
+                                                       ParseContext& ctx) {
+    if (!cache_) {
+        return parseTransition(node, name, ctx);
+    }
+
+    // Reusable only while its endpoints still resolve to the same states
+    const uint64_t hash = hashNode(node);
+    const StateId from = findStateRef(node, "from", ctx);
+    const StateId to = findStateRef(node, "to", ctx);
+    auto& entry = cache_->transitions[name];
+    if (entry.generation != 0 && entry.hash == hash && entry.transition.from == from && entry.transition.to == to) {
+        entry.generation = cache_->generation;
+        ++cache_->stats.reusedTransitions;
+        ctx.errors.insert(ctx.errors.end(), entry.errors.begin(), entry.errors.end());
+        ctx.warnings.insert(ctx.warnings.end(), entry.warnings.begin(), entry.warnings.end());
+        return entry.transition;
+    }
+
+    ++cache_->stats.parsedTransitions;
+    const size_t errorMark = ctx.errors.size();
+    const size_t warningMark = ctx.warnings.size();
+    Transition trans = parseTransition(node, name, ctx);
+    entry.hash = hash;
+    entry.generation = cache_->generation;
+    entry.transition = trans;
+    entry.errors.assign(ctx.errors.begin() + static_cast<std::ptrdiff_t>(errorMark), ctx.errors.end());
+    entry.warnings.assign(ctx.warnings.begin() + static_cast<std::ptrdiff_t>(warningMark), ctx.warnings.end());
+    return trans;
+}
+
 inline void AutomataParser::parseTransitions(ryml::ConstNodeRef node, Automata& automata, 
                                               ParseContext& ctx) {
     if (node.is_map() || (!node.is_seq() && node.num_children() > 0)) {
@@ -435,7 +645,7 @@ inline void AutomataParser::parseTransitions(ryml::ConstNodeRef node, Automata&
                 continue;
             }
 
-            Transition trans = parseTransition(transNode, name, ctx);
+            Transition trans = parseTransitionEntry(transNode, name, ctx);
             trans.id = ctx.nextTransitionId++;
             automata.transitions[trans.id] = std::move(trans);
         }
@@ -450,7 +660,7 @@ inline void AutomataParser::parseTransitions(ryml::ConstNodeRef node, Automata&
                 ++index;
                 name = "transition_" + std::to_string(index);
             }
-            Transition trans = parseTransition(transNode, name, ctx);
+            Transition trans = parseTransitionEntry(transNode, name, ctx);
             trans.id = ctx.nextTransitionId++;
             automata.transitions[trans.id] = std::move(trans);
         }
@@ -554,6 +764,11 @@ inline Transition AutomataParser::parseTransition(ryml::ConstNodeRef node,
     if (auto enabledNode = findChild(node, "enabled")) {
         trans.enabled = getBool(*enabledNode, true);
     }
+    if (auto dependsNode = findChild(node, "depends_on"); dependsNode && (*dependsNode).is_seq()) {
+        for (auto dep : (*dependsNode).children()) {
+            trans.dependsOn.push_back(getString(dep));
+        }
+    }
     if (auto descNode = findChild(node, "description")) {
         trans.description = getString(*descNode);
     }
@@ -591,6 +806,9 @@ inline VariableSpec AutomataParser::parseVariableSpec(ryml::ConstNodeRef node,
     if (auto descNode = findChild(node, "description")) {
         spec.description = getString(*descNode);
     }
+    if (auto telemetryNode = findChild(node, "telemetry")) {
+        spec.telemetry = parseTelemetryPolicy(*telemetryNode, spec.name, ctx);
+    }
     
     // Parse default/initial value
     if (auto defaultNode = findChild(node, "default")) {
@@ -601,6 +819,40 @@ inline VariableSpec AutomataParser::parseVariableSpec(ryml::ConstNodeRef node,
     return spec;
 }
 
+inline TelemetryPolicy AutomataParser::parseTelemetryPolicy(ryml::ConstNodeRef node, const std::string& name,
+                                                            ParseContext& ctx) {
+    TelemetryPolicy policy;
+    auto millis = [&](const char* key) -> uint32_t {
+        auto child = findChild(node, key);
+        return child ? static_cast<uint32_t>(std::max(0, getInt(*child, 0))) : 0;
+    };
+    policy.windowMs = millis("window_ms");
+    policy.slideMs = millis("slide_ms");
+    policy.minIntervalMs = millis("min_interval_ms");
+    if (auto rateNode = findChild(node, "max_rate_hz")) {
+        const double hz = getDouble(*rateNode, 0.0);
+        if (hz > 0.0) {
+            policy.minIntervalMs = static_cast<uint32_t>(std::ceil(1000.0 / hz));
+        }
+    }
+    if (auto deadbandNode = findChild(node, "deadband")) {
+        policy.deadband = std::max(0.0, getDouble(*deadbandNode, 0.0));
+    }
+
+    if (policy.slideMs > 0 && policy.windowMs == 0) {
+        ctx.error("Variable '" + name + "' telemetry: slide_ms needs window_ms");
+    } else if (policy.slideMs > policy.windowMs) {
+        ctx.error("Variable '" + name + "' telemetry: slide_ms is longer than window_ms");
+    } else if (policy.slideMs > 0 && policy.windowMs % policy.slideMs != 0) {
+        ctx.warn("Variable '" + name + "' telemetry: window_ms rounded up to a multiple of slide_ms");
+        policy.windowMs += policy.slideMs - policy.windowMs % policy.slideMs;
+    }
+    if (policy.windowMs > 0 && policy.minIntervalMs > 0) {
+        ctx.warn("Variable '" + name + "' telemetry: min_interval_ms is ignored for windowed outputs");
+    }
+    return policy;
+}
+
 inline VariableSpec AutomataParser::parseVariableShort(const std::string& spec, 
                                                         ParseContext& ctx) {
     VariableSpec result;
@@ -876,6 +1128,54 @@ inline std::string AutomataParser::nodeKey(ryml::ConstNodeRef node) {
     return "";
 }
 
+inline StateId AutomataParser::findStateRef(ryml::ConstNodeRef node, const char* key, const ParseContext& ctx) {
+    if (auto refNode = findChild(node, key)) {
+        auto it = ctx.stateIds.find(getString(*refNode));
+        if (it != ctx.stateIds.end()) {
+            return it->second;
+        }
+    }
+    return INVALID_STATE;
+}
+
+inline uint64_t AutomataParser::hashBytes(const char* data, size_t len, uint64_t hash) {
+    // FNV-1a
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+inline uint64_t AutomataParser::hashNode(ryml::ConstNodeRef node, uint64_t hash) {
+    // Shape and child count are mixed in so moving text between keys changes the hash
+    const char shape = node.is_map() ? 'm' : (node.is_seq() ? 's' : 'v');
+    hash = hashBytes(&shape, 1, hash);
+    if (node.has_key()) {
+        hash = hashBytes(node.key().str, node.key().len, hash);
+    }
+    if (node.is_keyval() || node.is_val()) {
+        hash = hashBytes("=", 1, hash);
+        hash = hashBytes(node.val().str, node.val().len, hash);
+    }
+    const uint64_t children = node.num_children();
+    hash = hashBytes(reinterpret_cast<const char*>(&children), sizeof(children), hash);
+    for (auto child : node.children()) {
+        hash = hashNode(child, hash);
+    }
+    return hash;
+}
+
+inline std::vector<std::string> AutomataParser::stringList(ryml::ConstNodeRef node, const char* key) {
+    std::vector<std::string> out;
+    if (auto listNode = findChild(node, key); listNode && (*listNode).is_seq()) {
+        for (auto item : (*listNode).children()) {
+            out.push_back(getString(item));
+        }
+    }
+    return out;
+}
+
 inline VariableId AutomataParser::ensureVariable(const std::string& specText,
                                                  VariableDirection direction,
                                                  Automata& automata,
@@ -896,6 +1196,9 @@ inline VariableId AutomataParser::ensureVariable(VariableSpec spec, Automata& au
             if (existing->type != spec.type && spec.type != ValueType::String) {
                 ctx.warn("Variable '" + spec.name + "' type conflict; keeping first definition");
             }
+            if (spec.telemetry.enabled() && !existing->telemetry.enabled()) {
+                existing->telemetry = spec.telemetry;  // `variables:` details a port the automaton listed
+            }
         }
         return it->second;
     }
@@ -909,15 +1212,40 @@ inline VariableId AutomataParser::ensureVariable(VariableSpec spec, Automata& au
     return assigned;
 }
 
-inline std::string AutomataParser::readTextFile(const std::filesystem::path& path, ParseContext& ctx) {
+inline bool AutomataParser::readTextFile(const std::filesystem::path& path, std::string& out) {
     std::ifstream file(path);
     if (!file.is_open()) {
-        ctx.error("Missing required folder-layout file: " + path.string());
-        return "";
+        return false;
     }
     std::ostringstream ss;
     ss << file.rdbuf();
-    return ss.str();
+    out = ss.str();
+    return true;
+}
+
+inline std::vector<std::string> AutomataParser::readTextFiles(const std::vector<std::filesystem::path>& paths,
+                                                              ParseContext& ctx) {
+    std::vector<std::string> contents(paths.size());
+    std::vector<uint8_t> found(paths.size(), 0);
+    if (parallelReads_ && paths.size() >= PARALLEL_READ_THRESHOLD) {
+        WorkStealingPool pool;
+        for (size_t i = 0; i < paths.size(); ++i) {
+            pool.submit([&, i] { found[i] = readTextFile(paths[i], contents[i]) ? 1 : 0; });
+        }
+        pool.waitIdle();
+    } else {
+        for (size_t i = 0; i < paths.size(); ++i) {
+            found[i] = readTextFile(paths[i], contents[i]) ? 1 : 0;
+        }
+    }
+
+    // Reported in path order, whichever read finished first
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (!found[i]) {
+            ctx.error("Missing required folder-layout file: " + paths[i].string());
+        }
+    }
+    return contents;
 }
 
 inline void AutomataParser::resolveFolderLayoutCode(Automata& automata, ParseContext& ctx) {
@@ -925,9 +1253,34 @@ inline void AutomataParser::resolveFolderLayoutCode(Automata& automata, ParseCon
     const std::filesystem::path location = automata.config.location.empty() ? "." : automata.config.location;
     const std::filesystem::path folder = basePath / location;
 
+    // Id order keeps error order and the merged model independent of the maps' layout
+    std::vector<State*> states;
+    states.reserve(automata.states.size());
     for (auto& [id, state] : automata.states) {
-        const auto filePath = folder / (state.name + ".lua");
-        const std::string script = readTextFile(filePath, ctx);
+        states.push_back(&state);
+    }
+    std::sort(states.begin(), states.end(), [](const State* a, const State* b) { return a->id < b->id; });
+    std::vector<Transition*> transitions;
+    transitions.reserve(automata.transitions.size());
+    for (auto& [id, transition] : automata.transitions) {
+        transitions.push_back(&transition);
+    }
+    std::sort(transitions.begin(), transitions.end(),
+              [](const Transition* a, const Transition* b) { return a->id < b->id; });
+
+    std::vector<std::filesystem::path> paths;
+    paths.reserve(states.size() + transitions.size());
+    for (const State* state : states) {
+        paths.push_back(folder / (state->name + ".lua"));
+    }
+    for (const Transition* transition : transitions) {
+        paths.push_back(folder / (transition->name + ".lua"));
+    }
+    const auto scripts = readTextFiles(paths, ctx);
+
+    for (size_t i = 0; i < states.size(); ++i) {
+        State& state = *states[i];
+        const std::string& script = scripts[i];
         if (script.empty()) {
             continue;
         }
@@ -942,20 +1295,23 @@ inline void AutomataParser::resolveFolderLayoutCode(Automata& automata, ParseCon
         }
     }
 
-    for (auto& [id, transition] : automata.transitions) {
-        const auto filePath = folder / (transition.name + ".lua");
-        const std::string script = readTextFile(filePath, ctx);
+    for (size_t i = 0; i < transitions.size(); ++i) {
+        Transition& transition = *transitions[i];
+        const std::string& script = scripts[states.size() + i];
         if (script.empty()) {
             continue;
         }
         if (transition.classicConfig.condition.isEmpty() && transition.type == TransitionType::Classic) {
             transition.classicConfig.condition.source = script + "\nif condition ~= nil then return condition() end\nreturn true";
+            transition.classicConfig.condition.kind = CodeKind::Statement;
         }
         if (transition.timedConfig.additionalCondition.isEmpty() && transition.type == TransitionType::Timed) {
             transition.timedConfig.additionalCondition.source = script + "\nif condition ~= nil then return condition() end\nreturn true";
+            transition.timedConfig.additionalCondition.kind = CodeKind::Statement;
         }
         if (transition.eventConfig.additionalCondition.isEmpty() && transition.type == TransitionType::Event) {
             transition.eventConfig.additionalCondition.source = script + "\nif condition ~= nil then return condition() end\nreturn true";
+            transition.eventConfig.additionalCondition.kind = CodeKind::Statement;
         }
         if (transition.body.isEmpty()) {
             transition.body.source = script + "\nif body ~= nil then return body() end";
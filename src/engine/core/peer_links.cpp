@@ -0,0 +1,150 @@
+#include "peer_links.hpp"
+
+#include <algorithm>
+
+namespace aeth {
+
+Result<void> PeerLinks::configure(DeviceId self, const std::vector<protocol::PeerWire>& wires, uint16_t sampleEvery) {
+    std::vector<Link> links;
+    std::vector<Route> routes;
+    auto linkFor = [&](const std::string& endpoint) -> Result<size_t> {
+        for (size_t i = 0; i < links.size(); ++i) {
+            if (links[i].endpoint == endpoint) {
+                return Result<size_t>::ok(i);
+            }
+        }
+        // Reuse the open link of the previous table
+        auto kept = std::find_if(links_.begin(), links_.end(), [&](const Link& link) {
+            return link.transport && link.endpoint == endpoint;
+        });
+        if (kept != links_.end()) {
+            links.push_back(std::move(*kept));
+            return Result<size_t>::ok(links.size() - 1);
+        }
+        if (!factory_) {
+            return Result<size_t>::error("no transport for peer endpoint " + endpoint);
+        }
+        auto transport = factory_(endpoint);
+        if (!transport) {
+            return Result<size_t>::error("unsupported peer endpoint " + endpoint);
+        }
+        auto connected = transport->connect();
+        if (connected.isError()) {
+            return Result<size_t>::error("peer endpoint " + endpoint + ": " + connected.error());
+        }
+        links.push_back(Link{endpoint, std::move(transport)});
+        return Result<size_t>::ok(links.size() - 1);
+    };
+
+    for (const auto& wire : wires) {
+        const bool outgoing = wire.sourceDevice == self;
+        const bool incoming = wire.targetDevice == self;
+        if (outgoing == incoming) {
+            continue;  // Not ours, or a loop back to this engine
+        }
+        if (wire.endpoint.empty() || (outgoing && (wire.sourcePort.empty() || wire.targetPort.empty()))) {
+            return Result<void>::error("peer wire " + wire.sourcePort + " -> " + wire.targetPort + " is incomplete");
+        }
+        auto link = linkFor(wire.endpoint);
+        if (link.isError()) {
+            return Result<void>::error(link.error());
+        }
+        if (outgoing) {
+            routes.push_back(Route{wire.sourcePort, INVALID_VARIABLE, wire.targetDevice, wire.targetPort, link.value()});
+        }
+    }
+
+    // Links the new table no longer uses close with the old vector
+    for (auto& link : links_) {
+        if (link.transport) {
+            link.transport->disconnect();
+        }
+    }
+    links_ = std::move(links);
+    routes_ = std::move(routes);
+    spans_.clear();
+    self_ = self;
+    sampleEvery_ = sampleEvery;
+    return Result<void>::ok();
+}
+
+void PeerLinks::bind(const VariableStore& variables) {
+    VariableId maxId = 0;
+    for (auto& route : routes_) {
+        const Variable* var = variables.getByName(route.sourcePort);
+        route.source = var ? var->id() : INVALID_VARIABLE;
+        if (var) {
+            maxId = std::max(maxId, var->id());
+        }
+    }
+    std::stable_sort(routes_.begin(), routes_.end(),
+                     [](const Route& a, const Route& b) { return a.source < b.source; });
+
+    spans_.assign(routes_.empty() ? 0 : static_cast<size_t>(maxId) + 1, Span{});
+    for (uint32_t i = 0; i < routes_.size(); ++i) {
+        const VariableId source = routes_[i].source;
+        if (source == INVALID_VARIABLE) {
+            break;  // Unresolved ports sort last
+        }
+        Span& span = spans_[source];
+        if (span.begin == span.end) {
+            span.begin = i;
+        }
+        span.end = i + 1;
+    }
+}
+
+void PeerLinks::clear() {
+    for (auto& link : links_) {
+        if (link.transport) {
+            link.transport->disconnect();
+        }
+    }
+    links_.clear();
+    routes_.clear();
+    spans_.clear();
+}
+
+bool PeerLinks::forward(const Variable& var) {
+    const VariableId id = var.id();
+    if (id >= spans_.size() || spans_[id].begin == spans_[id].end) {
+        return true;
+    }
+    Span& span = spans_[id];
+    for (uint32_t i = span.begin; i < span.end; ++i) {
+        const Route& route = routes_[i];
+        auto input = std::make_unique<protocol::InputMessage>();
+        input->sourceId = self_;
+        input->targetId = route.targetDevice;
+        input->variableName = route.targetPort;
+        input->value = var.value();
+        if (links_[route.link].transport->send(std::move(input))) {
+            ++forwarded_;
+        } else {
+            ++failedSends_;
+        }
+    }
+    if (sampleEvery_ == 0 || ++span.changes < sampleEvery_) {
+        return false;
+    }
+    span.changes = 0;
+    return true;
+}
+
+bool PeerLinks::hasMessage() const {
+    return std::any_of(links_.begin(), links_.end(),
+                       [](const Link& link) { return link.transport->hasMessage(); });
+}
+
+size_t PeerLinks::drain(const MessageCallback& fn, size_t max) {
+    size_t count = 0;
+    for (auto& link : links_) {
+        if (count >= max) {
+            break;
+        }
+        count += link.transport->drain(fn, max - count);
+    }
+    return count;
+}
+
+} // namespace aeth
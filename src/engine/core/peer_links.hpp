@@ -0,0 +1,95 @@
+#ifndef AETHERIUM_PEER_LINKS_HPP
+#define AETHERIUM_PEER_LINKS_HPP
+
+#include "protocol.hpp"
+#include "transport.hpp"
+#include "variable.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace aeth {
+
+/**
+ * Direct engine-to-engine port wiring (see PEER_WIRING). Holds the edges of
+ * a deployment's wiring table that this engine is an end of and one
+ * transport per distinct endpoint. Outgoing edges turn an output change into
+ * an Input for the target engine; incoming edges only keep their endpoint
+ * open so the peer has someone to talk to.
+ *
+ * The transports come from a factory the platform layer installs (the
+ * engine core does not link any transport); without one, configure()
+ * refuses a table that needs a link.
+ */
+class PeerLinks {
+public:
+    using TransportFactory = std::function<std::unique_ptr<ITransport>(const std::string& endpoint)>;
+
+    void setTransportFactory(TransportFactory factory) { factory_ = std::move(factory); }
+    [[nodiscard]] bool hasTransportFactory() const { return static_cast<bool>(factory_); }
+
+    /**
+     * Replace the table with the wires `self` is an end of and connect their
+     * endpoints (links whose endpoint is still wired are kept open). Source
+     * ports are matched to variables by bind().
+     */
+    Result<void> configure(DeviceId self, const std::vector<protocol::PeerWire>& wires, uint16_t sampleEvery);
+    // Resolve outgoing source ports against a freshly loaded store
+    void bind(const VariableStore& variables);
+    void clear();
+
+    [[nodiscard]] bool empty() const { return links_.empty(); }
+    [[nodiscard]] size_t routeCount() const { return routes_.size(); }
+    [[nodiscard]] size_t linkCount() const { return links_.size(); }
+
+    /**
+     * Send an output change to every engine wired to it. Returns whether the
+     * server should get the change too: always for an unwired output, every
+     * sampleEvery-th change for a wired one.
+     */
+    bool forward(const Variable& var);
+
+    // Whether any link has a message waiting
+    [[nodiscard]] bool hasMessage() const;
+    // Hand up to max messages from the links to fn; returns how many
+    size_t drain(const MessageCallback& fn, size_t max);
+
+    [[nodiscard]] uint64_t forwardedCount() const { return forwarded_; }
+    [[nodiscard]] uint64_t failedSendCount() const { return failedSends_; }
+
+private:
+    struct Link {
+        std::string endpoint;
+        std::unique_ptr<ITransport> transport;
+    };
+
+    struct Route {
+        std::string sourcePort;
+        VariableId source = INVALID_VARIABLE;
+        DeviceId targetDevice = 0;
+        std::string targetPort;
+        size_t link = 0;
+    };
+
+    // [begin, end) into routes_ for a source variable id
+    struct Span {
+        uint32_t begin = 0;
+        uint32_t end = 0;
+        uint32_t changes = 0;  // Since the last sampled copy
+    };
+
+    TransportFactory factory_;
+    DeviceId self_ = 0;
+    uint16_t sampleEvery_ = 0;
+    std::vector<Link> links_;
+    std::vector<Route> routes_;  // Sorted by source once bound
+    std::vector<Span> spans_;    // Indexed by VariableId
+    uint64_t forwarded_ = 0;
+    uint64_t failedSends_ = 0;
+};
+
+} // namespace aeth
+
+#endif // AETHERIUM_PEER_LINKS_HPP
@@ -0,0 +1,379 @@
+/**
+ * Aetherium Automata - Tick Profiling
+ *
+ * Steady-clock phase counters and log-linear latency histograms for the
+ * runtime hot path, and per-code-block script cost. Built in when AETHERIUM_PROFILING is 1 (the host
+ * default); with 0 every type here is an empty stub, ProfileClock::now()
+ * is a constant and the instrumentation compiles away.
+ */
+
+#ifndef AETHERIUM_PROFILER_HPP
+#define AETHERIUM_PROFILER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifndef AETHERIUM_PROFILING
+#if defined(ARDUINO) || defined(AETHERIUM_PLATFORM_MCXN947)
+#define AETHERIUM_PROFILING 0
+#else
+#define AETHERIUM_PROFILING 1
+#endif
+#endif
+
+#if AETHERIUM_PROFILING
+#include <chrono>
+#endif
+
+namespace aeth {
+
+// Where a tick spends its time; ids are stable on the wire
+enum class TickPhase : uint8_t {
+    ScriptGc = 0,
+    Timers = 1,
+    Guards = 2,      // TransitionResolver::resolve, all guards of the tick
+    Transition = 3,  // Firing: onExit, transition body, onEnter
+    StateBody = 4
+};
+
+constexpr size_t TICK_PHASE_COUNT = 5;
+
+enum class ProfileHistogramKind : uint8_t {
+    Tick = 0,
+    Guard = 1,     // One transition's evaluation
+    Dispatch = 2   // One inbound message handled by the engine
+};
+
+struct ProfileClock {
+    static constexpr bool enabled = AETHERIUM_PROFILING != 0;
+
+    static uint64_t now() {
+#if AETHERIUM_PROFILING
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#else
+        return 0;
+#endif
+    }
+};
+
+/**
+ * HDR-style histogram of nanosecond values: exact below 8, then 8
+ * sub-buckets per power of two, so a bucket is at most 12.5% wide. Values
+ * of 2^40 ns (~18 min) and above land in the last bucket. Recording is a
+ * count-leading-zeros and an increment.
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BITS = 3;
+    static constexpr uint64_t SUB_COUNT = 1u << SUB_BITS;
+    static constexpr unsigned MAX_MAGNITUDE = 39;
+    static constexpr size_t BUCKETS = (MAX_MAGNITUDE - SUB_BITS + 2) * SUB_COUNT;
+
+    static unsigned highestBit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#else
+        unsigned bit = 0;
+        while (value >>= 1) {
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+
+    static size_t bucketOf(uint64_t value) {
+        if (value < SUB_COUNT) {
+            return static_cast<size_t>(value);
+        }
+        const unsigned magnitude = highestBit(value);
+        if (magnitude > MAX_MAGNITUDE) {
+            return BUCKETS - 1;
+        }
+        const uint64_t sub = (value >> (magnitude - SUB_BITS)) - SUB_COUNT;
+        return static_cast<size_t>((magnitude - SUB_BITS + 1) * SUB_COUNT + sub);
+    }
+
+    // Smallest value that maps to `bucket`
+    static uint64_t bucketLow(size_t bucket) {
+        if (bucket < SUB_COUNT) {
+            return bucket;
+        }
+        const unsigned magnitude = static_cast<unsigned>(bucket / SUB_COUNT) + SUB_BITS - 1;
+        return (SUB_COUNT + bucket % SUB_COUNT) << (magnitude - SUB_BITS);
+    }
+
+    // Largest value that maps to `bucket`
+    static uint64_t bucketHigh(size_t bucket) {
+        if (bucket < SUB_COUNT) {
+            return bucket;
+        }
+        const unsigned magnitude = static_cast<unsigned>(bucket / SUB_COUNT) + SUB_BITS - 1;
+        return bucketLow(bucket) + (uint64_t{1} << (magnitude - SUB_BITS)) - 1;
+    }
+
+#if AETHERIUM_PROFILING
+    void record(uint64_t value) {
+        ++counts_[bucketOf(value)];
+        ++count_;
+        sum_ += value;
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+
+    void reset() { *this = LatencyHistogram{}; }
+
+    [[nodiscard]] uint64_t count() const { return count_; }
+    [[nodiscard]] uint64_t sum() const { return sum_; }
+    [[nodiscard]] uint64_t min() const { return count_ > 0 ? min_ : 0; }
+    [[nodiscard]] uint64_t max() const { return max_; }
+    [[nodiscard]] uint32_t bucketCount(size_t bucket) const { return counts_[bucket]; }
+
+    // Upper bound of the bucket holding the q-th sample (0 <= q <= 1), capped at max()
+    [[nodiscard]] uint64_t percentile(double q) const {
+        if (count_ == 0) {
+            return 0;
+        }
+        const auto rank = static_cast<uint64_t>(std::clamp(q, 0.0, 1.0) * static_cast<double>(count_ - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) {
+                return std::min(bucketHigh(i), max_);
+            }
+        }
+        return max_;
+    }
+
+private:
+    std::array<uint32_t, BUCKETS> counts_{};
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+#else
+    void record(uint64_t) {}
+    void reset() {}
+    [[nodiscard]] uint64_t count() const { return 0; }
+    [[nodiscard]] uint64_t sum() const { return 0; }
+    [[nodiscard]] uint64_t min() const { return 0; }
+    [[nodiscard]] uint64_t max() const { return 0; }
+    [[nodiscard]] uint32_t bucketCount(size_t) const { return 0; }
+    [[nodiscard]] uint64_t percentile(double) const { return 0; }
+#endif
+};
+
+struct PhaseCounter {
+    uint64_t totalNs = 0;
+    uint64_t calls = 0;
+};
+
+// Which code block of a state or transition a script call ran; ids are stable on the wire
+enum class CodeSite : uint8_t {
+    OnEnter = 0,
+    Body = 1,
+    OnExit = 2,
+    Guard = 3,           // Classic condition or timed/event additional condition
+    TransitionBody = 4,
+    Triggered = 5,
+    Weight = 6           // Dynamic probabilistic weight
+};
+
+constexpr size_t STATE_CODE_SITES = 3;       // OnEnter, Body, OnExit
+constexpr size_t TRANSITION_CODE_SITES = 4;  // Guard .. Weight
+
+inline bool isStateSite(CodeSite site) {
+    return static_cast<size_t>(site) < STATE_CODE_SITES;
+}
+
+inline const char* codeSiteName(CodeSite site) {
+    switch (site) {
+        case CodeSite::OnEnter: return "on_enter";
+        case CodeSite::Body: return "body";
+        case CodeSite::OnExit: return "on_exit";
+        case CodeSite::Guard: return "guard";
+        case CodeSite::TransitionBody: return "transition_body";
+        case CodeSite::Triggered: return "triggered";
+        case CodeSite::Weight: return "weight";
+    }
+    return "unknown";
+}
+
+struct CodeBlockCost {
+    uint64_t totalNs = 0;
+    uint64_t calls = 0;
+    uint64_t allocatedBytes = 0;  // Script VM allocations made during the calls
+};
+
+struct CodeCostEntry {
+    CodeSite site = CodeSite::Body;
+    uint16_t ownerId = 0;  // StateId or TransitionId, by site
+    CodeBlockCost cost;
+};
+
+enum class CodeCostOrder : uint8_t {
+    Time = 0,
+    Calls = 1,
+    Memory = 2
+};
+
+// Most expensive first; ties keep their order
+inline void sortCodeCosts(std::vector<CodeCostEntry>& entries, CodeCostOrder order) {
+    auto key = [order](const CodeCostEntry& entry) {
+        switch (order) {
+            case CodeCostOrder::Calls: return entry.cost.calls;
+            case CodeCostOrder::Memory: return entry.cost.allocatedBytes;
+            case CodeCostOrder::Time: break;
+        }
+        return entry.cost.totalNs;
+    };
+    std::stable_sort(entries.begin(), entries.end(), [&key](const CodeCostEntry& a, const CodeCostEntry& b) {
+        return key(a) > key(b);
+    });
+}
+
+/**
+ * Cost of every code block of the loaded automata, in one array addressed
+ * by state/transition id: STATE_CODE_SITES slots per state id, then
+ * TRANSITION_CODE_SITES per transition id. Sized at load, so recording
+ * never allocates.
+ */
+class ScriptProfile {
+public:
+#if AETHERIUM_PROFILING
+    // Drops all costs; called whenever a new automata is installed
+    void resize(size_t stateIdLimit, size_t transitionIdLimit) {
+        stateIdLimit_ = stateIdLimit;
+        costs_.assign(stateIdLimit * STATE_CODE_SITES + transitionIdLimit * TRANSITION_CODE_SITES, {});
+    }
+
+    void record(CodeSite site, uint16_t ownerId, uint64_t ns, uint64_t allocatedBytes) {
+        const size_t index = slot(site, ownerId);
+        if (index >= costs_.size()) {
+            return;
+        }
+        auto& cost = costs_[index];
+        cost.totalNs += ns;
+        ++cost.calls;
+        cost.allocatedBytes += allocatedBytes;
+    }
+
+    [[nodiscard]] CodeBlockCost cost(CodeSite site, uint16_t ownerId) const {
+        const size_t index = slot(site, ownerId);
+        return index < costs_.size() ? costs_[index] : CodeBlockCost{};
+    }
+
+    // Every block that ran at least once, in id order
+    [[nodiscard]] std::vector<CodeCostEntry> entries() const {
+        std::vector<CodeCostEntry> out;
+        const size_t stateSlots = stateIdLimit_ * STATE_CODE_SITES;
+        for (size_t i = 0; i < costs_.size(); ++i) {
+            if (costs_[i].calls == 0) {
+                continue;
+            }
+            CodeCostEntry entry;
+            if (i < stateSlots) {
+                entry.site = static_cast<CodeSite>(i % STATE_CODE_SITES);
+                entry.ownerId = static_cast<uint16_t>(i / STATE_CODE_SITES);
+            } else {
+                const size_t offset = i - stateSlots;
+                entry.site = static_cast<CodeSite>(STATE_CODE_SITES + offset % TRANSITION_CODE_SITES);
+                entry.ownerId = static_cast<uint16_t>(offset / TRANSITION_CODE_SITES);
+            }
+            entry.cost = costs_[i];
+            out.push_back(entry);
+        }
+        return out;
+    }
+
+    void reset() { std::fill(costs_.begin(), costs_.end(), CodeBlockCost{}); }
+
+private:
+    [[nodiscard]] size_t slot(CodeSite site, uint16_t ownerId) const {
+        if (isStateSite(site)) {
+            return ownerId < stateIdLimit_ ? ownerId * STATE_CODE_SITES + static_cast<size_t>(site) : SIZE_MAX;
+        }
+        return stateIdLimit_ * STATE_CODE_SITES + ownerId * TRANSITION_CODE_SITES +
+               (static_cast<size_t>(site) - STATE_CODE_SITES);
+    }
+
+    size_t stateIdLimit_ = 0;
+    std::vector<CodeBlockCost> costs_;
+#else
+    void resize(size_t, size_t) {}
+    void record(CodeSite, uint16_t, uint64_t, uint64_t) {}
+    [[nodiscard]] CodeBlockCost cost(CodeSite, uint16_t) const { return {}; }
+    [[nodiscard]] std::vector<CodeCostEntry> entries() const { return {}; }
+    void reset() {}
+#endif
+};
+
+// Filled by Runtime; read through Runtime::profile()
+class RuntimeProfile {
+public:
+#if AETHERIUM_PROFILING
+    void addPhase(TickPhase phase, uint64_t ns) {
+        auto& counter = phases_[static_cast<size_t>(phase)];
+        counter.totalNs += ns;
+        ++counter.calls;
+    }
+
+    [[nodiscard]] const PhaseCounter& phase(TickPhase phase) const {
+        return phases_[static_cast<size_t>(phase)];
+    }
+
+    void reset() {
+        phases_ = {};
+        tick.reset();
+        guard.reset();
+        scripts.reset();
+    }
+
+    LatencyHistogram tick;
+    LatencyHistogram guard;
+    ScriptProfile scripts;
+
+private:
+    std::array<PhaseCounter, TICK_PHASE_COUNT> phases_{};
+#else
+    void addPhase(TickPhase, uint64_t) {}
+    [[nodiscard]] PhaseCounter phase(TickPhase) const { return {}; }
+    void reset() {}
+
+    LatencyHistogram tick;
+    LatencyHistogram guard;
+    ScriptProfile scripts;
+#endif
+};
+
+// Adds the scope's duration to one phase
+class PhaseScope {
+public:
+    PhaseScope(RuntimeProfile& profile, TickPhase phase)
+#if AETHERIUM_PROFILING
+        : profile_(profile), phase_(phase), start_(ProfileClock::now()) {}
+    ~PhaseScope() { profile_.addPhase(phase_, ProfileClock::now() - start_); }
+#else
+    {
+        (void)profile;
+        (void)phase;
+    }
+#endif
+
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+
+#if AETHERIUM_PROFILING
+private:
+    RuntimeProfile& profile_;
+    TickPhase phase_;
+    uint64_t start_;
+#endif
+};
+
+} // namespace aeth
+
+#endif // AETHERIUM_PROFILER_HPP
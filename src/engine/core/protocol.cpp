@@ -11,11 +11,20 @@
 namespace aeth {
 namespace protocol {
 
+// ============================================================================
+// Message
+// ============================================================================
+
+void Message::serializeInto(ByteWriter& out) const {
+    const auto bytes = serialize();
+    out.writeRaw(bytes.data(), bytes.size());
+}
+
 // ============================================================================
 // Value Serialization
 // ============================================================================
 
-static void writeValue(ByteWriter& writer, const Value& val) {
+void writeValue(ByteWriter& writer, const Value& val) {
     writer.writeU8(static_cast<uint8_t>(val.type()));
     
     switch (val.type()) {
@@ -45,17 +54,17 @@ static void writeValue(ByteWriter& writer, const Value& val) {
             break;
         }
         case ValueType::String:
-            writer.writeString(val.get<std::string>());
+            writer.writeString(val.str());
             break;
         case ValueType::Binary:
-            writer.writeBytes(val.get<std::vector<uint8_t>>());
+            writer.writeBytes(val.bytes().data, val.bytes().size);
             break;
         default:
             break;
     }
 }
 
-static std::optional<Value> readValue(ByteReader& reader) {
+std::optional<Value> readValue(ByteReader& reader) {
     auto typeOpt = reader.readU8();
     if (!typeOpt) return std::nullopt;
     
@@ -147,6 +156,30 @@ static std::optional<std::vector<NamedValueSnapshotEntry>> readNamedValueSnapsho
     return snapshot;
 }
 
+static void writeSymbols(ByteWriter& writer, const std::vector<SymbolEntry>& symbols) {
+    writer.writeU16(static_cast<uint16_t>(symbols.size()));
+    for (const auto& entry : symbols) {
+        writer.writeU16(entry.id);
+        writer.writeString(entry.name);
+    }
+}
+
+static std::optional<std::vector<SymbolEntry>> readSymbols(ByteReader& reader) {
+    auto count = reader.readU16();
+    if (!count) return std::nullopt;
+
+    std::vector<SymbolEntry> symbols;
+    symbols.reserve(*count);
+    for (uint16_t i = 0; i < *count; ++i) {
+        auto id = reader.readU16();
+        auto name = reader.readString();
+        if (!id || !name) return std::nullopt;
+        symbols.push_back(SymbolEntry{*id, std::move(*name)});
+    }
+
+    return symbols;
+}
+
 static void writeDeploymentMetadataExtension(ByteWriter& writer,
                                              const DeploymentMetadataExtension& deployment) {
     writer.writeU8(deployment.hasData() ? 1 : 0);
@@ -240,12 +273,219 @@ static std::optional<DeploymentMetadataExtension> readDeploymentMetadataExtensio
     return deployment;
 }
 
+// ============================================================================
+// Encoded Sizes
+// ============================================================================
+
+static size_t stringSize(std::string_view s) {
+    return 2 + s.size();
+}
+
+static size_t valueSize(const Value& val) {
+    switch (val.type()) {
+        case ValueType::Bool: return 1 + 1;
+        case ValueType::Int32:
+        case ValueType::Float32: return 1 + 4;
+        case ValueType::Int64:
+        case ValueType::Float64: return 1 + 8;
+        case ValueType::String: return 1 + stringSize(val.str());
+        case ValueType::Binary: return 1 + 2 + val.bytes().size;
+        default: return 1;
+    }
+}
+
+static size_t namedValueSnapshotSize(const std::vector<NamedValueSnapshotEntry>& snapshot) {
+    size_t size = 2;
+    for (const auto& entry : snapshot) {
+        size += stringSize(entry.variableName) + valueSize(entry.value);
+    }
+    return size;
+}
+
+static size_t symbolsSize(const std::vector<SymbolEntry>& symbols) {
+    size_t size = 2;
+    for (const auto& entry : symbols) {
+        size += 2 + stringSize(entry.name);
+    }
+    return size;
+}
+
+static size_t deploymentMetadataSize(const DeploymentMetadataExtension& deployment) {
+    if (!deployment.hasData()) {
+        return 1;
+    }
+    return 1 + stringSize(deployment.placement) + stringSize(deployment.transport) +
+           stringSize(deployment.controlPlaneInstance) + stringSize(deployment.targetClass) +
+           3 + 2 + 5 * 4 + 3 * 8 +
+           stringSize(deployment.traceFile) + stringSize(deployment.faultProfile) + 4;
+}
+
+size_t HelloMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 6 + stringSize(name) + deploymentMetadataSize(deployment);
+}
+
+size_t HelloAckMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 13 + stringSize(rejectReason);
+}
+
+size_t PingMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 12;
+}
+
+size_t PongMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 20;
+}
+
+size_t LoadAutomataMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 12 + 2 + data.size() + (chunkCrc ? 4 : 0);
+}
+
+size_t LoadAckMessage::serializedSize() const {
+    size_t size = FRAME_PREFIX_SIZE + 5 + stringSize(errorMessage) + 2;
+    for (const auto& warn : warnings) {
+        size += stringSize(warn);
+    }
+    return size;
+}
+
+size_t StartMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 5 + (startFromState ? 2 : 0);
+}
+
+size_t StopMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 5;
+}
+
+size_t ResetMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 4;
+}
+
+size_t StatusMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 35 + namedValueSnapshotSize(variableSnapshot) +
+           deploymentMetadataSize(deployment);
+}
+
+size_t PauseMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 4;
+}
+
+size_t ResumeMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 4;
+}
+
+size_t InputMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 6 + stringSize(variableName) + valueSize(value);
+}
+
+size_t InputBatchMessage::serializedSize() const {
+    size_t size = FRAME_PREFIX_SIZE + 6;
+    for (const auto& input : inputs) {
+        size += 2 + valueSize(input.value);
+    }
+    return size;
+}
+
+size_t OutputBatchMessage::serializedSize() const {
+    size_t size = FRAME_PREFIX_SIZE + 14;
+    for (const auto& output : outputs) {
+        size += 2 + valueSize(output.value);
+    }
+    return size;
+}
+
+size_t OutputAggregateMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 26 + stringSize(variableName) + valueSize(min) + valueSize(max) + valueSize(mean) +
+           valueSize(last);
+}
+
+size_t OutputMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 14 + stringSize(variableName) + valueSize(value);
+}
+
+size_t VariableMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 14 + stringSize(variableName) + valueSize(value);
+}
+
+size_t RestoreStateMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 4 + stringSize(targetState) + namedValueSnapshotSize(variables);
+}
+
+size_t SymbolTableMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 4 + symbolsSize(variables) + symbolsSize(states);
+}
+
+size_t PeerWiringMessage::serializedSize() const {
+    size_t size = FRAME_PREFIX_SIZE + 6 + 2;
+    for (const auto& wire : wires) {
+        size += 8 + stringSize(wire.sourcePort) + stringSize(wire.targetPort) + stringSize(wire.endpoint);
+    }
+    return size;
+}
+
+size_t StateChangeMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 18;
+}
+
+size_t TelemetryMessage::serializedSize() const {
+    size_t size = FRAME_PREFIX_SIZE + 26 + 2;
+    for (const auto& [id, val] : variableSnapshot) {
+        (void)id;
+        size += 2 + valueSize(val);
+    }
+    return size + namedValueSnapshotSize(namedVariableSnapshot) + deploymentMetadataSize(deployment) + 4;
+}
+
+size_t TransitionFiredMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 14;
+}
+
+size_t TelemetryDeltaMessage::serializedSize() const {
+    size_t size = FRAME_PREFIX_SIZE + 21 + symbolsSize(names) + 2;
+    for (const auto& update : values) {
+        size += 2 + valueSize(update.value);
+    }
+    return size;
+}
+
+size_t TelemetryAckMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 9;
+}
+
+size_t ProfileMessage::serializedSize() const {
+    size_t size = FRAME_PREFIX_SIZE + 13 + 1 + phases.size() * 17 + 1;
+    for (const auto& histogram : histograms) {
+        size += 35 + histogram.buckets.size() * 6;
+    }
+    return size + 2 + codeBlocks.size() * 27;
+}
+
+size_t ErrorMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 2 + stringSize(message) + 1 + (runId ? 4 : 0) + 1 +
+           (relatedMessageId ? 4 : 0);
+}
+
+size_t DebugMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 1 + stringSize(source) + stringSize(message) + 8;
+}
+
+size_t AckMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 4 + stringSize(info);
+}
+
+size_t NakMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + 6 + stringSize(reason);
+}
+
+size_t RawMessage::serializedSize() const {
+    return FRAME_PREFIX_SIZE + payload.size();
+}
+
 // ============================================================================
 // Hello Message
 // ============================================================================
 
 std::vector<uint8_t> HelloMessage::serialize() const {
-    ByteWriter w;
+    ByteWriter w(serializedSize());
     w.writeU16(header.magic);
     w.writeU8(header.version);
     w.writeU8(static_cast<uint8_t>(MessageType::Hello));
@@ -323,7 +563,7 @@ std::optional<HelloMessage> HelloMessage::deserialize(const uint8_t* data, size_
 // ============================================================================
 
 std::vector<uint8_t> HelloAckMessage::serialize() const {
-    ByteWriter w;
+    ByteWriter w(serializedSize());
     w.writeU16(header.magic);
     w.writeU8(header.version);
     w.writeU8(static_cast<uint8_t>(MessageType::HelloAck));
@@ -380,7 +620,7 @@ std::optional<HelloAckMessage> HelloAckMessage::deserialize(const uint8_t* data,
 // ============================================================================
 
 std::vector<uint8_t> PingMessage::serialize() const {
-    ByteWriter w;
+    ByteWriter w(serializedSize());
     w.writeU16(header.magic);
     w.writeU8(header.version);
     w.writeU8(static_cast<uint8_t>(MessageType::Ping));
@@ -425,7 +665,7 @@ std::optional<PingMessage> PingMessage::deserialize(const uint8_t* data, size_t
 }
 
 std::vector<uint8_t> PongMessage::serialize() const {
-    ByteWriter w;
+    ByteWriter w(serializedSize());
     w.writeU16(header.magic);
     w.writeU8(header.version);
     w.writeU8(static_cast<uint8_t>(MessageType::Pong));
@@ -477,7 +717,7 @@ std::optional<PongMessage> PongMessage::deserialize(const uint8_t* data, size_t
 // ============================================================================
 
 std::vector<uint8_t> LoadAutomataMessage::serialize() const {
-    ByteWriter w;
+    ByteWriter w(serializedSize());
     w.writeU16(header.magic);
     w.writeU8(header.version);
     w.writeU8(static_cast<uint8_t>(MessageType::LoadAutomata));
@@ -490,12 +730,15 @@ std::vector<uint8_t> LoadAutomataMessage::serialize() const {
     w.writeU32(targetId);
     w.writeU32(runId);
     w.writeU8(static_cast<uint8_t>(format));
-    w.writeU8(isChunked ? 1 : 0);
+    w.writeU8(static_cast<uint8_t>((isChunked ? 0x01 : 0) | (chunkCrc ? 0x02 : 0)));
     w.writeU16(chunkIndex);
     w.writeU16(totalChunks);
     w.writeU8(startAfterLoad ? 1 : 0);
     w.writeU8(replaceExisting ? 1 : 0);
     w.writeBytes(data);
+    if (chunkCrc) {
+        w.writeU32(*chunkCrc);
+    }
     
     auto result = w.finish();
     uint16_t length = static_cast<uint16_t>(result.size() - HEADER_SIZE);
@@ -508,7 +751,7 @@ std::vector<uint8_t> LoadAutomataMessage::serialize() const {
 std::optional<LoadAutomataMessage> LoadAutomataMessage::deserialize(const uint8_t* data, size_t len) {
     ByteReader r(data, len);
     r.readU16(); r.readU8(); r.readU8(); r.readU16();
-    
+
     LoadAutomataMessage msg;
     auto msgId = r.readU32();
     auto srcId = r.readU32();
@@ -521,24 +764,31 @@ std::optional<LoadAutomataMessage> LoadAutomataMessage::deserialize(const uint8_
     auto startAfter = r.readU8();
     auto replace = r.readU8();
     auto payload = r.readBytes();
-    
+
     if (!msgId || !srcId || !tgtId || !runId || !format || !isChunked ||
         !chunkIdx || !totalChunks || !startAfter || !replace || !payload) {
         return std::nullopt;
     }
-    
+
+    if ((*isChunked & 0x02) != 0) {
+        auto crc = r.readU32();
+        if (!crc) {
+            return std::nullopt;
+        }
+        msg.chunkCrc = *crc;
+    }
+
     msg.messageId = *msgId;
     msg.sourceId = *srcId;
     msg.targetId = *tgtId;
     msg.runId = *runId;
     msg.format = static_cast<AutomataFormat>(*format);
-    msg.isChunked = *isChunked != 0;
+    msg.isChunked = (*isChunked & 0x01) != 0;
     msg.chunkIndex = *chunkIdx;
     msg.totalChunks = *totalChunks;
     msg.startAfterLoad = *startAfter != 0;
     msg.replaceExisting = *replace != 0;
     msg.data = std::move(*payload);
-    
     return msg;
 }
 
@@ -547,7 +797,7 @@ std::optional<LoadAutomataMessage> LoadAutomataMessage::deserialize(const uint8_
 // ============================================================================
 
 std::vector<uint8_t> LoadAckMessage::serialize() const {
-    ByteWriter w;
+    ByteWriter w(serializedSize());
     w.writeU16(header.magic);
     w.writeU8(header.version);
     w.writeU8(static_cast<uint8_t>(MessageType::LoadAck));
@@ -612,7 +862,7 @@ std::optional<LoadAckMessage> LoadAckMessage::deserialize(const uint8_t* data, s
 // ============================================================================
 
 std::vector<uint8_t> StartMessage::serialize() const {
-    ByteWriter w;
+    ByteWriter w(serializedSize());
     w.writeU16(header.magic);
     w.writeU8(header.version);
     w.writeU8(static_cast<uint8_t>(MessageType::Start));
@@ -665,7 +915,7 @@ std::optional<StartMessage> StartMessage::deserialize(const uint8_t* data, size_
 }
 
 std::vector<uint8_t> StopMessage::serialize() const {
-    ByteWriter w;
+    ByteWriter w(serializedSize());
     w.writeU16(header.magic);
     w.writeU8(header.version);
     w.writeU8(static_cast<uint8_t>(MessageType::Stop));
@@ -710,7 +960,7 @@ std::optional<StopMessage> StopMessage::deserialize(const uint8_t* data, size_t
 }
 
 std::vector<uint8_t> ResetMessage::serialize() const {
-    ByteWriter w;
+    ByteWriter w(serializedSize());
     w.writeU16(header.magic);
     w.writeU8(header.version);
     w.writeU8(static_cast<uint8_t>(MessageType::Reset));
@@ -755,7 +1005,7 @@ std::optional<ResetMessage> ResetMessage::deserialize(const uint8_t* data, size_
 // ============================================================================
 
 std::vector<uint8_t> StatusMessage::serialize() const {
-    ByteWriter w;
+    ByteWriter w(serializedSize());
     w.writeU16(header.magic);
     w.writeU8(header.version);
     w.writeU8(static_cast<uint8_t>(MessageType::Status));
@@ -830,7 +1080,7 @@ std::optional<StatusMessage> StatusMessage::deserialize(const uint8_t* data, siz
 }
 
 std::vector<uint8_t> PauseMessage::serialize() const {
-    ByteWriter w;
+    ByteWriter w(serializedSize());
     w.writeU16(header.magic);
     w.writeU8(header.version);
     w.writeU8(static_cast<uint8_t>(MessageType::Pause));
@@ -870,7 +1120,7 @@ std::optional<PauseMessage> PauseMessage::deserialize(const uint8_t* data, size_
 }
 
 std::vector<uint8_t> ResumeMessage::serialize() const {
-    ByteWriter w;
+    ByteWriter w(serializedSize());
     w.writeU16(header.magic);
     w.writeU8(header.version);
     w.writeU8(static_cast<uint8_t>(MessageType::Resume));
@@ -914,7 +1164,7 @@ std::optional<ResumeMessage> ResumeMessage::deserialize(const uint8_t* data, siz
 // ============================================================================
 
 std::vector<uint8_t> InputMessage::serialize() const {
-    ByteWriter w;
+    ByteWriter w(serializedSize());
     w.writeU16(header.magic);
     w.writeU8(header.version);
     w.writeU8(static_cast<uint8_t>(MessageType::Input));
@@ -966,67 +1216,70 @@ std::optional<InputMessage> InputMessage::deserialize(const uint8_t* data, size_
     return msg;
 }
 
-std::vector<uint8_t> OutputMessage::serialize() const {
-    ByteWriter w;
+std::vector<uint8_t> InputBatchMessage::serialize() const {
+    ByteWriter w(serializedSize());
     w.writeU16(header.magic);
     w.writeU8(header.version);
-    w.writeU8(static_cast<uint8_t>(MessageType::Output));
-    
+    w.writeU8(static_cast<uint8_t>(MessageType::InputBatch));
+
     size_t lengthPos = w.size();
     w.writeU16(0);
-    
+
     w.writeU32(messageId);
     w.writeU32(sourceId);
     w.writeU32(targetId);
     w.writeU32(runId);
-    w.writeU16(variableId);
-    w.writeString(variableName);
-    writeValue(w, value);
-    w.writeU64(timestamp);
-    
+    w.writeU16(static_cast<uint16_t>(inputs.size()));
+    for (const auto& input : inputs) {
+        w.writeU16(input.id);
+        writeValue(w, input.value);
+    }
+
     auto result = w.finish();
     uint16_t length = static_cast<uint16_t>(result.size() - HEADER_SIZE);
     result[lengthPos] = static_cast<uint8_t>(length >> 8);
     result[lengthPos + 1] = static_cast<uint8_t>(length & 0xFF);
-    
+
     return result;
 }
 
-std::optional<OutputMessage> OutputMessage::deserialize(const uint8_t* data, size_t len) {
+std::optional<InputBatchMessage> InputBatchMessage::deserialize(const uint8_t* data, size_t len) {
     ByteReader r(data, len);
     r.readU16(); r.readU8(); r.readU8(); r.readU16();
-    
-    OutputMessage msg;
+
+    InputBatchMessage msg;
     auto msgId = r.readU32();
     auto srcId = r.readU32();
     auto tgtId = r.readU32();
     auto runId = r.readU32();
-    auto varId = r.readU16();
-    auto varName = r.readString();
-    auto val = readValue(r);
-    auto ts = r.readU64();
-    
-    if (!msgId || !srcId || !tgtId || !runId || !varId || !varName || !val || !ts) {
+    auto count = r.readU16();
+
+    if (!msgId || !srcId || !tgtId || !runId || !count) {
         return std::nullopt;
     }
-    
+
     msg.messageId = *msgId;
     msg.sourceId = *srcId;
     msg.targetId = *tgtId;
     msg.runId = *runId;
-    msg.variableId = *varId;
-    msg.variableName = std::move(*varName);
-    msg.value = std::move(*val);
-    msg.timestamp = *ts;
-    
+    msg.inputs.reserve(*count);
+    for (uint16_t i = 0; i < *count; ++i) {
+        auto varId = r.readU16();
+        auto val = readValue(r);
+        if (!varId || !val) {
+            return std::nullopt;
+        }
+        msg.inputs.push_back(VariableUpdate{*varId, std::move(*val)});
+    }
+
     return msg;
 }
 
-std::vector<uint8_t> VariableMessage::serialize() const {
-    ByteWriter w;
+std::vector<uint8_t> OutputBatchMessage::serialize() const {
+    ByteWriter w(serializedSize());
     w.writeU16(header.magic);
     w.writeU8(header.version);
-    w.writeU8(static_cast<uint8_t>(MessageType::Variable));
+    w.writeU8(static_cast<uint8_t>(MessageType::OutputBatch));
 
     size_t lengthPos = w.size();
     w.writeU16(0);
@@ -1035,33 +1288,34 @@ std::vector<uint8_t> VariableMessage::serialize() const {
     w.writeU32(sourceId);
     w.writeU32(targetId);
     w.writeU32(runId);
-    w.writeU16(variableId);
-    w.writeString(variableName);
-    writeValue(w, value);
     w.writeU64(timestamp);
+    w.writeU16(static_cast<uint16_t>(outputs.size()));
+    for (const auto& output : outputs) {
+        w.writeU16(output.id);
+        writeValue(w, output.value);
+    }
 
     auto result = w.finish();
     uint16_t length = static_cast<uint16_t>(result.size() - HEADER_SIZE);
     result[lengthPos] = static_cast<uint8_t>(length >> 8);
     result[lengthPos + 1] = static_cast<uint8_t>(length & 0xFF);
+
     return result;
 }
 
-std::optional<VariableMessage> VariableMessage::deserialize(const uint8_t* data, size_t len) {
+std::optional<OutputBatchMessage> OutputBatchMessage::deserialize(const uint8_t* data, size_t len) {
     ByteReader r(data, len);
     r.readU16(); r.readU8(); r.readU8(); r.readU16();
 
-    VariableMessage msg;
+    OutputBatchMessage msg;
     auto msgId = r.readU32();
     auto srcId = r.readU32();
     auto tgtId = r.readU32();
     auto runId = r.readU32();
-    auto varId = r.readU16();
-    auto varName = r.readString();
-    auto val = readValue(r);
     auto ts = r.readU64();
+    auto count = r.readU16();
 
-    if (!msgId || !srcId || !tgtId || !runId || !varId || !varName || !val || !ts) {
+    if (!msgId || !srcId || !tgtId || !runId || !ts || !count) {
         return std::nullopt;
     }
 
@@ -1069,22 +1323,25 @@ std::optional<VariableMessage> VariableMessage::deserialize(const uint8_t* data,
     msg.sourceId = *srcId;
     msg.targetId = *tgtId;
     msg.runId = *runId;
-    msg.variableId = *varId;
-    msg.variableName = std::move(*varName);
-    msg.value = std::move(*val);
     msg.timestamp = *ts;
+    msg.outputs.reserve(*count);
+    for (uint16_t i = 0; i < *count; ++i) {
+        auto varId = r.readU16();
+        auto val = readValue(r);
+        if (!varId || !val) {
+            return std::nullopt;
+        }
+        msg.outputs.push_back(VariableUpdate{*varId, std::move(*val)});
+    }
+
     return msg;
 }
 
-// ============================================================================
-// RestoreState Message
-// ============================================================================
-
-std::vector<uint8_t> RestoreStateMessage::serialize() const {
-    ByteWriter w;
+std::vector<uint8_t> OutputAggregateMessage::serialize() const {
+    ByteWriter w(serializedSize());
     w.writeU16(header.magic);
     w.writeU8(header.version);
-    w.writeU8(static_cast<uint8_t>(MessageType::RestoreState));
+    w.writeU8(static_cast<uint8_t>(MessageType::OutputAggregate));
 
     size_t lengthPos = w.size();
     w.writeU16(0);
@@ -1093,48 +1350,71 @@ std::vector<uint8_t> RestoreStateMessage::serialize() const {
     w.writeU32(sourceId);
     w.writeU32(targetId);
     w.writeU32(runId);
-    w.writeString(targetState);
-    writeNamedValueSnapshot(w, variables);
+    w.writeU16(variableId);
+    w.writeString(variableName);
+    w.writeU64(windowStart);
+    w.writeU64(windowEnd);
+    w.writeU32(count);
+    writeValue(w, min);
+    writeValue(w, max);
+    writeValue(w, mean);
+    writeValue(w, last);
 
     auto result = w.finish();
     uint16_t length = static_cast<uint16_t>(result.size() - HEADER_SIZE);
     result[lengthPos] = static_cast<uint8_t>(length >> 8);
     result[lengthPos + 1] = static_cast<uint8_t>(length & 0xFF);
+
     return result;
 }
 
-std::optional<RestoreStateMessage> RestoreStateMessage::deserialize(const uint8_t* data, size_t len) {
+std::optional<OutputAggregateMessage> OutputAggregateMessage::deserialize(const uint8_t* data, size_t len) {
     ByteReader r(data, len);
     r.readU16(); r.readU8(); r.readU8(); r.readU16();
 
-    auto msgId   = r.readU32();
-    auto srcId   = r.readU32();
-    auto tgtId   = r.readU32();
-    auto runId   = r.readU32();
-    auto state   = r.readString();
-    auto vars    = readNamedValueSnapshot(r);
+    OutputAggregateMessage msg;
+    auto msgId = r.readU32();
+    auto srcId = r.readU32();
+    auto tgtId = r.readU32();
+    auto runId = r.readU32();
+    auto varId = r.readU16();
+    auto varName = r.readString();
+    auto start = r.readU64();
+    auto end = r.readU64();
+    auto count = r.readU32();
+    auto min = readValue(r);
+    auto max = readValue(r);
+    auto mean = readValue(r);
+    auto last = readValue(r);
+
+    if (!msgId || !srcId || !tgtId || !runId || !varId || !varName || !start || !end || !count ||
+        !min || !max || !mean || !last) {
+        return std::nullopt;
+    }
 
-    if (!msgId || !srcId || !tgtId || !runId || !state || !vars) return std::nullopt;
+    msg.messageId = *msgId;
+    msg.sourceId = *srcId;
+    msg.targetId = *tgtId;
+    msg.runId = *runId;
+    msg.variableId = *varId;
+    msg.variableName = std::move(*varName);
+    msg.windowStart = *start;
+    msg.windowEnd = *end;
+    msg.count = *count;
+    msg.min = std::move(*min);
+    msg.max = std::move(*max);
+    msg.mean = std::move(*mean);
+    msg.last = std::move(*last);
 
-    RestoreStateMessage msg;
-    msg.messageId   = *msgId;
-    msg.sourceId    = *srcId;
-    msg.targetId    = *tgtId;
-    msg.runId       = *runId;
-    msg.targetState = std::move(*state);
-    msg.variables   = std::move(*vars);
     return msg;
 }
 
-// ============================================================================
-// StateChange Message
-// ============================================================================
-
-std::vector<uint8_t> StateChangeMessage::serialize() const {
-    ByteWriter w;
+void OutputMessage::serializeInto(ByteWriter& w) const {
+    w.reserve(serializedSize());
+    const size_t start = w.size();
     w.writeU16(header.magic);
     w.writeU8(header.version);
-    w.writeU8(static_cast<uint8_t>(MessageType::StateChange));
+    w.writeU8(static_cast<uint8_t>(MessageType::Output));
     
     size_t lengthPos = w.size();
     w.writeU16(0);
@@ -1143,33 +1423,311 @@ std::vector<uint8_t> StateChangeMessage::serialize() const {
     w.writeU32(sourceId);
     w.writeU32(targetId);
     w.writeU32(runId);
-    w.writeU16(previousState);
-    w.writeU16(newState);
-    w.writeU16(firedTransition);
+    w.writeU16(variableId);
+    w.writeString(variableName);
+    writeValue(w, value);
     w.writeU64(timestamp);
     
-    auto result = w.finish();
-    uint16_t length = static_cast<uint16_t>(result.size() - HEADER_SIZE);
-    result[lengthPos] = static_cast<uint8_t>(length >> 8);
-    result[lengthPos + 1] = static_cast<uint8_t>(length & 0xFF);
-    
-    return result;
+    w.patchU16(lengthPos, static_cast<uint16_t>(w.size() - start - HEADER_SIZE));
 }
 
-std::optional<StateChangeMessage> StateChangeMessage::deserialize(const uint8_t* data, size_t len) {
+std::vector<uint8_t> OutputMessage::serialize() const {
+    ByteWriter w(serializedSize());
+    serializeInto(w);
+    return w.finish();
+}
+
+std::optional<OutputMessage> OutputMessage::deserialize(const uint8_t* data, size_t len) {
     ByteReader r(data, len);
     r.readU16(); r.readU8(); r.readU8(); r.readU16();
     
-    StateChangeMessage msg;
+    OutputMessage msg;
     auto msgId = r.readU32();
     auto srcId = r.readU32();
     auto tgtId = r.readU32();
     auto runId = r.readU32();
-    auto prevState = r.readU16();
-    auto newState = r.readU16();
-    auto firedTrans = r.readU16();
-    auto ts = r.readU64();
-    
+    auto varId = r.readU16();
+    auto varName = r.readString();
+    auto val = readValue(r);
+    auto ts = r.readU64();
+    
+    if (!msgId || !srcId || !tgtId || !runId || !varId || !varName || !val || !ts) {
+        return std::nullopt;
+    }
+    
+    msg.messageId = *msgId;
+    msg.sourceId = *srcId;
+    msg.targetId = *tgtId;
+    msg.runId = *runId;
+    msg.variableId = *varId;
+    msg.variableName = std::move(*varName);
+    msg.value = std::move(*val);
+    msg.timestamp = *ts;
+    
+    return msg;
+}
+
+std::vector<uint8_t> VariableMessage::serialize() const {
+    ByteWriter w(serializedSize());
+    w.writeU16(header.magic);
+    w.writeU8(header.version);
+    w.writeU8(static_cast<uint8_t>(MessageType::Variable));
+
+    size_t lengthPos = w.size();
+    w.writeU16(0);
+
+    w.writeU32(messageId);
+    w.writeU32(sourceId);
+    w.writeU32(targetId);
+    w.writeU32(runId);
+    w.writeU16(variableId);
+    w.writeString(variableName);
+    writeValue(w, value);
+    w.writeU64(timestamp);
+
+    auto result = w.finish();
+    uint16_t length = static_cast<uint16_t>(result.size() - HEADER_SIZE);
+    result[lengthPos] = static_cast<uint8_t>(length >> 8);
+    result[lengthPos + 1] = static_cast<uint8_t>(length & 0xFF);
+    return result;
+}
+
+std::optional<VariableMessage> VariableMessage::deserialize(const uint8_t* data, size_t len) {
+    ByteReader r(data, len);
+    r.readU16(); r.readU8(); r.readU8(); r.readU16();
+
+    VariableMessage msg;
+    auto msgId = r.readU32();
+    auto srcId = r.readU32();
+    auto tgtId = r.readU32();
+    auto runId = r.readU32();
+    auto varId = r.readU16();
+    auto varName = r.readString();
+    auto val = readValue(r);
+    auto ts = r.readU64();
+
+    if (!msgId || !srcId || !tgtId || !runId || !varId || !varName || !val || !ts) {
+        return std::nullopt;
+    }
+
+    msg.messageId = *msgId;
+    msg.sourceId = *srcId;
+    msg.targetId = *tgtId;
+    msg.runId = *runId;
+    msg.variableId = *varId;
+    msg.variableName = std::move(*varName);
+    msg.value = std::move(*val);
+    msg.timestamp = *ts;
+    return msg;
+}
+
+// ============================================================================
+// RestoreState Message
+// ============================================================================
+
+std::vector<uint8_t> RestoreStateMessage::serialize() const {
+    ByteWriter w(serializedSize());
+    w.writeU16(header.magic);
+    w.writeU8(header.version);
+    w.writeU8(static_cast<uint8_t>(MessageType::RestoreState));
+
+    size_t lengthPos = w.size();
+    w.writeU16(0);
+
+    w.writeU32(messageId);
+    w.writeU32(sourceId);
+    w.writeU32(targetId);
+    w.writeU32(runId);
+    w.writeString(targetState);
+    writeNamedValueSnapshot(w, variables);
+
+    auto result = w.finish();
+    uint16_t length = static_cast<uint16_t>(result.size() - HEADER_SIZE);
+    result[lengthPos] = static_cast<uint8_t>(length >> 8);
+    result[lengthPos + 1] = static_cast<uint8_t>(length & 0xFF);
+    return result;
+}
+
+std::optional<RestoreStateMessage> RestoreStateMessage::deserialize(const uint8_t* data, size_t len) {
+    ByteReader r(data, len);
+    r.readU16(); r.readU8(); r.readU8(); r.readU16();
+
+    auto msgId   = r.readU32();
+    auto srcId   = r.readU32();
+    auto tgtId   = r.readU32();
+    auto runId   = r.readU32();
+    auto state   = r.readString();
+    auto vars    = readNamedValueSnapshot(r);
+
+    if (!msgId || !srcId || !tgtId || !runId || !state || !vars) return std::nullopt;
+
+    RestoreStateMessage msg;
+    msg.messageId   = *msgId;
+    msg.sourceId    = *srcId;
+    msg.targetId    = *tgtId;
+    msg.runId       = *runId;
+    msg.targetState = std::move(*state);
+    msg.variables   = std::move(*vars);
+    return msg;
+}
+
+// ============================================================================
+// SymbolTable Message
+// ============================================================================
+
+std::vector<uint8_t> SymbolTableMessage::serialize() const {
+    ByteWriter w(serializedSize());
+    w.writeU16(header.magic);
+    w.writeU8(header.version);
+    w.writeU8(static_cast<uint8_t>(MessageType::SymbolTable));
+
+    size_t lengthPos = w.size();
+    w.writeU16(0);
+
+    w.writeU32(messageId);
+    w.writeU32(sourceId);
+    w.writeU32(targetId);
+    w.writeU32(runId);
+    writeSymbols(w, variables);
+    writeSymbols(w, states);
+
+    w.patchU16(lengthPos, static_cast<uint16_t>(w.size() - HEADER_SIZE));
+    return w.finish();
+}
+
+std::optional<SymbolTableMessage> SymbolTableMessage::deserialize(const uint8_t* data, size_t len) {
+    ByteReader r(data, len);
+    r.readU16(); r.readU8(); r.readU8(); r.readU16();
+
+    auto msgId     = r.readU32();
+    auto srcId     = r.readU32();
+    auto tgtId     = r.readU32();
+    auto runId     = r.readU32();
+    auto variables = readSymbols(r);
+    auto states    = readSymbols(r);
+
+    if (!msgId || !srcId || !tgtId || !runId || !variables || !states) return std::nullopt;
+
+    SymbolTableMessage msg;
+    msg.messageId = *msgId;
+    msg.sourceId  = *srcId;
+    msg.targetId  = *tgtId;
+    msg.runId     = *runId;
+    msg.variables = std::move(*variables);
+    msg.states    = std::move(*states);
+    return msg;
+}
+
+// ============================================================================
+// PeerWiring Message
+// ============================================================================
+
+std::vector<uint8_t> PeerWiringMessage::serialize() const {
+    ByteWriter w(serializedSize());
+    w.writeU16(header.magic);
+    w.writeU8(header.version);
+    w.writeU8(static_cast<uint8_t>(MessageType::PeerWiring));
+
+    size_t lengthPos = w.size();
+    w.writeU16(0);
+
+    w.writeU32(messageId);
+    w.writeU32(sourceId);
+    w.writeU32(targetId);
+    w.writeU32(runId);
+    w.writeU16(sampleEvery);
+    w.writeU16(static_cast<uint16_t>(wires.size()));
+    for (const auto& wire : wires) {
+        w.writeU32(wire.sourceDevice);
+        w.writeString(wire.sourcePort);
+        w.writeU32(wire.targetDevice);
+        w.writeString(wire.targetPort);
+        w.writeString(wire.endpoint);
+    }
+
+    w.patchU16(lengthPos, static_cast<uint16_t>(w.size() - HEADER_SIZE));
+    return w.finish();
+}
+
+std::optional<PeerWiringMessage> PeerWiringMessage::deserialize(const uint8_t* data, size_t len) {
+    ByteReader r(data, len);
+    r.readU16(); r.readU8(); r.readU8(); r.readU16();
+
+    auto msgId       = r.readU32();
+    auto srcId       = r.readU32();
+    auto tgtId       = r.readU32();
+    auto runId       = r.readU32();
+    auto sampleEvery = r.readU16();
+    auto count       = r.readU16();
+
+    if (!msgId || !srcId || !tgtId || !runId || !sampleEvery || !count) return std::nullopt;
+
+    PeerWiringMessage msg;
+    msg.messageId   = *msgId;
+    msg.sourceId    = *srcId;
+    msg.targetId    = *tgtId;
+    msg.runId       = *runId;
+    msg.sampleEvery = *sampleEvery;
+    msg.wires.reserve(*count);
+    for (uint16_t i = 0; i < *count; ++i) {
+        auto sourceDevice = r.readU32();
+        auto sourcePort   = r.readString();
+        auto targetDevice = r.readU32();
+        auto targetPort   = r.readString();
+        auto endpoint     = r.readString();
+        if (!sourceDevice || !sourcePort || !targetDevice || !targetPort || !endpoint) return std::nullopt;
+        msg.wires.push_back(PeerWire{*sourceDevice, std::move(*sourcePort), *targetDevice,
+                                     std::move(*targetPort), std::move(*endpoint)});
+    }
+    return msg;
+}
+
+// ============================================================================
+// StateChange Message
+// ============================================================================
+
+void StateChangeMessage::serializeInto(ByteWriter& w) const {
+    w.reserve(serializedSize());
+    const size_t start = w.size();
+    w.writeU16(header.magic);
+    w.writeU8(header.version);
+    w.writeU8(static_cast<uint8_t>(MessageType::StateChange));
+    
+    size_t lengthPos = w.size();
+    w.writeU16(0);
+    
+    w.writeU32(messageId);
+    w.writeU32(sourceId);
+    w.writeU32(targetId);
+    w.writeU32(runId);
+    w.writeU16(previousState);
+    w.writeU16(newState);
+    w.writeU16(firedTransition);
+    w.writeU64(timestamp);
+    
+    w.patchU16(lengthPos, static_cast<uint16_t>(w.size() - start - HEADER_SIZE));
+}
+
+std::vector<uint8_t> StateChangeMessage::serialize() const {
+    ByteWriter w(serializedSize());
+    serializeInto(w);
+    return w.finish();
+}
+
+std::optional<StateChangeMessage> StateChangeMessage::deserialize(const uint8_t* data, size_t len) {
+    ByteReader r(data, len);
+    r.readU16(); r.readU8(); r.readU8(); r.readU16();
+    
+    StateChangeMessage msg;
+    auto msgId = r.readU32();
+    auto srcId = r.readU32();
+    auto tgtId = r.readU32();
+    auto runId = r.readU32();
+    auto prevState = r.readU16();
+    auto newState = r.readU16();
+    auto firedTrans = r.readU16();
+    auto ts = r.readU64();
+    
     if (!msgId || !srcId || !tgtId || !runId || !prevState || !newState || 
         !firedTrans || !ts) {
         return std::nullopt;
@@ -1191,8 +1749,9 @@ std::optional<StateChangeMessage> StateChangeMessage::deserialize(const uint8_t*
 // Telemetry Message
 // ============================================================================
 
-std::vector<uint8_t> TelemetryMessage::serialize() const {
-    ByteWriter w;
+void TelemetryMessage::serializeInto(ByteWriter& w) const {
+    w.reserve(serializedSize());
+    const size_t start = w.size();
     w.writeU16(header.magic);
     w.writeU8(header.version);
     w.writeU8(static_cast<uint8_t>(MessageType::Telemetry));
@@ -1220,13 +1779,15 @@ std::vector<uint8_t> TelemetryMessage::serialize() const {
     }
     writeNamedValueSnapshot(w, namedVariableSnapshot);
     writeDeploymentMetadataExtension(w, deployment);
+    w.writeU32(scriptValuesSynced);
     
-    auto result = w.finish();
-    uint16_t length = static_cast<uint16_t>(result.size() - HEADER_SIZE);
-    result[lengthPos] = static_cast<uint8_t>(length >> 8);
-    result[lengthPos + 1] = static_cast<uint8_t>(length & 0xFF);
-    
-    return result;
+    w.patchU16(lengthPos, static_cast<uint16_t>(w.size() - start - HEADER_SIZE));
+}
+
+std::vector<uint8_t> TelemetryMessage::serialize() const {
+    ByteWriter w(serializedSize());
+    serializeInto(w);
+    return w.finish();
 }
 
 std::optional<TelemetryMessage> TelemetryMessage::deserialize(const uint8_t* data, size_t len) {
@@ -1275,13 +1836,21 @@ std::optional<TelemetryMessage> TelemetryMessage::deserialize(const uint8_t* dat
         auto deployment = readDeploymentMetadataExtension(r);
         if (!deployment) return std::nullopt;
         msg.deployment = std::move(*deployment);
+
+        // Absent from engines that predate the counter
+        if (r.hasMore()) {
+            auto scriptValuesSynced = r.readU32();
+            if (!scriptValuesSynced) return std::nullopt;
+            msg.scriptValuesSynced = *scriptValuesSynced;
+        }
     }
     
     return msg;
 }
 
-std::vector<uint8_t> TransitionFiredMessage::serialize() const {
-    ByteWriter w;
+void TransitionFiredMessage::serializeInto(ByteWriter& w) const {
+    w.reserve(serializedSize());
+    const size_t start = w.size();
     w.writeU16(header.magic);
     w.writeU8(header.version);
     w.writeU8(static_cast<uint8_t>(MessageType::TransitionFired));
@@ -1296,11 +1865,13 @@ std::vector<uint8_t> TransitionFiredMessage::serialize() const {
     w.writeU16(transitionId);
     w.writeU64(timestamp);
 
-    auto result = w.finish();
-    uint16_t length = static_cast<uint16_t>(result.size() - HEADER_SIZE);
-    result[lengthPos] = static_cast<uint8_t>(length >> 8);
-    result[lengthPos + 1] = static_cast<uint8_t>(length & 0xFF);
-    return result;
+    w.patchU16(lengthPos, static_cast<uint16_t>(w.size() - start - HEADER_SIZE));
+}
+
+std::vector<uint8_t> TransitionFiredMessage::serialize() const {
+    ByteWriter w(serializedSize());
+    serializeInto(w);
+    return w.finish();
 }
 
 std::optional<TransitionFiredMessage> TransitionFiredMessage::deserialize(const uint8_t* data, size_t len) {
@@ -1328,12 +1899,287 @@ std::optional<TransitionFiredMessage> TransitionFiredMessage::deserialize(const
     return msg;
 }
 
+// ============================================================================
+// TelemetryDelta Messages
+// ============================================================================
+
+void TelemetryDeltaMessage::serializeInto(ByteWriter& w) const {
+    w.reserve(serializedSize());
+    const size_t start = w.size();
+    w.writeU16(header.magic);
+    w.writeU8(header.version);
+    w.writeU8(static_cast<uint8_t>(MessageType::TelemetryDelta));
+
+    size_t lengthPos = w.size();
+    w.writeU16(0);
+
+    w.writeU32(messageId);
+    w.writeU32(sourceId);
+    w.writeU32(targetId);
+    w.writeU32(runId);
+    w.writeU32(sequence);
+    w.writeU32(baseSequence);
+    w.writeU8(keyframe ? 1 : 0);
+    w.writeU64(timestamp);
+
+    writeSymbols(w, names);
+    w.writeU16(static_cast<uint16_t>(values.size()));
+    for (const auto& update : values) {
+        w.writeU16(update.id);
+        writeValue(w, update.value);
+    }
+
+    w.patchU16(lengthPos, static_cast<uint16_t>(w.size() - start - HEADER_SIZE));
+}
+
+std::vector<uint8_t> TelemetryDeltaMessage::serialize() const {
+    ByteWriter w(serializedSize());
+    serializeInto(w);
+    return w.finish();
+}
+
+std::optional<TelemetryDeltaMessage> TelemetryDeltaMessage::deserialize(const uint8_t* data, size_t len) {
+    ByteReader r(data, len);
+    r.readU16(); r.readU8(); r.readU8(); r.readU16();
+
+    TelemetryDeltaMessage msg;
+    auto msgId = r.readU32();
+    auto srcId = r.readU32();
+    auto tgtId = r.readU32();
+    auto runId = r.readU32();
+    auto sequence = r.readU32();
+    auto baseSequence = r.readU32();
+    auto flags = r.readU8();
+    auto ts = r.readU64();
+
+    if (!msgId || !srcId || !tgtId || !runId || !sequence || !baseSequence || !flags || !ts) {
+        return std::nullopt;
+    }
+
+    msg.messageId = *msgId;
+    msg.sourceId = *srcId;
+    msg.targetId = *tgtId;
+    msg.runId = *runId;
+    msg.sequence = *sequence;
+    msg.baseSequence = *baseSequence;
+    msg.keyframe = (*flags & 0x01) != 0;
+    msg.timestamp = *ts;
+
+    auto names = readSymbols(r);
+    if (!names) {
+        return std::nullopt;
+    }
+    msg.names = std::move(*names);
+
+    auto valueCount = r.readU16();
+    if (!valueCount) {
+        return std::nullopt;
+    }
+    msg.values.reserve(*valueCount);
+    for (uint16_t i = 0; i < *valueCount; ++i) {
+        auto varId = r.readU16();
+        auto val = readValue(r);
+        if (!varId || !val) {
+            return std::nullopt;
+        }
+        msg.values.push_back(VariableUpdate{*varId, std::move(*val)});
+    }
+
+    return msg;
+}
+
+std::vector<uint8_t> TelemetryAckMessage::serialize() const {
+    ByteWriter w(serializedSize());
+    w.writeU16(header.magic);
+    w.writeU8(header.version);
+    w.writeU8(static_cast<uint8_t>(MessageType::TelemetryAck));
+
+    size_t lengthPos = w.size();
+    w.writeU16(0);
+
+    w.writeU32(messageId);
+    w.writeU32(sourceId);
+    w.writeU32(targetId);
+    w.writeU32(runId);
+    w.writeU32(sequence);
+    w.writeU8(requestKeyframe ? 1 : 0);
+
+    w.patchU16(lengthPos, static_cast<uint16_t>(w.size() - HEADER_SIZE));
+    return w.finish();
+}
+
+std::optional<TelemetryAckMessage> TelemetryAckMessage::deserialize(const uint8_t* data, size_t len) {
+    ByteReader r(data, len);
+    r.readU16(); r.readU8(); r.readU8(); r.readU16();
+
+    TelemetryAckMessage msg;
+    auto msgId = r.readU32();
+    auto srcId = r.readU32();
+    auto tgtId = r.readU32();
+    auto runId = r.readU32();
+    auto sequence = r.readU32();
+    auto flags = r.readU8();
+
+    if (!msgId || !srcId || !tgtId || !runId || !sequence || !flags) {
+        return std::nullopt;
+    }
+
+    msg.messageId = *msgId;
+    msg.sourceId = *srcId;
+    msg.targetId = *tgtId;
+    msg.runId = *runId;
+    msg.sequence = *sequence;
+    msg.requestKeyframe = (*flags & 0x01) != 0;
+    return msg;
+}
+
+// ============================================================================
+// Profile Message
+// ============================================================================
+
+std::vector<uint8_t> ProfileMessage::serialize() const {
+    ByteWriter w(serializedSize());
+    w.writeU16(header.magic);
+    w.writeU8(header.version);
+    w.writeU8(static_cast<uint8_t>(MessageType::Profile));
+
+    size_t lengthPos = w.size();
+    w.writeU16(0);
+
+    w.writeU32(messageId);
+    w.writeU32(sourceId);
+    w.writeU32(targetId);
+    w.writeU32(runId);
+    w.writeU8(static_cast<uint8_t>((reset ? 0x01 : 0) | ((order & 0x03) << 1)));
+    w.writeU64(timestamp);
+
+    w.writeU8(static_cast<uint8_t>(phases.size()));
+    for (const auto& phase : phases) {
+        w.writeU8(phase.phase);
+        w.writeU64(phase.totalNs);
+        w.writeU64(phase.calls);
+    }
+    w.writeU8(static_cast<uint8_t>(histograms.size()));
+    for (const auto& histogram : histograms) {
+        w.writeU8(histogram.kind);
+        w.writeU64(histogram.count);
+        w.writeU64(histogram.sumNs);
+        w.writeU64(histogram.minNs);
+        w.writeU64(histogram.maxNs);
+        w.writeU16(static_cast<uint16_t>(histogram.buckets.size()));
+        for (const auto& bucket : histogram.buckets) {
+            w.writeU16(bucket.index);
+            w.writeU32(bucket.count);
+        }
+    }
+    w.writeU16(static_cast<uint16_t>(codeBlocks.size()));
+    for (const auto& block : codeBlocks) {
+        w.writeU8(block.site);
+        w.writeU16(block.ownerId);
+        w.writeU64(block.totalNs);
+        w.writeU64(block.calls);
+        w.writeU64(block.allocatedBytes);
+    }
+
+    w.patchU16(lengthPos, static_cast<uint16_t>(w.size() - HEADER_SIZE));
+    return w.finish();
+}
+
+std::optional<ProfileMessage> ProfileMessage::deserialize(const uint8_t* data, size_t len) {
+    ByteReader r(data, len);
+    r.readU16(); r.readU8(); r.readU8(); r.readU16();
+
+    ProfileMessage msg;
+    auto msgId = r.readU32();
+    auto srcId = r.readU32();
+    auto tgtId = r.readU32();
+    auto runId = r.readU32();
+    auto flags = r.readU8();
+    auto ts = r.readU64();
+    auto phaseCount = r.readU8();
+
+    if (!msgId || !srcId || !tgtId || !runId || !flags || !ts || !phaseCount) {
+        return std::nullopt;
+    }
+
+    msg.messageId = *msgId;
+    msg.sourceId = *srcId;
+    msg.targetId = *tgtId;
+    msg.runId = *runId;
+    msg.reset = (*flags & 0x01) != 0;
+    msg.order = static_cast<uint8_t>((*flags >> 1) & 0x03);
+    msg.timestamp = *ts;
+
+    msg.phases.reserve(*phaseCount);
+    for (uint8_t i = 0; i < *phaseCount; ++i) {
+        auto phase = r.readU8();
+        auto totalNs = r.readU64();
+        auto calls = r.readU64();
+        if (!phase || !totalNs || !calls) {
+            return std::nullopt;
+        }
+        msg.phases.push_back(ProfilePhaseEntry{*phase, *totalNs, *calls});
+    }
+
+    auto histogramCount = r.readU8();
+    if (!histogramCount) {
+        return std::nullopt;
+    }
+    msg.histograms.reserve(*histogramCount);
+    for (uint8_t i = 0; i < *histogramCount; ++i) {
+        ProfileHistogramEntry histogram;
+        auto kind = r.readU8();
+        auto count = r.readU64();
+        auto sum = r.readU64();
+        auto min = r.readU64();
+        auto max = r.readU64();
+        auto bucketCount = r.readU16();
+        if (!kind || !count || !sum || !min || !max || !bucketCount) {
+            return std::nullopt;
+        }
+        histogram.kind = *kind;
+        histogram.count = *count;
+        histogram.sumNs = *sum;
+        histogram.minNs = *min;
+        histogram.maxNs = *max;
+        histogram.buckets.reserve(*bucketCount);
+        for (uint16_t b = 0; b < *bucketCount; ++b) {
+            auto index = r.readU16();
+            auto bucket = r.readU32();
+            if (!index || !bucket) {
+                return std::nullopt;
+            }
+            histogram.buckets.push_back(ProfileBucket{*index, *bucket});
+        }
+        msg.histograms.push_back(std::move(histogram));
+    }
+
+    auto blockCount = r.readU16();
+    if (!blockCount) {
+        return std::nullopt;
+    }
+    msg.codeBlocks.reserve(*blockCount);
+    for (uint16_t i = 0; i < *blockCount; ++i) {
+        auto site = r.readU8();
+        auto ownerId = r.readU16();
+        auto totalNs = r.readU64();
+        auto calls = r.readU64();
+        auto bytes = r.readU64();
+        if (!site || !ownerId || !totalNs || !calls || !bytes) {
+            return std::nullopt;
+        }
+        msg.codeBlocks.push_back(ProfileCodeBlockEntry{*site, *ownerId, *totalNs, *calls, *bytes});
+    }
+
+    return msg;
+}
+
 // ============================================================================
 // Error Message
 // ============================================================================
 
 std::vector<uint8_t> ErrorMessage::serialize() const {
-    ByteWriter w;
+    ByteWriter w(serializedSize());
     w.writeU16(header.magic);
     w.writeU8(header.version);
     w.writeU8(static_cast<uint8_t>(MessageType::Error));
@@ -1402,7 +2248,7 @@ std::optional<ErrorMessage> ErrorMessage::deserialize(const uint8_t* data, size_
 // ============================================================================
 
 std::vector<uint8_t> DebugMessage::serialize() const {
-    ByteWriter w;
+    ByteWriter w(serializedSize());
     w.writeU16(header.magic);
     w.writeU8(header.version);
     w.writeU8(static_cast<uint8_t>(MessageType::Debug));
@@ -1454,8 +2300,9 @@ std::optional<DebugMessage> DebugMessage::deserialize(const uint8_t* data, size_
     return msg;
 }
 
-std::vector<uint8_t> AckMessage::serialize() const {
-    ByteWriter w;
+void AckMessage::serializeInto(ByteWriter& w) const {
+    w.reserve(serializedSize());
+    const size_t start = w.size();
     w.writeU16(header.magic);
     w.writeU8(header.version);
     w.writeU8(static_cast<uint8_t>(MessageType::Ack));
@@ -1469,11 +2316,13 @@ std::vector<uint8_t> AckMessage::serialize() const {
     w.writeU32(relatedMessageId);
     w.writeString(info);
 
-    auto result = w.finish();
-    uint16_t length = static_cast<uint16_t>(result.size() - HEADER_SIZE);
-    result[lengthPos] = static_cast<uint8_t>(length >> 8);
-    result[lengthPos + 1] = static_cast<uint8_t>(length & 0xFF);
-    return result;
+    w.patchU16(lengthPos, static_cast<uint16_t>(w.size() - start - HEADER_SIZE));
+}
+
+std::vector<uint8_t> AckMessage::serialize() const {
+    ByteWriter w(serializedSize());
+    serializeInto(w);
+    return w.finish();
 }
 
 std::optional<AckMessage> AckMessage::deserialize(const uint8_t* data, size_t len) {
@@ -1497,7 +2346,7 @@ std::optional<AckMessage> AckMessage::deserialize(const uint8_t* data, size_t le
 }
 
 std::vector<uint8_t> NakMessage::serialize() const {
-    ByteWriter w;
+    ByteWriter w(serializedSize());
     w.writeU16(header.magic);
     w.writeU8(header.version);
     w.writeU8(static_cast<uint8_t>(MessageType::Nak));
@@ -1542,7 +2391,7 @@ std::optional<NakMessage> NakMessage::deserialize(const uint8_t* data, size_t le
 }
 
 std::vector<uint8_t> RawMessage::serialize() const {
-    ByteWriter w;
+    ByteWriter w(serializedSize());
     w.writeU16(header.magic);
     w.writeU8(header.version);
     w.writeU8(static_cast<uint8_t>(rawType));
@@ -1553,9 +2402,7 @@ std::vector<uint8_t> RawMessage::serialize() const {
     w.writeU32(messageId);
     w.writeU32(sourceId);
     w.writeU32(targetId);
-    for (auto b : payload) {
-        w.writeU8(b);
-    }
+    w.writeRaw(payload.data(), payload.size());
 
     auto result = w.finish();
     uint16_t length = static_cast<uint16_t>(result.size() - HEADER_SIZE);
@@ -1582,11 +2429,7 @@ std::optional<RawMessage> RawMessage::deserialize(MessageType type, const uint8_
     msg.sourceId = *srcId;
     msg.targetId = *tgtId;
 
-    while (r.hasMore()) {
-        auto b = r.readU8();
-        if (!b) break;
-        msg.payload.push_back(*b);
-    }
+    msg.payload = r.readRemaining().toVector();
     return msg;
 }
 
@@ -1672,11 +2515,51 @@ std::unique_ptr<Message> MessageFactory::deserialize(const uint8_t* data, size_t
             if (msg) return std::make_unique<RestoreStateMessage>(std::move(*msg));
             break;
         }
+        case MessageType::SymbolTable: {
+            auto msg = SymbolTableMessage::deserialize(data, len);
+            if (msg) return std::make_unique<SymbolTableMessage>(std::move(*msg));
+            break;
+        }
+        case MessageType::PeerWiring: {
+            auto msg = PeerWiringMessage::deserialize(data, len);
+            if (msg) return std::make_unique<PeerWiringMessage>(std::move(*msg));
+            break;
+        }
         case MessageType::Input: {
             auto msg = InputMessage::deserialize(data, len);
             if (msg) return std::make_unique<InputMessage>(std::move(*msg));
             break;
         }
+        case MessageType::InputBatch: {
+            auto msg = InputBatchMessage::deserialize(data, len);
+            if (msg) return std::make_unique<InputBatchMessage>(std::move(*msg));
+            break;
+        }
+        case MessageType::TelemetryDelta: {
+            auto msg = TelemetryDeltaMessage::deserialize(data, len);
+            if (msg) return std::make_unique<TelemetryDeltaMessage>(std::move(*msg));
+            break;
+        }
+        case MessageType::TelemetryAck: {
+            auto msg = TelemetryAckMessage::deserialize(data, len);
+            if (msg) return std::make_unique<TelemetryAckMessage>(std::move(*msg));
+            break;
+        }
+        case MessageType::Profile: {
+            auto msg = ProfileMessage::deserialize(data, len);
+            if (msg) return std::make_unique<ProfileMessage>(std::move(*msg));
+            break;
+        }
+        case MessageType::OutputBatch: {
+            auto msg = OutputBatchMessage::deserialize(data, len);
+            if (msg) return std::make_unique<OutputBatchMessage>(std::move(*msg));
+            break;
+        }
+        case MessageType::OutputAggregate: {
+            auto msg = OutputAggregateMessage::deserialize(data, len);
+            if (msg) return std::make_unique<OutputAggregateMessage>(std::move(*msg));
+            break;
+        }
         case MessageType::Output: {
             auto msg = OutputMessage::deserialize(data, len);
             if (msg) return std::make_unique<OutputMessage>(std::move(*msg));
@@ -9,12 +9,16 @@
 #define AETHERIUM_PROTOCOL_HPP
 
 #include "types.hpp"
+#include "byte_order.hpp"
+#include "message_pool.hpp"
 #include <cstdint>
+#include <cstring>
 #include <vector>
 #include <string>
 #include <optional>
 #include <memory>
 #include <array>
+#include <string_view>
 
 namespace aeth {
 namespace protocol {
@@ -26,6 +30,7 @@ namespace protocol {
 constexpr uint16_t MAGIC = 0xAE01;  // Aetherium v1
 constexpr uint8_t VERSION = 0x01;
 constexpr size_t HEADER_SIZE = 6;   // Magic(2) + Version(1) + Type(1) + Length(2)
+constexpr size_t FRAME_PREFIX_SIZE = HEADER_SIZE + 12;  // + MessageId, SourceId, TargetId
 constexpr size_t MAX_MESSAGE_SIZE = 65535;
 
 // ============================================================================
@@ -52,6 +57,8 @@ enum class MessageType : uint8_t {
     Pause = 0x46,
     Resume = 0x47,
     RestoreState = 0x48,
+    SymbolTable = 0x49,
+    PeerWiring = 0x4A,
 
     // Data Plane (0x80-0xBF)
     Input = 0x80,
@@ -60,6 +67,12 @@ enum class MessageType : uint8_t {
     StateChange = 0x83,
     Telemetry = 0x84,
     TransitionFired = 0x85,
+    InputBatch = 0x86,
+    TelemetryDelta = 0x87,
+    TelemetryAck = 0x88,
+    Profile = 0x89,
+    OutputBatch = 0x8A,
+    OutputAggregate = 0x8B,
 
     // Extended (0xC0-0xFF)
     Vendor = 0xC0,
@@ -100,6 +113,7 @@ struct DeviceCapabilities {
     bool hasRTC() const { return raw & (1 << 5); }
     bool supportsNested() const { return raw & (1 << 6); }
     bool supportsBytecode() const { return raw & (1 << 7); }
+    bool supportsCompactValues() const { return raw & (1 << 8); }
 
     void setLua(bool v) { setBit(0, v); }
     void setTimed(bool v) { setBit(1, v); }
@@ -109,6 +123,7 @@ struct DeviceCapabilities {
     void setRTC(bool v) { setBit(5, v); }
     void setNested(bool v) { setBit(6, v); }
     void setBytecode(bool v) { setBit(7, v); }
+    void setCompactValues(bool v) { setBit(8, v); }
 
 private:
     void setBit(int bit, bool v) {
@@ -145,6 +160,8 @@ struct MessageHeader {
 // Base Message
 // ============================================================================
 
+class ByteWriter;
+
 struct Message {
     MessageHeader header;
     uint32_t messageId = 0;       // For correlation
@@ -157,6 +174,13 @@ struct Message {
     
     // Serialization (to be implemented)
     virtual std::vector<uint8_t> serialize() const = 0;
+
+    // Append the encoded frame to a caller-owned writer (reusable buffer).
+    // Hot message types override this; the default copies serialize().
+    virtual void serializeInto(ByteWriter& out) const;
+
+    // Encoded frame size in bytes, used to reserve the writer up front
+    virtual size_t serializedSize() const { return FRAME_PREFIX_SIZE; }
 };
 
 struct NamedValueSnapshotEntry {
@@ -164,6 +188,25 @@ struct NamedValueSnapshotEntry {
     Value value;
 };
 
+// Id-to-name binding; ids are VariableId or StateId depending on the table
+struct SymbolEntry {
+    uint16_t id = 0;
+    std::string name;
+};
+
+/**
+ * One edge of a deploy-time wiring table: the source device's output port
+ * drives the target device's input port over `endpoint` (shm://<name>
+ * on the same host, a socket URL otherwise).
+ */
+struct PeerWire {
+    DeviceId sourceDevice = 0;
+    std::string sourcePort;
+    DeviceId targetDevice = 0;
+    std::string targetPort;
+    std::string endpoint;
+};
+
 struct DeploymentMetadataExtension {
     std::string placement;
     std::string transport;
@@ -223,6 +266,7 @@ struct HelloMessage : Message {
 
     MessageType type() const override { return MessageType::Hello; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
     static std::optional<HelloMessage> deserialize(const uint8_t* data, size_t len);
 };
 
@@ -234,6 +278,7 @@ struct HelloAckMessage : Message {
 
     MessageType type() const override { return MessageType::HelloAck; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
     static std::optional<HelloAckMessage> deserialize(const uint8_t* data, size_t len);
 };
 
@@ -243,6 +288,7 @@ struct PingMessage : Message {
 
     MessageType type() const override { return MessageType::Ping; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
     static std::optional<PingMessage> deserialize(const uint8_t* data, size_t len);
 };
 
@@ -253,6 +299,7 @@ struct PongMessage : Message {
 
     MessageType type() const override { return MessageType::Pong; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
     static std::optional<PongMessage> deserialize(const uint8_t* data, size_t len);
 };
 
@@ -268,6 +315,8 @@ struct LoadAutomataMessage : Message {
     bool isChunked = false;
     uint16_t chunkIndex = 0;
     uint16_t totalChunks = 1;
+    // CRC-32 of `data` (chunked-flag bit 1 on the wire, u32 after the data)
+    std::optional<uint32_t> chunkCrc;
     
     // Flags
     bool startAfterLoad = false;
@@ -278,6 +327,7 @@ struct LoadAutomataMessage : Message {
 
     MessageType type() const override { return MessageType::LoadAutomata; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
     static std::optional<LoadAutomataMessage> deserialize(const uint8_t* data, size_t len);
 };
 
@@ -291,6 +341,7 @@ struct LoadAckMessage : Message {
 
     MessageType type() const override { return MessageType::LoadAck; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
     static std::optional<LoadAckMessage> deserialize(const uint8_t* data, size_t len);
 };
 
@@ -300,6 +351,7 @@ struct StartMessage : Message {
 
     MessageType type() const override { return MessageType::Start; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
     static std::optional<StartMessage> deserialize(const uint8_t* data, size_t len);
 };
 
@@ -309,6 +361,7 @@ struct StopMessage : Message {
 
     MessageType type() const override { return MessageType::Stop; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
     static std::optional<StopMessage> deserialize(const uint8_t* data, size_t len);
 };
 
@@ -317,6 +370,7 @@ struct ResetMessage : Message {
 
     MessageType type() const override { return MessageType::Reset; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
     static std::optional<ResetMessage> deserialize(const uint8_t* data, size_t len);
 };
 
@@ -333,6 +387,7 @@ struct StatusMessage : Message {
 
     MessageType type() const override { return MessageType::Status; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
     static std::optional<StatusMessage> deserialize(const uint8_t* data, size_t len);
 };
 
@@ -341,6 +396,7 @@ struct PauseMessage : Message {
 
     MessageType type() const override { return MessageType::Pause; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
     static std::optional<PauseMessage> deserialize(const uint8_t* data, size_t len);
 };
 
@@ -349,6 +405,7 @@ struct ResumeMessage : Message {
 
     MessageType type() const override { return MessageType::Resume; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
     static std::optional<ResumeMessage> deserialize(const uint8_t* data, size_t len);
 };
 
@@ -359,9 +416,43 @@ struct RestoreStateMessage : Message {
 
     MessageType type() const override { return MessageType::RestoreState; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
     static std::optional<RestoreStateMessage> deserialize(const uint8_t* data, size_t len);
 };
 
+/**
+ * Names for the ids of a loaded run. Sent by the device after a load when
+ * it runs with id-only data-plane messages, and in reply to an empty
+ * SymbolTable request (e.g. after the controller reconnects). Names are
+ * then resolved by the receiver for logs and UI only.
+ */
+struct SymbolTableMessage : Message {
+    RunId runId = 0;
+    std::vector<SymbolEntry> variables;
+    std::vector<SymbolEntry> states;
+
+    MessageType type() const override { return MessageType::SymbolTable; }
+    std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
+    static std::optional<SymbolTableMessage> deserialize(const uint8_t* data, size_t len);
+};
+
+/**
+ * The whole wiring table for a deployment; each engine keeps the edges it
+ * is an end of. Replaces any earlier table. The server still gets every
+ * sampleEvery-th change of a wired output (0 = none).
+ */
+struct PeerWiringMessage : Message {
+    RunId runId = 0;
+    uint16_t sampleEvery = 0;
+    std::vector<PeerWire> wires;
+
+    MessageType type() const override { return MessageType::PeerWiring; }
+    std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
+    static std::optional<PeerWiringMessage> deserialize(const uint8_t* data, size_t len);
+};
+
 // ============================================================================
 // Data Plane Messages
 // ============================================================================
@@ -374,10 +465,25 @@ struct InputMessage : Message {
 
     MessageType type() const override { return MessageType::Input; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
     static std::optional<InputMessage> deserialize(const uint8_t* data, size_t len);
 };
 
-struct OutputMessage : Message {
+/**
+ * Many inputs for one logical sample. Applied together before the next
+ * tick; a repeated id keeps its last value.
+ */
+struct InputBatchMessage : Message {
+    RunId runId = 0;
+    std::vector<VariableUpdate> inputs;
+
+    MessageType type() const override { return MessageType::InputBatch; }
+    std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
+    static std::optional<InputBatchMessage> deserialize(const uint8_t* data, size_t len);
+};
+
+struct OutputMessage : Message, PooledMessage<OutputMessage> {
     RunId runId = 0;
     VariableId variableId = INVALID_VARIABLE;
     std::string variableName;
@@ -386,9 +492,49 @@ struct OutputMessage : Message {
 
     MessageType type() const override { return MessageType::Output; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
+    void serializeInto(ByteWriter& out) const override;
     static std::optional<OutputMessage> deserialize(const uint8_t* data, size_t len);
 };
 
+/**
+ * Every output a tick changed, coalesced into one frame. Entries are
+ * id-only; controllers map them with the device's SymbolTable.
+ */
+struct OutputBatchMessage : Message {
+    RunId runId = 0;
+    Timestamp timestamp = 0;
+    std::vector<VariableUpdate> outputs;
+
+    MessageType type() const override { return MessageType::OutputBatch; }
+    std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
+    static std::optional<OutputBatchMessage> deserialize(const uint8_t* data, size_t len);
+};
+
+/**
+ * One closed telemetry window of an output: the changes in
+ * [windowStart, windowEnd) summarized. min/max/mean are Float64, or Void
+ * for non-numeric outputs; last keeps the output's type.
+ */
+struct OutputAggregateMessage : Message {
+    RunId runId = 0;
+    VariableId variableId = INVALID_VARIABLE;
+    std::string variableName;
+    Timestamp windowStart = 0;
+    Timestamp windowEnd = 0;
+    uint32_t count = 0;
+    Value min;
+    Value max;
+    Value mean;
+    Value last;
+
+    MessageType type() const override { return MessageType::OutputAggregate; }
+    std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
+    static std::optional<OutputAggregateMessage> deserialize(const uint8_t* data, size_t len);
+};
+
 struct VariableMessage : Message {
     RunId runId = 0;
     VariableId variableId = INVALID_VARIABLE;
@@ -398,10 +544,11 @@ struct VariableMessage : Message {
 
     MessageType type() const override { return MessageType::Variable; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
     static std::optional<VariableMessage> deserialize(const uint8_t* data, size_t len);
 };
 
-struct StateChangeMessage : Message {
+struct StateChangeMessage : Message, PooledMessage<StateChangeMessage> {
     RunId runId = 0;
     StateId previousState = INVALID_STATE;
     StateId newState = INVALID_STATE;
@@ -410,10 +557,12 @@ struct StateChangeMessage : Message {
 
     MessageType type() const override { return MessageType::StateChange; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
+    void serializeInto(ByteWriter& out) const override;
     static std::optional<StateChangeMessage> deserialize(const uint8_t* data, size_t len);
 };
 
-struct TelemetryMessage : Message {
+struct TelemetryMessage : Message, PooledMessage<TelemetryMessage> {
     RunId runId = 0;
     Timestamp timestamp = 0;
     
@@ -422,6 +571,9 @@ struct TelemetryMessage : Message {
     uint32_t heapTotal = 0;
     float cpuUsage = 0;
     uint32_t tickRate = 0;  // ticks per second
+    // Variable values synced with the script engine last tick; trails the
+    // deployment extension, so older decoders ignore it
+    uint32_t scriptValuesSynced = 0;
     
     // Optional variable snapshot
     std::vector<std::pair<VariableId, Value>> variableSnapshot;
@@ -430,19 +582,113 @@ struct TelemetryMessage : Message {
 
     MessageType type() const override { return MessageType::Telemetry; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
+    void serializeInto(ByteWriter& out) const override;
     static std::optional<TelemetryMessage> deserialize(const uint8_t* data, size_t len);
 };
 
-struct TransitionFiredMessage : Message {
+struct TransitionFiredMessage : Message, PooledMessage<TransitionFiredMessage> {
     RunId runId = 0;
     TransitionId transitionId = INVALID_TRANSITION;
     Timestamp timestamp = 0;
 
     MessageType type() const override { return MessageType::TransitionFired; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
+    void serializeInto(ByteWriter& out) const override;
     static std::optional<TransitionFiredMessage> deserialize(const uint8_t* data, size_t len);
 };
 
+/**
+ * Compact telemetry. A keyframe carries the id -> name table and every
+ * value; later frames carry only the variables changed since the frame
+ * the controller last acknowledged (baseSequence), so a lost delta is
+ * covered by the next one.
+ */
+struct TelemetryDeltaMessage : Message, PooledMessage<TelemetryDeltaMessage> {
+    RunId runId = 0;
+    uint32_t sequence = 0;
+    uint32_t baseSequence = 0;  // 0 on keyframes
+    bool keyframe = false;
+    Timestamp timestamp = 0;
+    std::vector<SymbolEntry> names;  // Keyframes only
+    std::vector<VariableUpdate> values;
+
+    MessageType type() const override { return MessageType::TelemetryDelta; }
+    std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
+    void serializeInto(ByteWriter& out) const override;
+    static std::optional<TelemetryDeltaMessage> deserialize(const uint8_t* data, size_t len);
+};
+
+/**
+ * Controller -> device: acknowledge a TelemetryDelta frame, or ask for a
+ * fresh keyframe (e.g. after reconnecting).
+ */
+struct TelemetryAckMessage : Message {
+    RunId runId = 0;
+    uint32_t sequence = 0;
+    bool requestKeyframe = false;
+
+    MessageType type() const override { return MessageType::TelemetryAck; }
+    std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
+    static std::optional<TelemetryAckMessage> deserialize(const uint8_t* data, size_t len);
+};
+
+struct ProfilePhaseEntry {
+    uint8_t phase = 0;  // TickPhase
+    uint64_t totalNs = 0;
+    uint64_t calls = 0;
+};
+
+struct ProfileBucket {
+    uint16_t index = 0;  // LatencyHistogram bucket
+    uint32_t count = 0;
+};
+
+struct ProfileHistogramEntry {
+    uint8_t kind = 0;  // ProfileHistogramKind
+    uint64_t count = 0;
+    uint64_t sumNs = 0;
+    uint64_t minNs = 0;
+    uint64_t maxNs = 0;
+    std::vector<ProfileBucket> buckets;  // Non-empty buckets only
+};
+
+struct ProfileCodeBlockEntry {
+    uint8_t site = 0;      // CodeSite
+    uint16_t ownerId = 0;  // StateId or TransitionId, by site
+    uint64_t totalNs = 0;
+    uint64_t calls = 0;
+    uint64_t allocatedBytes = 0;
+};
+
+// Code block entries one Profile frame carries at most
+constexpr size_t PROFILE_MAX_CODE_BLOCKS = 1024;
+
+/**
+ * Tick profile: per-phase time, latency histograms and per-code-block
+ * script cost. The device sends one in reply to a Profile request (the
+ * controller's carries no entries); `reset` on the request clears the
+ * counters once the reply is built, and `order` (a CodeCostOrder) picks
+ * how the reply's code blocks are ranked.
+ */
+struct ProfileMessage : Message {
+    RunId runId = 0;
+    bool reset = false;
+    uint8_t order = 0;
+    Timestamp timestamp = 0;
+    std::vector<ProfilePhaseEntry> phases;
+    std::vector<ProfileHistogramEntry> histograms;
+    std::vector<ProfileCodeBlockEntry> codeBlocks;  // Most expensive first
+
+    MessageType type() const override { return MessageType::Profile; }
+    std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
+    static std::optional<ProfileMessage> deserialize(const uint8_t* data, size_t len);
+};
+
 // ============================================================================
 // Error and Debug Messages
 // ============================================================================
@@ -472,6 +718,7 @@ struct ErrorMessage : Message {
 
     MessageType type() const override { return MessageType::Error; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
     static std::optional<ErrorMessage> deserialize(const uint8_t* data, size_t len);
 };
 
@@ -491,15 +738,18 @@ struct DebugMessage : Message {
 
     MessageType type() const override { return MessageType::Debug; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
     static std::optional<DebugMessage> deserialize(const uint8_t* data, size_t len);
 };
 
-struct AckMessage : Message {
+struct AckMessage : Message, PooledMessage<AckMessage> {
     uint32_t relatedMessageId = 0;
     std::string info;
 
     MessageType type() const override { return MessageType::Ack; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
+    void serializeInto(ByteWriter& out) const override;
     static std::optional<AckMessage> deserialize(const uint8_t* data, size_t len);
 };
 
@@ -510,6 +760,7 @@ struct NakMessage : Message {
 
     MessageType type() const override { return MessageType::Nak; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
     static std::optional<NakMessage> deserialize(const uint8_t* data, size_t len);
 };
 
@@ -519,6 +770,7 @@ struct RawMessage : Message {
 
     MessageType type() const override { return rawType; }
     std::vector<uint8_t> serialize() const override;
+    size_t serializedSize() const override;
     static std::optional<RawMessage> deserialize(MessageType type, const uint8_t* data, size_t len);
 };
 
@@ -538,43 +790,80 @@ public:
 // Serialization Helpers
 // ============================================================================
 
+/**
+ * Append-only big-endian encoder. The buffer is grown in bulk and written
+ * through a cursor, so each field is one bounds check plus a memcpy.
+ */
 class ByteWriter {
 public:
     ByteWriter() = default;
-    explicit ByteWriter(size_t reserve) { data_.reserve(reserve); }
+    explicit ByteWriter(size_t reserve) { data_.resize(reserve); }
 
-    void writeU8(uint8_t v) { data_.push_back(v); }
-    void writeU16(uint16_t v) {
-        data_.push_back(static_cast<uint8_t>(v >> 8));
-        data_.push_back(static_cast<uint8_t>(v & 0xFF));
-    }
-    void writeU32(uint32_t v) {
-        writeU16(static_cast<uint16_t>(v >> 16));
-        writeU16(static_cast<uint16_t>(v & 0xFFFF));
-    }
-    void writeU64(uint64_t v) {
-        writeU32(static_cast<uint32_t>(v >> 32));
-        writeU32(static_cast<uint32_t>(v & 0xFFFFFFFF));
+    // Make room for `extra` more bytes; grows geometrically so repeated
+    // appends into one writer stay amortized O(1).
+    void reserve(size_t extra) {
+        if (size_ + extra > data_.size()) {
+            growTo(size_ + extra);
+        }
     }
-    void writeString(const std::string& s) {
+
+    void writeU8(uint8_t v) { *claim(1) = v; }
+    void writeU16(uint16_t v) { byteorder::storeBig(claim(2), v); }
+    void writeU32(uint32_t v) { byteorder::storeBig(claim(4), v); }
+    void writeU64(uint64_t v) { byteorder::storeBig(claim(8), v); }
+    void writeString(std::string_view s) {
         writeU16(static_cast<uint16_t>(s.size()));
-        for (char c : s) {
-            data_.push_back(static_cast<uint8_t>(c));
-        }
+        writeRaw(reinterpret_cast<const uint8_t*>(s.data()), s.size());
     }
     void writeBytes(const uint8_t* data, size_t len) {
         writeU16(static_cast<uint16_t>(len));
-        data_.insert(data_.end(), data, data + len);
+        writeRaw(data, len);
     }
     void writeBytes(const std::vector<uint8_t>& v) {
         writeBytes(v.data(), v.size());
     }
+    // Append without a length prefix
+    void writeRaw(const uint8_t* data, size_t len) {
+        if (len > 0) {
+            std::memcpy(claim(len), data, len);
+        }
+    }
+
+    // Overwrite a big-endian u16 written earlier (e.g. a length field)
+    void patchU16(size_t pos, uint16_t v) {
+        byteorder::storeBig(data_.data() + pos, v);
+    }
 
-    [[nodiscard]] std::vector<uint8_t> finish() { return std::move(data_); }
-    [[nodiscard]] size_t size() const { return data_.size(); }
+    [[nodiscard]] std::vector<uint8_t> finish() {
+        data_.resize(size_);
+        size_ = 0;
+        return std::move(data_);
+    }
+    [[nodiscard]] size_t size() const { return size_; }
+    [[nodiscard]] const uint8_t* data() const { return data_.data(); }
+
+    // Drop the contents but keep the capacity for the next message
+    void clear() { size_ = 0; }
+    // Drop everything written after the first `size` bytes
+    void truncate(size_t size) { size_ = size < size_ ? size : size_; }
 
 private:
-    std::vector<uint8_t> data_;
+    uint8_t* claim(size_t n) {
+        if (size_ + n > data_.size()) {
+            growTo(size_ + n);
+        }
+        uint8_t* out = data_.data() + size_;
+        size_ += n;
+        return out;
+    }
+
+    void growTo(size_t needed) {
+        const size_t doubled = data_.size() * 2;
+        data_.resize(needed > doubled ? needed : doubled);
+    }
+
+    std::vector<uint8_t> data_;  // Sized to capacity; bytes past size_ are scratch
+    size_t size_ = 0;
 };
 
 class ByteReader {
@@ -589,49 +878,64 @@ public:
         return data_[pos_++];
     }
 
-    std::optional<uint16_t> readU16() {
-        if (pos_ + 2 > len_) return std::nullopt;
-        uint16_t v = (static_cast<uint16_t>(data_[pos_]) << 8) | data_[pos_ + 1];
-        pos_ += 2;
-        return v;
+    std::optional<uint16_t> readU16() { return readBig<uint16_t>(); }
+    std::optional<uint32_t> readU32() { return readBig<uint32_t>(); }
+    std::optional<uint64_t> readU64() { return readBig<uint64_t>(); }
+
+    std::optional<std::string> readString() {
+        auto view = readBytesView();
+        if (!view) return std::nullopt;
+        return std::string(reinterpret_cast<const char*>(view->data), view->size);
     }
 
-    std::optional<uint32_t> readU32() {
-        auto hi = readU16();
-        auto lo = readU16();
-        if (!hi || !lo) return std::nullopt;
-        return (static_cast<uint32_t>(*hi) << 16) | *lo;
+    std::optional<std::vector<uint8_t>> readBytes() {
+        auto view = readBytesView();
+        if (!view) return std::nullopt;
+        return view->toVector();
     }
 
-    std::optional<uint64_t> readU64() {
-        auto hi = readU32();
-        auto lo = readU32();
-        if (!hi || !lo) return std::nullopt;
-        return (static_cast<uint64_t>(*hi) << 32) | *lo;
+    // The next `len` bytes, without a length prefix
+    std::optional<ByteView> readRaw(size_t len) {
+        if (len > len_ - pos_) return std::nullopt;
+        ByteView view{data_ + pos_, len};
+        pos_ += len;
+        return view;
     }
 
-    std::optional<std::string> readString() {
-        auto len = readU16();
-        if (!len || pos_ + *len > len_) return std::nullopt;
-        std::string s(reinterpret_cast<const char*>(data_ + pos_), *len);
-        pos_ += *len;
-        return s;
+    // Everything not yet read
+    ByteView readRemaining() {
+        ByteView view{data_ + pos_, len_ - pos_};
+        pos_ = len_;
+        return view;
     }
 
-    std::optional<std::vector<uint8_t>> readBytes() {
+private:
+    // Length-prefixed field, borrowed from the buffer
+    std::optional<ByteView> readBytesView() {
         auto len = readU16();
-        if (!len || pos_ + *len > len_) return std::nullopt;
-        std::vector<uint8_t> v(data_ + pos_, data_ + pos_ + *len);
+        if (!len || *len > len_ - pos_) return std::nullopt;
+        ByteView view{data_ + pos_, *len};
         pos_ += *len;
+        return view;
+    }
+
+    template <typename T>
+    std::optional<T> readBig() {
+        if (len_ - pos_ < sizeof(T)) return std::nullopt;
+        const T v = byteorder::loadBig<T>(data_ + pos_);
+        pos_ += sizeof(T);
         return v;
     }
 
-private:
     const uint8_t* data_;
     size_t len_;
     size_t pos_;
 };
 
+// Type tag plus big-endian payload; shared by message bodies and runtime checkpoints
+void writeValue(ByteWriter& writer, const Value& val);
+std::optional<Value> readValue(ByteReader& reader);
+
 } // namespace protocol
 } // namespace aeth
 
@@ -1,89 +1,257 @@
 #include "protocol_v2.hpp"
 
+#include <cstdint>
 #include <cstring>
 
 namespace aeth::protocolv2 {
 
 namespace {
 
+// v2 differs from v1 only in the u32 length prefix on byte blobs
 class Writer {
 public:
-    void writeU8(uint8_t v) { data_.push_back(v); }
-    void writeU16(uint16_t v) {
-        data_.push_back(static_cast<uint8_t>(v >> 8));
-        data_.push_back(static_cast<uint8_t>(v & 0xFF));
-    }
-    void writeU32(uint32_t v) {
-        writeU16(static_cast<uint16_t>(v >> 16));
-        writeU16(static_cast<uint16_t>(v & 0xFFFF));
-    }
-    void writeU64(uint64_t v) {
-        writeU32(static_cast<uint32_t>(v >> 32));
-        writeU32(static_cast<uint32_t>(v & 0xFFFFFFFF));
-    }
-    void writeString(const std::string& s) {
-        writeU16(static_cast<uint16_t>(s.size()));
-        data_.insert(data_.end(), s.begin(), s.end());
+    explicit Writer(ValueEncoding encoding = ValueEncoding::Fixed) : encoding_(encoding) {}
+
+    void writeU8(uint8_t v) { out_.writeU8(v); }
+    void writeU16(uint16_t v) { out_.writeU16(v); }
+    void writeU32(uint32_t v) { out_.writeU32(v); }
+    void writeU64(uint64_t v) { out_.writeU64(v); }
+    void writeString(std::string_view s) { out_.writeString(s); }
+    void writeBytes(const uint8_t* data, size_t len) {
+        writeU32(static_cast<uint32_t>(len));
+        writeRaw(data, len);
     }
-    void writeBytes(const std::vector<uint8_t>& bytes) {
-        writeU32(static_cast<uint32_t>(bytes.size()));
-        data_.insert(data_.end(), bytes.begin(), bytes.end());
+    void writeBytes(const std::vector<uint8_t>& bytes) { writeBytes(bytes.data(), bytes.size()); }
+    void writeRaw(const uint8_t* data, size_t len) { out_.writeRaw(data, len); }
+    // LEB128: 7 bits per byte, high bit set on all but the last
+    void writeVarint(uint64_t v) {
+        while (v >= 0x80) {
+            out_.writeU8(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        out_.writeU8(static_cast<uint8_t>(v));
     }
-    [[nodiscard]] std::vector<uint8_t> finish() { return std::move(data_); }
+    void reserve(size_t bytes) { out_.reserve(bytes); }
+    [[nodiscard]] ValueEncoding encoding() const { return encoding_; }
+    [[nodiscard]] std::vector<uint8_t> finish() { return out_.finish(); }
 private:
-    std::vector<uint8_t> data_;
+    protocol::ByteWriter out_;
+    ValueEncoding encoding_;
 };
 
 class Reader {
 public:
-    Reader(const uint8_t* data, size_t len) : data_(data), len_(len) {}
+    Reader(const uint8_t* data, size_t len, ValueEncoding encoding = ValueEncoding::Fixed)
+        : data_(data), len_(len), encoding_(encoding) {}
 
     std::optional<uint8_t> readU8() {
         if (pos_ + 1 > len_) return std::nullopt;
         return data_[pos_++];
     }
-    std::optional<uint16_t> readU16() {
-        if (pos_ + 2 > len_) return std::nullopt;
-        uint16_t v = (static_cast<uint16_t>(data_[pos_]) << 8) | data_[pos_ + 1];
-        pos_ += 2;
-        return v;
-    }
-    std::optional<uint32_t> readU32() {
-        auto hi = readU16();
-        auto lo = readU16();
-        if (!hi || !lo) return std::nullopt;
-        return (static_cast<uint32_t>(*hi) << 16) | *lo;
-    }
-    std::optional<uint64_t> readU64() {
-        auto hi = readU32();
-        auto lo = readU32();
-        if (!hi || !lo) return std::nullopt;
-        return (static_cast<uint64_t>(*hi) << 32) | *lo;
-    }
+    std::optional<uint16_t> readU16() { return readBig<uint16_t>(); }
+    std::optional<uint32_t> readU32() { return readBig<uint32_t>(); }
+    std::optional<uint64_t> readU64() { return readBig<uint64_t>(); }
     std::optional<std::string> readString() {
         auto len = readU16();
-        if (!len || pos_ + *len > len_) return std::nullopt;
+        if (!len || *len > len_ - pos_) return std::nullopt;
         std::string s(reinterpret_cast<const char*>(data_ + pos_), *len);
         pos_ += *len;
         return s;
     }
     std::optional<std::vector<uint8_t>> readBytes() {
         auto len = readU32();
-        if (!len || pos_ + *len > len_) return std::nullopt;
+        if (!len || *len > len_ - pos_) return std::nullopt;
         std::vector<uint8_t> bytes(data_ + pos_, data_ + pos_ + *len);
         pos_ += *len;
         return bytes;
     }
+    bool readRaw(std::vector<uint8_t>& out, size_t len) {
+        if (len > len_ - pos_) return false;
+        out.assign(data_ + pos_, data_ + pos_ + len);
+        pos_ += len;
+        return true;
+    }
+    std::optional<uint64_t> readVarint() {
+        uint64_t v = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (pos_ >= len_) return std::nullopt;
+            const uint8_t byte = data_[pos_++];
+            v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return v;
+        }
+        return std::nullopt;  // more than 10 bytes
+    }
+    bool readRaw(const uint8_t*& out, size_t len) {
+        if (len > len_ - pos_) return false;
+        out = data_ + pos_;
+        pos_ += len;
+        return true;
+    }
     [[nodiscard]] size_t pos() const { return pos_; }
     [[nodiscard]] size_t remaining() const { return len_ - pos_; }
+    [[nodiscard]] ValueEncoding encoding() const { return encoding_; }
 
 private:
+    template <typename T>
+    std::optional<T> readBig() {
+        if (len_ - pos_ < sizeof(T)) return std::nullopt;
+        const T v = byteorder::loadBig<T>(data_ + pos_);
+        pos_ += sizeof(T);
+        return v;
+    }
+
     const uint8_t* data_ = nullptr;
     size_t len_ = 0;
     size_t pos_ = 0;
+    ValueEncoding encoding_;
+};
+
+// Compact value tags. Bools live in the tag; the type survives decoding
+// (an Int64 stays Int64 however small, a narrowed Float64 stays Float64).
+enum CompactTag : uint8_t {
+    kCompactVoid = 0x00,
+    kCompactFalse = 0x01,
+    kCompactTrue = 0x02,
+    kCompactInt32 = 0x03,      // zig-zag varint
+    kCompactInt64 = 0x04,      // zig-zag varint
+    kCompactFloat32 = 0x05,    // 4 bytes
+    kCompactFloat64As32 = 0x06, // 4 bytes, widened on decode
+    kCompactFloat64 = 0x07,    // 8 bytes
+    kCompactString = 0x08,     // varint length + bytes
+    kCompactBinary = 0x09      // varint length + bytes
 };
 
+uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+int64_t unzigzag(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+uint32_t floatBits(float f) {
+    uint32_t bits = 0;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+// Exact bit comparison, so -0.0 and NaN payloads are only narrowed when they survive
+bool narrowsLosslessly(double d) {
+    const double widened = static_cast<double>(static_cast<float>(d));
+    return std::memcmp(&widened, &d, sizeof(d)) == 0;
+}
+
+void writeCompactValue(Writer& writer, const Value& value) {
+    switch (value.type()) {
+        case ValueType::Bool:
+            writer.writeU8(value.get<bool>() ? kCompactTrue : kCompactFalse);
+            break;
+        case ValueType::Int32:
+            writer.writeU8(kCompactInt32);
+            writer.writeVarint(zigzag(value.get<int32_t>()));
+            break;
+        case ValueType::Int64:
+            writer.writeU8(kCompactInt64);
+            writer.writeVarint(zigzag(value.get<int64_t>()));
+            break;
+        case ValueType::Float32:
+            writer.writeU8(kCompactFloat32);
+            writer.writeU32(floatBits(value.get<float>()));
+            break;
+        case ValueType::Float64: {
+            const double d = value.get<double>();
+            if (narrowsLosslessly(d)) {
+                writer.writeU8(kCompactFloat64As32);
+                writer.writeU32(floatBits(static_cast<float>(d)));
+            } else {
+                uint64_t bits = 0;
+                std::memcpy(&bits, &d, sizeof(bits));
+                writer.writeU8(kCompactFloat64);
+                writer.writeU64(bits);
+            }
+            break;
+        }
+        case ValueType::String: {
+            const std::string_view str = value.str();
+            writer.writeU8(kCompactString);
+            writer.writeVarint(str.size());
+            writer.writeRaw(reinterpret_cast<const uint8_t*>(str.data()), str.size());
+            break;
+        }
+        case ValueType::Binary: {
+            const ByteView bytes = value.bytes();
+            writer.writeU8(kCompactBinary);
+            writer.writeVarint(bytes.size);
+            writer.writeRaw(bytes.data, bytes.size);
+            break;
+        }
+        default:
+            writer.writeU8(kCompactVoid);
+            break;
+    }
+}
+
+std::optional<Value> readCompactValue(Reader& reader) {
+    auto tag = reader.readU8();
+    if (!tag) return std::nullopt;
+
+    switch (*tag) {
+        case kCompactVoid:
+            return Value();
+        case kCompactFalse:
+            return Value(false);
+        case kCompactTrue:
+            return Value(true);
+        case kCompactInt32: {
+            auto n = reader.readVarint();
+            if (!n) return std::nullopt;
+            const int64_t v = unzigzag(*n);
+            if (v < INT32_MIN || v > INT32_MAX) return std::nullopt;
+            return Value(static_cast<int32_t>(v));
+        }
+        case kCompactInt64: {
+            auto n = reader.readVarint();
+            if (!n) return std::nullopt;
+            return Value(unzigzag(*n));
+        }
+        case kCompactFloat32:
+        case kCompactFloat64As32: {
+            auto bits = reader.readU32();
+            if (!bits) return std::nullopt;
+            float f = 0.0f;
+            std::memcpy(&f, &*bits, sizeof(f));
+            if (*tag == kCompactFloat64As32) return Value(static_cast<double>(f));
+            return Value(f);
+        }
+        case kCompactFloat64: {
+            auto bits = reader.readU64();
+            if (!bits) return std::nullopt;
+            double d = 0.0;
+            std::memcpy(&d, &*bits, sizeof(d));
+            return Value(d);
+        }
+        case kCompactString:
+        case kCompactBinary: {
+            auto len = reader.readVarint();
+            const uint8_t* bytes = nullptr;
+            if (!len || *len > reader.remaining() || !reader.readRaw(bytes, static_cast<size_t>(*len))) {
+                return std::nullopt;
+            }
+            if (*tag == kCompactString) {
+                return Value(std::string_view(reinterpret_cast<const char*>(bytes), static_cast<size_t>(*len)));
+            }
+            return Value(ByteView{bytes, static_cast<size_t>(*len)});
+        }
+        default:
+            return std::nullopt;
+    }
+}
+
 void writeValue(Writer& writer, const Value& value) {
+    if (writer.encoding() == ValueEncoding::Compact) {
+        writeCompactValue(writer, value);
+        return;
+    }
     writer.writeU8(static_cast<uint8_t>(value.type()));
     switch (value.type()) {
         case ValueType::Void:
@@ -112,10 +280,10 @@ void writeValue(Writer& writer, const Value& value) {
             break;
         }
         case ValueType::String:
-            writer.writeString(value.get<std::string>());
+            writer.writeString(value.str());
             break;
         case ValueType::Binary:
-            writer.writeBytes(value.get<std::vector<uint8_t>>());
+            writer.writeBytes(value.bytes().data, value.bytes().size);
             break;
         default:
             break;
@@ -123,6 +291,9 @@ void writeValue(Writer& writer, const Value& value) {
 }
 
 std::optional<Value> readValue(Reader& reader) {
+    if (reader.encoding() == ValueEncoding::Compact) {
+        return readCompactValue(reader);
+    }
     auto type = reader.readU8();
     if (!type) return std::nullopt;
 
@@ -176,14 +347,21 @@ std::optional<Value> readValue(Reader& reader) {
 } // namespace
 
 Result<std::vector<uint8_t>> ProtocolCodecV2::encode(const Frame& frame) {
-    auto payloadRes = encodePayload(frame.type, frame.payload);
+    auto payloadRes = encodePayload(frame.type, frame.payload, frame.valueEncoding);
     if (payloadRes.isError()) {
         return Result<std::vector<uint8_t>>::error(payloadRes.error());
     }
 
     const std::vector<uint8_t> payload = payloadRes.value();
 
+    // Fixed header (18) + runId (4) + outcome (1) + lengths (5)
+    size_t frameSize = 28 + payload.size();
+    for (const auto& ext : frame.extensions) {
+        frameSize += 4 + ext.data.size();
+    }
+
     Writer writer;
+    writer.reserve(frameSize);
     writer.writeU16(MAGIC);
     writer.writeU8(VERSION);
     writer.writeU8(static_cast<uint8_t>(frame.type));
@@ -192,6 +370,7 @@ Result<std::vector<uint8_t>> ProtocolCodecV2::encode(const Frame& frame) {
     if (frame.runId.has_value()) flags |= 0x01;
     if (frame.outcome != Outcome::None) flags |= 0x02;
     if (!frame.extensions.empty()) flags |= 0x04;
+    if (frame.valueEncoding == ValueEncoding::Compact) flags |= 0x08;
     writer.writeU8(flags);
     writer.writeU8(0); // reserved
 
@@ -209,16 +388,12 @@ Result<std::vector<uint8_t>> ProtocolCodecV2::encode(const Frame& frame) {
     writer.writeU32(static_cast<uint32_t>(payload.size()));
     writer.writeU8(static_cast<uint8_t>(frame.extensions.size()));
 
-    for (auto b : payload) {
-        writer.writeU8(b);
-    }
+    writer.writeRaw(payload.data(), payload.size());
 
     for (const auto& ext : frame.extensions) {
         writer.writeU16(ext.type);
         writer.writeU16(static_cast<uint16_t>(ext.data.size()));
-        for (auto b : ext.data) {
-            writer.writeU8(b);
-        }
+        writer.writeRaw(ext.data.data(), ext.data.size());
     }
 
     return Result<std::vector<uint8_t>>::ok(writer.finish());
@@ -255,6 +430,7 @@ Result<Frame> ProtocolCodecV2::decode(const uint8_t* data, size_t len) {
     frame.messageId = *msgId;
     frame.sourceId = *sourceId;
     frame.targetId = *targetId;
+    frame.valueEncoding = (*flags & 0x08) != 0 ? ValueEncoding::Compact : ValueEncoding::Fixed;
 
     if ((*flags & 0x01) != 0) {
         auto runId = reader.readU32();
@@ -278,19 +454,12 @@ Result<Frame> ProtocolCodecV2::decode(const uint8_t* data, size_t len) {
     }
 
     const uint8_t* payloadPtr = data + reader.pos();
-    auto payloadRes = decodePayload(frame.type, payloadPtr, *payloadLen);
+    auto payloadRes = decodePayload(frame.type, payloadPtr, *payloadLen, frame.valueEncoding);
     if (payloadRes.isError()) {
         return Result<Frame>::error(payloadRes.error());
     }
     frame.payload = payloadRes.value();
 
-    Reader payloadReader(payloadPtr, *payloadLen);
-    while (payloadReader.remaining() > 0) {
-        if (!payloadReader.readU8()) {
-            break;
-        }
-    }
-
     Reader extReader(payloadPtr + *payloadLen, reader.remaining() - *payloadLen);
     for (uint8_t i = 0; i < *extCount; ++i) {
         auto extType = extReader.readU16();
@@ -302,11 +471,8 @@ Result<Frame> ProtocolCodecV2::decode(const uint8_t* data, size_t len) {
             return Result<Frame>::error("protocol_v2: malformed extension payload");
         }
         std::vector<uint8_t> extData;
-        extData.reserve(*extLen);
-        for (uint16_t j = 0; j < *extLen; ++j) {
-            auto b = extReader.readU8();
-            if (!b) return Result<Frame>::error("protocol_v2: malformed extension byte");
-            extData.push_back(*b);
+        if (!extReader.readRaw(extData, *extLen)) {
+            return Result<Frame>::error("protocol_v2: malformed extension byte");
         }
         frame.extensions.push_back(Extension{*extType, std::move(extData)});
     }
@@ -315,8 +481,9 @@ Result<Frame> ProtocolCodecV2::decode(const uint8_t* data, size_t len) {
 }
 
 Result<std::vector<uint8_t>> ProtocolCodecV2::encodePayload(protocol::MessageType type,
-                                                            const Payload& payload) {
-    Writer w;
+                                                            const Payload& payload,
+                                                            ValueEncoding encoding) {
+    Writer w(encoding);
 
     switch (type) {
         case protocol::MessageType::Hello: {
@@ -445,6 +612,32 @@ Result<std::vector<uint8_t>> ProtocolCodecV2::encodePayload(protocol::MessageTyp
             }
             break;
         }
+        case protocol::MessageType::TelemetryDelta: {
+            if (auto* p = std::get_if<TelemetryDeltaPayload>(&payload)) {
+                w.writeU32(p->sequence);
+                w.writeU32(p->baseSequence);
+                w.writeU8(p->keyframe ? 1 : 0);
+                w.writeU64(p->timestamp);
+                w.writeU16(static_cast<uint16_t>(p->names.size()));
+                for (const auto& entry : p->names) {
+                    w.writeU16(entry.id);
+                    w.writeString(entry.name);
+                }
+                w.writeU16(static_cast<uint16_t>(p->values.size()));
+                for (const auto& update : p->values) {
+                    w.writeU16(update.id);
+                    writeValue(w, update.value);
+                }
+            }
+            break;
+        }
+        case protocol::MessageType::TelemetryAck: {
+            if (auto* p = std::get_if<TelemetryAckPayload>(&payload)) {
+                w.writeU32(p->sequence);
+                w.writeU8(p->requestKeyframe ? 1 : 0);
+            }
+            break;
+        }
         case protocol::MessageType::Provision: {
             if (auto* p = std::get_if<ProvisionPayload>(&payload)) {
                 w.writeBytes(p->data);
@@ -512,8 +705,9 @@ Result<std::vector<uint8_t>> ProtocolCodecV2::encodePayload(protocol::MessageTyp
 
 Result<Payload> ProtocolCodecV2::decodePayload(protocol::MessageType type,
                                                const uint8_t* data,
-                                               size_t len) {
-    Reader r(data, len);
+                                               size_t len,
+                                               ValueEncoding encoding) {
+    Reader r(data, len, encoding);
 
     switch (type) {
         case protocol::MessageType::Hello: {
@@ -714,6 +908,53 @@ Result<Payload> ProtocolCodecV2::decodePayload(protocol::MessageType type,
             }
             return Result<Payload>::ok(p);
         }
+        case protocol::MessageType::TelemetryDelta: {
+            TelemetryDeltaPayload p;
+            auto sequence = r.readU32();
+            auto baseSequence = r.readU32();
+            auto flags = r.readU8();
+            auto ts = r.readU64();
+            auto nameCount = r.readU16();
+            if (!sequence || !baseSequence || !flags || !ts || !nameCount) {
+                return Result<Payload>::error("protocol_v2: bad telemetry delta payload");
+            }
+            p.sequence = *sequence;
+            p.baseSequence = *baseSequence;
+            p.keyframe = (*flags & 0x01) != 0;
+            p.timestamp = *ts;
+            for (uint16_t i = 0; i < *nameCount; ++i) {
+                auto id = r.readU16();
+                auto name = r.readString();
+                if (!id || !name) {
+                    return Result<Payload>::error("protocol_v2: bad telemetry delta name entry");
+                }
+                p.names.push_back(protocol::SymbolEntry{*id, std::move(*name)});
+            }
+            auto valueCount = r.readU16();
+            if (!valueCount) {
+                return Result<Payload>::error("protocol_v2: bad telemetry delta payload");
+            }
+            for (uint16_t i = 0; i < *valueCount; ++i) {
+                auto id = r.readU16();
+                auto value = readValue(r);
+                if (!id || !value) {
+                    return Result<Payload>::error("protocol_v2: bad telemetry delta value entry");
+                }
+                p.values.push_back(VariableUpdate{*id, std::move(*value)});
+            }
+            return Result<Payload>::ok(p);
+        }
+        case protocol::MessageType::TelemetryAck: {
+            TelemetryAckPayload p;
+            auto sequence = r.readU32();
+            auto flags = r.readU8();
+            if (!sequence || !flags) {
+                return Result<Payload>::error("protocol_v2: bad telemetry ack payload");
+            }
+            p.sequence = *sequence;
+            p.requestKeyframe = (*flags & 0x01) != 0;
+            return Result<Payload>::ok(p);
+        }
         case protocol::MessageType::Provision: {
             ProvisionPayload p;
             auto bytes = r.readBytes();
@@ -25,9 +25,33 @@ enum class Outcome : uint8_t {
 
 enum class LoadReplaceMode : uint8_t {
     HardReset = 0,
-    CarryOverCompatible = 1
+    CarryOverCompatible = 1,
+    // Warm the new automata up in the background, swap at a tick boundary
+    HotSwap = 2
 };
 
+/**
+ * How Value fields inside a payload are encoded. Compact packs a type tag
+ * with zig-zag varints, folds bools into the tag and narrows float64 to
+ * float32 when that is lossless. A frame says which one it uses (header
+ * flag 0x08); peers only send Compact once both Hello capability sets
+ * advertise it (DeviceCapabilities::supportsCompactValues).
+ */
+enum class ValueEncoding : uint8_t {
+    Fixed = 0,
+    Compact = 1
+};
+
+inline ValueEncoding negotiateValueEncoding(uint16_t localCapabilities, uint16_t peerCapabilities) {
+    protocol::DeviceCapabilities local;
+    protocol::DeviceCapabilities peer;
+    local.raw = localCapabilities;
+    peer.raw = peerCapabilities;
+    return local.supportsCompactValues() && peer.supportsCompactValues()
+        ? ValueEncoding::Compact
+        : ValueEncoding::Fixed;
+}
+
 struct Extension {
     uint16_t type = 0;
     std::vector<uint8_t> data;
@@ -124,6 +148,21 @@ struct TelemetryPayload {
     std::vector<std::pair<VariableId, Value>> variableSnapshot;
 };
 
+// Keyframe: names + every value. Delta: values changed since baseSequence.
+struct TelemetryDeltaPayload {
+    uint32_t sequence = 0;
+    uint32_t baseSequence = 0;
+    bool keyframe = false;
+    Timestamp timestamp = 0;
+    std::vector<protocol::SymbolEntry> names;
+    std::vector<VariableUpdate> values;
+};
+
+struct TelemetryAckPayload {
+    uint32_t sequence = 0;
+    bool requestKeyframe = false;
+};
+
 struct ProvisionPayload {
     std::vector<uint8_t> data;
 };
@@ -177,6 +216,8 @@ using Payload = std::variant<
     StateChangePayload,
     TransitionFiredPayload,
     TelemetryPayload,
+    TelemetryDeltaPayload,
+    TelemetryAckPayload,
     ProvisionPayload,
     GoodbyePayload,
     VendorPayload,
@@ -193,6 +234,7 @@ struct Frame {
     DeviceId targetId = 0;
     std::optional<RunId> runId;
     Outcome outcome = Outcome::None;
+    ValueEncoding valueEncoding = ValueEncoding::Fixed;
     Payload payload = EmptyPayload{};
     std::vector<Extension> extensions;
 };
@@ -207,10 +249,12 @@ public:
 
 private:
     static Result<std::vector<uint8_t>> encodePayload(protocol::MessageType type,
-                                                      const Payload& payload);
+                                                      const Payload& payload,
+                                                      ValueEncoding encoding);
     static Result<Payload> decodePayload(protocol::MessageType type,
                                          const uint8_t* data,
-                                         size_t len);
+                                         size_t len,
+                                         ValueEncoding encoding);
 };
 
 } // namespace aeth::protocolv2
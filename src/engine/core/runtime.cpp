@@ -3,6 +3,8 @@
  */
 
 #include "runtime.hpp"
+#include "byte_order.hpp"
+#include "hardware_service.hpp"
 
 #ifdef abs
 #undef abs
@@ -14,13 +16,90 @@
 
 #include <chrono>
 #include <algorithm>
+#include <climits>
 
 #if !defined(ARDUINO) && !defined(AETHERIUM_PLATFORM_MCXN947)
+#include <sstream>
 #include <thread>
 #endif
 
 namespace aeth {
 
+namespace {
+
+// Charges one script call's time and VM allocations to its code block
+class CodeCostScope {
+public:
+    CodeCostScope(RuntimeProfile* profile, const IScriptEngine& script, CodeSite site, uint16_t ownerId)
+#if AETHERIUM_PROFILING
+        : profile_(profile), script_(script), site_(site), ownerId_(ownerId),
+          startBytes_(script.allocatedBytes()), start_(ProfileClock::now()) {}
+
+    ~CodeCostScope() {
+        if (profile_) {
+            const uint64_t ns = ProfileClock::now() - start_;
+            profile_->scripts.record(site_, ownerId_, ns, script_.allocatedBytes() - startBytes_);
+        }
+    }
+#else
+    {
+        (void)profile;
+        (void)script;
+        (void)site;
+        (void)ownerId;
+    }
+#endif
+
+    CodeCostScope(const CodeCostScope&) = delete;
+    CodeCostScope& operator=(const CodeCostScope&) = delete;
+
+#if AETHERIUM_PROFILING
+private:
+    RuntimeProfile* profile_;
+    const IScriptEngine& script_;
+    CodeSite site_;
+    uint16_t ownerId_;
+    uint64_t startBytes_;
+    uint64_t start_;
+#endif
+};
+
+// Wall time for idle budgets, independent of the runtime's (possibly manual) clock
+uint64_t monotonicUs() {
+#if defined(ARDUINO) || defined(AETHERIUM_PLATFORM_MCXN947)
+    return static_cast<uint64_t>(aeth::embedded::platform::millis()) * 1000;
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// Child runtimes read their parent's clock, so both run on one timeline
+class BorrowedClock : public IClock {
+public:
+    explicit BorrowedClock(IClock* inner) : inner_(inner) {}
+    Timestamp now() override { return inner_->now(); }
+    void sleep(uint32_t ms) override { inner_->sleep(ms); }
+
+private:
+    IClock* inner_;
+};
+
+} // namespace
+
+// A child runtime hosted under one state of its parent
+struct NestedChild {
+    struct Link {
+        VariableId parent = INVALID_VARIABLE;
+        VariableId child = INVALID_VARIABLE;
+    };
+
+    StateId parentState = INVALID_STATE;
+    std::unique_ptr<Runtime> runtime;
+    std::vector<Link> inputs;   // Parent variable -> child input
+    std::vector<Link> outputs;  // Child output -> parent variable
+};
+
 // ============================================================================
 // StdClock Implementation
 // ============================================================================
@@ -48,10 +127,12 @@ void StdClock::sleep(uint32_t ms) {
 // ============================================================================
 
 StdRandomSource::StdRandomSource() 
-    : gen_(std::random_device{}()), dist_(0.0, 1.0) {}
+    : StdRandomSource(std::random_device{}()) {}
 
 StdRandomSource::StdRandomSource(uint64_t seed) 
-    : gen_(seed), dist_(0.0, 1.0) {}
+    : dist_(0.0, 1.0) {
+    this->seed(seed);
+}
 
 double StdRandomSource::random() {
     return dist_(gen_);
@@ -64,283 +145,396 @@ uint32_t StdRandomSource::randomInt(uint32_t max) {
 }
 
 void StdRandomSource::seed(uint64_t seed) {
-    gen_.seed(seed);
+    gen_.engine.seed(seed);
+    gen_.seed = seed;
+    gen_.draws = 0;
+}
+
+std::vector<uint8_t> StdRandomSource::saveState() const {
+    std::vector<uint8_t> out(16);
+    byteorder::storeBig(out.data(), gen_.seed);
+    byteorder::storeBig(out.data() + 8, gen_.draws);
+#if !defined(ARDUINO) && !defined(AETHERIUM_PLATFORM_MCXN947)
+    // The engine's textual state (its words, plus the position on some
+    // standard libraries), packed as big-endian u64s
+    std::stringstream text;
+    text << gen_.engine;
+    uint64_t word = 0;
+    while (text >> word) {
+        out.resize(out.size() + 8);
+        byteorder::storeBig(out.data() + out.size() - 8, word);
+    }
+#endif
+    return out;
+}
+
+bool StdRandomSource::restoreState(const uint8_t* data, size_t size) {
+    if (size < 16 || size % 8 != 0) {
+        return false;
+    }
+    const auto draws = byteorder::loadBig<uint64_t>(data + 8);
+    seed(byteorder::loadBig<uint64_t>(data));
+    gen_.draws = draws;
+#if !defined(ARDUINO) && !defined(AETHERIUM_PLATFORM_MCXN947)
+    if (size > 16) {
+        std::stringstream text;
+        for (size_t offset = 16; offset < size; offset += 8) {
+            text << byteorder::loadBig<uint64_t>(data + offset) << ' ';
+        }
+        std::mt19937_64 engine;
+        if (text >> engine) {
+            gen_.engine = engine;
+            return true;
+        }
+        // Written by another standard library; fall back to replaying
+    }
+#endif
+    gen_.engine.discard(draws);
+    return true;
 }
 
 // ============================================================================
 // TransitionResolver Implementation
 // ============================================================================
 
-const Transition* TransitionResolver::resolve(const Automata& automata, 
-                                               StateId currentState) {
-    // Get all transitions from current state (already sorted by priority)
-    auto transitions = automata.getTransitionsFrom(currentState);
-    
-    if (transitions.empty()) {
+const Transition* TransitionResolver::resolve(const CompiledAutomata& automata,
+                                               StateId currentState,
+                                               const ReactiveFilter* filter) {
+    evaluated_ = 0;
+    nativeEvaluated_ = 0;
+    const CompiledState* state = automata.state(currentState);
+    if (!state || state->terminal) {
         return nullptr;
     }
 
-    std::vector<EvaluatedTransition> candidates;
-    std::vector<EvaluatedTransition> groupCandidates;
-    uint8_t currentPriority = transitions[0]->priority;
-    bool groupHasTimed = false;
+    // Groups are already sorted by priority; the first group with an enabled
+    // candidate wins. Timeout transitions are fallback by design, so they are
+    // kept apart and only used when nothing else in the group is enabled.
+    candidates_.clear();
+    fallbacks_.clear();
+    bool candidatesWeighted = false;
+    bool fallbacksWeighted = false;
 
-    for (const auto* t : transitions) {
-        if (t->priority > currentPriority) {
-            if (!groupCandidates.empty()) {
-                candidates = std::move(groupCandidates);
-                break;
+    for (const auto& group : automata.groups(*state)) {
+        for (const auto& entry : automata.members(group)) {
+            if (filter && entry.reactive &&
+                !dependenciesChanged(automata, entry, filter->sinceRevision)) {
+                continue;
+            }
+            ++evaluated_;
+            const uint64_t guardStart = ProfileClock::now();
+            EvaluatedTransition eval;
+            eval.transition = entry.transition;
+            eval.weight = entry.transition->weight;
+            eval.conditionMet = entry.evaluate(*this, automata, entry, eval.weight);
+            if (ProfileClock::enabled && profile_) {
+                profile_->guard.record(ProfileClock::now() - guardStart);
+            }
+            if (!eval.conditionMet) {
+                continue;
             }
-            if (groupHasTimed) {
-                return nullptr;
+            if (entry.timeout) {
+                fallbacks_.push_back(eval);
+                fallbacksWeighted = fallbacksWeighted || entry.weighted;
+            } else {
+                candidates_.push_back(eval);
+                candidatesWeighted = candidatesWeighted || entry.weighted;
             }
-            currentPriority = t->priority;
-            groupHasTimed = false;
         }
-
-        groupHasTimed = groupHasTimed || t->type == TransitionType::Timed;
-        auto eval = evaluate(*t);
-        if (eval.conditionMet) {
-            groupCandidates.push_back(eval);
+        if (!candidates_.empty() || !fallbacks_.empty()) {
+            break;
+        }
+        // A pending timed transition holds lower-priority groups back.
+        if (group.hasTimed) {
+            return nullptr;
         }
     }
 
-    if (candidates.empty() && !groupCandidates.empty()) {
-        candidates = std::move(groupCandidates);
-    } else if (candidates.empty() && groupHasTimed) {
-        return nullptr;
-    }
-
-    if (candidates.empty()) {
-        return nullptr;
-    }
-
-    // Timeout transitions are fallback by design: if any other transition is
-    // available in the same priority group, suppress timeout candidates.
-    const bool hasNonTimeout = std::any_of(
-        candidates.begin(), candidates.end(),
-        [](const EvaluatedTransition& c) {
-            const Transition* t = c.transition;
-            return !(t->type == TransitionType::Timed &&
-                     t->timedConfig.mode == TimedMode::Timeout);
-        });
-
-    if (hasNonTimeout) {
-        candidates.erase(
-            std::remove_if(
-                candidates.begin(), candidates.end(),
-                [](const EvaluatedTransition& c) {
-                    const Transition* t = c.transition;
-                    return t->type == TransitionType::Timed &&
-                           t->timedConfig.mode == TimedMode::Timeout;
-                }),
-            candidates.end());
-    }
-
-    if (candidates.empty()) {
+    const bool useFallbacks = candidates_.empty();
+    const auto& selected = useFallbacks ? fallbacks_ : candidates_;
+    if (selected.empty()) {
         return nullptr;
     }
 
     // Single candidate - return it
-    if (candidates.size() == 1) {
-        return candidates[0].transition;
+    if (selected.size() == 1) {
+        return selected[0].transition;
     }
 
-    // Multiple candidates - check if any are weighted
-    bool hasWeights = std::any_of(candidates.begin(), candidates.end(),
-        [](const EvaluatedTransition& e) { 
-            return e.transition->isWeighted(); 
-        });
-
-    if (hasWeights) {
-        return selectWeighted(candidates);
+    if (useFallbacks ? fallbacksWeighted : candidatesWeighted) {
+        return selectWeighted(selected);
     }
 
     // No weights - return first (deterministic)
-    return candidates[0].transition;
+    return selected[0].transition;
 }
 
-EvaluatedTransition TransitionResolver::evaluate(const Transition& t) {
-    EvaluatedTransition result;
-    result.transition = &t;
-    result.weight = t.weight;
+void TransitionResolver::reserve(size_t maxCandidates) {
+    candidates_.reserve(maxCandidates);
+    fallbacks_.reserve(maxCandidates);
+}
 
-    if (!t.enabled) {
-        result.conditionMet = false;
-        return result;
+bool TransitionResolver::dependenciesChanged(const CompiledAutomata& automata,
+                                             const CompiledTransition& entry,
+                                             uint64_t sinceRevision) const {
+    if (variables_->revision() <= sinceRevision) {
+        return false;
     }
+    for (VariableId id : automata.dependencies(entry)) {
+        const Variable* var = variables_->get(id);
+        if (var && var->revision() > sinceRevision) {
+            return true;
+        }
+    }
+    return false;
+}
 
-    switch (t.type) {
-        case TransitionType::Immediate:
-            result.conditionMet = true;
-            break;
-
-        case TransitionType::Classic:
-            if (t.classicConfig.condition.isEmpty()) {
-                result.conditionMet = true;
-            } else {
-                auto evalResult = script_->evaluateCondition(t.classicConfig.condition);
-                result.conditionMet = evalResult.isOk() && evalResult.value();
-            }
-            break;
-
-        case TransitionType::Timed:
-            result.conditionMet = evaluateTimed(t);
-            break;
+bool TransitionResolver::checkGuard(const Transition& t, const CodeBlock& code,
+                                    ArrayView<GuardInstr> guard) {
+    if (nativeGuards_ && !guard.empty()) {
+        if (auto native = evaluateNativeGuard(guard.begin(), guard.size(), *variables_)) {
+            ++nativeEvaluated_;
+            return *native;
+        }
+    }
+    CodeCostScope cost(profile_, *script_, CodeSite::Guard, t.id);
+    auto result = script_->evaluateCondition(code);
+    return result.isOk() && result.value();
+}
 
-        case TransitionType::Event:
-            result.conditionMet = evaluateEvent(t);
-            break;
+bool TransitionResolver::evaluateImmediate(TransitionResolver&, const CompiledAutomata&,
+                                           const CompiledTransition&, double&) {
+    return true;
+}
 
-        case TransitionType::Probabilistic:
-            // Probabilistic always fires, weight determines selection
-            result.conditionMet = true;
-            if (t.probConfig.isDynamic && !t.probConfig.weightExpression.isEmpty()) {
-                auto weightResult = script_->evaluateWeight(t.probConfig.weightExpression);
-                if (weightResult.isOk()) {
-                    result.weight = static_cast<uint16_t>(
-                        std::clamp(weightResult.value() * 100, 0.0, 10000.0));
-                }
-            } else {
-                result.weight = t.probConfig.weight;
-            }
-            break;
+template <bool Guarded>
+bool TransitionResolver::evaluateClassic(TransitionResolver& self, const CompiledAutomata& automata,
+                                         const CompiledTransition& entry, double&) {
+    if constexpr (!Guarded) {
+        return true;
+    } else {
+        const Transition& t = *entry.transition;
+        return self.checkGuard(t, t.classicConfig.condition, automata.guard(entry));
     }
-
-    return result;
 }
 
-bool TransitionResolver::evaluateTimed(const Transition& t) {
-    const auto* timer = timers_->getTimer(t.id);
-    const Timestamp now = timers_->now();
-    const Timestamp stateEntry = context_ ? context_->stateEntryTime : 0;
+template <TimedMode Mode, bool Guarded>
+bool TransitionResolver::evaluateTimed(TransitionResolver& self, const CompiledAutomata& automata,
+                                       const CompiledTransition& entry, double&) {
+    const Transition& t = *entry.transition;
+    const Timestamp now = self.timers_->now();
+    const Timestamp stateEntry = self.context_ ? self.context_->stateEntryTime : 0;
     const Timestamp elapsed = now >= stateEntry ? (now - stateEntry) : 0;
-    const bool timerFired = timer ? timer->fired : false;
+    auto timerFired = [&] {
+        const auto* timer = self.timers_->getTimer(t.id);
+        return timer ? timer->fired : false;
+    };
 
     bool ready = false;
-    switch (t.timedConfig.mode) {
-        case TimedMode::After:
-            ready = timerFired ||
-                    elapsed >= static_cast<Timestamp>(t.timedConfig.delayMs);
-            break;
-        case TimedMode::Every:
-            ready = timerFired;
-            break;
-        case TimedMode::Timeout:
-            ready = timerFired ||
-                    elapsed >= static_cast<Timestamp>(t.timedConfig.delayMs);
-            break;
-        case TimedMode::At:
-            // Current representation keeps "at" in delayMs; if delayMs is unset,
-            // fall back to timer semantics.
-            ready = (t.timedConfig.delayMs > 0)
-                ? (elapsed >= static_cast<Timestamp>(t.timedConfig.delayMs))
-                : timerFired;
-            break;
-        case TimedMode::Window: {
-            const Timestamp startMs = static_cast<Timestamp>(t.timedConfig.delayMs);
-            const Timestamp endMs = static_cast<Timestamp>(t.timedConfig.windowEndMs);
-            ready = elapsed >= startMs;
-            if (ready && endMs > 0) {
-                ready = elapsed <= endMs;
+    if constexpr (Mode == TimedMode::After || Mode == TimedMode::Timeout) {
+        ready = elapsed >= static_cast<Timestamp>(t.timedConfig.delayMs) || timerFired();
+    } else if constexpr (Mode == TimedMode::Every) {
+        ready = timerFired();
+    } else if constexpr (Mode == TimedMode::At) {
+        // Current representation keeps "at" in delayMs; if delayMs is unset,
+        // fall back to timer semantics.
+        ready = (t.timedConfig.delayMs > 0)
+            ? (elapsed >= static_cast<Timestamp>(t.timedConfig.delayMs))
+            : timerFired();
+    } else {
+        const Timestamp startMs = static_cast<Timestamp>(t.timedConfig.delayMs);
+        const Timestamp endMs = static_cast<Timestamp>(t.timedConfig.windowEndMs);
+        ready = elapsed >= startMs && (endMs == 0 || elapsed <= endMs);
+    }
+
+    if constexpr (Guarded) {
+        return ready && self.checkGuard(t, t.timedConfig.additionalCondition, automata.guard(entry));
+    } else {
+        return ready;
+    }
+}
+
+template <TransitionResolver::TriggerJoin Join, bool Guarded>
+bool TransitionResolver::evaluateEvent(TransitionResolver& self, const CompiledAutomata& automata,
+                                       const CompiledTransition& entry, double&) {
+    const ArrayView<CompiledTrigger> triggers = automata.triggers(entry);
+    bool result = false;
+    if constexpr (Join == TriggerJoin::Single) {
+        result = triggers[0].fired(self, triggers[0]);
+    } else if constexpr (Join == TriggerJoin::Any) {
+        for (const auto& trigger : triggers) {
+            if (trigger.fired(self, trigger)) {
+                result = true;
+                break;
+            }
+        }
+    } else {
+        result = true;
+        for (const auto& trigger : triggers) {
+            if (!trigger.fired(self, trigger)) {
+                result = false;
+                break;
             }
-            break;
         }
     }
 
-    if (!ready) {
-        return false;
+    if constexpr (Guarded) {
+        const Transition& t = *entry.transition;
+        return result && self.checkGuard(t, t.eventConfig.additionalCondition, automata.guard(entry));
+    } else {
+        return result;
     }
+}
 
-    // Check additional condition if present
-    if (!t.timedConfig.additionalCondition.isEmpty()) {
-        auto result = script_->evaluateCondition(t.timedConfig.additionalCondition);
-        if (result.isError() || !result.value()) {
-            return false;
+template <bool Dynamic>
+bool TransitionResolver::evaluateProbabilistic(TransitionResolver& self, const CompiledAutomata&,
+                                               const CompiledTransition& entry, double& weight) {
+    // Probabilistic always fires, weight determines selection
+    const Transition& t = *entry.transition;
+    if constexpr (Dynamic) {
+        CodeCostScope cost(self.profile_, *self.script_, CodeSite::Weight, t.id);
+        auto weightResult = self.script_->evaluateWeight(t.probConfig.weightExpression);
+        if (weightResult.isOk()) {
+            weight = static_cast<uint16_t>(std::clamp(weightResult.value() * 100, 0.0, 10000.0));
         }
+    } else {
+        weight = t.probConfig.weight;
     }
-
     return true;
 }
 
-bool TransitionResolver::evaluateEvent(const Transition& t) {
-    bool anyTriggered = false;
-    bool allTriggered = true;
+template <EventTrigger Trigger>
+bool TransitionResolver::triggerFired(const TransitionResolver& self, const CompiledTrigger& compiled) {
+    const Variable* var = self.variables_->get(compiled.signal);
+    if (!var || !var->hasChanged()) {
+        return false;
+    }
 
-    for (const auto& trigger : t.eventConfig.triggers) {
-        bool triggered = false;
-        const Variable* var = variables_->getByName(trigger.signalName);
-        
-        if (!var) {
-            allTriggered = false;
-            continue;
+    if constexpr (Trigger == EventTrigger::OnChange) {
+        return true;
+    } else if constexpr (Trigger == EventTrigger::OnRise || Trigger == EventTrigger::OnFall) {
+        auto prevBool = var->previousValue().tryGet<bool>();
+        auto currBool = var->value().tryGet<bool>();
+        if (!prevBool || !currBool) {
+            return false;
         }
+        return Trigger == EventTrigger::OnRise ? (!*prevBool && *currBool) : (*prevBool && !*currBool);
+    } else {
+        // Views compare lengths first; nothing is copied
+        return var->value().is<std::string>() && var->value().str() == compiled.pattern;
+    }
+}
 
-        switch (trigger.triggerType) {
-            case EventTrigger::OnChange:
-                triggered = var->hasChanged();
-                break;
+template <CompareOp Op>
+bool TransitionResolver::thresholdCrossed(const TransitionResolver& self, const CompiledTrigger& compiled) {
+    const Variable* var = self.variables_->get(compiled.signal);
+    if (!var) {
+        return false;
+    }
+    // Fire if value changed OR on the first tick after entering this state
+    // (so a threshold already met at state entry is not silently missed).
+    const bool isEntryTick = self.context_ &&
+        self.context_->tickCount == self.context_->stateEntryTickCount + 1;
+    if (!var->hasChanged() && !isEntryTick) {
+        return false;
+    }
+    const double curr = var->value().toDouble();
+    const double threshold = compiled.threshold;
+    if constexpr (Op == CompareOp::Gt) {
+        return curr > threshold;
+    } else if constexpr (Op == CompareOp::Ge) {
+        return curr >= threshold;
+    } else if constexpr (Op == CompareOp::Lt) {
+        return curr < threshold;
+    } else if constexpr (Op == CompareOp::Le) {
+        return curr <= threshold;
+    } else if constexpr (Op == CompareOp::Eq) {
+        return curr == threshold;
+    } else {
+        return curr != threshold;
+    }
+}
 
-            case EventTrigger::OnRise:
-                if (var->hasChanged()) {
-                    auto prevBool = var->previousValue().tryGet<bool>();
-                    auto currBool = var->value().tryGet<bool>();
-                    triggered = prevBool && currBool && !*prevBool && *currBool;
-                }
-                break;
+bool TransitionResolver::triggerNever(const TransitionResolver&, const CompiledTrigger&) {
+    return false;
+}
 
-            case EventTrigger::OnFall:
-                if (var->hasChanged()) {
-                    auto prevBool = var->previousValue().tryGet<bool>();
-                    auto currBool = var->value().tryGet<bool>();
-                    triggered = prevBool && currBool && *prevBool && !*currBool;
-                }
-                break;
+TransitionEvaluator selectTransitionEvaluator(const Transition& t) {
+    using R = TransitionResolver;
+    switch (t.type) {
+        case TransitionType::Immediate:
+            return &R::evaluateImmediate;
 
-            case EventTrigger::OnThreshold:
-                if (trigger.threshold) {
-                    // Fire if value changed OR on the first tick after entering this state
-                    // (so a threshold already met at state entry is not silently missed).
-                    const bool isEntryTick = context_ &&
-                        context_->tickCount == context_->stateEntryTickCount + 1;
-                    if (var->hasChanged() || isEntryTick) {
-                        double curr = var->value().toDouble();
-                        double threshold = trigger.threshold->value.toDouble();
-                        switch (trigger.threshold->op) {
-                            case CompareOp::Gt: triggered = curr > threshold; break;
-                            case CompareOp::Ge: triggered = curr >= threshold; break;
-                            case CompareOp::Lt: triggered = curr < threshold; break;
-                            case CompareOp::Le: triggered = curr <= threshold; break;
-                            case CompareOp::Eq: triggered = curr == threshold; break;
-                            case CompareOp::Ne: triggered = curr != threshold; break;
-                        }
-                    }
-                }
-                break;
+        case TransitionType::Classic:
+            return t.classicConfig.condition.isEmpty() ? &R::evaluateClassic<false> : &R::evaluateClassic<true>;
+
+        case TransitionType::Timed: {
+            const bool guarded = !t.timedConfig.additionalCondition.isEmpty();
+            switch (t.timedConfig.mode) {
+                case TimedMode::After:
+                    return guarded ? &R::evaluateTimed<TimedMode::After, true> : &R::evaluateTimed<TimedMode::After, false>;
+                case TimedMode::At:
+                    return guarded ? &R::evaluateTimed<TimedMode::At, true> : &R::evaluateTimed<TimedMode::At, false>;
+                case TimedMode::Every:
+                    return guarded ? &R::evaluateTimed<TimedMode::Every, true> : &R::evaluateTimed<TimedMode::Every, false>;
+                case TimedMode::Timeout:
+                    return guarded ? &R::evaluateTimed<TimedMode::Timeout, true> : &R::evaluateTimed<TimedMode::Timeout, false>;
+                case TimedMode::Window:
+                    return guarded ? &R::evaluateTimed<TimedMode::Window, true> : &R::evaluateTimed<TimedMode::Window, false>;
+            }
+            break;
+        }
 
-            case EventTrigger::OnMatch:
-                if (var->hasChanged()) {
-                    auto strVal = var->value().tryGet<std::string>();
-                    if (strVal) {
-                        triggered = (*strVal == trigger.pattern);
-                    }
-                }
-                break;
+        case TransitionType::Event: {
+            const bool guarded = !t.eventConfig.additionalCondition.isEmpty();
+            const size_t count = t.eventConfig.triggers.size();
+            if (count == 0) {
+                // No trigger: any-of is never met, all-of always is
+                return t.eventConfig.requireAll ? (guarded ? &R::evaluateEvent<R::TriggerJoin::All, true>
+                                                           : &R::evaluateEvent<R::TriggerJoin::All, false>)
+                                                : (guarded ? &R::evaluateEvent<R::TriggerJoin::Any, true>
+                                                           : &R::evaluateEvent<R::TriggerJoin::Any, false>);
+            }
+            if (count == 1) {
+                return guarded ? &R::evaluateEvent<R::TriggerJoin::Single, true>
+                               : &R::evaluateEvent<R::TriggerJoin::Single, false>;
+            }
+            if (t.eventConfig.requireAll) {
+                return guarded ? &R::evaluateEvent<R::TriggerJoin::All, true> : &R::evaluateEvent<R::TriggerJoin::All, false>;
+            }
+            return guarded ? &R::evaluateEvent<R::TriggerJoin::Any, true> : &R::evaluateEvent<R::TriggerJoin::Any, false>;
         }
 
-        if (triggered) anyTriggered = true;
-        else allTriggered = false;
+        case TransitionType::Probabilistic:
+            return t.probConfig.isDynamic && !t.probConfig.weightExpression.isEmpty()
+                ? &R::evaluateProbabilistic<true>
+                : &R::evaluateProbabilistic<false>;
     }
+    return &R::evaluateClassic<false>;
+}
 
-    bool result = t.eventConfig.requireAll ? allTriggered : anyTriggered;
-
-    // Check additional condition
-    if (result && !t.eventConfig.additionalCondition.isEmpty()) {
-        auto evalResult = script_->evaluateCondition(t.eventConfig.additionalCondition);
-        result = evalResult.isOk() && evalResult.value();
+TriggerEvaluator selectTriggerEvaluator(const SignalTrigger& trigger) {
+    using R = TransitionResolver;
+    switch (trigger.triggerType) {
+        case EventTrigger::OnChange: return &R::triggerFired<EventTrigger::OnChange>;
+        case EventTrigger::OnRise: return &R::triggerFired<EventTrigger::OnRise>;
+        case EventTrigger::OnFall: return &R::triggerFired<EventTrigger::OnFall>;
+        case EventTrigger::OnThreshold:
+            if (!trigger.threshold) {
+                return &R::triggerNever;
+            }
+            switch (trigger.threshold->op) {
+                case CompareOp::Gt: return &R::thresholdCrossed<CompareOp::Gt>;
+                case CompareOp::Ge: return &R::thresholdCrossed<CompareOp::Ge>;
+                case CompareOp::Lt: return &R::thresholdCrossed<CompareOp::Lt>;
+                case CompareOp::Le: return &R::thresholdCrossed<CompareOp::Le>;
+                case CompareOp::Eq: return &R::thresholdCrossed<CompareOp::Eq>;
+                case CompareOp::Ne: return &R::thresholdCrossed<CompareOp::Ne>;
+            }
+            return &R::triggerNever;
+        case EventTrigger::OnMatch: return &R::triggerFired<EventTrigger::OnMatch>;
     }
-
-    return result;
+    return &R::triggerFired<EventTrigger::OnChange>;
 }
 
 const Transition* TransitionResolver::selectWeighted(
@@ -393,11 +587,15 @@ Runtime::~Runtime() {
     if (running_) {
         stop();
     }
+    dropChildren();
 }
 
 void Runtime::setCallbacks(RuntimeCallbacks callbacks) {
     callbacks_ = std::move(callbacks);
+    installScriptLogHandler();
+}
 
+void Runtime::installScriptLogHandler() {
     if (!script_) {
         return;
     }
@@ -418,9 +616,13 @@ Result<RunId> Runtime::load(const Automata& automata) {
     if (!errors.empty()) {
         return Result<RunId>::error("Validation failed: " + errors[0]);
     }
+    dropChildren();
 
     // Store reference
     automata_ = &automata;
+    compiled_.build(automata);
+    timers_->reserve(compiled_.transitionIdLimit());
+    profile_.scripts.resize(compiled_.stateIdLimit(), compiled_.transitionIdLimit());
     ctx_.automata = &automata;
     ctx_.runId = nextRunId_++;
     ctx_.state = ExecutionState::Loaded;
@@ -431,21 +633,179 @@ Result<RunId> Runtime::load(const Automata& automata) {
         ctx_.variables.addVariable(spec);
     }
 
+    watchOutputs();
+
+    // Initialize script engine
+    auto initResult = script_->initialize(&ctx_.variables);
+    if (initResult.isError()) {
+        ctx_.state = ExecutionState::Error;
+        return Result<RunId>::error("Script init failed: " + initResult.error());
+    }
+    script_->setGcMode(gcPolicy_.mode);
+    script_->prepare(automata);
+
+    debug("Loaded automata: " + automata.config.name);
+    return Result<RunId>::ok(ctx_.runId);
+}
+
+void Runtime::watchOutputs() {
     // Setup variable change callback for outputs
     ctx_.variables.onVariableChange([this](const Variable& var) {
         if (var.direction() == VariableDirection::Output && callbacks_.onOutputChange) {
             callbacks_.onOutputChange(var);
         }
     });
+}
 
-    // Initialize script engine
-    auto initResult = script_->initialize(&ctx_.variables);
+Result<std::unique_ptr<PreparedLoad>> Runtime::prepare(const Automata& automata,
+                                                       std::unique_ptr<IScriptEngine> script) {
+    if (!script) {
+        return Result<std::unique_ptr<PreparedLoad>>::error("No script engine for prepared load");
+    }
+    auto errors = automata.validate();
+    if (!errors.empty()) {
+        return Result<std::unique_ptr<PreparedLoad>>::error("Validation failed: " + errors[0]);
+    }
+
+    auto prepared = std::make_unique<PreparedLoad>();
+    prepared->automata = &automata;
+    prepared->compiled.build(automata);
+    prepared->variables = std::make_unique<VariableStore>();
+    for (const auto& spec : automata.variables) {
+        prepared->variables->addVariable(spec);
+    }
+
+    auto initResult = script->initialize(prepared->variables.get());
     if (initResult.isError()) {
-        ctx_.state = ExecutionState::Error;
-        return Result<RunId>::error("Script init failed: " + initResult.error());
+        return Result<std::unique_ptr<PreparedLoad>>::error("Script init failed: " + initResult.error());
     }
+    script->prepare(automata);
+    prepared->script = std::move(script);
+    return Result<std::unique_ptr<PreparedLoad>>::ok(std::move(prepared));
+}
 
-    debug("Loaded automata: " + automata.config.name);
+std::unique_ptr<IScriptEngine> Runtime::createScriptEngine() {
+    std::unique_ptr<IScriptEngine> script;
+    if (!spareScripts_.empty()) {
+        script = std::move(spareScripts_.back());
+        spareScripts_.pop_back();
+    } else if (script_) {
+        script = script_->createInstance();
+    }
+    if (script) {
+        script->setMemoryBudget(scriptMemoryBudget_);
+    }
+    return script;
+}
+
+void Runtime::warmScriptEngines(size_t count) {
+    spareScriptLimit_ = count;
+    if (spareScripts_.size() > count) {
+        spareScripts_.resize(count);
+    }
+    while (script_ && spareScripts_.size() < count) {
+        auto script = script_->createInstance();
+        if (!script) {
+            break;
+        }
+        script->setMemoryBudget(scriptMemoryBudget_);
+        if (script->initialize(nullptr).isError()) {
+            break;
+        }
+        spareScripts_.push_back(std::move(script));
+    }
+}
+
+void Runtime::recycleScriptEngine(std::unique_ptr<IScriptEngine> script) {
+    if (!script || spareScripts_.size() >= spareScriptLimit_) {
+        return;
+    }
+    // Re-initializing against no store drops the old run's chunks and globals
+    if (script->initialize(nullptr).isOk()) {
+        spareScripts_.push_back(std::move(script));
+    }
+}
+
+Result<RunId> Runtime::swapIn(PreparedLoad& prepared) {
+    if (!prepared.automata || !prepared.script || !prepared.variables) {
+        return Result<RunId>::error("Prepared load is incomplete");
+    }
+
+    const Automata& next = *prepared.automata;
+    const bool active = ctx_.state == ExecutionState::Running || ctx_.state == ExecutionState::Paused;
+    const State* keptState = nullptr;
+    if (active) {
+        if (const State* current = automata_->getState(ctx_.currentState)) {
+            keptState = next.getStateByName(current->name);
+        }
+    }
+
+    // Carry matching values across before anything observes the new store
+    VariableStore& incoming = *prepared.variables;
+    if (isLoaded()) {
+        incoming.forEach([&](const Variable& var) {
+            const Variable* old = ctx_.variables.getByName(var.name());
+            if (!old || old->type() != var.type() || old->direction() != var.direction()) {
+                return;
+            }
+            if (var.direction() == VariableDirection::Input) {
+                incoming.setExternalValue(var.id(), old->value());
+            } else {
+                incoming.setValue(var.id(), old->value());
+            }
+        });
+        incoming.clearAllChanged();  // Carried values are not edges
+    }
+
+    dropChildren();
+    timers_->cancelAll();
+    std::swap(ctx_.variables, incoming);
+    script_.swap(prepared.script);
+    std::swap(compiled_, prepared.compiled);
+    prepared.automata = automata_;
+
+    script_->rebindVariables(&ctx_.variables);
+    script_->setGcMode(gcPolicy_.mode);
+    watchOutputs();
+    installScriptLogHandler();
+
+    automata_ = &next;
+    ctx_.automata = &next;
+    ctx_.runId = nextRunId_++;
+    timers_->reserve(compiled_.transitionIdLimit());
+    profile_.scripts.resize(compiled_.stateIdLimit(), compiled_.transitionIdLimit());
+    reactiveResync_ = true;
+
+    if (!active) {
+        resolver_.reset();
+        ctx_.state = ExecutionState::Loaded;
+        debug("Hot-swapped automata: " + next.config.name);
+        return Result<RunId>::ok(ctx_.runId);
+    }
+
+    resolver_ = std::make_unique<TransitionResolver>(
+        script_.get(), random_.get(), timers_.get(), &ctx_.variables, &ctx_, &profile_);
+    resolver_->reserve(compiled_.maxGroupSize());
+    resolver_->setNativeGuards(nativeGuards_);
+
+    if (keptState) {
+        ctx_.currentState = keptState->id;
+        setupTimersForState(*keptState);
+    } else {
+        const State* initial = next.getState(next.initialState);
+        if (!initial) {
+            ctx_.state = ExecutionState::Error;
+            return Result<RunId>::error("Invalid start state");
+        }
+        ctx_.previousState = INVALID_STATE;
+        ctx_.currentState = initial->id;
+        ctx_.stateEntryTime = clock_->now();
+        ctx_.stateEntryTickCount = ctx_.tickCount;
+        setupTimersForState(*initial);
+        executeOnEnter(*initial);
+    }
+
+    debug("Hot-swapped automata: " + next.config.name);
     return Result<RunId>::ok(ctx_.runId);
 }
 
@@ -475,16 +835,23 @@ Result<void> Runtime::start(std::optional<StateId> fromState) {
     ctx_.stateEntryTickCount = 0;
     ctx_.transitionCount = 0;
     pausedAt_ = 0;
+    reactiveResync_ = true;
 
     // Setup resolver
     resolver_ = std::make_unique<TransitionResolver>(
-        script_.get(), random_.get(), timers_.get(), &ctx_.variables, &ctx_);
+        script_.get(), random_.get(), timers_.get(), &ctx_.variables, &ctx_, &profile_);
+    resolver_->reserve(compiled_.maxGroupSize());
+    resolver_->setNativeGuards(nativeGuards_);
 
     // Setup timers for initial state
     setupTimersForState(*state);
 
     // Execute on_enter for initial state
+    exitChildren();  // Left over from a run that ended in a terminal state
     executeOnEnter(*state);
+    enterChildren(state->id);
+    flushActuation();
+    publishOutputs();
 
     debug("Started in state: " + state->name);
     return Result<void>::ok();
@@ -498,9 +865,11 @@ Result<void> Runtime::stop() {
     running_ = false;
 
     // Execute on_exit for current state
+    exitChildren();
     if (const State* state = automata_->getState(ctx_.currentState)) {
         executeOnExit(*state);
     }
+    publishOutputs();
 
     ctx_.state = ExecutionState::Stopped;
     timers_->cancelAll();
@@ -517,6 +886,9 @@ Result<void> Runtime::pause() {
 
     ctx_.state = ExecutionState::Paused;
     pausedAt_ = clock_->now();
+    for (NestedChild* child : activeChildren_) {
+        (void)child->runtime->pause();
+    }
     
     debug("Paused");
     return Result<void>::ok();
@@ -534,6 +906,9 @@ Result<void> Runtime::resume() {
     }
     pausedAt_ = 0;
     ctx_.state = ExecutionState::Running;
+    for (NestedChild* child : activeChildren_) {
+        (void)child->runtime->resume();
+    }
     
     debug("Resumed");
     return Result<void>::ok();
@@ -553,6 +928,13 @@ Result<void> Runtime::reset() {
     ctx_.reset();
     timers_->cancelAll();
 
+    const uint64_t scriptResetStart = monotonicUs();
+    auto globals = script_->resetGlobals();
+    lastScriptResetUs_ = monotonicUs() - scriptResetStart;
+    if (globals.isError()) {
+        return Result<void>::error("Script reset failed: " + globals.error());
+    }
+
     if (wasRunning) {
         return start();
     }
@@ -576,6 +958,7 @@ Result<void> Runtime::restoreState(const std::string& stateName,
     const bool wasPaused = (ctx_.state == ExecutionState::Paused);
 
     // Move to Paused for the swap — bypass the running check for Stopped.
+    exitChildren();
     ctx_.state = ExecutionState::Paused;
     pausedAt_ = clock_->now();
 
@@ -596,6 +979,10 @@ Result<void> Runtime::restoreState(const std::string& stateName,
     script_->setReplayMode(true);
     executeOnEnter(*targetState);
     script_->setReplayMode(false);
+    // Children have no history to restore; they start over (paused, like the parent)
+    enterChildren(targetState->id);
+    flushActuation();
+    publishOutputs();
 
     // Always resume unless the user had explicitly paused before the rewind.
     if (!wasPaused) {
@@ -609,8 +996,10 @@ void Runtime::unload() {
     if (isRunning()) {
         stop();
     }
+    dropChildren();
 
     automata_ = nullptr;
+    compiled_.clear();
     ctx_.automata = nullptr;
     ctx_.state = ExecutionState::Unloaded;
     ctx_.variables.clear();
@@ -626,43 +1015,93 @@ bool Runtime::tick() {
         return false;
     }
 
+    const uint64_t tickStart = ProfileClock::now();
     const Timestamp now = clock_->now();
     ctx_.tickCount++;
     ctx_.lastTickTime = now;
-    
-    // Run garbage collection every 100 ticks to prevent memory buildup
-    if (ctx_.tickCount % 100 == 0 && script_) {
-        script_->collectGarbage();
+
+    // Children first, so this tick's guards already see their outputs
+    tickChildren();
+
+    const uint64_t syncedBefore = script_ ? script_->syncedValueCount() : 0;
+    const bool fired = step();
+    if (script_) {
+        ctx_.scriptValuesSynced = static_cast<uint32_t>(script_->syncedValueCount() - syncedBefore);
+    }
+    flushActuation();
+    publishOutputs();
+    profile_.tick.record(ProfileClock::now() - tickStart);
+    return fired;
+}
+
+bool Runtime::step() {
+    // Full mode collects on a fixed cadence; the others leave the tick path
+    // to the VM's own collector unless the heap is over the watermark.
+    if (script_) {
+        if (gcPolicy_.mode == GcMode::Full) {
+            if (gcPolicy_.fullCollectTicks > 0 && ctx_.tickCount % gcPolicy_.fullCollectTicks == 0) {
+                PhaseScope gc(profile_, TickPhase::ScriptGc);
+                script_->collectGarbage();
+            }
+        } else if (gcPolicy_.watermarkBytes > 0 && script_->memoryInUse() > gcPolicy_.watermarkBytes) {
+            PhaseScope gc(profile_, TickPhase::ScriptGc);
+            script_->stepGarbage(gcPolicy_.stepKb);
+        }
     }
 
-    // Check expired timers
-    auto expiredTimers = timers_->checkExpired();
+    // Mark expired timers; the resolver reads their fired flags
+    {
+        PhaseScope timers(profile_, TickPhase::Timers);
+        timers_->markExpired();
+    }
 
-    // Resolve transition
-    const Transition* transition = resolver_->resolve(*automata_, ctx_.currentState);
+    // Resolve transition. In reactive mode, everything is evaluated on the
+    // state-entry tick; afterwards only transitions whose inputs changed.
+    const bool entryTick = ctx_.tickCount == ctx_.stateEntryTickCount + 1;
+    const ReactiveFilter filter{reactiveRevision_};
+    const bool filtered = tickMode_ == TickMode::Reactive && !entryTick && !reactiveResync_;
+    reactiveRevision_ = ctx_.variables.revision();
+    reactiveResync_ = false;
+
+    const Transition* transition = nullptr;
+    {
+        PhaseScope guards(profile_, TickPhase::Guards);
+        transition = resolver_->resolve(compiled_, ctx_.currentState, filtered ? &filter : nullptr);
+    }
+    ctx_.transitionsEvaluated = resolver_->lastEvaluated();
+    ctx_.nativeGuards = resolver_->lastNativeGuards();
 
     if (transition) {
-        fireTransition(*transition);
-        if (script_) script_->collectGarbage();
+        {
+            PhaseScope firing(profile_, TickPhase::Transition);
+            fireTransition(*transition);
+        }
+        if (script_ && gcPolicy_.mode == GcMode::Full) {
+            PhaseScope gc(profile_, TickPhase::ScriptGc);
+            script_->collectGarbage();
+        }
         ctx_.variables.clearAllChanged();
         return true;
     }
 
-    // No transition available - check if this is a terminal state
-    auto outgoing = automata_->getTransitionsFrom(ctx_.currentState);
-    if (outgoing.empty()) {
+    // No transition available - check if this is a terminal state. A state
+    // hosting a running child is not finished until the child is.
+    const CompiledState* current = compiled_.state(ctx_.currentState);
+    if (!current || (current->terminal && !childrenRunning())) {
         // Terminal state - no outgoing transitions, stop execution
-        if (const State* state = automata_->getState(ctx_.currentState)) {
-            debug("Reached terminal state: " + state->name);
+        if (current) {
+            debug("Reached terminal state: " + current->state->name);
         }
+        exitChildren();
         ctx_.state = ExecutionState::Stopped;
         running_ = false;
         return false;
     }
 
     // Execute state body while waiting for transition conditions
-    if (const State* state = automata_->getState(ctx_.currentState)) {
-        executeBody(*state);
+    {
+        PhaseScope body(profile_, TickPhase::StateBody);
+        executeBody(*current->state);
     }
 
     // Clear change flags after processing
@@ -682,22 +1121,70 @@ void Runtime::run() {
 
     running_ = true;
 
+    TickScheduler scheduler(maxTickRate_);
     while (running_ && isRunning()) {
-        Timestamp tickStart = clock_->now();
-        
         tick();
-
-        // Rate limiting
-        if (maxTickRate_ > 0) {
-            Timestamp tickDuration = clock_->now() - tickStart;
-            uint32_t targetMs = 1000 / maxTickRate_;
-            if (tickDuration < targetMs) {
-                clock_->sleep(targetMs - static_cast<uint32_t>(tickDuration));
+        scheduler.ticked(clock_->now() * 1000);
+
+        // Rate limiting: collect in part of the slack, then sleep until the
+        // next slot or timer deadline
+        if (!scheduler.unlimited()) {
+            uint64_t waitUs = scheduler.waitUs(clock_->now() * 1000, msUntilNextTimer(), UINT64_MAX);
+            if (waitUs > 0 && collectGarbageIdle(static_cast<uint32_t>(std::min<uint64_t>(waitUs / 2, UINT32_MAX)))) {
+                waitUs = scheduler.waitUs(clock_->now() * 1000, msUntilNextTimer(), UINT64_MAX);
+            }
+            if (waitUs > 0) {
+                clock_->sleep(static_cast<uint32_t>((waitUs + 999) / 1000));
             }
         }
     }
 }
 
+bool Runtime::collectGarbageIdle(uint32_t budgetUs) {
+    if (!script_ || !isLoaded() || gcPolicy_.mode == GcMode::Full || gcCycleTick_ == ctx_.tickCount) {
+        return false;
+    }
+    const uint32_t budget = std::min(budgetUs, gcPolicy_.idleBudgetUs);
+    if (budget == 0) {
+        return false;
+    }
+
+    PhaseScope gc(profile_, TickPhase::ScriptGc);
+    const uint64_t start = monotonicUs();
+    do {
+        if (script_->stepGarbage(gcPolicy_.stepKb)) {
+            gcCycleTick_ = ctx_.tickCount;
+            break;
+        }
+    } while (monotonicUs() - start < budget);
+    return true;
+}
+
+void Runtime::setGcPolicy(const GcPolicy& policy) {
+    gcPolicy_ = policy;
+    if (script_) {
+        script_->setGcMode(policy.mode);
+    }
+}
+
+std::optional<uint32_t> Runtime::msUntilNextTimer() {
+    if (!isRunning() || !timers_) {
+        return std::nullopt;
+    }
+    std::optional<uint32_t> wait;
+    if (const auto deadline = timers_->nextDeadline()) {
+        const Timestamp now = clock_->now();
+        wait = *deadline <= now ? 0 : static_cast<uint32_t>(std::min<Timestamp>(*deadline - now, UINT32_MAX));
+    }
+    // Children share this runtime's scheduler, so their deadlines count too
+    for (NestedChild* child : activeChildren_) {
+        if (const auto childWait = child->runtime->msUntilNextTimer()) {
+            wait = wait ? std::min(*wait, *childWait) : *childWait;
+        }
+    }
+    return wait;
+}
+
 Result<void> Runtime::setInput(const std::string& name, Value value) {
     if (!ctx_.variables.setExternalValue(name, std::move(value))) {
         return Result<void>::error("Failed to set input: " + name);
@@ -712,6 +1199,13 @@ Result<void> Runtime::setInput(VariableId id, Value value) {
     return Result<void>::ok();
 }
 
+Result<void> Runtime::setInputs(const std::vector<VariableUpdate>& inputs) {
+    if (!ctx_.variables.setExternalValues(inputs)) {
+        return Result<void>::error("Failed to set input batch");
+    }
+    return Result<void>::ok();
+}
+
 Result<void> Runtime::setVariable(const std::string& name, Value value) {
     const auto* existing = ctx_.variables.getByName(name);
     if (!existing) {
@@ -748,6 +1242,28 @@ std::optional<Value> Runtime::getOutput(VariableId id) const {
     return ctx_.variables.getValue(id);
 }
 
+void Runtime::publishOutputs() {
+    VariableStore& variables = ctx_.variables;
+    const auto& journal = variables.changeJournal();
+    if (journal.empty()) {
+        return;
+    }
+    if (callbacks_.onOutputBatch) {
+        publishedOutputs_.clear();
+        for (VariableId id : journal) {
+            const Variable* var = variables.get(id);
+            if (var && var->direction() == VariableDirection::Output &&
+                !(suppressOutputFlips_ && variables.journalReverted(id))) {
+                publishedOutputs_.push_back(var);
+            }
+        }
+        if (!publishedOutputs_.empty()) {
+            callbacks_.onOutputBatch(publishedOutputs_);
+        }
+    }
+    variables.clearJournal();
+}
+
 std::vector<std::pair<std::string, Value>> Runtime::getChangedOutputs() {
     std::vector<std::pair<std::string, Value>> result;
     
@@ -761,17 +1277,22 @@ std::vector<std::pair<std::string, Value>> Runtime::getChangedOutputs() {
 }
 
 void Runtime::fireTransition(const Transition& t) {
-    const State* fromState = automata_->getState(t.from);
-    const State* toState = automata_->getState(t.to);
+    const CompiledState* from = compiled_.state(t.from);
+    const CompiledState* to = compiled_.state(t.to);
 
-    if (!fromState || !toState) {
+    if (!from || !to) {
         reportError("Invalid transition states");
         return;
     }
+    const State* fromState = from->state;
+    const State* toState = to->state;
 
-    debug("Firing: " + t.name + " (" + fromState->name + " -> " + toState->name + ")");
+    if (callbacks_.onDebug) {
+        debug("Firing: " + t.name + " (" + fromState->name + " -> " + toState->name + ")");
+    }
 
     // Execute on_exit of current state
+    exitChildren();
     executeOnExit(*fromState);
 
     // Cancel timers for old state
@@ -792,6 +1313,7 @@ void Runtime::fireTransition(const Transition& t) {
 
     // Execute on_enter of new state
     executeOnEnter(*toState);
+    enterChildren(t.to);
 
     // Notify callback
     if (callbacks_.onStateChange) {
@@ -807,6 +1329,7 @@ void Runtime::fireTransition(const Transition& t) {
 
 void Runtime::executeOnEnter(const State& state) {
     if (!state.onEnter.isEmpty()) {
+        CodeCostScope cost(&profile_, *script_, CodeSite::OnEnter, state.id);
         auto result = script_->execute(state.onEnter);
         if (result.isError()) {
             reportError("on_enter error in " + state.name + ": " + result.error());
@@ -816,6 +1339,7 @@ void Runtime::executeOnEnter(const State& state) {
 
 void Runtime::executeOnExit(const State& state) {
     if (!state.onExit.isEmpty()) {
+        CodeCostScope cost(&profile_, *script_, CodeSite::OnExit, state.id);
         auto result = script_->execute(state.onExit);
         if (result.isError()) {
             reportError("on_exit error in " + state.name + ": " + result.error());
@@ -825,6 +1349,7 @@ void Runtime::executeOnExit(const State& state) {
 
 void Runtime::executeBody(const State& state) {
     if (!state.body.isEmpty()) {
+        CodeCostScope cost(&profile_, *script_, CodeSite::Body, state.id);
         auto result = script_->execute(state.body);
         if (result.isError()) {
             reportError("body error in " + state.name + ": " + result.error());
@@ -834,6 +1359,7 @@ void Runtime::executeBody(const State& state) {
 
 void Runtime::executeTransitionBody(const Transition& t) {
     if (!t.body.isEmpty()) {
+        CodeCostScope cost(&profile_, *script_, CodeSite::TransitionBody, t.id);
         auto result = script_->execute(t.body);
         if (result.isError()) {
             reportError("transition body error in " + t.name + ": " + result.error());
@@ -841,6 +1367,7 @@ void Runtime::executeTransitionBody(const Transition& t) {
     }
 
     if (!t.triggered.isEmpty()) {
+        CodeCostScope cost(&profile_, *script_, CodeSite::Triggered, t.id);
         auto result = script_->execute(t.triggered);
         if (result.isError()) {
             reportError("triggered error in " + t.name + ": " + result.error());
@@ -849,11 +1376,15 @@ void Runtime::executeTransitionBody(const Transition& t) {
 }
 
 void Runtime::setupTimersForState(const State& state) {
-    // Find timed transitions from this state
-    auto transitions = automata_->getTransitionsFrom(state.id);
-    
-    for (const auto* t : transitions) {
-        if (t->type == TransitionType::Timed) {
+    const CompiledState* compiled = compiled_.state(state.id);
+    if (!compiled) {
+        return;
+    }
+
+    // Start timers for timed transitions from this state
+    for (const auto& entry : compiled_.outgoing(*compiled)) {
+        if (entry.timed) {
+            const Transition* t = entry.transition;
             timers_->startTimer(t->id, t->timedConfig.delayMs, 
                                t->timedConfig.jitterMs,
                                t->timedConfig.repeatCount);
@@ -862,13 +1393,190 @@ void Runtime::setupTimersForState(const State& state) {
 }
 
 void Runtime::cancelTimersForState(StateId stateId) {
-    auto transitions = automata_->getTransitionsFrom(stateId);
-    
-    for (const auto* t : transitions) {
-        if (t->type == TransitionType::Timed) {
-            timers_->cancelTimer(t->id);
+    const CompiledState* compiled = compiled_.state(stateId);
+    if (!compiled) {
+        return;
+    }
+
+    for (const auto& entry : compiled_.outgoing(*compiled)) {
+        if (entry.timed) {
+            timers_->cancelTimer(entry.transition->id);
+        }
+    }
+}
+
+void Runtime::flushActuation() {
+    // A buffered hardware service applies the tick's writes here, in one go
+    if (auto* hardware = hardwareService()) {
+        auto flushed = hardware->flush();
+        if (flushed.isError()) {
+            reportError("actuation flush failed: " + flushed.error());
+        }
+    }
+}
+
+// ============================================================================
+// Nested Automata
+// ============================================================================
+
+Result<size_t> Runtime::addChild(StateId parentState, const Automata& child,
+                                 const std::vector<NestedBinding>& bindings) {
+    using R = Result<size_t>;
+    if (!isLoaded()) {
+        return R::error("No automata loaded");
+    }
+    if (!automata_->getState(parentState)) {
+        return R::error("Unknown parent state");
+    }
+    if (child.parentId && *child.parentId != automata_->id) {
+        return R::error("Child automata " + child.config.name + " belongs to another parent");
+    }
+    auto script = createScriptEngine();
+    if (!script) {
+        return R::error("Script engine cannot create child instances");
+    }
+
+    auto entry = std::make_unique<NestedChild>();
+    entry->parentState = parentState;
+    entry->runtime = std::make_unique<Runtime>(std::make_unique<BorrowedClock>(clock_.get()),
+                                               std::make_unique<StdRandomSource>(random_->randomInt(UINT32_MAX)),
+                                               std::move(script));
+    Runtime& runtime = *entry->runtime;
+    runtime.setTickMode(tickMode_);
+    runtime.setNativeGuards(nativeGuards_);
+    runtime.setGcPolicy(gcPolicy_);
+    runtime.setScriptMemoryBudget(scriptMemoryBudget_);
+    auto loaded = runtime.load(child);
+    if (loaded.isError()) {
+        return R::error("Child load failed: " + loaded.error());
+    }
+
+    for (const auto& binding : bindings) {
+        const Variable* parentVar = ctx_.variables.getByName(binding.parent);
+        const Variable* childVar = runtime.context().variables.getByName(binding.child);
+        if (!parentVar || !childVar) {
+            return R::error("Unknown binding variable: " + (parentVar ? binding.child : binding.parent));
+        }
+        if (parentVar->type() != childVar->type()) {
+            return R::error("Binding type mismatch: " + binding.parent + " / " + binding.child);
+        }
+        const NestedChild::Link link{parentVar->id(), childVar->id()};
+        if (childVar->direction() == VariableDirection::Input) {
+            entry->inputs.push_back(link);
+        } else if (childVar->direction() == VariableDirection::Output) {
+            entry->outputs.push_back(link);
+        } else {
+            return R::error("Binding " + binding.child + " is neither a child input nor output");
         }
     }
+
+    const std::string label = child.config.name.empty() ? "child" : child.config.name;
+    RuntimeCallbacks callbacks;
+    callbacks.onError = [this, label](const std::string& error) { reportError(label + ": " + error); };
+    runtime.setCallbacks(std::move(callbacks));
+
+    children_.push_back(std::move(entry));
+    const bool active = ctx_.state == ExecutionState::Running || ctx_.state == ExecutionState::Paused;
+    if (active && ctx_.currentState == parentState) {
+        // Added under the current state: enter it now, as a transition would have
+        NestedChild& added = *children_.back();
+        pushChildInputs(added);
+        if (added.runtime->start().isOk()) {
+            pullChildOutputs(added);
+            activeChildren_.push_back(&added);
+            if (ctx_.state == ExecutionState::Paused) {
+                (void)added.runtime->pause();
+            }
+        }
+    }
+    return R::ok(children_.size() - 1);
+}
+
+Runtime* Runtime::child(size_t index) {
+    return index < children_.size() ? children_[index]->runtime.get() : nullptr;
+}
+
+void Runtime::enterChildren(StateId stateId) {
+    for (auto& child : children_) {
+        if (child->parentState != stateId) {
+            continue;
+        }
+        pushChildInputs(*child);
+        auto started = child->runtime->start();
+        if (started.isError()) {
+            reportError("child start failed: " + started.error());
+            continue;
+        }
+        pullChildOutputs(*child);
+        activeChildren_.push_back(child.get());
+        if (ctx_.state == ExecutionState::Paused) {
+            (void)child->runtime->pause();
+        }
+    }
+}
+
+void Runtime::exitChildren() {
+    for (NestedChild* child : activeChildren_) {
+        Runtime& runtime = *child->runtime;
+        if (runtime.isRunning() || runtime.state() == ExecutionState::Paused) {
+            (void)runtime.stop();
+            pullChildOutputs(*child);  // Whatever its on_exit wrote
+        }
+    }
+    activeChildren_.clear();
+}
+
+void Runtime::tickChildren() {
+    for (NestedChild* child : activeChildren_) {
+        if (!child->runtime->isRunning()) {
+            continue;  // Finished in a terminal state
+        }
+        pushChildInputs(*child);
+        child->runtime->tick();
+        pullChildOutputs(*child);
+    }
+}
+
+void Runtime::dropChildren() {
+    exitChildren();
+    children_.clear();
+}
+
+void Runtime::pushChildInputs(NestedChild& child) {
+    VariableStore& childVars = child.runtime->ctx_.variables;
+    for (const auto& link : child.inputs) {
+        const Variable* from = ctx_.variables.get(link.parent);
+        const Variable* to = childVars.get(link.child);
+        // Unchanged values are skipped so the child sees no false edges
+        if (from && to && from->value() != to->value()) {
+            childVars.setExternalValue(link.child, from->value());
+        }
+    }
+}
+
+void Runtime::pullChildOutputs(NestedChild& child) {
+    const VariableStore& childVars = child.runtime->ctx_.variables;
+    for (const auto& link : child.outputs) {
+        const Variable* from = childVars.get(link.child);
+        const Variable* to = ctx_.variables.get(link.parent);
+        if (!from || !to || from->value() == to->value()) {
+            continue;
+        }
+        if (to->direction() == VariableDirection::Input) {
+            ctx_.variables.setExternalValue(link.parent, from->value());
+        } else {
+            ctx_.variables.setValue(link.parent, from->value());
+        }
+    }
+}
+
+bool Runtime::childrenRunning() const {
+    for (const NestedChild* child : activeChildren_) {
+        if (child->runtime->isRunning() || child->runtime->state() == ExecutionState::Paused) {
+            return true;
+        }
+    }
+    return false;
 }
 
 void Runtime::reportError(const std::string& error) {
@@ -894,7 +1602,7 @@ bool Value::toBool() const {
     if (is<int64_t>()) return get<int64_t>() != 0;
     if (is<float>()) return get<float>() != 0.0f;
     if (is<double>()) return get<double>() != 0.0;
-    if (is<std::string>()) return !get<std::string>().empty();
+    if (is<std::string>()) return !str().empty();
     return false;
 }
 
@@ -905,7 +1613,7 @@ int64_t Value::toInt() const {
     if (is<float>()) return static_cast<int64_t>(get<float>());
     if (is<double>()) return static_cast<int64_t>(get<double>());
     if (is<std::string>()) {
-        try { return std::stoll(get<std::string>()); }
+        try { return std::stoll(std::string(str())); }
         catch (...) { return 0; }
     }
     return 0;
@@ -918,7 +1626,7 @@ double Value::toDouble() const {
     if (is<float>()) return static_cast<double>(get<float>());
     if (is<double>()) return get<double>();
     if (is<std::string>()) {
-        try { return std::stod(get<std::string>()); }
+        try { return std::stod(std::string(str())); }
         catch (...) { return 0.0; }
     }
     return 0.0;
@@ -931,7 +1639,7 @@ std::string Value::toString() const {
     if (is<int64_t>()) return std::to_string(get<int64_t>());
     if (is<float>()) return std::to_string(get<float>());
     if (is<double>()) return std::to_string(get<double>());
-    if (is<std::string>()) return get<std::string>();
+    if (is<std::string>()) return std::string(str());
     return "[binary]";
 }
 
@@ -14,6 +14,10 @@
 
 #include "types.hpp"
 #include "model.hpp"
+#include "compiled_automata.hpp"
+#include "lua_arena.hpp"
+#include "profiler.hpp"
+#include "tick_scheduler.hpp"
 #include "variable.hpp"
 #include <memory>
 #include <random>
@@ -44,6 +48,10 @@ public:
     virtual double random() = 0;  // Returns [0.0, 1.0)
     virtual uint32_t randomInt(uint32_t max) = 0;  // Returns [0, max)
     virtual void seed(uint64_t seed) = 0;
+
+    // Opaque generator state for checkpoints; empty when it cannot be captured
+    [[nodiscard]] virtual std::vector<uint8_t> saveState() const { return {}; }
+    virtual bool restoreState(const uint8_t* data, size_t size) { (void)data; return size == 0; }
 };
 
 /**
@@ -64,8 +72,28 @@ public:
     uint32_t randomInt(uint32_t max) override;
     void seed(uint64_t seed) override;
 
+    // Seed and draws since seeding (16 bytes), then on hosts the engine state
+    // words so restore is constant-time; embedded restore replays the draws
+    [[nodiscard]] std::vector<uint8_t> saveState() const override;
+    bool restoreState(const uint8_t* data, size_t size) override;
+
 private:
-    std::mt19937_64 gen_;
+    // Counts the words drawn, which with the seed pins down the generator state
+    struct CountingGenerator {
+        using result_type = std::mt19937_64::result_type;
+        static constexpr result_type min() { return std::mt19937_64::min(); }
+        static constexpr result_type max() { return std::mt19937_64::max(); }
+        result_type operator()() {
+            ++draws;
+            return engine();
+        }
+
+        std::mt19937_64 engine;
+        uint64_t seed = 0;
+        uint64_t draws = 0;
+    };
+
+    CountingGenerator gen_;
     std::uniform_real_distribution<double> dist_;
 };
 
@@ -73,6 +101,25 @@ private:
 // Script Engine Interface
 // ============================================================================
 
+// How the script VM's garbage is collected
+enum class GcMode : uint8_t {
+    Full = 0,         // Stop-the-world collect every fullCollectTicks ticks and after each transition
+    Incremental = 1,  // VM's incremental collector, plus steps in idle time
+    Generational = 2  // Lua 5.4 generational collector, plus steps in idle time
+};
+
+struct GcPolicy {
+#if defined(ARDUINO) || defined(AETHERIUM_PLATFORM_MCXN947)
+    GcMode mode = GcMode::Full;  // Small heaps: reclaim as early as possible
+#else
+    GcMode mode = GcMode::Incremental;
+#endif
+    uint32_t fullCollectTicks = 100;  // Full mode only
+    uint32_t stepKb = 8;              // Work per step (LUA_GCSTEP size)
+    size_t watermarkBytes = 0;        // A tick above this VM heap size takes one step; 0 = off
+    uint32_t idleBudgetUs = 500;      // Most idle time spent collecting between two ticks
+};
+
 /**
  * Abstract interface for script execution (Lua)
  */
@@ -92,13 +139,34 @@ public:
     // Compute dynamic weight (returns number 0-100)
     virtual Result<double> evaluateWeight(const CodeBlock& code) = 0;
 
+    // Optional ahead-of-time compilation of every code block in a loaded automata.
+    // Blocks are identified by address, so the automata must outlive the load.
+    virtual void prepare(const Automata& automata) { (void)automata; }
+
     // Error handling
     virtual std::string lastError() const = 0;
     virtual void clearError() = 0;
     
-    // Memory management - run garbage collection
+    // Memory management - run a full garbage collection
     virtual void collectGarbage() = 0;
 
+    // Collector the VM should run between explicit steps; engines without a choice ignore it
+    virtual void setGcMode(GcMode mode) { (void)mode; }
+
+    // One bounded collection step of about `stepKb` KiB of work. Returns
+    // true when a cycle finished (or there is nothing to step).
+    virtual bool stepGarbage(uint32_t stepKb) { (void)stepKb; return true; }
+
+    // Bytes the VM heap currently holds, 0 = unknown
+    [[nodiscard]] virtual size_t memoryInUse() const { return 0; }
+
+    // Cap on the VM heap, applied from the next initialize(); 0 = unlimited.
+    // Engines without their own allocator ignore it.
+    virtual void setMemoryBudget(size_t bytes) { (void)bytes; }
+
+    // Allocator counters; all zero when the engine does not track them
+    [[nodiscard]] virtual ScriptMemoryStats memoryStats() const { return {}; }
+
     // Optional structured log sink for script-side `log(...)` calls
     virtual void setLogHandler(std::function<void(const std::string& level,
                                                   const std::string& message)> handler) = 0;
@@ -106,6 +174,34 @@ public:
     // Replay mode: suppresses setVal/setOutput variable mutations while allowing
     // hardware calls (gpio.write, pwm.write, etc.) to re-drive physical outputs.
     virtual void setReplayMode(bool enabled) { (void)enabled; }
+
+    // Total variable values copied across the script boundary (both directions)
+    [[nodiscard]] virtual uint64_t syncedValueCount() const { return 0; }
+
+    // Bytes the script VM has allocated since creation, never decreasing;
+    // the difference across a call is what that call allocated. 0 = untracked.
+    [[nodiscard]] virtual uint64_t allocatedBytes() const { return 0; }
+
+    // Fresh, uninitialized engine of the same kind, used to warm up a
+    // replacement automata off the runtime thread. nullptr = unsupported.
+    [[nodiscard]] virtual std::unique_ptr<IScriptEngine> createInstance() const { return nullptr; }
+
+    // The store given to initialize() was moved to `variables` (same
+    // contents, new address). Defaults to re-initializing.
+    virtual void rebindVariables(VariableStore* variables) { (void)initialize(variables); }
+
+    // Drop the script-side state a run left behind (globals it created or
+    // overwrote) and go back to what initialize() set up, keeping compiled
+    // code and bindings. Engines without script-side state have nothing to do.
+    virtual Result<void> resetGlobals() { return Result<void>::ok(); }
+
+    // The script's own globals (not automata variables) for checkpoints.
+    // Engines without script-side state save nothing.
+    virtual Result<std::vector<uint8_t>> saveGlobals() { return Result<std::vector<uint8_t>>::ok({}); }
+    virtual Result<void> restoreGlobals(const uint8_t* data, size_t size) {
+        (void)data;
+        return size == 0 ? Result<void>::ok() : Result<void>::error("script engine cannot restore globals");
+    }
 };
 
 // ============================================================================
@@ -129,12 +225,19 @@ struct Timer {
 };
 
 /**
- * Manages timers for timed transitions
+ * Manages timers for timed transitions.
+ *
+ * Timers live in slots indexed by TransitionId; pending (not yet fired)
+ * timers are also kept in an indexed min-heap ordered by target time, so
+ * start/cancel are O(log n) and expiry checks cost O(expired).
  */
 class TimerManager {
 public:
     explicit TimerManager(IClock* clock) : clock_(clock) {}
 
+    // Pre-size slot storage for transition ids below idLimit
+    void reserve(size_t idLimit);
+
     // Start timer for transition
     void startTimer(TransitionId id, uint32_t delayMs, uint32_t jitterMs = 0,
                     uint32_t repeatCount = 1);
@@ -148,6 +251,9 @@ public:
     // Check for expired timers
     std::vector<TransitionId> checkExpired();
 
+    // Mark expired timers as fired without collecting them; returns the count
+    size_t markExpired();
+
     // Restart timer (for repeating)
     void restartTimer(TransitionId id, uint32_t delayMs, uint32_t jitterMs = 0);
 
@@ -157,17 +263,64 @@ public:
     // Get timer info
     const Timer* getTimer(TransitionId id) const;
 
+    // Every running or fired timer, for checkpoints
+    [[nodiscard]] std::vector<Timer> snapshot() const;
+
+    // Reinstate a timer from snapshot() as is; a fired one stays out of the heap
+    void restoreTimer(const Timer& timer);
+
+    // Earliest target time among timers that have not fired yet
+    [[nodiscard]] std::optional<Timestamp> nextDeadline() const;
+
+    [[nodiscard]] size_t activeCount() const { return active_.size(); }
+
     void setRandomSource(IRandomSource* source);
     [[nodiscard]] Timestamp now() const;
 
 private:
+    static constexpr uint32_t NOT_QUEUED = 0xFFFFFFFF;
+
+    struct Slot {
+        Timer timer;
+        uint32_t heapIndex = NOT_QUEUED;    // Position in heap_ while pending
+        uint32_t activeIndex = NOT_QUEUED;  // Position in active_ while running
+    };
+
+    Slot& acquire(TransitionId id);
+    Slot* find(TransitionId id);
+    const Slot* find(TransitionId id) const;
+    void release(TransitionId id);
+
+    // Heap maintenance
+    void push(TransitionId id);
+    void erase(TransitionId id);
+    void popFront();
+    void siftUp(uint32_t index);
+    void siftDown(uint32_t index);
+    bool earlier(TransitionId a, TransitionId b) const;
+    void place(uint32_t index, TransitionId id);
+
+    int32_t randomJitter(uint32_t jitterMs);
+
     IClock* clock_;
-    std::unordered_map<TransitionId, Timer> timers_;
+    std::vector<Slot> slots_;          // Indexed by TransitionId
+    std::vector<TransitionId> heap_;   // Pending timers, earliest first
+    std::vector<TransitionId> active_; // Every running or fired timer
     IRandomSource* randomSource_ = nullptr;  // For jitter
 };
 
 class ExecutionContext;
 
+/**
+ * Serialized Runtime state, written by Runtime::checkpoint. Times inside
+ * are relative to when it was taken, so it restores onto any clock.
+ */
+struct RuntimeCheckpoint {
+    Timestamp at = 0;        // Runtime clock when taken (engines restamp it with their trace clock)
+    uint64_t tickCount = 0;
+    std::vector<uint8_t> bytes;
+};
+
 // ============================================================================
 // Transition Resolver
 // ============================================================================
@@ -181,6 +334,14 @@ struct EvaluatedTransition {
     bool conditionMet = false;  // Whether guard is satisfied
 };
 
+/**
+ * Restricts resolution to transitions whose inputs changed (reactive mode).
+ * Non-reactive transitions (timed, immediate, opaque guards) always evaluate.
+ */
+struct ReactiveFilter {
+    uint64_t sinceRevision = 0;  // VariableStore revision seen by the last resolve
+};
+
 /**
  * Resolves which transition to fire from current state
  */
@@ -188,32 +349,82 @@ class TransitionResolver {
 public:
     TransitionResolver(IScriptEngine* script, IRandomSource* random, 
                        TimerManager* timers, VariableStore* variables,
-                       const ExecutionContext* context)
-        : script_(script), random_(random), timers_(timers), variables_(variables), context_(context) {}
+                       const ExecutionContext* context, RuntimeProfile* profile = nullptr)
+        : script_(script), random_(random), timers_(timers), variables_(variables), context_(context),
+          profile_(profile) {}
 
     /**
      * Resolve which transition (if any) should fire.
      * 
      * Algorithm:
-     * 1. Get all enabled transitions from current state
-     * 2. Group by priority (lower = higher priority)
-     * 3. Evaluate conditions for highest priority group
-     * 4. If multiple enabled:
+     * 1. Walk the current state's precompiled priority groups
+     *    (lower = higher priority)
+     * 2. Evaluate conditions for highest priority group, splitting enabled
+     *    candidates from timeout fallbacks in the same pass
+     * 3. If multiple enabled:
      *    - If any has weight: probabilistic selection
      *    - Else: select first (deterministic)
-     * 5. Return selected transition or nullptr
+     * 4. Return selected transition or nullptr
+     *
+     * Candidate storage is owned by the resolver and reused across calls.
+     * With a filter, reactive transitions whose dependencies have not
+     * changed since filter->sinceRevision are treated as not enabled.
+     * Each transition is checked by the evaluator compiled for it, so
+     * there is no per-tick dispatch on its type or mode.
      */
-    const Transition* resolve(const Automata& automata, StateId currentState);
+    const Transition* resolve(const CompiledAutomata& automata, StateId currentState,
+                              const ReactiveFilter* filter = nullptr);
 
-private:
-    // Evaluate a single transition
-    EvaluatedTransition evaluate(const Transition& t);
+    /**
+     * Pre-size candidate storage so resolve() never allocates
+     */
+    void reserve(size_t maxCandidates);
 
-    // Evaluate timed transition
-    bool evaluateTimed(const Transition& t);
+    // Transitions evaluated by the last resolve()
+    [[nodiscard]] uint32_t lastEvaluated() const { return evaluated_; }
 
-    // Evaluate event transition  
-    bool evaluateEvent(const Transition& t);
+    // Guards the last resolve() answered from their native program
+    [[nodiscard]] uint32_t lastNativeGuards() const { return nativeEvaluated_; }
+
+    // Off: every guard goes to the script engine (for comparison and debugging)
+    void setNativeGuards(bool enabled) { nativeGuards_ = enabled; }
+
+private:
+    // Whether any dependency of a reactive transition changed
+    bool dependenciesChanged(const CompiledAutomata& automata,
+                             const CompiledTransition& entry, uint64_t sinceRevision) const;
+
+    friend TransitionEvaluator selectTransitionEvaluator(const Transition& t);
+    friend TriggerEvaluator selectTriggerEvaluator(const SignalTrigger& trigger);
+
+    // How an event transition combines its triggers
+    enum class TriggerJoin : uint8_t { Single, Any, All };
+
+    // Specialized evaluators, picked per transition by selectTransitionEvaluator
+    static bool evaluateImmediate(TransitionResolver& self, const CompiledAutomata& automata,
+                                  const CompiledTransition& entry, double& weight);
+    template <bool Guarded>
+    static bool evaluateClassic(TransitionResolver& self, const CompiledAutomata& automata,
+                                const CompiledTransition& entry, double& weight);
+    template <TimedMode Mode, bool Guarded>
+    static bool evaluateTimed(TransitionResolver& self, const CompiledAutomata& automata,
+                              const CompiledTransition& entry, double& weight);
+    template <TriggerJoin Join, bool Guarded>
+    static bool evaluateEvent(TransitionResolver& self, const CompiledAutomata& automata,
+                              const CompiledTransition& entry, double& weight);
+    template <bool Dynamic>
+    static bool evaluateProbabilistic(TransitionResolver& self, const CompiledAutomata& automata,
+                                      const CompiledTransition& entry, double& weight);
+
+    // Trigger evaluators, picked per trigger by selectTriggerEvaluator
+    template <EventTrigger Trigger>
+    static bool triggerFired(const TransitionResolver& self, const CompiledTrigger& trigger);
+    template <CompareOp Op>
+    static bool thresholdCrossed(const TransitionResolver& self, const CompiledTrigger& trigger);
+    static bool triggerNever(const TransitionResolver& self, const CompiledTrigger& trigger);
+
+    // Run a guard natively when it compiled, else through the script engine
+    bool checkGuard(const Transition& t, const CodeBlock& code, ArrayView<GuardInstr> guard);
 
     // Select from weighted transitions
     const Transition* selectWeighted(const std::vector<EvaluatedTransition>& candidates);
@@ -223,6 +434,14 @@ private:
     TimerManager* timers_;
     VariableStore* variables_;
     const ExecutionContext* context_;
+    RuntimeProfile* profile_;  // Per-guard latency when profiling is built in
+
+    // Reused per resolve: enabled candidates and timeout fallbacks
+    std::vector<EvaluatedTransition> candidates_;
+    std::vector<EvaluatedTransition> fallbacks_;
+    uint32_t evaluated_ = 0;
+    uint32_t nativeEvaluated_ = 0;
+    bool nativeGuards_ = true;
 };
 
 // ============================================================================
@@ -255,6 +474,9 @@ public:
     Timestamp stateEntryTime = 0;
     Timestamp lastTickTime = 0;
     uint64_t stateEntryTickCount = 0;  // tickCount when the current state was entered
+    uint32_t scriptValuesSynced = 0;   // Values synced with the script engine during the last tick
+    uint32_t transitionsEvaluated = 0; // Outgoing transitions evaluated during the last tick
+    uint32_t nativeGuards = 0;         // Guards of those answered without the script engine
 
     // Variable store
     VariableStore variables;
@@ -268,6 +490,19 @@ public:
     }
 };
 
+/**
+ * A replacement automata compiled and warmed up against its own script
+ * engine and variable store, ready for Runtime::swapIn. Built by
+ * Runtime::prepare, which touches no runtime state and so may run on
+ * another thread. The automata must outlive the swapped-in run.
+ */
+struct PreparedLoad {
+    const Automata* automata = nullptr;
+    CompiledAutomata compiled;
+    std::unique_ptr<IScriptEngine> script;
+    std::unique_ptr<VariableStore> variables;
+};
+
 // ============================================================================
 // Event Callbacks
 // ============================================================================
@@ -275,16 +510,44 @@ public:
 using StateChangeCallback = std::function<void(StateId from, StateId to, 
                                                 TransitionId via)>;
 using OutputChangeCallback = std::function<void(const Variable& var)>;
+// Outputs changed since the last publish, in first-change order
+using OutputBatchCallback = std::function<void(const std::vector<const Variable*>& outputs)>;
 using ErrorCallback = std::function<void(const std::string& error)>;
 using DebugCallback = std::function<void(const std::string& message)>;
 
 struct RuntimeCallbacks {
     StateChangeCallback onStateChange;
-    OutputChangeCallback onOutputChange;
+    OutputChangeCallback onOutputChange;  // Per write, as it happens
+    OutputBatchCallback onOutputBatch;    // Once per tick, from the change journal
     ErrorCallback onError;
     DebugCallback onDebug;
 };
 
+// ============================================================================
+// Nested Automata
+// ============================================================================
+
+/**
+ * Links a parent variable to a child variable by name. The child's
+ * direction decides the flow: an input is copied in from the parent before
+ * the child ticks, an output is copied out to the parent after it.
+ */
+struct NestedBinding {
+    std::string parent;
+    std::string child;
+};
+
+struct NestedChild;  // Defined in runtime.cpp
+
+// ============================================================================
+// Tick Mode
+// ============================================================================
+
+enum class TickMode : uint8_t {
+    Polling = 0,   // Evaluate every outgoing transition on every tick
+    Reactive = 1,  // Re-evaluate a transition only when its inputs change
+};
+
 // ============================================================================
 // Runtime Engine
 // ============================================================================
@@ -330,7 +593,8 @@ public:
     Result<void> resume();
 
     /**
-     * Reset to initial state
+     * Reset to initial state. Script globals go back to their post-load
+     * baseline in place; the script VM is not rebuilt.
      */
     Result<void> reset();
 
@@ -339,6 +603,64 @@ public:
      */
     void unload();
 
+    /**
+     * Compile `automata` and initialize + prepare `script` against a shadow
+     * store. Thread-safe: uses nothing but its arguments.
+     */
+    static Result<std::unique_ptr<PreparedLoad>> prepare(const Automata& automata,
+                                                         std::unique_ptr<IScriptEngine> script);
+
+    /**
+     * Replace the loaded automata with a prepared one without stopping.
+     * Variables whose name, type and direction match keep their values;
+     * a running or paused run stays in the state of the same name (no
+     * hooks fire) or enters the new initial state if there is none.
+     * Afterwards `prepared` holds the old script engine, store and
+     * compiled tables so the caller decides when to free them.
+     */
+    Result<RunId> swapIn(PreparedLoad& prepared);
+
+    // Script engine for prepare() (nullptr if unsupported): a pre-warmed
+    // spare if there is one, otherwise a fresh uninitialized instance
+    [[nodiscard]] std::unique_ptr<IScriptEngine> createScriptEngine();
+
+    /**
+     * Keep up to `count` script engines initialized ahead of time (VM up,
+     * builtins bound, no store) for createScriptEngine(), so preparing a
+     * hot swap reuses a VM instead of building one. 0 drops the spares.
+     */
+    void warmScriptEngines(size_t count);
+
+    // A script engine done with its run (e.g. swapped out). Reset to its
+    // baseline and kept as a spare while there is room, freed otherwise.
+    void recycleScriptEngine(std::unique_ptr<IScriptEngine> script);
+    [[nodiscard]] size_t spareScriptEngines() const { return spareScripts_.size(); }
+
+    // Wall time the last reset() spent putting the script globals back
+    [[nodiscard]] uint64_t lastScriptResetUs() const { return lastScriptResetUs_; }
+
+    // RunId the next load() or swapIn() will assign
+    [[nodiscard]] RunId nextRunId() const { return nextRunId_; }
+
+    // ========================================================================
+    // Nested Automata
+    // ========================================================================
+
+    /**
+     * Run `child` in-process while `parentState` is current: it starts from
+     * its initial state on entry (after the parent's on_enter), stops on
+     * exit (before the parent's on_exit) and ticks just ahead of this
+     * runtime on the same clock. Children of other states are not touched
+     * per tick. A child may itself have children. load, swapIn and unload
+     * drop all children; `child` must outlive them.
+     */
+    Result<size_t> addChild(StateId parentState, const Automata& child,
+                            const std::vector<NestedBinding>& bindings);
+
+    [[nodiscard]] size_t childCount() const { return children_.size(); }
+    [[nodiscard]] size_t activeChildCount() const { return activeChildren_.size(); }
+    [[nodiscard]] Runtime* child(size_t index);
+
     // ========================================================================
     // Execution
     // ========================================================================
@@ -351,10 +673,25 @@ public:
 
     /**
      * Run continuously until stopped.
-     * Blocking call.
+     * Blocking call. Sleeps until the next tick slot or timer deadline,
+     * whichever comes first.
      */
     void run();
 
+    /**
+     * Milliseconds until the earliest pending timer (0 if already due);
+     * nullopt when no timer is pending or the runtime is not running.
+     */
+    [[nodiscard]] std::optional<uint32_t> msUntilNextTimer();
+
+    /**
+     * Incremental script GC for idle time between ticks: steps for at most
+     * min(budgetUs, policy idleBudgetUs), stopping early once a cycle
+     * completes. Does nothing in Full mode or when no tick ran since the
+     * last completed cycle. Returns true if it stepped.
+     */
+    bool collectGarbageIdle(uint32_t budgetUs);
+
     // ========================================================================
     // Input/Output
     // ========================================================================
@@ -364,6 +701,8 @@ public:
      */
     Result<void> setInput(const std::string& name, Value value);
     Result<void> setInput(VariableId id, Value value);
+    // All-or-nothing batch; repeated ids keep their last value
+    Result<void> setInputs(const std::vector<VariableUpdate>& inputs);
     Result<void> setVariable(const std::string& name, Value value);
     Result<void> setVariable(VariableId id, Value value);
 
@@ -378,6 +717,15 @@ public:
      */
     std::vector<std::pair<std::string, Value>> getChangedOutputs();
 
+    /**
+     * Hand the outputs in the variable change journal to onOutputBatch and
+     * clear the journal. Runs after each tick, start, stop and restore;
+     * call it after writing variables outside those.
+     */
+    void publishOutputs();
+    // Skip outputs that are back at their pre-tick value when published
+    void setSuppressOutputFlips(bool suppress) { suppressOutputFlips_ = suppress; }
+
     // ========================================================================
     // State Queries
     // ========================================================================
@@ -385,6 +733,8 @@ public:
     [[nodiscard]] ExecutionState state() const { return ctx_.state; }
     [[nodiscard]] StateId currentState() const { return ctx_.currentState; }
     [[nodiscard]] const ExecutionContext& context() const { return ctx_; }
+    // Current time on the injected clock
+    [[nodiscard]] Timestamp now() const { return clock_->now(); }
     [[nodiscard]] bool isRunning() const { 
         return ctx_.state == ExecutionState::Running; 
     }
@@ -405,6 +755,21 @@ public:
     Result<void> restoreState(const std::string& stateName,
                               const std::vector<std::pair<std::string, Value>>& variables);
 
+    /**
+     * Capture the whole run as a binary checkpoint: counters, current
+     * state, every variable, timers as time remaining, the random source
+     * and the script globals (see checkpoint.hpp). Running or Paused only.
+     */
+    Result<RuntimeCheckpoint> checkpoint();
+
+    /**
+     * Continue from a checkpoint taken with the same automata loaded.
+     * Like restoreState, only the restored state's onEnter runs, in replay
+     * mode, to re-drive hardware; children start over. The run ends up
+     * Running or Paused as it was when the checkpoint was taken.
+     */
+    Result<void> restoreCheckpoint(const RuntimeCheckpoint& checkpoint);
+
     // ========================================================================
     // Callbacks
     // ========================================================================
@@ -421,13 +786,69 @@ public:
     void setMaxTickRate(uint32_t ticksPerSecond) { 
         maxTickRate_ = ticksPerSecond; 
     }
+    [[nodiscard]] uint32_t maxTickRate() const { return maxTickRate_; }
+
+    /**
+     * Select polling or reactive transition scheduling. State bodies run
+     * every tick in both modes.
+     */
+    void setTickMode(TickMode mode) {
+        tickMode_ = mode;
+        reactiveResync_ = true;
+    }
+    [[nodiscard]] TickMode tickMode() const { return tickMode_; }
+
+    /**
+     * Evaluate guards in the native subset (see native_guard.hpp) without
+     * the script engine. On by default.
+     */
+    void setNativeGuards(bool enabled) {
+        nativeGuards_ = enabled;
+        if (resolver_) {
+            resolver_->setNativeGuards(enabled);
+        }
+    }
+    [[nodiscard]] bool nativeGuards() const { return nativeGuards_; }
+
+    // Transitions of the loaded automata whose guard compiled natively
+    [[nodiscard]] size_t nativeGuardCount() const { return compiled_.nativeGuardCount(); }
+
+    // Index form of the loaded automata
+    [[nodiscard]] const CompiledAutomata& compiled() const { return compiled_; }
 
     /**
      * Set random seed for reproducibility
      */
     void setSeed(uint64_t seed) { random_->seed(seed); }
 
+    // Applies to the current script engine and those installed later
+    void setGcPolicy(const GcPolicy& policy);
+    [[nodiscard]] const GcPolicy& gcPolicy() const { return gcPolicy_; }
+
+    // Script heap cap per automaton, effective from the next load; 0 = unlimited
+    void setScriptMemoryBudget(size_t bytes) {
+        scriptMemoryBudget_ = bytes;
+        if (script_) {
+            script_->setMemoryBudget(bytes);
+        }
+    }
+    [[nodiscard]] ScriptMemoryStats scriptMemory() const {
+        return script_ ? script_->memoryStats() : ScriptMemoryStats{};
+    }
+
+    // ========================================================================
+    // Profiling
+    // ========================================================================
+
+    // Phase totals, tick/guard latency and per-code-block script cost since
+    // the last reset or load (zeros when built with AETHERIUM_PROFILING=0)
+    [[nodiscard]] const RuntimeProfile& profile() const { return profile_; }
+    void resetProfile() { profile_.reset(); }
+
 private:
+    // Single tick body; tick() wraps it with per-tick accounting
+    bool step();
+
     // Execute state hooks
     void executeOnEnter(const State& state);
     void executeOnExit(const State& state);
@@ -439,10 +860,26 @@ private:
     void setupTimersForState(const State& state);
     void cancelTimersForState(StateId stateId);
 
+    // Apply staged hardware writes (see BufferedHardwareService)
+    void flushActuation();
+
+    // Nested automata of the current state
+    void enterChildren(StateId stateId);
+    void exitChildren();
+    void tickChildren();
+    void dropChildren();
+    void pushChildInputs(NestedChild& child);
+    void pullChildOutputs(NestedChild& child);
+    [[nodiscard]] bool childrenRunning() const;
+
     // Error handling
     void reportError(const std::string& error);
     void debug(const std::string& message);
 
+    // Wiring for a newly installed store / script engine
+    void watchOutputs();
+    void installScriptLogHandler();
+
     // Components
     std::unique_ptr<IClock> clock_;
     std::unique_ptr<IRandomSource> random_;
@@ -453,6 +890,7 @@ private:
     // Context
     ExecutionContext ctx_;
     const Automata* automata_ = nullptr;
+    CompiledAutomata compiled_;
     RunId nextRunId_ = 1;
 
     // Callbacks
@@ -460,75 +898,121 @@ private:
 
     // Configuration
     uint32_t maxTickRate_ = 0;
+    TickMode tickMode_ = TickMode::Polling;
+    uint64_t reactiveRevision_ = 0;  // Variable revision seen by the last resolve
+    bool reactiveResync_ = true;     // Evaluate everything on the next tick
+    bool suppressOutputFlips_ = false;
+    std::vector<const Variable*> publishedOutputs_;  // Reused by publishOutputs
+    bool nativeGuards_ = true;
     bool running_ = false;
     Timestamp pausedAt_ = 0;
+    GcPolicy gcPolicy_;
+    size_t scriptMemoryBudget_ = 0;
+    std::vector<std::unique_ptr<IScriptEngine>> spareScripts_;  // Pre-warmed, see warmScriptEngines()
+    size_t spareScriptLimit_ = 0;
+    uint64_t lastScriptResetUs_ = 0;
+    uint64_t gcCycleTick_ = 0;  // tickCount when the last idle cycle completed
+
+    RuntimeProfile profile_;
+
+    std::vector<std::unique_ptr<NestedChild>> children_;
+    std::vector<NestedChild*> activeChildren_;  // Only these are ticked
 };
 
 // ============================================================================
 // Implementation: TimerManager
 // ============================================================================
 
+inline void TimerManager::reserve(size_t idLimit) {
+    if (slots_.size() < idLimit) {
+        slots_.resize(idLimit);
+    }
+    heap_.reserve(idLimit);
+    active_.reserve(idLimit);
+}
+
 inline void TimerManager::startTimer(TransitionId id, uint32_t delayMs, 
                                      uint32_t jitterMs, uint32_t repeatCount) {
-    Timer t;
+    Slot& slot = acquire(id);
+    Timer& t = slot.timer;
     t.transitionId = id;
     t.startTime = clock_->now();
-    
-    // Apply jitter
-    int32_t jitter = 0;
-    if (jitterMs > 0 && randomSource_) {
-        jitter = static_cast<int32_t>(randomSource_->randomInt(jitterMs * 2)) - 
-                 static_cast<int32_t>(jitterMs);
-    }
-    
-    t.targetTime = t.startTime + delayMs + jitter;
+    t.targetTime = t.startTime + delayMs + randomJitter(jitterMs);
     t.repeatCount = repeatCount;
     t.currentRepeat = 0;
     t.fired = false;
-    
-    timers_[id] = t;
+
+    if (slot.heapIndex == NOT_QUEUED) {
+        push(id);
+    } else {
+        // Restarted while pending: the target may have moved either way
+        siftUp(slot.heapIndex);
+        siftDown(slots_[id].heapIndex);
+    }
 }
 
 inline void TimerManager::cancelTimer(TransitionId id) {
-    timers_.erase(id);
+    release(id);
 }
 
 inline void TimerManager::cancelAll() {
-    timers_.clear();
+    for (TransitionId id : active_) {
+        Slot& slot = slots_[id];
+        slot.heapIndex = NOT_QUEUED;
+        slot.activeIndex = NOT_QUEUED;
+    }
+    active_.clear();
+    heap_.clear();
 }
 
 inline std::vector<TransitionId> TimerManager::checkExpired() {
     std::vector<TransitionId> expired;
-    Timestamp now = clock_->now();
-    
-    for (auto& [id, timer] : timers_) {
-        if (timer.isExpired(now)) {
-            expired.push_back(id);
-            timer.fired = true;
-        }
+    const Timestamp now = clock_->now();
+
+    while (!heap_.empty() && slots_[heap_.front()].timer.isExpired(now)) {
+        const TransitionId id = heap_.front();
+        slots_[id].timer.fired = true;
+        popFront();
+        expired.push_back(id);
     }
-    
+
+    return expired;
+}
+
+inline size_t TimerManager::markExpired() {
+    size_t expired = 0;
+    const Timestamp now = clock_->now();
+
+    while (!heap_.empty() && slots_[heap_.front()].timer.isExpired(now)) {
+        slots_[heap_.front()].timer.fired = true;
+        popFront();
+        ++expired;
+    }
+
     return expired;
 }
 
 inline void TimerManager::restartTimer(TransitionId id, uint32_t delayMs, 
                                        uint32_t jitterMs) {
-    auto it = timers_.find(id);
-    if (it != timers_.end()) {
-        Timer& t = it->second;
-        if (t.repeatCount == 0 || t.currentRepeat < t.repeatCount - 1) {
-            t.currentRepeat++;
-            t.startTime = clock_->now();
-            int32_t jitter = 0;
-            if (jitterMs > 0 && randomSource_) {
-                jitter = static_cast<int32_t>(randomSource_->randomInt(jitterMs * 2)) -
-                         static_cast<int32_t>(jitterMs);
-            }
-            t.targetTime = t.startTime + delayMs + jitter;
-            t.fired = false;
+    Slot* slot = find(id);
+    if (!slot) {
+        return;
+    }
+
+    Timer& t = slot->timer;
+    if (t.repeatCount == 0 || t.currentRepeat < t.repeatCount - 1) {
+        t.currentRepeat++;
+        t.startTime = clock_->now();
+        t.targetTime = t.startTime + delayMs + randomJitter(jitterMs);
+        t.fired = false;
+        if (slot->heapIndex == NOT_QUEUED) {
+            push(id);
         } else {
-            timers_.erase(it);
+            siftUp(slot->heapIndex);
+            siftDown(slots_[id].heapIndex);
         }
+    } else {
+        release(id);
     }
 }
 
@@ -536,15 +1020,42 @@ inline void TimerManager::shiftAll(uint32_t deltaMs) {
     if (deltaMs == 0) {
         return;
     }
-    for (auto& [id, timer] : timers_) {
+    // A uniform shift keeps heap order intact.
+    for (TransitionId id : active_) {
+        Timer& timer = slots_[id].timer;
         timer.startTime += deltaMs;
         timer.targetTime += deltaMs;
     }
 }
 
 inline const Timer* TimerManager::getTimer(TransitionId id) const {
-    auto it = timers_.find(id);
-    return it != timers_.end() ? &it->second : nullptr;
+    const Slot* slot = find(id);
+    return slot ? &slot->timer : nullptr;
+}
+
+inline std::vector<Timer> TimerManager::snapshot() const {
+    std::vector<Timer> timers;
+    timers.reserve(active_.size());
+    for (TransitionId id : active_) {
+        timers.push_back(slots_[id].timer);
+    }
+    return timers;
+}
+
+inline void TimerManager::restoreTimer(const Timer& timer) {
+    release(timer.transitionId);
+    Slot& slot = acquire(timer.transitionId);
+    slot.timer = timer;
+    if (!timer.fired) {
+        push(timer.transitionId);
+    }
+}
+
+inline std::optional<Timestamp> TimerManager::nextDeadline() const {
+    if (heap_.empty()) {
+        return std::nullopt;
+    }
+    return slots_[heap_.front()].timer.targetTime;
 }
 
 inline void TimerManager::setRandomSource(IRandomSource* source) {
@@ -555,6 +1066,126 @@ inline Timestamp TimerManager::now() const {
     return clock_->now();
 }
 
+inline TimerManager::Slot& TimerManager::acquire(TransitionId id) {
+    if (id >= slots_.size()) {
+        slots_.resize(static_cast<size_t>(id) + 1);
+    }
+    Slot& slot = slots_[id];
+    if (slot.activeIndex == NOT_QUEUED) {
+        slot.activeIndex = static_cast<uint32_t>(active_.size());
+        active_.push_back(id);
+    }
+    return slot;
+}
+
+inline TimerManager::Slot* TimerManager::find(TransitionId id) {
+    if (id >= slots_.size() || slots_[id].activeIndex == NOT_QUEUED) {
+        return nullptr;
+    }
+    return &slots_[id];
+}
+
+inline const TimerManager::Slot* TimerManager::find(TransitionId id) const {
+    if (id >= slots_.size() || slots_[id].activeIndex == NOT_QUEUED) {
+        return nullptr;
+    }
+    return &slots_[id];
+}
+
+inline void TimerManager::release(TransitionId id) {
+    Slot* slot = find(id);
+    if (!slot) {
+        return;
+    }
+    if (slot->heapIndex != NOT_QUEUED) {
+        erase(id);
+    }
+
+    // Swap-remove from the active list
+    const uint32_t index = slot->activeIndex;
+    const TransitionId last = active_.back();
+    active_[index] = last;
+    slots_[last].activeIndex = index;
+    active_.pop_back();
+    slot->activeIndex = NOT_QUEUED;
+}
+
+inline void TimerManager::push(TransitionId id) {
+    heap_.push_back(id);
+    const auto index = static_cast<uint32_t>(heap_.size() - 1);
+    slots_[id].heapIndex = index;
+    siftUp(index);
+}
+
+inline void TimerManager::erase(TransitionId id) {
+    const uint32_t index = slots_[id].heapIndex;
+    const TransitionId last = heap_.back();
+    heap_.pop_back();
+    slots_[id].heapIndex = NOT_QUEUED;
+    if (last == id) {
+        return;
+    }
+    place(index, last);
+    siftUp(index);
+    siftDown(slots_[last].heapIndex);
+}
+
+inline void TimerManager::popFront() {
+    erase(heap_.front());
+}
+
+inline void TimerManager::siftUp(uint32_t index) {
+    const TransitionId id = heap_[index];
+    while (index > 0) {
+        const uint32_t parent = (index - 1) / 2;
+        if (!earlier(id, heap_[parent])) {
+            break;
+        }
+        place(index, heap_[parent]);
+        index = parent;
+    }
+    place(index, id);
+}
+
+inline void TimerManager::siftDown(uint32_t index) {
+    const TransitionId id = heap_[index];
+    const auto size = static_cast<uint32_t>(heap_.size());
+    while (true) {
+        uint32_t child = 2 * index + 1;
+        if (child >= size) {
+            break;
+        }
+        if (child + 1 < size && earlier(heap_[child + 1], heap_[child])) {
+            ++child;
+        }
+        if (!earlier(heap_[child], id)) {
+            break;
+        }
+        place(index, heap_[child]);
+        index = child;
+    }
+    place(index, id);
+}
+
+inline bool TimerManager::earlier(TransitionId a, TransitionId b) const {
+    const Timestamp ta = slots_[a].timer.targetTime;
+    const Timestamp tb = slots_[b].timer.targetTime;
+    return ta < tb || (ta == tb && a < b);
+}
+
+inline void TimerManager::place(uint32_t index, TransitionId id) {
+    heap_[index] = id;
+    slots_[id].heapIndex = index;
+}
+
+inline int32_t TimerManager::randomJitter(uint32_t jitterMs) {
+    if (jitterMs == 0 || !randomSource_) {
+        return 0;
+    }
+    return static_cast<int32_t>(randomSource_->randomInt(jitterMs * 2)) -
+           static_cast<int32_t>(jitterMs);
+}
+
 // ============================================================================
 // Implementation: ExecutionContext
 // ============================================================================
@@ -569,6 +1200,9 @@ inline void ExecutionContext::reset() {
     errorCount = 0;
     stateEntryTime = 0;
     stateEntryTickCount = 0;
+    scriptValuesSynced = 0;
+    transitionsEvaluated = 0;
+    nativeGuards = 0;
     variables.resetAll();
 }
 
@@ -2,19 +2,31 @@
  * Aetherium Automata - Script Engine Implementation
  * 
  * Basic script engine for condition evaluation and code execution.
- * Currently implements a simple expression evaluator.
- * TODO: Full Lua integration for production use.
+ * Code blocks carrying script VM chunks (script_vm.hpp) run on the VM;
+ * anything else goes through a simple expression evaluator.
  */
 
 #ifndef AETHERIUM_SCRIPT_ENGINE_HPP
 #define AETHERIUM_SCRIPT_ENGINE_HPP
 
 #include "runtime.hpp"
+#include "script_vm.hpp"
 #include <sstream>
 #include <regex>
 #include <optional>
+#include <unordered_map>
 #include <vector>
 
+// Compile VM chunks in prepare() for blocks loaded from source. Embedded
+// targets expect them precompiled in the artifact instead.
+#ifndef AETHERIUM_SCRIPT_VM_COMPILE_ON_LOAD
+#if defined(ARDUINO) || defined(AETHERIUM_PLATFORM_MCXN947)
+#define AETHERIUM_SCRIPT_VM_COMPILE_ON_LOAD 0
+#else
+#define AETHERIUM_SCRIPT_VM_COMPILE_ON_LOAD 1
+#endif
+#endif
+
 namespace aeth {
 
 /**
@@ -30,19 +42,69 @@ public:
         return Result<void>::ok();
     }
 
+    std::unique_ptr<IScriptEngine> createInstance() const override {
+        return std::make_unique<SimpleScriptEngine>();
+    }
+
+    void rebindVariables(VariableStore* variables) override { variables_ = variables; }
+
+    void prepare(const Automata& automata) override {
+        prepared_.clear();
+#if AETHERIUM_SCRIPT_VM_COMPILE_ON_LOAD
+        auto compile = [&](const CodeBlock& code, CodeKind contextual) {
+            const CodeKind kind = code.resolvedKind(contextual);
+            const uint8_t* body = nullptr;
+            size_t size = 0;
+            if (code.isEmpty() || scriptVmChunk(code, kind, body, size)) {
+                return;
+            }
+            auto chunk = compileScriptVm(code.text(), kind, automata.variables);
+            if (chunk.isOk()) {  // Otherwise the expression evaluator handles it
+                prepared_[&code] = PreparedChunk{code.text(), kind, std::move(chunk.value())};
+            }
+        };
+
+        for (const auto& [id, state] : automata.states) {
+            compile(state.onEnter, CodeKind::Statement);
+            compile(state.body, CodeKind::Statement);
+            compile(state.onExit, CodeKind::Statement);
+        }
+        for (const auto& [id, transition] : automata.transitions) {
+            compile(transition.classicConfig.condition, CodeKind::Expression);
+            compile(transition.timedConfig.additionalCondition, CodeKind::Expression);
+            compile(transition.eventConfig.additionalCondition, CodeKind::Expression);
+            compile(transition.probConfig.weightExpression, CodeKind::Expression);
+            compile(transition.body, CodeKind::Statement);
+            compile(transition.triggered, CodeKind::Statement);
+        }
+#else
+        (void)automata;
+#endif
+    }
+
+    void setReplayMode(bool enabled) override { replayMode_ = enabled; }
+
     Result<Value> execute(const CodeBlock& code) override {
         if (code.isEmpty()) {
             return Result<Value>::ok(Value());
         }
 
+        ScriptVmResult run;
+        if (runVm(code, CodeKind::Statement, run)) {
+            if (!run.ok) {
+                return Result<Value>::error(lastError_);
+            }
+            return Result<Value>::ok(run.returned ? Value(run.value) : Value());
+        }
+
         // For now, just log execution and return void
         // Full Lua implementation would go here
-        lastExecution_ = code.source;
+        lastExecution_ = code.text();
         
         // Try to parse simple assignments: varname = value
         std::regex assignRegex(R"((\w+)\s*=\s*(.+))");
         std::smatch match;
-        if (std::regex_match(code.source, match, assignRegex)) {
+        if (std::regex_match(code.text(), match, assignRegex)) {
             std::string varName = match[1];
             std::string valueStr = match[2];
             
@@ -61,7 +123,15 @@ public:
             return Result<bool>::ok(true);  // Empty condition is always true
         }
 
-        return evaluateExpr(code.source);
+        ScriptVmResult run;
+        if (runVm(code, CodeKind::Expression, run)) {
+            if (!run.ok) {
+                return Result<bool>::error(lastError_);
+            }
+            return Result<bool>::ok(run.value != 0.0);
+        }
+
+        return evaluateExpr(code.text());
     }
 
     Result<double> evaluateWeight(const CodeBlock& code) override {
@@ -69,9 +139,17 @@ public:
             return Result<double>::ok(100.0);
         }
 
+        ScriptVmResult run;
+        if (runVm(code, CodeKind::Expression, run)) {
+            if (!run.ok) {
+                return Result<double>::error(lastError_);
+            }
+            return Result<double>::ok(run.value);
+        }
+
         // Try to parse as number
         try {
-            double val = std::stod(code.source);
+            double val = std::stod(code.text());
             return Result<double>::ok(val);
         } catch (...) {
             // Not a number, try evaluating as expression
@@ -79,7 +157,7 @@ public:
 
         // Try to get from variable
         if (variables_) {
-            auto varValue = variables_->getValue(code.source);
+            auto varValue = variables_->getValue(code.text());
             if (varValue) {
                 return Result<double>::ok(varValue->toDouble());
             }
@@ -106,6 +184,36 @@ public:
     }
 
 private:
+    struct PreparedChunk {
+        std::string source;
+        CodeKind kind = CodeKind::Statement;
+        std::vector<uint8_t> body;
+    };
+
+    // Run `code` on the VM if it has a chunk: its own or one from prepare()
+    bool runVm(const CodeBlock& code, CodeKind contextual, ScriptVmResult& run) {
+        const CodeKind kind = code.resolvedKind(contextual);
+        const uint8_t* body = nullptr;
+        size_t size = 0;
+        if (!variables_) {
+            return false;
+        }
+        if (!scriptVmChunk(code, kind, body, size)) {
+            auto it = prepared_.find(&code);
+            // Keyed by address; the source check catches a rewritten block
+            if (it == prepared_.end() || it->second.kind != kind || it->second.source != code.text()) {
+                return false;
+            }
+            body = it->second.body.data();
+            size = it->second.body.size();
+        }
+        run = runScriptVm(body, size, *variables_, replayMode_);
+        if (!run.ok) {
+            lastError_ = run.error;
+        }
+        return true;
+    }
+
     static std::string trimCopy(const std::string& input) {
         const auto begin = input.find_first_not_of(" \t\n\r");
         if (begin == std::string::npos) {
@@ -463,6 +571,8 @@ private:
     std::string lastError_;
     std::string lastExecution_;
     std::function<void(const std::string&, const std::string&)> logHandler_;
+    std::unordered_map<const CodeBlock*, PreparedChunk> prepared_;
+    bool replayMode_ = false;
 };
 
 } // namespace aeth
@@ -0,0 +1,1040 @@
+/**
+ * Aetherium Automata - Script VM
+ *
+ * Register VM for builds without Lua. Code blocks are compiled ahead of
+ * time (compileScriptVmChunks, next to precompileLuaChunks) and travel in
+ * the same chunk section of the bytecode artifact, under their own
+ * pseudo-target, so a Lua engine always falls back to source for them.
+ * The VM runs a chunk in place from the code block's bytes with a fixed
+ * register file on the C stack: a call allocates nothing.
+ *
+ * Language: a Lua subset over numbers and booleans (false and 0 are
+ * false; and/or/not yield booleans).
+ * - Statements: `local x = e`, `name = e`, if/elseif/else/end, return,
+ *   setVal/setOutput("name", e), gpio.mode/write, pwm.attach/write,
+ *   dac.write
+ * - Expressions: literals, locals, automata variables, getVal/value/
+ *   getInput("name"), changed/check("name"), + - * / %, comparisons,
+ *   and/or/not, gpio.read, adc.read/read_mv, clamp, math.abs/min/max/floor
+ * There are no loops, so any chunk finishes in at most its length.
+ *
+ * Chunk body (after the chunk tag): u8 registers, u8 constants,
+ * u16 instructions, constants as big-endian IEEE doubles, then 4-byte
+ * instructions {op, a, b, c}; bx = b << 8 | c.
+ */
+
+#ifndef AETHERIUM_SCRIPT_VM_HPP
+#define AETHERIUM_SCRIPT_VM_HPP
+
+#include "artifact.hpp"
+#include "hardware_service.hpp"
+#include "lua_chunk.hpp"
+#include "model.hpp"
+#include "variable.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace aeth {
+
+// Pseudo Lua version 0xAE01 marks VM chunks; doubles, 32-bit pin/duty arguments
+constexpr LuaChunkTarget SCRIPT_VM_TARGET{0xAE01, 0, 4, 8};
+
+constexpr size_t SCRIPT_VM_MAX_REGISTERS = 32;
+constexpr size_t SCRIPT_VM_MAX_CONSTANTS = 255;
+constexpr size_t SCRIPT_VM_HEADER_SIZE = 4;
+constexpr size_t SCRIPT_VM_INSTR_SIZE = 4;
+
+enum class VmOp : uint8_t {
+    LoadK = 0,       // R[a] = K[bx]
+    LoadVar = 1,     // R[a] = variable bx
+    Changed = 2,     // R[a] = variable bx changed
+    StoreVar = 3,    // variable bx = R[a]
+    Move = 4,        // R[a] = R[b]
+    Add = 5,         // R[a] = R[b] op R[c] ...
+    Sub = 6,
+    Mul = 7,
+    Div = 8,
+    Mod = 9,
+    Eq = 10,
+    Ne = 11,
+    Lt = 12,
+    Le = 13,
+    And = 14,
+    Or = 15,
+    Neg = 16,        // R[a] = -R[b]
+    Not = 17,        // R[a] = not R[b]
+    Jmp = 18,        // pc += bx (forward only)
+    JmpIfNot = 19,   // if not R[a]: pc += bx
+    Call = 20,       // R[a] = builtin b (R[c], R[c + 1], ...)
+    Return = 21,     // return R[a]
+    ReturnNone = 22
+};
+
+enum class VmBuiltin : uint8_t {
+    GpioMode = 0,
+    GpioWrite = 1,
+    GpioRead = 2,
+    PwmAttach = 3,
+    PwmWrite = 4,
+    AdcRead = 5,
+    AdcReadMv = 6,
+    DacWrite = 7,
+    Clamp = 8,
+    Abs = 9,
+    Min = 10,
+    Max = 11,
+    Floor = 12,
+    Count = 13
+};
+
+struct ScriptVmResult {
+    bool ok = true;
+    bool returned = false;  // A return statement supplied `value`
+    double value = 0.0;
+    const char* error = nullptr;  // Static text; set when !ok
+};
+
+/**
+ * Compile one code block. Expression blocks are compiled as
+ * `return (<source>)`. `variables` is any range of records with id, name,
+ * type and direction (std::vector of VariableSpec or ir::BytecodeVariable).
+ */
+template <typename Variables>
+Result<std::vector<uint8_t>> compileScriptVm(std::string_view source, CodeKind kind, const Variables& variables);
+
+/**
+ * Compile every code block of a program into VM chunks, replacing any
+ * Lua chunks. Fails on the first block outside the VM language.
+ */
+Result<void> compileScriptVmChunks(ir::EngineBytecodeProgram& program);
+
+/**
+ * VM chunk body of a code block compiled for `kind`, if it carries one
+ */
+bool scriptVmChunk(const CodeBlock& code, CodeKind kind, const uint8_t*& body, size_t& size);
+
+// Run a chunk body. In replay mode variable writes are skipped; hardware calls still run.
+ScriptVmResult runScriptVm(const uint8_t* body, size_t size, VariableStore& variables, bool replay = false);
+
+// ============================================================================
+// Implementation: Compiler
+// ============================================================================
+
+namespace detail {
+
+struct VmBuiltinSpec {
+    const char* table;  // nullptr for globals
+    const char* name;
+    VmBuiltin id;
+    uint8_t argc;
+    bool returnsValue;
+};
+
+inline const VmBuiltinSpec* findVmBuiltin(std::string_view table, std::string_view name) {
+    static const VmBuiltinSpec specs[] = {
+        {"gpio", "mode", VmBuiltin::GpioMode, 2, false},
+        {"gpio", "write", VmBuiltin::GpioWrite, 2, false},
+        {"gpio", "read", VmBuiltin::GpioRead, 1, true},
+        {"pwm", "attach", VmBuiltin::PwmAttach, 4, false},
+        {"pwm", "write", VmBuiltin::PwmWrite, 2, false},
+        {"adc", "read", VmBuiltin::AdcRead, 1, true},
+        {"adc", "read_mv", VmBuiltin::AdcReadMv, 1, true},
+        {"dac", "write", VmBuiltin::DacWrite, 2, false},
+        {nullptr, "clamp", VmBuiltin::Clamp, 3, true},
+        {"math", "abs", VmBuiltin::Abs, 1, true},
+        {"math", "min", VmBuiltin::Min, 2, true},
+        {"math", "max", VmBuiltin::Max, 2, true},
+        {"math", "floor", VmBuiltin::Floor, 1, true},
+    };
+    for (const auto& spec : specs) {
+        const std::string_view specTable = spec.table ? spec.table : "";
+        if (specTable == table && name == spec.name) {
+            return &spec;
+        }
+    }
+    return nullptr;
+}
+
+// gpio.mode names; the VM passes the index
+inline const char* const kVmGpioModes[] = {"input", "output", "input_pullup", "input_pulldown"};
+
+template <typename Variables>
+class ScriptVmCompiler {
+public:
+    ScriptVmCompiler(std::string_view src, const Variables& variables)
+        : src_(src), variables_(variables) {}
+
+    Result<std::vector<uint8_t>> compile(CodeKind kind) {
+        if (kind == CodeKind::Expression) {
+            const int reg = allocRegister();
+            expression(reg);
+            emit(VmOp::Return, reg);
+        } else {
+            block();
+            if (!error_ && returned_ == 0) {
+                emit(VmOp::ReturnNone);
+            }
+        }
+        skipSpace();
+        if (!error_ && pos_ < src_.size()) {
+            fail("unexpected input");
+        }
+        if (error_) {
+            return Result<std::vector<uint8_t>>::error(std::string("script vm: ") + error_ +
+                                                       " at offset " + std::to_string(errorPos_));
+        }
+
+        std::vector<uint8_t> out;
+        out.reserve(SCRIPT_VM_HEADER_SIZE + constants_.size() * 8 + code_.size());
+        out.push_back(static_cast<uint8_t>(maxRegisters_));
+        out.push_back(static_cast<uint8_t>(constants_.size()));
+        const size_t count = code_.size() / SCRIPT_VM_INSTR_SIZE;
+        out.push_back(static_cast<uint8_t>(count >> 8));
+        out.push_back(static_cast<uint8_t>(count & 0xFF));
+        for (double constant : constants_) {
+            uint64_t bits = 0;
+            std::memcpy(&bits, &constant, sizeof(bits));
+            for (int shift = 56; shift >= 0; shift -= 8) {
+                out.push_back(static_cast<uint8_t>(bits >> shift));
+            }
+        }
+        out.insert(out.end(), code_.begin(), code_.end());
+        return Result<std::vector<uint8_t>>::ok(std::move(out));
+    }
+
+private:
+    struct Local {
+        std::string_view name;
+        int reg;
+    };
+
+    using VariableRecord = typename Variables::value_type;
+
+    // ------------------------------------------------------------------
+    // Statements
+    // ------------------------------------------------------------------
+
+    void block() {
+        const size_t scope = locals_.size();
+        const int top = top_;
+        while (!error_) {
+            skipSpace();
+            if (pos_ >= src_.size() || atKeyword("end") || atKeyword("else") || atKeyword("elseif")) {
+                break;
+            }
+            if (returnedInBlock_) {
+                fail("statement after return");
+                break;
+            }
+            statement();
+            symbol(';');
+        }
+        returnedInBlock_ = false;
+        locals_.resize(scope);
+        top_ = top;
+    }
+
+    void statement() {
+        if (keyword("local")) {
+            const std::string_view name = identifier();
+            if (name.empty()) {
+                fail("expected local name");
+                return;
+            }
+            const int reg = allocRegister();
+            if (symbol('=')) {
+                expression(reg);
+            } else {
+                emitK(reg, 0.0);
+            }
+            locals_.push_back({name, reg});
+            return;
+        }
+        if (keyword("if")) {
+            ifStatement();
+            return;
+        }
+        if (keyword("return")) {
+            skipSpace();
+            if (pos_ >= src_.size() || atKeyword("end") || atKeyword("else") || atKeyword("elseif") ||
+                peek() == ';') {
+                emit(VmOp::ReturnNone);
+            } else {
+                const int reg = allocRegister();
+                expression(reg);
+                emit(VmOp::Return, reg);
+                --top_;
+            }
+            ++returned_;
+            returnedInBlock_ = true;
+            return;
+        }
+
+        const size_t start = pos_;
+        const std::string_view name = identifier();
+        if (name.empty()) {
+            fail("expected statement");
+            return;
+        }
+        if (name == "setVal" || name == "setOutput" || name == "emit") {
+            storeCall(name == "setOutput");
+            return;
+        }
+        if (peek() == '.' || peek() == '(') {
+            pos_ = start;
+            const int reg = allocRegister();
+            if (!callExpression(reg, false)) {
+                fail("unsupported call");
+            }
+            --top_;
+            return;
+        }
+        if (!symbol('=') || peek() == '=') {
+            fail("expected assignment");
+            return;
+        }
+        if (const Local* local = findLocal(name)) {
+            const int reg = local->reg;  // The right side may read the local
+            const int value = allocRegister();
+            expression(value);
+            emit(VmOp::Move, reg, value);
+            --top_;
+            return;
+        }
+        const auto* var = findVariable(name);
+        if (!var) {
+            fail("unknown variable");
+            return;
+        }
+        if (var->direction == VariableDirection::Input) {
+            fail("cannot assign an input");
+            return;
+        }
+        store(*var);
+    }
+
+    void ifStatement() {
+        std::vector<size_t> exits;
+        while (!error_) {
+            const int cond = allocRegister();
+            expression(cond);
+            --top_;
+            if (!keyword("then")) {
+                fail("expected then");
+                return;
+            }
+            const size_t skip = emitJump(VmOp::JmpIfNot, cond);
+            block();
+            if (keyword("elseif")) {
+                exits.push_back(emitJump(VmOp::Jmp, 0));
+                patchJump(skip);
+                continue;
+            }
+            if (keyword("else")) {
+                exits.push_back(emitJump(VmOp::Jmp, 0));
+                patchJump(skip);
+                block();
+            } else {
+                patchJump(skip);
+            }
+            if (!keyword("end")) {
+                fail("expected end");
+            }
+            break;
+        }
+        for (size_t exit : exits) {
+            patchJump(exit);
+        }
+    }
+
+    // setVal("name", e) / setOutput("name", e)
+    void storeCall(bool outputOnly) {
+        if (!symbol('(')) {
+            fail("expected (");
+            return;
+        }
+        const std::string name = stringLiteral();
+        const auto* var = findVariable(name);
+        if (!var || !symbol(',')) {
+            fail("unknown variable");
+            return;
+        }
+        if (var->direction == VariableDirection::Input ||
+            (outputOnly && var->direction != VariableDirection::Output)) {
+            fail(outputOnly ? "setOutput expects an output" : "cannot assign an input");
+            return;
+        }
+        store(*var);
+        if (!symbol(')')) {
+            fail("expected )");
+        }
+    }
+
+    void store(const VariableRecord& var) {
+        if (var.type == ValueType::String || var.type == ValueType::Binary || var.type == ValueType::Void) {
+            fail("only number and boolean variables");
+            return;
+        }
+        const int reg = allocRegister();
+        expression(reg);
+        emitBx(VmOp::StoreVar, reg, var.id);
+        --top_;
+    }
+
+    // ------------------------------------------------------------------
+    // Expressions (result into register `dst`)
+    // ------------------------------------------------------------------
+
+    void expression(int dst) { orExpr(dst); }
+
+    void orExpr(int dst) {
+        andExpr(dst);
+        while (!error_ && keyword("or")) {
+            binaryRhs(dst, VmOp::Or, &ScriptVmCompiler::andExpr);
+        }
+    }
+
+    void andExpr(int dst) {
+        comparison(dst);
+        while (!error_ && keyword("and")) {
+            binaryRhs(dst, VmOp::And, &ScriptVmCompiler::comparison);
+        }
+    }
+
+    void comparison(int dst) {
+        additive(dst);
+        while (!error_) {
+            skipSpace();
+            const char c = peek();
+            const bool equals = peek(1) == '=';
+            VmOp op;
+            bool swap = false;
+            if (c == '=' && equals) op = VmOp::Eq;
+            else if (c == '~' && equals) op = VmOp::Ne;
+            else if (c == '<') op = equals ? VmOp::Le : VmOp::Lt;
+            else if (c == '>') { op = equals ? VmOp::Le : VmOp::Lt; swap = true; }
+            else break;
+            pos_ += equals ? 2 : 1;
+            const int rhs = allocRegister();
+            additive(rhs);
+            emit(op, dst, swap ? rhs : dst, swap ? dst : rhs);
+            --top_;
+        }
+    }
+
+    void additive(int dst) {
+        multiplicative(dst);
+        while (!error_) {
+            skipSpace();
+            if (symbol('+')) binaryRhs(dst, VmOp::Add, &ScriptVmCompiler::multiplicative);
+            else if (symbol('-')) binaryRhs(dst, VmOp::Sub, &ScriptVmCompiler::multiplicative);
+            else break;
+        }
+    }
+
+    void multiplicative(int dst) {
+        unary(dst);
+        while (!error_) {
+            skipSpace();
+            if (peek() == '/' && peek(1) == '/') {
+                fail("floor division unsupported");
+            } else if (symbol('*')) {
+                binaryRhs(dst, VmOp::Mul, &ScriptVmCompiler::unary);
+            } else if (symbol('/')) {
+                binaryRhs(dst, VmOp::Div, &ScriptVmCompiler::unary);
+            } else if (symbol('%')) {
+                binaryRhs(dst, VmOp::Mod, &ScriptVmCompiler::unary);
+            } else {
+                break;
+            }
+        }
+    }
+
+    void binaryRhs(int dst, VmOp op, void (ScriptVmCompiler::*operand)(int)) {
+        const int rhs = allocRegister();
+        (this->*operand)(rhs);
+        emit(op, dst, dst, rhs);
+        --top_;
+    }
+
+    void unary(int dst) {
+        if (keyword("not")) {
+            unary(dst);
+            emit(VmOp::Not, dst, dst);
+            return;
+        }
+        skipSpace();
+        if (peek() == '-' && peek(1) != '-' && symbol('-')) {
+            unary(dst);
+            emit(VmOp::Neg, dst, dst);
+            return;
+        }
+        primary(dst);
+    }
+
+    void primary(int dst) {
+        skipSpace();
+        const char c = peek();
+        if (c == '(') {
+            ++pos_;
+            expression(dst);
+            if (!symbol(')')) fail("expected )");
+            return;
+        }
+        if (std::isdigit(static_cast<unsigned char>(c)) ||
+            (c == '.' && std::isdigit(static_cast<unsigned char>(peek(1))))) {
+            number(dst);
+            return;
+        }
+        const size_t start = pos_;
+        const std::string_view word = identifier();
+        if (word.empty()) {
+            fail("expected expression");
+            return;
+        }
+        if (word == "true" || word == "false") {
+            emitK(dst, word == "true" ? 1.0 : 0.0);
+            return;
+        }
+        if (word == "getVal" || word == "value" || word == "getInput" ||
+            word == "changed" || word == "check") {
+            if (!symbol('(')) {
+                fail("expected (");
+                return;
+            }
+            const std::string name = stringLiteral();
+            const auto* var = findVariable(name);
+            if (!var || !symbol(')')) {
+                fail("unknown variable");
+                return;
+            }
+            if (word == "changed" || word == "check") {
+                emitBx(VmOp::Changed, dst, var->id);
+            } else {
+                if (word == "getInput" && var->direction != VariableDirection::Input) {
+                    fail("getInput expects an input");
+                    return;
+                }
+                load(dst, *var);
+            }
+            return;
+        }
+        if (const Local* local = findLocal(word)) {
+            if (local->reg != dst) {
+                emit(VmOp::Move, dst, local->reg);
+            }
+            return;
+        }
+        if (peek() == '.' || peek() == '(') {
+            pos_ = start;
+            if (!callExpression(dst, true)) {
+                fail("unsupported call");
+            }
+            return;
+        }
+        const auto* var = findVariable(word);
+        if (!var) {
+            fail("unknown variable");
+            return;
+        }
+        load(dst, *var);
+    }
+
+    // table.name(args) or name(args); the result goes to `dst`
+    bool callExpression(int dst, bool needValue) {
+        std::string_view table;
+        std::string_view name = identifier();
+        if (peek() == '.') {
+            ++pos_;
+            table = name;
+            name = identifier();
+        }
+        const VmBuiltinSpec* spec = findVmBuiltin(table, name);
+        if (!spec || (needValue && !spec->returnsValue) || !symbol('(')) {
+            return false;
+        }
+        const int first = top_;
+        for (uint8_t i = 0; i < spec->argc && !error_; ++i) {
+            if (i > 0 && !symbol(',')) {
+                fail("expected ,");
+                break;
+            }
+            const int reg = allocRegister();
+            if (spec->id == VmBuiltin::GpioMode && i == 1) {
+                gpioMode(reg);
+            } else {
+                expression(reg);
+            }
+        }
+        if (!symbol(')')) {
+            fail("expected )");
+        }
+        emit(VmOp::Call, dst, static_cast<int>(spec->id), first);
+        top_ = first;
+        return true;
+    }
+
+    void gpioMode(int dst) {
+        const std::string mode = stringLiteral();
+        for (size_t i = 0; i < sizeof(kVmGpioModes) / sizeof(kVmGpioModes[0]); ++i) {
+            if (mode == kVmGpioModes[i]) {
+                emitK(dst, static_cast<double>(i));
+                return;
+            }
+        }
+        fail("unknown gpio mode");
+    }
+
+    void load(int dst, const VariableRecord& var) {
+        if (var.type == ValueType::String || var.type == ValueType::Binary || var.type == ValueType::Void) {
+            fail("only number and boolean variables");
+            return;
+        }
+        emitBx(VmOp::LoadVar, dst, var.id);
+    }
+
+    void number(int dst) {
+        const size_t start = pos_;
+        const bool hex = peek() == '0' && (peek(1) == 'x' || peek(1) == 'X');
+        while (pos_ < src_.size()) {
+            const char c = src_[pos_];
+            const char prev = pos_ > start ? src_[pos_ - 1] : '\0';
+            const bool exponentSign = (c == '+' || c == '-') && !hex && (prev == 'e' || prev == 'E');
+            if (!std::isalnum(static_cast<unsigned char>(c)) && c != '.' && !exponentSign) {
+                break;
+            }
+            ++pos_;
+        }
+        const std::string token(src_.substr(start, pos_ - start));
+        char* end = nullptr;
+        const double value = std::strtod(token.c_str(), &end);
+        if (end != token.c_str() + token.size()) {
+            fail("malformed number");
+            return;
+        }
+        emitK(dst, value);
+    }
+
+    std::string stringLiteral() {
+        skipSpace();
+        const char quote = peek();
+        if (quote != '"' && quote != '\'') {
+            fail("expected string");
+            return {};
+        }
+        const size_t close = src_.find(quote, pos_ + 1);
+        if (close == std::string_view::npos) {
+            fail("unterminated string");
+            return {};
+        }
+        std::string text(src_.substr(pos_ + 1, close - pos_ - 1));
+        pos_ = close + 1;
+        return text;
+    }
+
+    // ------------------------------------------------------------------
+    // Emission
+    // ------------------------------------------------------------------
+
+    int allocRegister() {
+        if (top_ >= static_cast<int>(SCRIPT_VM_MAX_REGISTERS)) {
+            fail("expression too complex");
+            return 0;
+        }
+        const int reg = top_++;
+        maxRegisters_ = std::max(maxRegisters_, top_);
+        return reg;
+    }
+
+    void emit(VmOp op, int a = 0, int b = 0, int c = 0) {
+        code_.push_back(static_cast<uint8_t>(op));
+        code_.push_back(static_cast<uint8_t>(a));
+        code_.push_back(static_cast<uint8_t>(b));
+        code_.push_back(static_cast<uint8_t>(c));
+        if (code_.size() / SCRIPT_VM_INSTR_SIZE > 0xFFFF) {
+            fail("block too long");
+        }
+    }
+
+    void emitBx(VmOp op, int a, uint32_t bx) { emit(op, a, static_cast<int>(bx >> 8), static_cast<int>(bx & 0xFF)); }
+
+    void emitK(int dst, double value) {
+        size_t index = 0;
+        while (index < constants_.size() && std::memcmp(&constants_[index], &value, sizeof(value)) != 0) {
+            ++index;
+        }
+        if (index == constants_.size()) {
+            if (constants_.size() >= SCRIPT_VM_MAX_CONSTANTS) {
+                fail("too many constants");
+                return;
+            }
+            constants_.push_back(value);
+        }
+        emitBx(VmOp::LoadK, dst, static_cast<uint32_t>(index));
+    }
+
+    size_t emitJump(VmOp op, int a) {
+        const size_t at = code_.size();
+        emit(op, a);
+        return at;
+    }
+
+    // Point a jump at the next instruction to be emitted
+    void patchJump(size_t at) {
+        const size_t offset = (code_.size() - at) / SCRIPT_VM_INSTR_SIZE - 1;
+        code_[at + 2] = static_cast<uint8_t>(offset >> 8);
+        code_[at + 3] = static_cast<uint8_t>(offset & 0xFF);
+    }
+
+    // ------------------------------------------------------------------
+    // Lexing
+    // ------------------------------------------------------------------
+
+    const Local* findLocal(std::string_view name) const {
+        for (auto it = locals_.rbegin(); it != locals_.rend(); ++it) {
+            if (it->name == name) return &*it;
+        }
+        return nullptr;
+    }
+
+    const VariableRecord* findVariable(std::string_view name) const {
+        for (const auto& var : variables_) {
+            if (var.name == name) return &var;
+        }
+        return nullptr;
+    }
+
+    bool atKeyword(std::string_view word) {
+        skipSpace();
+        return src_.compare(pos_, word.size(), word) == 0 && !isIdentChar(peek(word.size()));
+    }
+
+    bool keyword(std::string_view word) {
+        if (!atKeyword(word)) return false;
+        pos_ += word.size();
+        return true;
+    }
+
+    bool symbol(char c) {
+        skipSpace();
+        if (peek() != c) return false;
+        ++pos_;
+        return true;
+    }
+
+    std::string_view identifier() {
+        skipSpace();
+        const size_t start = pos_;
+        if (!std::isalpha(static_cast<unsigned char>(peek())) && peek() != '_') {
+            return {};
+        }
+        while (isIdentChar(peek())) ++pos_;
+        return src_.substr(start, pos_ - start);
+    }
+
+    // Whitespace and comments
+    void skipSpace() {
+        while (pos_ < src_.size()) {
+            if (std::isspace(static_cast<unsigned char>(src_[pos_]))) {
+                ++pos_;
+            } else if (src_.compare(pos_, 4, "--[[") == 0) {
+                const size_t close = src_.find("]]", pos_ + 4);
+                pos_ = close == std::string_view::npos ? src_.size() : close + 2;
+            } else if (src_.compare(pos_, 2, "--") == 0) {
+                const size_t eol = src_.find('\n', pos_);
+                pos_ = eol == std::string_view::npos ? src_.size() : eol + 1;
+            } else {
+                break;
+            }
+        }
+    }
+
+    [[nodiscard]] char peek(size_t ahead = 0) const {
+        return pos_ + ahead < src_.size() ? src_[pos_ + ahead] : '\0';
+    }
+
+    static bool isIdentChar(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    void fail(const char* message) {
+        if (!error_) {
+            error_ = message;
+            errorPos_ = pos_;
+        }
+    }
+
+    std::string_view src_;
+    const Variables& variables_;
+    size_t pos_ = 0;
+    std::vector<Local> locals_;
+    std::vector<double> constants_;
+    std::vector<uint8_t> code_;
+    int top_ = 0;
+    int maxRegisters_ = 0;
+    size_t returned_ = 0;
+    bool returnedInBlock_ = false;
+    const char* error_ = nullptr;
+    size_t errorPos_ = 0;
+};
+
+} // namespace detail
+
+template <typename Variables>
+Result<std::vector<uint8_t>> compileScriptVm(std::string_view source, CodeKind kind, const Variables& variables) {
+    detail::ScriptVmCompiler<Variables> compiler(source, variables);
+    return compiler.compile(kind);
+}
+
+inline Result<void> compileScriptVmChunks(ir::EngineBytecodeProgram& program) {
+    std::vector<ir::BytecodeLuaChunk> chunks;
+    std::string error;
+    auto compile = [&](ir::LuaChunkSlot slot, uint16_t ownerId, const std::string& source, CodeKind kind) {
+        if (source.empty() || !error.empty()) {
+            return;
+        }
+        auto bytes = compileScriptVm(source, kind, program.variables);
+        if (bytes.isError()) {
+            error = bytes.error();
+            return;
+        }
+        chunks.push_back(ir::BytecodeLuaChunk{slot, ownerId, std::move(bytes.value())});
+    };
+
+    for (const auto& st : program.states) {
+        compile(ir::LuaChunkSlot::StateOnEnter, st.id, st.onEnterSource, CodeKind::Statement);
+        compile(ir::LuaChunkSlot::StateBody, st.id, st.bodySource, CodeKind::Statement);
+        compile(ir::LuaChunkSlot::StateOnExit, st.id, st.onExitSource, CodeKind::Statement);
+    }
+    for (const auto& t : program.transitions) {
+        compile(ir::LuaChunkSlot::TransitionCondition, t.id, t.conditionExpression, t.resolvedConditionKind());
+        compile(ir::LuaChunkSlot::TransitionBody, t.id, t.bodySource, CodeKind::Statement);
+        compile(ir::LuaChunkSlot::TransitionTriggered, t.id, t.triggeredSource, CodeKind::Statement);
+    }
+    if (!error.empty()) {
+        return Result<void>::error(error);
+    }
+
+    program.luaTarget = SCRIPT_VM_TARGET;
+    program.luaChunks = std::move(chunks);
+    return Result<void>::ok();
+}
+
+// ============================================================================
+// Implementation: Interpreter
+// ============================================================================
+
+inline bool scriptVmChunk(const CodeBlock& code, CodeKind kind, const uint8_t*& body, size_t& size) {
+    LuaChunkView view;
+    if (!loadableLuaChunk(code, SCRIPT_VM_TARGET, kind, view)) {
+        return false;
+    }
+    body = reinterpret_cast<const uint8_t*>(view.data);
+    size = view.size;
+    return true;
+}
+
+namespace detail {
+
+inline bool vmLoad(const Value& value, double& out) {
+    switch (value.type()) {
+        case ValueType::Bool: out = value.get<bool>() ? 1.0 : 0.0; return true;
+        case ValueType::Int32: out = value.get<int32_t>(); return true;
+        case ValueType::Int64: out = static_cast<double>(value.get<int64_t>()); return true;
+        case ValueType::Float32: out = value.get<float>(); return true;
+        case ValueType::Float64: out = value.get<double>(); return true;
+        default: return false;
+    }
+}
+
+// Same coercion the Lua engines apply to script writes
+inline bool vmValue(double number, ValueType type, Value& out) {
+    switch (type) {
+        case ValueType::Bool: out = Value(number != 0.0); return true;
+        case ValueType::Int32: out = Value(static_cast<int32_t>(number)); return true;
+        case ValueType::Int64: out = Value(static_cast<int64_t>(number)); return true;
+        case ValueType::Float32: out = Value(static_cast<float>(number)); return true;
+        case ValueType::Float64: out = Value(number); return true;
+        default: return false;
+    }
+}
+
+inline bool vmCall(VmBuiltin builtin, const double* args, double& out, const char*& error) {
+    auto& hw = []() -> IHardwareService& {
+        auto* service = hardwareService();
+        if (!service) {
+            static NullHardwareService fallback;
+            service = &fallback;
+        }
+        return *service;
+    }();
+    auto pin = [&](size_t i) { return static_cast<int>(args[i]); };
+    auto done = [&](bool ok) {
+        if (!ok) error = "hardware call failed";
+        return ok;
+    };
+    auto read = [&](Result<int64_t> result) {
+        if (result.isError()) return done(false);
+        out = static_cast<double>(result.value());
+        return true;
+    };
+
+    out = 0.0;
+    switch (builtin) {
+        case VmBuiltin::GpioMode: {
+            const size_t mode = static_cast<size_t>(args[1]);
+            if (mode >= sizeof(kVmGpioModes) / sizeof(kVmGpioModes[0])) {
+                error = "unknown gpio mode";
+                return false;
+            }
+            return done(hw.gpioMode(pin(0), kVmGpioModes[mode]).isOk());
+        }
+        case VmBuiltin::GpioWrite: return done(hw.gpioWrite(pin(0), args[1] != 0.0).isOk());
+        case VmBuiltin::GpioRead: return read(hw.gpioRead(pin(0)));
+        case VmBuiltin::PwmAttach: return done(hw.pwmAttach(pin(0), pin(1), pin(2), pin(3)).isOk());
+        case VmBuiltin::PwmWrite: return done(hw.pwmWrite(pin(0), pin(1)).isOk());
+        case VmBuiltin::AdcRead: return read(hw.adcRead(pin(0)));
+        case VmBuiltin::AdcReadMv: return read(hw.adcReadMilliVolts(pin(0)));
+        case VmBuiltin::DacWrite: return done(hw.dacWrite(pin(0), pin(1)).isOk());
+        case VmBuiltin::Clamp: {
+            const double lo = std::min(args[1], args[2]);
+            const double hi = std::max(args[1], args[2]);
+            out = args[0] < lo ? lo : (args[0] > hi ? hi : args[0]);
+            return true;
+        }
+        case VmBuiltin::Abs: out = std::fabs(args[0]); return true;
+        case VmBuiltin::Min: out = args[0] < args[1] ? args[0] : args[1]; return true;
+        case VmBuiltin::Max: out = args[0] > args[1] ? args[0] : args[1]; return true;
+        case VmBuiltin::Floor: out = std::floor(args[0]); return true;
+        case VmBuiltin::Count: break;
+    }
+    error = "unknown builtin";
+    return false;
+}
+
+inline uint8_t vmArgc(VmBuiltin builtin) {
+    static const uint8_t argc[] = {2, 2, 1, 4, 2, 1, 1, 2, 3, 1, 2, 2, 1};
+    return argc[static_cast<uint8_t>(builtin)];
+}
+
+} // namespace detail
+
+inline ScriptVmResult runScriptVm(const uint8_t* body, size_t size, VariableStore& variables, bool replay) {
+    ScriptVmResult result;
+    auto fault = [&](const char* error) {
+        result.ok = false;
+        result.error = error;
+        return result;
+    };
+    if (size < SCRIPT_VM_HEADER_SIZE) {
+        return fault("vm chunk truncated");
+    }
+    const size_t registers = body[0];
+    const size_t constantCount = body[1];
+    const size_t count = static_cast<size_t>((body[2] << 8) | body[3]);
+    const uint8_t* constants = body + SCRIPT_VM_HEADER_SIZE;
+    const uint8_t* code = constants + constantCount * 8;
+    if (registers > SCRIPT_VM_MAX_REGISTERS ||
+        size != SCRIPT_VM_HEADER_SIZE + constantCount * 8 + count * SCRIPT_VM_INSTR_SIZE) {
+        return fault("vm chunk malformed");
+    }
+
+    double r[SCRIPT_VM_MAX_REGISTERS] = {};
+    for (size_t pc = 0; pc < count; ++pc) {
+        const uint8_t* instr = code + pc * SCRIPT_VM_INSTR_SIZE;
+        const auto op = static_cast<VmOp>(instr[0]);
+        const size_t a = instr[1];
+        const size_t b = instr[2];
+        const size_t c = instr[3];
+        const size_t bx = (b << 8) | c;
+        if (a >= registers && op != VmOp::Jmp && op != VmOp::ReturnNone) {
+            return fault("vm register out of range");
+        }
+        switch (op) {
+            case VmOp::LoadK: {
+                if (bx >= constantCount) return fault("vm constant out of range");
+                uint64_t bits = 0;
+                for (size_t i = 0; i < 8; ++i) bits = (bits << 8) | constants[bx * 8 + i];
+                std::memcpy(&r[a], &bits, sizeof(bits));
+                break;
+            }
+            case VmOp::LoadVar:
+            case VmOp::Changed:
+            case VmOp::StoreVar: {
+                Variable* var = variables.get(static_cast<VariableId>(bx));
+                if (!var) return fault("vm variable unknown");
+                if (op == VmOp::Changed) {
+                    r[a] = var->hasChanged() ? 1.0 : 0.0;
+                } else if (op == VmOp::LoadVar) {
+                    if (!detail::vmLoad(var->value(), r[a])) return fault("vm variable not numeric");
+                } else if (!replay) {
+                    Value value;
+                    if (!detail::vmValue(r[a], var->type(), value) ||
+                        !variables.setValue(var->id(), std::move(value))) {
+                        return fault("vm write rejected");
+                    }
+                }
+                break;
+            }
+            case VmOp::Jmp:
+            case VmOp::JmpIfNot:
+                if (op == VmOp::Jmp || r[a] == 0.0) {
+                    pc += bx;  // Forward only: the loop always ends
+                }
+                break;
+            case VmOp::Call: {
+                const auto builtin = static_cast<VmBuiltin>(b);
+                if (b >= static_cast<size_t>(VmBuiltin::Count) || c + detail::vmArgc(builtin) > registers) {
+                    return fault("vm call malformed");
+                }
+                const char* error = nullptr;
+                if (!detail::vmCall(builtin, r + c, r[a], error)) return fault(error);
+                break;
+            }
+            case VmOp::Return:
+                result.returned = true;
+                result.value = r[a];
+                return result;
+            case VmOp::ReturnNone:
+                return result;
+            default: {
+                if (b >= registers || (op < VmOp::Neg && c >= registers)) {
+                    return fault("vm register out of range");
+                }
+                const double x = r[b];
+                const double y = op < VmOp::Neg ? r[c] : 0.0;
+                switch (op) {
+                    case VmOp::Move: r[a] = x; break;
+                    case VmOp::Add: r[a] = x + y; break;
+                    case VmOp::Sub: r[a] = x - y; break;
+                    case VmOp::Mul: r[a] = x * y; break;
+                    case VmOp::Div: r[a] = x / y; break;
+                    case VmOp::Mod: r[a] = x - std::floor(x / y) * y; break;  // Lua's floored modulo
+                    case VmOp::Eq: r[a] = x == y ? 1.0 : 0.0; break;
+                    case VmOp::Ne: r[a] = x != y ? 1.0 : 0.0; break;
+                    case VmOp::Lt: r[a] = x < y ? 1.0 : 0.0; break;
+                    case VmOp::Le: r[a] = x <= y ? 1.0 : 0.0; break;
+                    case VmOp::And: r[a] = (x != 0.0 && y != 0.0) ? 1.0 : 0.0; break;
+                    case VmOp::Or: r[a] = (x != 0.0 || y != 0.0) ? 1.0 : 0.0; break;
+                    case VmOp::Neg: r[a] = -x; break;
+                    case VmOp::Not: r[a] = x == 0.0 ? 1.0 : 0.0; break;
+                    default: return fault("vm opcode unknown");
+                }
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace aeth
+
+#endif // AETHERIUM_SCRIPT_VM_HPP
@@ -0,0 +1,453 @@
+/**
+ * Aetherium Automata - Shared-Memory Transport Implementation
+ */
+
+#include "shm_transport.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <ctime>
+#endif
+
+namespace aeth {
+
+namespace {
+
+constexpr uint32_t SEGMENT_MAGIC = 0x41455348;  // "AESH"
+constexpr uint32_t SEGMENT_VERSION = 1;
+constexpr size_t FRAME_PREFIX = 4;  // Little-endian frame length
+constexpr auto ATTACH_TIMEOUT = std::chrono::seconds(1);
+
+size_t roundUpPow2(size_t value) {
+    size_t size = 4096;
+    while (size < value) {
+        size <<= 1;
+    }
+    return size;
+}
+
+// A side that crashed leaves its pid in the segment; ESRCH tells us it is gone
+bool processAlive(uint32_t pid) {
+    return pid != 0 && (::kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH);
+}
+
+void futexWait(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::microseconds timeout) {
+#if defined(__linux__)
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(timeout.count() / 1000000);
+    ts.tv_nsec = static_cast<long>((timeout.count() % 1000000) * 1000);
+    // Shared (not PRIVATE) futex: the word lives in memory mapped by both processes
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+#else
+    // No cross-process futex: poll in short slices
+    const auto slice = std::min(timeout, std::chrono::microseconds(200));
+    if (word.load(std::memory_order_acquire) == expected) {
+        std::this_thread::sleep_for(slice);
+    }
+#endif
+}
+
+void futexWake(std::atomic<uint32_t>& word) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+
+} // namespace
+
+/**
+ * Segment header; ring 0 carries creator -> attached, ring 1 the reverse.
+ * Rings start at offsets rounded to a cache line.
+ */
+struct SharedMemoryTransport::Segment {
+    std::atomic<uint32_t> magic;  // Set last by the creator
+    uint32_t version;
+    uint64_t ringBytes;
+    std::atomic<uint32_t> attached[2];  // pid of each side, 0 when detached
+
+    static size_t ringOffset(int index, size_t ringBytes) {
+        const size_t header = (sizeof(Segment) + 63) & ~size_t{63};
+        return header + static_cast<size_t>(index) * (sizeof(ShmRing) + ringBytes);
+    }
+    static size_t totalBytes(size_t ringBytes) { return ringOffset(2, ringBytes); }
+
+    ShmRing& ring(int index) {
+        return *reinterpret_cast<ShmRing*>(reinterpret_cast<uint8_t*>(this) + ringOffset(index, ringBytes));
+    }
+};
+
+SharedMemoryTransport::SharedMemoryTransport(std::string name, size_t ringBytes)
+    : name_("/" + std::move(name)), ringBytes_(roundUpPow2(ringBytes)) {}
+
+SharedMemoryTransport::~SharedMemoryTransport() {
+    disconnect();
+}
+
+bool SharedMemoryTransport::isShmUrl(const std::string& url) {
+    return url.rfind(URL_SCHEME, 0) == 0 && url.size() > std::strlen(URL_SCHEME);
+}
+
+Result<void> SharedMemoryTransport::connect() {
+    if (state_ == TransportState::Connected) {
+        return Result<void>::ok();
+    }
+    state_ = TransportState::Connecting;
+    notifyStateChange(state_);
+
+    auto mapped = map(true);
+    if (mapped.isError() && mapFailure_ == MapFailure::Exists) {
+        mapped = map(false);
+        if (mapped.isError() && mapFailure_ == MapFailure::Stale) {
+            // Left behind by peers that crashed: start over
+            shm_unlink(name_.c_str());
+            mapped = map(true);
+        }
+    }
+    if (mapped.isError()) {
+        state_ = TransportState::Error;
+        notifyStateChange(state_);
+        return mapped;
+    }
+
+    state_ = TransportState::Connected;
+    notifyStateChange(state_);
+    if (sendHello_) {
+        sendHelloMessage();
+    }
+    std::cout << "[SHM] " << (isCreator() ? "Created " : "Attached to ") << name_ << std::endl;
+    return Result<void>::ok();
+}
+
+Result<void> SharedMemoryTransport::map(bool create) {
+    mapFailure_ = MapFailure::None;
+    fd_ = create ? shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600)
+                 : shm_open(name_.c_str(), O_RDWR, 0600);
+    if (fd_ < 0) {
+        const int error = errno;
+        mapFailure_ = error == EEXIST ? MapFailure::Exists : MapFailure::Other;
+        return Result<void>::error("shm_open " + name_ + ": " + std::strerror(error));
+    }
+
+    size_t ringBytes = ringBytes_;
+    if (create) {
+        if (ftruncate(fd_, static_cast<off_t>(Segment::totalBytes(ringBytes))) != 0) {
+            const std::string error = std::strerror(errno);
+            ::close(fd_);
+            fd_ = -1;
+            shm_unlink(name_.c_str());
+            return Result<void>::error("ftruncate " + name_ + ": " + error);
+        }
+    } else {
+        // The creator sizes the segment right after creating it
+        struct stat info {};
+        const auto deadline = std::chrono::steady_clock::now() + ATTACH_TIMEOUT;
+        while (fstat(fd_, &info) == 0 && static_cast<size_t>(info.st_size) < sizeof(Segment) &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (static_cast<size_t>(info.st_size) < sizeof(Segment)) {
+            ::close(fd_);
+            fd_ = -1;
+            mapFailure_ = MapFailure::Stale;
+            return Result<void>::error("shm segment " + name_ + " was never initialized");
+        }
+        ringBytes = 0;  // Read from the header below
+    }
+
+    // Map the header first when attaching, to learn the ring size
+    size_t bytes = create ? Segment::totalBytes(ringBytes) : sizeof(Segment);
+    void* base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (base == MAP_FAILED) {
+        const std::string error = std::strerror(errno);
+        ::close(fd_);
+        fd_ = -1;
+        return Result<void>::error("mmap " + name_ + ": " + error);
+    }
+    auto* segment = static_cast<Segment*>(base);
+
+    if (create) {
+        // ftruncate zero-fills, so the rings start empty
+        segment->version = SEGMENT_VERSION;
+        segment->ringBytes = ringBytes;
+        segment->attached[0].store(static_cast<uint32_t>(::getpid()), std::memory_order_relaxed);
+        segment->magic.store(SEGMENT_MAGIC, std::memory_order_release);
+        side_ = 0;
+    } else {
+        const auto deadline = std::chrono::steady_clock::now() + ATTACH_TIMEOUT;
+        while (segment->magic.load(std::memory_order_acquire) != SEGMENT_MAGIC &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::string error;
+        if (segment->magic.load(std::memory_order_acquire) != SEGMENT_MAGIC ||
+            segment->version != SEGMENT_VERSION) {
+            error = "shm segment " + name_ + " has an unknown layout";
+            mapFailure_ = MapFailure::Stale;
+        } else if (!processAlive(segment->attached[0].load(std::memory_order_acquire))) {
+            error = "shm segment " + name_ + " was left behind by its creator";
+            mapFailure_ = MapFailure::Stale;
+        } else {
+            uint32_t previous = segment->attached[1].load(std::memory_order_acquire);
+            if (processAlive(previous) ||
+                !segment->attached[1].compare_exchange_strong(previous, static_cast<uint32_t>(::getpid()),
+                                                              std::memory_order_acq_rel)) {
+                error = "shm segment " + name_ + " already has two peers";
+                mapFailure_ = MapFailure::Other;
+            }
+        }
+        ringBytes = static_cast<size_t>(segment->ringBytes);
+        munmap(base, bytes);
+        if (!error.empty()) {
+            ::close(fd_);
+            fd_ = -1;
+            return Result<void>::error(error);
+        }
+        bytes = Segment::totalBytes(ringBytes);
+        base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (base == MAP_FAILED) {
+            const std::string mapError = std::strerror(errno);
+            ::close(fd_);
+            fd_ = -1;
+            return Result<void>::error("mmap " + name_ + ": " + mapError);
+        }
+        segment = static_cast<Segment*>(base);
+        side_ = 1;
+    }
+
+    base_ = base;
+    mappedBytes_ = bytes;
+    segment_ = segment;
+    ringBytes_ = ringBytes;
+    rxBuffer_.reserve(protocol::HEADER_SIZE + 0xFFFF);  // Largest v1 frame
+    return Result<void>::ok();
+}
+
+void SharedMemoryTransport::unmap() {
+    if (segment_) {
+        segment_->attached[side_].store(0, std::memory_order_release);
+        // The last side to leave removes the name
+        if (segment_->attached[1 - side_].load(std::memory_order_acquire) == 0) {
+            shm_unlink(name_.c_str());
+        }
+    }
+    if (base_) {
+        munmap(base_, mappedBytes_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    base_ = nullptr;
+    segment_ = nullptr;
+    mappedBytes_ = 0;
+    fd_ = -1;
+}
+
+void SharedMemoryTransport::disconnect() {
+    if (state_ == TransportState::Disconnected) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(sendMutex_);
+        unmap();
+    }
+    state_ = TransportState::Disconnected;
+    notifyStateChange(state_);
+}
+
+ShmRing& SharedMemoryTransport::outRing() const {
+    return segment_->ring(side_);
+}
+
+ShmRing& SharedMemoryTransport::inRing() const {
+    return segment_->ring(1 - side_);
+}
+
+bool SharedMemoryTransport::peerAttached() const {
+    return segment_ && processAlive(segment_->attached[1 - side_].load(std::memory_order_acquire));
+}
+
+void SharedMemoryTransport::sendHelloMessage() {
+    protocol::HelloMessage hello;
+    hello.deviceType = protocol::DeviceType::Desktop;
+    hello.versionMajor = 0;
+    hello.versionMinor = 2;
+    hello.versionPatch = 0;
+    hello.name = deviceName_;
+    hello.capabilities.setLua(true);
+    hello.capabilities.setTimed(true);
+    hello.capabilities.setProbabilistic(true);
+    hello.deployment = helloDeployment_;
+
+    send(std::make_unique<protocol::HelloMessage>(hello));
+}
+
+bool SharedMemoryTransport::send(std::unique_ptr<protocol::Message> msg) {
+    if (!isConnected()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    if (msg->messageId == 0) {
+        msg->messageId = nextMsgId_++;
+    }
+    if (msg->sourceId == 0 && assignedId_ != 0 && msg->type() != protocol::MessageType::Hello) {
+        msg->sourceId = assignedId_;
+    }
+    sendWriter_.clear();
+    msg->serializeInto(sendWriter_);
+    return writeFrame(sendWriter_.data(), sendWriter_.size());
+}
+
+bool SharedMemoryTransport::sendRaw(const uint8_t* data, size_t len) {
+    if (!isConnected()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    return writeFrame(data, len);
+}
+
+bool SharedMemoryTransport::writeFrame(const uint8_t* data, size_t len) {
+    if (!segment_) {
+        return false;
+    }
+    ShmRing& ring = outRing();
+    const uint64_t head = ring.head.load(std::memory_order_relaxed);
+    const uint64_t tail = ring.tail.load(std::memory_order_acquire);
+    const size_t need = FRAME_PREFIX + len;
+    if (len > UINT32_MAX || need > ringBytes_ - static_cast<size_t>(head - tail)) {
+        ++droppedSends_;
+        return false;
+    }
+
+    const size_t mask = ringBytes_ - 1;
+    uint8_t* bytes = ring.data();
+    auto put = [&](uint64_t at, const uint8_t* src, size_t n) {
+        const size_t offset = static_cast<size_t>(at) & mask;
+        const size_t first = std::min(n, ringBytes_ - offset);
+        std::memcpy(bytes + offset, src, first);
+        std::memcpy(bytes, src + first, n - first);
+    };
+    const uint32_t length = static_cast<uint32_t>(len);
+    const uint8_t prefix[FRAME_PREFIX] = {
+        static_cast<uint8_t>(length), static_cast<uint8_t>(length >> 8),
+        static_cast<uint8_t>(length >> 16), static_cast<uint8_t>(length >> 24)};
+    put(head, prefix, FRAME_PREFIX);
+    put(head + FRAME_PREFIX, data, len);
+    ring.head.store(head + need, std::memory_order_release);
+
+    // Pairs with the fence in waitForMessage (no lost wakeup)
+    ring.wakeSeq.fetch_add(1, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ring.consumerWaiting.load(std::memory_order_relaxed) != 0) {
+        futexWake(ring.wakeSeq);
+    }
+    return true;
+}
+
+bool SharedMemoryTransport::readFrame() {
+    if (state_ == TransportState::Error) {
+        return false;
+    }
+    ShmRing& ring = inRing();
+    const uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+    const uint64_t head = ring.head.load(std::memory_order_acquire);
+    if (head == tail) {
+        return false;
+    }
+    const uint64_t available = head - tail;
+
+    const size_t mask = ringBytes_ - 1;
+    const uint8_t* bytes = ring.data();
+    auto get = [&](uint64_t at, uint8_t* dst, size_t n) {
+        const size_t offset = static_cast<size_t>(at) & mask;
+        const size_t first = std::min(n, ringBytes_ - offset);
+        std::memcpy(dst, bytes + offset, first);
+        std::memcpy(dst + first, bytes, n - first);
+    };
+    uint8_t prefix[FRAME_PREFIX];
+    get(tail, prefix, FRAME_PREFIX);
+    const size_t length = static_cast<size_t>(prefix[0]) | (static_cast<size_t>(prefix[1]) << 8) |
+                          (static_cast<size_t>(prefix[2]) << 16) | (static_cast<size_t>(prefix[3]) << 24);
+    // The writer publishes whole frames, so anything else means the peer
+    // (or the segment) is corrupt: stop reading rather than trust it.
+    if (available > ringBytes_ || available < FRAME_PREFIX || length > available - FRAME_PREFIX) {
+        std::cerr << "[SHM] " << name_ << ": corrupt frame length " << length
+                  << " with " << available << " bytes queued; closing link" << std::endl;
+        state_ = TransportState::Error;
+        notifyStateChange(state_);
+        return false;
+    }
+    rxBuffer_.resize(length);
+    get(tail + FRAME_PREFIX, rxBuffer_.data(), length);
+    ring.tail.store(tail + FRAME_PREFIX + length, std::memory_order_release);
+    return true;
+}
+
+bool SharedMemoryTransport::receiveRaw(std::vector<uint8_t>& out) {
+    if (!segment_ || !readFrame()) {
+        return false;
+    }
+    out.assign(rxBuffer_.begin(), rxBuffer_.end());
+    return true;
+}
+
+std::unique_ptr<protocol::Message> SharedMemoryTransport::receive() {
+    if (!segment_) {
+        return nullptr;
+    }
+    while (readFrame()) {
+        auto message = protocol::MessageFactory::deserialize(rxBuffer_.data(), rxBuffer_.size());
+        if (!message) {
+            std::cerr << "[SHM] Failed to deserialize message, size=" << rxBuffer_.size() << std::endl;
+            continue;
+        }
+        if (message->type() == protocol::MessageType::HelloAck) {
+            assignedId_ = static_cast<const protocol::HelloAckMessage&>(*message).assignedId;
+        }
+        return message;
+    }
+    return nullptr;
+}
+
+bool SharedMemoryTransport::hasMessage() const {
+    if (!segment_ || state_ == TransportState::Error) {
+        return false;
+    }
+    const ShmRing& ring = inRing();
+    return ring.head.load(std::memory_order_acquire) != ring.tail.load(std::memory_order_relaxed);
+}
+
+bool SharedMemoryTransport::waitForMessage(std::chrono::microseconds timeout) {
+    if (!segment_ || hasMessage()) {
+        return hasMessage();
+    }
+    ShmRing& ring = inRing();
+    ring.consumerWaiting.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const uint32_t seq = ring.wakeSeq.load(std::memory_order_acquire);
+    if (!hasMessage() && timeout.count() > 0) {
+        futexWait(ring.wakeSeq, seq, timeout);
+    }
+    ring.consumerWaiting.store(0, std::memory_order_relaxed);
+    return hasMessage();
+}
+
+std::string SharedMemoryTransport::info() const {
+    return "Shared-Memory Transport: " + name_ + (isCreator() ? " (creator)" : " (attached)");
+}
+
+} // namespace aeth
@@ -0,0 +1,133 @@
+/**
+ * Aetherium Automata - Shared-Memory Transport
+ *
+ * Connects two co-located processes (engines, or an engine and the local
+ * controller bridge) through a POSIX shared-memory segment instead of the
+ * server. Each direction is a lock-free single-producer/single-consumer
+ * byte ring of length-prefixed frames; a blocked reader sleeps on a futex
+ * in the segment (Linux) and is woken by the writer.
+ */
+
+#ifndef AETHERIUM_SHM_TRANSPORT_HPP
+#define AETHERIUM_SHM_TRANSPORT_HPP
+
+#include "transport.hpp"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace aeth {
+
+/**
+ * One direction of a shared-memory link, laid out in the segment.
+ * head/tail count bytes ever written/read; the frame bytes follow the
+ * struct. Only lock-free atomics are used, so both processes agree.
+ */
+struct ShmRing {
+    alignas(64) std::atomic<uint64_t> head;  // Written by the producer
+    alignas(64) std::atomic<uint64_t> tail;  // Written by the consumer
+    alignas(64) std::atomic<uint32_t> wakeSeq;  // Futex word, bumped per publish
+    std::atomic<uint32_t> consumerWaiting;
+
+    [[nodiscard]] uint8_t* data() { return reinterpret_cast<uint8_t*>(this + 1); }
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory rings need lock-free 64-bit atomics");
+
+/**
+ * Transport over a named shared-memory segment. The first process to
+ * connect creates the segment; the second attaches to it. The rings carry
+ * opaque frames: send()/receive() use the v1 protocol frames the WebSocket
+ * transport carries, while a peer speaking protocol_v2 (ProtocolCodecV2)
+ * exchanges its frames through sendRaw()/receiveRaw().
+ */
+class SharedMemoryTransport : public ITransport {
+public:
+    static constexpr size_t DEFAULT_RING_BYTES = 1 << 20;  // Per direction
+    static constexpr const char* URL_SCHEME = "shm://";
+
+    /**
+     * name: segment name without the leading '/' (e.g. "cell-a").
+     * ringBytes is rounded up to a power of two; an attaching peer uses
+     * the creator's size.
+     */
+    explicit SharedMemoryTransport(std::string name, size_t ringBytes = DEFAULT_RING_BYTES);
+    ~SharedMemoryTransport() override;
+
+    SharedMemoryTransport(const SharedMemoryTransport&) = delete;
+    SharedMemoryTransport& operator=(const SharedMemoryTransport&) = delete;
+
+    // "shm://<name>" selects this transport where a server URL is expected
+    [[nodiscard]] static bool isShmUrl(const std::string& url);
+
+    // ITransport interface
+    Result<void> connect() override;
+    void disconnect() override;
+    [[nodiscard]] TransportState state() const override { return state_; }
+
+    bool send(std::unique_ptr<protocol::Message> msg) override;
+    bool sendRaw(const uint8_t* data, size_t len) override;
+    std::unique_ptr<protocol::Message> receive() override;
+    // Next frame as sent, without decoding (for protocol_v2 peers)
+    bool receiveRaw(std::vector<uint8_t>& out);
+    [[nodiscard]] bool hasMessage() const override;
+    bool waitForMessage(std::chrono::microseconds timeout) override;
+    [[nodiscard]] bool canWait() const override { return true; }
+    [[nodiscard]] uint32_t assignedId() const override { return assignedId_; }
+
+    [[nodiscard]] std::string info() const override;
+    [[nodiscard]] std::string name() const override { return "shm"; }
+
+    // Hello sent on connect, as over WebSocket; off for engine-to-engine links
+    void setSendHello(bool on) { sendHello_ = on; }
+    void setDeviceName(const std::string& name) { deviceName_ = name; }
+    void setHelloDeploymentMetadata(protocol::DeploymentMetadataExtension deployment) {
+        helloDeployment_ = std::move(deployment);
+    }
+
+    // Whether the other side is attached to the segment
+    [[nodiscard]] bool peerAttached() const;
+    [[nodiscard]] bool isCreator() const { return side_ == 0; }
+
+    // Sends refused because the outbound ring was full
+    [[nodiscard]] uint64_t droppedSends() const { return droppedSends_; }
+
+private:
+    struct Segment;
+    enum class MapFailure : uint8_t { None, Exists, Stale, Other };
+
+    Result<void> map(bool create);
+    void unmap();
+    ShmRing& outRing() const;
+    ShmRing& inRing() const;
+    bool writeFrame(const uint8_t* data, size_t len);
+    bool readFrame();  // Into rxBuffer_; a corrupt length prefix puts the link in Error
+    void sendHelloMessage();
+
+    std::string name_;
+    size_t ringBytes_;
+    int fd_ = -1;
+    void* base_ = nullptr;
+    size_t mappedBytes_ = 0;
+    Segment* segment_ = nullptr;
+    int side_ = 0;  // 0 = creator, 1 = attached
+    MapFailure mapFailure_ = MapFailure::None;
+    TransportState state_ = TransportState::Disconnected;
+
+    bool sendHello_ = true;
+    std::string deviceName_ = "cpp-engine";
+    protocol::DeploymentMetadataExtension helloDeployment_;
+
+    // Several threads send (engine loop, log dispatcher); the ring has one producer
+    std::mutex sendMutex_;
+    protocol::ByteWriter sendWriter_;
+    std::vector<uint8_t> rxBuffer_;
+    uint32_t nextMsgId_ = 1;
+    uint32_t assignedId_ = 0;
+    uint64_t droppedSends_ = 0;
+};
+
+} // namespace aeth
+
+#endif // AETHERIUM_SHM_TRANSPORT_HPP
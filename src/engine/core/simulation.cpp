@@ -0,0 +1,268 @@
+#include "simulation.hpp"
+#include "tick_scheduler.hpp"
+
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace aeth {
+
+namespace {
+
+std::string trim(const std::string& s) {
+    const auto first = s.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+        return "";
+    }
+    const auto last = s.find_last_not_of(" \t\r");
+    return s.substr(first, last - first + 1);
+}
+
+// "250", "90s", "1.5m", "2h"
+std::optional<Timestamp> parseTimelineTime(const std::string& token) {
+    if (token.empty()) {
+        return std::nullopt;
+    }
+    errno = 0;
+    char* end = nullptr;
+    const double amount = std::strtod(token.c_str(), &end);
+    if (end == token.c_str() || errno != 0 || !(amount >= 0.0)) {
+        return std::nullopt;
+    }
+    const std::string unit(end);
+    double scale = 0.0;
+    if (unit.empty() || unit == "ms") scale = 1.0;
+    else if (unit == "s") scale = 1000.0;
+    else if (unit == "m") scale = 60.0 * 1000.0;
+    else if (unit == "h") scale = 60.0 * 60.0 * 1000.0;
+    else return std::nullopt;
+    return static_cast<Timestamp>(std::llround(amount * scale));
+}
+
+} // namespace
+
+// ============================================================================
+// InputTimeline
+// ============================================================================
+
+Result<InputTimeline> InputTimeline::parse(const std::string& text) {
+    using R = Result<InputTimeline>;
+    InputTimeline timeline;
+    std::istringstream in(text);
+    std::string raw;
+    size_t lineNo = 0;
+    while (std::getline(in, raw)) {
+        ++lineNo;
+        const std::string line = trim(raw);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string when;
+        TimelineEvent event;
+        fields >> when >> event.variable;
+        std::getline(fields, event.text);
+        event.text = trim(event.text);
+        event.line = lineNo;
+
+        const auto at = parseTimelineTime(when);
+        if (!at) {
+            return R::error("line " + std::to_string(lineNo) + ": bad time '" + when + "'");
+        }
+        if (event.variable.empty() || event.text.empty()) {
+            return R::error("line " + std::to_string(lineNo) + ": expected <time> <variable> <value>");
+        }
+        event.atMs = *at;
+        timeline.add(std::move(event));
+    }
+    return R::ok(std::move(timeline));
+}
+
+Result<InputTimeline> InputTimeline::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return Result<InputTimeline>::error("cannot open input timeline: " + path);
+    }
+    std::ostringstream text;
+    text << file.rdbuf();
+    auto parsed = parse(text.str());
+    if (parsed.isError()) {
+        return Result<InputTimeline>::error(path + ": " + parsed.error());
+    }
+    return parsed;
+}
+
+void InputTimeline::add(TimelineEvent event) {
+    // Stable for equal times: append, then walk back past later events
+    auto pos = events_.end();
+    while (pos != events_.begin() && std::prev(pos)->atMs > event.atMs) {
+        --pos;
+    }
+    events_.insert(pos, std::move(event));
+}
+
+std::optional<Value> parseTimelineValue(const std::string& text, ValueType type) {
+    errno = 0;
+    char* end = nullptr;
+    switch (type) {
+        case ValueType::Bool:
+            if (text == "true" || text == "1") return Value(true);
+            if (text == "false" || text == "0") return Value(false);
+            return std::nullopt;
+        case ValueType::Int32:
+        case ValueType::Int64: {
+            const long long v = std::strtoll(text.c_str(), &end, 10);
+            if (end == text.c_str() || *end != '\0' || errno != 0) return std::nullopt;
+            if (type == ValueType::Int64) return Value(static_cast<int64_t>(v));
+            if (v < INT32_MIN || v > INT32_MAX) return std::nullopt;
+            return Value(static_cast<int32_t>(v));
+        }
+        case ValueType::Float32:
+        case ValueType::Float64: {
+            const double v = std::strtod(text.c_str(), &end);
+            if (end == text.c_str() || *end != '\0' || errno != 0) return std::nullopt;
+            return type == ValueType::Float32 ? Value(static_cast<float>(v)) : Value(v);
+        }
+        case ValueType::String:
+            if (text.size() >= 2 && text.front() == '"' && text.back() == '"') {
+                return Value(text.substr(1, text.size() - 2));
+            }
+            return Value(text);
+        default:
+            return std::nullopt;
+    }
+}
+
+// ============================================================================
+// Simulation
+// ============================================================================
+
+Result<SimulationReport> runSimulation(Engine& engine,
+                                       VirtualClock& clock,
+                                       const InputTimeline& timeline,
+                                       const SimulationOptions& options) {
+    using R = Result<SimulationReport>;
+    SimulationReport report;
+
+    // Resolve every event first, so a typo fails now rather than hours into the run
+    const auto& events = timeline.events();
+    std::vector<Value> values;
+    values.reserve(events.size());
+    for (const auto& event : events) {
+        const Variable* var = engine.variables().getByName(event.variable);
+        if (!var) {
+            return R::error("line " + std::to_string(event.line) + ": unknown variable '" + event.variable + "'");
+        }
+        auto value = parseTimelineValue(event.text, var->type());
+        if (!value) {
+            return R::error("line " + std::to_string(event.line) + ": '" + event.text + "' is not a valid " +
+                            event.variable + " value");
+        }
+        values.push_back(std::move(*value));
+    }
+
+    // Unlimited rate: one tick slot per virtual millisecond
+    TickScheduler scheduler(engine.maxTickRate() > 0 ? engine.maxTickRate() : 1000);
+    const Timestamp startMs = clock.now();
+    const std::optional<Timestamp> endMs =
+        options.durationMs > 0 ? std::optional<Timestamp>(startMs + options.durationMs) : std::nullopt;
+    const EngineStatus initial = engine.status();
+    uint32_t nextMessageId = 0;
+    size_t next = 0;
+    bool idle = false;
+    std::optional<Timestamp> lastTickMs;
+
+    auto drain = [&] {
+        for (const auto& reply : engine.processCommandQueue()) {
+            if (reply && reply->type() == protocol::MessageType::Nak) {
+                report.inputErrors.push_back(static_cast<const protocol::NakMessage&>(*reply).reason);
+            }
+        }
+    };
+
+    while (engine.isRunning()) {
+        const Timestamp now = clock.now();
+        if (endMs && now >= *endMs) {
+            break;
+        }
+
+        bool delivered = false;
+        while (next < events.size() && startMs + events[next].atMs <= now) {
+            auto input = std::make_unique<protocol::InputMessage>();
+            input->messageId = ++nextMessageId;
+            input->runId = engine.activeRunId();
+            input->variableName = events[next].variable;
+            input->value = values[next];
+            engine.enqueueCommand(std::move(input));
+            ++report.inputsApplied;
+            ++next;
+            delivered = true;
+        }
+        drain();
+        if (delivered) {
+            idle = false;  // The input handler ticked; the new values may keep changing things
+            lastTickMs = now;
+        }
+        if (!engine.isRunning()) {
+            break;
+        }
+
+        if (scheduler.due(now * 1000, engine.msUntilNextTimer())) {
+            const EngineStatus before = engine.status();
+            const uint64_t revision = engine.variables().revision();
+            engine.tick();
+            scheduler.ticked(now * 1000);
+            lastTickMs = now;
+            const EngineStatus after = engine.status();
+            idle = options.skipIdleTicks && after.transitionCount == before.transitionCount &&
+                   after.currentState == before.currentState && after.executionState == before.executionState &&
+                   engine.variables().revision() == revision;
+            drain();
+        }
+
+        const EngineStatus status = engine.status();
+        if (options.maxTicks > 0 && status.tickCount - initial.tickCount >= options.maxTicks) {
+            break;
+        }
+        if (options.maxTransitions > 0 && status.transitionCount - initial.transitionCount >= options.maxTransitions) {
+            break;
+        }
+
+        // Next moment anything can happen; an idle automaton waits for a timer or input
+        const auto timer = engine.msUntilNextTimer();
+        const Timestamp slotMs = now + (scheduler.waitUs(now * 1000, timer, UINT64_MAX) + 999) / 1000;
+        std::optional<Timestamp> wake;
+        auto consider = [&wake](Timestamp at) {
+            if (!wake || at < *wake) {
+                wake = at;
+            }
+        };
+        if (!idle) consider(slotMs);
+        if (timer) consider(now + *timer);
+        if (next < events.size()) consider(startMs + events[next].atMs);
+        if (auto release = engine.nextReleaseAt()) consider(*release);
+        if (endMs) consider(*endMs);
+        if (!wake) {
+            break;  // Fixed point with nothing scheduled
+        }
+        // At most one scheduled tick per virtual millisecond, so a timer stuck at 0 cannot spin
+        if (*wake <= now && lastTickMs == now) {
+            wake = now + 1;
+        }
+        if (idle && *wake > slotMs) {
+            ++report.idleJumps;
+        }
+        clock.advanceTo(*wake);
+    }
+    drain();
+
+    report.endMs = clock.now();
+    report.ticks = engine.status().tickCount - initial.tickCount;
+    return R::ok(std::move(report));
+}
+
+} // namespace aeth
@@ -0,0 +1,120 @@
+/**
+ * Aetherium Automata - Virtual-Time Simulation
+ *
+ * Runs an Engine on a VirtualClock as a discrete-event simulation: the
+ * clock never waits, it jumps to the next tick slot, timer deadline or
+ * scripted input. A tick that changes nothing (no transition, no variable
+ * write, same state) is a fixed point of the automaton, so the following
+ * slots are skipped until a timer or input can change the outcome. A day
+ * of minute-long timers then costs a few thousand ticks.
+ *
+ * Inputs are delivered as Input commands through the normal command queue,
+ * so the trace (ingress, state and output records, stamped in virtual ms
+ * with EngineInitOptions::virtualTime) matches what a real run records.
+ *
+ * Bodies that read the clock or draw random numbers without a timer are
+ * not fixed points; run those with skipIdleTicks = false.
+ */
+
+#ifndef AETHERIUM_SIMULATION_HPP
+#define AETHERIUM_SIMULATION_HPP
+
+#include "engine.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace aeth {
+
+/**
+ * Clock that only moves when told to. sleep() advances it, so code that
+ * waits on the clock takes no wall time.
+ */
+class VirtualClock : public IClock {
+public:
+    explicit VirtualClock(Timestamp startMs = 0) : nowMs_(startMs) {}
+
+    Timestamp now() override { return nowMs_; }
+    void sleep(uint32_t ms) override { nowMs_ += ms; }
+
+    // Never moves backwards
+    void advanceTo(Timestamp ms) { nowMs_ = std::max(nowMs_, ms); }
+
+private:
+    Timestamp nowMs_;
+};
+
+/**
+ * One scripted input: at `atMs` (virtual), set `variable` from `text`,
+ * which is read as the variable's type when the event is delivered.
+ */
+struct TimelineEvent {
+    Timestamp atMs = 0;
+    std::string variable;
+    std::string text;
+    size_t line = 0;  // Source line, for error messages
+};
+
+/**
+ * Scripted input timeline. Text format, one event per line:
+ *
+ *     # time  variable  value
+ *     0       enabled   true
+ *     90s     setpoint  21.5
+ *     2h      mode      "eco"
+ *
+ * Times are milliseconds from the start of the run, or take an ms/s/m/h
+ * suffix. The value is the rest of the line (quotes around a string are
+ * dropped). Blank lines and lines starting with `#` are ignored; events
+ * are kept in time order (stable for equal times).
+ */
+class InputTimeline {
+public:
+    static Result<InputTimeline> parse(const std::string& text);
+    static Result<InputTimeline> load(const std::string& path);
+
+    void add(TimelineEvent event);
+
+    [[nodiscard]] const std::vector<TimelineEvent>& events() const { return events_; }
+    [[nodiscard]] bool empty() const { return events_.empty(); }
+    [[nodiscard]] Timestamp endMs() const { return events_.empty() ? 0 : events_.back().atMs; }
+
+private:
+    std::vector<TimelineEvent> events_;
+};
+
+// Read `text` as a value of `type`; nullopt if it does not parse (binary is never accepted)
+std::optional<Value> parseTimelineValue(const std::string& text, ValueType type);
+
+struct SimulationOptions {
+    // Virtual ms to stop at. 0 = run until the timeline is exhausted and
+    // nothing (no tick slot, timer or input) is left to happen.
+    Timestamp durationMs = 0;
+    bool skipIdleTicks = true;
+    uint64_t maxTicks = 0;        // 0 = unlimited
+    uint64_t maxTransitions = 0;  // 0 = unlimited
+};
+
+struct SimulationReport {
+    Timestamp endMs = 0;       // Virtual time when the run stopped
+    uint64_t ticks = 0;        // Ticks run (including those input commands run)
+    uint64_t idleJumps = 0;    // Times the clock skipped past idle tick slots
+    size_t inputsApplied = 0;
+    std::vector<std::string> inputErrors;  // Inputs the engine refused
+};
+
+/**
+ * Drive `engine` (constructed on `clock`, loaded and started) through
+ * `timeline` in virtual time. Errors only when an event names an unknown
+ * variable or its value does not parse; refused inputs are reported.
+ */
+Result<SimulationReport> runSimulation(Engine& engine,
+                                       VirtualClock& clock,
+                                       const InputTimeline& timeline,
+                                       const SimulationOptions& options = {});
+
+} // namespace aeth
+
+#endif // AETHERIUM_SIMULATION_HPP
@@ -0,0 +1,133 @@
+/**
+ * Aetherium Automata - SPSC Ring
+ *
+ * Bounded lock-free queue for exactly one producer thread and one
+ * consumer thread (e.g. a transport receive thread handing messages to the
+ * engine loop). Capacity is rounded up to a power of two. Head and tail
+ * live on separate cache lines, and each side caches the other's index so
+ * the shared line is only re-read when the ring looks full or empty.
+ */
+
+#ifndef AETHERIUM_SPSC_RING_HPP
+#define AETHERIUM_SPSC_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace aeth {
+
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity);
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * Producer side. Returns false (value untouched) when full.
+     */
+    bool tryPush(T&& value);
+
+    /**
+     * Consumer side. Returns false when empty.
+     */
+    bool tryPop(T& out);
+
+    /**
+     * Consumer side: pop up to max entries into fn(T&&); returns the count.
+     * Publishes the new head once for the whole batch.
+     */
+    template <typename Fn>
+    size_t drain(Fn&& fn, size_t max);
+
+    [[nodiscard]] bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+    [[nodiscard]] size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+    [[nodiscard]] size_t capacity() const { return slots_.size(); }
+
+private:
+    static size_t roundUp(size_t value);
+
+    std::vector<T> slots_;
+    size_t mask_;
+
+    alignas(64) std::atomic<size_t> head_{0};  // Next slot to pop (consumer-owned)
+    size_t cachedTail_ = 0;                    // Consumer's view of tail_
+
+    alignas(64) std::atomic<size_t> tail_{0};  // Next slot to fill (producer-owned)
+    size_t cachedHead_ = 0;                    // Producer's view of head_
+};
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+template <typename T>
+SpscRing<T>::SpscRing(size_t capacity)
+    : slots_(roundUp(capacity))
+    , mask_(slots_.size() - 1) {}
+
+template <typename T>
+size_t SpscRing<T>::roundUp(size_t value) {
+    size_t out = 2;
+    while (out < value) {
+        out <<= 1;
+    }
+    return out;
+}
+
+template <typename T>
+bool SpscRing<T>::tryPush(T&& value) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cachedHead_ == slots_.size()) {
+        cachedHead_ = head_.load(std::memory_order_acquire);
+        if (tail - cachedHead_ == slots_.size()) {
+            return false;
+        }
+    }
+    slots_[tail & mask_] = std::move(value);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool SpscRing<T>::tryPop(T& out) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == cachedTail_) {
+        cachedTail_ = tail_.load(std::memory_order_acquire);
+        if (head == cachedTail_) {
+            return false;
+        }
+    }
+    out = std::move(slots_[head & mask_]);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+template <typename Fn>
+size_t SpscRing<T>::drain(Fn&& fn, size_t max) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    cachedTail_ = tail_.load(std::memory_order_acquire);
+    size_t count = cachedTail_ - head;
+    if (count > max) {
+        count = max;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        fn(std::move(slots_[(head + i) & mask_]));
+    }
+    if (count > 0) {
+        head_.store(head + count, std::memory_order_release);
+    }
+    return count;
+}
+
+} // namespace aeth
+
+#endif // AETHERIUM_SPSC_RING_HPP
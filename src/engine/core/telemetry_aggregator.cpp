@@ -0,0 +1,164 @@
+#include "telemetry_aggregator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace aeth {
+
+namespace {
+
+bool isNumeric(ValueType type) {
+    switch (type) {
+        case ValueType::Bool:
+        case ValueType::Int32:
+        case ValueType::Int64:
+        case ValueType::Float32:
+        case ValueType::Float64:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+void TelemetryAggregator::bind(const std::vector<VariableSpec>& specs, const VariableStore& variables, Timestamp now) {
+    clear();
+    for (const auto& spec : specs) {
+        if (spec.direction != VariableDirection::Output || !spec.telemetry.enabled()) {
+            continue;
+        }
+        const Variable* var = variables.getByName(spec.name);
+        if (!var) {
+            continue;
+        }
+        Slot slot;
+        slot.id = var->id();
+        slot.name = spec.name;
+        slot.policy = spec.telemetry;
+        slot.numeric = isNumeric(spec.type);
+        if (slot.policy.windowMs > 0) {
+            const uint32_t slide = slot.policy.slideMs > 0 ? slot.policy.slideMs : slot.policy.windowMs;
+            slot.buckets.resize((slot.policy.windowMs + slide - 1) / slide);
+            slot.bucketEnd = now + slide;
+        }
+        if (slotOf_.size() <= slot.id) {
+            slotOf_.resize(static_cast<size_t>(slot.id) + 1, -1);
+        }
+        slotOf_[slot.id] = static_cast<int32_t>(slots_.size());
+        slots_.push_back(std::move(slot));
+    }
+}
+
+void TelemetryAggregator::clear() {
+    slots_.clear();
+    slotOf_.clear();
+    closed_.clear();
+}
+
+bool TelemetryAggregator::offer(const Variable& var, Timestamp now) {
+    const VariableId id = var.id();
+    if (id >= slotOf_.size() || slotOf_[id] < 0) {
+        return true;
+    }
+    Slot& slot = slots_[static_cast<size_t>(slotOf_[id])];
+    const Value& value = var.value();
+    const double number = slot.numeric ? value.toDouble() : 0.0;
+
+    if (slot.numeric && slot.policy.deadband > 0.0 && slot.accepted &&
+        std::fabs(number - slot.acceptedValue) < slot.policy.deadband) {
+        ++suppressed_;
+        return false;
+    }
+    slot.accepted = true;
+    slot.acceptedValue = number;
+
+    if (slot.policy.windowMs > 0) {
+        // A window that ended before this change closes without it
+        closeBuckets(slot, now, closed_);
+        Bucket& bucket = slot.buckets[slot.head];
+        if (bucket.count == 0 || number < bucket.min) {
+            bucket.min = number;
+        }
+        if (bucket.count == 0 || number > bucket.max) {
+            bucket.max = number;
+        }
+        bucket.sum += number;
+        ++bucket.count;
+        slot.last = value;
+        ++suppressed_;
+        return false;
+    }
+
+    if (slot.policy.minIntervalMs > 0 && slot.sent && now - slot.lastSent < slot.policy.minIntervalMs) {
+        slot.pending = true;
+        ++suppressed_;
+        return false;
+    }
+    slot.pending = false;
+    slot.sent = true;
+    slot.lastSent = now;
+    return true;
+}
+
+void TelemetryAggregator::poll(Timestamp now, std::vector<VariableId>& released,
+                               std::vector<protocol::OutputAggregateMessage>& closed) {
+    for (auto& entry : closed_) {
+        closed.push_back(std::move(entry));
+    }
+    closed_.clear();
+    for (Slot& slot : slots_) {
+        if (slot.policy.windowMs > 0) {
+            closeBuckets(slot, now, closed);
+        } else if (slot.pending && now - slot.lastSent >= slot.policy.minIntervalMs) {
+            slot.pending = false;
+            slot.lastSent = now;
+            released.push_back(slot.id);
+        }
+    }
+}
+
+void TelemetryAggregator::closeBuckets(Slot& slot, Timestamp now,
+                                       std::vector<protocol::OutputAggregateMessage>& closed) {
+    const uint32_t slide = slot.policy.slideMs > 0 ? slot.policy.slideMs : slot.policy.windowMs;
+    while (now >= slot.bucketEnd) {
+        Bucket total;
+        for (const Bucket& bucket : slot.buckets) {
+            if (bucket.count == 0) {
+                continue;
+            }
+            total.min = total.count == 0 ? bucket.min : std::min(total.min, bucket.min);
+            total.max = total.count == 0 ? bucket.max : std::max(total.max, bucket.max);
+            total.sum += bucket.sum;
+            total.count += bucket.count;
+        }
+        if (total.count > 0) {
+            protocol::OutputAggregateMessage aggregate;
+            aggregate.variableId = slot.id;
+            aggregate.variableName = slot.name;
+            aggregate.windowStart = slot.bucketEnd - slot.buckets.size() * slide;
+            aggregate.windowEnd = slot.bucketEnd;
+            aggregate.count = total.count;
+            if (slot.numeric) {
+                aggregate.min = Value(total.min);
+                aggregate.max = Value(total.max);
+                aggregate.mean = Value(total.sum / total.count);
+            }
+            aggregate.last = slot.last;
+            closed.push_back(std::move(aggregate));
+            ++aggregates_;
+        }
+
+        slot.head = (slot.head + 1) % slot.buckets.size();
+        slot.buckets[slot.head] = Bucket{};
+        slot.bucketEnd += slide;
+        const bool idle = std::all_of(slot.buckets.begin(), slot.buckets.end(),
+                                      [](const Bucket& bucket) { return bucket.count == 0; });
+        if (idle && now >= slot.bucketEnd) {
+            // Nothing left to report: skip the empty windows in one step, on the same grid
+            slot.bucketEnd += (now - slot.bucketEnd) / slide * slide + slide;
+        }
+    }
+}
+
+} // namespace aeth
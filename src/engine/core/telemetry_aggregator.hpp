@@ -0,0 +1,85 @@
+#ifndef AETHERIUM_TELEMETRY_AGGREGATOR_HPP
+#define AETHERIUM_TELEMETRY_AGGREGATOR_HPP
+
+#include "protocol.hpp"
+#include "variable.hpp"
+
+#include <string>
+#include <vector>
+
+namespace aeth {
+
+/**
+ * Applies the outputs' TelemetryPolicy on the way to the server. Outputs
+ * without a policy pass through untouched; the others are deadband
+ * filtered and either rate limited or summarized per window, so the uplink
+ * carries one OUTPUT_AGGREGATE per window instead of every raw sample.
+ *
+ * Windows are cut on the engine's event clock and only close in poll(),
+ * i.e. at tick boundaries. Sliding windows keep one bucket per slide.
+ */
+class TelemetryAggregator {
+public:
+    // Slots for the outputs of `specs` that have a policy; windows start at `now`
+    void bind(const std::vector<VariableSpec>& specs, const VariableStore& variables, Timestamp now);
+    void clear();
+
+    [[nodiscard]] bool empty() const { return slots_.empty(); }
+    [[nodiscard]] size_t slotCount() const { return slots_.size(); }
+
+    /**
+     * An output changed at `now`. Returns whether the change should go to
+     * the server as it is; otherwise it was dropped by the deadband, held by
+     * the rate limit or added to the output's window.
+     */
+    bool offer(const Variable& var, Timestamp now);
+
+    /**
+     * Collect the rate-limited outputs whose interval has passed (their
+     * current value is due) and the windows `now` closed. Appends to both.
+     */
+    void poll(Timestamp now, std::vector<VariableId>& released,
+              std::vector<protocol::OutputAggregateMessage>& closed);
+
+    [[nodiscard]] uint64_t suppressedCount() const { return suppressed_; }
+    [[nodiscard]] uint64_t aggregateCount() const { return aggregates_; }
+
+private:
+    struct Bucket {
+        uint32_t count = 0;
+        double sum = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+    };
+
+    struct Slot {
+        VariableId id = INVALID_VARIABLE;
+        std::string name;
+        TelemetryPolicy policy;
+        bool numeric = false;
+
+        bool accepted = false;      // acceptedValue holds the last change let through
+        double acceptedValue = 0.0;
+
+        bool pending = false;       // Rate limited: a change waits for the interval
+        bool sent = false;
+        Timestamp lastSent = 0;
+
+        std::vector<Bucket> buckets;  // Ring of slides making up the window
+        size_t head = 0;              // Bucket being filled
+        Timestamp bucketEnd = 0;      // When buckets[head] closes
+        Value last;
+    };
+
+    void closeBuckets(Slot& slot, Timestamp now, std::vector<protocol::OutputAggregateMessage>& closed);
+
+    std::vector<Slot> slots_;
+    std::vector<int32_t> slotOf_;  // Indexed by VariableId, -1 = no policy
+    std::vector<protocol::OutputAggregateMessage> closed_;  // Closed by offer(), handed out by poll()
+    uint64_t suppressed_ = 0;
+    uint64_t aggregates_ = 0;
+};
+
+} // namespace aeth
+
+#endif // AETHERIUM_TELEMETRY_AGGREGATOR_HPP
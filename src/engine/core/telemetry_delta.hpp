@@ -0,0 +1,124 @@
+/**
+ * Aetherium Automata - Telemetry Delta Tracker
+ *
+ * Decides what goes into the next TelemetryDelta frame. Until the
+ * controller has acknowledged a keyframe every frame is a keyframe; after
+ * that a frame carries the variables whose store revision is newer than
+ * the last acknowledged frame. Deltas are cumulative from that base, so a
+ * dropped frame is repaired by the next one without retransmission.
+ */
+
+#ifndef AETHERIUM_TELEMETRY_DELTA_HPP
+#define AETHERIUM_TELEMETRY_DELTA_HPP
+
+#include "protocol.hpp"
+#include "variable.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace aeth {
+
+class TelemetryDeltaTracker {
+public:
+    // Unacknowledged frames remembered for ack lookup; older ones are dropped
+    static constexpr size_t MAX_IN_FLIGHT = 32;
+
+    /**
+     * Forget acknowledgements; the next frame is a keyframe. Call when the
+     * variable set changes (new load) or the controller asks for one.
+     */
+    void reset() {
+        inFlight_.clear();
+        ackedSequence_ = 0;
+        ackedRevision_ = 0;
+        keyframeAcked_ = false;
+    }
+
+    /**
+     * Fill the next frame from the store. Returns false (out untouched)
+     * when a keyframe is acknowledged and nothing changed since the base.
+     */
+    bool build(const VariableStore& store, protocol::TelemetryDeltaMessage& out) {
+        const bool keyframe = !keyframeAcked_;
+        out.names.clear();
+        out.values.clear();
+
+        if (keyframe) {
+            const bool names = includeNames_;
+            store.forEach([&out, names](const Variable& var) {
+                if (names) {
+                    out.names.push_back(protocol::SymbolEntry{var.id(), var.name()});
+                }
+                out.values.push_back(VariableUpdate{var.id(), var.value()});
+            });
+            std::sort(out.names.begin(), out.names.end(),
+                      [](const auto& a, const auto& b) { return a.id < b.id; });
+        } else {
+            store.forEachChangedSince(ackedRevision_, [&out](const Variable& var) {
+                out.values.push_back(VariableUpdate{var.id(), var.value()});
+            });
+            if (out.values.empty()) {
+                return false;
+            }
+        }
+        std::sort(out.values.begin(), out.values.end(),
+                  [](const auto& a, const auto& b) { return a.id < b.id; });
+
+        out.keyframe = keyframe;
+        out.sequence = nextSequence_++;
+        if (nextSequence_ == 0) {
+            nextSequence_ = 1;  // 0 means "no frame" in acks
+        }
+        out.baseSequence = keyframe ? 0 : ackedSequence_;
+
+        if (inFlight_.size() == MAX_IN_FLIGHT) {
+            inFlight_.erase(inFlight_.begin());
+        }
+        inFlight_.push_back(Sent{out.sequence, store.revision(), keyframe});
+        return true;
+    }
+
+    /**
+     * Controller acknowledged `sequence`. Unknown or stale sequences are
+     * ignored. Returns true if the base moved.
+     */
+    bool acknowledge(uint32_t sequence) {
+        auto it = std::find_if(inFlight_.begin(), inFlight_.end(),
+                               [sequence](const Sent& sent) { return sent.sequence == sequence; });
+        if (it == inFlight_.end()) {
+            return false;
+        }
+        if (it->keyframe || keyframeAcked_) {
+            ackedSequence_ = it->sequence;
+            ackedRevision_ = std::max(ackedRevision_, it->revision);
+            keyframeAcked_ = true;
+        }
+        inFlight_.erase(inFlight_.begin(), it + 1);
+        return true;
+    }
+
+    // Keyframe names are redundant once a SymbolTable has been sent
+    void setIncludeNames(bool include) { includeNames_ = include; }
+
+    [[nodiscard]] bool keyframeAcked() const { return keyframeAcked_; }
+    [[nodiscard]] uint32_t ackedSequence() const { return ackedSequence_; }
+
+private:
+    struct Sent {
+        uint32_t sequence;
+        uint64_t revision;  // Store revision the frame reflects
+        bool keyframe;
+    };
+
+    std::vector<Sent> inFlight_;
+    uint32_t nextSequence_ = 1;
+    uint32_t ackedSequence_ = 0;
+    uint64_t ackedRevision_ = 0;
+    bool keyframeAcked_ = false;
+    bool includeNames_ = true;
+};
+
+} // namespace aeth
+
+#endif // AETHERIUM_TELEMETRY_DELTA_HPP
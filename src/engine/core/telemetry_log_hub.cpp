@@ -5,6 +5,7 @@
 #endif
 
 #include <algorithm>
+#include <cstring>
 
 #ifdef abs
 #undef abs
@@ -14,15 +15,64 @@
 
 namespace aeth {
 
+namespace {
+
+// Copies at most `capacity` bytes; returns the stored length
+size_t copyTruncated(char* dst, size_t capacity, const char* src, size_t len) {
+    const size_t n = std::min(len, capacity);
+    std::memcpy(dst, src, n);
+    return n;
+}
+
+} // namespace
+
 TelemetryLogHub::TelemetryLogHub(size_t capacity)
     : capacity_(std::max<size_t>(capacity, 1)) {}
 
+TelemetryLogHub::~TelemetryLogHub() {
+#if defined(AETHERIUM_LOG_ASYNC_STREAMS)
+    {
+        std::lock_guard<std::mutex> lock(dispatchMutex_);
+        stopping_ = true;
+    }
+    queued_.notify_all();
+    drained_.notify_all();
+    if (dispatcher_.joinable()) {
+        dispatcher_.join();
+    }
+#endif
+}
+
 void TelemetryLogHub::setCapacity(size_t capacity) {
     compat::LockGuard<compat::Mutex> lock(mutex_);
-    capacity_ = std::max<size_t>(capacity, 1);
-    while (ring_.size() > capacity_) {
-        ring_.pop_front();
+    capacity = std::max<size_t>(capacity, 1);
+    if (capacity == capacity_) {
+        return;
     }
+
+    Slot* old = ready_.load(std::memory_order_acquire);
+    if (old == nullptr) {
+        capacity_ = capacity;
+        return;
+    }
+
+    // Move the newest committed events into their slots in the new ring
+    std::unique_ptr<Slot[]> fresh(new Slot[capacity]);
+    const uint64_t last = nextSeq_.load(std::memory_order_acquire) - 1;
+    const uint64_t keep = std::min<uint64_t>({last, capacity_, capacity});
+    for (uint64_t seq = last - keep + 1; seq <= last && keep > 0; ++seq) {
+        const Slot& from = old[(seq - 1) % capacity_];
+        if (from.state.load(std::memory_order_acquire) != seq) {
+            continue;
+        }
+        Slot& to = fresh[(seq - 1) % capacity];
+        to.record = from.record;
+        to.state.store(seq, std::memory_order_relaxed);
+    }
+
+    capacity_ = capacity;
+    slots_ = std::move(fresh);
+    ready_.store(slots_.get(), std::memory_order_release);
 }
 
 uint64_t TelemetryLogHub::log(LogLevel level,
@@ -37,96 +87,390 @@ uint64_t TelemetryLogHub::event(EventKind kind,
                                 const std::string& category,
                                 const std::string& message,
                                 std::optional<RunId> runId) {
-    LogEvent entry;
-    entry.timestamp = nowMs();
-    entry.kind = kind;
-    entry.level = level;
-    entry.category = category;
-    entry.message = message;
-    entry.runId = runId;
-    return push(std::move(entry));
+    return push(kind, level, category, message, [&runId](Record& record) {
+        if (runId) {
+            record.runId = *runId;
+            record.flags |= HasRunId;
+        }
+    });
 }
 
 uint64_t TelemetryLogHub::stateChange(StateId from,
                                       StateId to,
                                       TransitionId transition,
                                       std::optional<RunId> runId) {
-    LogEvent entry;
-    entry.timestamp = nowMs();
-    entry.kind = EventKind::StateChange;
-    entry.level = LogLevel::Info;
-    entry.category = "runtime";
-    entry.message = "state transition";
-    entry.runId = runId;
-    entry.fromState = from;
-    entry.toState = to;
-    entry.transitionId = transition;
-    return push(std::move(entry));
+    return push(EventKind::StateChange, LogLevel::Info, "runtime", "state transition", [&](Record& record) {
+        if (runId) {
+            record.runId = *runId;
+            record.flags |= HasRunId;
+        }
+        record.fromState = from;
+        record.toState = to;
+        record.transitionId = transition;
+        record.flags |= HasStates | HasTransition;
+    });
 }
 
 uint64_t TelemetryLogHub::outputChange(const std::string& variable,
                                        const Value& value,
                                        std::optional<RunId> runId) {
-    LogEvent entry;
-    entry.timestamp = nowMs();
-    entry.kind = EventKind::OutputChange;
-    entry.level = LogLevel::Info;
-    entry.category = "output";
-    entry.message = "output changed";
-    entry.runId = runId;
-    entry.variableName = variable;
-    entry.value = value;
-    return push(std::move(entry));
+    return push(EventKind::OutputChange, LogLevel::Info, "output", "output changed", [&](Record& record) {
+        if (runId) {
+            record.runId = *runId;
+            record.flags |= HasRunId;
+        }
+        record.variableLen = static_cast<uint8_t>(
+            copyTruncated(record.variable, sizeof(record.variable), variable.data(), variable.size()));
+        record.valueType = value.type();
+        switch (value.type()) {
+            case ValueType::Bool: record.scalar.b = value.get<bool>(); break;
+            case ValueType::Int32: record.scalar.i32 = value.get<int32_t>(); break;
+            case ValueType::Int64: record.scalar.i64 = value.get<int64_t>(); break;
+            case ValueType::Float32: record.scalar.f32 = value.get<float>(); break;
+            case ValueType::Float64: record.scalar.f64 = value.get<double>(); break;
+            case ValueType::String: {
+                const std::string_view text = value.str();
+                record.valueLen = static_cast<uint8_t>(
+                    copyTruncated(record.valueBytes, sizeof(record.valueBytes), text.data(), text.size()));
+                break;
+            }
+            case ValueType::Binary: {
+                const ByteView bytes = value.bytes();
+                record.valueLen = static_cast<uint8_t>(copyTruncated(
+                    record.valueBytes, sizeof(record.valueBytes), reinterpret_cast<const char*>(bytes.data),
+                    bytes.size));
+                break;
+            }
+            default:
+                break;
+        }
+        record.flags |= HasVariable | HasValue;
+    });
 }
 
 std::vector<LogEvent> TelemetryLogHub::snapshot(const LogQuery& query) const {
-    compat::LockGuard<compat::Mutex> lock(mutex_);
     std::vector<LogEvent> result;
-    result.reserve(std::min(query.maxItems, ring_.size()));
+    snapshotSince(query.afterSeq, result, query.maxItems);
+    return result;
+}
 
-    for (const auto& e : ring_) {
-        if (e.seq <= query.afterSeq) {
-            continue;
+size_t TelemetryLogHub::snapshotSince(uint64_t afterSeq, std::vector<LogEvent>& out, size_t maxItems) const {
+    const Slot* slots = ready_.load(std::memory_order_acquire);
+    if (slots == nullptr || maxItems == 0) {
+        return 0;
+    }
+
+    const uint64_t last = nextSeq_.load(std::memory_order_acquire) - 1;
+    const uint64_t oldest = last >= capacity_ ? last - capacity_ + 1 : 1;
+    uint64_t seq = std::max(afterSeq + 1, oldest);
+    if (seq <= last) {
+        out.reserve(out.size() + static_cast<size_t>(std::min<uint64_t>(last - seq + 1, maxItems)));
+    }
+
+    size_t added = 0;
+    for (; seq <= last && added < maxItems; ++seq) {
+        const Slot& slot = slots[(seq - 1) % capacity_];
+        const uint64_t before = slot.state.load(std::memory_order_acquire);
+        if ((before & ~WRITING) > seq) {
+            continue;  // Already overwritten by a later lap
         }
-        result.push_back(e);
-        if (result.size() >= query.maxItems) {
-            break;
+        if (before != seq) {
+            break;  // Claimed but not yet published
+        }
+        const Record copy = slot.record;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.state.load(std::memory_order_relaxed) != before) {
+            continue;  // Overwritten while copying
         }
+        out.push_back(decode(seq, copy));
+        ++added;
     }
-
-    return result;
+    return added;
 }
 
 void TelemetryLogHub::stream(EventStreamCallback callback) {
+    stream(std::move(callback), StreamOptions{});
+}
+
+void TelemetryLogHub::stream(EventStreamCallback callback, const StreamOptions& options) {
     if (!callback) {
         return;
     }
     compat::LockGuard<compat::Mutex> lock(mutex_);
-    streamCallbacks_.push_back(std::move(callback));
+    auto subscriber = std::make_unique<Subscriber>();
+    subscriber->callback = std::move(callback);
+    subscriber->options = options;
+    subscriber->options.queueCapacity = std::max<size_t>(options.queueCapacity, 1);
+    if (subscriber->options.name.empty()) {
+        subscriber->options.name = "stream-" + std::to_string(subscriberStore_.size());
+    }
+#if defined(AETHERIUM_LOG_ASYNC_STREAMS)
+    if (subscriber->options.async) {
+        std::lock_guard<std::mutex> dispatchLock(dispatchMutex_);
+        asyncSubscribers_.push_back(subscriber.get());
+        if (!dispatcher_.joinable()) {
+            dispatcher_ = std::thread([this] { dispatchLoop(); });
+        }
+    }
+#else
+    subscriber->options.async = false;
+#endif
+
+    auto next = std::make_unique<std::vector<Subscriber*>>();
+    if (const auto* current = subscribers_.load(std::memory_order_acquire)) {
+        *next = *current;
+    }
+    next->push_back(subscriber.get());
+    subscriberStore_.push_back(std::move(subscriber));
+    subscribers_.store(next.get(), std::memory_order_release);
+    subscriberLists_.push_back(std::move(next));
 }
 
+std::vector<LogStreamStats> TelemetryLogHub::streamStats() const {
+    compat::LockGuard<compat::Mutex> lock(mutex_);
+    std::vector<LogStreamStats> stats;
+    stats.reserve(subscriberStore_.size());
+    for (const auto& subscriber : subscriberStore_) {
+        LogStreamStats entry;
+        entry.name = subscriber->options.name;
+        entry.async = subscriber->options.async;
+        entry.delivered = subscriber->delivered.load(std::memory_order_relaxed);
+        entry.dropped = subscriber->dropped.load(std::memory_order_relaxed);
+#if defined(AETHERIUM_LOG_ASYNC_STREAMS)
+        if (entry.async) {
+            std::lock_guard<std::mutex> dispatchLock(dispatchMutex_);
+            entry.queued = subscriber->queue.size();
+        }
+#endif
+        stats.push_back(std::move(entry));
+    }
+    return stats;
+}
+
+void TelemetryLogHub::deliver(Subscriber& subscriber, const LogEvent& event) {
+#if defined(AETHERIUM_LOG_ASYNC_STREAMS)
+    if (subscriber.options.async) {
+        enqueue(subscriber, event);
+        return;
+    }
+#endif
+    subscriber.callback(event);
+    subscriber.delivered.fetch_add(1, std::memory_order_relaxed);
+}
+
+#if defined(AETHERIUM_LOG_ASYNC_STREAMS)
+void TelemetryLogHub::enqueue(Subscriber& subscriber, const LogEvent& event) {
+    std::unique_lock<std::mutex> lock(dispatchMutex_);
+    auto& queue = subscriber.queue;
+    const size_t capacity = subscriber.options.queueCapacity;
+    if (queue.size() >= capacity) {
+        StreamOverflow policy = subscriber.options.overflow;
+        // A subscriber that logs from its own callback must not wait on itself
+        if (policy == StreamOverflow::Block && std::this_thread::get_id() == dispatcher_.get_id()) {
+            policy = StreamOverflow::DropNewest;
+        }
+        switch (policy) {
+            case StreamOverflow::DropOldest:
+                queue.pop_front();
+                subscriber.dropped.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case StreamOverflow::DropNewest:
+                subscriber.dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            case StreamOverflow::Block:
+                drained_.wait(lock, [&] { return queue.size() < capacity || stopping_; });
+                if (queue.size() >= capacity) {
+                    subscriber.dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                break;
+        }
+    }
+    const bool wasEmpty = queue.empty();
+    queue.push_back(event);
+    if (wasEmpty) {
+        queued_.notify_one();
+    }
+}
+
+void TelemetryLogHub::dispatchLoop() {
+    std::deque<LogEvent> batch;
+    std::unique_lock<std::mutex> lock(dispatchMutex_);
+    for (;;) {
+        bool took = false;
+        for (size_t i = 0; i < asyncSubscribers_.size(); ++i) {
+            Subscriber& subscriber = *asyncSubscribers_[i];
+            if (subscriber.queue.empty()) {
+                continue;
+            }
+            batch.swap(subscriber.queue);
+            took = true;
+            lock.unlock();
+            drained_.notify_all();
+            for (const auto& event : batch) {
+                subscriber.callback(event);
+            }
+            subscriber.delivered.fetch_add(batch.size(), std::memory_order_relaxed);
+            batch.clear();
+            lock.lock();
+        }
+        if (took) {
+            continue;
+        }
+        if (stopping_) {
+            return;
+        }
+        queued_.wait(lock);
+    }
+}
+#endif
+
 uint64_t TelemetryLogHub::latestSeq() const {
+    return nextSeq_.load(std::memory_order_acquire) - 1;
+}
+
+TelemetryLogHub::Slot* TelemetryLogHub::ensureSlots() {
+    Slot* slots = ready_.load(std::memory_order_acquire);
+    if (slots != nullptr) {
+        return slots;
+    }
+    // First event: allocate here rather than in the constructor so
+    // setCapacity() during setup decides the size
+    compat::LockGuard<compat::Mutex> lock(mutex_);
+    slots = ready_.load(std::memory_order_relaxed);
+    if (slots == nullptr) {
+        slots_.reset(new Slot[capacity_]);
+        slots = slots_.get();
+        ready_.store(slots, std::memory_order_release);
+    }
+    return slots;
+}
+
+uint16_t TelemetryLogHub::intern(std::string_view category) {
+    auto find = [this, &category](uint16_t count) -> uint16_t {
+        const size_t len = std::min(category.size(), sizeof(Category::name));
+        for (uint16_t i = 0; i < count; ++i) {
+            const Category& entry = categories_[i];
+            if (entry.len == len && std::memcmp(entry.name, category.data(), len) == 0) {
+                return i;
+            }
+        }
+        return NO_CATEGORY;
+    };
+
+    const uint16_t found = find(categoryCount_.load(std::memory_order_acquire));
+    if (found != NO_CATEGORY) {
+        return found;
+    }
+
     compat::LockGuard<compat::Mutex> lock(mutex_);
-    return nextSeq_ > 0 ? nextSeq_ - 1 : 0;
+    const uint16_t count = categoryCount_.load(std::memory_order_relaxed);
+    const uint16_t raced = find(count);
+    if (raced != NO_CATEGORY || count == AETHERIUM_LOG_MAX_CATEGORIES) {
+        return raced;
+    }
+    Category& entry = categories_[count];
+    entry.len = static_cast<uint8_t>(copyTruncated(entry.name, sizeof(entry.name), category.data(), category.size()));
+    categoryCount_.store(static_cast<uint16_t>(count + 1), std::memory_order_release);
+    return count;
 }
 
-uint64_t TelemetryLogHub::push(LogEvent event) {
-    std::vector<EventStreamCallback> callbacks;
-    {
-        compat::LockGuard<compat::Mutex> lock(mutex_);
-        event.seq = nextSeq_++;
-        ring_.push_back(event);
-        while (ring_.size() > capacity_) {
-            ring_.pop_front();
+template <typename Fill>
+uint64_t TelemetryLogHub::push(EventKind kind,
+                               LogLevel level,
+                               std::string_view category,
+                               std::string_view message,
+                               Fill&& fill) {
+    Slot* slots = ensureSlots();
+    const uint16_t categoryId = intern(category);
+    const uint64_t seq = nextSeq_.fetch_add(1, std::memory_order_acq_rel);
+    Slot& slot = slots[(seq - 1) % capacity_];
+
+    // A slot is only contended when producers are a whole ring apart; wait
+    // out a lapped writer, and give up if a newer lap already took the slot.
+    uint64_t observed = slot.state.load(std::memory_order_acquire);
+    for (;;) {
+        if ((observed & ~WRITING) >= seq) {
+            return seq;
+        }
+        if (observed & WRITING) {
+            observed = slot.state.load(std::memory_order_acquire);
+            continue;
+        }
+        if (slot.state.compare_exchange_weak(observed, seq | WRITING, std::memory_order_acq_rel,
+                                             std::memory_order_acquire)) {
+            break;
         }
-        callbacks = streamCallbacks_;
     }
 
-    for (const auto& cb : callbacks) {
-        cb(event);
+    Record& record = slot.record;
+    record.timestamp = nowMs();
+    record.kind = kind;
+    record.level = level;
+    record.category = categoryId;
+    record.flags = 0;
+    record.variableLen = 0;
+    record.valueLen = 0;
+    record.valueType = ValueType::Void;
+    record.messageLen = static_cast<uint16_t>(
+        copyTruncated(record.message, sizeof(record.message), message.data(), message.size()));
+    fill(record);
+
+    // Decoded before publishing: once published a lapping writer may reuse the slot
+    const auto* subscribers = subscribers_.load(std::memory_order_acquire);
+    if (subscribers == nullptr) {
+        slot.state.store(seq, std::memory_order_release);
+        return seq;
     }
+    const LogEvent event = decode(seq, record);
+    slot.state.store(seq, std::memory_order_release);
+    for (Subscriber* subscriber : *subscribers) {
+        deliver(*subscriber, event);
+    }
+    return seq;
+}
 
-    return event.seq;
+LogEvent TelemetryLogHub::decode(uint64_t seq, const Record& record) const {
+    LogEvent event;
+    event.seq = seq;
+    event.timestamp = record.timestamp;
+    event.kind = record.kind;
+    event.level = record.level;
+    if (record.category < categoryCount_.load(std::memory_order_acquire)) {
+        const Category& entry = categories_[record.category];
+        event.category.assign(entry.name, entry.len);
+    } else {
+        event.category = "other";
+    }
+    event.message.assign(record.message, record.messageLen);
+    if (record.flags & HasRunId) {
+        event.runId = record.runId;
+    }
+    if (record.flags & HasStates) {
+        event.fromState = record.fromState;
+        event.toState = record.toState;
+    }
+    if (record.flags & HasTransition) {
+        event.transitionId = record.transitionId;
+    }
+    if (record.flags & HasVariable) {
+        event.variableName = std::string(record.variable, record.variableLen);
+    }
+    if (record.flags & HasValue) {
+        switch (record.valueType) {
+            case ValueType::Bool: event.value = Value(record.scalar.b); break;
+            case ValueType::Int32: event.value = Value(record.scalar.i32); break;
+            case ValueType::Int64: event.value = Value(record.scalar.i64); break;
+            case ValueType::Float32: event.value = Value(record.scalar.f32); break;
+            case ValueType::Float64: event.value = Value(record.scalar.f64); break;
+            case ValueType::String: event.value = Value(std::string_view(record.valueBytes, record.valueLen)); break;
+            case ValueType::Binary:
+                event.value = Value(ByteView{reinterpret_cast<const uint8_t*>(record.valueBytes), record.valueLen});
+                break;
+            default: event.value = Value(); break;
+        }
+    }
+    return event;
 }
 
 Timestamp TelemetryLogHub::nowMs() {
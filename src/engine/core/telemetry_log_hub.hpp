@@ -3,9 +3,10 @@
 
 #include "compat_mutex.hpp"
 #include "types.hpp"
+#include <atomic>
 #include <cstdint>
-#include <deque>
 #include <functional>
+#include <memory>
 
 #ifdef abs
 #undef abs
@@ -13,8 +14,39 @@
 
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
+// Fixed slot sizes of the log ring; longer text is truncated
+#ifndef AETHERIUM_LOG_MESSAGE_BYTES
+#if defined(ARDUINO) || defined(AETHERIUM_PLATFORM_MCXN947)
+#define AETHERIUM_LOG_MESSAGE_BYTES 64
+#else
+#define AETHERIUM_LOG_MESSAGE_BYTES 160
+#endif
+#endif
+
+#ifndef AETHERIUM_LOG_NAME_BYTES
+#define AETHERIUM_LOG_NAME_BYTES 32
+#endif
+
+#ifndef AETHERIUM_LOG_VALUE_BYTES
+#define AETHERIUM_LOG_VALUE_BYTES 32
+#endif
+
+#ifndef AETHERIUM_LOG_MAX_CATEGORIES
+#define AETHERIUM_LOG_MAX_CATEGORIES 32
+#endif
+
+// Async stream subscribers need a dispatcher thread; embedded builds deliver inline
+#if !defined(ARDUINO) && !defined(AETHERIUM_PLATFORM_MCXN947)
+#define AETHERIUM_LOG_ASYNC_STREAMS 1
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#endif
+
 namespace aeth {
 
 enum class LogLevel : uint8_t {
@@ -56,10 +88,56 @@ struct LogQuery {
 
 using EventStreamCallback = std::function<void(const LogEvent&)>;
 
+// What an async subscriber's queue does with an event when it is full
+enum class StreamOverflow : uint8_t {
+    DropOldest = 0,  // Evict the oldest queued event
+    DropNewest = 1,  // Discard the incoming event
+    Block = 2        // Make the producer wait for the dispatcher
+};
+
+struct StreamOptions {
+    // Deliver from the hub's dispatcher thread instead of inside push().
+    // Ignored on embedded builds, which have no dispatcher.
+    bool async = false;
+    size_t queueCapacity = 1024;
+    StreamOverflow overflow = StreamOverflow::DropOldest;
+    std::string name;  // Shown in status; defaults to "stream-<n>"
+};
+
+struct LogStreamStats {
+    std::string name;
+    bool async = false;
+    size_t queued = 0;
+    uint64_t delivered = 0;
+    uint64_t dropped = 0;
+};
+
+/**
+ * Event ring shared by the engine and its pollers. Storage is a
+ * preallocated array of fixed-size slots; producers claim a sequence with
+ * one fetch_add and publish the slot through its own sequence word, so
+ * logging takes no lock and does not allocate. Readers copy a slot and
+ * keep it only if its sequence did not move meanwhile (a seqlock), which
+ * lets snapshotSince() return just the events a poller has not seen.
+ *
+ * Stream subscribers are called inside push() on the producing thread
+ * unless registered as async, in which case push() only appends to the
+ * subscriber's bounded queue and one dispatcher thread per hub makes the
+ * calls.
+ */
 class TelemetryLogHub {
 public:
     explicit TelemetryLogHub(size_t capacity = 2048);
+    // Delivers what async queues still hold, then joins the dispatcher
+    ~TelemetryLogHub();
+
+    TelemetryLogHub(const TelemetryLogHub&) = delete;
+    TelemetryLogHub& operator=(const TelemetryLogHub&) = delete;
 
+    /**
+     * Resize the ring, keeping the newest events. Not safe against
+     * concurrent producers; call during setup (Engine::initialize does).
+     */
     void setCapacity(size_t capacity);
 
     uint64_t log(LogLevel level,
@@ -84,19 +162,121 @@ public:
 
     std::vector<LogEvent> snapshot(const LogQuery& query = {}) const;
 
+    /**
+     * Events with seq > afterSeq, oldest first, appended to `out`. Only the
+     * slots after afterSeq are visited. Stops at an event still being
+     * written so a poller that passes the last seq it got never skips one.
+     * Returns the number appended.
+     */
+    size_t snapshotSince(uint64_t afterSeq, std::vector<LogEvent>& out, size_t maxItems = 200) const;
+
     void stream(EventStreamCallback callback);
+    void stream(EventStreamCallback callback, const StreamOptions& options);
+
+    // One entry per subscriber, in registration order
+    [[nodiscard]] std::vector<LogStreamStats> streamStats() const;
 
     [[nodiscard]] uint64_t latestSeq() const;
+    [[nodiscard]] size_t capacity() const { return capacity_; }
 
 private:
-    uint64_t push(LogEvent event);
+    enum : uint8_t {
+        HasRunId = 1 << 0,
+        HasStates = 1 << 1,
+        HasTransition = 1 << 2,
+        HasVariable = 1 << 3,
+        HasValue = 1 << 4
+    };
+
+    // Trivially copyable so a reader can copy it while a writer may be active
+    struct Record {
+        Timestamp timestamp;
+        RunId runId;
+        StateId fromState;
+        StateId toState;
+        TransitionId transitionId;
+        uint16_t category;
+        uint16_t messageLen;
+        uint8_t variableLen;
+        uint8_t valueLen;
+        EventKind kind;
+        LogLevel level;
+        uint8_t flags;
+        ValueType valueType;
+        union {
+            bool b;
+            int32_t i32;
+            int64_t i64;
+            float f32;
+            double f64;
+        } scalar;
+        char message[AETHERIUM_LOG_MESSAGE_BYTES];
+        char variable[AETHERIUM_LOG_NAME_BYTES];
+        char valueBytes[AETHERIUM_LOG_VALUE_BYTES];  // String / binary values
+    };
+
+    struct Slot {
+        // Committed seq; seq | WRITING while a producer fills it; 0 = never used
+        std::atomic<uint64_t> state{0};
+        Record record;
+    };
+
+    static constexpr uint64_t WRITING = 1ull << 63;
+    static constexpr uint16_t NO_CATEGORY = 0xFFFF;
+
+    struct Category {
+        char name[AETHERIUM_LOG_NAME_BYTES];
+        uint8_t len;
+    };
+
+    template <typename Fill>
+    uint64_t push(EventKind kind, LogLevel level, std::string_view category,
+                  std::string_view message, Fill&& fill);
+    uint16_t intern(std::string_view category);
+    LogEvent decode(uint64_t seq, const Record& record) const;
+    Slot* ensureSlots();
     static Timestamp nowMs();
 
-    mutable compat::Mutex mutex_;
-    std::deque<LogEvent> ring_;
-    std::vector<EventStreamCallback> streamCallbacks_;
     size_t capacity_;
-    uint64_t nextSeq_ = 1;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<Slot*> ready_{nullptr};  // slots_ once allocated
+    std::atomic<uint64_t> nextSeq_{1};
+
+    // Append-only: an entry is immutable once categoryCount_ covers it
+    Category categories_[AETHERIUM_LOG_MAX_CATEGORIES];
+    std::atomic<uint16_t> categoryCount_{0};
+
+    struct Subscriber {
+        EventStreamCallback callback;
+        StreamOptions options;
+        std::atomic<uint64_t> delivered{0};
+        std::atomic<uint64_t> dropped{0};
+#if defined(AETHERIUM_LOG_ASYNC_STREAMS)
+        std::deque<LogEvent> queue;  // Guarded by dispatchMutex_
+#endif
+    };
+
+    void deliver(Subscriber& subscriber, const LogEvent& event);
+
+    // Each subscription publishes a new list; old lists stay alive (there are
+    // only ever a handful) so producers can read one without the mutex.
+    std::vector<std::unique_ptr<Subscriber>> subscriberStore_;
+    std::vector<std::unique_ptr<const std::vector<Subscriber*>>> subscriberLists_;
+    std::atomic<const std::vector<Subscriber*>*> subscribers_{nullptr};
+
+#if defined(AETHERIUM_LOG_ASYNC_STREAMS)
+    void enqueue(Subscriber& subscriber, const LogEvent& event);
+    void dispatchLoop();
+
+    mutable std::mutex dispatchMutex_;
+    std::condition_variable queued_;  // A queue became non-empty, or stopping
+    std::condition_variable drained_;  // The dispatcher took a queue's events
+    std::vector<Subscriber*> asyncSubscribers_;  // Guarded by dispatchMutex_
+    bool stopping_ = false;
+    std::thread dispatcher_;
+#endif
+
+    mutable compat::Mutex mutex_;  // Slot allocation, interning, subscription
 };
 
 } // namespace aeth
@@ -0,0 +1,154 @@
+/**
+ * Aetherium Automata - Tick Pacer
+ *
+ * Adapts an engine's tick rate between the bounds of its deployment:
+ * - activity (a transition fired or a variable changed since the last tick)
+ *   raises it straight to the ceiling, so the next reaction is not late;
+ * - every idleTicks quiet ticks halve it, down to the floor;
+ * - while the battery is low the ceiling drops to lowBatteryRate;
+ * - when the average tick cost passes costBudgetPercent of the period, the
+ *   ceiling drops to the rate at which the cost fits the budget again.
+ *
+ * The pacer only decides. Engine::tick feeds it and hosts apply
+ * Engine::tickRate() to their TickScheduler.
+ */
+
+#ifndef AETHERIUM_TICK_PACER_HPP
+#define AETHERIUM_TICK_PACER_HPP
+
+#include <algorithm>
+#include <cstdint>
+
+namespace aeth {
+
+struct PacingProfile {
+    bool enabled = false;
+    uint32_t minRate = 1;             // Floor when idle (ticks per second)
+    uint32_t maxRate = 0;             // Ceiling; 0 = EngineInitOptions::maxTickRate
+    uint32_t idleTicks = 10;          // Quiet ticks per halving
+    uint32_t lowBatteryRate = 0;      // Ceiling while the battery is low; 0 = a quarter of the ceiling
+    uint32_t costBudgetPercent = 50;  // Share of the period a tick may take before the rate backs off
+};
+
+// Why the rate last changed
+enum class PacingDecision : uint8_t {
+    Hold,        // Not changed since configure()
+    Active,      // Raised to the ceiling by activity
+    Idle,        // Halved after idleTicks quiet ticks
+    LowBattery,  // Capped at the low-battery ceiling
+    Overload     // Capped because ticks cost too much of the period
+};
+
+inline const char* pacingDecisionName(PacingDecision decision) {
+    switch (decision) {
+        case PacingDecision::Hold: return "hold";
+        case PacingDecision::Active: return "active";
+        case PacingDecision::Idle: return "idle";
+        case PacingDecision::LowBattery: return "low_battery";
+        case PacingDecision::Overload: return "overload";
+    }
+    return "unknown";
+}
+
+class TickPacer {
+public:
+    /**
+     * Start over at the ceiling. Pacing stays off when the profile is
+     * disabled or has no ceiling (maxRate and configuredRate both 0, i.e.
+     * unlimited); rate() is then configuredRate.
+     */
+    void configure(const PacingProfile& profile, uint32_t configuredRate) {
+        profile_ = profile;
+        max_ = profile.maxRate > 0 ? profile.maxRate : configuredRate;
+        enabled_ = profile.enabled && max_ > 0;
+        min_ = std::clamp<uint32_t>(profile.minRate, 1, std::max<uint32_t>(max_, 1));
+        rate_ = enabled_ ? max_ : configuredRate;
+        quiet_ = 0;
+        costUs_ = 0;
+        changes_ = 0;
+        decision_ = PacingDecision::Hold;
+    }
+
+    /**
+     * Record one tick: whether anything happened since the previous one,
+     * what it cost and whether the battery is low. True when rate() changed.
+     * The cost average is kept with pacing off too, for loadPercent().
+     */
+    bool observe(bool active, uint64_t tickCostUs, bool batteryLow) {
+        // Average over about eight ticks
+        costUs_ = costUs_ == 0 ? tickCostUs : costUs_ - costUs_ / 8 + tickCostUs / 8;
+        if (!enabled_) {
+            return false;
+        }
+
+        uint32_t ceiling = max_;
+        PacingDecision limit = PacingDecision::Active;
+        if (batteryLow) {
+            ceiling = profile_.lowBatteryRate > 0 ? std::min(ceiling, profile_.lowBatteryRate) : ceiling / 4;
+            limit = PacingDecision::LowBattery;
+        }
+        if (costUs_ > 0) {
+            // rate * cost = costBudgetPercent of a second
+            const uint64_t fits = static_cast<uint64_t>(profile_.costBudgetPercent) * 10000 / costUs_;
+            if (fits < ceiling) {
+                ceiling = static_cast<uint32_t>(fits);
+                limit = PacingDecision::Overload;
+            }
+        }
+        ceiling = std::max(ceiling, min_);
+
+        uint32_t next = rate_;
+        PacingDecision why = decision_;
+        if (active) {
+            quiet_ = 0;
+            if (rate_ < ceiling) {
+                next = ceiling;
+                why = PacingDecision::Active;
+            }
+        } else if (++quiet_ >= std::max<uint32_t>(profile_.idleTicks, 1)) {
+            quiet_ = 0;
+            next = std::max(min_, rate_ / 2);
+            why = PacingDecision::Idle;
+        }
+        if (next > ceiling) {
+            next = ceiling;
+            why = limit;
+        }
+
+        if (next == rate_) {
+            return false;
+        }
+        rate_ = next;
+        decision_ = why;
+        ++changes_;
+        return true;
+    }
+
+    [[nodiscard]] bool enabled() const { return enabled_; }
+    [[nodiscard]] uint32_t rate() const { return rate_; }
+    [[nodiscard]] uint32_t floor() const { return min_; }
+    [[nodiscard]] uint32_t ceiling() const { return max_; }
+    [[nodiscard]] PacingDecision decision() const { return decision_; }
+    [[nodiscard]] uint64_t changes() const { return changes_; }
+    [[nodiscard]] uint64_t costUs() const { return costUs_; }
+
+    // Share of wall time spent ticking at the current rate, in percent
+    [[nodiscard]] float loadPercent() const {
+        return static_cast<float>(costUs_) * static_cast<float>(rate_) / 10000.0f;
+    }
+
+private:
+    PacingProfile profile_;
+    bool enabled_ = false;
+    uint32_t min_ = 1;
+    uint32_t max_ = 0;
+    uint32_t rate_ = 0;
+    uint32_t quiet_ = 0;
+    uint64_t costUs_ = 0;
+    uint64_t changes_ = 0;
+    PacingDecision decision_ = PacingDecision::Hold;
+};
+
+} // namespace aeth
+
+#endif // AETHERIUM_TICK_PACER_HPP
@@ -0,0 +1,122 @@
+/**
+ * Aetherium Automata - Tick Scheduler
+ *
+ * Decides when the next runtime tick is due and how long a host loop may
+ * block before it: whichever comes first of the next tick slot at the
+ * configured rate or the next timer deadline. Slots are derived from a
+ * fixed origin, so non-integer periods (e.g. 3 Hz) do not drift.
+ *
+ * Time is passed in by the caller in microseconds, so the same scheduler
+ * serves Runtime::run (IClock) and host loops (steady_clock).
+ */
+
+#ifndef AETHERIUM_TICK_SCHEDULER_HPP
+#define AETHERIUM_TICK_SCHEDULER_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+
+namespace aeth {
+
+class TickScheduler {
+public:
+    explicit TickScheduler(uint32_t ticksPerSecond = 0) { setRate(ticksPerSecond); }
+
+    /**
+     * Set tick rate (0 = unlimited: a tick is always due)
+     */
+    void setRate(uint32_t ticksPerSecond) {
+        rate_ = ticksPerSecond;
+        started_ = false;
+    }
+
+    /**
+     * Change the rate between ticks (TickPacer): the next slot is one new
+     * period after the last tick instead of a fresh start.
+     */
+    void retune(uint32_t ticksPerSecond) {
+        if (ticksPerSecond == rate_) {
+            return;
+        }
+        const bool keep = started_ && rate_ != 0 && ticksPerSecond != 0;
+        rate_ = ticksPerSecond;
+        if (keep) {
+            anchor(lastTickUs_);
+        } else {
+            started_ = false;
+        }
+    }
+
+    [[nodiscard]] uint32_t rate() const { return rate_; }
+    [[nodiscard]] bool unlimited() const { return rate_ == 0; }
+
+    /**
+     * Whether a tick should run now: its slot was reached or a timer
+     * deadline has passed.
+     */
+    [[nodiscard]] bool due(uint64_t nowUs, std::optional<uint32_t> msUntilTimer) const {
+        if (unlimited() || !started_) {
+            return true;
+        }
+        return nowUs >= nextSlotUs() || (msUntilTimer && *msUntilTimer == 0);
+    }
+
+    /**
+     * Record a tick that ran at nowUs. Falling more than a period behind
+     * re-anchors the slots instead of bursting to catch up.
+     */
+    void ticked(uint64_t nowUs) {
+        lastTickUs_ = nowUs;
+        if (unlimited()) {
+            return;
+        }
+        if (!started_ || nowUs >= nextSlotUs() + periodUs()) {
+            anchor(nowUs);
+            return;
+        }
+        // An early tick (timer deadline) leaves the pending slot in place.
+        while (nextSlotUs() <= nowUs) {
+            ++slot_;
+        }
+    }
+
+    /**
+     * How long a host may block before the next tick is due, capped at
+     * maxWaitUs. Zero when a tick is already due.
+     */
+    [[nodiscard]] uint64_t waitUs(uint64_t nowUs, std::optional<uint32_t> msUntilTimer,
+                                  uint64_t maxWaitUs) const {
+        if (due(nowUs, msUntilTimer)) {
+            return 0;
+        }
+        uint64_t wait = nextSlotUs() - nowUs;
+        if (msUntilTimer) {
+            wait = std::min<uint64_t>(wait, static_cast<uint64_t>(*msUntilTimer) * 1000);
+        }
+        return std::min(wait, maxWaitUs);
+    }
+
+private:
+    [[nodiscard]] uint64_t periodUs() const { return 1000000ULL / rate_; }
+    [[nodiscard]] uint64_t slotUs(uint64_t slot) const {
+        return originUs_ + (slot * 1000000ULL) / rate_;
+    }
+    [[nodiscard]] uint64_t nextSlotUs() const { return slotUs(slot_); }
+
+    void anchor(uint64_t nowUs) {
+        originUs_ = nowUs;
+        slot_ = 1;
+        started_ = true;
+    }
+
+    uint32_t rate_ = 0;
+    uint64_t originUs_ = 0;
+    uint64_t slot_ = 0;  // Index of the next slot after originUs_
+    uint64_t lastTickUs_ = 0;
+    bool started_ = false;
+};
+
+} // namespace aeth
+
+#endif // AETHERIUM_TICK_SCHEDULER_HPP
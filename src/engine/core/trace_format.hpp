@@ -0,0 +1,113 @@
+/**
+ * Aetherium Automata - Binary Trace Format
+ *
+ * Frame tags, the record presence mask and a bounds-checked cursor for the
+ * .aetr format described at TraceBinaryReader. Shared by the trace writer,
+ * the sequential reader and the columnar loader (trace_query.hpp); not part
+ * of the public API.
+ */
+
+#ifndef AETHERIUM_TRACE_FORMAT_HPP
+#define AETHERIUM_TRACE_FORMAT_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace aeth::trace_format {
+
+constexpr char TRACE_MAGIC[8] = {'A', 'E', 'T', 'H', 'T', 'R', '0', '1'};
+constexpr uint8_t FRAME_STRING = 1;
+constexpr uint8_t FRAME_RECORD = 2;
+constexpr size_t MAX_FRAME_BYTES = 1u << 24;
+
+// Record fields after the fixed ones appear in this bit order
+enum : uint32_t {
+    HasMessageId = 1u << 0,
+    HasRelatedMessageId = 1u << 1,
+    HasRunId = 1u << 2,
+    HasReceiveTimestamp = 1u << 3,
+    HasHandleTimestamp = 1u << 4,
+    HasSendTimestamp = 1u << 5,
+    HasPortName = 1u << 6,
+    HasPortDirection = 1u << 7,
+    HasObservableState = 1u << 8,
+    HasBatteryPercent = 1u << 9,
+    HasBatteryLow = 1u << 10,
+    HasLatencyBudget = 1u << 11,
+    HasLatencyWarning = 1u << 12,
+    HasObservedLatency = 1u << 13,
+    HasLatencyExceeded = 1u << 14
+};
+
+// String ids every record carries, in this order, before the summary
+constexpr size_t RECORD_STRING_FIELDS = 8;
+
+// Bounds-checked cursor over one frame
+struct FrameCursor {
+    const uint8_t* at;
+    const uint8_t* end;
+    bool ok = true;
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (at == end) {
+                break;
+            }
+            const uint8_t byte = *at++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        ok = false;
+        return 0;
+    }
+
+    uint8_t byte() {
+        if (at == end) {
+            ok = false;
+            return 0;
+        }
+        return *at++;
+    }
+
+    double float64() {
+        if (end - at < 8) {
+            ok = false;
+            return 0.0;
+        }
+        uint64_t bits = 0;
+        for (int i = 0; i < 8; ++i) {
+            bits |= static_cast<uint64_t>(at[i]) << (8 * i);
+        }
+        at += 8;
+        double value = 0.0;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::string text(size_t len) {
+        if (static_cast<size_t>(end - at) < len) {
+            ok = false;
+            return {};
+        }
+        std::string value(reinterpret_cast<const char*>(at), len);
+        at += len;
+        return value;
+    }
+
+    void skip(size_t len) {
+        if (static_cast<size_t>(end - at) < len) {
+            ok = false;
+            at = end;
+            return;
+        }
+        at += len;
+    }
+};
+
+} // namespace aeth::trace_format
+
+#endif // AETHERIUM_TRACE_FORMAT_HPP
@@ -0,0 +1,541 @@
+#include "trace_query.hpp"
+#include "mapped_file.hpp"
+#include "trace_format.hpp"
+#include "work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+
+namespace aeth {
+
+namespace {
+
+using namespace trace_format;
+
+constexpr uint32_t kNone = TraceColumns::kNone;
+constexpr Timestamp kNoTime = TraceColumns::kNoTime;
+constexpr uint8_t kNotJudged = TraceColumns::kNotJudged;
+constexpr size_t kNoBadRecord = ~size_t{0};
+
+size_t chunkCount(size_t count, size_t chunk) {
+    return (count + chunk - 1) / chunk;
+}
+
+// fn(chunk index, begin, end) for every chunk of [0, count), on the pool
+template <typename Fn>
+void forEachChunk(WorkStealingPool& pool, size_t count, size_t chunk, const Fn& fn) {
+    for (size_t c = 0, begin = 0; begin < count; ++c, begin += chunk) {
+        const size_t end = std::min(count, begin + chunk);
+        pool.submit([&fn, c, begin, end] { fn(c, begin, end); });
+    }
+    pool.waitIdle();
+}
+
+template <typename T>
+T percentile(const std::vector<T>& sorted, double q) {
+    const size_t index = static_cast<size_t>(q * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// Decode record frame `i` into row i; its fault actions go to `actions`
+bool decodeRecord(const uint8_t* frame, size_t len, size_t i, TraceColumns& columns,
+                  std::vector<uint32_t>& actions) {
+    FrameCursor cursor{frame, frame + len};
+    const size_t strings = columns.strings.size();
+    auto id = [&]() -> uint32_t {
+        const uint64_t value = cursor.varint();
+        if (value >= strings) {
+            cursor.ok = false;
+            return kNone;
+        }
+        return static_cast<uint32_t>(value);
+    };
+    auto varintOr = [&](uint32_t mask, uint32_t bit, uint64_t absent) {
+        return (mask & bit) ? cursor.varint() : absent;
+    };
+
+    columns.seq[i] = cursor.varint();
+    const auto mask = static_cast<uint32_t>(cursor.varint());
+    // kind, boundary, category, messageType, sourceInstance, targetInstance, transport, placement
+    uint32_t fields[RECORD_STRING_FIELDS];
+    for (auto& field : fields) {
+        field = id();
+    }
+    columns.kind[i] = fields[0];
+    columns.messageType[i] = fields[3];
+    columns.sourceInstance[i] = fields[4];
+    columns.transport[i] = fields[6];
+    columns.placement[i] = fields[7];
+    cursor.skip(static_cast<size_t>(cursor.varint()));  // Summary
+
+    varintOr(mask, HasMessageId, 0);
+    varintOr(mask, HasRelatedMessageId, 0);
+    columns.runId[i] = static_cast<RunId>(varintOr(mask, HasRunId, kNone));
+    const Timestamp receive = varintOr(mask, HasReceiveTimestamp, kNoTime);
+    const Timestamp handle = varintOr(mask, HasHandleTimestamp, kNoTime);
+    const Timestamp send = varintOr(mask, HasSendTimestamp, kNoTime);
+    columns.timestamp[i] = handle != kNoTime ? handle : receive != kNoTime ? receive : send;
+    if (mask & HasPortName) id();
+    if (mask & HasPortDirection) id();
+    columns.observableState[i] = (mask & HasObservableState) ? id() : kNone;
+    if (mask & HasBatteryPercent) cursor.skip(8);
+    if (mask & HasBatteryLow) cursor.byte();
+    varintOr(mask, HasLatencyBudget, 0);
+    varintOr(mask, HasLatencyWarning, 0);
+    columns.latencyMs[i] = static_cast<uint32_t>(varintOr(mask, HasObservedLatency, kNone));
+    columns.exceeded[i] = (mask & HasLatencyExceeded) ? (cursor.byte() != 0 ? 1 : 0) : kNotJudged;
+
+    const uint64_t count = cursor.varint();
+    if (count > len) {
+        cursor.ok = false;
+    }
+    for (uint64_t a = 0; cursor.ok && a < count; ++a) {
+        actions.push_back(id());
+    }
+    columns.faultBegin[i + 1] = static_cast<uint32_t>(count);  // Turned into offsets once all chunks are in
+    return cursor.ok;
+}
+
+Result<TraceColumns> loadColumns(const std::string& path, size_t chunk, WorkStealingPool& pool) {
+    using R = Result<TraceColumns>;
+    auto opened = MappedFile::open(path);
+    if (opened.isError()) {
+        return R::error("failed to open binary trace: " + path);
+    }
+    const uint8_t* data = opened.value()->data();
+    const size_t size = opened.value()->size();
+    if (size < sizeof(TRACE_MAGIC) || std::memcmp(data, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+        return R::error("not a binary trace: " + path);
+    }
+
+    // Sequential: the string table and where each record frame starts
+    TraceColumns columns;
+    std::vector<size_t> frameAt;
+    std::vector<uint32_t> frameLen;
+    size_t pos = sizeof(TRACE_MAGIC);
+    while (pos < size) {
+        const uint8_t tag = data[pos++];
+        FrameCursor header{data + pos, data + size};
+        const uint64_t len = header.varint();
+        if (!header.ok || len > MAX_FRAME_BYTES) {
+            return R::error("binary trace: bad frame length");
+        }
+        pos = static_cast<size_t>(header.at - data);
+        if (size - pos < len) {
+            return R::error("binary trace: truncated frame");
+        }
+        if (tag == FRAME_STRING) {
+            columns.strings.emplace_back(reinterpret_cast<const char*>(data + pos), static_cast<size_t>(len));
+        } else if (tag == FRAME_RECORD) {
+            frameAt.push_back(pos);
+            frameLen.push_back(static_cast<uint32_t>(len));
+        }
+        pos += static_cast<size_t>(len);
+    }
+
+    const size_t count = frameAt.size();
+    columns.seq.resize(count);
+    for (auto* column : {&columns.kind, &columns.messageType, &columns.sourceInstance, &columns.transport,
+                         &columns.placement, &columns.observableState, &columns.runId, &columns.latencyMs}) {
+        column->resize(count);
+    }
+    columns.timestamp.resize(count);
+    columns.exceeded.resize(count);
+    columns.faultBegin.assign(count + 1, 0);
+
+    // Parallel: every chunk decodes its rows in place
+    std::vector<std::vector<uint32_t>> chunkActions(chunkCount(count, chunk));
+    std::vector<size_t> badRecord(chunkActions.size(), kNoBadRecord);
+    forEachChunk(pool, count, chunk, [&](size_t c, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (!decodeRecord(data + frameAt[i], frameLen[i], i, columns, chunkActions[c])) {
+                badRecord[c] = i;
+                return;
+            }
+        }
+    });
+    for (const size_t bad : badRecord) {
+        if (bad != kNoBadRecord) {
+            return R::error("binary trace: malformed record " + std::to_string(bad + 1));
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        columns.faultBegin[i + 1] += columns.faultBegin[i];
+    }
+    columns.faultActions.reserve(columns.faultBegin[count]);
+    for (const auto& actions : chunkActions) {
+        columns.faultActions.insert(columns.faultActions.end(), actions.begin(), actions.end());
+    }
+    return R::ok(std::move(columns));
+}
+
+template <typename T>
+using SamplesById = std::unordered_map<uint32_t, std::vector<T>>;
+
+// Chunk partials appended in chunk order, so each id's samples keep file order
+template <typename T>
+std::vector<std::pair<uint32_t, std::vector<T>>> mergeSamples(std::vector<SamplesById<T>>& partial) {
+    SamplesById<T> merged;
+    for (auto& groups : partial) {
+        for (auto& [id, samples] : groups) {
+            auto& into = merged[id];
+            into.insert(into.end(), samples.begin(), samples.end());
+        }
+    }
+    return {std::make_move_iterator(merged.begin()), std::make_move_iterator(merged.end())};
+}
+
+// Sorts each group's samples, one task per group
+template <typename T, typename Stats, typename Fill>
+std::vector<Stats> summarizeSamples(std::vector<std::pair<uint32_t, std::vector<T>>>& groups,
+                                    WorkStealingPool& pool, const Fill& fill) {
+    std::vector<Stats> out(groups.size());
+    for (size_t g = 0; g < groups.size(); ++g) {
+        pool.submit([&groups, &out, &fill, g] {
+            auto& samples = groups[g].second;
+            std::sort(samples.begin(), samples.end());
+            double sum = 0.0;
+            for (const T value : samples) {
+                sum += static_cast<double>(value);
+            }
+            fill(out[g], groups[g].first, samples, sum / static_cast<double>(samples.size()));
+        });
+    }
+    pool.waitIdle();
+    return out;
+}
+
+std::vector<MessageLatencyStats> latencyByMessageType(const TraceColumns& columns, size_t chunk,
+                                                      WorkStealingPool& pool) {
+    std::vector<SamplesById<uint32_t>> partial(chunkCount(columns.size(), chunk));
+    forEachChunk(pool, columns.size(), chunk, [&](size_t c, size_t begin, size_t end) {
+        uint32_t lastType = kNone;
+        std::vector<uint32_t>* samples = nullptr;
+        for (size_t i = begin; i < end; ++i) {
+            if (columns.latencyMs[i] == kNone) {
+                continue;
+            }
+            if (columns.messageType[i] != lastType || samples == nullptr) {
+                lastType = columns.messageType[i];
+                samples = &partial[c][lastType];
+            }
+            samples->push_back(columns.latencyMs[i]);
+        }
+    });
+
+    auto groups = mergeSamples(partial);
+    auto stats = summarizeSamples<uint32_t, MessageLatencyStats>(
+        groups, pool, [&columns](MessageLatencyStats& out, uint32_t type, const std::vector<uint32_t>& sorted,
+                                 double mean) {
+            out.messageType = columns.strings[type];
+            out.samples = sorted.size();
+            out.minMs = sorted.front();
+            out.p50Ms = percentile(sorted, 0.50);
+            out.p90Ms = percentile(sorted, 0.90);
+            out.p99Ms = percentile(sorted, 0.99);
+            out.maxMs = sorted.back();
+            out.meanMs = mean;
+        });
+    std::sort(stats.begin(), stats.end(), [](const auto& a, const auto& b) { return a.messageType < b.messageType; });
+    return stats;
+}
+
+std::vector<BudgetVerdictCount> budgetByPlacementAndTransport(const TraceColumns& columns, size_t chunk,
+                                                              WorkStealingPool& pool) {
+    struct Counts {
+        uint64_t judged = 0;
+        uint64_t exceeded = 0;
+    };
+    // Keyed by placement id << 32 | transport id
+    std::vector<std::unordered_map<uint64_t, Counts>> partial(chunkCount(columns.size(), chunk));
+    forEachChunk(pool, columns.size(), chunk, [&](size_t c, size_t begin, size_t end) {
+        uint64_t lastKey = ~uint64_t{0};
+        Counts* counts = nullptr;
+        for (size_t i = begin; i < end; ++i) {
+            const uint8_t verdict = columns.exceeded[i];
+            if (verdict == kNotJudged) {
+                continue;
+            }
+            const uint64_t key = static_cast<uint64_t>(columns.placement[i]) << 32 | columns.transport[i];
+            if (key != lastKey) {
+                lastKey = key;
+                counts = &partial[c][key];
+            }
+            ++counts->judged;
+            counts->exceeded += verdict;
+        }
+    });
+
+    std::unordered_map<uint64_t, Counts> merged;
+    for (const auto& counts : partial) {
+        for (const auto& [key, value] : counts) {
+            merged[key].judged += value.judged;
+            merged[key].exceeded += value.exceeded;
+        }
+    }
+    std::vector<BudgetVerdictCount> out;
+    out.reserve(merged.size());
+    for (const auto& [key, value] : merged) {
+        BudgetVerdictCount entry;
+        entry.placement = columns.strings[static_cast<uint32_t>(key >> 32)];
+        entry.transport = columns.strings[static_cast<uint32_t>(key)];
+        entry.judged = value.judged;
+        entry.exceeded = value.exceeded;
+        out.push_back(std::move(entry));
+    }
+    std::sort(out.begin(), out.end(), [](const auto& a, const auto& b) {
+        return a.placement != b.placement ? a.placement < b.placement : a.transport < b.transport;
+    });
+    return out;
+}
+
+std::vector<StateDwellStats> dwellByState(const TraceColumns& columns, size_t chunk, WorkStealingPool& pool) {
+    // A state change is a record naming an observable state, or a runtime state
+    // change without one (the instance moved to a state that is not observable)
+    const uint32_t stateChangeKind = columns.findString("runtime_state_change");
+    std::vector<std::vector<uint32_t>> partialRows(chunkCount(columns.size(), chunk));
+    forEachChunk(pool, columns.size(), chunk, [&](size_t c, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if ((columns.observableState[i] != kNone || columns.kind[i] == stateChangeKind) &&
+                columns.timestamp[i] != kNoTime) {
+                partialRows[c].push_back(static_cast<uint32_t>(i));
+            }
+        }
+    });
+
+    // Each instance and run walks its states on its own
+    std::unordered_map<uint64_t, size_t> groupOf;
+    std::vector<std::vector<uint32_t>> groups;
+    for (const auto& rows : partialRows) {
+        for (const uint32_t row : rows) {
+            const uint64_t key = static_cast<uint64_t>(columns.sourceInstance[row]) << 32 | columns.runId[row];
+            auto [it, inserted] = groupOf.emplace(key, groups.size());
+            if (inserted) {
+                groups.emplace_back();
+            }
+            groups[it->second].push_back(row);
+        }
+    }
+
+    const size_t groupChunk = std::max<size_t>(1, groups.size() / (pool.workerCount() * 4));
+    std::vector<SamplesById<Timestamp>> partial(chunkCount(groups.size(), groupChunk));
+    forEachChunk(pool, groups.size(), groupChunk, [&](size_t c, size_t begin, size_t end) {
+        for (size_t g = begin; g < end; ++g) {
+            uint32_t state = kNone;
+            Timestamp since = 0;
+            for (const uint32_t row : groups[g]) {
+                const uint32_t next = columns.observableState[row];
+                if (next == state) {
+                    continue;  // The same change traced again, e.g. as the outbound message
+                }
+                const Timestamp at = columns.timestamp[row];
+                if (state != kNone && at >= since) {
+                    partial[c][state].push_back(at - since);
+                }
+                state = next;
+                since = at;
+            }
+        }
+    });
+
+    auto samples = mergeSamples(partial);
+    auto stats = summarizeSamples<Timestamp, StateDwellStats>(
+        samples, pool, [&columns](StateDwellStats& out, uint32_t state, const std::vector<Timestamp>& sorted,
+                                  double mean) {
+            out.state = columns.strings[state];
+            out.visits = sorted.size();
+            out.minMs = sorted.front();
+            out.p50Ms = percentile(sorted, 0.50);
+            out.p90Ms = percentile(sorted, 0.90);
+            out.maxMs = sorted.back();
+            out.meanMs = mean;
+        });
+    std::sort(stats.begin(), stats.end(), [](const auto& a, const auto& b) { return a.state < b.state; });
+    return stats;
+}
+
+struct ImpactSums {
+    uint64_t records = 0;
+    uint64_t latencySamples = 0;
+    uint64_t latencySum = 0;
+    uint64_t judged = 0;
+    uint64_t exceeded = 0;
+
+    void add(const ImpactSums& other) {
+        records += other.records;
+        latencySamples += other.latencySamples;
+        latencySum += other.latencySum;
+        judged += other.judged;
+        exceeded += other.exceeded;
+    }
+
+    [[nodiscard]] FaultActionImpact report(std::string action) const {
+        FaultActionImpact out;
+        out.action = std::move(action);
+        out.records = records;
+        out.latencySamples = latencySamples;
+        out.meanLatencyMs = latencySamples > 0 ? static_cast<double>(latencySum) / latencySamples : 0.0;
+        out.judged = judged;
+        out.exceeded = exceeded;
+        return out;
+    }
+};
+
+void faultImpact(const TraceColumns& columns, size_t chunk, WorkStealingPool& pool, TraceAnalysisReport& report) {
+    struct Partial {
+        ImpactSums clean;
+        std::unordered_map<uint32_t, ImpactSums> actions;
+    };
+    std::vector<Partial> partial(chunkCount(columns.size(), chunk));
+    forEachChunk(pool, columns.size(), chunk, [&](size_t c, size_t begin, size_t end) {
+        const uint32_t* faultBegin = columns.faultBegin.data();
+        const uint32_t* latency = columns.latencyMs.data();
+        const uint8_t* exceeded = columns.exceeded.data();
+
+        // Most records carry no fault action: one branch-free pass over the
+        // columns counts them (it vectorizes), the rest are visited one by one
+        uint64_t records = 0;
+        uint64_t samples = 0;
+        uint64_t sum = 0;
+        uint64_t judged = 0;
+        uint64_t over = 0;
+        for (size_t i = begin; i < end; ++i) {
+            const uint64_t clean = faultBegin[i + 1] == faultBegin[i];
+            const uint64_t measured = clean & (latency[i] != kNone);
+            records += clean;
+            samples += measured;
+            sum += measured * latency[i];
+            judged += clean & (exceeded[i] != kNotJudged);
+            over += clean & (exceeded[i] == 1);
+        }
+        Partial& out = partial[c];
+        out.clean = {records, samples, sum, judged, over};
+
+        for (size_t i = begin; i < end; ++i) {
+            for (uint32_t a = faultBegin[i]; a < faultBegin[i + 1]; ++a) {
+                ImpactSums& sums = out.actions[columns.faultActions[a]];
+                ++sums.records;
+                if (latency[i] != kNone) {
+                    ++sums.latencySamples;
+                    sums.latencySum += latency[i];
+                }
+                if (exceeded[i] != kNotJudged) {
+                    ++sums.judged;
+                    sums.exceeded += exceeded[i];
+                }
+            }
+        }
+    });
+
+    ImpactSums clean;
+    std::unordered_map<uint32_t, ImpactSums> actions;
+    for (const auto& part : partial) {
+        clean.add(part.clean);
+        for (const auto& [action, sums] : part.actions) {
+            actions[action].add(sums);
+        }
+    }
+    report.withoutFaults = clean.report("(none)");
+    for (const auto& [action, sums] : actions) {
+        report.faults.push_back(sums.report(columns.strings[action]));
+    }
+    std::sort(report.faults.begin(), report.faults.end(),
+              [](const auto& a, const auto& b) { return a.action < b.action; });
+}
+
+TraceAnalysisReport analyze(const TraceColumns& columns, size_t chunk, WorkStealingPool& pool) {
+    TraceAnalysisReport report;
+    report.records = columns.size();
+    report.strings = columns.strings.size();
+    report.latency = latencyByMessageType(columns, chunk, pool);
+    report.budget = budgetByPlacementAndTransport(columns, chunk, pool);
+    report.dwell = dwellByState(columns, chunk, pool);
+    faultImpact(columns, chunk, pool, report);
+    return report;
+}
+
+template <typename T>
+const T* findByName(const std::vector<T>& entries, const std::string& name, std::string T::*field) {
+    for (const auto& entry : entries) {
+        if (entry.*field == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+uint32_t TraceColumns::findString(const std::string& text) const {
+    const auto it = std::find(strings.begin(), strings.end(), text);
+    return it == strings.end() ? kNone : static_cast<uint32_t>(it - strings.begin());
+}
+
+const MessageLatencyStats* TraceAnalysisReport::findLatency(const std::string& messageType) const {
+    return findByName(latency, messageType, &MessageLatencyStats::messageType);
+}
+
+const StateDwellStats* TraceAnalysisReport::findDwell(const std::string& state) const {
+    return findByName(dwell, state, &StateDwellStats::state);
+}
+
+const FaultActionImpact* TraceAnalysisReport::findFault(const std::string& action) const {
+    return findByName(faults, action, &FaultActionImpact::action);
+}
+
+std::string TraceAnalysisReport::summary() const {
+    std::ostringstream oss;
+    oss << "Records: " << records << " (" << strings << " distinct strings)\n";
+    oss << "Latency by message type (samples, min/p50/p90/p99/max ms, mean):\n";
+    for (const auto& l : latency) {
+        oss << "  " << std::left << std::setw(24) << l.messageType << std::right << " " << l.samples << ", "
+            << l.minMs << "/" << l.p50Ms << "/" << l.p90Ms << "/" << l.p99Ms << "/" << l.maxMs << ", "
+            << std::fixed << std::setprecision(1) << l.meanMs << "\n";
+    }
+    oss << "Latency budget exceeded by placement / transport:\n";
+    for (const auto& b : budget) {
+        oss << "  " << b.placement << " / " << b.transport << ": " << b.exceeded << "/" << b.judged << "\n";
+    }
+    oss << "State dwell (visits, min/p50/p90/max ms, mean):\n";
+    for (const auto& d : dwell) {
+        oss << "  " << std::left << std::setw(24) << d.state << std::right << " " << d.visits << ", " << d.minMs
+            << "/" << d.p50Ms << "/" << d.p90Ms << "/" << d.maxMs << ", " << std::fixed << std::setprecision(1)
+            << d.meanMs << "\n";
+    }
+    oss << "Fault actions (records, mean latency ms, budget exceeded):\n";
+    auto impact = [&oss](const FaultActionImpact& f) {
+        oss << "  " << std::left << std::setw(24) << f.action << std::right << " " << f.records << ", "
+            << std::fixed << std::setprecision(1) << f.meanLatencyMs << ", " << f.exceeded << "/" << f.judged
+            << "\n";
+    };
+    impact(withoutFaults);
+    for (const auto& f : faults) {
+        impact(f);
+    }
+    return oss.str();
+}
+
+Result<TraceColumns> loadTraceColumns(const std::string& path, const TraceQueryOptions& options) {
+    WorkStealingPool pool(options.workers);
+    return loadColumns(path, std::max<size_t>(1, options.chunkRecords), pool);
+}
+
+TraceAnalysisReport analyzeTrace(const TraceColumns& columns, const TraceQueryOptions& options) {
+    WorkStealingPool pool(options.workers);
+    return analyze(columns, std::max<size_t>(1, options.chunkRecords), pool);
+}
+
+Result<TraceAnalysisReport> analyzeTraceFile(const std::string& path, const TraceQueryOptions& options) {
+    WorkStealingPool pool(options.workers);
+    const size_t chunk = std::max<size_t>(1, options.chunkRecords);
+    auto columns = loadColumns(path, chunk, pool);
+    if (columns.isError()) {
+        return Result<TraceAnalysisReport>::error(columns.error());
+    }
+    return Result<TraceAnalysisReport>::ok(analyze(columns.value(), chunk, pool));
+}
+
+} // namespace aeth
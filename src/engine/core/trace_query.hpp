@@ -0,0 +1,130 @@
+/**
+ * Aetherium Automata - Trace Query
+ *
+ * Loads a binary trace (.aetr) into columns, one array per field, and
+ * answers the latency-budget questions asked of fault-injection campaigns:
+ * latency percentiles per message type, budget verdicts per placement and
+ * transport, how long the observable states were held, and what each fault
+ * action did to latency.
+ *
+ * One sequential pass indexes the frames and the string table; the records
+ * are then decoded, and every query scanned, in chunks on a work-stealing
+ * pool. Partial results merge in chunk order, so a report does not depend
+ * on the worker count. Host-side only.
+ */
+
+#ifndef AETHERIUM_TRACE_QUERY_HPP
+#define AETHERIUM_TRACE_QUERY_HPP
+
+#include "types.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace aeth {
+
+struct TraceQueryOptions {
+    size_t workers = 0;            // 0 = one per hardware thread
+    size_t chunkRecords = 1 << 16; // Records per decode / scan task
+};
+
+/**
+ * A trace as one array per field; row i of every column is record i in
+ * file order. Only the fields the queries read are kept.
+ */
+struct TraceColumns {
+    static constexpr uint32_t kNone = ~uint32_t{0};       // Absent id or number
+    static constexpr Timestamp kNoTime = ~Timestamp{0};
+    static constexpr uint8_t kNotJudged = 2;              // exceeded: no budget verdict
+
+    std::vector<std::string> strings;  // The file's string table; the id columns index it
+
+    std::vector<uint64_t> seq;
+    std::vector<uint32_t> kind;
+    std::vector<uint32_t> messageType;
+    std::vector<uint32_t> sourceInstance;
+    std::vector<uint32_t> transport;
+    std::vector<uint32_t> placement;
+    std::vector<uint32_t> observableState;  // kNone when the record has none
+    std::vector<RunId> runId;               // kNone when the record has none
+    std::vector<Timestamp> timestamp;       // Handle, else receive, else send time; kNoTime if none
+    std::vector<uint32_t> latencyMs;        // observedLatencyMs, kNone when absent
+    std::vector<uint8_t> exceeded;          // latencyBudgetExceeded: 0, 1 or kNotJudged
+
+    // Fault actions of record i: faultActions[faultBegin[i] .. faultBegin[i + 1])
+    std::vector<uint32_t> faultBegin;
+    std::vector<uint32_t> faultActions;
+
+    [[nodiscard]] size_t size() const { return seq.size(); }
+    [[nodiscard]] uint32_t findString(const std::string& text) const;
+};
+
+struct MessageLatencyStats {
+    std::string messageType;
+    uint64_t samples = 0;
+    uint32_t minMs = 0;
+    uint32_t p50Ms = 0;
+    uint32_t p90Ms = 0;
+    uint32_t p99Ms = 0;
+    uint32_t maxMs = 0;
+    double meanMs = 0.0;
+};
+
+struct BudgetVerdictCount {
+    std::string placement;
+    std::string transport;
+    uint64_t judged = 0;    // Records with a budget verdict
+    uint64_t exceeded = 0;
+};
+
+// Time from entering an observable state until the same instance and run left it
+struct StateDwellStats {
+    std::string state;
+    uint64_t visits = 0;  // Completed visits; one still open at the end of the trace is not counted
+    Timestamp minMs = 0;
+    Timestamp p50Ms = 0;
+    Timestamp p90Ms = 0;
+    Timestamp maxMs = 0;
+    double meanMs = 0.0;
+};
+
+struct FaultActionImpact {
+    std::string action;       // "(none)" for the records without a fault action
+    uint64_t records = 0;
+    uint64_t latencySamples = 0;
+    double meanLatencyMs = 0.0;
+    uint64_t judged = 0;
+    uint64_t exceeded = 0;
+};
+
+struct TraceAnalysisReport {
+    uint64_t records = 0;
+    size_t strings = 0;
+    std::vector<MessageLatencyStats> latency;  // By message type name
+    std::vector<BudgetVerdictCount> budget;    // By placement, then transport
+    std::vector<StateDwellStats> dwell;        // By state name
+    FaultActionImpact withoutFaults;
+    std::vector<FaultActionImpact> faults;     // By action name
+
+    [[nodiscard]] const MessageLatencyStats* findLatency(const std::string& messageType) const;
+    [[nodiscard]] const StateDwellStats* findDwell(const std::string& state) const;
+    [[nodiscard]] const FaultActionImpact* findFault(const std::string& action) const;
+    [[nodiscard]] std::string summary() const;
+};
+
+/**
+ * Decode the binary trace at `path` into columns. Errors when the file is
+ * not a binary trace or a frame is malformed.
+ */
+Result<TraceColumns> loadTraceColumns(const std::string& path, const TraceQueryOptions& options = {});
+
+// Run every query over `columns`
+TraceAnalysisReport analyzeTrace(const TraceColumns& columns, const TraceQueryOptions& options = {});
+
+// loadTraceColumns + analyzeTrace on one pool
+Result<TraceAnalysisReport> analyzeTraceFile(const std::string& path, const TraceQueryOptions& options = {});
+
+} // namespace aeth
+
+#endif // AETHERIUM_TRACE_QUERY_HPP
@@ -11,6 +11,7 @@
 #include "compat_mutex.hpp"
 #include "types.hpp"
 #include "protocol.hpp"
+#include <chrono>
 #include <queue>
 #include <functional>
 #include <memory>
@@ -84,6 +85,40 @@ public:
      */
     [[nodiscard]] virtual bool hasMessage() const = 0;
 
+    /**
+     * Block until a message is waiting or the timeout elapses.
+     * Returns hasMessage(). Transports without a receive thread do not
+     * block; callers should sleep themselves when this returns at once.
+     */
+    virtual bool waitForMessage(std::chrono::microseconds timeout) {
+        (void)timeout;
+        return hasMessage();
+    }
+
+    // Whether waitForMessage() actually blocks
+    [[nodiscard]] virtual bool canWait() const { return false; }
+
+    // Device id assigned by the peer's HelloAck (0 until known)
+    [[nodiscard]] virtual uint32_t assignedId() const { return 0; }
+
+    /**
+     * Hand up to max waiting messages to fn; returns how many were passed.
+     * Transports with a receive thread override this to take the whole
+     * batch with one synchronization.
+     */
+    virtual size_t drain(const MessageCallback& fn, size_t max) {
+        size_t count = 0;
+        while (count < max && hasMessage()) {
+            auto message = receive();
+            if (!message) {
+                break;
+            }
+            fn(std::move(message));
+            ++count;
+        }
+        return count;
+    }
+
     // ========================================================================
     // Async callbacks (optional)
     // ========================================================================
@@ -14,8 +14,13 @@
 #ifndef AETHERIUM_TYPES_HPP
 #define AETHERIUM_TYPES_HPP
 
+#include <atomic>
 #include <cstdint>
+#include <cstring>
+#include <new>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <variant>
 #include <vector>
 #include <optional>
@@ -59,66 +64,231 @@ enum class ValueType : uint8_t {
 };
 
 /**
- * Type-safe value container
- * Uses std::variant for type safety, but keeps memory footprint reasonable
+ * Non-owning byte range. Only valid while the bytes it points into are
+ * alive and unchanged.
+ */
+struct ByteView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    [[nodiscard]] bool empty() const { return size == 0; }
+    [[nodiscard]] const uint8_t* begin() const { return data; }
+    [[nodiscard]] const uint8_t* end() const { return data + size; }
+    [[nodiscard]] std::vector<uint8_t> toVector() const { return std::vector<uint8_t>(begin(), end()); }
+};
+
+/**
+ * Tagged value in 16 bytes. Scalars, and strings or binaries of up to
+ * INLINE_CAPACITY bytes, are stored inline; longer ones live in an
+ * immutable refcounted blob. Copies never allocate (a large value costs a
+ * refcount bump), moves are a 16-byte copy. Contents are read through
+ * str()/bytes(); a Value is replaced, never edited in place.
  */
 class Value {
 public:
-    using Storage = std::variant<
-        std::monostate,     // Void
-        bool,               // Bool
-        int32_t,            // Int32
-        int64_t,            // Int64
-        float,              // Float32
-        double,             // Float64
-        std::string,        // String
-        std::vector<uint8_t> // Binary
-    >;
-
-    Value() : data_(std::monostate{}) {}
-    explicit Value(bool v) : data_(v) {}
-    explicit Value(int32_t v) : data_(v) {}
-    explicit Value(int64_t v) : data_(v) {}
-    explicit Value(float v) : data_(v) {}
-    explicit Value(double v) : data_(v) {}
-    explicit Value(std::string v) : data_(std::move(v)) {}
-    explicit Value(const char* v) : data_(std::string(v)) {}
-    explicit Value(std::vector<uint8_t> v) : data_(std::move(v)) {}
-
-    [[nodiscard]] ValueType type() const {
-        return static_cast<ValueType>(data_.index());
+    static constexpr size_t INLINE_CAPACITY = 14;
+
+    Value() noexcept = default;
+    explicit Value(bool v) noexcept { setScalar(ValueType::Bool, v); }
+    explicit Value(int32_t v) noexcept { setScalar(ValueType::Int32, v); }
+    explicit Value(int64_t v) noexcept { setScalar(ValueType::Int64, v); }
+    explicit Value(float v) noexcept { setScalar(ValueType::Float32, v); }
+    explicit Value(double v) noexcept { setScalar(ValueType::Float64, v); }
+    explicit Value(std::string_view v) { setBuffer(ValueType::String, v.data(), v.size()); }
+    explicit Value(const std::string& v) : Value(std::string_view(v)) {}
+    explicit Value(const char* v) : Value(std::string_view(v)) {}
+    explicit Value(const std::vector<uint8_t>& v) { setBuffer(ValueType::Binary, v.data(), v.size()); }
+    explicit Value(ByteView v) { setBuffer(ValueType::Binary, v.data, v.size); }
+
+    Value(const Value& other) noexcept { copyFrom(other); }
+    Value(Value&& other) noexcept { stealFrom(other); }
+    Value& operator=(const Value& other) noexcept {
+        if (this != &other) {
+            release();
+            copyFrom(other);
+        }
+        return *this;
     }
+    Value& operator=(Value&& other) noexcept {
+        if (this != &other) {
+            release();
+            stealFrom(other);
+        }
+        return *this;
+    }
+    ~Value() { release(); }
 
-    [[nodiscard]] bool isVoid() const { return std::holds_alternative<std::monostate>(data_); }
-
-    template <typename T>
-    [[nodiscard]] bool is() const { return std::holds_alternative<T>(data_); }
+    [[nodiscard]] ValueType type() const { return type_; }
+    [[nodiscard]] bool isVoid() const { return type_ == ValueType::Void; }
 
     template <typename T>
-    [[nodiscard]] T& get() { return std::get<T>(data_); }
+    [[nodiscard]] bool is() const { return type_ == tagOf<T>(); }
 
+    // By value; strings and binaries are copied out, so prefer str()/bytes()
     template <typename T>
-    [[nodiscard]] const T& get() const { return std::get<T>(data_); }
+    [[nodiscard]] T get() const {
+        if (!is<T>()) {
+            throw std::bad_variant_access();
+        }
+        return read<T>();
+    }
 
     template <typename T>
     [[nodiscard]] std::optional<T> tryGet() const {
-        if (auto* p = std::get_if<T>(&data_)) {
-            return *p;
+        if (!is<T>()) {
+            return std::nullopt;
         }
-        return std::nullopt;
+        return read<T>();
     }
 
+    // Contents of a String / Binary (empty for other types)
+    [[nodiscard]] std::string_view str() const {
+        return type_ == ValueType::String ? std::string_view(reinterpret_cast<const char*>(buffer()), bufferSize())
+                                          : std::string_view();
+    }
+    [[nodiscard]] ByteView bytes() const {
+        return type_ == ValueType::Binary ? ByteView{buffer(), bufferSize()} : ByteView{};
+    }
+
+    // Whether the contents are in a shared blob rather than inline
+    [[nodiscard]] bool isShared() const { return inlineSize_ == HEAP; }
+
     // Conversion helpers
     [[nodiscard]] bool toBool() const;
     [[nodiscard]] int64_t toInt() const;
     [[nodiscard]] double toDouble() const;
     [[nodiscard]] std::string toString() const;
 
-    bool operator==(const Value& other) const { return data_ == other.data_; }
+    bool operator==(const Value& other) const;
     bool operator!=(const Value& other) const { return !(*this == other); }
 
 private:
-    Storage data_;
+    struct Blob {
+        std::atomic<uint32_t> refs;
+        uint32_t size;
+        [[nodiscard]] uint8_t* data() { return reinterpret_cast<uint8_t*>(this + 1); }
+    };
+
+    static constexpr uint8_t HEAP = 0xFF;  // inlineSize_ when storage_ holds a Blob*
+
+    template <typename T>
+    static constexpr ValueType tagOf() {
+        if constexpr (std::is_same_v<T, std::monostate>) return ValueType::Void;
+        else if constexpr (std::is_same_v<T, bool>) return ValueType::Bool;
+        else if constexpr (std::is_same_v<T, int32_t>) return ValueType::Int32;
+        else if constexpr (std::is_same_v<T, int64_t>) return ValueType::Int64;
+        else if constexpr (std::is_same_v<T, float>) return ValueType::Float32;
+        else if constexpr (std::is_same_v<T, double>) return ValueType::Float64;
+        else if constexpr (std::is_same_v<T, std::string>) return ValueType::String;
+        else if constexpr (std::is_same_v<T, std::vector<uint8_t>>) return ValueType::Binary;
+        else static_assert(sizeof(T) == 0, "type is not storable in a Value");
+    }
+
+    template <typename T>
+    [[nodiscard]] T read() const {
+        if constexpr (std::is_same_v<T, std::monostate>) {
+            return std::monostate{};
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            return std::string(str());
+        } else if constexpr (std::is_same_v<T, std::vector<uint8_t>>) {
+            return bytes().toVector();
+        } else {
+            T v;
+            std::memcpy(&v, storage_, sizeof(T));
+            return v;
+        }
+    }
+
+    template <typename T>
+    void setScalar(ValueType type, T v) {
+        type_ = type;
+        std::memcpy(storage_, &v, sizeof(T));
+    }
+
+    void setBuffer(ValueType type, const void* data, size_t size) {
+        type_ = type;
+        if (size <= INLINE_CAPACITY) {
+            inlineSize_ = static_cast<uint8_t>(size);
+            if (size > 0) {
+                std::memcpy(storage_, data, size);
+            }
+            return;
+        }
+        Blob* blob = new (::operator new(sizeof(Blob) + size)) Blob{{1}, static_cast<uint32_t>(size)};
+        std::memcpy(blob->data(), data, size);
+        std::memcpy(storage_, &blob, sizeof(blob));
+        inlineSize_ = HEAP;
+    }
+
+    [[nodiscard]] Blob* blob() const {
+        Blob* b = nullptr;
+        std::memcpy(&b, storage_, sizeof(b));
+        return b;
+    }
+    [[nodiscard]] const uint8_t* buffer() const {
+        return inlineSize_ == HEAP ? blob()->data() : reinterpret_cast<const uint8_t*>(storage_);
+    }
+    [[nodiscard]] size_t bufferSize() const { return inlineSize_ == HEAP ? blob()->size : inlineSize_; }
+
+    void copyFrom(const Value& other) noexcept {
+        std::memcpy(static_cast<void*>(this), &other, sizeof(Value));
+        if (inlineSize_ == HEAP) {
+            blob()->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    void stealFrom(Value& other) noexcept {
+        std::memcpy(static_cast<void*>(this), &other, sizeof(Value));
+        other.inlineSize_ = 0;
+        other.type_ = ValueType::Void;
+    }
+    void release() noexcept {
+        if (inlineSize_ == HEAP) {
+            Blob* b = blob();
+            if (b->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                b->~Blob();
+                ::operator delete(b);
+            }
+        }
+        inlineSize_ = 0;
+        type_ = ValueType::Void;
+    }
+
+    alignas(8) unsigned char storage_[INLINE_CAPACITY] = {};
+    uint8_t inlineSize_ = 0;
+    ValueType type_ = ValueType::Void;
+};
+
+static_assert(sizeof(Value) == 16, "Value should stay two words");
+
+inline bool Value::operator==(const Value& other) const {
+    if (type_ != other.type_) {
+        return false;
+    }
+    switch (type_) {
+        case ValueType::Void: return true;
+        case ValueType::Bool: return read<bool>() == other.read<bool>();
+        case ValueType::Int32: return read<int32_t>() == other.read<int32_t>();
+        case ValueType::Int64: return read<int64_t>() == other.read<int64_t>();
+        case ValueType::Float32: return read<float>() == other.read<float>();
+        case ValueType::Float64: return read<double>() == other.read<double>();
+        case ValueType::String:
+        case ValueType::Binary: {
+            if (isShared() && other.isShared() && blob() == other.blob()) {
+                return true;
+            }
+            const size_t size = bufferSize();
+            return size == other.bufferSize() && (size == 0 || std::memcmp(buffer(), other.buffer(), size) == 0);
+        }
+        default: return false;
+    }
+}
+
+/**
+ * One (id, value) write, as carried by batched inputs
+ */
+struct VariableUpdate {
+    VariableId id = INVALID_VARIABLE;
+    Value value;
 };
 
 // ============================================================================
@@ -9,8 +9,11 @@
 #define AETHERIUM_VARIABLE_HPP
 
 #include "types.hpp"
+#include <algorithm>
 #include <unordered_map>
 #include <functional>
+#include <utility>
+#include <vector>
 
 namespace aeth {
 
@@ -18,6 +21,19 @@ namespace aeth {
 // Variable Definition (static, from automata spec)
 // ============================================================================
 
+/**
+ * How an output's changes go up to the server (the `telemetry:` block of a
+ * variable in the automaton YAML). The default sends every change.
+ */
+struct TelemetryPolicy {
+    uint32_t windowMs = 0;       // Send min/max/mean/count/last per window instead of changes
+    uint32_t slideMs = 0;        // Sliding: close a windowMs window every slideMs (0 = tumbling)
+    double deadband = 0.0;       // Ignore changes within this of the last accepted value
+    uint32_t minIntervalMs = 0;  // Unwindowed: at most one change per interval, latest wins
+
+    [[nodiscard]] bool enabled() const { return windowMs > 0 || deadband > 0.0 || minIntervalMs > 0; }
+};
+
 /**
  * Definition of a variable from the automata specification
  */
@@ -28,6 +44,7 @@ struct VariableSpec {
     VariableDirection direction = VariableDirection::Internal;
     Value initialValue;
     std::string description;
+    TelemetryPolicy telemetry;
 
     VariableSpec() = default;
     VariableSpec(VariableId id, std::string name, ValueType type, 
@@ -37,69 +54,51 @@ struct VariableSpec {
 };
 
 // ============================================================================
-// Variable Instance (runtime, with current value)
+// Variable View (runtime, reads the store's columns)
 // ============================================================================
 
+class VariableStore;
+
 /**
- * Runtime instance of a variable with current value and change tracking
+ * Read-only view of one variable in a VariableStore. Values live in the
+ * store's per-id columns; writes go through the store. A Variable* stays
+ * valid until the next addVariable() or clear() on its store.
  */
 class Variable {
 public:
     Variable() = default;
-    explicit Variable(const VariableSpec& spec)
-        : spec_(spec), value_(spec.initialValue), changed_(false) {}
 
     // Identity
-    [[nodiscard]] VariableId id() const { return spec_.id; }
-    [[nodiscard]] const std::string& name() const { return spec_.name; }
-    [[nodiscard]] ValueType type() const { return spec_.type; }
-    [[nodiscard]] VariableDirection direction() const { return spec_.direction; }
+    [[nodiscard]] VariableId id() const { return id_; }
+    [[nodiscard]] const std::string& name() const { return spec().name; }
+    [[nodiscard]] ValueType type() const { return spec().type; }
+    [[nodiscard]] VariableDirection direction() const { return spec().direction; }
+    [[nodiscard]] const VariableSpec& spec() const;
 
     // Value access
-    [[nodiscard]] const Value& value() const { return value_; }
-    [[nodiscard]] const Value& previousValue() const { return prevValue_; }
-
-    /**
-     * Set the value. Returns false if type mismatch or direction violation.
-     * For inputs, use setExternal() instead.
-     */
-    bool set(Value newValue);
-
-    /**
-     * Set from external source (for inputs)
-     */
-    bool setExternal(Value newValue);
+    [[nodiscard]] const Value& value() const;
+    [[nodiscard]] const Value& previousValue() const;
 
     // Change detection
-    [[nodiscard]] bool hasChanged() const { return changed_; }
-    void clearChanged() { changed_ = false; }
-    void markChanged() { changed_ = true; }
+    [[nodiscard]] bool hasChanged() const;
 
-    // Timestamp of last update
-    [[nodiscard]] Timestamp lastUpdated() const { return lastUpdated_; }
-    void setTimestamp(Timestamp ts) { lastUpdated_ = ts; }
+    // Store revision of the last value change (see VariableStore::revision)
+    [[nodiscard]] uint64_t revision() const;
 
     // Access control
     [[nodiscard]] bool isReadable() const {
-        return spec_.direction != VariableDirection::Output;
+        return direction() != VariableDirection::Output;
     }
     [[nodiscard]] bool isWritable() const {
-        return spec_.direction != VariableDirection::Input;
-    }
-
-    // Reset to initial value
-    void reset() {
-        prevValue_ = value_;
-        value_ = spec_.initialValue;
-        changed_ = true;
+        return direction() != VariableDirection::Input;
     }
 
 private:
-    VariableSpec spec_;
-    Value value_;
-    Value prevValue_;
-    Timestamp lastUpdated_ = 0;
-    bool changed_ = false;
+    friend class VariableStore;
+    Variable(const VariableStore* store, VariableId id) : store_(store), id_(id) {}
+
+    const VariableStore* store_ = nullptr;
+    VariableId id_ = INVALID_VARIABLE;
 };
 
 // ============================================================================
@@ -112,11 +111,21 @@ private:
 using VariableChangeCallback = std::function<void(const Variable&)>;
 
 /**
- * Manages all variables for an automata instance
+ * Manages all variables for an automata instance.
+ *
+ * Storage is structure-of-arrays indexed directly by VariableId: specs,
+ * values, previous values and revisions are parallel vectors, and
+ * presence, changed and direction flags are bitsets. Changed-variable
+ * iteration is a bitset scan, clearAllChanged() zeroes a few words, and
+ * the direction views are built once per layout rather than per call.
  */
 class VariableStore {
 public:
     VariableStore() = default;
+    VariableStore(const VariableStore& other) { *this = other; }
+    VariableStore(VariableStore&& other) noexcept { *this = std::move(other); }
+    VariableStore& operator=(const VariableStore& other);
+    VariableStore& operator=(VariableStore&& other) noexcept;
 
     // Initialization
     void addVariable(const VariableSpec& spec);
@@ -128,11 +137,11 @@ public:
     [[nodiscard]] Variable* getByName(const std::string& name);
     [[nodiscard]] const Variable* getByName(const std::string& name) const;
 
-    // Bulk access
-    [[nodiscard]] std::vector<Variable*> inputs();
-    [[nodiscard]] std::vector<Variable*> outputs();
-    [[nodiscard]] std::vector<Variable*> internals();
-    [[nodiscard]] std::vector<Variable*> all();
+    // Bulk access, in id order (views rebuilt only when the layout changes)
+    [[nodiscard]] const std::vector<Variable*>& inputs() { return view(VariableDirection::Input); }
+    [[nodiscard]] const std::vector<Variable*>& outputs() { return view(VariableDirection::Output); }
+    [[nodiscard]] const std::vector<Variable*>& internals() { return view(VariableDirection::Internal); }
+    [[nodiscard]] const std::vector<Variable*>& all();
 
     // Value operations
     bool setValue(VariableId id, Value value);
@@ -140,27 +149,136 @@ public:
     bool setExternalValue(VariableId id, Value value);
     bool setExternalValue(const std::string& name, Value value);
 
+    /**
+     * Apply a batch of external writes as one update: nothing is written
+     * unless every id names an externally settable variable, and a
+     * repeated id keeps only its last value (one change per variable).
+     */
+    bool setExternalValues(const std::vector<VariableUpdate>& updates);
+
     [[nodiscard]] std::optional<Value> getValue(VariableId id) const;
     [[nodiscard]] std::optional<Value> getValue(const std::string& name) const;
 
     // Change tracking
-    void clearAllChanged();
+    void clearAllChanged() { std::fill(changedBits_.begin(), changedBits_.end(), 0); }
     [[nodiscard]] std::vector<Variable*> getChanged();
 
+    // Visit variables whose changed flag is set, in id order
+    template <typename Fn>
+    void forEachChanged(Fn&& fn) const;
+
+    /**
+     * Change journal: ids whose value changed since the last clearJournal(),
+     * once each, in first-change order. Unlike the changed flags it is not
+     * reset by clearAllChanged(), so a consumer can walk a whole tick's
+     * changes (on_exit, transition, on_enter) in one pass.
+     */
+    [[nodiscard]] const std::vector<VariableId>& changeJournal() const { return journal_; }
+    // A journaled variable that is back at its value from before the window
+    [[nodiscard]] bool journalReverted(VariableId id) const {
+        return testBit(journalBits_, id) && values_[id] == journalBase_[id];
+    }
+    void clearJournal();
+
+    /**
+     * Monotonic counter bumped on every value change. Each variable records
+     * the revision of its last change, so consumers that mirror the store
+     * (script engines) only need to visit variables newer than their last sync.
+     */
+    [[nodiscard]] uint64_t revision() const { return revision_; }
+
+    template <typename Fn>
+    void forEachChangedSince(uint64_t revision, Fn&& fn) const;
+
+    // Visit every variable (id order)
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        forEachBit(presentBits_, [&](VariableId id) { fn(handles_[id]); });
+    }
+
     // Callbacks
     void onVariableChange(VariableChangeCallback callback);
 
     // Reset all to initial values
     void resetAll();
 
+    /**
+     * Put back a value captured earlier (checkpoints): no direction or type
+     * checks, no change callbacks. Bumps the revision so mirrors resync.
+     */
+    bool restoreValue(VariableId id, Value value, Value previous, bool changed);
+
     // Stats
-    [[nodiscard]] size_t size() const { return variables_.size(); }
-    [[nodiscard]] bool empty() const { return variables_.empty(); }
+    [[nodiscard]] size_t size() const { return count_; }
+    [[nodiscard]] bool empty() const { return count_ == 0; }
 
 private:
-    std::unordered_map<VariableId, Variable> variables_;
+    friend class Variable;
+
+    using Bits = std::vector<uint64_t>;
+
+    static bool testBit(const Bits& bits, size_t i) {
+        return i / 64 < bits.size() && ((bits[i / 64] >> (i % 64)) & 1u) != 0;
+    }
+    static void assignBit(Bits& bits, size_t i, bool on) {
+        const uint64_t mask = uint64_t{1} << (i % 64);
+        bits[i / 64] = on ? (bits[i / 64] | mask) : (bits[i / 64] & ~mask);
+    }
+    static unsigned lowestBit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctzll(word));
+#else
+        unsigned n = 0;
+        while ((word & 1u) == 0) {
+            word >>= 1;
+            ++n;
+        }
+        return n;
+#endif
+    }
+    template <typename Fn>
+    static void forEachBit(const Bits& bits, Fn&& fn) {
+        for (size_t w = 0; w < bits.size(); ++w) {
+            for (uint64_t word = bits[w]; word != 0; word &= word - 1) {
+                fn(static_cast<VariableId>(w * 64 + lowestBit(word)));
+            }
+        }
+    }
+
+    [[nodiscard]] bool has(VariableId id) const { return testBit(presentBits_, id); }
+    [[nodiscard]] const std::vector<Variable*>& view(VariableDirection direction);
+    void rebuildViews();
+    void rebind();
+
+    // Write `value` to a present slot; false when `external` does not match its direction
+    bool write(VariableId id, Value value, bool external);
+    void commit(VariableId id, bool changed);
+
+    // Per-id columns; slots with no variable have presentBits_ clear
+    std::vector<VariableSpec> specs_;
+    std::vector<Value> values_;
+    std::vector<Value> previous_;
+    std::vector<uint64_t> revisions_;
+    std::vector<Variable> handles_;
+    std::vector<Value> journalBase_;  // Value before the id's first journaled change
+    Bits presentBits_;
+    Bits changedBits_;
+    Bits journalBits_;
+    Bits inputBits_;
+    Bits outputBits_;
+    size_t count_ = 0;
+
     std::unordered_map<std::string, VariableId> nameIndex_;
+    std::vector<Variable*> inputs_;
+    std::vector<Variable*> outputs_;
+    std::vector<Variable*> internals_;
+    std::vector<Variable*> all_;
+    bool viewsDirty_ = false;
+
     std::vector<VariableChangeCallback> changeCallbacks_;
+    uint64_t revision_ = 0;
+    std::vector<VariableId> journal_;
+    std::vector<std::pair<VariableId, size_t>> batch_;  // Reused by setExternalValues
 
     void notifyChange(const Variable& var);
 };
@@ -169,58 +287,149 @@ private:
 // Implementation: Variable
 // ============================================================================
 
-inline bool Variable::set(Value newValue) {
-    // Check direction - can't write to inputs from code
-    if (spec_.direction == VariableDirection::Input) {
-        return false;
-    }
+inline const VariableSpec& Variable::spec() const { return store_->specs_[id_]; }
+inline const Value& Variable::value() const { return store_->values_[id_]; }
+inline const Value& Variable::previousValue() const { return store_->previous_[id_]; }
+inline bool Variable::hasChanged() const { return VariableStore::testBit(store_->changedBits_, id_); }
+inline uint64_t Variable::revision() const { return store_->revisions_[id_]; }
 
-    // Type checking (allow compatible types)
-    if (newValue.type() != spec_.type && spec_.type != ValueType::Void) {
-        // Could add type coercion here
-        return false;
-    }
+// ============================================================================
+// Implementation: VariableStore
+// ============================================================================
 
-    prevValue_ = value_;
-    value_ = std::move(newValue);
-    changed_ = (value_ != prevValue_);
-    return true;
+inline VariableStore& VariableStore::operator=(const VariableStore& other) {
+    if (this != &other) {
+        specs_ = other.specs_;
+        values_ = other.values_;
+        previous_ = other.previous_;
+        revisions_ = other.revisions_;
+        journalBase_ = other.journalBase_;
+        handles_ = other.handles_;
+        presentBits_ = other.presentBits_;
+        changedBits_ = other.changedBits_;
+        journalBits_ = other.journalBits_;
+        inputBits_ = other.inputBits_;
+        outputBits_ = other.outputBits_;
+        count_ = other.count_;
+        nameIndex_ = other.nameIndex_;
+        changeCallbacks_ = other.changeCallbacks_;
+        revision_ = other.revision_;
+        journal_ = other.journal_;
+        rebind();
+    }
+    return *this;
 }
 
-inline bool Variable::setExternal(Value newValue) {
-    // External can set inputs
-    if (spec_.direction == VariableDirection::Output) {
-        return false; // Can't externally set outputs
+inline VariableStore& VariableStore::operator=(VariableStore&& other) noexcept {
+    if (this != &other) {
+        specs_ = std::move(other.specs_);
+        values_ = std::move(other.values_);
+        previous_ = std::move(other.previous_);
+        revisions_ = std::move(other.revisions_);
+        journalBase_ = std::move(other.journalBase_);
+        handles_ = std::move(other.handles_);
+        presentBits_ = std::move(other.presentBits_);
+        changedBits_ = std::move(other.changedBits_);
+        journalBits_ = std::move(other.journalBits_);
+        inputBits_ = std::move(other.inputBits_);
+        outputBits_ = std::move(other.outputBits_);
+        count_ = other.count_;
+        nameIndex_ = std::move(other.nameIndex_);
+        changeCallbacks_ = std::move(other.changeCallbacks_);
+        revision_ = other.revision_;
+        journal_ = std::move(other.journal_);
+        // Handles keep their addresses across a move, so the views stay valid
+        inputs_ = std::move(other.inputs_);
+        outputs_ = std::move(other.outputs_);
+        internals_ = std::move(other.internals_);
+        all_ = std::move(other.all_);
+        viewsDirty_ = other.viewsDirty_;
+        for (auto& handle : handles_) {
+            handle.store_ = this;
+        }
+        other.clear();
     }
-
-    prevValue_ = value_;
-    value_ = std::move(newValue);
-    changed_ = (value_ != prevValue_);
-    return true;
+    return *this;
 }
 
-// ============================================================================
-// Implementation: VariableStore
-// ============================================================================
-
 inline void VariableStore::addVariable(const VariableSpec& spec) {
-    variables_[spec.id] = Variable(spec);
-    nameIndex_[spec.name] = spec.id;
+    if (spec.id == INVALID_VARIABLE) {
+        return;
+    }
+    const size_t slots = static_cast<size_t>(spec.id) + 1;
+    if (slots > specs_.size()) {
+        const size_t words = (slots + 63) / 64;
+        specs_.resize(slots);
+        values_.resize(slots);
+        previous_.resize(slots);
+        revisions_.resize(slots, 0);
+        journalBase_.resize(slots);
+        handles_.resize(slots);
+        presentBits_.resize(words, 0);
+        changedBits_.resize(words, 0);
+        journalBits_.resize(words, 0);
+        inputBits_.resize(words, 0);
+        outputBits_.resize(words, 0);
+        rebind();
+    }
+
+    const VariableId id = spec.id;
+    if (!has(id)) {
+        ++count_;
+    } else if (specs_[id].name != spec.name) {
+        nameIndex_.erase(specs_[id].name);
+    }
+    specs_[id] = spec;
+    values_[id] = spec.initialValue;
+    previous_[id] = Value();
+    revisions_[id] = ++revision_;
+    assignBit(presentBits_, id, true);
+    assignBit(changedBits_, id, false);
+    if (testBit(journalBits_, id)) {
+        assignBit(journalBits_, id, false);
+        journal_.erase(std::find(journal_.begin(), journal_.end(), id));
+    }
+    assignBit(inputBits_, id, spec.direction == VariableDirection::Input);
+    assignBit(outputBits_, id, spec.direction == VariableDirection::Output);
+    nameIndex_[spec.name] = id;
+    viewsDirty_ = true;
 }
 
 inline void VariableStore::clear() {
-    variables_.clear();
+    specs_.clear();
+    values_.clear();
+    previous_.clear();
+    revisions_.clear();
+    journalBase_.clear();
+    handles_.clear();
+    presentBits_.clear();
+    changedBits_.clear();
+    journalBits_.clear();
+    journal_.clear();
+    inputBits_.clear();
+    outputBits_.clear();
+    count_ = 0;
     nameIndex_.clear();
+    inputs_.clear();
+    outputs_.clear();
+    internals_.clear();
+    all_.clear();
+    viewsDirty_ = false;
+}
+
+inline void VariableStore::rebind() {
+    for (size_t id = 0; id < handles_.size(); ++id) {
+        handles_[id] = Variable(this, static_cast<VariableId>(id));
+    }
+    viewsDirty_ = true;
 }
 
 inline Variable* VariableStore::get(VariableId id) {
-    auto it = variables_.find(id);
-    return it != variables_.end() ? &it->second : nullptr;
+    return has(id) ? &handles_[id] : nullptr;
 }
 
 inline const Variable* VariableStore::get(VariableId id) const {
-    auto it = variables_.find(id);
-    return it != variables_.end() ? &it->second : nullptr;
+    return has(id) ? &handles_[id] : nullptr;
 }
 
 inline Variable* VariableStore::getByName(const std::string& name) {
@@ -235,96 +444,116 @@ inline const Variable* VariableStore::getByName(const std::string& name) const {
     return get(it->second);
 }
 
-inline std::vector<Variable*> VariableStore::inputs() {
-    std::vector<Variable*> result;
-    for (auto& [id, var] : variables_) {
-        if (var.direction() == VariableDirection::Input) {
-            result.push_back(&var);
+inline void VariableStore::rebuildViews() {
+    inputs_.clear();
+    outputs_.clear();
+    internals_.clear();
+    all_.clear();
+    all_.reserve(count_);
+    forEachBit(presentBits_, [this](VariableId id) {
+        Variable* var = &handles_[id];
+        all_.push_back(var);
+        if (testBit(inputBits_, id)) {
+            inputs_.push_back(var);
+        } else if (testBit(outputBits_, id)) {
+            outputs_.push_back(var);
+        } else {
+            internals_.push_back(var);
         }
-    }
-    return result;
+    });
+    viewsDirty_ = false;
 }
 
-inline std::vector<Variable*> VariableStore::outputs() {
-    std::vector<Variable*> result;
-    for (auto& [id, var] : variables_) {
-        if (var.direction() == VariableDirection::Output) {
-            result.push_back(&var);
-        }
+inline const std::vector<Variable*>& VariableStore::view(VariableDirection direction) {
+    if (viewsDirty_) {
+        rebuildViews();
+    }
+    switch (direction) {
+        case VariableDirection::Input: return inputs_;
+        case VariableDirection::Output: return outputs_;
+        default: return internals_;
     }
-    return result;
 }
 
-inline std::vector<Variable*> VariableStore::internals() {
-    std::vector<Variable*> result;
-    for (auto& [id, var] : variables_) {
-        if (var.direction() == VariableDirection::Internal) {
-            result.push_back(&var);
-        }
+inline const std::vector<Variable*>& VariableStore::all() {
+    if (viewsDirty_) {
+        rebuildViews();
     }
-    return result;
+    return all_;
 }
 
-inline std::vector<Variable*> VariableStore::all() {
-    std::vector<Variable*> result;
-    result.reserve(variables_.size());
-    for (auto& [id, var] : variables_) {
-        result.push_back(&var);
+inline bool VariableStore::write(VariableId id, Value value, bool external) {
+    // Code can't write inputs; external sources can't write outputs
+    if (testBit(external ? outputBits_ : inputBits_, id)) {
+        return false;
     }
-    return result;
+    // Type checking (allow compatible types)
+    const ValueType type = specs_[id].type;
+    if (!external && value.type() != type && type != ValueType::Void) {
+        return false;
+    }
+
+    previous_[id] = std::move(values_[id]);
+    values_[id] = std::move(value);
+    commit(id, values_[id] != previous_[id]);
+    return true;
 }
 
-inline bool VariableStore::setValue(VariableId id, Value value) {
-    if (auto* var = get(id)) {
-        if (var->set(std::move(value))) {
-            if (var->hasChanged()) {
-                notifyChange(*var);
-            }
-            return true;
+inline void VariableStore::commit(VariableId id, bool changed) {
+    assignBit(changedBits_, id, changed);
+    if (changed) {
+        revisions_[id] = ++revision_;
+        if (!testBit(journalBits_, id)) {
+            assignBit(journalBits_, id, true);
+            journalBase_[id] = previous_[id];
+            journal_.push_back(id);
         }
+        notifyChange(handles_[id]);
     }
-    return false;
+}
+
+inline bool VariableStore::setValue(VariableId id, Value value) {
+    return has(id) && write(id, std::move(value), false);
 }
 
 inline bool VariableStore::setValue(const std::string& name, Value value) {
-    if (auto* var = getByName(name)) {
-        if (var->set(std::move(value))) {
-            if (var->hasChanged()) {
-                notifyChange(*var);
-            }
-            return true;
-        }
-    }
-    return false;
+    auto it = nameIndex_.find(name);
+    return it != nameIndex_.end() && write(it->second, std::move(value), false);
 }
 
 inline bool VariableStore::setExternalValue(VariableId id, Value value) {
-    if (auto* var = get(id)) {
-        if (var->setExternal(std::move(value))) {
-            if (var->hasChanged()) {
-                notifyChange(*var);
-            }
-            return true;
-        }
-    }
-    return false;
+    return has(id) && write(id, std::move(value), true);
 }
 
 inline bool VariableStore::setExternalValue(const std::string& name, Value value) {
-    if (auto* var = getByName(name)) {
-        if (var->setExternal(std::move(value))) {
-            if (var->hasChanged()) {
-                notifyChange(*var);
-            }
-            return true;
+    auto it = nameIndex_.find(name);
+    return it != nameIndex_.end() && write(it->second, std::move(value), true);
+}
+
+inline bool VariableStore::setExternalValues(const std::vector<VariableUpdate>& updates) {
+    batch_.clear();
+    for (size_t i = 0; i < updates.size(); ++i) {
+        const VariableId id = updates[i].id;
+        if (!has(id) || testBit(outputBits_, id)) {
+            return false;
+        }
+        batch_.emplace_back(id, i);
+    }
+
+    // Group writes per variable in arrival order; only the last one applies.
+    std::sort(batch_.begin(), batch_.end());
+    for (size_t k = 0; k < batch_.size(); ++k) {
+        if (k + 1 < batch_.size() && batch_[k + 1].first == batch_[k].first) {
+            continue;
         }
+        write(batch_[k].first, updates[batch_[k].second].value, true);
     }
-    return false;
+    return true;
 }
 
 inline std::optional<Value> VariableStore::getValue(VariableId id) const {
-    if (const auto* var = get(id)) {
-        return var->value();
+    if (has(id)) {
+        return values_[id];
     }
     return std::nullopt;
 }
@@ -336,20 +565,34 @@ inline std::optional<Value> VariableStore::getValue(const std::string& name) con
     return std::nullopt;
 }
 
-inline void VariableStore::clearAllChanged() {
-    for (auto& [id, var] : variables_) {
-        var.clearChanged();
-    }
-}
-
 inline std::vector<Variable*> VariableStore::getChanged() {
     std::vector<Variable*> result;
-    for (auto& [id, var] : variables_) {
-        if (var.hasChanged()) {
-            result.push_back(&var);
+    forEachBit(changedBits_, [&](VariableId id) { result.push_back(&handles_[id]); });
+    return result;
+}
+
+template <typename Fn>
+inline void VariableStore::forEachChanged(Fn&& fn) const {
+    forEachBit(changedBits_, [&](VariableId id) { fn(handles_[id]); });
+}
+
+template <typename Fn>
+inline void VariableStore::forEachChangedSince(uint64_t revision, Fn&& fn) const {
+    if (revision >= revision_) {
+        return;
+    }
+    for (size_t id = 0; id < revisions_.size(); ++id) {
+        if (revisions_[id] > revision && testBit(presentBits_, id)) {
+            fn(handles_[id]);
         }
     }
-    return result;
+}
+
+inline void VariableStore::clearJournal() {
+    for (VariableId id : journal_) {
+        assignBit(journalBits_, id, false);
+    }
+    journal_.clear();
 }
 
 inline void VariableStore::onVariableChange(VariableChangeCallback callback) {
@@ -362,10 +605,24 @@ inline void VariableStore::notifyChange(const Variable& var) {
     }
 }
 
-inline void VariableStore::resetAll() {
-    for (auto& [id, var] : variables_) {
-        var.reset();
+inline bool VariableStore::restoreValue(VariableId id, Value value, Value previous, bool changed) {
+    if (!has(id)) {
+        return false;
     }
+    values_[id] = std::move(value);
+    previous_[id] = std::move(previous);
+    assignBit(changedBits_, id, changed);
+    revisions_[id] = ++revision_;
+    return true;
+}
+
+inline void VariableStore::resetAll() {
+    forEachBit(presentBits_, [this](VariableId id) {
+        previous_[id] = values_[id];
+        values_[id] = specs_[id].initialValue;
+        assignBit(changedBits_, id, true);
+        revisions_[id] = ++revision_;
+    });
 }
 
 } // namespace aeth
@@ -125,23 +125,32 @@ void WebSocketTransport::onMessage(const ix::WebSocketMessagePtr& msg) {
     }
 }
 
+// msg->str is only valid for the callback, so decoding into owned fields
+// is the one copy the hand-off to the engine thread needs.
 void WebSocketTransport::handleBinaryMessage(const std::string& data) {
-    if (data.empty()) return;
-    
-    auto message = protocol::MessageFactory::deserialize(
-        reinterpret_cast<const uint8_t*>(data.data()), 
-        data.size()
-    );
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+    auto message = protocol::MessageFactory::deserialize(bytes, data.size());
     
     if (message) {
         if (message->type() == protocol::MessageType::HelloAck) {
-            if (auto* ack = dynamic_cast<protocol::HelloAckMessage*>(message.get())) {
-                assignedId_ = ack->assignedId;
+            assignedId_ = static_cast<const protocol::HelloAckMessage&>(*message).assignedId;
+        }
+        if (!inRing_.tryPush(std::move(message))) {
+            // Ring full: hold the socket thread (TCP backpressure) rather
+            // than drop commands.
+            ingressStalls_.fetch_add(1, std::memory_order_relaxed);
+            while (!inRing_.tryPush(std::move(message))) {
+                if (shuttingDown_) {
+                    return;
+                }
+                std::this_thread::yield();
             }
         }
-        std::lock_guard<std::mutex> lock(mutex_);
-        inQueue_.push(std::move(message));
-        cv_.notify_one();
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumerWaiting_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(waitMutex_);
+            cv_.notify_one();
+        }
     } else {
         std::cerr << "[WS] Failed to deserialize message, size=" << data.size() << std::endl;
     }
@@ -175,8 +184,10 @@ bool WebSocketTransport::send(std::unique_ptr<protocol::Message> msg) {
         msg->sourceId = assignedId_;
     }
     
-    auto bytes = msg->serialize();
-    return sendRaw(bytes.data(), bytes.size());
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    sendWriter_.clear();
+    msg->serializeInto(sendWriter_);
+    return sendLocked(sendWriter_.data(), sendWriter_.size());
 }
 
 bool WebSocketTransport::sendRaw(const uint8_t* data, size_t len) {
@@ -184,27 +195,46 @@ bool WebSocketTransport::sendRaw(const uint8_t* data, size_t len) {
         return false;
     }
     
-    std::string payload(reinterpret_cast<const char*>(data), len);
+    // Hello is sent from the socket thread, hence the lock.
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    return sendLocked(data, len);
+}
+
+bool WebSocketTransport::sendLocked(const uint8_t* data, size_t len) {
+    // Non-owning view: the frame goes from sendWriter_ (or the caller's
+    // bytes) straight into IXWebSocket's masking pass, with no string copy.
+    ix::IXWebSocketSendData payload(reinterpret_cast<const char*>(data), len);
     auto result = ws_.sendBinary(payload);
-    
     return result.success;
 }
 
 std::unique_ptr<protocol::Message> WebSocketTransport::receive() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (inQueue_.empty()) {
-        return nullptr;
-    }
-    
-    auto msg = std::move(inQueue_.front());
-    inQueue_.pop();
+    std::unique_ptr<protocol::Message> msg;
+    inRing_.tryPop(msg);
     return msg;
 }
 
 bool WebSocketTransport::hasMessage() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return !inQueue_.empty();
+    return !inRing_.empty();
+}
+
+size_t WebSocketTransport::drain(const MessageCallback& fn, size_t max) {
+    return inRing_.drain([&fn](std::unique_ptr<protocol::Message>&& msg) { fn(std::move(msg)); }, max);
+}
+
+bool WebSocketTransport::waitForMessage(std::chrono::microseconds timeout) {
+    if (!inRing_.empty()) {
+        return true;
+    }
+    std::unique_lock<std::mutex> lock(waitMutex_);
+    consumerWaiting_.store(true, std::memory_order_relaxed);
+    // Pairs with the fence after the producer's push (no lost wakeup).
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const bool ready = cv_.wait_for(lock, timeout, [this] {
+        return !inRing_.empty() || shuttingDown_.load();
+    }) && !inRing_.empty();
+    consumerWaiting_.store(false, std::memory_order_relaxed);
+    return ready;
 }
 
 std::string WebSocketTransport::info() const {
@@ -8,8 +8,8 @@
 #define AETHERIUM_WEBSOCKET_TRANSPORT_HPP
 
 #include "transport.hpp"
+#include "spsc_ring.hpp"
 #include <ixwebsocket/IXWebSocket.h>
-#include <queue>
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
@@ -33,6 +33,9 @@ public:
     bool sendRaw(const uint8_t* data, size_t len) override;
     std::unique_ptr<protocol::Message> receive() override;
     [[nodiscard]] bool hasMessage() const override;
+    bool waitForMessage(std::chrono::microseconds timeout) override;
+    [[nodiscard]] bool canWait() const override { return true; }
+    size_t drain(const MessageCallback& fn, size_t max) override;
 
     [[nodiscard]] std::string info() const override;
     [[nodiscard]] std::string name() const override { return "websocket"; }
@@ -44,12 +47,18 @@ public:
         helloDeployment_ = std::move(deployment);
     }
     void setAssignedId(uint32_t id) { assignedId_ = id; }
-    [[nodiscard]] uint32_t assignedId() const { return assignedId_; }
+    [[nodiscard]] uint32_t assignedId() const override { return assignedId_; }
+
+    // Times the receive thread found the ingress ring full and had to wait
+    [[nodiscard]] uint64_t ingressStalls() const { return ingressStalls_.load(std::memory_order_relaxed); }
+
+    static constexpr size_t INGRESS_CAPACITY = 4096;
 
 private:
     void onMessage(const ix::WebSocketMessagePtr& msg);
     void handleBinaryMessage(const std::string& data);
     void sendHello();
+    bool sendLocked(const uint8_t* data, size_t len);  // Caller holds sendMutex_
 
     ix::WebSocket ws_;
     std::string url_;
@@ -59,9 +68,16 @@ private:
     
     std::atomic<TransportState> state_{TransportState::Disconnected};
     
-    std::queue<std::unique_ptr<protocol::Message>> inQueue_;
-    mutable std::mutex mutex_;
+    // Filled by the IXWebSocket thread, drained by the engine loop. The
+    // mutex/cv pair is only touched when the consumer is blocked waiting.
+    SpscRing<std::unique_ptr<protocol::Message>> inRing_{INGRESS_CAPACITY};
+    std::mutex waitMutex_;
     std::condition_variable cv_;
+    std::atomic<bool> consumerWaiting_{false};
+    std::atomic<uint64_t> ingressStalls_{0};
+
+    std::mutex sendMutex_;
+    protocol::ByteWriter sendWriter_;
 
     std::atomic<uint32_t> nextMsgId_{1};
     std::atomic<uint32_t> assignedId_{0};
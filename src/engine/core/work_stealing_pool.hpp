@@ -0,0 +1,178 @@
+/**
+ * Aetherium Automata - Work-Stealing Pool
+ *
+ * Fixed set of worker threads, each owning a task deque. Tasks are
+ * submitted round-robin; a worker pops from the front of its own deque
+ * and, when that is empty, steals from the back of the others. Host-side
+ * only (needs std::thread).
+ */
+
+#ifndef AETHERIUM_WORK_STEALING_POOL_HPP
+#define AETHERIUM_WORK_STEALING_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace aeth {
+
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * Start the workers (0 = one per hardware thread)
+     */
+    explicit WorkStealingPool(size_t workers = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(Task task);
+
+    /**
+     * Block until every submitted task has finished
+     */
+    void waitIdle();
+
+    [[nodiscard]] size_t workerCount() const { return threads_.size(); }
+    [[nodiscard]] uint64_t stolenCount() const { return stolen_.load(std::memory_order_relaxed); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(size_t index);
+    bool tryPop(size_t index, Task& out);
+    bool trySteal(size_t thief, Task& out);
+    void finishTask();
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::atomic<size_t> queued_{0};   // In a deque, not yet taken
+    std::atomic<size_t> pending_{0};  // Submitted, not yet finished
+    std::atomic<size_t> nextQueue_{0};
+    std::atomic<uint64_t> stolen_{0};
+    bool stopping_ = false;
+};
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+inline WorkStealingPool::WorkStealingPool(size_t workers) {
+    if (workers == 0) {
+        workers = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    queues_.reserve(workers);
+    for (size_t i = 0; i < workers; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    threads_.reserve(workers);
+    for (size_t i = 0; i < workers; ++i) {
+        threads_.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+inline WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+inline void WorkStealingPool::submit(Task task) {
+    const size_t index = nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    queued_.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+    }
+    wake_.notify_one();
+}
+
+inline void WorkStealingPool::waitIdle() {
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    idle_.wait(lock, [this] { return pending_.load(std::memory_order_acquire) == 0; });
+}
+
+inline void WorkStealingPool::workerLoop(size_t index) {
+    while (true) {
+        Task task;
+        if (tryPop(index, task) || trySteal(index, task)) {
+            task();
+            finishTask();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        wake_.wait(lock, [this] {
+            return stopping_ || queued_.load(std::memory_order_acquire) > 0;
+        });
+        if (stopping_ && queued_.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+inline bool WorkStealingPool::tryPop(size_t index, Task& out) {
+    Queue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    out = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    queued_.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
+
+inline bool WorkStealingPool::trySteal(size_t thief, Task& out) {
+    const size_t count = queues_.size();
+    for (size_t offset = 1; offset < count; ++offset) {
+        Queue& victim = *queues_[(thief + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty()) {
+            continue;
+        }
+        out = std::move(victim.tasks.back());
+        victim.tasks.pop_back();
+        queued_.fetch_sub(1, std::memory_order_acq_rel);
+        stolen_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+inline void WorkStealingPool::finishTask() {
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        idle_.notify_all();
+    }
+}
+
+} // namespace aeth
+
+#endif // AETHERIUM_WORK_STEALING_POOL_HPP
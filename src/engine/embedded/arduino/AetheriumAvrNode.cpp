@@ -50,8 +50,10 @@ void AetheriumAvrNode::loop() {
 
     // Use the platform clock bound into the runtime through Engine::tick().
     // We just rate-limit loop() calls to avoid busy-spinning on MCU.
+    // A deployment with pacing sets the period through the engine's pacer.
     const Timestamp wall = platform::millis();
-    if (engine_.isRunning() && (lastTickMs_ == 0 || wall - lastTickMs_ >= options_.tickPeriodMs)) {
+    const uint32_t periodMs = engine_.pacer().enabled() ? 1000 / engine_.tickRate() : options_.tickPeriodMs;
+    if (engine_.isRunning() && (lastTickMs_ == 0 || wall - lastTickMs_ >= periodMs)) {
         engine_.tick();
         lastTickMs_ = wall;
     }
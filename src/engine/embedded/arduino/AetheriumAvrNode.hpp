@@ -15,6 +15,8 @@ struct AvrNodeOptions {
     EngineInitOptions engineInit;
     uint32_t tickPeriodMs = 10;
     uint64_t randomSeed = 0xA37E57ULL;
+    // Boards with a hardware service: stage writes and apply them once per tick
+    bool batchActuation = false;
 };
 
 class AetheriumAvrNode {
@@ -10,6 +10,9 @@ constexpr uint32_t kHelloRetryIntervalMs = 3'000;
 constexpr uint32_t kHelloRefreshIntervalMs = 15'000;
 constexpr uint32_t kKeepAliveIntervalMs = 10'000;
 constexpr uint32_t kEngineEventFlushIntervalMs = 20;
+constexpr uint32_t kEventBatchDeadlineMs = 20;
+// Below this much free TX space, events stay queued in the engine
+constexpr int kTxCongestedBelowBytes = AETHERIUM_SERIAL_TX_BATCH_BYTES / 2;
 
 protocol::DeviceCapabilities defaultCapabilitiesForDeviceType(protocol::DeviceType deviceType) {
     switch (deviceType) {
@@ -33,7 +36,9 @@ protocol::DeviceCapabilities defaultCapabilitiesForDeviceType(protocol::DeviceTy
 #ifdef ARDUINO
 AetheriumAvrSerialLink::AetheriumAvrSerialLink(AetheriumAvrNode& node, Stream& stream)
     : node_(node)
-    , stream_(&stream) {}
+    , txBatch_(kEventBatchDeadlineMs) {
+    attach(stream);
+}
 #else
 AetheriumAvrSerialLink::AetheriumAvrSerialLink(AetheriumAvrNode& node)
     : node_(node) {}
@@ -41,7 +46,15 @@ AetheriumAvrSerialLink::AetheriumAvrSerialLink(AetheriumAvrNode& node)
 
 #ifdef ARDUINO
 void AetheriumAvrSerialLink::attach(Stream& stream) {
+#if defined(ARDUINO_ARCH_ESP32)
+    if (uart_) {
+        uart_->onReceive(nullptr);
+        uart_ = nullptr;
+    }
+#endif
     stream_ = &stream;
+    // Nonzero while the TX buffer is still empty means the stream tracks it
+    txSpaceKnown_ = stream.availableForWrite() > 0;
     helloAcknowledged_ = false;
     lastKeepAliveSentMs_ = 0;
     lastEventFlushMs_ = 0;
@@ -72,7 +85,7 @@ bool AetheriumAvrSerialLink::sendHello(const SerialHelloOptions& opts) {
     hello.name = helloOptions_.deviceNameOverride.empty() ? node_.engine().deviceName() : helloOptions_.deviceNameOverride;
     hello.capabilities = helloOptions_.capabilitiesOverride.value_or(defaultCapabilitiesForDeviceType(helloOptions_.deviceType));
 
-    writeFrame(hello.serialize());
+    writeFrame(hello, true);
     helloAcknowledged_ = false;
     lastKeepAliveSentMs_ = 0;
     lastHelloSentMs_ = static_cast<uint32_t>(::millis());
@@ -80,6 +93,15 @@ bool AetheriumAvrSerialLink::sendHello(const SerialHelloOptions& opts) {
 #endif
 }
 
+#if defined(ARDUINO) && defined(ARDUINO_ARCH_ESP32)
+void AetheriumAvrSerialLink::attachUart(HardwareSerial& serial) {
+    attach(serial);
+    fillRx(serial);  // Still the only producer until the callback is set
+    uart_ = &serial;
+    serial.onReceive([this, &serial]() { fillRx(serial); });
+}
+#endif
+
 void AetheriumAvrSerialLink::poll() {
 #ifdef ARDUINO
     drainSerial();
@@ -87,33 +109,62 @@ void AetheriumAvrSerialLink::poll() {
     maybeFlushEngineEvents();
     maybeSendHelloRetry();
     maybeSendKeepAlive();
+    txBatch_.flushIfDue(static_cast<uint32_t>(::millis()), [this](const uint8_t* data, size_t len) {
+        writeBytes(data, len);
+    });
 #endif
 }
 
 #ifdef ARDUINO
 void AetheriumAvrSerialLink::drainSerial() {
-    if (!stream_) {
-        return;
+#if defined(ARDUINO_ARCH_ESP32)
+    if (uart_) {
+        return;  // The driver callback fills the ring
     }
+#endif
+    if (stream_) {
+        fillRx(*stream_);
+    }
+}
 
-    while (stream_->available() > 0) {
-        const int b = stream_->read();
-        if (b < 0) {
-            break;
+void AetheriumAvrSerialLink::fillRx(Stream& stream) {
+    int available = stream.available();
+    while (available > 0) {
+        size_t span = 0;
+        uint8_t* out = rx_.writable(span);
+        if (span == 0) {
+            return;  // Ring full: the rest waits in the UART buffer
         }
-        rxBuffer_.push_back(static_cast<uint8_t>(b));
-        if (rxBuffer_.size() > protocol::MAX_MESSAGE_SIZE * 2) {
-            // Hard guard against unbounded growth on malformed input.
-            rxBuffer_.erase(rxBuffer_.begin(), rxBuffer_.begin() + static_cast<std::ptrdiff_t>(rxBuffer_.size() / 2));
+        const size_t got = stream.readBytes(out, std::min(span, static_cast<size_t>(available)));
+        if (got == 0) {
+            return;
         }
+        rx_.commit(got);
+        available = stream.available();
     }
 }
 
-void AetheriumAvrSerialLink::writeFrame(const std::vector<uint8_t>& bytes) {
-    if (!stream_ || bytes.empty()) {
+void AetheriumAvrSerialLink::writeFrame(const protocol::Message& msg, bool flushNow) {
+    if (!stream_) {
         return;
     }
-    stream_->write(bytes.data(), bytes.size());
+    txWriter_.clear();
+    msg.serializeInto(txWriter_);
+    auto sink = [this](const uint8_t* data, size_t len) { writeBytes(data, len); };
+    txBatch_.append(txWriter_.data(), txWriter_.size(), static_cast<uint32_t>(::millis()), sink);
+    if (flushNow) {
+        txBatch_.flush(sink);
+    }
+}
+
+void AetheriumAvrSerialLink::writeBytes(const uint8_t* data, size_t len) {
+    if (stream_) {
+        stream_->write(data, len);
+    }
+}
+
+bool AetheriumAvrSerialLink::txCongested() const {
+    return txSpaceKnown_ && stream_ && stream_->availableForWrite() < kTxCongestedBelowBytes;
 }
 
 void AetheriumAvrSerialLink::maybeFlushEngineEvents() {
@@ -121,14 +172,26 @@ void AetheriumAvrSerialLink::maybeFlushEngineEvents() {
         return;
     }
 
+    // A full TX buffer holds events back in the engine, which collapses and
+    // caps them, instead of blocking here on every frame
+    Engine& engine = node_.engine();
+    const bool congested = txCongested();
+    engine.setEventBackpressure(congested);
+    if (congested) {
+        return;
+    }
+
+    // Pending events go into the batch right away; the batch deadline, not
+    // this interval, bounds their latency
     const uint32_t now = static_cast<uint32_t>(::millis());
-    if (kEngineEventFlushIntervalMs > 0 &&
+    if (engine.pendingEventCount() == 0 &&
+        kEngineEventFlushIntervalMs > 0 &&
         lastEventFlushMs_ != 0 &&
         (now - lastEventFlushMs_) < kEngineEventFlushIntervalMs) {
         return;
     }
 
-    sendReplies(node_.engine().processCommandQueue());
+    sendReplies(engine.processCommandQueue(), false);
     lastEventFlushMs_ = now;
 }
 
@@ -168,40 +231,15 @@ void AetheriumAvrSerialLink::maybeSendKeepAlive() {
     ping.timestamp = now;
     ping.sequenceNumber = keepAliveSequence_++;
 
-    writeFrame(ping.serialize());
+    writeFrame(ping, true);
     lastKeepAliveSentMs_ = now;
 }
 #endif
 
 void AetheriumAvrSerialLink::processRxBuffer() {
-    while (true) {
-        if (rxBuffer_.size() < protocol::HEADER_SIZE) {
-            return;
-        }
-
-        // Resync to magic if needed.
-        if (!(rxBuffer_[0] == static_cast<uint8_t>((protocol::MAGIC >> 8) & 0xFF) &&
-              rxBuffer_[1] == static_cast<uint8_t>(protocol::MAGIC & 0xFF))) {
-            rxBuffer_.erase(rxBuffer_.begin());
-            continue;
-        }
-
-        const uint16_t payloadLen =
-            (static_cast<uint16_t>(rxBuffer_[4]) << 8) |
-            static_cast<uint16_t>(rxBuffer_[5]);
-        const size_t totalLen = protocol::HEADER_SIZE + static_cast<size_t>(payloadLen);
-
-        if (totalLen > protocol::MAX_MESSAGE_SIZE) {
-            rxBuffer_.erase(rxBuffer_.begin());
-            continue;
-        }
-        if (rxBuffer_.size() < totalLen) {
-            return;
-        }
-
-        handleFrame(rxBuffer_.data(), totalLen);
-        rxBuffer_.erase(rxBuffer_.begin(), rxBuffer_.begin() + static_cast<std::ptrdiff_t>(totalLen));
-    }
+    platform::parseFrames(rx_, rxScratch_, [this](const uint8_t* data, size_t len) {
+        handleFrame(data, len);
+    });
 }
 
 void AetheriumAvrSerialLink::handleFrame(const uint8_t* data, size_t len) {
@@ -227,12 +265,13 @@ void AetheriumAvrSerialLink::handleFrame(const uint8_t* data, size_t len) {
     }
 
     node_.engine().enqueueCommand(std::move(msg));
-    sendReplies(node_.engine().processCommandQueue());
+    sendReplies(node_.engine().processCommandQueue(), true);
 }
 
-void AetheriumAvrSerialLink::sendReplies(Engine::Replies replies) {
+void AetheriumAvrSerialLink::sendReplies(Engine::Replies replies, bool flushNow) {
 #ifndef ARDUINO
     (void) replies;
+    (void) flushNow;
 #else
     if (!stream_) {
         return;
@@ -241,7 +280,10 @@ void AetheriumAvrSerialLink::sendReplies(Engine::Replies replies) {
     for (auto& msg : replies) {
         if (!msg) continue;
         stampOutgoing(*msg);
-        writeFrame(msg->serialize());
+        writeFrame(*msg, false);
+    }
+    if (flushNow) {
+        txBatch_.flush([this](const uint8_t* data, size_t len) { writeBytes(data, len); });
     }
 #endif
 }
@@ -4,6 +4,8 @@
 #include "AetheriumAvrNode.hpp"
 #include "engine/core/capabilities.hpp"
 #include "engine/core/protocol.hpp"
+#include "engine/embedded/platform/FrameBatcher.hpp"
+#include "engine/embedded/platform/SerialRing.hpp"
 
 #ifdef ARDUINO
 #include <Arduino.h>
@@ -14,7 +16,26 @@
 #include <cstdint>
 #include <optional>
 #include <string>
-#include <vector>
+
+// Receive ring; also bounds the largest frame the link accepts
+#ifndef AETHERIUM_SERIAL_RX_RING_BYTES
+#if defined(__AVR__)
+#define AETHERIUM_SERIAL_RX_RING_BYTES 256
+#elif defined(ARDUINO_ARCH_ESP32)
+#define AETHERIUM_SERIAL_RX_RING_BYTES 8192
+#else
+#define AETHERIUM_SERIAL_RX_RING_BYTES 4096
+#endif
+#endif
+
+// Largest outbound write; engine events are packed up to this size
+#ifndef AETHERIUM_SERIAL_TX_BATCH_BYTES
+#if defined(__AVR__)
+#define AETHERIUM_SERIAL_TX_BATCH_BYTES 64
+#else
+#define AETHERIUM_SERIAL_TX_BATCH_BYTES 512
+#endif
+#endif
 
 namespace aeth::embedded::arduino {
 
@@ -39,6 +60,15 @@ public:
     void attach(Stream& stream);
 #endif
 
+#if defined(ARDUINO) && defined(ARDUINO_ARCH_ESP32)
+    /**
+     * Receive from the UART driver's event task instead of polling: the
+     * driver's onReceive callback fills the RX ring and poll() only parses.
+     * A full ring leaves bytes in the driver buffer until the next event.
+     */
+    void attachUart(HardwareSerial& serial);
+#endif
+
     bool sendHello(const SerialHelloOptions& opts = {});
     void poll();
 
@@ -48,21 +78,32 @@ public:
 private:
 #ifdef ARDUINO
     void drainSerial();
-    void writeFrame(const std::vector<uint8_t>& bytes);
+    void fillRx(Stream& stream);
+    // `flushNow` sends the pending batch too; events leave it to the deadline
+    void writeFrame(const protocol::Message& msg, bool flushNow);
+    void writeBytes(const uint8_t* data, size_t len);
+    [[nodiscard]] bool txCongested() const;
     void maybeFlushEngineEvents();
     void maybeSendHelloRetry();
     void maybeSendKeepAlive();
 #endif
     void processRxBuffer();
     void handleFrame(const uint8_t* data, size_t len);
-    void sendReplies(Engine::Replies replies);
+    void sendReplies(Engine::Replies replies, bool flushNow);
     void stampOutgoing(protocol::Message& msg);
 
     AetheriumAvrNode& node_;
 #ifdef ARDUINO
     Stream* stream_ = nullptr;
 #endif
-    std::vector<uint8_t> rxBuffer_;
+#if defined(ARDUINO) && defined(ARDUINO_ARCH_ESP32)
+    HardwareSerial* uart_ = nullptr;  // Set while the driver callback fills rx_
+#endif
+    platform::SerialRing<AETHERIUM_SERIAL_RX_RING_BYTES> rx_;
+    uint8_t rxScratch_[AETHERIUM_SERIAL_RX_RING_BYTES]{};  // Frames that wrap rx_
+    protocol::ByteWriter txWriter_;  // Reused; stops growing at the largest frame
+    platform::FrameBatcher<AETHERIUM_SERIAL_TX_BATCH_BYTES> txBatch_;
+    bool txSpaceKnown_ = false;  // Stream reports availableForWrite()
     std::atomic<uint32_t> nextMessageId_{1};
     std::atomic<uint32_t> assignedId_{0};
     SerialHelloOptions helloOptions_{};
@@ -1,6 +1,7 @@
 #include "AetheriumEmbeddedLuaEngine.hpp"
 
 #include "engine/core/hardware_service.hpp"
+#include "engine/core/lua_chunk.hpp"
 #include "engine/embedded/platform/EmbeddedPlatformHooks.hpp"
 
 extern "C" {
@@ -23,6 +24,29 @@ namespace aeth::embedded::arduino {
 
 namespace {
 
+const LuaChunkTarget kLuaTarget = luaChunkTarget<lua_Integer, lua_Number>(LUA_VERSION_NUM);
+
+// Precompiled chunk when it was built for this Lua, otherwise the source
+int loadCode(lua_State* L, const CodeBlock& code, CodeKind kind) {
+    LuaChunkView chunk;
+    if (loadableLuaChunk(code, kLuaTarget, kind, chunk)) {
+#if defined(LUA_VERSION_NUM) && LUA_VERSION_NUM >= 502
+        const int status = luaL_loadbufferx(L, chunk.data, chunk.size, "=precompiled", "b");
+#else
+        const int status = luaL_loadbuffer(L, chunk.data, chunk.size, "=precompiled");
+#endif
+        if (status == 0) {
+            return 0;
+        }
+        lua_pop(L, 1);
+    }
+    if (kind == CodeKind::Expression) {
+        const std::string expr = "return (" + code.text() + ")";
+        return luaL_loadstring(L, expr.c_str());
+    }
+    return luaL_loadstring(L, code.text().c_str());
+}
+
 void requireLibrary(lua_State* L, const char* name, lua_CFunction openFn) {
 #if defined(LUA_VERSION_NUM) && LUA_VERSION_NUM >= 502
     luaL_requiref(L, name, openFn, 1);
@@ -67,7 +91,7 @@ bool pushRuntimeValue(lua_State* L, const Value& value) {
             lua_pushnumber(L, static_cast<lua_Number>(value.get<double>()));
             return true;
         case ValueType::String:
-            lua_pushlstring(L, value.get<std::string>().c_str(), value.get<std::string>().size());
+            lua_pushlstring(L, value.str().data(), value.str().size());
             return true;
         default:
             lua_pushnil(L);
@@ -353,6 +377,20 @@ int luaI2cOpen(lua_State* L) {
     return 0;
 }
 
+int luaI2cWrite(lua_State* L) {
+    const int bus = static_cast<int>(luaL_checkinteger(L, 1));
+    const int address = static_cast<int>(luaL_checkinteger(L, 2));
+    const int argc = lua_gettop(L);
+    std::vector<uint8_t> data;
+    data.reserve(argc > 2 ? static_cast<size_t>(argc - 2) : 0);
+    for (int i = 3; i <= argc; ++i) {
+        data.push_back(static_cast<uint8_t>(luaL_checkinteger(L, i)));
+    }
+    auto result = requireHardware().i2cWrite(bus, address, data);
+    if (result.isError()) return pushError(L, result.error());
+    return 0;
+}
+
 int luaI2cScan(lua_State* L) {
     const int bus = lua_gettop(L) >= 1 ? static_cast<int>(luaL_checkinteger(L, 1)) : 0;
     auto result = requireHardware().i2cScan(bus);
@@ -367,44 +405,43 @@ int luaI2cScan(lua_State* L) {
     return 1;
 }
 
-int luaComponentInvoke(lua_State* L) {
-    auto* component = static_cast<IComponent*>(lua_touserdata(L, lua_upvalueindex(1)));
-    const char* method = luaL_checkstring(L, 2);
-    if (!component) {
-        return pushError(L, "component unavailable");
-    }
+constexpr const char* kComponentCacheKey = "aetherium.components";
 
+// Stack slots `first`..top become the call's arguments, without a heap vector
+int callComponent(lua_State* L, IComponent& component, ComponentMethod method, int first) {
     const int argc = lua_gettop(L);
-    std::vector<Value> args;
-    args.reserve(argc > 2 ? static_cast<size_t>(argc - 2) : 0);
-    for (int i = 3; i <= argc; ++i) {
-        args.push_back(toRuntimeValue(L, i));
+    InlineValueArgs<> args(argc >= first ? static_cast<size_t>(argc - first + 1) : 0);
+    for (int i = first; i <= argc; ++i) {
+        args[static_cast<size_t>(i - first)] = toRuntimeValue(L, i);
     }
 
-    auto result = component->invoke(method, args);
+    auto result = component.call(method, args.span());
     if (result.isError()) return pushError(L, result.error());
     pushRuntimeValue(L, result.value());
     return 1;
 }
 
-int luaComponentMethod(lua_State* L) {
+int luaComponentInvoke(lua_State* L) {
     auto* component = static_cast<IComponent*>(lua_touserdata(L, lua_upvalueindex(1)));
-    const char* method = lua_tostring(L, lua_upvalueindex(2));
-    if (!component || !method) {
-        return pushError(L, "component method unavailable");
+    const char* method = luaL_checkstring(L, 2);
+    if (!component) {
+        return pushError(L, "component unavailable");
     }
-
-    const int argc = lua_gettop(L);
-    std::vector<Value> args;
-    args.reserve(argc > 1 ? static_cast<size_t>(argc - 1) : 0);
-    for (int i = 2; i <= argc; ++i) {
-        args.push_back(toRuntimeValue(L, i));
+    const ComponentMethod id = component->resolve(method);
+    if (id == INVALID_COMPONENT_METHOD) {
+        return pushError(L, "unknown component method");
     }
+    return callComponent(L, *component, id, 3);
+}
 
-    auto result = component->invoke(method, args);
-    if (result.isError()) return pushError(L, result.error());
-    pushRuntimeValue(L, result.value());
-    return 1;
+// Upvalues: the component and the method id resolved when the table was built
+int luaComponentMethod(lua_State* L) {
+    auto* component = static_cast<IComponent*>(lua_touserdata(L, lua_upvalueindex(1)));
+    if (!component) {
+        return pushError(L, "component method unavailable");
+    }
+    const auto id = static_cast<ComponentMethod>(lua_tointeger(L, lua_upvalueindex(2)));
+    return callComponent(L, *component, id, 2);
 }
 
 int luaComponent(lua_State* L) {
@@ -414,18 +451,56 @@ int luaComponent(lua_State* L) {
         return pushError(L, "unknown component");
     }
 
+    // Tables are built once per component and kept in the registry
+    lua_getfield(L, LUA_REGISTRYINDEX, kComponentCacheKey);
+    if (!lua_istable(L, -1)) {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushvalue(L, -1);
+        lua_setfield(L, LUA_REGISTRYINDEX, kComponentCacheKey);
+    }
+    lua_getfield(L, -1, name);
+    if (lua_istable(L, -1)) {
+        lua_getfield(L, -1, "__component");
+        const bool same = lua_touserdata(L, -1) == component;
+        lua_pop(L, 1);
+        if (same) {
+            return 1;
+        }
+    }
+    lua_pop(L, 1);
+
     lua_newtable(L);
 
+    lua_pushlightuserdata(L, component);
+    lua_setfield(L, -2, "__component");
+
     lua_pushlightuserdata(L, component);
     lua_pushcclosure(L, luaComponentInvoke, 1);
     lua_setfield(L, -2, "invoke");
 
-    for (const auto& method : component->methods()) {
+    auto bindMethod = [&](const char* method, ComponentMethod id) {
         lua_pushlightuserdata(L, component);
-        lua_pushlstring(L, method.c_str(), method.size());
+        lua_pushinteger(L, static_cast<lua_Integer>(id));
         lua_pushcclosure(L, luaComponentMethod, 2);
-        lua_setfield(L, -2, method.c_str());
+        lua_setfield(L, -2, method);
+    };
+    if (const ComponentDescriptor* descriptor = component->descriptor()) {
+        // Straight from the method table in flash: index = method id
+        for (uint16_t i = 0; i < descriptor->methodCount; ++i) {
+            bindMethod(descriptor->methods[i].name, static_cast<ComponentMethod>(i));
+        }
+    } else {
+        for (const auto& method : component->methods()) {
+            const ComponentMethod id = component->resolve(method);
+            if (id != INVALID_COMPONENT_METHOD) {
+                bindMethod(method.c_str(), id);
+            }
+        }
     }
+
+    lua_pushvalue(L, -1);
+    lua_setfield(L, -3, name);
     return 1;
 }
 
@@ -445,9 +520,13 @@ Result<void> EmbeddedLuaScriptEngine::initialize(VariableStore* variables) {
         state_ = nullptr;
     }
 
-    state_ = luaL_newstate();
+#if LUA_VERSION_NUM >= 505
+    state_ = lua_newstate(&LuaArena::alloc, &arena_, luaL_makeseed(nullptr));
+#else
+    state_ = lua_newstate(&LuaArena::alloc, &arena_);
+#endif
     if (!state_) {
-        lastError_ = "luaL_newstate failed";
+        lastError_ = "lua_newstate failed (script memory budget too small?)";
         return Result<void>::error(lastError_);
     }
 
@@ -460,6 +539,7 @@ Result<void> EmbeddedLuaScriptEngine::initialize(VariableStore* variables) {
     bindBuiltins();
     bindHardwareTables();
     syncVariablesToLua();
+    setGcMode(gcMode_);
     clearError();
     return Result<void>::ok();
 }
@@ -502,8 +582,10 @@ Result<Value> EmbeddedLuaScriptEngine::execute(const CodeBlock& code) {
     }
 
     syncVariablesToLua();
-    lua_gc(state_, LUA_GCCOLLECT, 0);
-    if (luaL_loadstring(state_, code.source.c_str()) != 0) {
+    if (gcMode_ == GcMode::Full) {
+        lua_gc(state_, LUA_GCCOLLECT, 0);
+    }
+    if (loadCode(state_, code, CodeKind::Statement) != 0) {
         lastError_ = lua_tostring(state_, -1);
         lua_pop(state_, 1);
         return Result<Value>::error(lastError_);
@@ -533,14 +615,10 @@ Result<bool> EmbeddedLuaScriptEngine::evaluateCondition(const CodeBlock& code) {
     }
 
     syncVariablesToLua();
-    std::string expr = "return (" + code.source + ")";
-    if (luaL_loadstring(state_, expr.c_str()) != 0) {
+    if (loadCode(state_, code, code.resolvedKind(CodeKind::Expression)) != 0) {
+        lastError_ = lua_tostring(state_, -1);
         lua_pop(state_, 1);
-        if (luaL_loadstring(state_, code.source.c_str()) != 0) {
-            lastError_ = lua_tostring(state_, -1);
-            lua_pop(state_, 1);
-            return Result<bool>::error(lastError_);
-        }
+        return Result<bool>::error(lastError_);
     }
     if (lua_pcall(state_, 0, LUA_MULTRET, 0) != 0) {
         lastError_ = lua_tostring(state_, -1);
@@ -575,8 +653,7 @@ Result<double> EmbeddedLuaScriptEngine::evaluateWeight(const CodeBlock& code) {
     }
 
     syncVariablesToLua();
-    std::string expr = "return (" + code.source + ")";
-    if (luaL_loadstring(state_, expr.c_str()) != 0) {
+    if (loadCode(state_, code, CodeKind::Expression) != 0) {
         lastError_ = lua_tostring(state_, -1);
         lua_pop(state_, 1);
         return Result<double>::error(lastError_);
@@ -606,6 +683,23 @@ void EmbeddedLuaScriptEngine::collectGarbage() {
     }
 }
 
+void EmbeddedLuaScriptEngine::setGcMode(GcMode mode) {
+    gcMode_ = mode;
+#if defined(LUA_GCGEN)
+    if (state_) {
+        if (mode == GcMode::Generational) {
+            lua_gc(state_, LUA_GCGEN, 0, 0);
+        } else {
+            lua_gc(state_, LUA_GCINC, 0, 0, 0);
+        }
+    }
+#endif
+}
+
+bool EmbeddedLuaScriptEngine::stepGarbage(uint32_t stepKb) {
+    return !state_ || lua_gc(state_, LUA_GCSTEP, static_cast<int>(stepKb)) != 0;
+}
+
 void EmbeddedLuaScriptEngine::setLogHandler(std::function<void(const std::string& level,
                                                                const std::string& message)> handler) {
     logHandler_ = std::move(handler);
@@ -695,6 +789,8 @@ void EmbeddedLuaScriptEngine::bindHardwareTables() {
     lua_setfield(state_, -2, "open");
     lua_pushcfunction(state_, luaI2cScan);
     lua_setfield(state_, -2, "scan");
+    lua_pushcfunction(state_, luaI2cWrite);
+    lua_setfield(state_, -2, "write");
     lua_setglobal(state_, "i2c");
 }
 
@@ -1,6 +1,7 @@
 #ifndef AETHERIUM_EMBEDDED_ARDUINO_LUA_ENGINE_HPP
 #define AETHERIUM_EMBEDDED_ARDUINO_LUA_ENGINE_HPP
 
+#include "engine/core/lua_arena.hpp"
 #include "engine/core/runtime.hpp"
 
 struct lua_State;
@@ -19,6 +20,12 @@ public:
     std::string lastError() const override;
     void clearError() override;
     void collectGarbage() override;
+    void setGcMode(GcMode mode) override;
+    bool stepGarbage(uint32_t stepKb) override;
+    [[nodiscard]] size_t memoryInUse() const override { return arena_.stats().inUse; }
+    [[nodiscard]] uint64_t allocatedBytes() const override { return arena_.stats().allocated; }
+    void setMemoryBudget(size_t bytes) override { arena_.setBudget(bytes); }
+    [[nodiscard]] ScriptMemoryStats memoryStats() const override { return arena_.stats(); }
     void setLogHandler(std::function<void(const std::string& level,
                                           const std::string& message)> handler) override;
 
@@ -32,10 +39,12 @@ private:
     void syncVariablesToLua();
     void syncVariablesFromLua();
 
+    LuaArena arena_;  // Size-class pools instead of scattered heap blocks; outlives state_
     lua_State* state_ = nullptr;
     VariableStore* variables_ = nullptr;
     std::string lastError_;
     std::function<void(const std::string&, const std::string&)> logHandler_;
+    GcMode gcMode_ = GcPolicy{}.mode;
 };
 
 } // namespace aeth::embedded::arduino
@@ -7,6 +7,7 @@
 #include <memory>
 #include <cctype>
 #include <algorithm>
+#include <array>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -28,61 +29,25 @@
 
 namespace aeth::embedded::arduino {
 
-class GenericComponent final : public IComponent {
-public:
-    using Handler = std::function<Result<Value>(const std::vector<Value>& args)>;
-
-    GenericComponent(std::string componentName,
-                     std::vector<std::pair<std::string, Handler>> handlers)
-        : name_(std::move(componentName)) {
-        for (auto& entry : handlers) {
-            methods_.push_back(entry.first);
-            handlers_.emplace(std::move(entry.first), std::move(entry.second));
-        }
-    }
-
-    const std::string& name() const override { return name_; }
-    std::vector<std::string> methods() const override { return methods_; }
-
-    Result<Value> invoke(const std::string& method, const std::vector<Value>& args) override {
-        auto it = handlers_.find(method);
-        if (it == handlers_.end()) {
-            return Result<Value>::error("unknown component method: " + method);
-        }
-        return it->second(args);
-    }
-
-private:
-    std::string name_;
-    std::vector<std::string> methods_;
-    std::unordered_map<std::string, Handler> handlers_;
-};
+#ifndef AETHERIUM_ESP32_MAX_COMPONENTS
+#define AETHERIUM_ESP32_MAX_COMPONENTS 8  // Table-driven components: built-ins plus generated bindings
+#endif
 
 class Esp32HardwareService;
 
-class Ssd1306TextComponent final : public IComponent {
+class Ssd1306TextComponent final {
 public:
     explicit Ssd1306TextComponent(Esp32HardwareService& hardware)
         : hardware_(hardware) {}
 
-    const std::string& name() const override {
-        static const std::string kName = "ssd1306_text";
-        return kName;
-    }
-
-    std::vector<std::string> methods() const override {
-        return {"init", "clear", "line", "show", "set_text_size", "invert"};
-    }
-
-    Result<Value> invoke(const std::string& method, const std::vector<Value>& args) override;
-
-private:
-    Result<Value> init(const std::vector<Value>& args);
+    Result<Value> init(ValueSpan args);
     Result<Value> clear();
-    Result<Value> line(const std::vector<Value>& args);
+    Result<Value> line(ValueSpan args);
     Result<Value> show();
-    Result<Value> setTextSize(const std::vector<Value>& args);
-    Result<Value> invert(const std::vector<Value>& args);
+    Result<Value> setTextSize(ValueSpan args);
+    Result<Value> invert(ValueSpan args);
+
+private:
     Result<void> redraw();
     Result<void> ensureReady() const;
     int visibleLineCount() const;
@@ -101,52 +66,48 @@ private:
 #endif
 };
 
+inline constexpr ComponentMethodDescriptor kSsd1306TextMethods[] = {
+    {"init", "|iiiiiii", &invokeComponentMethod<&Ssd1306TextComponent::init, Ssd1306TextComponent>},
+    {"clear", "", &invokeComponentMethod<&Ssd1306TextComponent::clear, Ssd1306TextComponent>},
+    {"line", "iv", &invokeComponentMethod<&Ssd1306TextComponent::line, Ssd1306TextComponent>},
+    {"show", "", &invokeComponentMethod<&Ssd1306TextComponent::show, Ssd1306TextComponent>},
+    {"set_text_size", "i", &invokeComponentMethod<&Ssd1306TextComponent::setTextSize, Ssd1306TextComponent>},
+    {"invert", "|b", &invokeComponentMethod<&Ssd1306TextComponent::invert, Ssd1306TextComponent>},
+};
+inline constexpr ComponentDescriptor kSsd1306TextComponent = {"ssd1306_text", kSsd1306TextMethods, 6};
+
+inline constexpr ComponentMethodDescriptor kBoardLedMethods[] = {
+    {"set", "|b", [](void*, ValueSpan args) -> Result<Value> {
+        const bool on = !args.empty() && args.front().toBool();
+        board_led::set(on);
+        return Result<Value>::ok(Value(on));
+    }},
+    {"on", "", [](void*, ValueSpan) -> Result<Value> {
+        board_led::set(true);
+        return Result<Value>::ok(Value(true));
+    }},
+    {"off", "", [](void*, ValueSpan) -> Result<Value> {
+        board_led::set(false);
+        return Result<Value>::ok(Value(false));
+    }},
+    {"clear", "", [](void*, ValueSpan) -> Result<Value> {
+        board_led::clear();
+        return Result<Value>::ok(Value(true));
+    }},
+    {"status", "", [](void*, ValueSpan) -> Result<Value> {
+        return Result<Value>::ok(Value(board_led::active() && board_led::value()));
+    }},
+};
+inline constexpr ComponentDescriptor kBoardLedComponent = {"board_led", kBoardLedMethods, 5};
+
+/**
+ * Built-in components (board_led, i2c_scanner, ssd1306_text) and generated
+ * bindings are constant method tables bound to their instance, so the
+ * constructor allocates nothing.
+ */
 class Esp32HardwareService final : public IHardwareService {
 public:
-    Esp32HardwareService() {
-        registerComponent(std::make_unique<GenericComponent>(
-            "board_led",
-            std::vector<std::pair<std::string, GenericComponent::Handler>>{
-                {"set", [](const std::vector<Value>& args) -> Result<Value> {
-                    const bool on = !args.empty() && args.front().toBool();
-                    board_led::set(on);
-                    return Result<Value>::ok(Value(on));
-                }},
-                {"on", [](const std::vector<Value>&) -> Result<Value> {
-                    board_led::set(true);
-                    return Result<Value>::ok(Value(true));
-                }},
-                {"off", [](const std::vector<Value>&) -> Result<Value> {
-                    board_led::set(false);
-                    return Result<Value>::ok(Value(false));
-                }},
-                {"clear", [](const std::vector<Value>&) -> Result<Value> {
-                    board_led::clear();
-                    return Result<Value>::ok(Value(true));
-                }},
-                {"status", [](const std::vector<Value>&) -> Result<Value> {
-                    return Result<Value>::ok(Value(board_led::active() && board_led::value()));
-                }}
-            }));
-        registerComponent(std::make_unique<GenericComponent>(
-            "i2c_scanner",
-            std::vector<std::pair<std::string, GenericComponent::Handler>>{
-                {"scan", [this](const std::vector<Value>& args) -> Result<Value> {
-                    const int bus = args.empty() ? 0 : static_cast<int>(args.front().toInt());
-                    auto result = i2cScan(bus);
-                    if (result.isError()) {
-                        return Result<Value>::error(result.error());
-                    }
-                    std::string joined;
-                    for (size_t i = 0; i < result.value().size(); ++i) {
-                        if (i > 0) joined += ",";
-                        joined += std::to_string(result.value()[i]);
-                    }
-                    return Result<Value>::ok(Value(joined));
-                }}
-            }));
-        registerComponent(std::make_unique<Ssd1306TextComponent>(*this));
-    }
+    Esp32HardwareService();
 
     Result<void> gpioMode(int pin, const std::string& mode) override {
 #ifdef ARDUINO
@@ -283,23 +244,85 @@ public:
 #endif
     }
 
+    Result<void> i2cWrite(int bus, int address, const std::vector<uint8_t>& data) override {
+#ifdef ARDUINO
+        auto busIt = buses_.find(bus);
+        if (busIt == buses_.end() || !busIt->second.opened) {
+            auto beginResult = i2cOpen(bus, defaultSdaFor(bus), defaultSclFor(bus), 400000);
+            if (beginResult.isError()) {
+                return beginResult;
+            }
+        }
+        auto& wire = wireFor(bus);
+        wire.beginTransmission(static_cast<uint8_t>(address));
+        wire.write(data.data(), data.size());
+        if (wire.endTransmission() != 0) {
+            return Result<void>::error("i2c write not acknowledged");
+        }
+        return Result<void>::ok();
+#else
+        (void) bus;
+        (void) address;
+        (void) data;
+        return Result<void>::error("i2c unavailable outside Arduino");
+#endif
+    }
+
     std::vector<std::string> componentNames() const override {
         std::vector<std::string> names;
-        names.reserve(components_.size());
-        for (const auto& entry : components_) {
-            names.push_back(entry.first);
+        names.reserve(tableCount_ + owned_.size());
+        for (size_t i = 0; i < tableCount_; ++i) {
+            names.emplace_back(tables_[i].descriptor()->name);
+        }
+        for (const auto& owned : owned_) {
+            names.push_back(owned->name());
         }
         return names;
     }
 
     IComponent* component(const std::string& name) override {
-        auto it = components_.find(name);
-        return it == components_.end() ? nullptr : it->second.get();
+        for (const auto& owned : owned_) {
+            if (owned->name() == name) {
+                return owned.get();
+            }
+        }
+        for (size_t i = 0; i < tableCount_; ++i) {
+            if (tables_[i].named(name)) {
+                return &tables_[i];
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * A component given by its method table (generated bindings); `self` is
+     * what the methods run on and must outlive the service. Replaces a
+     * component of the same name. False once all
+     * AETHERIUM_ESP32_MAX_COMPONENTS slots are taken.
+     */
+    bool registerComponent(const ComponentDescriptor& descriptor, void* self) {
+        size_t slot = 0;
+        while (slot < tableCount_ && !tables_[slot].named(descriptor.name)) {
+            ++slot;
+        }
+        if (slot == tables_.size()) {
+            return false;
+        }
+        tables_[slot] = StaticComponent(descriptor, self);
+        tableCount_ = std::max(tableCount_, slot + 1);
+        return true;
     }
 
+    // A component with its own IComponent implementation; found before table components
     void registerComponent(std::unique_ptr<IComponent> component) {
         if (!component) return;
-        components_[component->name()] = std::move(component);
+        for (auto& owned : owned_) {
+            if (owned->name() == component->name()) {
+                owned = std::move(component);
+                return;
+            }
+        }
+        owned_.push_back(std::move(component));
     }
 
 #ifdef ARDUINO
@@ -346,20 +369,36 @@ private:
     }
 
     std::unordered_map<int, BusConfig> buses_;
-    std::unordered_map<std::string, std::unique_ptr<IComponent>> components_;
+    Ssd1306TextComponent display_{*this};
+    std::array<StaticComponent, AETHERIUM_ESP32_MAX_COMPONENTS> tables_{};
+    size_t tableCount_ = 0;
+    std::vector<std::unique_ptr<IComponent>> owned_;
+};
+
+inline constexpr ComponentMethodDescriptor kI2cScannerMethods[] = {
+    {"scan", "|i", [](void* self, ValueSpan args) -> Result<Value> {
+        const int bus = args.empty() ? 0 : static_cast<int>(args.front().toInt());
+        auto result = static_cast<Esp32HardwareService*>(self)->i2cScan(bus);
+        if (result.isError()) {
+            return Result<Value>::error(result.error());
+        }
+        std::string joined;
+        for (size_t i = 0; i < result.value().size(); ++i) {
+            if (i > 0) joined += ",";
+            joined += std::to_string(result.value()[i]);
+        }
+        return Result<Value>::ok(Value(joined));
+    }},
 };
+inline constexpr ComponentDescriptor kI2cScannerComponent = {"i2c_scanner", kI2cScannerMethods, 1};
 
-inline Result<Value> Ssd1306TextComponent::invoke(const std::string& method, const std::vector<Value>& args) {
-    if (method == "init") return init(args);
-    if (method == "clear") return clear();
-    if (method == "line") return line(args);
-    if (method == "show") return show();
-    if (method == "set_text_size") return setTextSize(args);
-    if (method == "invert") return invert(args);
-    return Result<Value>::error("unknown component method: " + method);
+inline Esp32HardwareService::Esp32HardwareService() {
+    registerComponent(kBoardLedComponent, nullptr);
+    registerComponent(kI2cScannerComponent, this);
+    registerComponent(kSsd1306TextComponent, &display_);
 }
 
-inline Result<Value> Ssd1306TextComponent::init(const std::vector<Value>& args) {
+inline Result<Value> Ssd1306TextComponent::init(ValueSpan args) {
     width_ = args.size() > 0 ? static_cast<int>(args[0].toInt()) : 128;
     height_ = args.size() > 1 ? static_cast<int>(args[1].toInt()) : 64;
     address_ = args.size() > 2 ? static_cast<int>(args[2].toInt()) : 0x3C;
@@ -412,7 +451,7 @@ inline Result<Value> Ssd1306TextComponent::clear() {
     return Result<Value>::ok(Value(true));
 }
 
-inline Result<Value> Ssd1306TextComponent::line(const std::vector<Value>& args) {
+inline Result<Value> Ssd1306TextComponent::line(ValueSpan args) {
     if (auto ready = ensureReady(); ready.isError()) {
         return Result<Value>::error(ready.error());
     }
@@ -450,7 +489,7 @@ inline Result<Value> Ssd1306TextComponent::show() {
     return Result<Value>::ok(Value(true));
 }
 
-inline Result<Value> Ssd1306TextComponent::setTextSize(const std::vector<Value>& args) {
+inline Result<Value> Ssd1306TextComponent::setTextSize(ValueSpan args) {
     if (args.empty()) {
         return Result<Value>::error("ssd1306_text.set_text_size expects a size");
     }
@@ -468,7 +507,7 @@ inline Result<Value> Ssd1306TextComponent::setTextSize(const std::vector<Value>&
     return Result<Value>::ok(Value(static_cast<int32_t>(textSize_)));
 }
 
-inline Result<Value> Ssd1306TextComponent::invert(const std::vector<Value>& args) {
+inline Result<Value> Ssd1306TextComponent::invert(ValueSpan args) {
     if (auto ready = ensureReady(); ready.isError()) {
         return Result<Value>::error(ready.error());
     }
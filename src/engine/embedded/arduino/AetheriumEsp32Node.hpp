@@ -12,15 +12,21 @@ using Esp32NodeOptions = AvrNodeOptions;
 class AetheriumEsp32Node : public AetheriumAvrNode {
 public:
     explicit AetheriumEsp32Node(const Esp32NodeOptions& options = {})
-        : AetheriumAvrNode(options) {
-        setHardwareService(&hardware_);
+        : AetheriumAvrNode(options), actuation_(hardware_) {
+        if (options.batchActuation) {
+            setHardwareService(&actuation_);
+        } else {
+            setHardwareService(&hardware_);
+        }
     }
 
     Esp32HardwareService& hardware() { return hardware_; }
     const Esp32HardwareService& hardware() const { return hardware_; }
+    BufferedHardwareService& actuation() { return actuation_; }
 
 private:
     Esp32HardwareService hardware_;
+    BufferedHardwareService actuation_;
 };
 
 } // namespace aeth::embedded::arduino
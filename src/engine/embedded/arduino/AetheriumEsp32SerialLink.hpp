@@ -4,6 +4,14 @@
 #include "AetheriumAvrSerialLink.hpp"
 #include "AetheriumEsp32Node.hpp"
 
+#ifndef AETHERIUM_ESP32_UART_RX_BUFFER_BYTES
+#define AETHERIUM_ESP32_UART_RX_BUFFER_BYTES 2048
+#endif
+
+#ifndef AETHERIUM_ESP32_UART_TX_BUFFER_BYTES
+#define AETHERIUM_ESP32_UART_TX_BUFFER_BYTES 2048
+#endif
+
 namespace aeth::embedded::arduino {
 
 class AetheriumEsp32SerialLink {
@@ -20,6 +28,20 @@ public:
     void attach(Stream& stream) { link_.attach(stream); }
 #endif
 
+#if defined(ARDUINO) && defined(ARDUINO_ARCH_ESP32)
+    /**
+     * Start `serial` with driver buffers sized for the link, then receive
+     * from the driver's event task instead of polling. TX goes through the
+     * driver's interrupt-fed ring, so writes block only once it is full.
+     */
+    void beginUart(HardwareSerial& serial, unsigned long baud) {
+        serial.setRxBufferSize(AETHERIUM_ESP32_UART_RX_BUFFER_BYTES);
+        serial.setTxBufferSize(AETHERIUM_ESP32_UART_TX_BUFFER_BYTES);
+        serial.begin(baud);
+        link_.attachUart(serial);
+    }
+#endif
+
     bool sendHello(const std::string& deviceNameOverride = {}) {
         SerialHelloOptions opts;
         opts.deviceType = protocol::DeviceType::ESP32;
@@ -0,0 +1,46 @@
+#ifndef AETHERIUM_EMBEDDED_ARDUINO_FLASH_NODE_HPP
+#define AETHERIUM_EMBEDDED_ARDUINO_FLASH_NODE_HPP
+
+#include "engine/core/flash_automata.hpp"
+#include "engine/embedded/platform/EmbeddedPlatformHooks.hpp"
+
+#include <cstdint>
+
+namespace aeth::embedded::arduino {
+
+/**
+ * Node running one automaton linked into the firmware as flash tables
+ * (engine `--emit-flash-tables`). There is no Engine, loader or Lua: RAM
+ * holds the variables and the current state only, and nothing is parsed
+ * at boot.
+ */
+class AetheriumFlashNode {
+public:
+    explicit AetheriumFlashNode(const FlashAutomata* tables, uint32_t tickPeriodMs = 10)
+        : runtime_(tables), tickPeriodMs_(tickPeriodMs) {}
+
+    Result<void> begin() {
+        lastTickMs_ = platform::millis();
+        return runtime_.start(lastTickMs_);
+    }
+
+    void loop() {
+        const Timestamp wall = platform::millis();
+        if (runtime_.isRunning() && wall - lastTickMs_ >= tickPeriodMs_) {
+            runtime_.tick(wall);
+            lastTickMs_ = wall;
+        }
+    }
+
+    FlashRuntime& runtime() { return runtime_; }
+    const FlashRuntime& runtime() const { return runtime_; }
+
+private:
+    FlashRuntime runtime_;
+    uint32_t tickPeriodMs_;
+    Timestamp lastTickMs_ = 0;
+};
+
+} // namespace aeth::embedded::arduino
+
+#endif // AETHERIUM_EMBEDDED_ARDUINO_FLASH_NODE_HPP
@@ -7,6 +7,7 @@
 
 #include "../../core/artifact.cpp"
 #include "../../core/runtime.cpp"
+#include "../../core/checkpoint.cpp"
 #include "../../core/protocol.cpp"
 #include "../../core/protocol_v2.cpp"
 #include "../../core/execution_trace.cpp"
@@ -23,32 +23,13 @@ extern "C" {
 
 #include <algorithm>
 #include <array>
-#include <memory>
 #include <string>
-#include <unordered_map>
 #include <utility>
 
 namespace aeth::embedded::mcxn947 {
 
-class BoardTempComponent final : public IComponent {
+class BoardTempComponent final {
 public:
-    const std::string& name() const override {
-        static const std::string kName = "board_temp";
-        return kName;
-    }
-
-    std::vector<std::string> methods() const override {
-        return {"init", "read_c", "read_milli_c"};
-    }
-
-    Result<Value> invoke(const std::string& method, const std::vector<Value>&) override {
-        if (method == "init") return init();
-        if (method == "read_c") return readC();
-        if (method == "read_milli_c") return readMilliC();
-        return Result<Value>::error("unknown component method: " + method);
-    }
-
-private:
     Result<Value> init() {
         auto ready = ensureReady();
         return ready.isError() ? Result<Value>::error(ready.error()) : Result<Value>::ok(Value(true));
@@ -73,6 +54,7 @@ private:
         return Result<Value>::ok(Value(milliC));
     }
 
+private:
     Result<double> readTemperatureC() {
         if (ready_) {
             (void) HAL_AdcSensorDeinit(sensorHandle_);
@@ -153,34 +135,9 @@ private:
 #endif
 };
 
-class TouchPadComponent final : public IComponent {
+class TouchPadComponent final {
 public:
-    const std::string& name() const override {
-        static const std::string kName = "touch_pad";
-        return kName;
-    }
-
-    std::vector<std::string> methods() const override {
-        return {"init", "raw", "baseline", "delta", "pressed", "threshold", "set_threshold"};
-    }
-
-    Result<Value> invoke(const std::string& method, const std::vector<Value>& args) override {
-        if (method == "init") return init(args);
-        if (method == "raw") return raw();
-        if (method == "baseline") return baseline();
-        if (method == "delta") return delta();
-        if (method == "pressed") return pressed(args);
-        if (method == "threshold") return threshold();
-        if (method == "set_threshold") return setThreshold(args);
-        return Result<Value>::error("unknown component method: " + method);
-    }
-
-private:
-    static constexpr uint8_t kTouchPort = 1U;
-    static constexpr uint8_t kTouchPin = 3U;
-    static constexpr uint8_t kTouchChannel = BOARD_TSI_ELECTRODE_1;
-
-    Result<Value> init(const std::vector<Value>& args) {
+    Result<Value> init(ValueSpan args) {
         auto ready = ensureReady();
         if (ready.isError()) {
             return Result<Value>::error(ready.error());
@@ -233,7 +190,7 @@ private:
         return Result<Value>::ok(Value(deltaValue));
     }
 
-    Result<Value> pressed(const std::vector<Value>& args) {
+    Result<Value> pressed(ValueSpan args) {
         auto measurement = measureRaw();
         if (measurement.isError()) {
             return Result<Value>::error(measurement.error());
@@ -258,7 +215,7 @@ private:
         return Result<Value>::ok(Value(static_cast<int64_t>(threshold_)));
     }
 
-    Result<Value> setThreshold(const std::vector<Value>& args) {
+    Result<Value> setThreshold(ValueSpan args) {
         if (args.empty()) {
             return Result<Value>::error("touch_pad.set_threshold expects a threshold");
         }
@@ -270,6 +227,11 @@ private:
         return Result<Value>::ok(Value(static_cast<int64_t>(threshold_)));
     }
 
+private:
+    static constexpr uint8_t kTouchPort = 1U;
+    static constexpr uint8_t kTouchPin = 3U;
+    static constexpr uint8_t kTouchChannel = BOARD_TSI_ELECTRODE_1;
+
     Result<void> ensureReady() {
 #if defined(AETHERIUM_PLATFORM_MCXN947)
         if (hardwareReady_) {
@@ -348,12 +310,30 @@ private:
     int threshold_ = 120;
 };
 
+inline constexpr ComponentMethodDescriptor kBoardTempMethods[] = {
+    {"init", "", &invokeComponentMethod<&BoardTempComponent::init, BoardTempComponent>},
+    {"read_c", "", &invokeComponentMethod<&BoardTempComponent::readC, BoardTempComponent>},
+    {"read_milli_c", "", &invokeComponentMethod<&BoardTempComponent::readMilliC, BoardTempComponent>},
+};
+inline constexpr ComponentDescriptor kBoardTempComponent = {"board_temp", kBoardTempMethods, 3};
+
+inline constexpr ComponentMethodDescriptor kTouchPadMethods[] = {
+    {"init", "|i", &invokeComponentMethod<&TouchPadComponent::init, TouchPadComponent>},
+    {"raw", "", &invokeComponentMethod<&TouchPadComponent::raw, TouchPadComponent>},
+    {"baseline", "", &invokeComponentMethod<&TouchPadComponent::baseline, TouchPadComponent>},
+    {"delta", "", &invokeComponentMethod<&TouchPadComponent::delta, TouchPadComponent>},
+    {"pressed", "|i", &invokeComponentMethod<&TouchPadComponent::pressed, TouchPadComponent>},
+    {"threshold", "", &invokeComponentMethod<&TouchPadComponent::threshold, TouchPadComponent>},
+    {"set_threshold", "i", &invokeComponentMethod<&TouchPadComponent::setThreshold, TouchPadComponent>},
+};
+inline constexpr ComponentDescriptor kTouchPadComponent = {"touch_pad", kTouchPadMethods, 7};
+
+// Components are constant method tables bound to members: nothing allocated at boot
 class Mcxn947HardwareService final : public IHardwareService {
 public:
-    Mcxn947HardwareService() {
-        registerComponent(std::make_unique<BoardTempComponent>());
-        registerComponent(std::make_unique<TouchPadComponent>());
-    }
+    Mcxn947HardwareService()
+        : components_{StaticComponent(kBoardTempComponent, &boardTemp_),
+                      StaticComponent(kTouchPadComponent, &touchPad_)} {}
 
     Result<void> gpioMode(int pin, const std::string& mode) override {
         int portIndex = 0;
@@ -456,21 +436,21 @@ public:
         std::vector<std::string> names;
         names.reserve(components_.size());
         for (const auto& entry : components_) {
-            names.push_back(entry.first);
+            names.emplace_back(entry.descriptor()->name);
         }
         return names;
     }
 
     IComponent* component(const std::string& name) override {
-        auto it = components_.find(name);
-        return it == components_.end() ? nullptr : it->second.get();
+        for (auto& entry : components_) {
+            if (entry.named(name)) {
+                return &entry;
+            }
+        }
+        return nullptr;
     }
 
 private:
-    void registerComponent(std::unique_ptr<IComponent> component) {
-        if (!component) return;
-        components_[component->name()] = std::move(component);
-    }
 
     static std::string normalize(const std::string& mode) {
         std::string lowered = mode;
@@ -486,7 +466,9 @@ private:
         return pin == 10 || pin == 27 || pin == 34;
     }
 
-    std::unordered_map<std::string, std::unique_ptr<IComponent>> components_;
+    BoardTempComponent boardTemp_;
+    TouchPadComponent touchPad_;
+    std::array<StaticComponent, 2> components_;
 };
 
 } // namespace aeth::embedded::mcxn947
@@ -3,6 +3,7 @@
 
 #include "AetheriumMcxn947Hardware.hpp"
 #include "engine/embedded/arduino/AetheriumAvrNode.hpp"
+#include "engine/embedded/arduino/AetheriumFlashNode.hpp"
 
 namespace aeth::embedded::mcxn947 {
 
@@ -11,7 +12,28 @@ using Mcxn947NodeOptions = aeth::embedded::arduino::AvrNodeOptions;
 class AetheriumMcxn947Node : public aeth::embedded::arduino::AetheriumAvrNode {
 public:
     explicit AetheriumMcxn947Node(const Mcxn947NodeOptions& options = {})
-        : aeth::embedded::arduino::AetheriumAvrNode(options) {
+        : aeth::embedded::arduino::AetheriumAvrNode(options), actuation_(hardware_) {
+        if (options.batchActuation) {
+            setHardwareService(&actuation_);
+        } else {
+            setHardwareService(&hardware_);
+        }
+    }
+
+    Mcxn947HardwareService& hardware() { return hardware_; }
+    const Mcxn947HardwareService& hardware() const { return hardware_; }
+    BufferedHardwareService& actuation() { return actuation_; }
+
+private:
+    Mcxn947HardwareService hardware_;
+    BufferedHardwareService actuation_;
+};
+
+// Flash-table node (AetheriumFlashNode) with the board's hardware service
+class AetheriumMcxn947FlashNode : public aeth::embedded::arduino::AetheriumFlashNode {
+public:
+    explicit AetheriumMcxn947FlashNode(const FlashAutomata* tables, uint32_t tickPeriodMs = 10)
+        : aeth::embedded::arduino::AetheriumFlashNode(tables, tickPeriodMs) {
         setHardwareService(&hardware_);
     }
 
@@ -18,7 +18,6 @@ constexpr uint32_t kFlexcomm4Index = 4;
 constexpr uint32_t kDebugUartClockHz = 12'000'000U;
 constexpr int kStatusLedPort = 1;
 constexpr int kStatusLedPin = 2;
-constexpr size_t kUartRxBufferSize = 2048;
 
 #ifndef AETHERIUM_MCXN947_STATUS_LED_ENABLED
 #define AETHERIUM_MCXN947_STATUS_LED_ENABLED 0
@@ -27,27 +26,42 @@ constexpr size_t kUartRxBufferSize = 2048;
 volatile Timestamp g_ticksMs = 0;
 bool g_initialized = false;
 bool g_clockConfigured = false;
-volatile uint8_t g_uartRxBuffer[kUartRxBufferSize]{};
-volatile size_t g_uartRxHead = 0;
-volatile size_t g_uartRxTail = 0;
+UartRxRing g_uartRx;
+platform::SerialRing<AETHERIUM_MCXN947_UART_TX_RING_BYTES> g_uartTx;
 
 #if defined(AETHERIUM_PLATFORM_MCXN947)
 GPIO_Type* const kGpioPorts[] = GPIO_BASE_PTRS;
 PORT_Type* const kPortRegs[] = PORT_BASE_PTRS;
 
-size_t nextRxIndex(size_t index) {
-    return (index + 1U) % kUartRxBufferSize;
+void clearUartErrors() {
+    const uint32_t errorMask = static_cast<uint32_t>(
+        kLPUART_RxOverrunFlag | kLPUART_FramingErrorFlag | kLPUART_NoiseErrorFlag | kLPUART_ParityErrorFlag
+    );
+    const uint32_t status = LPUART_GetStatusFlags(LPUART4);
+    if ((status & errorMask) != 0U) {
+        (void)LPUART_ClearStatusFlags(LPUART4, status & errorMask);
+    }
 }
 
-void pushRxByte(uint8_t byte) {
-    const size_t nextHead = nextRxIndex(g_uartRxHead);
-    if (nextHead == g_uartRxTail) {
-        g_uartRxTail = nextRxIndex(g_uartRxTail);
+void receiveUartBytes() {
+    while ((LPUART_GetStatusFlags(LPUART4) & static_cast<uint32_t>(kLPUART_RxDataRegFullFlag)) != 0U) {
+        (void)g_uartRx.push(static_cast<uint8_t>(LPUART4->DATA & 0xFFU));
     }
+}
 
-    g_uartRxBuffer[g_uartRxHead] = byte;
-    g_uartRxHead = nextHead;
+#if AETHERIUM_MCXN947_UART_IRQ
+// Feed the transmitter from the TX ring; TIE stays on while bytes remain
+void transmitUartBytes() {
+    while ((LPUART4->STAT & LPUART_STAT_TDRE_MASK) != 0U) {
+        uint8_t byte = 0;
+        if (!g_uartTx.pop(byte)) {
+            LPUART_DisableInterrupts(LPUART4, static_cast<uint32_t>(kLPUART_TxDataRegEmptyInterruptEnable));
+            return;
+        }
+        LPUART4->DATA = static_cast<uint32_t>(byte);
+    }
 }
+#endif
 
 void enablePeripheralClocks() {
     SYSCON->AHBCLKCTRLSET[0] =
@@ -107,10 +121,12 @@ void configureDebugUart(uint32_t baudRate) {
     config.enableTx = true;
     config.enableRx = true;
     (void)LPUART_Init(LPUART4, &config, kDebugUartClockHz);
+#if AETHERIUM_MCXN947_UART_IRQ
     LPUART_EnableInterrupts(LPUART4, static_cast<uint32_t>(kLPUART_RxDataRegFullInterruptEnable));
     NVIC_ClearPendingIRQ(BOARD_UART_IRQ);
     NVIC_SetPriority(BOARD_UART_IRQ, 3U);
     EnableIRQ(BOARD_UART_IRQ);
+#endif
 }
 
 void configureStatusLed() {
@@ -131,23 +147,18 @@ extern "C" void SysTick_Handler(void) {
     ++g_ticksMs;
 }
 
+#if AETHERIUM_MCXN947_UART_IRQ
 extern "C" void LP_FLEXCOMM4_IRQHandler(void) {
-    const uint32_t status = LPUART_GetStatusFlags(LPUART4);
-    const uint32_t errorMask = static_cast<uint32_t>(
-        kLPUART_RxOverrunFlag | kLPUART_FramingErrorFlag | kLPUART_NoiseErrorFlag | kLPUART_ParityErrorFlag
-    );
-
-    if ((status & errorMask) != 0U) {
-        (void)LPUART_ClearStatusFlags(LPUART4, status & errorMask);
-    }
-
-    while ((LPUART_GetStatusFlags(LPUART4) & static_cast<uint32_t>(kLPUART_RxDataRegFullFlag)) != 0U) {
-        pushRxByte(static_cast<uint8_t>(LPUART4->DATA & 0xFFU));
+    clearUartErrors();
+    receiveUartBytes();
+    if ((LPUART4->CTRL & LPUART_CTRL_TIE_MASK) != 0U) {
+        transmitUartBytes();
     }
 
     __DSB();
 }
 #endif
+#endif
 
 Result<void> initializePlatform(const UartConfig& uart) {
     if (g_initialized) {
@@ -159,8 +170,7 @@ Result<void> initializePlatform(const UartConfig& uart) {
     enablePeripheralClocks();
     releasePeripheralResets();
     BOARD_InitDEBUG_UARTPins();
-    g_uartRxHead = 0;
-    g_uartRxTail = 0;
+    g_uartRx.clear();
     configureDebugUart(uart.baudRate);
     configureStatusLed();
 
@@ -201,21 +211,35 @@ bool decodePin(int encodedPin, int& port, int& pin) {
 }
 
 bool uartReadByte(uint8_t& byte) {
-#if defined(AETHERIUM_PLATFORM_MCXN947)
-    if (g_uartRxHead == g_uartRxTail) {
-        return false;
-    }
-    byte = g_uartRxBuffer[g_uartRxTail];
-    g_uartRxTail = nextRxIndex(g_uartRxTail);
-    return true;
-#else
-    (void) byte;
-    return false;
+    uartPoll();
+    return g_uartRx.pop(byte);
+}
+
+UartRxRing& uartRxRing() { return g_uartRx; }
+
+void uartPoll() {
+#if defined(AETHERIUM_PLATFORM_MCXN947) && !AETHERIUM_MCXN947_UART_IRQ
+    clearUartErrors();
+    receiveUartBytes();
 #endif
 }
 
 void uartWrite(const uint8_t* data, size_t len) {
-#if defined(AETHERIUM_PLATFORM_MCXN947)
+#if defined(AETHERIUM_PLATFORM_MCXN947) && AETHERIUM_MCXN947_UART_IRQ
+    if (!data) {
+        return;
+    }
+    while (len > 0) {
+        const size_t queued = g_uartTx.write(data, len);
+        data += queued;
+        len -= queued;
+        // Enabling TIE on an idle transmitter raises the interrupt at once
+        LPUART_EnableInterrupts(LPUART4, static_cast<uint32_t>(kLPUART_TxDataRegEmptyInterruptEnable));
+        if (len > 0) {
+            yieldIfNeeded();  // Ring full: wait for the interrupt to drain it
+        }
+    }
+#elif defined(AETHERIUM_PLATFORM_MCXN947)
     if (!data) {
         return;
     }
@@ -230,6 +254,14 @@ void uartWrite(const uint8_t* data, size_t len) {
 #endif
 }
 
+size_t uartTxSpace() {
+#if defined(AETHERIUM_PLATFORM_MCXN947) && AETHERIUM_MCXN947_UART_IRQ
+    return g_uartTx.space();
+#else
+    return SIZE_MAX;
+#endif
+}
+
 void setStatusLed(bool on) {
 #if defined(AETHERIUM_PLATFORM_MCXN947) && AETHERIUM_MCXN947_STATUS_LED_ENABLED
     if (on) {
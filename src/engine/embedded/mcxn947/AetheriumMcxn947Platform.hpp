@@ -2,12 +2,34 @@
 #define AETHERIUM_EMBEDDED_MCXN947_PLATFORM_HPP
 
 #include "engine/core/types.hpp"
+#include "engine/embedded/platform/SerialRing.hpp"
 
 #include <cstddef>
 #include <cstdint>
 
+// 1: LPUART interrupts fill the RX ring and drain the TX ring.
+// 0: polled fallback, bytes move only from uartPoll() and uartWrite().
+#ifndef AETHERIUM_MCXN947_UART_IRQ
+#define AETHERIUM_MCXN947_UART_IRQ 1
+#endif
+
+#ifndef AETHERIUM_MCXN947_UART_RX_RING_BYTES
+#define AETHERIUM_MCXN947_UART_RX_RING_BYTES 8192
+#endif
+
+#ifndef AETHERIUM_MCXN947_UART_TX_RING_BYTES
+#define AETHERIUM_MCXN947_UART_TX_RING_BYTES 4096
+#endif
+
+// Largest outbound write; engine events are packed up to this size
+#ifndef AETHERIUM_MCXN947_UART_TX_BATCH_BYTES
+#define AETHERIUM_MCXN947_UART_TX_BATCH_BYTES 512
+#endif
+
 namespace aeth::embedded::mcxn947 {
 
+using UartRxRing = platform::SerialRing<AETHERIUM_MCXN947_UART_RX_RING_BYTES>;
+
 struct UartConfig {
     uint32_t baudRate = 115200;
 };
@@ -21,7 +43,19 @@ void yieldIfNeeded();
 
 bool decodePin(int encodedPin, int& port, int& pin);
 bool uartReadByte(uint8_t& byte);
+
+// Received bytes, in static storage; parse frames from it in place
+UartRxRing& uartRxRing();
+
+// Move bytes waiting in the LPUART into the RX ring (polled builds)
+void uartPoll();
+
+// Queues on the TX ring and returns; blocks only while the ring is full.
+// Polled builds write straight to the LPUART.
 void uartWrite(const uint8_t* data, size_t len);
+
+// Free TX ring bytes (SIZE_MAX in polled builds, where writes block)
+size_t uartTxSpace();
 void setStatusLed(bool on);
 
 } // namespace aeth::embedded::mcxn947
@@ -1,9 +1,5 @@
 #include "AetheriumMcxn947SerialLink.hpp"
 
-#include "AetheriumMcxn947Platform.hpp"
-
-#include <cstddef>
-
 namespace aeth::embedded::mcxn947 {
 
 namespace {
@@ -12,6 +8,9 @@ constexpr uint32_t kHelloRetryIntervalMs = 3'000;
 constexpr uint32_t kHelloRefreshIntervalMs = 15'000;
 constexpr uint32_t kKeepAliveIntervalMs = 10'000;
 constexpr uint32_t kEngineEventFlushIntervalMs = 20;
+constexpr uint32_t kEventBatchDeadlineMs = 20;
+// Below this much free TX ring, events stay queued in the engine
+constexpr size_t kTxCongestedBelowBytes = AETHERIUM_MCXN947_UART_TX_BATCH_BYTES;
 
 protocol::DeviceCapabilities defaultCapabilities() {
     return mcxn947Capabilities().toProtocol();
@@ -19,6 +18,10 @@ protocol::DeviceCapabilities defaultCapabilities() {
 
 } // namespace
 
+AetheriumMcxn947SerialLink::AetheriumMcxn947SerialLink(AetheriumMcxn947Node& node)
+    : node_(node)
+    , txBatch_(kEventBatchDeadlineMs) {}
+
 bool AetheriumMcxn947SerialLink::sendHello(const SerialHelloOptions& opts) {
     helloOptions_ = opts;
 
@@ -33,7 +36,7 @@ bool AetheriumMcxn947SerialLink::sendHello(const SerialHelloOptions& opts) {
     hello.name = helloOptions_.deviceNameOverride.empty() ? node_.engine().deviceName() : helloOptions_.deviceNameOverride;
     hello.capabilities = helloOptions_.capabilitiesOverride.value_or(defaultCapabilities());
 
-    writeFrame(hello.serialize());
+    writeFrame(hello, true);
     helloAcknowledged_ = false;
     lastKeepAliveSentMs_ = 0;
     lastHelloSentMs_ = static_cast<uint32_t>(millis());
@@ -46,37 +49,51 @@ void AetheriumMcxn947SerialLink::poll() {
     maybeFlushEngineEvents();
     maybeSendHelloRetry();
     maybeSendKeepAlive();
+    txBatch_.flushIfDue(static_cast<uint32_t>(millis()), uartWrite);
 }
 
 void AetheriumMcxn947SerialLink::drainSerial() {
-    uint8_t byte = 0;
-    while (uartReadByte(byte)) {
-        rxBuffer_.push_back(byte);
-        if (rxBuffer_.size() > protocol::MAX_MESSAGE_SIZE * 2) {
-            rxBuffer_.erase(rxBuffer_.begin(), rxBuffer_.begin() + static_cast<std::ptrdiff_t>(rxBuffer_.size() / 2));
-        }
-    }
+    uartPoll();  // No-op when the RX interrupt fills the ring
 }
 
-void AetheriumMcxn947SerialLink::writeFrame(const std::vector<uint8_t>& bytes) {
-    if (!bytes.empty()) {
-        uartWrite(bytes.data(), bytes.size());
+void AetheriumMcxn947SerialLink::writeFrame(const protocol::Message& msg, bool flushNow) {
+    txWriter_.clear();
+    msg.serializeInto(txWriter_);
+    txBatch_.append(txWriter_.data(), txWriter_.size(), static_cast<uint32_t>(millis()), uartWrite);
+    if (flushNow) {
+        flushTx();
     }
 }
 
+void AetheriumMcxn947SerialLink::flushTx() {
+    txBatch_.flush(uartWrite);
+}
+
 void AetheriumMcxn947SerialLink::maybeFlushEngineEvents() {
     if (!helloAcknowledged_) {
         return;
     }
 
+    // A full TX ring holds events back in the engine, which collapses and
+    // caps them, instead of blocking in uartWrite
+    Engine& engine = node_.engine();
+    const bool congested = uartTxSpace() < kTxCongestedBelowBytes;
+    engine.setEventBackpressure(congested);
+    if (congested) {
+        return;
+    }
+
+    // Pending events go into the batch right away; the batch deadline, not
+    // this interval, bounds their latency
     const uint32_t now = static_cast<uint32_t>(millis());
-    if (kEngineEventFlushIntervalMs > 0 &&
+    if (engine.pendingEventCount() == 0 &&
+        kEngineEventFlushIntervalMs > 0 &&
         lastEventFlushMs_ != 0 &&
         (now - lastEventFlushMs_) < kEngineEventFlushIntervalMs) {
         return;
     }
 
-    sendReplies(node_.engine().processCommandQueue());
+    sendReplies(engine.processCommandQueue(), false);
     lastEventFlushMs_ = now;
 }
 
@@ -110,38 +127,14 @@ void AetheriumMcxn947SerialLink::maybeSendKeepAlive() {
     ping.timestamp = now;
     ping.sequenceNumber = keepAliveSequence_++;
 
-    writeFrame(ping.serialize());
+    writeFrame(ping, true);
     lastKeepAliveSentMs_ = now;
 }
 
 void AetheriumMcxn947SerialLink::processRxBuffer() {
-    while (true) {
-        if (rxBuffer_.size() < protocol::HEADER_SIZE) {
-            return;
-        }
-
-        if (!(rxBuffer_[0] == static_cast<uint8_t>((protocol::MAGIC >> 8) & 0xFF) &&
-              rxBuffer_[1] == static_cast<uint8_t>(protocol::MAGIC & 0xFF))) {
-            rxBuffer_.erase(rxBuffer_.begin());
-            continue;
-        }
-
-        const uint16_t payloadLen =
-            (static_cast<uint16_t>(rxBuffer_[4]) << 8) |
-            static_cast<uint16_t>(rxBuffer_[5]);
-        const size_t totalLen = protocol::HEADER_SIZE + static_cast<size_t>(payloadLen);
-
-        if (totalLen > protocol::MAX_MESSAGE_SIZE) {
-            rxBuffer_.erase(rxBuffer_.begin());
-            continue;
-        }
-        if (rxBuffer_.size() < totalLen) {
-            return;
-        }
-
-        handleFrame(rxBuffer_.data(), totalLen);
-        rxBuffer_.erase(rxBuffer_.begin(), rxBuffer_.begin() + static_cast<std::ptrdiff_t>(totalLen));
-    }
+    platform::parseFrames(uartRxRing(), rxScratch_, [this](const uint8_t* data, size_t len) {
+        handleFrame(data, len);
+    });
 }
 
 void AetheriumMcxn947SerialLink::handleFrame(const uint8_t* data, size_t len) {
@@ -167,16 +160,19 @@ void AetheriumMcxn947SerialLink::handleFrame(const uint8_t* data, size_t len) {
     }
 
     node_.engine().enqueueCommand(std::move(msg));
-    sendReplies(node_.engine().processCommandQueue());
+    sendReplies(node_.engine().processCommandQueue(), true);
 }
 
-void AetheriumMcxn947SerialLink::sendReplies(Engine::Replies replies) {
+void AetheriumMcxn947SerialLink::sendReplies(Engine::Replies replies, bool flushNow) {
     for (auto& msg : replies) {
         if (!msg) {
             continue;
         }
         stampOutgoing(*msg);
-        writeFrame(msg->serialize());
+        writeFrame(*msg, false);
+    }
+    if (flushNow) {
+        flushTx();
     }
 }
 
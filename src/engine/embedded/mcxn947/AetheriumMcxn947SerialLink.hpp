@@ -2,15 +2,16 @@
 #define AETHERIUM_EMBEDDED_MCXN947_SERIAL_LINK_HPP
 
 #include "AetheriumMcxn947Node.hpp"
+#include "AetheriumMcxn947Platform.hpp"
 #include "engine/core/capabilities.hpp"
 #include "engine/core/protocol.hpp"
+#include "engine/embedded/platform/FrameBatcher.hpp"
 
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <string>
-#include <vector>
 
 namespace aeth::embedded::mcxn947 {
 
@@ -25,8 +26,7 @@ struct SerialHelloOptions {
 
 class AetheriumMcxn947SerialLink {
 public:
-    explicit AetheriumMcxn947SerialLink(AetheriumMcxn947Node& node)
-        : node_(node) {}
+    explicit AetheriumMcxn947SerialLink(AetheriumMcxn947Node& node);
 
     bool sendHello(const SerialHelloOptions& opts = {});
     void poll();
@@ -36,17 +36,21 @@ public:
 
 private:
     void drainSerial();
-    void writeFrame(const std::vector<uint8_t>& bytes);
+    // `flushNow` sends the pending batch too; events leave it to the deadline
+    void writeFrame(const protocol::Message& msg, bool flushNow);
+    void flushTx();
     void maybeFlushEngineEvents();
     void maybeSendHelloRetry();
     void maybeSendKeepAlive();
     void processRxBuffer();
     void handleFrame(const uint8_t* data, size_t len);
-    void sendReplies(Engine::Replies replies);
+    void sendReplies(Engine::Replies replies, bool flushNow);
     void stampOutgoing(protocol::Message& msg);
 
     AetheriumMcxn947Node& node_;
-    std::vector<uint8_t> rxBuffer_;
+    uint8_t rxScratch_[UartRxRing::CAPACITY]{};  // Frames that wrap the RX ring
+    protocol::ByteWriter txWriter_;               // Reused; stops growing at the largest frame
+    platform::FrameBatcher<AETHERIUM_MCXN947_UART_TX_BATCH_BYTES> txBatch_;
     std::atomic<uint32_t> nextMessageId_{1};
     std::atomic<uint32_t> assignedId_{0};
     SerialHelloOptions helloOptions_{};
@@ -0,0 +1,82 @@
+/**
+ * Aetherium Automata - Outbound Frame Batching
+ *
+ * Packs consecutive protocol frames into one link write of up to MTU
+ * bytes. Frames keep their own headers, so the receiver's stream parser
+ * is unchanged; what goes away is a driver call (and on USB a packet) per
+ * frame. A batch goes out when the next frame would not fit, when its
+ * oldest frame has waited the deadline, or on flush().
+ *
+ * Sinks are callables `sink(const uint8_t* data, size_t len)`.
+ */
+
+#ifndef AETHERIUM_EMBEDDED_PLATFORM_FRAME_BATCHER_HPP
+#define AETHERIUM_EMBEDDED_PLATFORM_FRAME_BATCHER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace aeth::embedded::platform {
+
+template <size_t MTU>
+class FrameBatcher {
+public:
+    static constexpr size_t CAPACITY = MTU;
+
+    explicit FrameBatcher(uint32_t deadlineMs = 0) : deadlineMs_(deadlineMs) {}
+
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+    [[nodiscard]] size_t size() const { return size_; }
+    [[nodiscard]] size_t pendingFrames() const { return frames_; }
+
+    // Frames larger than the MTU go straight to the sink, after the batch
+    template <typename Sink>
+    void append(const uint8_t* frame, size_t len, uint32_t nowMs, Sink&& sink) {
+        if (len == 0) {
+            return;
+        }
+        if (size_ + len > MTU) {
+            flush(sink);
+        }
+        if (len > MTU) {
+            sink(frame, len);
+            return;
+        }
+        if (size_ == 0) {
+            firstAtMs_ = nowMs;
+        }
+        std::memcpy(buffer_ + size_, frame, len);
+        size_ += len;
+        ++frames_;
+    }
+
+    template <typename Sink>
+    bool flushIfDue(uint32_t nowMs, Sink&& sink) {
+        if (size_ == 0 || (nowMs - firstAtMs_) < deadlineMs_) {
+            return false;
+        }
+        flush(sink);
+        return true;
+    }
+
+    template <typename Sink>
+    void flush(Sink&& sink) {
+        if (size_ > 0) {
+            sink(static_cast<const uint8_t*>(buffer_), size_);
+        }
+        size_ = 0;
+        frames_ = 0;
+    }
+
+private:
+    uint8_t buffer_[MTU]{};
+    size_t size_ = 0;
+    size_t frames_ = 0;
+    uint32_t firstAtMs_ = 0;
+    uint32_t deadlineMs_ = 0;
+};
+
+} // namespace aeth::embedded::platform
+
+#endif // AETHERIUM_EMBEDDED_PLATFORM_FRAME_BATCHER_HPP
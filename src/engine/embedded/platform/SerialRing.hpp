@@ -0,0 +1,171 @@
+/**
+ * Aetherium Automata - Serial Rings
+ *
+ * Fixed-capacity byte ring between a UART interrupt (or driver task) and
+ * the link's poll loop: one producer, one consumer, static storage. The
+ * producer never moves the read index, so a full ring drops the newest
+ * bytes (counted in overruns) and the frame parser resyncs on the magic.
+ *
+ * parseFrames reads frames straight out of the ring; only a frame that
+ * wraps the end of the storage is copied, into a caller-owned buffer.
+ */
+
+#ifndef AETHERIUM_EMBEDDED_PLATFORM_SERIAL_RING_HPP
+#define AETHERIUM_EMBEDDED_PLATFORM_SERIAL_RING_HPP
+
+#include "engine/core/protocol.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace aeth::embedded::platform {
+
+template <size_t N>
+class SerialRing {
+    static_assert(N >= protocol::HEADER_SIZE && (N & (N - 1)) == 0, "SerialRing capacity must be a power of two");
+
+public:
+    static constexpr size_t CAPACITY = N;
+
+    [[nodiscard]] size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+    [[nodiscard]] bool empty() const { return size() == 0; }
+    [[nodiscard]] size_t space() const { return N - size(); }
+    [[nodiscard]] uint32_t overruns() const { return overruns_.load(std::memory_order_relaxed); }
+
+    // ---- Producer -----------------------------------------------------------
+
+    bool push(uint8_t byte) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == N) {
+            overruns_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        data_[head & MASK] = byte;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Copies what fits; returns the bytes taken
+    size_t write(const uint8_t* data, size_t len) {
+        size_t span = 0;
+        uint8_t* out = writable(span);
+        size_t taken = std::min(len, span);
+        std::memcpy(out, data, taken);
+        commit(taken);
+        if (taken < len) {
+            out = writable(span);
+            const size_t rest = std::min(len - taken, span);
+            std::memcpy(out, data + taken, rest);
+            commit(rest);
+            taken += rest;
+        }
+        return taken;
+    }
+
+    // Contiguous free run at the write index, for bulk reads from a driver
+    uint8_t* writable(size_t& len) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t room = N - (head - tail_.load(std::memory_order_acquire));
+        len = std::min(room, N - (head & MASK));
+        return data_ + (head & MASK);
+    }
+
+    void commit(size_t len) {
+        head_.store(head_.load(std::memory_order_relaxed) + len, std::memory_order_release);
+    }
+
+    // ---- Consumer -----------------------------------------------------------
+
+    [[nodiscard]] uint8_t peek(size_t offset) const {
+        return data_[(tail_.load(std::memory_order_relaxed) + offset) & MASK];
+    }
+
+    // Contiguous readable run at the read index
+    const uint8_t* readable(size_t& len) const {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        len = std::min(head_.load(std::memory_order_acquire) - tail, N - (tail & MASK));
+        return data_ + (tail & MASK);
+    }
+
+    // Copy `len` buffered bytes without consuming them
+    void copyOut(uint8_t* out, size_t len) const {
+        const size_t start = tail_.load(std::memory_order_relaxed) & MASK;
+        const size_t first = std::min(len, N - start);
+        std::memcpy(out, data_ + start, first);
+        std::memcpy(out + first, data_, len - first);
+    }
+
+    bool pop(uint8_t& byte) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (head_.load(std::memory_order_acquire) == tail) {
+            return false;
+        }
+        byte = data_[tail & MASK];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    void discard(size_t len) {
+        tail_.store(tail_.load(std::memory_order_relaxed) + std::min(len, size()), std::memory_order_release);
+    }
+
+    void clear() { tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release); }
+
+private:
+    static constexpr size_t MASK = N - 1;
+
+    uint8_t data_[N]{};
+    std::atomic<size_t> head_{0};  // Free-running; only the producer writes it
+    std::atomic<size_t> tail_{0};  // Free-running; only the consumer writes it
+    std::atomic<uint32_t> overruns_{0};
+};
+
+/**
+ * Hand each complete frame in `ring` to `handle(data, len)`, then drop it.
+ * Bytes before a magic are skipped, as are headers announcing a frame the
+ * ring could never hold. `scratch` receives frames that wrap.
+ */
+template <size_t N, typename Handler>
+void parseFrames(SerialRing<N>& ring, uint8_t (&scratch)[N], Handler&& handle) {
+    constexpr uint8_t kMagicHigh = static_cast<uint8_t>((protocol::MAGIC >> 8) & 0xFF);
+    constexpr uint8_t kMagicLow = static_cast<uint8_t>(protocol::MAGIC & 0xFF);
+
+    while (true) {
+        const size_t available = ring.size();
+        if (available < protocol::HEADER_SIZE) {
+            return;
+        }
+        if (ring.peek(0) != kMagicHigh || ring.peek(1) != kMagicLow) {
+            ring.discard(1);
+            continue;
+        }
+
+        const size_t payloadLen = (static_cast<size_t>(ring.peek(4)) << 8) | ring.peek(5);
+        const size_t totalLen = protocol::HEADER_SIZE + payloadLen;
+        if (totalLen > protocol::MAX_MESSAGE_SIZE || totalLen > N) {
+            ring.discard(1);
+            continue;
+        }
+        if (available < totalLen) {
+            return;
+        }
+
+        size_t contiguous = 0;
+        const uint8_t* frame = ring.readable(contiguous);
+        if (contiguous < totalLen) {
+            ring.copyOut(scratch, totalLen);
+            frame = scratch;
+        }
+        handle(frame, totalLen);
+        ring.discard(totalLen);
+    }
+}
+
+} // namespace aeth::embedded::platform
+
+#endif // AETHERIUM_EMBEDDED_PLATFORM_SERIAL_RING_HPP
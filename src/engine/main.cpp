@@ -4,14 +4,38 @@
 
 #include "argparser.hpp"
 #include "automata_validator.hpp"
+#include "core/automata_analysis.hpp"
 #include "core/engine.hpp"
+#include "core/engine_host.hpp"
+#include "core/bytecode_compiler.hpp"
+#include "core/flash_automata.hpp"
+#include "core/monte_carlo.hpp"
+#include "core/simulation.hpp"
+#include "core/trace_query.hpp"
 #include "core/websocket_transport.hpp"
+#ifndef _WIN32
+#include "core/shm_transport.hpp"
+#endif
+#if defined(__linux__)
+#include "core/epoll_ws_transport.hpp"
+#endif
+
+#if !defined(AETHERIUM_DISABLE_YAML_FRONTEND)
+#include "core/automata_loader.hpp"
+#endif
 
 #include <atomic>
+#include <cctype>
 #include <chrono>
 #include <csignal>
+#include <cstring>
 #include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
 #include <iostream>
+#include <mutex>
 #include <thread>
 
 using namespace std::chrono_literals;
@@ -20,6 +44,9 @@ static std::atomic<bool> g_running{true};
 static std::atomic<uint64_t> g_maxTransitions{0};
 static std::atomic<uint64_t> g_maxTicks{10000000};
 static constexpr auto TICK_DELAY = std::chrono::microseconds(100);
+static constexpr auto IDLE_WAIT = std::chrono::milliseconds(100);  // Bounds signal/telemetry latency
+static constexpr size_t INGRESS_BATCH = aeth::WebSocketTransport::INGRESS_CAPACITY;  // Messages drained per loop
+static constexpr auto PEER_POLL = std::chrono::microseconds(500);  // Wait bound while peer links are open
 
 void signalHandler(int signal) {
     std::cout << "\nReceived signal " << signal << ", shutting down...\n";
@@ -59,24 +86,6 @@ aeth::protocol::DebugLevel toDebugLevel(aeth::LogLevel level) {
     }
 }
 
-bool isControlPlaneCommand(aeth::protocol::MessageType type) {
-    using aeth::protocol::MessageType;
-    switch (type) {
-        case MessageType::LoadAutomata:
-        case MessageType::Start:
-        case MessageType::Stop:
-        case MessageType::Pause:
-        case MessageType::Resume:
-        case MessageType::Reset:
-        case MessageType::Status:
-        case MessageType::Input:
-        case MessageType::Variable:
-            return true;
-        default:
-            return false;
-    }
-}
-
 std::string serverUrlFromArgs() {
     if (!ArgParser::serverUrl.empty()) {
         return ArgParser::serverUrl;
@@ -84,72 +93,221 @@ std::string serverUrlFromArgs() {
     return "ws://localhost:4000/socket/device/websocket";
 }
 
-int runAutomata(const std::string& automataFile, bool networkMode, const std::string& serverUrl) {
-    aeth::Engine engine;
-    std::unique_ptr<aeth::WebSocketTransport> transport;
-
-    aeth::EngineInitOptions initOptions;
-    initOptions.maxTickRate = 10;
-    initOptions.logCapacity = 4096;
+aeth::EngineInitOptions makeInitOptions() {
+    aeth::EngineInitOptions options;
+    options.maxTickRate = ArgParser::tickRate;
+    options.tickMode = ArgParser::reactiveFlag ? aeth::TickMode::Reactive : aeth::TickMode::Polling;
+    options.logCapacity = 4096;
+    if (ArgParser::gcMode == "full") {
+        options.gcPolicy.mode = aeth::GcMode::Full;
+    } else if (ArgParser::gcMode == "incremental") {
+        options.gcPolicy.mode = aeth::GcMode::Incremental;
+    } else if (ArgParser::gcMode == "generational") {
+        options.gcPolicy.mode = aeth::GcMode::Generational;
+    }
+    options.gcPolicy.watermarkBytes = static_cast<size_t>(ArgParser::gcWatermarkKb) * 1024;
+    options.scriptMemoryBudget = static_cast<size_t>(ArgParser::scriptMemoryKb) * 1024;
     if (const char* envId = std::getenv("DEVICE_ID")) {
-        initOptions.deviceName = envId;
-    }
-    initOptions.deployment.instanceId = ArgParser::instanceId;
-    initOptions.deployment.placement = ArgParser::placement;
-    initOptions.deployment.transport = ArgParser::transportName;
-    initOptions.deployment.controlPlaneInstance = ArgParser::controlPlaneInstance;
-    initOptions.deployment.battery.present = ArgParser::batteryPresent;
-    initOptions.deployment.battery.externalPower = ArgParser::batteryExternalPower;
-    initOptions.deployment.battery.chargePercent = ArgParser::batteryPercent;
-    initOptions.deployment.battery.lowThresholdPercent = ArgParser::batteryLowThresholdPercent;
-    initOptions.deployment.battery.drainPerTickPercent = ArgParser::batteryDrainPerTickPercent;
-    initOptions.deployment.battery.drainPerMessagePercent = ArgParser::batteryDrainPerMessagePercent;
-    initOptions.deployment.latency.budgetMs = ArgParser::latencyBudgetMs;
-    initOptions.deployment.latency.warningMs = ArgParser::latencyWarningMs;
-    initOptions.faultProfile.name = ArgParser::faultProfileName;
-    initOptions.faultProfile.enabled =
+        options.deviceName = envId;
+    }
+    options.deployment.instanceId = ArgParser::instanceId;
+    options.deployment.placement = ArgParser::placement;
+    options.deployment.transport = ArgParser::transportName;
+    options.deployment.controlPlaneInstance = ArgParser::controlPlaneInstance;
+    options.deployment.battery.present = ArgParser::batteryPresent;
+    options.deployment.battery.externalPower = ArgParser::batteryExternalPower;
+    options.deployment.battery.chargePercent = ArgParser::batteryPercent;
+    options.deployment.battery.lowThresholdPercent = ArgParser::batteryLowThresholdPercent;
+    options.deployment.battery.drainPerTickPercent = ArgParser::batteryDrainPerTickPercent;
+    options.deployment.battery.drainPerMessagePercent = ArgParser::batteryDrainPerMessagePercent;
+    options.deployment.latency.budgetMs = ArgParser::latencyBudgetMs;
+    options.deployment.latency.warningMs = ArgParser::latencyWarningMs;
+    options.deployment.pacing.enabled = ArgParser::minTickRate > 0;
+    options.deployment.pacing.minRate = ArgParser::minTickRate;
+    options.faultProfile.name = ArgParser::faultProfileName;
+    options.faultProfile.enabled =
         ArgParser::faultDelayMs > 0 ||
         ArgParser::faultJitterMs > 0 ||
         ArgParser::faultDropProbability > 0.0 ||
         ArgParser::faultDuplicateProbability > 0.0 ||
         ArgParser::faultSuccessProbability < 1.0 ||
         (ArgParser::faultDisconnectPeriodMs > 0 && ArgParser::faultDisconnectDurationMs > 0);
-    initOptions.faultProfile.applyToIngress = ArgParser::faultIngressFlag;
-    initOptions.faultProfile.applyToEgress = true;
-    initOptions.faultProfile.fixedDelayMs = ArgParser::faultDelayMs;
-    initOptions.faultProfile.jitterMs = ArgParser::faultJitterMs;
-    initOptions.faultProfile.dropProbability = ArgParser::faultDropProbability;
-    initOptions.faultProfile.duplicateProbability = ArgParser::faultDuplicateProbability;
-    initOptions.faultProfile.successProbability = ArgParser::faultSuccessProbability;
-    initOptions.faultProfile.disconnectPeriodMs = ArgParser::faultDisconnectPeriodMs;
-    initOptions.faultProfile.disconnectDurationMs = ArgParser::faultDisconnectDurationMs;
+    options.faultProfile.applyToIngress = ArgParser::faultIngressFlag;
+    options.faultProfile.applyToEgress = true;
+    options.faultProfile.fixedDelayMs = ArgParser::faultDelayMs;
+    options.faultProfile.jitterMs = ArgParser::faultJitterMs;
+    options.faultProfile.dropProbability = ArgParser::faultDropProbability;
+    options.faultProfile.duplicateProbability = ArgParser::faultDuplicateProbability;
+    options.faultProfile.successProbability = ArgParser::faultSuccessProbability;
+    options.faultProfile.disconnectPeriodMs = ArgParser::faultDisconnectPeriodMs;
+    options.faultProfile.disconnectDurationMs = ArgParser::faultDisconnectDurationMs;
     if (!ArgParser::traceFile.empty()) {
-        initOptions.traceOutputPath = ArgParser::traceFile;
+        options.traceOutputPath = ArgParser::traceFile;
     }
     if (ArgParser::seedProvided) {
-        initOptions.faultRandomSeed = ArgParser::seed;
+        options.faultRandomSeed = ArgParser::seed;
+    }
+    return options;
+}
+
+template <typename Transport>
+void configureHello(Transport& transport, const aeth::EngineInitOptions& initOptions) {
+    transport.setDeviceName(initOptions.deviceName);
+    aeth::protocol::DeploymentMetadataExtension helloDeployment;
+    helloDeployment.placement = initOptions.deployment.placement;
+    helloDeployment.transport = initOptions.deployment.transport;
+    helloDeployment.controlPlaneInstance = initOptions.deployment.controlPlaneInstance;
+    helloDeployment.targetClass = initOptions.deployment.targetClass;
+    helloDeployment.batteryPresent = initOptions.deployment.battery.present;
+    helloDeployment.batteryExternalPower = initOptions.deployment.battery.externalPower;
+    helloDeployment.batteryPercent = initOptions.deployment.battery.chargePercent;
+    helloDeployment.latencyBudgetMs = initOptions.deployment.latency.budgetMs;
+    helloDeployment.latencyWarningMs = initOptions.deployment.latency.warningMs;
+    if (!ArgParser::traceFile.empty()) {
+        helloDeployment.traceFile = ArgParser::traceFile;
+    }
+    helloDeployment.faultProfile = initOptions.faultProfile.name;
+    transport.setHelloDeploymentMetadata(std::move(helloDeployment));
+}
+
+#if defined(__linux__)
+// Shared epoll threads for ws:// links (--io-threads), null when off. Built
+// on first use; outlives every transport since those die before main returns.
+aeth::IoEventLoop* ioEventLoop() {
+    static std::unique_ptr<aeth::IoEventLoop> loop =
+        ArgParser::ioThreads > 0 ? std::make_unique<aeth::IoEventLoop>(ArgParser::ioThreads) : nullptr;
+    return loop.get();
+}
+
+bool usesIoEventLoop(const std::string& url) {
+    return url.rfind("ws://", 0) == 0 && ioEventLoop() != nullptr;
+}
+#endif
+
+std::unique_ptr<aeth::ITransport> connectTransport(const std::string& serverUrl,
+                                                   const aeth::EngineInitOptions& initOptions) {
+    std::unique_ptr<aeth::ITransport> transport;
+#ifndef _WIN32
+    if (aeth::SharedMemoryTransport::isShmUrl(serverUrl)) {
+        // Same-host link (e.g. to the local controller bridge), no socket involved
+        std::cout << "Attaching to shared-memory link: " << serverUrl << "\n";
+        auto shm = std::make_unique<aeth::SharedMemoryTransport>(
+            serverUrl.substr(std::strlen(aeth::SharedMemoryTransport::URL_SCHEME)));
+        configureHello(*shm, initOptions);
+        transport = std::move(shm);
+    }
+#endif
+#if defined(__linux__)
+    if (!transport && usesIoEventLoop(serverUrl)) {
+        std::cout << "Connecting to server: " << serverUrl << "\n";
+        auto ws = std::make_unique<aeth::EpollWebSocketTransport>(serverUrl, *ioEventLoop());
+        configureHello(*ws, initOptions);
+        transport = std::move(ws);
+    }
+#endif
+    if (!transport) {
+        std::cout << "Connecting to server: " << serverUrl << "\n";
+        auto ws = std::make_unique<aeth::WebSocketTransport>(serverUrl);
+        configureHello(*ws, initOptions);
+        transport = std::move(ws);
+    }
+    auto result = transport->connect();
+    if (result.isError()) {
+        std::cerr << "[WARN] Initial connect failed: " << result.error() << "\n";
+    }
+    return transport;
+}
+
+// Links for PEER_WIRING endpoints: shm://<name> on this host, otherwise a
+// WebSocket to the peer's listener
+std::unique_ptr<aeth::ITransport> makePeerTransport(const std::string& endpoint) {
+#ifndef _WIN32
+    if (aeth::SharedMemoryTransport::isShmUrl(endpoint)) {
+        auto shm = std::make_unique<aeth::SharedMemoryTransport>(
+            endpoint.substr(std::strlen(aeth::SharedMemoryTransport::URL_SCHEME)));
+        shm->setSendHello(false);
+        return shm;
+    }
+#endif
+#if defined(__linux__)
+    if (usesIoEventLoop(endpoint)) {
+        return std::make_unique<aeth::EpollWebSocketTransport>(endpoint, *ioEventLoop());
+    }
+#endif
+    if (endpoint.rfind("ws://", 0) == 0 || endpoint.rfind("wss://", 0) == 0) {
+        return std::make_unique<aeth::WebSocketTransport>(endpoint);
     }
+    return nullptr;
+}
+
+void printScriptCosts(const aeth::Engine& engine) {
+    if (!aeth::ProfileClock::enabled) {
+        std::cout << "Script profile unavailable: built with AETHERIUM_PROFILING=0\n";
+        return;
+    }
+    const std::string& sort = ArgParser::profileSort;
+    const auto order = sort == "calls" ? aeth::CodeCostOrder::Calls
+        : sort == "memory" ? aeth::CodeCostOrder::Memory
+        : aeth::CodeCostOrder::Time;
+
+    std::cout << "\n=== Script Cost (by " << sort << ") ===\n";
+    std::cout << std::left << std::setw(28) << "owner" << std::setw(16) << "block" << std::right
+              << std::setw(10) << "calls" << std::setw(12) << "total_us" << std::setw(10) << "mean_us"
+              << std::setw(12) << "lua_bytes" << "\n";
+    for (const auto& row : engine.scriptCosts(order)) {
+        const auto& cost = row.entry.cost;
+        const double totalUs = static_cast<double>(cost.totalNs) / 1000.0;
+        std::cout << std::left << std::setw(28) << row.owner << std::setw(16) << aeth::codeSiteName(row.entry.site)
+                  << std::right << std::setw(10) << cost.calls << std::fixed << std::setprecision(1)
+                  << std::setw(12) << totalUs << std::setw(10) << totalUs / static_cast<double>(cost.calls)
+                  << std::setw(12) << cost.allocatedBytes << "\n";
+    }
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+void printLogEvent(const aeth::LogEvent& event) {
+    std::cout << "[" << levelName(event.level) << "] "
+              << event.category << ": " << event.message;
+    if (event.variableName) {
+        std::cout << " (" << *event.variableName;
+        if (event.value) {
+            std::cout << "=" << event.value->toString();
+        }
+        std::cout << ")";
+    }
+    std::cout << "\n";
+}
+
+int runAutomata(const std::string& automataFile, bool networkMode, const std::string& serverUrl) {
+    // Declared first so it outlives the engine's log dispatcher, which uses it
+    std::unique_ptr<aeth::ITransport> transport;
+    aeth::Engine engine;
+
+    const aeth::EngineInitOptions initOptions = makeInitOptions();
 
     auto initResult = engine.initialize(initOptions);
     if (initResult.isError()) {
         std::cerr << "Failed to initialize engine: " << initResult.error() << "\n";
         return 1;
     }
+    engine.setIdOnlyWire(ArgParser::idOnlyWireFlag);
+    engine.setHotSwapLoads(ArgParser::hotSwapFlag);
+    engine.setPeerTransportFactory(makePeerTransport);
+
+    if (networkMode) {
+        transport = connectTransport(serverUrl, initOptions);
+    }
 
+    // Printing and the DebugMessage send run on the log dispatcher thread so
+    // a slow terminal or socket does not stretch ticks.
+    aeth::StreamOptions consoleStream;
+    consoleStream.async = true;
+    consoleStream.name = "console";
     engine.streamLogs([&transport](const aeth::LogEvent& event) {
         if (!shouldPrintLog(event)) {
             return;
         }
-        std::cout << "[" << levelName(event.level) << "] "
-                  << event.category << ": " << event.message;
-        if (event.variableName) {
-            std::cout << " (" << *event.variableName;
-            if (event.value) {
-                std::cout << "=" << event.value->toString();
-            }
-            std::cout << ")";
-        }
-        std::cout << "\n";
+        printLogEvent(event);
 
         if (transport && transport->isConnected()) {
             aeth::protocol::DebugMessage msg;
@@ -159,32 +317,7 @@ int runAutomata(const std::string& automataFile, bool networkMode, const std::st
             msg.timestamp = event.timestamp;
             transport->send(std::make_unique<aeth::protocol::DebugMessage>(msg));
         }
-    });
-
-    if (networkMode) {
-        std::cout << "Connecting to server: " << serverUrl << "\n";
-        transport = std::make_unique<aeth::WebSocketTransport>(serverUrl);
-        transport->setDeviceName(initOptions.deviceName);
-        aeth::protocol::DeploymentMetadataExtension helloDeployment;
-        helloDeployment.placement = initOptions.deployment.placement;
-        helloDeployment.transport = initOptions.deployment.transport;
-        helloDeployment.controlPlaneInstance = initOptions.deployment.controlPlaneInstance;
-        helloDeployment.targetClass = initOptions.deployment.targetClass;
-        helloDeployment.batteryPresent = initOptions.deployment.battery.present;
-        helloDeployment.batteryExternalPower = initOptions.deployment.battery.externalPower;
-        helloDeployment.batteryPercent = initOptions.deployment.battery.chargePercent;
-        helloDeployment.latencyBudgetMs = initOptions.deployment.latency.budgetMs;
-        helloDeployment.latencyWarningMs = initOptions.deployment.latency.warningMs;
-        if (!ArgParser::traceFile.empty()) {
-            helloDeployment.traceFile = ArgParser::traceFile;
-        }
-        helloDeployment.faultProfile = initOptions.faultProfile.name;
-        transport->setHelloDeploymentMetadata(std::move(helloDeployment));
-        auto result = transport->connect();
-        if (result.isError()) {
-            std::cerr << "[WARN] Initial connect failed: " << result.error() << "\n";
-        }
-    }
+    }, consoleStream);
 
     if (!automataFile.empty()) {
         std::cout << "Loading automata from: " << automataFile << "\n";
@@ -204,28 +337,24 @@ int runAutomata(const std::string& automataFile, bool networkMode, const std::st
 
     static constexpr auto TELEMETRY_INTERVAL = std::chrono::seconds(5);
     auto lastTelemetry = std::chrono::steady_clock::now() - TELEMETRY_INTERVAL;
+    aeth::TickScheduler scheduler(initOptions.maxTickRate);
+    auto steadyUs = [] {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    };
     while (g_running && (networkMode || engine.isRunning())) {
-        bool sawControlCommand = false;
-
-        while (transport && transport->hasMessage()) {
-            auto message = transport->receive();
-            if (!message) {
-                break;
-            }
-
+        if (transport) {
             const uint32_t myId = transport->assignedId();
-            if (message->targetId != 0 && myId != 0 && message->targetId != myId) {
-                continue;
-            }
-
-            if (isControlPlaneCommand(message->type())) {
-                sawControlCommand = true;
-            }
-
-            engine.enqueueCommand(std::move(message));
+            transport->drain([&](std::unique_ptr<aeth::protocol::Message> message) {
+                if (message->targetId != 0 && myId != 0 && message->targetId != myId) {
+                    return;
+                }
+                engine.enqueueCommand(std::move(message));
+            }, INGRESS_BATCH);
         }
+        engine.pollPeerLinks(INGRESS_BATCH);
 
-        // Prioritize control commands before executing another runtime tick.
+        // Commands before the tick; control lanes ahead of input and bulk (see Engine::processCommandQueue)
         auto replies = engine.processCommandQueue();
         for (auto& reply : replies) {
             if (!reply) {
@@ -238,13 +367,10 @@ int runAutomata(const std::string& automataFile, bool networkMode, const std::st
             }
         }
 
-        if (sawControlCommand) {
-            std::this_thread::sleep_for(TICK_DELAY);
-            continue;
-        }
-
-        if (engine.isRunning()) {
+        scheduler.retune(engine.tickRate());
+        if (engine.isRunning() && scheduler.due(steadyUs(), engine.msUntilNextTimer())) {
             engine.tick();
+            scheduler.ticked(steadyUs());
         }
 
         auto status = engine.status();
@@ -261,11 +387,36 @@ int runAutomata(const std::string& automataFile, bool networkMode, const std::st
             auto now = std::chrono::steady_clock::now();
             if (now - lastTelemetry >= TELEMETRY_INTERVAL) {
                 lastTelemetry = now;
-                transport->send(engine.buildTelemetryMessage());
+                if (!ArgParser::telemetryDeltaFlag) {
+                    transport->send(engine.buildTelemetryMessage());
+                } else if (auto delta = engine.buildTelemetryDelta()) {
+                    transport->send(std::move(delta));
+                }
             }
         }
 
-        std::this_thread::sleep_for(TICK_DELAY);
+        // Step the script GC in part of the slack before the next tick slot.
+        if (engine.isRunning() && !scheduler.unlimited()) {
+            const uint64_t slackUs = scheduler.waitUs(steadyUs(), engine.msUntilNextTimer(), UINT32_MAX);
+            engine.collectGarbageIdle(static_cast<uint32_t>(slackUs / 2));
+        }
+
+        // Block until the next tick slot, timer deadline or inbound message.
+        auto wait = std::chrono::duration_cast<std::chrono::microseconds>(IDLE_WAIT);
+        if (engine.isRunning()) {
+            wait = scheduler.unlimited()
+                ? TICK_DELAY
+                : std::chrono::microseconds(scheduler.waitUs(
+                      steadyUs(), engine.msUntilNextTimer(), static_cast<uint64_t>(wait.count())));
+        }
+        if (!engine.peerLinks().empty()) {
+            wait = std::min(wait, std::chrono::duration_cast<std::chrono::microseconds>(PEER_POLL));
+        }
+        if (transport && transport->canWait()) {
+            transport->waitForMessage(wait);
+        } else if (wait.count() > 0) {
+            std::this_thread::sleep_for(wait);
+        }
     }
 
     if (engine.isRunning() || engine.status().executionState == aeth::ExecutionState::Paused) {
@@ -281,7 +432,107 @@ int runAutomata(const std::string& automataFile, bool networkMode, const std::st
     std::cout << "Run ID: " << finalStatus.runId << "\n";
     std::cout << "Total ticks: " << finalStatus.tickCount << "\n";
     std::cout << "Total transitions: " << finalStatus.transitionCount << "\n";
+    std::cout << "Script values synced (last tick): " << finalStatus.scriptValuesSynced << "\n";
+    std::cout << "Errors: " << finalStatus.errorCount << "\n";
+    if (finalStatus.scriptMemory.peak > 0) {
+        std::cout << "Script heap: peak " << finalStatus.scriptMemory.peak << " bytes, "
+                  << finalStatus.scriptMemory.reserved << " reserved";
+        if (finalStatus.scriptMemory.failures > 0) {
+            std::cout << ", " << finalStatus.scriptMemory.failures << " allocations refused";
+        }
+        std::cout << "\n";
+    }
+    for (const auto& stream : engine.logStreamStats()) {
+        if (stream.dropped > 0) {
+            std::cout << "Log stream " << stream.name << ": " << stream.delivered
+                      << " delivered, " << stream.dropped << " dropped\n";
+        }
+    }
+
+    if (ArgParser::profileFlag) {
+        printScriptCosts(engine);
+    }
+
+    auto traceResult = engine.writeTrace();
+    if (traceResult.isError()) {
+        std::cerr << "Failed to write trace: " << traceResult.error() << "\n";
+        return 1;
+    }
+    if (!ArgParser::traceFile.empty()) {
+        std::cout << "Trace written to: " << ArgParser::traceFile << "\n";
+    }
+
+    return 0;
+}
+
+// --virtual-time: the same run on a virtual clock, as fast as the CPU allows
+int runSimulated(const std::string& automataFile) {
+    aeth::InputTimeline timeline;
+    if (!ArgParser::inputTimelineFile.empty()) {
+        auto loaded = aeth::InputTimeline::load(ArgParser::inputTimelineFile);
+        if (loaded.isError()) {
+            std::cerr << "Failed to load inputs: " << loaded.error() << "\n";
+            return 1;
+        }
+        timeline = std::move(loaded.value());
+    }
+
+    auto clockOwner = std::make_unique<aeth::VirtualClock>();
+    aeth::VirtualClock& clock = *clockOwner;
+    auto random = ArgParser::seedProvided ? std::make_unique<aeth::StdRandomSource>(ArgParser::seed)
+                                          : std::make_unique<aeth::StdRandomSource>();
+    aeth::Engine engine(std::move(clockOwner), std::move(random), aeth::makeDefaultScriptEngine());
+
+    aeth::EngineInitOptions initOptions = makeInitOptions();
+    initOptions.virtualTime = true;
+    auto initResult = engine.initialize(initOptions);
+    if (initResult.isError()) {
+        std::cerr << "Failed to initialize engine: " << initResult.error() << "\n";
+        return 1;
+    }
+    engine.setIdOnlyWire(ArgParser::idOnlyWireFlag);
+    engine.streamLogs([](const aeth::LogEvent& event) {
+        if (shouldPrintLog(event)) {
+            printLogEvent(event);
+        }
+    });
+
+    auto load = engine.loadAutomataFromFile(automataFile, aeth::protocolv2::LoadReplaceMode::HardReset, true);
+    if (load.isError()) {
+        std::cerr << "Failed to load automata: " << load.error() << "\n";
+        return 1;
+    }
+
+    aeth::SimulationOptions options;
+    options.durationMs = ArgParser::simDurationMs;
+    options.skipIdleTicks = !ArgParser::simEveryTickFlag;
+    options.maxTicks = g_maxTicks;
+    options.maxTransitions = g_maxTransitions;
+    const auto started = std::chrono::steady_clock::now();
+    auto simulated = aeth::runSimulation(engine, clock, timeline, options);
+    if (simulated.isError()) {
+        std::cerr << "Simulation failed: " << simulated.error() << "\n";
+        return 1;
+    }
+    const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started).count();
+
+    if (engine.isRunning() || engine.status().executionState == aeth::ExecutionState::Paused) {
+        engine.stop();
+    }
+
+    const auto& report = simulated.value();
+    const auto finalStatus = engine.status();
+    std::cout << "\n=== Simulation Summary ===\n";
+    std::cout << "Run ID: " << finalStatus.runId << "\n";
+    std::cout << "Virtual time: " << report.endMs << " ms (" << elapsedMs << " ms wall)\n";
+    std::cout << "Total ticks: " << report.ticks << " (" << report.idleJumps << " idle jumps)\n";
+    std::cout << "Total transitions: " << finalStatus.transitionCount << "\n";
+    std::cout << "Inputs applied: " << report.inputsApplied << "\n";
     std::cout << "Errors: " << finalStatus.errorCount << "\n";
+    for (const auto& error : report.inputErrors) {
+        std::cout << "Input refused: " << error << "\n";
+    }
 
     auto traceResult = engine.writeTrace();
     if (traceResult.isError()) {
@@ -291,10 +542,315 @@ int runAutomata(const std::string& automataFile, bool networkMode, const std::st
     if (!ArgParser::traceFile.empty()) {
         std::cout << "Trace written to: " << ArgParser::traceFile << "\n";
     }
+    return report.inputErrors.empty() ? 0 : 1;
+}
+
+int runMonteCarlo(const std::string& automataFile) {
+    aeth::InputTimeline timeline;
+    if (!ArgParser::inputTimelineFile.empty()) {
+        auto loaded = aeth::InputTimeline::load(ArgParser::inputTimelineFile);
+        if (loaded.isError()) {
+            std::cerr << "Failed to load inputs: " << loaded.error() << "\n";
+            return 1;
+        }
+        timeline = std::move(loaded.value());
+    }
+
+    aeth::MonteCarloOptions options;
+    options.runs = ArgParser::monteCarloRuns;
+    options.workers = ArgParser::workers;
+    options.baseSeed = ArgParser::seedProvided ? ArgParser::seed : 1;
+    options.engine = makeInitOptions();
+    options.simulation.durationMs = ArgParser::simDurationMs;
+    options.simulation.skipIdleTicks = !ArgParser::simEveryTickFlag;
+    // Only an explicit --max-ticks; the ten-million default is meant for one run
+    options.simulation.maxTicks = ArgParser::maxTicks;
+    options.simulation.maxTransitions = g_maxTransitions;
+
+    const auto started = std::chrono::steady_clock::now();
+    auto result = aeth::runMonteCarlo(automataFile, timeline, options);
+    if (result.isError()) {
+        std::cerr << "Monte-Carlo failed: " << result.error() << "\n";
+        return 1;
+    }
+    const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started).count();
+
+    std::cout << "\n=== Monte-Carlo Summary ===\n";
+    std::cout << "Base seed: " << options.baseSeed << " (" << elapsedMs << " ms wall)\n";
+    std::cout << result.value().summary();
+    return result.value().failedRuns == 0 ? 0 : 1;
+}
+
+int runHost(const std::vector<std::string>& files, bool networkMode, const std::string& serverUrl) {
+    aeth::EngineHostOptions hostOptions;
+    hostOptions.workers = ArgParser::workers;
+    hostOptions.instanceDefaults = makeInitOptions();
+    // One trace per instance, written below with the instance index appended.
+    hostOptions.instanceDefaults.traceOutputPath.reset();
+    hostOptions.peerTransportFactory = makePeerTransport;
+
+    aeth::EngineHost host(hostOptions);
+    host.setMaxTicksPerInstance(g_maxTicks);
+
+    // Instance logs arrive on worker threads.
+    std::mutex logMutex;
+    for (const auto& file : files) {
+        auto added = host.addInstanceFromFile(file, true);
+        if (added.isError()) {
+            std::cerr << "Failed to load automata: " << added.error() << "\n";
+            return 1;
+        }
+        const size_t index = added.value();
+        const std::string name = host.stats()[index].name;
+        host.instance(index).streamLogs([&logMutex, name](const aeth::LogEvent& event) {
+            if (!shouldPrintLog(event)) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(logMutex);
+            std::cout << "[" << levelName(event.level) << "] [" << name << "] "
+                      << event.category << ": " << event.message << "\n";
+        });
+        if (!ArgParser::traceFile.empty()) {
+            host.instance(index).setTraceOutputPath(ArgParser::traceFile + "." + std::to_string(index));
+        }
+        std::cout << "Hosting " << file << " as device " << host.instance(index).deviceId()
+                  << " (run_id=" << host.instance(index).activeRunId() << ")\n";
+    }
+    std::cout << "Hosting " << host.instanceCount() << " automata on "
+              << host.workerCount() << " workers\n";
+
+    std::unique_ptr<aeth::ITransport> transport;
+    if (networkMode) {
+        transport = connectTransport(serverUrl, hostOptions.instanceDefaults);
+    }
+
+    auto steadyUs = [] {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    };
+    while (g_running && (networkMode || host.anyRunning())) {
+        if (transport) {
+            // The server addresses the process; instances are picked by RunId.
+            const uint32_t myId = transport->assignedId();
+            transport->drain([&](std::unique_ptr<aeth::protocol::Message> message) {
+                if (myId != 0 && message->targetId == myId) {
+                    message->targetId = 0;
+                }
+                host.route(std::move(message));
+            }, INGRESS_BATCH);
+        }
+
+        host.schedule(steadyUs());
+
+        for (auto& reply : host.takeReplies()) {
+            if (transport && transport->isConnected()) {
+                transport->send(std::move(reply));
+            } else if (ArgParser::debugFlag) {
+                std::cout << "[OUT] message type=" << static_cast<int>(reply->type()) << "\n";
+            }
+        }
+
+        const auto maxWait = std::chrono::duration_cast<std::chrono::microseconds>(IDLE_WAIT);
+        auto wait = std::chrono::microseconds(
+            host.waitUs(steadyUs(), static_cast<uint64_t>(maxWait.count())));
+        if (host.anyPeerLinks()) {
+            wait = std::min(wait, std::chrono::duration_cast<std::chrono::microseconds>(PEER_POLL));
+        }
+        if (transport && transport->canWait()) {
+            transport->waitForMessage(wait);
+        } else if (wait.count() > 0) {
+            std::this_thread::sleep_for(wait);
+        }
+    }
+
+    host.stopAll();
+    if (transport) {
+        for (auto& reply : host.takeReplies()) {
+            transport->send(std::move(reply));
+        }
+        transport->disconnect();
+    }
+
+    auto stats = host.stats();
+    std::sort(stats.begin(), stats.end(), [](const auto& a, const auto& b) {
+        return a.meanTickUs() > b.meanTickUs();
+    });
+    std::cout << "\n=== Host Summary (slowest first) ===\n";
+    for (const auto& entry : stats) {
+        std::cout << entry.name << " (device " << entry.deviceId << ", run_id=" << entry.runId << "): "
+                  << entry.ticks << " ticks, mean " << entry.meanTickUs() << "us, max "
+                  << entry.maxTickUs << "us, script heap peak " << entry.scriptHeapPeak << " bytes";
+        if (entry.scriptAllocFailures > 0) {
+            std::cout << " (" << entry.scriptAllocFailures << " allocations refused)";
+        }
+        std::cout << "\n";
+    }
+
+    int exitCode = 0;
+    for (size_t i = 0; i < host.instanceCount(); ++i) {
+        auto traceResult = host.instance(i).writeTrace();
+        if (traceResult.isError()) {
+            std::cerr << "Failed to write trace: " << traceResult.error() << "\n";
+            exitCode = 1;
+        }
+    }
+    return exitCode;
+}
 
+// Write an engine-bytecode artifact as flash tables next to it; the file stem names the symbol
+int emitFlashTablesFile(const std::string& artifactFile) {
+    std::ifstream in(artifactFile, std::ios::binary);
+    const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    auto artifact = aeth::ir::deserializeArtifact(bytes);
+    if (artifact.isError()) {
+        std::cerr << "Failed to read artifact: " << artifact.error() << "\n";
+        return 1;
+    }
+    if (artifact.value().payloadKind != aeth::ir::PayloadKind::EngineBytecode) {
+        std::cerr << "Flash tables need an engine bytecode artifact\n";
+        return 1;
+    }
+    auto program = aeth::ir::deserializeEngineBytecodeProgram(artifact.value().payloadBytes);
+    if (program.isError()) {
+        std::cerr << "Failed to decode bytecode: " << program.error() << "\n";
+        return 1;
+    }
+
+    std::string symbol = std::filesystem::path(artifactFile).stem().string();
+    std::replace_if(symbol.begin(), symbol.end(), [](char c) {
+        return !std::isalnum(static_cast<unsigned char>(c));
+    }, '_');
+    if (symbol.empty() || std::isdigit(static_cast<unsigned char>(symbol.front()))) {
+        symbol = "automata_" + symbol;
+    }
+    auto header = aeth::emitFlashTables(program.value(), symbol);
+    if (header.isError()) {
+        std::cerr << "Failed to emit flash tables: " << header.error() << "\n";
+        return 1;
+    }
+
+    const std::string output = std::filesystem::path(artifactFile).replace_extension(".hpp").string();
+    std::ofstream(output) << header.value();
+    std::cout << "Wrote flash tables '" << symbol << "' to: " << output << "\n";
     return 0;
 }
 
+// Compile a YAML automaton once into the binary deploy format, next to it
+int compileArtifactFile(const std::string& yamlFile) {
+#if defined(AETHERIUM_DISABLE_YAML_FRONTEND)
+    std::cerr << "This build has no YAML frontend; compile artifacts with a full engine build\n";
+    (void) yamlFile;
+    return 1;
+#else
+    aeth::AutomataLoader loader;
+    auto loaded = loader.loadFromFile(yamlFile);
+    if (loaded.isError()) {
+        std::cerr << "Failed to load automata: " << loaded.error() << "\n";
+        return 1;
+    }
+    for (const auto& warn : loaded.value().warnings) {
+        std::cerr << "Warning: " << warn << "\n";
+    }
+    auto artifact = aeth::compileDeployArtifact(*loaded.value().automata, yamlFile);
+    if (artifact.isError()) {
+        std::cerr << "Failed to compile artifact: " << artifact.error() << "\n";
+        return 1;
+    }
+    auto bytes = aeth::ir::serializeArtifact(artifact.value());
+    if (bytes.isError()) {
+        std::cerr << "Failed to encode artifact: " << bytes.error() << "\n";
+        return 1;
+    }
+
+    const std::string output = std::filesystem::path(yamlFile).replace_extension(".aeth").string();
+    std::ofstream(output, std::ios::binary).write(reinterpret_cast<const char*>(bytes.value().data()),
+                                                  static_cast<std::streamsize>(bytes.value().size()));
+    std::cout << "Wrote bytecode artifact (" << bytes.value().size() << " bytes) to: " << output << "\n";
+    return 0;
+#endif
+}
+
+#if !defined(AETHERIUM_DISABLE_YAML_FRONTEND)
+// Full load and static analysis of each file; with --validate-cache, unchanged files reuse their verdict
+int validateAutomataFiles(const std::vector<std::string>& files) {
+    std::unique_ptr<aeth::ValidationCache> cache;
+    if (!ArgParser::validateCacheFile.empty()) {
+        cache = std::make_unique<aeth::ValidationCache>(ArgParser::validateCacheFile);
+        cache->load();
+    }
+
+    std::vector<aeth::ValidationCache::Verdict> verdicts(files.size());
+    std::vector<std::string> stale;
+    std::vector<size_t> staleIndex;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (cache) {
+            auto fingerprint = aeth::ValidationCache::fingerprint(files[i]);
+            verdicts[i].fingerprint = fingerprint.isOk() ? fingerprint.value() : 0;
+            if (const auto* cached = cache->find(files[i], verdicts[i].fingerprint)) {
+                verdicts[i] = *cached;
+                continue;
+            }
+        }
+        stale.push_back(files[i]);
+        staleIndex.push_back(i);
+    }
+
+    aeth::AutomataLoader loader;
+    auto results = loader.loadFromFiles(stale, ArgParser::workers);
+    for (size_t j = 0; j < results.size(); ++j) {
+        auto& verdict = verdicts[staleIndex[j]];
+        verdict.valid = results[j].isOk();
+        if (results[j].isError()) {
+            verdict.errors.push_back(results[j].error());
+        } else {
+            verdict.warnings = std::move(results[j].value().warnings);
+            aeth::AnalysisOptions analysisOptions;
+            analysisOptions.workers = ArgParser::workers;
+            const auto analysis = aeth::analyzeAutomata(*results[j].value().automata, analysisOptions);
+            for (const auto& finding : analysis.findings) {
+                verdict.warnings.push_back(std::string(aeth::findingKindName(finding.kind)) + ": " + finding.message);
+            }
+        }
+        if (cache) {
+            cache->store(stale[j], verdict);
+        }
+    }
+    if (cache) {
+        if (auto saved = cache->save(); saved.isError()) {
+            std::cerr << "Warning: " << saved.error() << "\n";
+        }
+    }
+
+    size_t invalid = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+        invalid += verdicts[i].valid ? 0 : 1;
+        for (const auto& error : verdicts[i].errors) {
+            std::cout << files[i] << ": " << error << "\n";
+        }
+        for (const auto& warn : verdicts[i].warnings) {
+            std::cerr << files[i] << ": warning: " << warn << "\n";
+        }
+    }
+    std::cout << (files.size() - invalid) << "/" << files.size() << " automata valid ("
+              << (files.size() - stale.size()) << " from cache).\n";
+    return invalid == 0 ? 0 : 1;
+}
+
+// Every *.yaml/*.yml under `folder`
+int validateAutomataFolder(const std::string& folder) {
+    std::vector<std::string> files;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(folder)) {
+        const auto ext = entry.path().extension();
+        if (entry.is_regular_file() && (ext == ".yaml" || ext == ".yml")) {
+            files.push_back(entry.path().string());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return validateAutomataFiles(files);
+}
+#endif
+
 int main(int argc, char* argv[]) {
     std::signal(SIGINT, signalHandler);
     std::signal(SIGTERM, signalHandler);
@@ -313,12 +869,60 @@ int main(int argc, char* argv[]) {
             return 1;
         }
 
+#if defined(AETHERIUM_DISABLE_YAML_FRONTEND)
+        std::cerr << "This build has no YAML frontend; --validate is unavailable\n";
+        return 1;
+#else
+        if (std::filesystem::is_directory(ArgParser::automataFile)) {
+            return validateAutomataFolder(ArgParser::automataFile);
+        }
+        if (!ArgParser::validateCacheFile.empty()) {
+            return validateAutomataFiles({ArgParser::automataFile});
+        }
         if (AutomataValidator::validate(ArgParser::automataFile)) {
             std::cout << "Automata is valid.\n";
             return 0;
         }
         std::cout << "Automata is invalid.\n";
         return 1;
+#endif
+    }
+
+    if (!ArgParser::convertTraceFile.empty()) {
+        const std::string output = ArgParser::traceFile.empty()
+            ? std::filesystem::path(ArgParser::convertTraceFile).replace_extension(".jsonl").string()
+            : ArgParser::traceFile;
+        auto converted = aeth::LocalTraceStore::convertBinaryToJsonLines(ArgParser::convertTraceFile, output);
+        if (converted.isError()) {
+            std::cerr << "Failed to convert trace: " << converted.error() << "\n";
+            return 1;
+        }
+        std::cout << "Converted " << converted.value() << " trace records to: " << output << "\n";
+        return 0;
+    }
+
+    if (!ArgParser::analyzeTraceFile.empty()) {
+        aeth::TraceQueryOptions options;
+        options.workers = ArgParser::workers;
+        const auto started = std::chrono::steady_clock::now();
+        auto analyzed = aeth::analyzeTraceFile(ArgParser::analyzeTraceFile, options);
+        if (analyzed.isError()) {
+            std::cerr << "Failed to analyze trace: " << analyzed.error() << "\n";
+            return 1;
+        }
+        const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started).count();
+        std::cout << "=== Trace Analysis: " << ArgParser::analyzeTraceFile << " (" << elapsedMs << " ms wall) ===\n";
+        std::cout << analyzed.value().summary();
+        return 0;
+    }
+
+    if (!ArgParser::flashTablesFile.empty()) {
+        return emitFlashTablesFile(ArgParser::flashTablesFile);
+    }
+
+    if (!ArgParser::compileArtifactFile.empty()) {
+        return compileArtifactFile(ArgParser::compileArtifactFile);
     }
 
     g_maxTransitions = ArgParser::maxTransitions;
@@ -328,11 +932,25 @@ int main(int argc, char* argv[]) {
 
     const bool networkMode = (ArgParser::mode == EngineMode::network);
 
+    if (!ArgParser::hostFiles.empty()) {
+        return runHost(ArgParser::hostFiles, networkMode, serverUrlFromArgs());
+    }
+
     if (ArgParser::runFlag) {
         if (ArgParser::automataFile.empty() && !networkMode) {
             std::cerr << "Error: No automata file specified\n";
             return 1;
         }
+        if (ArgParser::virtualTimeFlag) {
+            if (networkMode) {
+                std::cerr << "Error: --virtual-time runs a local automata file\n";
+                return 1;
+            }
+            if (ArgParser::monteCarloRuns > 0) {
+                return runMonteCarlo(ArgParser::automataFile);
+            }
+            return runSimulated(ArgParser::automataFile);
+        }
         return runAutomata(ArgParser::automataFile, networkMode, serverUrlFromArgs());
     }
 
@@ -340,7 +958,7 @@ int main(int argc, char* argv[]) {
         return runAutomata("", true, serverUrlFromArgs());
     }
 
-    std::cerr << "Error: No action specified. Use --run <file>, --validate <file>, or --mode network\n";
+    std::cerr << "Error: No action specified. Use --run <file>, --host <file>, --validate <file>, or --mode network\n";
     ArgParser::printHelp();
     return 1;
 }
@@ -393,7 +393,7 @@ defmodule AetheriumServer.EngineProtocol do
     {legacy_vars, rest2} = decode_var_snapshot(rest, var_count, [])
 
     with {:ok, named_vars, rest3} <- decode_named_var_snapshot(rest2),
-         {:ok, deployment_metadata, _rest4} <- decode_deployment_extension(rest3) do
+         {:ok, deployment_metadata, rest4} <- decode_deployment_extension(rest3) do
       {:ok, :telemetry,
        %{
          message_id: message_id,
@@ -404,6 +404,7 @@ defmodule AetheriumServer.EngineProtocol do
          heap_total: heap_total,
          cpu_usage: cpu_fixed / 100.0,
          tick_rate: tick_rate,
+         script_values_synced: decode_script_values_synced(rest4),
          variables: if(map_size(named_vars) > 0, do: named_vars, else: legacy_vars),
          deployment_metadata: deployment_metadata
        }}
@@ -616,6 +617,10 @@ defmodule AetheriumServer.EngineProtocol do
 
   defp do_decode_named_var_snapshot(_rest, _n, _acc), do: {:error, :invalid_named_var_snapshot}
 
+  # Trails the deployment extension; engines that predate it send nothing
+  defp decode_script_values_synced(<<synced::32, _rest::binary>>), do: synced
+  defp decode_script_values_synced(_rest), do: 0
+
   defp decode_deployment_extension(<<>>), do: {:ok, %{}, <<>>}
   defp decode_deployment_extension(<<0::8, rest::binary>>), do: {:ok, %{}, rest}
 
@@ -103,6 +103,17 @@ defmodule AetheriumServer.EngineProtocolTest do
     assert payload.deployment_metadata["placement"] == "docker_black_box"
     assert payload.deployment_metadata["battery"]["percent"] == 91.5
     assert payload.deployment_metadata["latency"]["ingress_ms"] == 8
+    assert payload.script_values_synced == 0
+  end
+
+  test "decodes the script sync counter trailing telemetry" do
+    payload =
+      <<99::32, 4::32, 0::32, 111::32, 1_700_000_000_000::64, 64::32, 128::32, 150::16, 30::32,
+        0::16, 0::16, 0::8, 7::32>>
+
+    assert {:ok, :telemetry, payload} = EngineProtocol.decode(frame(0x84, payload))
+    assert payload.script_values_synced == 7
+    assert payload.deployment_metadata == %{}
   end
 
   defp decode_load(
@@ -1,10 +1,38 @@
 #include "engine/core/engine.hpp"
 #include "engine/core/artifact.hpp"
+#include "engine/core/bytecode_compiler.hpp"
+#include "engine/core/crc32.hpp"
+#include "engine/core/engine_host.hpp"
+#include "engine/core/automata_loader.hpp"
+#include "engine/core/parser.hpp"
+#include "engine/core/monte_carlo.hpp"
+#include "engine/core/simulation.hpp"
+#include "engine/core/trace_query.hpp"
+#ifndef _WIN32
+#include "engine/core/shm_transport.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include "engine/core/epoll_ws_transport.hpp"
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+#if !defined(AETHERIUM_DISABLE_LUA_SCRIPT_ENGINE)
+#include "engine/core/lua_engine.hpp"
+#endif
 
 #include <algorithm>
 #include <chrono>
 #include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <thread>
@@ -373,6 +401,35 @@ int main() {
         require(loadAck->success, "load: expected success=true, got error: " + loadAck->errorMessage);
     }
 
+    {
+        auto symbolReq = makeMessage<protocol::SymbolTableMessage>();
+        auto replies = send(engine, std::move(symbolReq));
+        auto* table = findMessage<protocol::SymbolTableMessage>(replies);
+        require(table != nullptr, "symbol table request: expected SymbolTable");
+        require(table->runId == 42, "symbol table request: expected active run id");
+        const bool hasSensor = std::any_of(table->variables.begin(), table->variables.end(),
+                                           [](const auto& entry) { return entry.name == "sensor_temp"; });
+        require(hasSensor && !table->states.empty(), "symbol table request: expected variables and states");
+    }
+
+    {
+        engine.setIdOnlyWire(true);
+        auto loadReq = makeMessage<protocol::LoadAutomataMessage>();
+        loadReq->runId = 42;
+        loadReq->format = protocol::AutomataFormat::YAML;
+        loadReq->replaceExisting = true;
+        loadReq->startAfterLoad = false;
+        loadReq->data.assign(kYaml, kYaml + std::char_traits<char>::length(kYaml));
+
+        auto replies = send(engine, std::move(loadReq));
+        require(findMessage<protocol::SymbolTableMessage>(replies) != nullptr,
+                "id-only load: expected SymbolTable after LoadAck");
+        auto telemetry = engine.buildTelemetryMessage();
+        require(telemetry->namedVariableSnapshot.empty() && !telemetry->variableSnapshot.empty(),
+                "id-only telemetry: expected id-keyed snapshot only");
+        engine.setIdOnlyWire(false);
+    }
+
     {
         auto artifact = ir::makeYamlArtifact(kYaml, ".");
         auto encoded = ir::serializeArtifact(artifact);
@@ -616,6 +673,73 @@ int main() {
         require(!loadAck->success, "out-of-order chunk: expected failure");
     }
 
+    {
+        auto program = makeBytecodeProgram();
+        auto artifactRes = ir::makeEngineBytecodeArtifact(program, ".");
+        require(artifactRes.isOk(), "stream decoder artifact build failed: " + artifactRes.error());
+        auto encodedArtifact = ir::serializeArtifact(artifactRes.value());
+        require(encodedArtifact.isOk(), "stream decoder artifact encode failed: " + encodedArtifact.error());
+
+        ir::ArtifactStreamDecoder decoder;
+        for (const auto& chunk : chunkBytes(encodedArtifact.value(), 7)) {
+            auto fed = decoder.feed(chunk.data(), chunk.size());
+            require(fed.isOk(), "stream decoder feed failed: " + fed.error());
+        }
+        auto finished = decoder.finish();
+        require(finished.isOk(), "stream decoder finish failed: " + finished.error());
+        require(decoder.program().states.size() == program.states.size(), "stream decoder: state count mismatch");
+        require(decoder.program().transitions.size() == program.transitions.size(),
+                "stream decoder: transition count mismatch");
+        require(decoder.peakBufferedBytes() < encodedArtifact.value().size(),
+                "stream decoder: expected less than the whole artifact buffered");
+
+        ir::ArtifactStreamDecoder limited(encodedArtifact.value().size() - 1);
+        const auto& bytes = encodedArtifact.value();
+        auto rejected = limited.feed(bytes.data(), bytes.size());
+        require(rejected.isError(), "stream decoder: expected load limit rejection");
+    }
+
+    {
+        auto program = makeBytecodeProgram();
+        auto artifactRes = ir::makeEngineBytecodeArtifact(program, ".");
+        require(artifactRes.isOk(), "crc chunk artifact build failed: " + artifactRes.error());
+        auto encodedArtifact = ir::serializeArtifact(artifactRes.value());
+        require(encodedArtifact.isOk(), "crc chunk artifact encode failed: " + encodedArtifact.error());
+        auto chunks = chunkBytes(encodedArtifact.value(), 13);
+        require(chunks.size() >= 2, "crc chunk test expected >=2 chunks");
+
+        auto makeChunk = [&](size_t i, uint32_t crc) {
+            auto loadReq = makeMessage<protocol::LoadAutomataMessage>();
+            loadReq->runId = 50;
+            loadReq->format = protocol::AutomataFormat::Binary;
+            loadReq->replaceExisting = true;
+            loadReq->startAfterLoad = false;
+            loadReq->isChunked = true;
+            loadReq->chunkIndex = static_cast<uint16_t>(i);
+            loadReq->totalChunks = static_cast<uint16_t>(chunks.size());
+            loadReq->data = chunks[i];
+            loadReq->chunkCrc = crc;
+            return loadReq;
+        };
+
+        auto frame = makeChunk(0, aeth::crc32(chunks[0].data(), chunks[0].size()))->serialize();
+        auto decoded = protocol::MessageFactory::deserialize(frame);
+        auto* decodedLoad = dynamic_cast<protocol::LoadAutomataMessage*>(decoded.get());
+        require(decodedLoad != nullptr && decodedLoad->chunkCrc.has_value(), "crc chunk: CRC lost in roundtrip");
+
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            auto replies = send(engine, makeChunk(i, aeth::crc32(chunks[i].data(), chunks[i].size())));
+            if (i + 1 == chunks.size()) {
+                auto* loadAck = findMessage<protocol::LoadAckMessage>(replies);
+                require(loadAck != nullptr && loadAck->success, "crc chunk final: expected successful LoadAck");
+            }
+        }
+
+        auto replies = send(engine, makeChunk(0, aeth::crc32(chunks[0].data(), chunks[0].size()) ^ 1u));
+        auto* loadAck = findMessage<protocol::LoadAckMessage>(replies);
+        require(loadAck != nullptr && !loadAck->success, "crc chunk corrupt: expected failed LoadAck");
+    }
+
     {
         auto startReq = makeMessage<protocol::StartMessage>();
         startReq->runId = 44;
@@ -724,6 +848,63 @@ int main() {
         require(status->transitionCount >= 1, "status-classic-bytecode-after: expected transition");
     }
 
+    {
+        auto program = makeClassicConditionBytecodeProgram();
+        auto artifactRes = ir::makeEngineBytecodeArtifact(program, ".");
+        require(artifactRes.isOk(), "batch bytecode artifact build failed: " + artifactRes.error());
+        auto encodedArtifact = ir::serializeArtifact(artifactRes.value());
+        require(encodedArtifact.isOk(), "batch bytecode artifact encode failed: " + encodedArtifact.error());
+
+        auto loadReq = makeMessage<protocol::LoadAutomataMessage>();
+        loadReq->runId = 48;
+        loadReq->format = protocol::AutomataFormat::Binary;
+        loadReq->replaceExisting = true;
+        loadReq->startAfterLoad = true;
+        loadReq->data = encodedArtifact.value();
+        auto replies = send(engine, std::move(loadReq));
+        auto* loadAck = findMessage<protocol::LoadAckMessage>(replies);
+        require(loadAck != nullptr && loadAck->success, "batch bytecode load: expected successful LoadAck");
+    }
+
+    {
+        // An unknown id rejects the whole batch, so 'enabled' must stay false.
+        auto batchReq = makeMessage<protocol::InputBatchMessage>();
+        batchReq->runId = 48;
+        batchReq->inputs.push_back(aeth::VariableUpdate{1, aeth::Value(true)});
+        batchReq->inputs.push_back(aeth::VariableUpdate{99, aeth::Value(true)});
+        auto replies = send(engine, std::move(batchReq));
+        expectNak(replies, "input-batch unknown id");
+        auto* status = findMessage<protocol::StatusMessage>(replies);
+        require(status->transitionCount == 0, "input-batch unknown id: expected nothing applied");
+    }
+
+    {
+        protocol::InputBatchMessage batch;
+        batch.messageId = nextMessageId();
+        batch.runId = 48;
+        batch.inputs.push_back(aeth::VariableUpdate{1, aeth::Value(true)});
+        batch.inputs.push_back(aeth::VariableUpdate{2, aeth::Value(false)});
+        batch.inputs.push_back(aeth::VariableUpdate{2, aeth::Value(true)});
+        auto decoded = protocol::MessageFactory::deserialize(batch.serialize());
+        auto* decodedBatch = dynamic_cast<protocol::InputBatchMessage*>(decoded.get());
+        require(decodedBatch != nullptr, "input-batch roundtrip: expected InputBatchMessage");
+        require(decodedBatch->inputs.size() == 3 && decodedBatch->inputs[2].id == 2 &&
+                    decodedBatch->inputs[2].value == aeth::Value(true),
+                "input-batch roundtrip: entries mismatch");
+
+        // Last write wins for 'armed', and the batch costs a single tick.
+        auto replies = send(engine, std::move(decoded));
+        expectAckOnly(replies, "input-batch apply");
+
+        auto statusReq = makeMessage<protocol::StatusMessage>();
+        statusReq->runId = 48;
+        auto statusReplies = send(engine, std::move(statusReq));
+        auto* status = findMessage<protocol::StatusMessage>(statusReplies);
+        require(status != nullptr, "input-batch status: expected STATUS");
+        require(status->transitionCount == 1, "input-batch status: expected one transition");
+        require(status->tickCount == 1, "input-batch status: expected one tick for the batch");
+    }
+
     {
         auto program = makeEventBytecodeProgram();
         auto artifactRes = ir::makeEngineBytecodeArtifact(program, ".");
@@ -852,6 +1033,1148 @@ int main() {
         require(status->transitionCount >= 1, "status-event-threshold-bytecode-after: expected transition");
     }
 
+    {
+        Engine swapEngine;
+        require(swapEngine.initialize(init).isOk(), "hot swap engine initialize failed");
+        swapEngine.setHotSwapLoads(true);
+
+        auto loadBytecode = [&](aeth::RunId runId, const std::string& name) {
+            auto program = makeClassicConditionBytecodeProgram();
+            program.name = name;
+            auto artifactRes = ir::makeEngineBytecodeArtifact(program, ".");
+            require(artifactRes.isOk(), "hot swap artifact build failed: " + artifactRes.error());
+            auto encodedArtifact = ir::serializeArtifact(artifactRes.value());
+            require(encodedArtifact.isOk(), "hot swap artifact encode failed: " + encodedArtifact.error());
+
+            auto loadReq = makeMessage<protocol::LoadAutomataMessage>();
+            loadReq->runId = runId;
+            loadReq->format = protocol::AutomataFormat::Binary;
+            loadReq->replaceExisting = false;
+            loadReq->startAfterLoad = true;
+            loadReq->data = encodedArtifact.value();
+            auto replies = send(swapEngine, std::move(loadReq));
+            auto* loadAck = findMessage<protocol::LoadAckMessage>(replies);
+            require(loadAck != nullptr && loadAck->success, "hot swap load " + name + ": expected successful LoadAck");
+        };
+
+        loadBytecode(70, "Hot Swap v1");
+        require(!swapEngine.hotSwapPending(), "first load has nothing to swap with");
+        {
+            auto inputReq = makeMessage<protocol::InputMessage>();
+            inputReq->runId = 70;
+            inputReq->variableName = "enabled";
+            inputReq->value = aeth::Value(true);
+            expectAckOnly(send(swapEngine, std::move(inputReq)), "hot swap set-input enabled");
+        }
+        swapEngine.tick();
+
+        loadBytecode(71, "Hot Swap v2");
+        require(swapEngine.hotSwapPending(), "reload of a running engine should stage a hot swap");
+        for (int i = 0; i < 2000 && swapEngine.hotSwapPending(); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            swapEngine.tick();
+        }
+        require(!swapEngine.hotSwapPending(), "hot swap never applied");
+        require(swapEngine.isRunning(), "hot swap should not stop the runtime");
+        require(swapEngine.activeRunId() == 71, "hot swap should activate the new run id");
+
+        auto statusReq = makeMessage<protocol::StatusMessage>();
+        statusReq->runId = 71;
+        auto replies = send(swapEngine, std::move(statusReq));
+        auto* status = findMessage<protocol::StatusMessage>(replies);
+        require(status != nullptr, "hot swap status: expected STATUS");
+        const aeth::Value* enabled = findSnapshotValue(*status, "enabled");
+        require(enabled != nullptr && *enabled == aeth::Value(true), "hot swap should carry enabled over");
+
+        const auto& records = swapEngine.traceStore().records();
+        require(std::any_of(records.begin(), records.end(),
+                            [](const aeth::TraceRecord& record) { return record.kind == "hot_swap"; }),
+                "hot swap should record its latency in the trace");
+    }
+
+    {
+        auto program = makeClassicConditionBytecodeProgram();
+        auto indexed = ir::serializeIndexedBytecodeProgram(program);
+        require(indexed.isOk(), "indexed bytecode encode failed: " + indexed.error());
+
+        const auto& bytes = indexed.value();
+        auto mapped = ir::MappedBytecodeProgram::open(bytes.data(), bytes.size());
+        require(mapped.isOk(), "indexed bytecode open failed: " + mapped.error());
+        require(mapped.value().name == program.name, "indexed bytecode: name mismatch");
+        require(mapped.value().states.size() == 2 && mapped.value().states[1].name == "Running",
+                "indexed bytecode: states mismatch");
+        require(mapped.value().variables.size() == 2 && mapped.value().variables[1].name == "armed",
+                "indexed bytecode: variables mismatch");
+        const auto condition = mapped.value().transitions[0].conditionExpression;
+        require(condition == program.transitions[0].conditionExpression, "indexed bytecode: condition mismatch");
+        const auto* conditionBytes = reinterpret_cast<const uint8_t*>(condition.data());
+        require(conditionBytes >= bytes.data() && conditionBytes + condition.size() <= bytes.data() + bytes.size(),
+                "indexed bytecode: condition should be read in place");
+
+        auto truncated = ir::MappedBytecodeProgram::open(bytes.data(), bytes.size() - 1);
+        require(truncated.isError(), "indexed bytecode: truncated payload should be rejected");
+
+        auto artifactRes = ir::makeIndexedBytecodeArtifact(program, ".");
+        require(artifactRes.isOk(), "indexed artifact build failed: " + artifactRes.error());
+        auto encodedArtifact = ir::serializeArtifact(artifactRes.value());
+        require(encodedArtifact.isOk(), "indexed artifact encode failed: " + encodedArtifact.error());
+
+        const std::string path = "engine_command_smoke_indexed.aeth";
+        {
+            std::ofstream out(path, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(encodedArtifact.value().data()),
+                      static_cast<std::streamsize>(encodedArtifact.value().size()));
+        }
+
+        Engine mappedEngine;
+        require(mappedEngine.initialize(init).isOk(), "mapped engine initialize failed");
+        auto loaded = mappedEngine.loadAutomataFromFile(path, aeth::protocolv2::LoadReplaceMode::HardReset, true);
+        std::remove(path.c_str());
+        require(loaded.isOk(), "mapped artifact load failed: " + loaded.error());
+        require(mappedEngine.isRunning(), "mapped artifact should start after load");
+
+        for (const char* name : {"enabled", "armed"}) {
+            auto inputReq = makeMessage<protocol::InputMessage>();
+            inputReq->runId = loaded.value();
+            inputReq->variableName = name;
+            inputReq->value = aeth::Value(true);
+            expectAckOnly(send(mappedEngine, std::move(inputReq)), std::string("mapped set-input ") + name);
+        }
+        mappedEngine.tick();
+
+        auto statusReq = makeMessage<protocol::StatusMessage>();
+        statusReq->runId = loaded.value();
+        auto replies = send(mappedEngine, std::move(statusReq));
+        auto* status = findMessage<protocol::StatusMessage>(replies);
+        require(status != nullptr, "mapped artifact status: expected STATUS");
+        require(status->transitionCount >= 1, "mapped artifact guard should fire from mapped source");
+    }
+
+    {
+        // Chunks for another Lua layout must be ignored in favour of the sources
+        auto program = makeClassicConditionBytecodeProgram();
+        program.luaTarget = aeth::LuaChunkTarget{1, 2, 3, 4};
+        program.luaChunks.push_back(ir::BytecodeLuaChunk{ir::LuaChunkSlot::TransitionCondition, 1, {0x1B, 'L', 'u', 'a'}});
+        auto bytecode = ir::serializeEngineBytecodeProgram(program);
+        require(bytecode.isOk(), "lua chunk bytecode encode failed: " + bytecode.error());
+        auto decoded = ir::deserializeEngineBytecodeProgram(bytecode.value());
+        require(decoded.isOk(), "lua chunk bytecode decode failed: " + decoded.error());
+        require(decoded.value().versionMinor == ir::BYTECODE_LUA_CHUNKS_MINOR, "lua chunks should bump the minor version");
+        require(decoded.value().luaTarget == program.luaTarget, "lua chunk target mismatch");
+        require(decoded.value().luaChunks.size() == 1 &&
+                    decoded.value().luaChunks[0].bytes == program.luaChunks[0].bytes,
+                "lua chunk bytes mismatch");
+
+        auto runGate = [&](const ir::EngineBytecodeProgram& gateProgram, const std::string& label) {
+            auto artifactRes = ir::makeEngineBytecodeArtifact(gateProgram, ".");
+            require(artifactRes.isOk(), label + " artifact build failed: " + artifactRes.error());
+            auto encodedArtifact = ir::serializeArtifact(artifactRes.value());
+            require(encodedArtifact.isOk(), label + " artifact encode failed: " + encodedArtifact.error());
+
+            Engine chunkEngine;
+            require(chunkEngine.initialize(init).isOk(), label + " engine initialize failed");
+            auto loaded = chunkEngine.loadAutomataFromBytes(encodedArtifact.value(),
+                                                            aeth::protocolv2::LoadReplaceMode::HardReset, true);
+            require(loaded.isOk(), label + " load failed: " + loaded.error());
+            for (const char* name : {"enabled", "armed"}) {
+                auto inputReq = makeMessage<protocol::InputMessage>();
+                inputReq->runId = loaded.value();
+                inputReq->variableName = name;
+                inputReq->value = aeth::Value(true);
+                expectAckOnly(send(chunkEngine, std::move(inputReq)), label + " set-input " + name);
+            }
+            chunkEngine.tick();
+
+            auto statusReq = makeMessage<protocol::StatusMessage>();
+            statusReq->runId = loaded.value();
+            auto replies = send(chunkEngine, std::move(statusReq));
+            auto* status = findMessage<protocol::StatusMessage>(replies);
+            require(status != nullptr, label + " status: expected STATUS");
+            require(status->transitionCount >= 1, label + " guard should fire");
+        };
+        runGate(program, "mismatched lua chunk");
+
+#if !defined(AETHERIUM_DISABLE_LUA_SCRIPT_ENGINE)
+        auto precompiled = makeClassicConditionBytecodeProgram();
+        auto compiledRes = aeth::precompileLuaChunks(precompiled);
+        require(compiledRes.isOk(), "lua precompile failed: " + compiledRes.error());
+        require(precompiled.luaChunks.size() == 1 &&
+                    precompiled.luaChunks[0].slot == ir::LuaChunkSlot::TransitionCondition,
+                "lua precompile should dump the gate condition");
+        runGate(precompiled, "precompiled lua chunk");
+#endif
+    }
+
+    {
+        aeth::LocalTraceStore ring;
+        ring.setMaxRecords(3);
+        for (int i = 0; i < 5; ++i) {
+            aeth::TraceRecord record;
+            record.kind = "probe";
+            ring.push(std::move(record));
+        }
+        auto kept = ring.records();
+        require(kept.size() == 3 && kept.front().seq == 3 && kept.back().seq == 5,
+                "capped trace store should keep the newest records in order");
+        ring.setMaxRecords(2);
+        kept = ring.records();
+        require(kept.size() == 2 && kept.front().seq == 4 && ring.totalRecorded() == 5,
+                "shrinking the trace cap should keep the newest records");
+
+        const std::string binaryPath = "engine_command_smoke_trace.aetr";
+        const std::string jsonPath = "engine_command_smoke_trace.jsonl";
+        aeth::EngineInitOptions traceInit = init;
+        traceInit.traceOutputPath = binaryPath;
+        Engine traceEngine;
+        require(traceEngine.initialize(traceInit).isOk(), "trace engine initialize failed");
+        require(traceEngine.traceStore().streaming(), ".aetr trace path should stream a binary trace");
+
+        auto loadReq = makeMessage<protocol::LoadAutomataMessage>();
+        loadReq->runId = 81;
+        loadReq->format = protocol::AutomataFormat::Binary;
+        auto artifactRes = ir::makeEngineBytecodeArtifact(makeClassicConditionBytecodeProgram(), ".");
+        require(artifactRes.isOk(), "trace artifact build failed: " + artifactRes.error());
+        auto encodedArtifact = ir::serializeArtifact(artifactRes.value());
+        require(encodedArtifact.isOk(), "trace artifact encode failed: " + encodedArtifact.error());
+        loadReq->data = encodedArtifact.value();
+        loadReq->startAfterLoad = true;
+        send(traceEngine, std::move(loadReq));
+        for (const char* name : {"enabled", "armed"}) {
+            auto inputReq = makeMessage<protocol::InputMessage>();
+            inputReq->runId = 81;
+            inputReq->variableName = name;
+            inputReq->value = aeth::Value(true);
+            send(traceEngine, std::move(inputReq));
+        }
+        traceEngine.tick();
+        require(traceEngine.writeTrace().isOk(), "binary trace flush failed");
+
+        const auto inMemory = traceEngine.traceStore().records();
+        aeth::TraceBinaryReader reader;
+        require(reader.open(binaryPath).isOk(), "binary trace should open");
+        std::vector<aeth::TraceRecord> streamed;
+        aeth::TraceRecord record;
+        for (;;) {
+            auto more = reader.next(record);
+            require(more.isOk(), "binary trace read failed: " + more.error());
+            if (!more.value()) {
+                break;
+            }
+            streamed.push_back(record);
+        }
+        require(!streamed.empty() && streamed.size() == traceEngine.traceStore().totalRecorded(),
+                "binary trace should hold every record");
+        require(streamed.size() == inMemory.size(), "short run should fit the in-memory window");
+        for (size_t i = 0; i < streamed.size(); ++i) {
+            require(streamed[i].seq == inMemory[i].seq && streamed[i].kind == inMemory[i].kind &&
+                        streamed[i].summary == inMemory[i].summary &&
+                        streamed[i].sourceInstance == inMemory[i].sourceInstance &&
+                        streamed[i].runId == inMemory[i].runId &&
+                        streamed[i].faultActions == inMemory[i].faultActions,
+                    "binary trace record should round-trip");
+        }
+
+        auto converted = aeth::LocalTraceStore::convertBinaryToJsonLines(binaryPath, jsonPath);
+        require(converted.isOk() && converted.value() == streamed.size(),
+                "binary trace conversion failed: " + converted.error());
+        const std::string expectedPath = "engine_command_smoke_trace_expected.jsonl";
+        require(traceEngine.traceStore().writeJsonLines(expectedPath).isOk(), "jsonl trace write failed");
+        auto slurp = [](const std::string& path) {
+            std::ifstream in(path);
+            return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        };
+        const std::string convertedJson = slurp(jsonPath);
+        require(!convertedJson.empty() && convertedJson == slurp(expectedPath),
+                "converted trace should match the JSONL writer");
+        std::remove(binaryPath.c_str());
+        std::remove(jsonPath.c_str());
+        std::remove(expectedPath.c_str());
+    }
+
+    {
+        // Ping-pong between two states: every tick queues a state change
+        // and a transition-fired event.
+        ir::EngineBytecodeProgram program;
+        program.name = "Backpressure Runtime";
+        program.initialState = 1;
+        program.states.push_back(ir::BytecodeState{1, "A"});
+        program.states.push_back(ir::BytecodeState{2, "B"});
+        for (uint16_t id : {1, 2}) {
+            ir::BytecodeTransition flip;
+            flip.id = id;
+            flip.name = id == 1 ? "a_to_b" : "b_to_a";
+            flip.from = id;
+            flip.to = id == 1 ? 2 : 1;
+            flip.kind = ir::BytecodeTransitionKind::Immediate;
+            flip.enabled = true;
+            program.transitions.push_back(flip);
+        }
+        auto artifactRes = ir::makeEngineBytecodeArtifact(program, ".");
+        require(artifactRes.isOk(), "backpressure artifact build failed: " + artifactRes.error());
+        auto encodedArtifact = ir::serializeArtifact(artifactRes.value());
+        require(encodedArtifact.isOk(), "backpressure artifact encode failed: " + encodedArtifact.error());
+
+        Engine bpEngine;
+        require(bpEngine.initialize(init).isOk(), "backpressure engine initialize failed");
+        auto loadReq = makeMessage<protocol::LoadAutomataMessage>();
+        loadReq->runId = 90;
+        loadReq->format = protocol::AutomataFormat::Binary;
+        loadReq->replaceExisting = true;
+        loadReq->startAfterLoad = true;
+        loadReq->data = encodedArtifact.value();
+        auto loadReplies = send(bpEngine, std::move(loadReq));
+        auto* loadAck = findMessage<protocol::LoadAckMessage>(loadReplies);
+        require(loadAck != nullptr && loadAck->success, "backpressure load: expected successful LoadAck");
+
+        bpEngine.setEventQueueLimit(6);
+        bpEngine.setEventBackpressure(true);
+        for (int i = 0; i < 20; ++i) {
+            bpEngine.tick();
+        }
+        auto statusReq = makeMessage<protocol::StatusMessage>();
+        statusReq->runId = 90;
+        auto held = send(bpEngine, std::move(statusReq));
+        require(findMessage<protocol::StatusMessage>(held) != nullptr &&
+                    findMessage<protocol::StateChangeMessage>(held) == nullptr,
+                "backpressure: commands answered, events held");
+        require(bpEngine.pendingEventCount() == 6 && bpEngine.droppedEventCount() > 0,
+                "backpressure: queue should stay at its limit");
+
+        bpEngine.setEventBackpressure(false);
+        auto released = bpEngine.processCommandQueue();
+        const auto stateChanges = std::count_if(released.begin(), released.end(), [](const auto& msg) {
+            return msg && msg->type() == protocol::MessageType::StateChange;
+        });
+        require(released.size() == 6 && stateChanges == 6,
+                "backpressure: transition-fired events should be dropped before state changes");
+        require(bpEngine.pendingEventCount() == 0, "backpressure: release should drain the queue");
+    }
+
+    {
+        // Folder layout large enough to take the parallel read path
+        namespace fs = std::filesystem;
+        const fs::path dir = fs::temp_directory_path() / "aeth_folder_parse_smoke";
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        const int stateCount = 12;
+        std::string yaml = "version: 0.0.1\nconfig:\n  name: folder smoke\n  type: folder\n"
+                           "automata:\n  initial_state: S0\n  states:\n";
+        for (int i = 0; i < stateCount; ++i) {
+            yaml += "    S" + std::to_string(i) + ":\n      outputs: [out]\n";
+            std::ofstream(dir / ("S" + std::to_string(i) + ".lua")) << "function on_enter() setVal(\"out\", " << i
+                                                                     << ") end\n";
+        }
+        yaml += "  transitions:\n";
+        for (int i = 0; i < stateCount; ++i) {
+            yaml += "    T" + std::to_string(i) + ":\n      from: S" + std::to_string(i) + "\n      to: S" +
+                    std::to_string((i + 1) % stateCount) + "\n";
+            if (i != 3 && i != 7) {
+                std::ofstream(dir / ("T" + std::to_string(i) + ".lua")) << "function condition() return true end\n";
+            }
+        }
+        std::ofstream(dir / "project.yaml") << yaml;
+        std::ofstream(dir / "copy.yaml") << yaml;
+
+        aeth::AutomataParser parser;
+        auto single = parser.parseFile((dir / "project.yaml").string());
+        require(single.errors.size() == 2 && single.errors[0].find("T3.lua") != std::string::npos &&
+                    single.errors[1].find("T7.lua") != std::string::npos,
+                "folder parse: missing files should be reported in transition order");
+
+        std::ofstream(dir / "T3.lua") << "function condition() return true end\n";
+        std::ofstream(dir / "T7.lua") << "function condition() return true end\n";
+        single = parser.parseFile((dir / "project.yaml").string());
+        require(single.success(), "folder parse: expected success once every file exists");
+
+        auto batch = parser.parseFiles({(dir / "project.yaml").string(), (dir / "copy.yaml").string(),
+                                        (dir / "absent.yaml").string()},
+                                       3);
+        require(batch.size() == 3 && batch[0].success() && batch[1].success(),
+                "folder parse: batch results should come back in input order");
+        require(!batch[2].success() && batch[2].errors.front().find("absent.yaml") != std::string::npos,
+                "folder parse: a missing batch file fails only its own result");
+        for (const auto* parsed : {batch[0].automata.get(), batch[1].automata.get()}) {
+            require(parsed->states.size() == single.automata->states.size() &&
+                        parsed->transitions.size() == single.automata->transitions.size(),
+                    "folder parse: batch should match the single-file parse");
+            for (const auto& [id, state] : single.automata->states) {
+                auto it = parsed->states.find(id);
+                require(it != parsed->states.end() && it->second.name == state.name &&
+                            it->second.onEnter.source == state.onEnter.source,
+                        "folder parse: ids and code should not depend on the worker");
+            }
+        }
+        fs::remove_all(dir);
+    }
+
+    {
+        // Incremental reload: only the edited entries are parsed again
+        aeth::AutomataLoader loader;
+        loader.setIncremental(true);
+        std::string yaml(kYaml);
+        auto first = loader.loadFromString(yaml, ".");
+        require(first.isOk(), "incremental: first load failed: " + first.error());
+        const auto cold = loader.lastParseStats();
+        require(cold.parsedStates == first.value().automata->states.size() && cold.reusedStates == 0,
+                "incremental: a cold cache should parse every state");
+
+        auto same = loader.loadFromString(yaml, ".");
+        require(same.isOk() && loader.lastParseStats().documentReused,
+                "incremental: an unchanged document should be reused whole");
+
+        const std::string before = "log(\"debug\", \"armed\")";
+        const auto at = yaml.find(before);
+        require(at != std::string::npos, "incremental: fixture should contain the armed log");
+        yaml.replace(at, before.size(), "log(\"debug\", \"armed again\")");
+        auto edited = loader.loadFromString(yaml, ".");
+        require(edited.isOk(), "incremental: edited load failed: " + edited.error());
+        const auto warm = loader.lastParseStats();
+        require(!warm.documentReused && warm.parsedStates == 1 &&
+                    warm.reusedStates == first.value().automata->states.size() - 1 && warm.parsedTransitions == 0,
+                "incremental: only the edited state should be parsed");
+
+        aeth::AutomataLoader full;
+        auto reference = full.loadFromString(yaml, ".");
+        require(reference.isOk(), "incremental: reference load failed");
+        const auto& got = *edited.value().automata;
+        const auto& want = *reference.value().automata;
+        require(got.states.size() == want.states.size() && got.transitions.size() == want.transitions.size() &&
+                    got.variables.size() == want.variables.size() && got.initialState == want.initialState,
+                "incremental: shape should match a full parse");
+        for (const auto& [id, state] : want.states) {
+            auto it = got.states.find(id);
+            require(it != got.states.end() && it->second.name == state.name &&
+                        it->second.onEnter.source == state.onEnter.source &&
+                        it->second.inputIds == state.inputIds && it->second.outputIds == state.outputIds,
+                    "incremental: state " + state.name + " should match a full parse");
+        }
+        for (const auto& [id, transition] : want.transitions) {
+            auto it = got.transitions.find(id);
+            require(it != got.transitions.end() && it->second.name == transition.name &&
+                        it->second.from == transition.from && it->second.to == transition.to,
+                    "incremental: transition " + transition.name + " should match a full parse");
+        }
+    }
+
+    {
+        const std::string path = "engine_command_smoke_validation.cache";
+        const std::string yamlPath = "engine_command_smoke_validation.yaml";
+        std::ofstream(yamlPath) << kYaml;
+        auto fingerprint = aeth::ValidationCache::fingerprint(yamlPath);
+        require(fingerprint.isOk(), "validation cache: fingerprint failed");
+
+        aeth::ValidationCache cache(path);
+        require(cache.load().isOk(), "validation cache: a missing file is an empty cache");
+        aeth::ValidationCache::Verdict verdict;
+        verdict.fingerprint = fingerprint.value();
+        verdict.valid = false;
+        verdict.errors.push_back("first\nsecond");
+        cache.store(yamlPath, verdict);
+        require(cache.save().isOk(), "validation cache: save failed");
+
+        aeth::ValidationCache reloaded(path);
+        require(reloaded.load().isOk(), "validation cache: load failed");
+        const auto* hit = reloaded.find(yamlPath, fingerprint.value());
+        require(hit != nullptr && !hit->valid && hit->errors.size() == 1 && hit->errors.front() == "first second",
+                "validation cache: verdict should survive a round trip");
+        require(reloaded.find(yamlPath, fingerprint.value() + 1) == nullptr,
+                "validation cache: a changed fingerprint should miss");
+
+        std::ofstream(yamlPath, std::ios::app) << "\n# edited\n";
+        auto changed = aeth::ValidationCache::fingerprint(yamlPath);
+        require(changed.isOk() && changed.value() != fingerprint.value(),
+                "validation cache: editing the file should change its fingerprint");
+        std::remove(path.c_str());
+        std::remove(yamlPath.c_str());
+    }
+
+    {
+        // Virtual time: a day of hour-long timers in a few hundred ticks
+        const char* simYaml = R"YAML(
+version: 0.0.1
+config:
+  name: Simulation Smoke
+  type: inline
+variables:
+  - name: enabled
+    type: bool
+    direction: input
+    default: false
+  - name: cycles
+    type: int
+    direction: output
+    default: 0
+automata:
+  initial_state: Idle
+  states:
+    Idle: {}
+    Heating:
+      on_enter: |
+        setVal("cycles", value("cycles") + 1)
+  transitions:
+    start:
+      from: Idle
+      to: Heating
+      type: classic
+      condition: value("enabled")
+    cool:
+      from: Heating
+      to: Idle
+      type: timed
+      after: 3600000
+)YAML";
+        auto timeline = aeth::InputTimeline::parse("# warm up, then stop mid-cycle\n0 enabled true\n150m enabled false\n");
+        require(timeline.isOk() && timeline.value().events().size() == 2, "simulation: timeline should parse");
+        require(aeth::InputTimeline::parse("soon enabled true").isError(), "simulation: bad times are rejected");
+
+        auto clockOwner = std::make_unique<aeth::VirtualClock>();
+        aeth::VirtualClock& clock = *clockOwner;
+        Engine simEngine(std::move(clockOwner), std::make_unique<aeth::StdRandomSource>(7),
+                         aeth::makeDefaultScriptEngine());
+        aeth::EngineInitOptions options;
+        options.virtualTime = true;
+        require(simEngine.initialize(options).isOk(), "simulation: initialize failed");
+        auto load = simEngine.loadAutomataFromYaml(simYaml, ".", aeth::protocolv2::LoadReplaceMode::HardReset, true);
+        require(load.isOk(), "simulation: load failed: " + (load.isError() ? load.error() : std::string()));
+
+        aeth::SimulationOptions simOptions;
+        simOptions.durationMs = 24ull * 60 * 60 * 1000;
+        auto report = aeth::runSimulation(simEngine, clock, timeline.value(), simOptions);
+        require(report.isOk(), "simulation: run failed");
+        const auto status = simEngine.status();
+        require(report.value().endMs == simOptions.durationMs && report.value().inputsApplied == 2,
+                "simulation: should reach the end of the day with both inputs applied");
+        require(status.transitionCount == 6 && simEngine.variables().getValue("cycles") == aeth::Value(int32_t{3}),
+                "simulation: three heating cycles should run before the input drops");
+        require(report.value().ticks < 1000, "simulation: idle stretches should be skipped, not ticked");
+        require(simEngine.eventTimeMs() == clock.now(), "simulation: events should be stamped in virtual time");
+
+        aeth::InputTimeline typo;
+        typo.add(aeth::TimelineEvent{0, "missing", "1", 1});
+        require(aeth::runSimulation(simEngine, clock, typo).isError(), "simulation: unknown variables are rejected");
+    }
+
+    {
+        // Monte-Carlo: seeded parallel runs, merged in run order
+        const std::string path = "engine_command_smoke_monte_carlo.yaml";
+        std::ofstream(path) << R"YAML(
+version: 0.0.1
+config:
+  name: Monte Carlo Smoke
+  type: inline
+automata:
+  initial_state: Choose
+  states:
+    Choose: {}
+    PathA: {}
+    PathB: {}
+  transitions:
+    to_a:
+      from: Choose
+      to: PathA
+      type: probabilistic
+      probabilistic:
+        weight: 70
+    to_b:
+      from: Choose
+      to: PathB
+      type: probabilistic
+      probabilistic:
+        weight: 30
+    a_back:
+      from: PathA
+      to: Choose
+      type: timed
+      timed:
+        mode: after
+        delay_ms: 1000
+    b_back:
+      from: PathB
+      to: Choose
+      type: timed
+      timed:
+        mode: after
+        delay_ms: 1000
+)YAML";
+        aeth::MonteCarloOptions options;
+        options.runs = 200;
+        options.workers = 3;
+        options.baseSeed = 42;
+        options.simulation.durationMs = 10000;
+        auto parallel = aeth::runMonteCarlo(path, {}, options);
+        require(parallel.isOk(), "monte carlo: run failed");
+        options.workers = 1;
+        auto serial = aeth::runMonteCarlo(path, {}, options);
+        require(serial.isOk(), "monte carlo: serial run failed");
+        std::remove(path.c_str());
+
+        const auto& report = parallel.value();
+        const auto* choose = report.findState("Choose");
+        const auto* a = report.findState("PathA");
+        const auto* b = report.findState("PathB");
+        require(report.runs == 200 && report.failedRuns == 0 && choose && a && b,
+                "monte carlo: every run should finish and every state be reported");
+        require(choose->runsVisited == 200 && choose->firstMaxMs == 0,
+                "monte carlo: every run starts in the initial state");
+        require(a->visits + b->visits > 1000 && a->visits > 2 * b->visits && b->visits > 0,
+                "monte carlo: branch visits should follow the 70/30 weights");
+        require(a->firstMinMs == 0 && a->firstP90Ms >= a->firstP50Ms && a->firstMaxMs >= 1000,
+                "monte carlo: time to first entry should spread over the runs");
+        for (size_t i = 0; i < report.states.size(); ++i) {
+            require(report.states[i].visits == serial.value().states[i].visits &&
+                        report.states[i].firstP90Ms == serial.value().states[i].firstP90Ms,
+                    "monte carlo: the report should not depend on the worker count");
+        }
+        require(aeth::runMonteCarlo("missing.yaml", {}, options).isError(),
+                "monte carlo: a missing automaton is an error");
+        options.simulation.durationMs = 0;
+        require(aeth::runMonteCarlo(path, {}, options).isError(), "monte carlo: runs without a limit are refused");
+    }
+
+    {
+        // Columnar trace queries over a streamed binary trace
+        const std::string queryPath = "engine_command_smoke_query.aetr";
+        aeth::LocalTraceStore store;
+        require(store.streamBinary(queryPath).isOk(), "trace query: binary stream should open");
+        auto push = [&store](const std::string& kind, aeth::RunId run, aeth::Timestamp at,
+                             std::optional<uint32_t> latency, std::optional<bool> exceeded,
+                             std::optional<std::string> state, std::vector<std::string> faults) {
+            aeth::TraceRecord record;
+            record.kind = kind;
+            record.messageType = run == 1 ? "input" : "output";
+            record.sourceInstance = "edge";
+            record.transport = run == 1 ? "ws" : "shm";
+            record.placement = "host";
+            record.runId = run;
+            record.handleTimestamp = at;
+            record.observedLatencyMs = latency;
+            record.latencyBudgetExceeded = exceeded;
+            record.observableState = std::move(state);
+            record.faultActions = std::move(faults);
+            store.push(std::move(record));
+        };
+        for (uint32_t i = 0; i < 100; ++i) {
+            push("message_handled", 1, 1000 + i, i, i >= 90, std::nullopt,
+                 i % 10 == 0 ? std::vector<std::string>{"delay"} : std::vector<std::string>{});
+        }
+        for (uint32_t i = 0; i < 10; ++i) {
+            push("message_handled", 2, 1000 + i, 5, false, std::nullopt, {});
+        }
+        // Run 1: Idle 100 ms, Busy 30 ms (then a state that is not observable), Idle 50 ms, Busy still open
+        push("runtime_state_change", 1, 0, std::nullopt, std::nullopt, "Idle", {});
+        push("runtime_state_change", 1, 100, std::nullopt, std::nullopt, "Busy", {});
+        push("message_sent", 1, 100, std::nullopt, std::nullopt, "Busy", {});
+        push("runtime_state_change", 1, 130, std::nullopt, std::nullopt, std::nullopt, {});
+        push("runtime_state_change", 1, 200, std::nullopt, std::nullopt, "Idle", {});
+        push("runtime_state_change", 1, 250, std::nullopt, std::nullopt, "Busy", {});
+        // Run 2: Idle 40 ms
+        push("runtime_state_change", 2, 0, std::nullopt, std::nullopt, "Idle", {});
+        push("runtime_state_change", 2, 40, std::nullopt, std::nullopt, "Busy", {});
+        require(store.flushStream().isOk(), "trace query: binary stream should flush");
+        store.closeStream();
+
+        aeth::TraceQueryOptions options;
+        options.workers = 4;
+        options.chunkRecords = 7;
+        auto analyzed = aeth::analyzeTraceFile(queryPath, options);
+        require(analyzed.isOk(), "trace query: analysis failed: " + analyzed.error());
+        const auto& report = analyzed.value();
+        require(report.records == 118, "trace query: every record should load");
+
+        const auto* input = report.findLatency("input");
+        const auto* output = report.findLatency("output");
+        require(input && input->samples == 100 && input->minMs == 0 && input->p50Ms == 50 && input->p99Ms == 98 &&
+                    input->maxMs == 99 && output && output->samples == 10 && output->p90Ms == 5,
+                "trace query: latency percentiles per message type");
+        require(report.budget.size() == 2 && report.budget[0].transport == "shm" &&
+                    report.budget[0].judged == 10 && report.budget[0].exceeded == 0 &&
+                    report.budget[1].transport == "ws" && report.budget[1].judged == 100 &&
+                    report.budget[1].exceeded == 10,
+                "trace query: budget verdicts by placement and transport");
+
+        const auto* idle = report.findDwell("Idle");
+        const auto* busy = report.findDwell("Busy");
+        require(idle && idle->visits == 3 && idle->minMs == 40 && idle->p50Ms == 50 && idle->maxMs == 100 &&
+                    busy && busy->visits == 1 && busy->maxMs == 30,
+                "trace query: dwell ends at the next state change of the same run");
+
+        const auto* delay = report.findFault("delay");
+        require(delay && delay->records == 10 && delay->latencySamples == 10 && delay->meanLatencyMs == 45.0 &&
+                    delay->exceeded == 1 && report.withoutFaults.records == 108 &&
+                    report.withoutFaults.latencySamples == 100 && report.withoutFaults.exceeded == 9,
+                "trace query: fault-action impact against the records without one");
+
+        options.workers = 1;
+        options.chunkRecords = 1 << 16;
+        auto serial = aeth::analyzeTraceFile(queryPath, options);
+        require(serial.isOk() && serial.value().summary() == report.summary(),
+                "trace query: the report should not depend on workers or chunking");
+        std::remove(queryPath.c_str());
+
+        {
+            std::ofstream truncated(queryPath, std::ios::binary | std::ios::trunc);
+            truncated << "AETHTR01" << '\x02' << '\x32';
+        }
+        require(aeth::analyzeTraceFile(queryPath).isError(), "trace query: a truncated frame is an error");
+        std::remove(queryPath.c_str());
+        require(aeth::loadTraceColumns("missing.aetr").isError(), "trace query: a missing trace is an error");
+    }
+
+    {
+        // Checkpoints: a ring of periodic runtime checkpoints to seek back to
+        const char* checkpointYaml = R"YAML(
+version: 0.0.1
+config:
+  name: Checkpoint Smoke
+  type: inline
+automata:
+  initial_state: Choose
+  states:
+    Choose: {}
+    Away: {}
+  transitions:
+    leave:
+      from: Choose
+      to: Away
+      type: probabilistic
+      probabilistic:
+        weight: 100
+    back:
+      from: Away
+      to: Choose
+      type: timed
+      timed:
+        mode: after
+        delay_ms: 250
+)YAML";
+        auto clockOwner = std::make_unique<aeth::VirtualClock>();
+        aeth::VirtualClock& clock = *clockOwner;
+        Engine cpEngine(std::move(clockOwner), std::make_unique<aeth::StdRandomSource>(3),
+                        aeth::makeDefaultScriptEngine());
+        aeth::EngineInitOptions options;
+        options.virtualTime = true;
+        options.checkpointEveryTicks = 20;
+        options.checkpointCapacity = 4;
+        require(cpEngine.initialize(options).isOk(), "checkpoint: initialize failed");
+        auto load =
+            cpEngine.loadAutomataFromYaml(checkpointYaml, ".", aeth::protocolv2::LoadReplaceMode::HardReset, true);
+        require(load.isOk() && cpEngine.start().isOk(), "checkpoint: load failed");
+
+        aeth::SimulationOptions simOptions;
+        simOptions.durationMs = 10000;
+        simOptions.skipIdleTicks = false;
+        require(aeth::runSimulation(cpEngine, clock, {}, simOptions).isOk(), "checkpoint: run failed");
+        const auto& ring = cpEngine.checkpoints();
+        require(ring.size() == 4, "checkpoint: the ring should stay at its capacity");
+
+        const aeth::Timestamp oldest = ring.entries().front().at;
+        const aeth::Timestamp middle = ring.entries()[1].at;
+        const uint64_t middleTicks = ring.entries()[1].tickCount;
+        require(cpEngine.seekToCheckpoint(oldest - 1).isError(), "checkpoint: evicted times cannot be sought");
+        auto seek = cpEngine.seekToCheckpoint(middle + 1);
+        require(seek.isOk() && seek.value() == middle, "checkpoint: seek should land on the nearest earlier checkpoint");
+        require(ring.size() == 2 && cpEngine.isRunning() && cpEngine.status().tickCount == middleTicks,
+                "checkpoint: seeking restores the run and forgets the later checkpoints");
+    }
+
+    {
+        // Trace observer: every record, as it is recorded
+        uint64_t observed = 0;
+        const uint64_t before = engine.traceStore().totalRecorded();
+        engine.setTraceObserver([&observed](const aeth::TraceRecord&) { ++observed; });
+        auto replies = send(engine, makeMessage<protocol::PingMessage>());
+        engine.setTraceObserver(nullptr);
+        require(!replies.empty() && observed > 0 && observed == engine.traceStore().totalRecorded() - before,
+                "trace observer should see each new record");
+    }
+
+    {
+        // One drained batch: replies keep command order, unknown types fall to the default handler
+        engine.enqueueCommand(makeMessage<protocol::PingMessage>());
+        auto unknown = makeMessage<protocol::RawMessage>();
+        unknown->rawType = static_cast<protocol::MessageType>(0xEE);
+        const uint32_t unknownId = unknown->messageId;
+        engine.enqueueCommand(std::move(unknown));
+        engine.enqueueCommand(makeMessage<protocol::StatusMessage>());
+        auto replies = engine.processCommandQueue();
+        std::vector<protocol::MessageType> order;
+        for (const auto& reply : replies) {
+            if (reply->type() == protocol::MessageType::Pong || reply->type() == protocol::MessageType::Nak) {
+                order.push_back(reply->type());
+            }
+        }
+        const auto* nak = findMessage<protocol::NakMessage>(replies);
+        require(order.size() == 2 && order[0] == protocol::MessageType::Pong &&
+                    order[1] == protocol::MessageType::Nak,
+                "batch: replies should follow command order");
+        require(nak && nak->relatedMessageId == unknownId, "batch: unknown types should be NAKed");
+        std::size_t statuses = 0;
+        for (const auto& reply : replies) {
+            statuses += reply->type() == protocol::MessageType::Status ? 1 : 0;
+        }
+        require(statuses == 3, "batch: ping, nak and status each carry a status snapshot");
+    }
+
+    {
+        // Priority lanes: control jumps an input flood, inputs stay within their budget
+        const size_t inputBudget = engine.laneBudget(aeth::CommandLane::Input);
+        engine.setLaneBudget(aeth::CommandLane::Input, 2);
+        for (int i = 0; i < 5; ++i) {
+            auto input = makeMessage<protocol::InputMessage>();
+            input->variableId = 0xFFFE;
+            engine.enqueueCommand(std::move(input));
+        }
+        engine.enqueueCommand(makeMessage<protocol::StatusMessage>());
+        auto replies = engine.processCommandQueue();
+        require(!replies.empty() && replies.front()->type() == protocol::MessageType::Status,
+                "lanes: the control command should be answered first");
+        size_t naks = 0;
+        for (const auto& reply : replies) {
+            naks += reply->type() == protocol::MessageType::Nak ? 1 : 0;
+        }
+        require(naks == 2 && engine.pendingCommandCount(aeth::CommandLane::Input) == 3,
+                "lanes: inputs past the budget should wait for the next call");
+        require(engine.nextReleaseAt().has_value(), "lanes: a held backlog should ask for a wake-up");
+        engine.setLaneBudget(aeth::CommandLane::Input, inputBudget);
+        engine.processCommandQueue();
+        require(engine.pendingCommandCount(aeth::CommandLane::Input) == 0, "lanes: the backlog should drain");
+    }
+
+    {
+        // A folder-layout guard is a statement block; --compile-artifact must keep it one
+        aeth::Automata automata;
+        automata.config.name = "statement-guard";
+        automata.addVariable(aeth::VariableSpec(1, "level", aeth::ValueType::Int32,
+                                                aeth::VariableDirection::Input, aeth::Value(0)));
+        automata.addState(aeth::State(1, "Idle"));
+        automata.addState(aeth::State(2, "High"));
+        automata.initialState = 1;
+        aeth::Transition up(1, "up", 1, 2);
+        up.type = aeth::TransitionType::Classic;
+        up.classicConfig.condition.source = "local hot = level > 10\nif hot then return true end\nreturn false";
+        up.classicConfig.condition.kind = aeth::CodeKind::Statement;
+        automata.addTransition(up);
+
+        auto artifact = aeth::compileDeployArtifact(automata);
+        require(artifact.isOk(), "statement guard: compile failed: " + artifact.error());
+        Engine guarded;
+        require(guarded.initialize(aeth::EngineInitOptions{}).isOk(), "statement guard: engine initialize failed");
+        auto loaded = guarded.loadAutomataFromArtifact(artifact.value(), aeth::protocolv2::LoadReplaceMode::HardReset, true);
+        require(loaded.isOk(), "statement guard: artifact load failed: " + loaded.error());
+        guarded.tick();
+        require(guarded.status().currentState == 1, "statement guard: should hold while level is low");
+        require(guarded.setInput("level", aeth::Value(12)).isOk(), "statement guard: set level failed");
+        guarded.tick();
+        require(guarded.status().currentState == 2 && guarded.status().errorCount == 0,
+                "statement guard: should fire as a statement after the artifact round trip");
+    }
+
+#ifndef _WIN32
+    {
+        const std::string linkName = "aeth-smoke-" + std::to_string(::getpid());
+        aeth::SharedMemoryTransport creator(linkName, 4096);
+        aeth::SharedMemoryTransport peer(linkName);
+        creator.setSendHello(false);
+        peer.setSendHello(false);
+        require(creator.connect().isOk() && peer.connect().isOk(), "shm: both sides should connect");
+        require(creator.isCreator() && !peer.isCreator() && creator.peerAttached(),
+                "shm: the second side should attach to the first one's segment");
+
+        auto status = makeMessage<protocol::StatusMessage>();
+        status->messageId = 41;
+        require(creator.send(std::move(status)), "shm: send should fit the ring");
+        require(peer.waitForMessage(std::chrono::milliseconds(100)), "shm: the peer should be woken");
+        auto received = peer.receive();
+        require(received && received->type() == protocol::MessageType::Status && received->messageId == 41,
+                "shm: the frame should arrive intact");
+
+        // Enough traffic to wrap the 4 KiB ring several times
+        for (uint32_t i = 0; i < 200; ++i) {
+            auto reply = makeMessage<protocol::StatusMessage>();
+            reply->messageId = 100 + i;
+            require(peer.send(std::move(reply)), "shm: reply should fit the ring");
+            auto echoed = creator.receive();
+            require(echoed && echoed->messageId == 100 + i, "shm: frames should survive wrap-around");
+        }
+
+        // Rewrite a queued frame's length prefix past what is queued
+        const int fd = ::shm_open(("/" + linkName).c_str(), O_RDWR, 0);
+        require(fd >= 0, "shm: the segment should reopen");
+        struct stat segmentStat {};
+        require(::fstat(fd, &segmentStat) == 0, "shm: the segment should stat");
+        const size_t segmentBytes = static_cast<size_t>(segmentStat.st_size);
+        void* segment = ::mmap(nullptr, segmentBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        require(segment != MAP_FAILED, "shm: the segment should map");
+        // Ring 0 (creator -> attached) follows the one-cache-line segment header
+        auto& ring = *reinterpret_cast<aeth::ShmRing*>(static_cast<uint8_t*>(segment) + 64);
+        require(creator.send(makeMessage<protocol::StatusMessage>()), "shm: send should fit the ring");
+        const uint64_t tail = ring.tail.load();
+        const uint8_t oversized[4] = {0xF0, 0xFF, 0xFF, 0x0F};
+        for (size_t i = 0; i < sizeof(oversized); ++i) {
+            ring.data()[(tail + i) & (4096 - 1)] = oversized[i];
+        }
+        require(!peer.receive() && peer.state() == aeth::TransportState::Error,
+                "shm: a length past the queued bytes should fail the link");
+        require(ring.tail.load() == tail && !peer.hasMessage(),
+                "shm: the corrupt frame should not be consumed");
+        ::munmap(segment, segmentBytes);
+
+        peer.disconnect();
+        require(!creator.peerAttached(), "shm: detaching should be visible to the other side");
+        creator.disconnect();
+    }
+
+    {
+        // Source's over_temp drives sink's door_open over a shared-memory peer link
+        auto makeEngine = [](aeth::DeviceId id) {
+            auto engine = std::make_unique<Engine>();
+            aeth::EngineInitOptions options;
+            options.deviceId = id;
+            require(engine->initialize(options).isOk(), "peer: engine initialize failed");
+            engine->setPeerTransportFactory([](const std::string& endpoint) -> std::unique_ptr<aeth::ITransport> {
+                auto link = std::make_unique<aeth::SharedMemoryTransport>(endpoint.substr(6), 4096);
+                link->setSendHello(false);
+                return link;
+            });
+            auto load = makeMessage<protocol::LoadAutomataMessage>();
+            load->format = protocol::AutomataFormat::YAML;
+            load->startAfterLoad = true;
+            load->data.assign(kYaml, kYaml + std::char_traits<char>::length(kYaml));
+            auto replies = send(*engine, std::move(load));
+            auto* ack = findMessage<protocol::LoadAckMessage>(replies);
+            require(ack && ack->success, "peer: load failed");
+            return engine;
+        };
+        auto source = makeEngine(11);
+        auto sink = makeEngine(12);
+
+        auto wiring = [] {
+            auto msg = makeMessage<protocol::PeerWiringMessage>();
+            msg->wires.push_back(protocol::PeerWire{
+                11, "over_temp", 12, "door_open", "shm://aeth-peer-" + std::to_string(::getpid())});
+            return msg;
+        };
+        const auto encoded = wiring()->serialize();
+        auto roundTrip = protocol::PeerWiringMessage::deserialize(encoded.data(), encoded.size());
+        require(roundTrip && roundTrip->wires.size() == 1 && roundTrip->wires[0].targetPort == "door_open",
+                "peer: wiring table should round-trip");
+        require(findMessage<protocol::AckMessage>(send(*source, wiring())) != nullptr, "peer: source should accept wiring");
+        require(findMessage<protocol::AckMessage>(send(*sink, wiring())) != nullptr, "peer: sink should accept wiring");
+        require(source->peerLinks().routeCount() == 1 && sink->peerLinks().routeCount() == 0 &&
+                    sink->peerLinks().linkCount() == 1,
+                "peer: each end should keep its side of the wire");
+
+        Engine::Replies toServer;
+        auto input = [&](const char* name, aeth::Value value) {
+            auto msg = makeMessage<protocol::InputMessage>();
+            msg->variableName = name;
+            msg->value = value;
+            auto replies = send(*source, std::move(msg));
+            std::move(replies.begin(), replies.end(), std::back_inserter(toServer));
+        };
+        input("sensor_temp", aeth::Value(int32_t{70}));
+        source->tick();
+        input("door_open", aeth::Value(true));
+        source->tick();
+        auto flushed = source->processCommandQueue();
+        std::move(flushed.begin(), flushed.end(), std::back_inserter(toServer));
+
+        require(source->variables().getValue("over_temp") == aeth::Value(true), "peer: source should latch");
+        require(source->peerLinks().forwardedCount() >= 1, "peer: the change should go to the sink");
+        require(sink->pollPeerLinks(16) >= 1, "peer: the sink should receive the input");
+        require(sink->variables().getValue("door_open") == aeth::Value(true), "peer: the sink input should follow");
+
+        bool serverSawWired = false;
+        bool serverSawUnwired = false;
+        for (const auto& message : toServer) {
+            if (message && message->type() == protocol::MessageType::Output) {
+                const auto& output = static_cast<const protocol::OutputMessage&>(*message);
+                serverSawWired = serverSawWired || output.variableName == "over_temp";
+                serverSawUnwired = serverSawUnwired || output.variableName == "latch_count";
+            }
+        }
+        require(!serverSawWired && serverSawUnwired,
+                "peer: with sampleEvery 0 only unwired outputs should reach the server");
+    }
+#endif
+
+#if defined(__linux__)
+    {
+        // A bound but non-listening port refuses connections
+        const int blocker = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addrLength = sizeof(addr);
+        require(::bind(blocker, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0 &&
+                    ::getsockname(blocker, reinterpret_cast<sockaddr*>(&addr), &addrLength) == 0,
+                "epoll ws: bind a probe port");
+
+        aeth::IoEventLoop loop(2);
+        aeth::EpollWebSocketTransport refused(
+            "ws://127.0.0.1:" + std::to_string(ntohs(addr.sin_port)) + "/socket", loop);
+        aeth::EpollWebSocketTransport secure("wss://127.0.0.1/socket", loop);
+        require(secure.connect().isError(), "epoll ws: wss:// should be rejected");
+
+        const auto started = std::chrono::steady_clock::now();
+        require(refused.connect().isOk(), "epoll ws: connect should only start the attempt");
+        require(std::chrono::steady_clock::now() - started < std::chrono::milliseconds(100),
+                "epoll ws: connect should not block the caller");
+        for (int i = 0; i < 100 && refused.reconnects() == 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        require(refused.reconnects() > 0 && !refused.isConnected(), "epoll ws: refusals should back off and retry");
+        require(!refused.send(makeMessage<protocol::StatusMessage>()), "epoll ws: sends should fail while down");
+        require(!refused.waitForMessage(std::chrono::milliseconds(10)), "epoll ws: nothing should arrive");
+        refused.disconnect();
+        require(refused.state() == aeth::TransportState::Disconnected, "epoll ws: disconnect should stop retrying");
+        ::close(blocker);
+    }
+#endif
+
+    {
+        // Output telemetry: `level` goes up once per 100 ms window, `echo` past a deadband
+        const char* shapedYaml = R"YAML(
+version: 0.0.1
+config:
+  name: Telemetry Smoke
+  type: inline
+variables:
+  - name: raw
+    type: double
+    direction: input
+    default: 0
+  - name: level
+    type: double
+    direction: output
+    default: 0
+    telemetry:
+      window_ms: 100
+  - name: echo
+    type: double
+    direction: output
+    default: 0
+    telemetry:
+      deadband: 1.0
+automata:
+  initial_state: Follow
+  states:
+    Follow:
+      code: |
+        setVal("level", value("raw"))
+        setVal("echo", value("raw"))
+)YAML";
+        auto clockOwner = std::make_unique<aeth::VirtualClock>(1000);
+        aeth::VirtualClock& clock = *clockOwner;
+        Engine shaped(std::move(clockOwner), std::make_unique<aeth::StdRandomSource>(7),
+                      aeth::makeDefaultScriptEngine());
+        aeth::EngineInitOptions options;
+        options.virtualTime = true;
+        options.maxTickRate = 0;
+        require(shaped.initialize(options).isOk(), "telemetry: initialize failed");
+        auto load = shaped.loadAutomataFromYaml(shapedYaml, ".", aeth::protocolv2::LoadReplaceMode::HardReset, true);
+        require(load.isOk(), "telemetry: load failed: " + (load.isError() ? load.error() : std::string()));
+        require(shaped.telemetryAggregator().slotCount() == 2, "telemetry: both shaped outputs should get a slot");
+
+        Engine::Replies uplink;
+        for (int i = 1; i <= 12; ++i) {
+            clock.advanceTo(1000 + i * 10);
+            require(shaped.setInput("raw", aeth::Value(i * 0.5)).isOk(), "telemetry: input rejected");
+            shaped.tick();
+            auto events = shaped.processCommandQueue();
+            std::move(events.begin(), events.end(), std::back_inserter(uplink));
+        }
+
+        size_t levelOutputs = 0;
+        size_t echoOutputs = 0;
+        std::vector<const protocol::OutputAggregateMessage*> windows;
+        for (const auto& message : uplink) {
+            if (message && message->type() == protocol::MessageType::Output) {
+                const auto& output = static_cast<const protocol::OutputMessage&>(*message);
+                levelOutputs += output.variableName == "level";
+                echoOutputs += output.variableName == "echo";
+            } else if (message && message->type() == protocol::MessageType::OutputAggregate) {
+                windows.push_back(static_cast<const protocol::OutputAggregateMessage*>(message.get()));
+            }
+        }
+        require(levelOutputs == 0, "telemetry: windowed outputs should not go up raw");
+        require(echoOutputs == 6, "telemetry: the deadband should pass every second half-step");
+        require(windows.size() == 1 && windows[0]->variableName == "level" && windows[0]->windowStart == 1000 &&
+                    windows[0]->windowEnd == 1100,
+                "telemetry: the first window should close at 1100");
+        require(windows[0]->count == 9 && windows[0]->min == aeth::Value(0.5) && windows[0]->max == aeth::Value(4.5) &&
+                    windows[0]->mean == aeth::Value(2.5) && windows[0]->last == aeth::Value(4.5),
+                "telemetry: the window should summarize the changes before its end");
+    }
+
+    {
+        // Host instances load new runs on workers while the host thread keeps routing by RunId
+        auto artifactRes = ir::makeEngineBytecodeArtifact(makeBytecodeProgram(), ".");
+        require(artifactRes.isOk(), "host: artifact build failed: " + artifactRes.error());
+        auto encoded = ir::serializeArtifact(artifactRes.value());
+        require(encoded.isOk(), "host: artifact encode failed: " + encoded.error());
+
+        aeth::EngineHostOptions hostOptions;
+        hostOptions.workers = 2;
+        hostOptions.instanceDefaults.maxTickRate = 1000;
+        hostOptions.instanceDefaults.logCapacity = 64;
+        aeth::EngineHost host(hostOptions);
+        require(host.addInstance("a").isOk() && host.addInstance("b").isOk(), "host: addInstance failed");
+
+        auto steadyUs = [] {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        };
+        auto runOf = [](aeth::RunId round, aeth::DeviceId device) { return round * 10 + device; };
+        constexpr aeth::RunId kRounds = 200;
+        size_t loadAcks = 0;
+        for (aeth::RunId round = 1; round <= kRounds; ++round) {
+            for (aeth::DeviceId device = 1; device <= 2; ++device) {
+                auto loadReq = makeMessage<protocol::LoadAutomataMessage>();
+                loadReq->targetId = device;
+                loadReq->runId = runOf(round, device);
+                loadReq->format = protocol::AutomataFormat::Binary;
+                loadReq->replaceExisting = true;
+                loadReq->startAfterLoad = true;
+                loadReq->data = encoded.value();
+                require(host.route(std::move(loadReq)) == 1, "host: a targeted load should reach one instance");
+            }
+            host.schedule(steadyUs());
+            // Routed while the loads run; replies are only taken at the end so nothing orders the two.
+            // The previous run may still be active or already replaced: one match, or a broadcast.
+            for (int i = 0; i < 8; ++i) {
+                auto input = makeMessage<protocol::InputMessage>();
+                input->runId = runOf(round - 1, 1 + (round + i) % 2);
+                input->variableName = "enabled";
+                input->value = aeth::Value(i % 2 == 0);
+                require(host.route(std::move(input)) >= 1, "host: an input should be delivered");
+            }
+        }
+        for (int i = 0; i < 3; ++i) {
+            host.waitIdle();
+            host.schedule(steadyUs());
+        }
+        host.waitIdle();
+        for (const auto& reply : host.takeReplies()) {
+            const auto* ack = dynamic_cast<const protocol::LoadAckMessage*>(reply.get());
+            loadAcks += ack != nullptr && ack->success;
+        }
+        require(loadAcks == 2 * kRounds, "host: every load should be acknowledged");
+
+        const auto stats = host.stats();
+        require(stats.size() == 2 && stats[0].deviceId == 1 && stats[1].deviceId == 2, "host: device ids");
+        require(stats[0].runId == runOf(kRounds, 1) && stats[1].runId == runOf(kRounds, 2),
+                "host: stats should report the last loaded runs");
+        require(!host.anyPeerLinks(), "host: no instance was wired to a peer");
+        auto last = makeMessage<protocol::InputMessage>();
+        last->runId = runOf(kRounds, 2);
+        last->variableName = "enabled";
+        last->value = aeth::Value(true);
+        require(host.route(std::move(last)) == 1, "host: the last run should route to its instance only");
+        host.stopAll();
+    }
+
     {
         auto goodbye = makeMessage<protocol::RawMessage>();
         goodbye->rawType = protocol::MessageType::Goodbye;
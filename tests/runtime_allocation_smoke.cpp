@@ -0,0 +1,299 @@
+#include "engine/core/runtime.hpp"
+#include "engine/core/telemetry_log_hub.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+
+// ============================================================================
+// Allocation counting
+// ============================================================================
+
+namespace {
+
+bool gCountAllocations = false;
+size_t gAllocationCount = 0;
+
+// Kept out of line: once inlined, GCC pairs free() with the new-expression
+// that made the pointer and warns (-Wmismatched-new-delete).
+[[gnu::noinline]] void* countedAlloc(std::size_t size, std::size_t alignment = 0) noexcept {
+    if (gCountAllocations) {
+        ++gAllocationCount;
+    }
+    size = size == 0 ? 1 : size;
+    if (alignment <= alignof(std::max_align_t)) {
+        return std::malloc(size);
+    }
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+[[gnu::noinline]] void countedFree(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void* countedAllocOrThrow(std::size_t size, std::size_t alignment = 0) {
+    if (void* ptr = countedAlloc(size, alignment)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+// Every replaceable form, so array, nothrow and over-aligned allocations
+// on the hot path are counted too.
+void* operator new(std::size_t size) { return countedAllocOrThrow(size); }
+void* operator new[](std::size_t size) { return countedAllocOrThrow(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new(std::size_t size, std::align_val_t align) {
+    return countedAllocOrThrow(size, static_cast<std::size_t>(align));
+}
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return countedAllocOrThrow(size, static_cast<std::size_t>(align));
+}
+
+void operator delete(void* ptr) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr) noexcept { countedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { countedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { countedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { countedFree(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { countedFree(ptr); }
+
+namespace {
+
+using namespace aeth;
+
+[[noreturn]] void fail(const std::string& msg) {
+    std::cerr << "[FAIL] " << msg << "\n";
+    std::exit(1);
+}
+
+void require(bool condition, const std::string& msg) {
+    if (!condition) {
+        fail(msg);
+    }
+}
+
+void pass(const std::string& name) {
+    std::cout << "[PASS] " << name << "\n";
+}
+
+class ManualClock : public IClock {
+public:
+    Timestamp now() override { return now_; }
+    void sleep(uint32_t ms) override { now_ += ms; }
+    void advance(uint32_t ms) { now_ += ms; }
+
+private:
+    Timestamp now_ = 1000;
+};
+
+/**
+ * Script engine stub so the check covers the runtime hot path only.
+ * Guards evaluate to false; bodies are no-ops.
+ */
+class StubScriptEngine : public IScriptEngine {
+public:
+    Result<void> initialize(VariableStore*) override { return Result<void>::ok(); }
+    Result<Value> execute(const CodeBlock&) override { return Result<Value>::ok(Value()); }
+    Result<bool> evaluateCondition(const CodeBlock&) override { return Result<bool>::ok(false); }
+    Result<double> evaluateWeight(const CodeBlock&) override { return Result<double>::ok(100.0); }
+    std::string lastError() const override { return {}; }
+    void clearError() override {}
+    void collectGarbage() override {}
+    void setLogHandler(std::function<void(const std::string&, const std::string&)>) override {}
+};
+
+Automata makeWaitingAutomata() {
+    Automata automata;
+    automata.config.name = "allocation-smoke";
+
+    automata.addVariable(VariableSpec(1, "trigger", ValueType::Bool, VariableDirection::Input, Value(false)));
+    automata.addVariable(VariableSpec(2, "level", ValueType::Int32, VariableDirection::Input, Value(0)));
+
+    State idle(1, "Idle");
+    idle.body.source = "tick()";
+    automata.addState(idle);
+    automata.addState(State(2, "Done"));
+    automata.initialState = 1;
+
+    Transition guarded(1, "guarded", 1, 2);
+    guarded.type = TransitionType::Classic;
+    guarded.classicConfig.condition.source = "false";
+    automata.addTransition(guarded);
+
+    Transition rise(2, "on_rise", 1, 2);
+    rise.type = TransitionType::Event;
+    SignalTrigger riseTrigger;
+    riseTrigger.signalName = "trigger";
+    riseTrigger.triggerType = EventTrigger::OnRise;
+    rise.eventConfig.triggers.push_back(riseTrigger);
+    automata.addTransition(rise);
+
+    Transition threshold(3, "on_threshold", 1, 2);
+    threshold.type = TransitionType::Event;
+    SignalTrigger thresholdTrigger;
+    thresholdTrigger.signalName = "level";
+    thresholdTrigger.triggerType = EventTrigger::OnThreshold;
+    thresholdTrigger.threshold = ThresholdConfig{CompareOp::Gt, Value(100), false};
+    threshold.eventConfig.triggers.push_back(thresholdTrigger);
+    automata.addTransition(threshold);
+
+    Transition timeout(4, "timeout", 1, 2);
+    timeout.type = TransitionType::Timed;
+    timeout.priority = 1;
+    timeout.timedConfig.mode = TimedMode::Timeout;
+    timeout.timedConfig.delayMs = 60000;
+    automata.addTransition(timeout);
+
+    return automata;
+}
+
+void testSteadyStateTickDoesNotAllocate() {
+    const Automata automata = makeWaitingAutomata();
+
+    auto clock = std::make_unique<ManualClock>();
+    ManualClock* clockPtr = clock.get();
+    Runtime runtime(std::move(clock),
+                    std::make_unique<StdRandomSource>(1),
+                    std::make_unique<StubScriptEngine>());
+
+    auto load = runtime.load(automata);
+    require(load.isOk(), "load failed: " + load.error());
+    auto start = runtime.start();
+    require(start.isOk(), "start failed: " + start.error());
+
+    // Warm up past the state-entry tick.
+    for (int i = 0; i < 4; ++i) {
+        clockPtr->advance(1);
+        runtime.tick();
+    }
+
+    gAllocationCount = 0;
+    gCountAllocations = true;
+    for (int i = 0; i < 1000; ++i) {
+        clockPtr->advance(1);
+        runtime.tick();
+    }
+    gCountAllocations = false;
+
+    require(gAllocationCount == 0,
+            "steady-state tick allocated " + std::to_string(gAllocationCount) + " times");
+    require(runtime.currentState() == 1, "expected to remain in Idle");
+    require(runtime.isRunning(), "expected runtime to keep running");
+
+    auto input = runtime.setInput("trigger", Value(true));
+    require(input.isOk(), "set trigger failed: " + input.error());
+    require(runtime.tick(), "expected on_rise to fire");
+    require(runtime.currentState() == 2, "expected Done after on_rise");
+
+    runtime.tick();
+    require(!runtime.isRunning(), "expected terminal Done state to stop the runtime");
+
+    pass("steady_state_tick_no_alloc");
+}
+
+void testResolverFiringDoesNotAllocate() {
+    Automata automata;
+    automata.addState(State(1, "Source"));
+    automata.addState(State(2, "Sink"));
+    automata.initialState = 1;
+    for (TransitionId id = 1; id <= 4; ++id) {
+        Transition t(id, "branch_" + std::to_string(id), 1, 2);
+        t.type = TransitionType::Probabilistic;
+        t.probConfig.weight = static_cast<uint16_t>(100 * id);
+        automata.addTransition(t);
+    }
+    Transition fallback(5, "fallback", 1, 2);
+    fallback.type = TransitionType::Timed;
+    fallback.timedConfig.mode = TimedMode::Timeout;
+    fallback.timedConfig.delayMs = 0;
+    automata.addTransition(fallback);
+
+    CompiledAutomata compiled;
+    compiled.build(automata);
+
+    ManualClock clock;
+    StdRandomSource random(7);
+    StubScriptEngine script;
+    TimerManager timers(&clock);
+    ExecutionContext context;
+    TransitionResolver resolver(&script, &random, &timers, &context.variables, &context);
+    resolver.reserve(compiled.maxGroupSize());
+
+    gAllocationCount = 0;
+    gCountAllocations = true;
+    bool allResolved = true;
+    for (int i = 0; i < 1000; ++i) {
+        const Transition* t = resolver.resolve(compiled, 1);
+        allResolved = allResolved && t && t->type == TransitionType::Probabilistic;
+    }
+    gCountAllocations = false;
+
+    require(allResolved, "expected a weighted branch to win over the timeout fallback");
+    require(gAllocationCount == 0,
+            "firing resolve allocated " + std::to_string(gAllocationCount) + " times");
+
+    pass("resolver_firing_no_alloc");
+}
+
+void testLogHubPushDoesNotAllocate() {
+    TelemetryLogHub hub(256);
+    const std::string category = "runtime";
+    const std::string message = "guard evaluated";
+    hub.log(LogLevel::Debug, category, message);  // Allocates the ring, interns the category
+
+    gAllocationCount = 0;
+    gCountAllocations = true;
+    for (int i = 0; i < 1000; ++i) {
+        hub.log(LogLevel::Debug, category, message, RunId{1});
+        hub.stateChange(1, 2, 3, RunId{1});
+    }
+    gCountAllocations = false;
+
+    require(gAllocationCount == 0,
+            "log hub push allocated " + std::to_string(gAllocationCount) + " times");
+    require(hub.latestSeq() == 2001, "every push should be numbered");
+
+    pass("log_hub_push_no_alloc");
+}
+
+void testEveryAllocationFormIsCounted() {
+    struct alignas(64) CacheLine {
+        uint8_t bytes[64];
+    };
+
+    gAllocationCount = 0;
+    gCountAllocations = true;
+    delete new int(1);
+    delete[] new int[4];
+    delete new (std::nothrow) int(2);
+    delete[] new (std::nothrow) int[4];
+    delete new CacheLine();
+    delete[] new CacheLine[2];
+    gCountAllocations = false;
+
+    require(gAllocationCount == 6,
+            "expected 6 counted allocations, got " + std::to_string(gAllocationCount));
+
+    pass("every_allocation_form_counted");
+}
+
+} // namespace
+
+int main() {
+    testEveryAllocationFormIsCounted();
+    testSteadyStateTickDoesNotAllocate();
+    testResolverFiringDoesNotAllocate();
+    testLogHubPushDoesNotAllocate();
+    return 0;
+}
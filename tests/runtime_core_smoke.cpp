@@ -0,0 +1,2448 @@
+#include "engine/core/automata_analysis.hpp"
+#include "engine/core/bytecode_compiler.hpp"
+#include "engine/core/checkpoint.hpp"
+#include "engine/core/flash_automata.hpp"
+#include "engine/core/fleet.hpp"
+#include "engine/core/hardware_service.hpp"
+#include "engine/core/protocol.hpp"
+#include "engine/core/protocol_v2.hpp"
+#include "engine/core/runtime.hpp"
+#include "engine/core/script_engine.hpp"
+#include "engine/core/spsc_ring.hpp"
+#include "engine/core/telemetry_delta.hpp"
+#include "engine/core/telemetry_log_hub.hpp"
+#include "engine/core/tick_pacer.hpp"
+#include "engine/core/work_stealing_pool.hpp"
+#include "engine/embedded/platform/FrameBatcher.hpp"
+#include "engine/embedded/platform/SerialRing.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace aeth;
+
+[[noreturn]] void fail(const std::string& msg) {
+    std::cerr << "[FAIL] " << msg << "\n";
+    std::exit(1);
+}
+
+void require(bool condition, const std::string& msg) {
+    if (!condition) {
+        fail(msg);
+    }
+}
+
+void pass(const std::string& name) {
+    std::cout << "[PASS] " << name << "\n";
+}
+
+class ManualClock : public IClock {
+public:
+    Timestamp now() override { return now_; }
+    void sleep(uint32_t ms) override { now_ += ms; }
+    void advance(uint32_t ms) { now_ += ms; }
+
+private:
+    Timestamp now_ = 1000;
+};
+
+/**
+ * Understands the two guard literals used below and counts evaluations.
+ */
+class CountingScriptEngine : public IScriptEngine {
+public:
+    Result<void> initialize(VariableStore* variables) override {
+        variables_ = variables;
+        ++initializes;
+        return Result<void>::ok();
+    }
+    std::unique_ptr<IScriptEngine> createInstance() const override {
+        return std::make_unique<CountingScriptEngine>();
+    }
+    Result<void> resetGlobals() override {
+        ++globalResets;
+        return Result<void>::ok();
+    }
+    Result<Value> execute(const CodeBlock&) override {
+        allocated += 16;
+        return Result<Value>::ok(Value());
+    }
+    Result<bool> evaluateCondition(const CodeBlock& code) override {
+        ++conditions;
+        if (code.source == "level > 10") {
+            const auto level = variables_->getValue("level");
+            return Result<bool>::ok(level && level->toDouble() > 10);
+        }
+        return Result<bool>::ok(false);
+    }
+    Result<double> evaluateWeight(const CodeBlock&) override { return Result<double>::ok(1.0); }
+    std::string lastError() const override { return {}; }
+    void clearError() override {}
+    void collectGarbage() override { ++fullCollects; }
+    bool stepGarbage(uint32_t) override { return ++gcSteps % 3 == 0; }  // A cycle takes three steps
+    [[nodiscard]] size_t memoryInUse() const override { return heapBytes; }
+    void setLogHandler(std::function<void(const std::string&, const std::string&)>) override {}
+    [[nodiscard]] uint64_t allocatedBytes() const override { return allocated; }
+
+    uint32_t conditions = 0;
+    uint32_t initializes = 0;
+    uint32_t globalResets = 0;
+    uint64_t allocated = 0;  // Pretend VM allocations, 16 bytes per execute()
+    uint32_t fullCollects = 0;
+    uint32_t gcSteps = 0;
+    size_t heapBytes = 0;
+
+private:
+    VariableStore* variables_ = nullptr;
+};
+
+CodeBlock guard(const std::string& source) {
+    CodeBlock code;
+    code.source = source;
+    return code;
+}
+
+Automata makeLevelAutomata() {
+    Automata automata;
+    automata.config.name = "reactive-smoke";
+    automata.addVariable(VariableSpec(1, "level", ValueType::Int32, VariableDirection::Input, Value(0)));
+    automata.addVariable(VariableSpec(2, "mode", ValueType::Int32, VariableDirection::Input, Value(0)));
+
+    automata.addState(State(1, "Idle"));
+    automata.addState(State(2, "High"));
+    automata.initialState = 1;
+
+    Transition high(1, "to_high", 1, 2);
+    high.type = TransitionType::Classic;
+    high.classicConfig.condition = guard("level > 10");
+    automata.addTransition(high);
+
+    // Reads the clock, so it cannot be scheduled reactively.
+    Transition clocked(2, "clocked", 1, 2);
+    clocked.type = TransitionType::Classic;
+    clocked.classicConfig.condition = guard("now() > 1e12");
+    automata.addTransition(clocked);
+
+    return automata;
+}
+
+void testGuardDependencyAnalysis() {
+    const Automata automata = makeLevelAutomata();
+    std::vector<VariableId> deps;
+
+    require(collectGuardDependencies(guard("level > 10 and mode == 2"), automata, deps),
+            "plain variable guard should be analyzable");
+    require(deps.size() == 2, "expected level and mode dependencies");
+
+    deps.clear();
+    require(collectGuardDependencies(guard("check(\"mode\") -- level\nand math.abs(x.level) > 1"),
+                                     automata, deps) == false,
+            "unknown global x should make the guard opaque");
+
+    deps.clear();
+    require(collectGuardDependencies(guard("local a = level\nreturn check(\"mode\") and a > 1"),
+                                     automata, deps),
+            "locals and pure builtins should stay analyzable");
+    require(deps.size() == 2, "expected level (bare) and mode (string argument)");
+
+    deps.clear();
+    require(!collectGuardDependencies(guard("rand() < 0.5"), automata, deps),
+            "rand() guard must be evaluated every tick");
+
+    pass("guard_dependency_analysis");
+}
+
+void testReactiveModeSkipsUnchangedGuards() {
+    const Automata automata = makeLevelAutomata();
+
+    auto clock = std::make_unique<ManualClock>();
+    ManualClock* clockPtr = clock.get();
+    auto script = std::make_unique<CountingScriptEngine>();
+    CountingScriptEngine* scriptPtr = script.get();
+    Runtime runtime(std::move(clock), std::make_unique<StdRandomSource>(1), std::move(script));
+    runtime.setTickMode(TickMode::Reactive);
+
+    require(runtime.load(automata).isOk(), "load failed");
+    require(runtime.start().isOk(), "start failed");
+
+    // Entry tick evaluates everything.
+    clockPtr->advance(1);
+    require(!runtime.tick(), "nothing should fire on entry");
+    require(runtime.context().transitionsEvaluated == 2, "entry tick should evaluate both guards");
+
+    // Idle ticks only evaluate the opaque guard.
+    const uint32_t before = scriptPtr->conditions;
+    for (int i = 0; i < 50; ++i) {
+        clockPtr->advance(1);
+        runtime.tick();
+        require(runtime.context().transitionsEvaluated == 1, "idle tick should skip the level guard");
+    }
+    require(scriptPtr->conditions - before == 50, "expected one opaque guard evaluation per idle tick");
+
+    // Changing level re-evaluates its guard once.
+    require(runtime.setInput("level", Value(5)).isOk(), "set level failed");
+    clockPtr->advance(1);
+    require(!runtime.tick(), "level 5 should not fire");
+    require(runtime.context().transitionsEvaluated == 2, "changed level should re-evaluate its guard");
+
+    clockPtr->advance(1);
+    runtime.tick();
+    require(runtime.context().transitionsEvaluated == 1, "guard should settle again after one evaluation");
+
+    require(runtime.setInput("level", Value(20)).isOk(), "set level failed");
+    clockPtr->advance(1);
+    require(runtime.tick(), "level 20 should fire to_high");
+    require(runtime.currentState() == 2, "expected High");
+
+    pass("reactive_mode_skips_unchanged_guards");
+}
+
+void testPollingModeEvaluatesEveryTick() {
+    const Automata automata = makeLevelAutomata();
+
+    auto clock = std::make_unique<ManualClock>();
+    ManualClock* clockPtr = clock.get();
+    Runtime runtime(std::move(clock), std::make_unique<StdRandomSource>(1),
+                    std::make_unique<CountingScriptEngine>());
+
+    require(runtime.load(automata).isOk(), "load failed");
+    require(runtime.start().isOk(), "start failed");
+    for (int i = 0; i < 10; ++i) {
+        clockPtr->advance(1);
+        runtime.tick();
+        require(runtime.context().transitionsEvaluated == 2, "polling mode should evaluate both guards");
+    }
+
+    pass("polling_mode_evaluates_every_tick");
+}
+
+void testTimerHeapOrderingAndCancel() {
+    ManualClock clock;
+    TimerManager timers(&clock);
+
+    require(!timers.nextDeadline(), "empty manager should have no deadline");
+
+    timers.startTimer(3, 300);
+    timers.startTimer(1, 100);
+    timers.startTimer(2, 200);
+    require(timers.nextDeadline() == clock.now() + 100, "earliest deadline should be timer 1");
+
+    timers.cancelTimer(1);
+    require(timers.nextDeadline() == clock.now() + 200, "cancel should drop the earliest deadline");
+    require(timers.getTimer(1) == nullptr, "cancelled timer should be gone");
+
+    // Restarting a pending timer moves it in the heap.
+    timers.startTimer(3, 50);
+    require(timers.nextDeadline() == clock.now() + 50, "restarted timer should become earliest");
+
+    clock.advance(250);
+    require(timers.markExpired() == 2, "timers 2 and 3 should expire");
+    require(timers.getTimer(2) && timers.getTimer(2)->fired, "expired timer stays visible as fired");
+    require(!timers.nextDeadline(), "fired timers are not pending");
+
+    timers.restartTimer(2, 100);
+    require(!timers.getTimer(2), "single-shot timer should be released on restart");
+
+    timers.startTimer(4, 100, 0, 0);
+    timers.shiftAll(1000);
+    clock.advance(500);
+    require(timers.markExpired() == 0, "shift should postpone pending timers");
+    require(timers.nextDeadline() == clock.now() + 600, "shifted deadline should move by delta");
+
+    timers.cancelAll();
+    require(timers.activeCount() == 0 && !timers.nextDeadline(), "cancelAll should clear everything");
+
+    pass("timer_heap_ordering_and_cancel");
+}
+
+void testTimerHeapMatchesReference() {
+    ManualClock clock;
+    TimerManager timers(&clock);
+    std::map<TransitionId, Timestamp> pending;
+    std::mt19937 rng(42);
+
+    for (int step = 0; step < 5000; ++step) {
+        const auto id = static_cast<TransitionId>(1 + rng() % 64);
+        switch (rng() % 4) {
+            case 0:
+            case 1: {
+                const uint32_t delay = rng() % 500;
+                timers.startTimer(id, delay);
+                pending[id] = clock.now() + delay;
+                break;
+            }
+            case 2:
+                timers.cancelTimer(id);
+                pending.erase(id);
+                break;
+            default: {
+                clock.advance(rng() % 40);
+                size_t expected = 0;
+                for (auto it = pending.begin(); it != pending.end();) {
+                    if (it->second <= clock.now()) {
+                        ++expected;
+                        it = pending.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+                require(timers.markExpired() == expected, "expired count diverged from reference");
+                break;
+            }
+        }
+
+        std::optional<Timestamp> earliest;
+        for (const auto& [pid, target] : pending) {
+            if (!earliest || target < *earliest) {
+                earliest = target;
+            }
+        }
+        require(timers.nextDeadline() == earliest, "next deadline diverged from reference");
+    }
+
+    pass("timer_heap_matches_reference");
+}
+
+void testTickSchedulerSlotsAndDeadlines() {
+    TickScheduler unlimited(0);
+    require(unlimited.due(0, std::nullopt) && unlimited.waitUs(0, std::nullopt, 1000) == 0,
+            "unlimited rate should always be due");
+
+    // 3 Hz: slots at 333333, 666666, 1000000 us after the first tick.
+    TickScheduler scheduler(3);
+    require(scheduler.due(0, std::nullopt), "first tick should be due immediately");
+    scheduler.ticked(0);
+    require(!scheduler.due(1000, std::nullopt), "next slot should not be due yet");
+    require(scheduler.waitUs(1000, std::nullopt, UINT64_MAX) == 332333, "wait should reach the next slot");
+    require(scheduler.waitUs(1000, std::nullopt, 5000) == 5000, "wait should respect the cap");
+
+    uint64_t now = 0;
+    for (int i = 0; i < 3; ++i) {
+        now += scheduler.waitUs(now, std::nullopt, UINT64_MAX);
+        require(scheduler.due(now, std::nullopt), "slot should be due after waiting");
+        scheduler.ticked(now);
+    }
+    require(now == 1000000, "three 3 Hz slots should land exactly on one second");
+
+    // A nearer timer deadline shortens the wait and makes an early tick due.
+    require(scheduler.waitUs(now + 10, 20u, UINT64_MAX) == 20000, "timer should bound the wait");
+    require(scheduler.due(now + 10, 0u), "expired timer should make a tick due");
+    scheduler.ticked(now + 10);
+    require(scheduler.waitUs(now + 10, std::nullopt, UINT64_MAX) == 333333 - 10,
+            "early tick should keep the pending slot");
+
+    // Falling far behind re-anchors instead of bursting.
+    scheduler.ticked(now + 5000000);
+    require(!scheduler.due(now + 5000001, std::nullopt), "re-anchored scheduler should wait a full period");
+
+    pass("tick_scheduler_slots_and_deadlines");
+}
+
+void testTickPacerFollowsActivityBatteryAndCost() {
+    PacingProfile profile;
+    profile.enabled = true;
+    profile.minRate = 2;
+    profile.idleTicks = 4;
+
+    TickPacer unbounded;
+    unbounded.configure(profile, 0);
+    require(!unbounded.enabled() && unbounded.rate() == 0, "pacing needs a ceiling");
+
+    TickPacer pacer;
+    pacer.configure(profile, 100);
+    require(pacer.enabled() && pacer.rate() == 100, "pacer should start at the ceiling");
+
+    // Quiet ticks halve the rate every idleTicks, down to the floor.
+    for (int i = 0; i < 3; ++i) {
+        require(!pacer.observe(false, 100, false), "rate should hold before idleTicks");
+    }
+    require(pacer.observe(false, 100, false) && pacer.rate() == 50, "idle should halve the rate");
+    for (int i = 0; i < 40; ++i) {
+        (void)pacer.observe(false, 100, false);
+    }
+    require(pacer.rate() == 2 && pacer.decision() == PacingDecision::Idle, "idle rate should settle at the floor");
+
+    require(pacer.observe(true, 100, false) && pacer.rate() == 100 && pacer.decision() == PacingDecision::Active,
+            "activity should jump to the ceiling");
+    require(pacer.observe(true, 100, true) && pacer.rate() == 25 && pacer.decision() == PacingDecision::LowBattery,
+            "low battery should cap the rate at a quarter");
+    require(pacer.observe(true, 100, false) && pacer.rate() == 100, "charged battery should lift the cap");
+
+    // 10 ms ticks against a 50% budget fit 50 per second.
+    for (int i = 0; i < 60; ++i) {
+        (void)pacer.observe(true, 10000, false);
+    }
+    require(pacer.rate() >= 49 && pacer.rate() <= 50 && pacer.decision() == PacingDecision::Overload,
+            "expensive ticks should back the rate off");
+    require(pacer.loadPercent() > 49.0f && pacer.loadPercent() < 51.0f, "load should sit at the budget");
+
+    // Retuning keeps the last tick as the origin of the new period.
+    TickScheduler scheduler(10);
+    scheduler.ticked(0);
+    scheduler.retune(20);
+    require(scheduler.waitUs(1000, std::nullopt, UINT64_MAX) == 49000, "retuned slot should follow the last tick");
+    scheduler.retune(0);
+    require(scheduler.due(1000, std::nullopt), "unlimited rate should be due");
+
+    pass("tick_pacer_follows_activity_battery_and_cost");
+}
+
+void testRuntimeReportsNextTimer() {
+    Automata automata;
+    automata.addState(State(1, "Wait"));
+    automata.addState(State(2, "Done"));
+    automata.initialState = 1;
+    Transition after(1, "after", 1, 2);
+    after.type = TransitionType::Timed;
+    after.timedConfig.mode = TimedMode::After;
+    after.timedConfig.delayMs = 250;
+    automata.addTransition(after);
+
+    auto clock = std::make_unique<ManualClock>();
+    ManualClock* clockPtr = clock.get();
+    Runtime runtime(std::move(clock), std::make_unique<StdRandomSource>(1),
+                    std::make_unique<CountingScriptEngine>());
+    require(!runtime.msUntilNextTimer(), "no timer before start");
+    require(runtime.load(automata).isOk(), "load failed");
+    require(runtime.start().isOk(), "start failed");
+
+    require(runtime.msUntilNextTimer() == 250u, "expected the after timer to be pending");
+    clockPtr->advance(100);
+    require(runtime.msUntilNextTimer() == 150u, "deadline should count down");
+    clockPtr->advance(200);
+    require(runtime.msUntilNextTimer() == 0u, "overdue timer should report zero");
+    require(runtime.tick(), "after transition should fire");
+    require(!runtime.msUntilNextTimer(), "no timer pending in Done");
+
+    pass("runtime_reports_next_timer");
+}
+
+void testRuntimeHotSwapKeepsMatchingStateAndValues() {
+    const Automata current = makeLevelAutomata();
+
+    Automata next;
+    next.config.name = "reactive-smoke-v2";
+    next.addVariable(VariableSpec(5, "level", ValueType::Int32, VariableDirection::Input, Value(0)));
+    next.addVariable(VariableSpec(6, "mode", ValueType::Float64, VariableDirection::Input, Value(1.5)));
+    next.addState(State(8, "Idle"));
+    next.addState(State(7, "High"));
+    next.initialState = 8;
+    Transition back(3, "back", 7, 8);
+    back.type = TransitionType::Classic;
+    back.classicConfig.condition = guard("never");
+    next.addTransition(back);
+
+    auto clock = std::make_unique<ManualClock>();
+    ManualClock* clockPtr = clock.get();
+    Runtime runtime(std::move(clock), std::make_unique<StdRandomSource>(1),
+                    std::make_unique<CountingScriptEngine>());
+    require(runtime.load(current).isOk(), "load failed");
+    require(runtime.start().isOk(), "start failed");
+    require(runtime.setInput("level", Value(20)).isOk(), "set level failed");
+    require(runtime.setInput("mode", Value(4)).isOk(), "set mode failed");
+    clockPtr->advance(1);
+    require(runtime.tick(), "level 20 should fire to_high");
+    const RunId firstRun = runtime.context().runId;
+
+    // Warm-up touches nothing shared with the running runtime.
+    Result<std::unique_ptr<PreparedLoad>> prepared = Result<std::unique_ptr<PreparedLoad>>::error("not run");
+    std::thread warmUp([&] { prepared = Runtime::prepare(next, std::make_unique<CountingScriptEngine>()); });
+    warmUp.join();
+    require(prepared.isOk(), "prepare failed: " + prepared.error());
+
+    auto swapped = runtime.swapIn(*prepared.value());
+    require(swapped.isOk(), "swapIn failed: " + swapped.error());
+    require(swapped.value() != firstRun, "swap should start a new run id");
+    require(runtime.isRunning(), "runtime should keep running across the swap");
+    require(runtime.currentState() == 7, "expected the state named High in the new automata");
+    require(runtime.context().variables.getValue("level") == Value(20), "level should carry over by name");
+    require(runtime.context().variables.getValue("mode") == Value(1.5), "retyped mode should start at its default");
+    require(prepared.value()->automata == &current, "prepared load should hand back the old automata");
+
+    require(runtime.setInput("level", Value(3)).isOk(), "inputs should reach the new store");
+    clockPtr->advance(1);
+    runtime.tick();
+    require(runtime.context().variables.getValue(5) == Value(3), "new store should see the write by id");
+
+    pass("runtime_hot_swap_keeps_matching_state_and_values");
+}
+
+void testSpareScriptEnginesAndResetInPlace() {
+    const Automata automata = makeLevelAutomata();
+    auto script = std::make_unique<CountingScriptEngine>();
+    CountingScriptEngine* scriptPtr = script.get();
+    Runtime runtime(std::make_unique<ManualClock>(), std::make_unique<StdRandomSource>(1), std::move(script));
+    require(runtime.load(automata).isOk(), "load failed");
+
+    runtime.warmScriptEngines(2);
+    require(runtime.spareScriptEngines() == 2, "expected two pre-warmed spares");
+    auto spare = runtime.createScriptEngine();
+    require(spare && static_cast<CountingScriptEngine*>(spare.get())->initializes == 1,
+            "a spare should come initialized once");
+    require(runtime.spareScriptEngines() == 1, "handing out a spare should shrink the pool");
+
+    runtime.recycleScriptEngine(std::move(spare));
+    require(runtime.spareScriptEngines() == 2, "a recycled engine should go back to the pool");
+    runtime.recycleScriptEngine(std::make_unique<CountingScriptEngine>());
+    require(runtime.spareScriptEngines() == 2, "the pool should not grow past its limit");
+
+    require(runtime.start().isOk(), "start failed");
+    const uint32_t initializesBefore = scriptPtr->initializes;
+    require(runtime.reset().isOk(), "reset failed");
+    require(scriptPtr->globalResets == 1, "reset should put the script globals back");
+    require(scriptPtr->initializes == initializesBefore, "reset should not re-initialize the script engine");
+    require(runtime.isRunning(), "a running runtime should restart after reset");
+
+    runtime.warmScriptEngines(0);
+    require(runtime.spareScriptEngines() == 0, "warming zero should drop the spares");
+    auto fresh = runtime.createScriptEngine();
+    require(fresh && static_cast<CountingScriptEngine*>(fresh.get())->initializes == 0,
+            "without spares a fresh instance is made");
+
+    pass("spare_script_engines_and_reset_in_place");
+}
+
+void testSpscRingPreservesOrderAcrossThreads() {
+    SpscRing<std::unique_ptr<uint64_t>> ring(60);
+    require(ring.capacity() == 64, "capacity should round up to a power of two");
+
+    constexpr uint64_t kCount = 100000;
+    std::thread producer([&ring] {
+        for (uint64_t i = 0; i < kCount; ++i) {
+            auto value = std::make_unique<uint64_t>(i);
+            while (!ring.tryPush(std::move(value))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t expected = 0;
+    bool ordered = true;
+    while (expected < kCount) {
+        std::unique_ptr<uint64_t> single;
+        if (expected % 3 == 0 && ring.tryPop(single)) {
+            ordered = ordered && *single == expected;
+            ++expected;
+            continue;
+        }
+        const size_t drained = ring.drain([&](std::unique_ptr<uint64_t>&& value) {
+            ordered = ordered && value && *value == expected;
+            ++expected;
+        }, 16);
+        if (drained == 0) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    require(ordered, "ring should deliver values in push order");
+    require(ring.empty(), "ring should be empty after draining everything");
+
+    auto extra = std::make_unique<uint64_t>(7);
+    for (size_t i = 0; i < ring.capacity(); ++i) {
+        require(ring.tryPush(std::make_unique<uint64_t>(i)), "push below capacity should succeed");
+    }
+    require(!ring.tryPush(std::move(extra)), "push into a full ring should fail");
+    require(extra && *extra == 7, "failed push should leave the value untouched");
+
+    pass("spsc_ring_preserves_order_across_threads");
+}
+
+void testLoadAutomataRoundTripsChunkFields() {
+    protocol::LoadAutomataMessage load;
+    load.messageId = 7;
+    load.sourceId = 3;
+    load.targetId = 9;
+    load.runId = 42;
+    load.isChunked = true;
+    load.chunkIndex = 1;
+    load.totalChunks = 4;
+    load.chunkCrc = 0xC0FFEEu;
+    load.data.assign(4000, 0xAB);
+    const auto frame = load.serialize();
+
+    auto decoded = protocol::LoadAutomataMessage::deserialize(frame.data(), frame.size());
+    require(decoded.has_value(), "load decode failed");
+    require(decoded->messageId == 7 && decoded->sourceId == 3 && decoded->targetId == 9, "load ids mismatch");
+    require(decoded->runId == 42 && decoded->isChunked && decoded->chunkIndex == 1 && decoded->totalChunks == 4,
+            "load chunk fields mismatch");
+    require(decoded->chunkCrc && *decoded->chunkCrc == 0xC0FFEEu, "load chunk crc mismatch");
+    require(decoded->data == load.data, "load payload mismatch");
+
+    require(!protocol::LoadAutomataMessage::deserialize(frame.data(), frame.size() - 4),
+            "load frame missing its crc should not decode");
+    const uint8_t junk[] = {0x00, 0x01, 0x02};
+    require(!protocol::MessageFactory::deserialize(junk, sizeof(junk)), "short/bad-magic buffer should not decode");
+
+    pass("load_automata_round_trips_chunk_fields");
+}
+
+void testPooledMessagesReuseBlocksAndWriter() {
+    using namespace protocol;
+
+    // Warm up, then a steady stream of outbound messages must not touch the heap.
+    for (int i = 0; i < 4; ++i) {
+        std::unique_ptr<Message> warm = std::make_unique<StateChangeMessage>();
+        std::unique_ptr<Message> ack = std::make_unique<AckMessage>();
+    }
+    const uint64_t before = messageHeapAllocations();
+    for (int i = 0; i < 1000; ++i) {
+        std::unique_ptr<Message> change = std::make_unique<StateChangeMessage>();
+        std::unique_ptr<Message> ack = std::make_unique<AckMessage>();
+    }
+    require(messageHeapAllocations() == before, "pooled messages should be reused after warm-up");
+
+    StateChangeMessage change;
+    change.runId = 5;
+    change.newState = 2;
+    change.timestamp = 99;
+    AckMessage ack;
+    ack.relatedMessageId = 11;
+    ack.info = "ok";
+
+    ByteWriter writer;
+    change.serializeInto(writer);
+    ack.serializeInto(writer);
+    const auto first = change.serialize();
+    const auto second = ack.serialize();
+    require(writer.size() == first.size() + second.size(), "serializeInto should append both frames");
+    require(std::equal(first.begin(), first.end(), writer.data()), "first frame mismatch");
+    require(std::equal(second.begin(), second.end(), writer.data() + first.size()), "second frame mismatch");
+
+    auto decoded = StateChangeMessage::deserialize(writer.data(), first.size());
+    require(decoded && decoded->newState == 2 && decoded->timestamp == 99, "appended frame should decode");
+
+    writer.clear();
+    ack.serializeInto(writer);
+    require(writer.size() == second.size(), "cleared writer should start a fresh frame");
+
+    pass("pooled_messages_reuse_blocks_and_writer");
+}
+
+void testByteWriterBigEndianAndSizes() {
+    using namespace protocol;
+
+    ByteWriter writer;
+    writer.writeU16(0x0102);
+    writer.writeU32(0x03040506u);
+    writer.writeU64(0x0708090A0B0C0D0EULL);
+    writer.writeString("hi");
+    const std::vector<uint8_t> expected = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A,
+                                           0x0B, 0x0C, 0x0D, 0x0E, 0x00, 0x02, 'h', 'i'};
+    require(writer.size() == expected.size() &&
+                std::equal(expected.begin(), expected.end(), writer.data()),
+            "writer should emit big-endian fields");
+
+    ByteReader reader(writer.data(), writer.size());
+    require(reader.readU16() == 0x0102 && reader.readU32() == 0x03040506u &&
+                reader.readU64() == 0x0708090A0B0C0D0EULL && reader.readString() == std::string("hi"),
+            "reader should decode what the writer wrote");
+    require(!reader.readU16(), "reading past the end should fail");
+
+    TelemetryMessage telemetry;
+    telemetry.variableSnapshot.emplace_back(1, Value(std::string("warm")));
+    telemetry.namedVariableSnapshot.push_back({"speed", Value(2.5)});
+    telemetry.deployment.placement = "edge";
+    OutputMessage output;
+    output.variableName = "fan";
+    output.value = Value(static_cast<int64_t>(9));
+    telemetry.scriptValuesSynced = 7;
+    require(telemetry.serializedSize() == telemetry.serialize().size(), "telemetry size mismatch");
+    require(output.serializedSize() == output.serialize().size(), "output size mismatch");
+
+    // The sync counter trails the deployment extension; frames without it still decode
+    auto frame = telemetry.serialize();
+    auto decoded = TelemetryMessage::deserialize(frame.data(), frame.size());
+    require(decoded && decoded->scriptValuesSynced == 7 && decoded->deployment.placement == "edge",
+            "telemetry should carry the script sync counter");
+    decoded = TelemetryMessage::deserialize(frame.data(), frame.size() - 4);
+    require(decoded && decoded->scriptValuesSynced == 0 && decoded->deployment.placement == "edge",
+            "telemetry without the counter should still decode");
+
+    pass("byte_writer_big_endian_and_sizes");
+}
+
+void testTelemetryDeltaTrackerKeyframeThenDeltas() {
+    using namespace protocol;
+
+    VariableStore store;
+    const VariableId speed = 1;
+    store.addVariable(VariableSpec(speed, "speed", ValueType::Int32, VariableDirection::Output,
+                                   Value(static_cast<int32_t>(1))));
+    store.addVariable(VariableSpec(2, "mode", ValueType::String, VariableDirection::Internal,
+                                   Value(std::string("auto"))));
+
+    TelemetryDeltaTracker tracker;
+    TelemetryDeltaMessage first;
+    require(tracker.build(store, first) && first.keyframe, "first frame should be a keyframe");
+    require(first.names.size() == 2 && first.values.size() == 2, "keyframe should carry every variable");
+
+    TelemetryDeltaMessage again;
+    require(tracker.build(store, again) && again.keyframe, "unacked keyframe should be resent");
+
+    require(tracker.acknowledge(again.sequence), "ack of a sent frame should be accepted");
+    require(!tracker.acknowledge(first.sequence), "older frames are dropped after an ack");
+    TelemetryDeltaMessage idle;
+    require(!tracker.build(store, idle), "no change should produce no frame");
+
+    store.setValue(speed, Value(static_cast<int32_t>(2)));
+    TelemetryDeltaMessage delta;
+    require(tracker.build(store, delta) && !delta.keyframe, "change should produce a delta");
+    require(delta.baseSequence == again.sequence && delta.values.size() == 1 &&
+                delta.values[0].id == speed && delta.names.empty(),
+            "delta should carry only the changed variable");
+
+    const std::vector<uint8_t> frame = delta.serialize();
+    require(delta.serializedSize() == frame.size(), "delta size mismatch");
+    auto decoded = MessageFactory::deserialize(frame);
+    require(decoded && decoded->type() == MessageType::TelemetryDelta, "delta should decode");
+    const auto& roundtrip = static_cast<const TelemetryDeltaMessage&>(*decoded);
+    require(roundtrip.sequence == delta.sequence && roundtrip.baseSequence == delta.baseSequence &&
+                roundtrip.values.size() == 1 && roundtrip.values[0].value == Value(static_cast<int32_t>(2)),
+            "delta should roundtrip");
+
+    TelemetryAckMessage ack;
+    ack.sequence = delta.sequence;
+    ack.requestKeyframe = true;
+    auto decodedAck = MessageFactory::deserialize(ack.serialize());
+    require(decodedAck && static_cast<const TelemetryAckMessage&>(*decodedAck).requestKeyframe,
+            "ack should roundtrip");
+
+    pass("telemetry_delta_tracker_keyframe_then_deltas");
+}
+
+void testSymbolTableRoundtripAndIdOnlyOutput() {
+    using namespace protocol;
+
+    SymbolTableMessage table;
+    table.runId = 7;
+    table.variables = {{1, "speed"}, {2, "mode"}};
+    table.states = {{1, "Idle"}};
+    const std::vector<uint8_t> frame = table.serialize();
+    require(table.serializedSize() == frame.size(), "symbol table size mismatch");
+    auto decoded = MessageFactory::deserialize(frame);
+    require(decoded && decoded->type() == MessageType::SymbolTable, "symbol table should decode");
+    const auto& roundtrip = static_cast<const SymbolTableMessage&>(*decoded);
+    require(roundtrip.runId == 7 && roundtrip.variables.size() == 2 && roundtrip.variables[1].name == "mode" &&
+                roundtrip.states.size() == 1 && roundtrip.states[0].name == "Idle",
+            "symbol table should roundtrip");
+
+    OutputMessage named;
+    named.variableId = 1;
+    named.variableName = "speed";
+    named.value = Value(static_cast<int32_t>(3));
+    OutputMessage idOnly = named;
+    idOnly.variableName.clear();
+    require(idOnly.serializedSize() + named.variableName.size() == named.serializedSize(),
+            "id-only output should drop the name bytes");
+    auto decodedOutput = MessageFactory::deserialize(idOnly.serialize());
+    require(decodedOutput && static_cast<const OutputMessage&>(*decodedOutput).variableId == 1,
+            "id-only output should decode");
+
+    pass("symbol_table_roundtrip_and_id_only_output");
+}
+
+void testCompactValueEncodingIsSmallerAndLossless() {
+    using namespace protocolv2;
+
+    protocol::DeviceCapabilities device;
+    protocol::DeviceCapabilities server;
+    device.setCompactValues(true);
+    require(negotiateValueEncoding(device.raw, server.raw) == ValueEncoding::Fixed,
+            "compact values need both peers");
+    server.setCompactValues(true);
+    require(negotiateValueEncoding(device.raw, server.raw) == ValueEncoding::Compact,
+            "compact values should be negotiated");
+
+    TelemetryDeltaPayload delta;
+    delta.sequence = 5;
+    delta.values = {
+        VariableUpdate{1, Value(true)},
+        VariableUpdate{2, Value(static_cast<int32_t>(-3))},
+        VariableUpdate{3, Value(static_cast<int64_t>(1) << 40)},
+        VariableUpdate{4, Value(0.5)},
+        VariableUpdate{5, Value(0.1)},
+        VariableUpdate{6, Value(std::string("auto"))},
+        VariableUpdate{7, Value(static_cast<int32_t>(INT32_MIN))},
+    };
+
+    Frame frame;
+    frame.type = protocol::MessageType::TelemetryDelta;
+    frame.runId = 1;
+    frame.payload = delta;
+    auto fixed = ProtocolCodecV2::encode(frame);
+    frame.valueEncoding = ValueEncoding::Compact;
+    auto compact = ProtocolCodecV2::encode(frame);
+    require(fixed.isOk() && compact.isOk(), "v2 encode should succeed");
+    require(compact.value().size() < fixed.value().size(), "compact encoding should be smaller");
+
+    auto decoded = ProtocolCodecV2::decode(compact.value());
+    require(decoded.isOk() && decoded.value().valueEncoding == ValueEncoding::Compact,
+            "compact frame should decode and report its encoding");
+    const auto* roundtrip = std::get_if<TelemetryDeltaPayload>(&decoded.value().payload);
+    require(roundtrip && roundtrip->values.size() == delta.values.size(), "compact payload should roundtrip");
+    for (size_t i = 0; i < delta.values.size(); ++i) {
+        require(roundtrip->values[i].value.type() == delta.values[i].value.type() &&
+                    roundtrip->values[i].value == delta.values[i].value,
+                "compact value " + std::to_string(i) + " should keep type and value");
+    }
+
+    pass("compact_value_encoding_is_smaller_and_lossless");
+}
+
+void testWorkStealingPoolRunsEveryTask() {
+    WorkStealingPool pool(4);
+    require(pool.workerCount() == 4, "expected four workers");
+
+    std::atomic<uint64_t> sum{0};
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        pool.submit([&sum, i] {
+            // Uneven task cost so idle workers have something to steal.
+            if (i % 97 == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            sum.fetch_add(i, std::memory_order_relaxed);
+        });
+    }
+    pool.waitIdle();
+    require(sum.load() == 500500u, "every submitted task should run exactly once");
+
+    pool.submit([&sum] { sum.store(0); });
+    pool.waitIdle();
+    require(sum.load() == 0u, "pool should accept work after going idle");
+
+    pass("work_stealing_pool_runs_every_task");
+}
+
+void testTelemetryLogHubRingAcrossProducers() {
+    TelemetryLogHub hub(64);
+    hub.setCapacity(16);
+    require(hub.capacity() == 16, "capacity should follow setCapacity");
+
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 500;
+    const std::string category = "bench";
+    const std::string message = "tick";
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&] {
+            for (int i = 0; i < kPerProducer; ++i) {
+                hub.log(LogLevel::Debug, category, message, RunId{7});
+            }
+        });
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+
+    const uint64_t last = hub.latestSeq();
+    require(last == kProducers * kPerProducer, "every log should claim a sequence");
+
+    std::vector<LogEvent> events;
+    require(hub.snapshotSince(0, events, 100) == 16, "ring should hold exactly its capacity");
+    for (size_t i = 0; i < events.size(); ++i) {
+        require(events[i].seq == last - 15 + i, "snapshot should return the newest events in order");
+        require(events[i].category == "bench" && events[i].message == "tick", "slot text mismatch");
+        require(events[i].runId && *events[i].runId == 7, "slot run id mismatch");
+    }
+
+    events.clear();
+    require(hub.snapshotSince(last - 2, events) == 2 && events.front().seq == last - 1,
+            "incremental read should return only newer events");
+    events.clear();
+    require(hub.snapshotSince(last, events) == 0, "nothing newer than latestSeq");
+
+    const uint64_t outSeq = hub.outputChange("speed", Value(static_cast<int32_t>(42)), RunId{7});
+    const uint64_t longSeq = hub.log(LogLevel::Warn, "engine", std::string(1000, 'x'));
+    auto tail = hub.snapshot(LogQuery{outSeq - 1, 10});
+    require(tail.size() == 2, "expected output and long log events");
+    require(tail[0].kind == EventKind::OutputChange && tail[0].variableName == std::string("speed") &&
+                tail[0].value && *tail[0].value == Value(static_cast<int32_t>(42)),
+            "output change should keep its variable and value");
+    require(tail[1].seq == longSeq && tail[1].message.size() == AETHERIUM_LOG_MESSAGE_BYTES,
+            "long messages should be truncated to the slot");
+
+    hub.setCapacity(4);
+    events.clear();
+    require(hub.snapshotSince(0, events) == 4 && events.back().seq == longSeq,
+            "shrinking should keep the newest events");
+
+    pass("telemetry_log_hub_ring_across_producers");
+}
+
+void testTelemetryLogHubAsyncStreams() {
+    TelemetryLogHub hub(64);
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+    std::vector<uint64_t> newestSeqs;
+    std::vector<uint64_t> oldestSeqs;
+
+    StreamOptions dropNewest;
+    dropNewest.async = true;
+    dropNewest.queueCapacity = 4;
+    dropNewest.overflow = StreamOverflow::DropNewest;
+    dropNewest.name = "slow";
+    hub.stream([&](const LogEvent& event) {
+        entered.store(true);
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        newestSeqs.push_back(event.seq);
+    }, dropNewest);
+
+    StreamOptions dropOldest = dropNewest;
+    dropOldest.overflow = StreamOverflow::DropOldest;
+    dropOldest.name.clear();
+    hub.stream([&](const LogEvent& event) { oldestSeqs.push_back(event.seq); }, dropOldest);
+
+    uint64_t syncSeen = 0;
+    hub.stream([&](const LogEvent&) { ++syncSeen; });
+
+    const uint64_t first = hub.log(LogLevel::Info, "test", "first");
+    const auto waitUntil = [](const auto& done) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!done()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                fail("timed out waiting for the log dispatcher");
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    };
+    waitUntil([&] { return entered.load(); });
+
+    // The dispatcher is stuck in the first subscriber; producers must not be
+    for (int i = 0; i < 10; ++i) {
+        hub.log(LogLevel::Info, "test", "burst");
+    }
+    require(syncSeen == 11, "sync subscribers should still run inside push");
+
+    auto stats = hub.streamStats();
+    require(stats.size() == 3, "expected one stats entry per subscriber");
+    require(stats[0].name == "slow" && stats[0].async && stats[0].queued == 4 && stats[0].dropped == 6,
+            "drop-newest queue should keep the first events that fit");
+    require(stats[1].name == "stream-1" && stats[1].queued == 4 && stats[1].dropped == 7,
+            "drop-oldest queue should keep the newest events");
+    require(!stats[2].async && stats[2].delivered == 11 && stats[2].dropped == 0, "sync stream stats mismatch");
+
+    release.store(true);
+    waitUntil([&] {
+        const auto now = hub.streamStats();
+        return now[0].delivered == 5 && now[1].delivered == 4;
+    });
+    require(newestSeqs == std::vector<uint64_t>({first, first + 1, first + 2, first + 3, first + 4}),
+            "drop-newest subscriber should see the oldest events");
+    require(oldestSeqs == std::vector<uint64_t>({first + 7, first + 8, first + 9, first + 10}),
+            "drop-oldest subscriber should see the newest events");
+
+    std::vector<uint64_t> blockedSeqs;
+    {
+        TelemetryLogHub blocking(64);
+        StreamOptions block;
+        block.async = true;
+        block.queueCapacity = 2;
+        block.overflow = StreamOverflow::Block;
+        blocking.stream([&](const LogEvent& event) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            blockedSeqs.push_back(event.seq);
+        }, block);
+        for (int i = 0; i < 50; ++i) {
+            blocking.log(LogLevel::Info, "test", "steady");
+        }
+        require(blocking.streamStats()[0].dropped == 0, "block policy should not drop");
+    }
+    require(blockedSeqs.size() == 50 && blockedSeqs.back() == 50, "block policy should deliver every event");
+
+    pass("telemetry_log_hub_async_streams");
+}
+
+void testTickProfileHistogramsAndPhases() {
+    for (uint64_t value : {0ull, 7ull, 8ull, 9ull, 15ull, 16ull, 1000ull, 123456789ull, (1ull << 39) + 5}) {
+        const size_t bucket = LatencyHistogram::bucketOf(value);
+        require(LatencyHistogram::bucketLow(bucket) <= value && value <= LatencyHistogram::bucketHigh(bucket),
+                "value should fall inside its bucket");
+    }
+    require(LatencyHistogram::bucketOf(UINT64_MAX) == LatencyHistogram::BUCKETS - 1,
+            "huge values should land in the last bucket");
+
+#if AETHERIUM_PROFILING
+    LatencyHistogram histogram;
+    for (uint64_t v = 1; v <= 1000; ++v) {
+        histogram.record(v * 1000);
+    }
+    require(histogram.count() == 1000 && histogram.min() == 1000 && histogram.max() == 1000000,
+            "histogram should track count, min and max");
+    const uint64_t p50 = histogram.percentile(0.5);
+    require(p50 >= 500000 && p50 <= 500000 + 500000 / 8, "p50 should be within one bucket width");
+    require(histogram.percentile(1.0) == 1000000, "p100 should be capped at max");
+
+    const Automata automata = makeLevelAutomata();
+    auto clock = std::make_unique<ManualClock>();
+    ManualClock* clockPtr = clock.get();
+    Runtime runtime(std::move(clock), std::make_unique<StdRandomSource>(1),
+                    std::make_unique<CountingScriptEngine>());
+    require(runtime.load(automata).isOk(), "load failed");
+    require(runtime.start().isOk(), "start failed");
+    for (int i = 0; i < 20; ++i) {
+        clockPtr->advance(1);
+        runtime.tick();
+    }
+    require(runtime.setInput("level", Value(20)).isOk(), "set level failed");
+    clockPtr->advance(1);
+    require(runtime.tick(), "level 20 should fire");
+
+    const RuntimeProfile& profile = runtime.profile();
+    require(profile.tick.count() == 21, "every tick should be timed");
+    require(profile.guard.count() == 42, "every guard evaluation should be timed");
+    require(profile.phase(TickPhase::Guards).calls == 21 && profile.phase(TickPhase::Timers).calls == 21,
+            "guard and timer phases run once per tick");
+    require(profile.phase(TickPhase::StateBody).calls == 20 && profile.phase(TickPhase::Transition).calls == 1,
+            "idle ticks run the body, the last one fires");
+    runtime.resetProfile();
+    require(runtime.profile().tick.count() == 0, "reset should clear the profile");
+#endif
+
+    protocol::ProfileMessage message;
+    message.runId = 3;
+    message.reset = true;
+    message.timestamp = 99;
+    message.phases = {{static_cast<uint8_t>(TickPhase::Guards), 1234, 5}};
+    protocol::ProfileHistogramEntry entry;
+    entry.kind = static_cast<uint8_t>(ProfileHistogramKind::Tick);
+    entry.count = 3;
+    entry.sumNs = 30;
+    entry.minNs = 9;
+    entry.maxNs = 11;
+    entry.buckets = {{9, 2}, {11, 1}};
+    message.histograms.push_back(entry);
+    message.order = static_cast<uint8_t>(CodeCostOrder::Memory);
+    message.codeBlocks.push_back({static_cast<uint8_t>(CodeSite::Guard), 7, 500, 4, 64});
+    const std::vector<uint8_t> frame = message.serialize();
+    require(message.serializedSize() == frame.size(), "profile size mismatch");
+    auto decoded = protocol::MessageFactory::deserialize(frame);
+    require(decoded && decoded->type() == protocol::MessageType::Profile, "profile should decode");
+    const auto& roundtrip = static_cast<const protocol::ProfileMessage&>(*decoded);
+    require(roundtrip.runId == 3 && roundtrip.reset && roundtrip.phases.size() == 1 &&
+                roundtrip.phases[0].totalNs == 1234 && roundtrip.histograms.size() == 1 &&
+                roundtrip.histograms[0].buckets.size() == 2 && roundtrip.histograms[0].buckets[1].index == 11 &&
+                roundtrip.order == static_cast<uint8_t>(CodeCostOrder::Memory) && roundtrip.codeBlocks.size() == 1 &&
+                roundtrip.codeBlocks[0].ownerId == 7 && roundtrip.codeBlocks[0].allocatedBytes == 64,
+            "profile should roundtrip");
+
+    pass("tick_profile_histograms_and_phases");
+}
+
+void testScriptCostPerCodeBlock() {
+#if AETHERIUM_PROFILING
+    Automata automata = makeLevelAutomata();
+    CodeBlock body;
+    body.source = "count = count + 1";
+    automata.getState(1)->body = body;
+    automata.getState(1)->onEnter = body;
+    automata.getState(2)->onEnter = body;
+
+    auto clock = std::make_unique<ManualClock>();
+    ManualClock* clockPtr = clock.get();
+    Runtime runtime(std::move(clock), std::make_unique<StdRandomSource>(1),
+                    std::make_unique<CountingScriptEngine>());
+    runtime.setNativeGuards(false);  // Charge `level > 10` to the script
+    require(runtime.load(automata).isOk(), "load failed");
+    require(runtime.start().isOk(), "start failed");
+    for (int i = 0; i < 20; ++i) {
+        clockPtr->advance(1);
+        runtime.tick();
+    }
+    require(runtime.setInput("level", Value(20)).isOk(), "set level failed");
+    clockPtr->advance(1);
+    require(runtime.tick(), "level 20 should fire");
+
+    const ScriptProfile& scripts = runtime.profile().scripts;
+    const CodeBlockCost idleBody = scripts.cost(CodeSite::Body, 1);
+    require(idleBody.calls == 20 && idleBody.allocatedBytes == 20 * 16, "idle body should be charged per tick");
+    require(scripts.cost(CodeSite::OnEnter, 1).calls == 1 && scripts.cost(CodeSite::OnEnter, 2).calls == 1,
+            "each on_enter ran once");
+    require(scripts.cost(CodeSite::Guard, 1).calls == 21 && scripts.cost(CodeSite::Guard, 1).allocatedBytes == 0,
+            "guard calls should be charged to their transition");
+    require(scripts.cost(CodeSite::OnExit, 1).calls == 0, "empty hooks are not charged");
+
+    auto entries = scripts.entries();
+    require(entries.size() == 5, "two guards, one body and two on_enter ran");
+    sortCodeCosts(entries, CodeCostOrder::Calls);
+    require(entries[0].site == CodeSite::Guard && entries[0].cost.calls == 21, "guards ran most often");
+    sortCodeCosts(entries, CodeCostOrder::Memory);
+    require(entries[0].site == CodeSite::Body && entries[0].ownerId == 1, "the body allocated most");
+
+    runtime.resetProfile();
+    require(runtime.profile().scripts.entries().empty(), "reset should clear script costs");
+#endif
+    pass("script_cost_per_code_block");
+}
+
+void testGcPolicyKeepsFullCollectsOffTheTickPath() {
+    auto makeRuntime = [](ManualClock*& clockPtr, CountingScriptEngine*& scriptPtr) {
+        auto clock = std::make_unique<ManualClock>();
+        auto script = std::make_unique<CountingScriptEngine>();
+        clockPtr = clock.get();
+        scriptPtr = script.get();
+        return std::make_unique<Runtime>(std::move(clock), std::make_unique<StdRandomSource>(1), std::move(script));
+    };
+    Automata automata = makeLevelAutomata();
+    Transition back(3, "back", 2, 1);
+    back.type = TransitionType::Immediate;
+    automata.addTransition(back);
+
+    ManualClock* clockPtr = nullptr;
+    CountingScriptEngine* script = nullptr;
+    auto runtime = makeRuntime(clockPtr, script);
+    GcPolicy policy;
+    policy.mode = GcMode::Incremental;
+    runtime->setGcPolicy(policy);
+    require(runtime->load(automata).isOk() && runtime->start().isOk(), "load/start failed");
+    require(runtime->setInput("level", Value(20)).isOk(), "set level failed");
+    for (int i = 0; i < 200; ++i) {
+        clockPtr->advance(1);
+        runtime->tick();  // Fires every tick: Idle <-> High
+    }
+    require(runtime->context().transitionCount == 200, "every tick should fire");
+    require(script->fullCollects == 0 && script->gcSteps == 0, "incremental mode must not collect on ticks");
+
+    require(runtime->collectGarbageIdle(1000000), "idle time should step the collector");
+    require(script->gcSteps == 3, "stepping stops once a cycle completes");
+    require(!runtime->collectGarbageIdle(1000000), "no tick since the last cycle: nothing to do");
+    clockPtr->advance(1);
+    runtime->tick();
+    require(!runtime->collectGarbageIdle(0), "a zero budget does nothing");
+    require(runtime->collectGarbageIdle(1000000) && script->gcSteps == 6, "a tick makes idle GC due again");
+
+    policy.watermarkBytes = 1024;
+    runtime->setGcPolicy(policy);
+    script->heapBytes = 4096;
+    clockPtr->advance(1);
+    runtime->tick();
+    require(script->gcSteps == 7 && script->fullCollects == 0, "over the watermark a tick takes one step");
+
+    auto full = makeRuntime(clockPtr, script);
+    policy = GcPolicy{};
+    policy.mode = GcMode::Full;
+    full->setGcPolicy(policy);
+    require(full->load(automata).isOk() && full->start().isOk(), "load/start failed");
+    for (int i = 0; i < 100; ++i) {
+        clockPtr->advance(1);
+        full->tick();
+    }
+    require(script->fullCollects == 1 && !full->collectGarbageIdle(1000000), "full mode keeps the fixed cadence");
+    require(full->setInput("level", Value(20)).isOk(), "set level failed");
+    clockPtr->advance(1);
+    full->tick();
+    require(script->fullCollects == 2, "full mode collects after a transition");
+
+    pass("gc_policy_keeps_full_collects_off_tick_path");
+}
+
+void testLuaArenaPoolsAndBudget() {
+    require(LuaArena::classOf(1) == 0 && LuaArena::classOf(8) == 0 && LuaArena::classOf(9) == 1 &&
+                LuaArena::classOf(64) == 7 && LuaArena::classOf(65) == 8 && LuaArena::classOf(512) == 13,
+            "size classes should round up");
+
+    LuaArena arena(64 * 1024);
+    // Lua passes a type tag as osize for new blocks
+    void* small = LuaArena::alloc(&arena, nullptr, 4, 20);
+    require(small != nullptr && arena.stats().inUse == 20, "small block should come from a pool");
+    std::memset(small, 0xAB, 20);
+    require(LuaArena::alloc(&arena, small, 20, 24) == small, "growth within a class stays in place");
+    void* moved = LuaArena::alloc(&arena, small, 24, 200);
+    require(moved != nullptr && moved != small && static_cast<unsigned char*>(moved)[19] == 0xAB,
+            "growth across classes should copy");
+    void* large = LuaArena::alloc(&arena, nullptr, 0, 4000);
+    require(large != nullptr && arena.stats().inUse == 4200, "large block should be tracked");
+    require(arena.stats().reserved >= LuaArena::SLAB_BYTES + 4000, "slabs and large blocks are reserved");
+
+    require(LuaArena::alloc(&arena, nullptr, 0, 64 * 1024) == nullptr && arena.stats().failures == 1,
+            "growth past the budget should fail");
+    require(LuaArena::alloc(&arena, large, 4000, 100) != nullptr, "shrinking is never refused");
+
+    // Freed blocks are reused before a new slab is taken
+    std::vector<void*> blocks;
+    for (int i = 0; i < 100; ++i) {
+        blocks.push_back(LuaArena::alloc(&arena, nullptr, 0, 32));
+    }
+    const size_t reserved = arena.stats().reserved;
+    for (void* block : blocks) {
+        LuaArena::alloc(&arena, block, 32, 0);
+    }
+    for (int i = 0; i < 100; ++i) {
+        blocks[static_cast<size_t>(i)] = LuaArena::alloc(&arena, nullptr, 0, 32);
+    }
+    require(arena.stats().reserved == reserved, "freed blocks should be recycled");
+    for (void* block : blocks) {
+        LuaArena::alloc(&arena, block, 32, 0);
+    }
+    require(arena.stats().peak >= 4200 && arena.stats().allocated >= 4200, "peak and totals should be kept");
+
+    pass("lua_arena_pools_and_budget");
+}
+
+void testNativeGuardsSkipTheScript() {
+    Automata automata = makeLevelAutomata();
+    automata.addVariable(VariableSpec(3, "enabled", ValueType::Bool, VariableDirection::Input, Value(true)));
+    automata.addVariable(VariableSpec(4, "name", ValueType::String, VariableDirection::Input, Value("a")));
+
+    auto compiles = [&](const std::string& source) {
+        std::vector<GuardInstr> program;
+        return compileNativeGuard(guard(source), automata, program);
+    };
+    require(compiles("level > 10 and enabled"), "comparison and boolean should compile");
+    require(compiles("not ((level + 2) * 3 >= 9.5e0) or value('mode') ~= -1"), "arithmetic should compile");
+    require(compiles("changed(\"level\") == enabled"), "changed() and boolean equality should compile");
+    require(!compiles("now() > 1e12"), "other calls stay with the script");
+    require(!compiles("name == 'a'"), "strings stay with the script");
+    require(!compiles("level"), "a numeric result keeps Lua truthiness in the script");
+    require(!compiles("level > 1 and mode"), "and on a number returns the number in Lua");
+    require(!compiles("level < mode < 3"), "chained comparison compares a boolean with a number");
+    require(!compiles("level > 3 -- 3"), "comments stay with the script");
+    require(!compiles("level // 2 > 1"), "floor division stays with the script");
+
+    CodeBlock statement = guard("return level >= 10");
+    statement.kind = CodeKind::Statement;
+    std::vector<GuardInstr> program;
+    require(compileNativeGuard(statement, automata, program), "statement guard with return should compile");
+    require(!compiles("return level >= 10"), "expression guard cannot start with return");
+    for (int i = 0; i < 40; ++i) {
+        require(compileNativeGuard(guard("level > " + std::to_string(i)), automata, program),
+                "the instruction limit applies per program, not to the shared buffer");
+    }
+    program.clear();
+
+    VariableStore store;
+    for (const auto& spec : automata.variables) {
+        store.addVariable(spec);
+    }
+    program.clear();
+    require(compileNativeGuard(guard("level / 4 > 2 and not enabled"), automata, program), "compile failed");
+    store.setExternalValue("level", Value(12));
+    auto result = evaluateNativeGuard(program.data(), program.size(), store);
+    require(result && !*result, "enabled blocks the guard");
+    store.setExternalValue("enabled", Value(false));
+    result = evaluateNativeGuard(program.data(), program.size(), store);
+    require(result && *result, "12 / 4 > 2 with enabled off");
+
+    // The guard fires without the script engine
+    auto script = std::make_unique<CountingScriptEngine>();
+    CountingScriptEngine* scriptPtr = script.get();
+    auto clock = std::make_unique<ManualClock>();
+    ManualClock* clockPtr = clock.get();
+    Runtime runtime(std::move(clock), std::make_unique<StdRandomSource>(1), std::move(script));
+    require(runtime.load(automata).isOk() && runtime.start().isOk(), "load/start failed");
+    require(runtime.nativeGuardCount() == 1, "only level > 10 is native");
+    clockPtr->advance(1);
+    require(!runtime.tick(), "nothing fires at level 0");
+    require(runtime.context().nativeGuards == 1 && scriptPtr->conditions == 1,
+            "the clock guard alone should reach the script");
+    require(runtime.setInput("level", Value(20)).isOk(), "set level failed");
+    clockPtr->advance(1);
+    require(runtime.tick() && runtime.context().currentState == 2, "level 20 should fire natively");
+    require(scriptPtr->conditions == 2, "still one script guard per tick");
+
+    pass("native_guards_skip_the_script");
+}
+
+
+void testScriptVmRunsCompiledBlocks() {
+    Automata automata = makeLevelAutomata();
+    automata.addVariable(VariableSpec(3, "out", ValueType::Float64, VariableDirection::Output, Value(0.0)));
+    automata.addVariable(VariableSpec(4, "flag", ValueType::Bool, VariableDirection::Internal, Value(false)));
+    automata.addVariable(VariableSpec(5, "name", ValueType::String, VariableDirection::Internal, Value("a")));
+
+    auto compiles = [&](const std::string& source, CodeKind kind) {
+        return compileScriptVm(source, kind, automata.variables).isOk();
+    };
+    require(!compiles("level = 3", CodeKind::Statement), "inputs cannot be assigned");
+    require(!compiles("setOutput('flag', 1)", CodeKind::Statement), "setOutput needs an output");
+    require(!compiles("name == 'a'", CodeKind::Expression), "strings are not supported");
+    require(!compiles("while level > 0 do end", CodeKind::Statement), "loops are not supported");
+    require(!compiles("return 1 out = 2", CodeKind::Statement), "nothing may follow a return");
+
+    const std::string body =
+        "local x = level * 2 -- doubled\n"
+        "if x > 10 then setOutput(\"out\", clamp(x, 0, 15))\n"
+        "elseif x == 2 then flag = true\n"
+        "else out = -1 - x % 3 end";
+    auto chunk = compileScriptVm(body, CodeKind::Statement, automata.variables);
+    require(chunk.isOk(), "body should compile");
+
+    VariableStore store;
+    for (const auto& spec : automata.variables) {
+        store.addVariable(spec);
+    }
+    auto run = [&](int32_t level) {
+        store.setExternalValue("level", Value(level));
+        return runScriptVm(chunk.value().data(), chunk.value().size(), store);
+    };
+    require(run(12).ok && store.getValue("out")->get<double>() == 15.0, "clamped output expected");
+    require(run(1).ok && store.getValue("flag")->get<bool>(), "elseif branch expected");
+    require(run(2).ok && store.getValue("out")->get<double>() == -2.0, "else branch with floored modulo");
+
+    // Chunks travel in code.bytecode under the VM target
+    SimpleScriptEngine engine;
+    require(engine.initialize(&store).isOk(), "initialize failed");
+    CodeBlock condition = guard("level % 4 == 1 and not flag");
+    condition.bytecode = tagLuaChunk(SCRIPT_VM_TARGET, CodeKind::Expression,
+                                     compileScriptVm(condition.text(), CodeKind::Expression,
+                                                     automata.variables).value());
+    store.setExternalValue("level", Value(5));
+    auto fired = engine.evaluateCondition(condition);
+    require(fired.isOk() && !fired.value(), "flag is still set");
+    store.setValue("flag", Value(false));
+    fired = engine.evaluateCondition(condition);
+    require(fired.isOk() && fired.value(), "5 % 4 == 1 without flag");
+
+    CodeBlock write = guard("out = 7");
+    write.kind = CodeKind::Statement;
+    write.bytecode = tagLuaChunk(SCRIPT_VM_TARGET, CodeKind::Statement,
+                                 compileScriptVm("out = 7", CodeKind::Statement, automata.variables).value());
+    engine.setReplayMode(true);
+    require(engine.execute(write).isOk() && store.getValue("out")->get<double>() == -2.0,
+            "replay suppresses variable writes");
+    engine.setReplayMode(false);
+    require(engine.execute(write).isOk() && store.getValue("out")->get<double>() == 7.0, "write expected");
+
+    ir::EngineBytecodeProgram program;
+    for (const auto& spec : automata.variables) {
+        program.variables.push_back(ir::BytecodeVariable{spec.id, spec.name, spec.type, spec.direction, spec.initialValue});
+    }
+    ir::BytecodeState state;
+    state.id = 1;
+    state.bodySource = "out = getVal('level') + 0.5";
+    program.states.push_back(state);
+    require(compileScriptVmChunks(program).isOk(), "program should compile");
+    require(program.luaTarget == SCRIPT_VM_TARGET && program.luaChunks.size() == 1 &&
+                program.luaChunks[0].slot == ir::LuaChunkSlot::StateBody,
+            "one VM chunk for the state body");
+    program.states[0].onExitSource = "gpio.read(name)";
+    require(compileScriptVmChunks(program).isError(), "unsupported blocks fail the program");
+
+    // Source-loaded blocks are compiled when the runtime prepares the engine
+    Automata machine = makeLevelAutomata();
+    machine.addVariable(VariableSpec(3, "out", ValueType::Float64, VariableDirection::Output, Value(0.0)));
+    machine.transitions.at(2).classicConfig.condition = guard("mode == 1");
+    machine.states.at(2).onEnter = guard("out = level * 2");
+    machine.states.at(2).onEnter.kind = CodeKind::Statement;
+    auto clock = std::make_unique<ManualClock>();
+    ManualClock* clockPtr = clock.get();
+    Runtime runtime(std::move(clock), std::make_unique<StdRandomSource>(1), std::make_unique<SimpleScriptEngine>());
+    runtime.setNativeGuards(false);
+    require(runtime.load(machine).isOk() && runtime.start().isOk(), "load/start failed");
+    require(runtime.setInput("level", Value(20)).isOk(), "set level failed");
+    clockPtr->advance(1);
+    require(runtime.tick() && runtime.context().currentState == 2, "level 20 should fire");
+    require(runtime.context().variables.getValue("out") == Value(40.0), "onEnter should run on the VM");
+
+    pass("script_vm_runs_compiled_blocks");
+}
+
+
+void testFlashRuntimeRunsFromTables() {
+    ir::EngineBytecodeProgram program;
+    program.name = "flash-smoke";
+    program.initialState = 1;
+    program.variables.push_back(ir::BytecodeVariable{1, "level", ValueType::Int32, VariableDirection::Input, Value(0)});
+    program.variables.push_back(ir::BytecodeVariable{2, "out", ValueType::Float64, VariableDirection::Output, Value(0.0)});
+    ir::BytecodeState idle;
+    idle.id = 1;
+    idle.name = "Idle";
+    idle.bodySource = "out = out + 1";
+    ir::BytecodeState high;
+    high.id = 2;
+    high.name = "High";
+    high.onEnterSource = "out = level * 2";
+    ir::BytecodeState done;
+    done.id = 3;
+    done.name = "Done";
+    program.states = {idle, high, done};
+    ir::BytecodeTransition up;
+    up.id = 1;
+    up.from = 1;
+    up.to = 2;
+    up.kind = ir::BytecodeTransitionKind::ClassicCondition;
+    up.conditionExpression = "level > 10";
+    ir::BytecodeTransition timeout;
+    timeout.id = 2;
+    timeout.from = 1;
+    timeout.to = 3;
+    timeout.kind = ir::BytecodeTransitionKind::TimedTimeout;
+    timeout.delayMs = 100;
+    program.transitions = {timeout, up};
+
+    auto header = emitFlashTables(program, "flash_smoke");
+    require(header.isOk(), "tables should generate");
+    require(header.value().find("inline constexpr aeth::FlashAutomata flash_smoke AETHERIUM_FLASH") != std::string::npos,
+            "header should define the automaton");
+    require(emitFlashTables(program, "9bad").isError(), "symbol must be an identifier");
+    program.transitions[1].weight = 50;
+    require(emitFlashTables(program, "flash_smoke").isError(), "weights are rejected");
+
+    // Tables as the generated header lays them out
+    std::vector<uint8_t> code;
+    auto chunk = [&](const std::string& source, CodeKind kind) {
+        auto bytes = compileScriptVm(source, kind, program.variables).value();
+        FlashCode at{static_cast<uint32_t>(code.size()), static_cast<uint16_t>(bytes.size())};
+        code.insert(code.end(), bytes.begin(), bytes.end());
+        return at;
+    };
+    const FlashCode body = chunk("out = out + 1", CodeKind::Statement);
+    const FlashCode enter = chunk("out = level * 2", CodeKind::Statement);
+    const FlashCode condition = chunk("level > 10", CodeKind::Expression);
+    const FlashVariable variables[] = {
+        {1, ValueType::Int32, VariableDirection::Input, "level", 0.0},
+        {2, ValueType::Float64, VariableDirection::Output, "out", 0.0}};
+    const FlashTransition transitions[] = {
+        {1, 1, ir::BytecodeTransitionKind::ClassicCondition, 0, 0, condition, {}, {}, INVALID_VARIABLE,
+         EventTrigger::OnChange, CompareOp::Gt, 0.0},
+        {2, 2, ir::BytecodeTransitionKind::TimedTimeout, 0, 100, {}, {}, {}, INVALID_VARIABLE,
+         EventTrigger::OnChange, CompareOp::Gt, 0.0}};
+    const FlashState states[] = {
+        {1, "Idle", {}, body, {}, 0, 2},
+        {2, "High", enter, {}, {}, 2, 2},
+        {3, "Done", {}, {}, {}, 2, 2}};
+    const FlashAutomata tables{"flash-smoke", 0, variables, 2, states, 3, transitions, 2,
+                               code.data(), static_cast<uint32_t>(code.size()), 0};
+
+    FlashRuntime runtime(&tables);
+    require(runtime.start(1000).isOk() && runtime.currentStateName() == "Idle", "start in Idle");
+    require(!runtime.tick(1010) && !runtime.tick(1020), "nothing fires yet");
+    require(runtime.variables().getValue("out") == Value(2.0), "body ran twice");
+    require(runtime.variables().setExternalValue("level", Value(12)), "set level failed");
+    require(runtime.tick(1030) && runtime.currentState() == 2, "the guard beats the timeout");
+    require(runtime.variables().getValue("out") == Value(24.0) && runtime.lastError().empty(), "onEnter ran");
+    require(!runtime.tick(1040) && !runtime.isRunning(), "High is terminal");
+
+    require(runtime.start(0).isOk() && runtime.tick(150) && runtime.currentState() == 3,
+            "the timeout fires as fallback");
+
+    pass("flash_runtime_runs_from_tables");
+}
+
+} // namespace
+
+void testSerialRingParsesFramesInPlace() {
+    namespace platform = aeth::embedded::platform;
+    platform::SerialRing<64> ring;
+    uint8_t scratch[64]{};
+
+    protocol::PingMessage ping;
+    ping.messageId = 7;
+    ping.sequenceNumber = 42;
+    const auto frame = ping.serialize();
+    require(frame.size() < 40, "ping frame should fit twice in the ring");
+
+    std::vector<std::vector<uint8_t>> frames;
+    std::vector<bool> copied;
+    auto collect = [&](const uint8_t* data, size_t len) {
+        frames.emplace_back(data, data + len);
+        copied.push_back(data == scratch);
+    };
+
+    // Garbage ahead of the first frame, then a frame split across pushes
+    const uint8_t noise[] = {0x00, 0xAE, 0x13, 0x37, 0xFF};
+    require(ring.write(noise, sizeof(noise)) == sizeof(noise), "noise should fit");
+    require(ring.write(frame.data(), 10) == 10, "frame head should fit");
+    platform::parseFrames(ring, scratch, collect);
+    require(frames.empty(), "partial frame should wait for the rest");
+    require(ring.write(frame.data() + 10, frame.size() - 10) == frame.size() - 10, "frame tail should fit");
+    platform::parseFrames(ring, scratch, collect);
+    require(frames.size() == 1 && frames[0] == frame && !copied[0], "first frame should parse in place");
+
+    // The second frame wraps the storage and comes out of the scratch buffer
+    for (uint8_t byte : frame) {
+        require(ring.push(byte), "second frame should fit");
+    }
+    platform::parseFrames(ring, scratch, collect);
+    require(frames.size() == 2 && frames[1] == frame && copied[1], "wrapped frame should be copied out whole");
+    require(ring.empty(), "parsed frames should be consumed");
+
+    // A header announcing more than the ring holds is skipped, not waited on
+    const uint8_t oversized[] = {0xAE, 0x01, 0x01, 0x01, 0x00, 0x80};
+    ring.write(oversized, sizeof(oversized));
+    ring.write(frame.data(), frame.size());
+    platform::parseFrames(ring, scratch, collect);
+    require(frames.size() == 3 && frames[2] == frame, "parser should resync past an oversized header");
+
+    // Full ring drops new bytes instead of overwriting unread ones
+    uint8_t fill[64]{};
+    require(ring.write(fill, sizeof(fill)) == 64 && !ring.push(1) && ring.overruns() == 1,
+            "full ring should refuse and count the overrun");
+    pass("serial_ring_parses_frames_in_place");
+}
+
+void testFrameBatcherPacksUpToMtu() {
+    aeth::embedded::platform::FrameBatcher<64> batcher(20);
+    std::vector<std::vector<uint8_t>> writes;
+    auto sink = [&](const uint8_t* data, size_t len) { writes.emplace_back(data, data + len); };
+
+    const std::vector<uint8_t> frame(24, 0xAB);
+    batcher.append(frame.data(), frame.size(), 100, sink);
+    batcher.append(frame.data(), frame.size(), 105, sink);
+    require(writes.empty() && batcher.pendingFrames() == 2, "two frames should share one batch");
+    require(!batcher.flushIfDue(119, sink), "batch should wait for its deadline");
+
+    // A third frame would pass the MTU, so the first two go out together
+    batcher.append(frame.data(), frame.size(), 110, sink);
+    require(writes.size() == 1 && writes[0].size() == 48, "full batch should go out as one write");
+    require(batcher.flushIfDue(130, sink) && writes.size() == 2 && writes[1].size() == 24,
+            "deadline should flush the partial batch");
+
+    // Oversized frames bypass the buffer after whatever was pending
+    const std::vector<uint8_t> big(100, 0xCD);
+    batcher.append(frame.data(), frame.size(), 200, sink);
+    batcher.append(big.data(), big.size(), 200, sink);
+    require(writes.size() == 4 && writes[2].size() == 24 && writes[3] == big && batcher.empty(),
+            "oversized frame should follow the flushed batch");
+    pass("frame_batcher_packs_up_to_mtu");
+}
+
+void testComponentMethodsResolveOnceAndCallByIndex() {
+    // Only invoke() is implemented, so resolve() and call() use the defaults
+    class EchoComponent final : public aeth::IComponent {
+    public:
+        const std::string& name() const override { return name_; }
+        std::vector<std::string> methods() const override { return {"count", "first"}; }
+        aeth::Result<aeth::Value> invoke(const std::string& method, const std::vector<aeth::Value>& args) override {
+            ++invokes;
+            if (method == "count") return aeth::Result<aeth::Value>::ok(aeth::Value(static_cast<int64_t>(args.size())));
+            if (method == "first") return aeth::Result<aeth::Value>::ok(args.empty() ? aeth::Value() : args[0]);
+            return aeth::Result<aeth::Value>::error("unknown component method: " + method);
+        }
+        int invokes = 0;
+
+    private:
+        std::string name_ = "echo";
+    };
+
+    EchoComponent component;
+    const aeth::ComponentMethod count = component.resolve("count");
+    const aeth::ComponentMethod first = component.resolve("first");
+    require(count == 0 && first == 1, "methods should resolve to their index");
+    require(component.resolve("missing") == aeth::INVALID_COMPONENT_METHOD, "unknown method should not resolve");
+
+    aeth::InlineValueArgs<> small(2);
+    small[0] = aeth::Value(static_cast<int64_t>(7));
+    small[1] = aeth::Value(true);
+    auto firstResult = component.call(first, small.span());
+    require(firstResult.isOk() && firstResult.value().toInt() == 7, "call should forward borrowed arguments");
+
+    // Past the inline capacity the arguments spill to the heap
+    aeth::InlineValueArgs<2> spilled(5);
+    for (size_t i = 0; i < 5; ++i) {
+        spilled[i] = aeth::Value(static_cast<int64_t>(i));
+    }
+    auto countResult = component.call(count, spilled.span());
+    require(countResult.isOk() && countResult.value().toInt() == 5 && spilled.span()[4].toInt() == 4,
+            "spilled arguments should all reach the component");
+    require(component.call(aeth::INVALID_COMPONENT_METHOD, {}).isError() && component.invokes == 2,
+            "invalid method id should fail without invoking");
+
+    const std::array<const char*, 3> names = {"init", "read", "write"};
+    require(aeth::resolveMethod(names, "write") == 2 && aeth::resolveMethod(names, "x") == aeth::INVALID_COMPONENT_METHOD,
+            "resolveMethod should index a fixed name table");
+    pass("component_methods_resolve_once_and_call_by_index");
+}
+
+struct Dimmer {
+    aeth::Result<aeth::Value> level() { return aeth::Result<aeth::Value>::ok(aeth::Value(static_cast<int64_t>(level_))); }
+    aeth::Result<aeth::Value> set(aeth::ValueSpan args) {
+        level_ = static_cast<int>(args[0].toInt()) + (args.size() > 1 && args[1].toBool() ? 100 : 0);
+        return level();
+    }
+    aeth::Result<aeth::Value> label(const std::vector<aeth::Value>& args) {
+        return aeth::Result<aeth::Value>::ok(aeth::Value(args[0].toString() + "!"));
+    }
+    int level_ = 0;
+};
+
+constexpr aeth::ComponentMethodDescriptor kDimmerMethods[] = {
+    {"level", "", &aeth::invokeComponentMethod<&Dimmer::level, Dimmer>},
+    {"set", "i|b", &aeth::invokeComponentMethod<&Dimmer::set, Dimmer>},
+    {"label", "s", &aeth::invokeComponentMethod<&Dimmer::label, Dimmer>},
+};
+constexpr aeth::ComponentDescriptor kDimmerComponent = {"dimmer", kDimmerMethods, 3};
+static_assert(kDimmerComponent.methods[2].signature[0] == 's', "method tables should be constant data");
+
+void testStaticComponentCallsThroughItsTable() {
+    Dimmer dimmer;
+    aeth::StaticComponent component(kDimmerComponent, &dimmer);
+    require(component.descriptor() == &kDimmerComponent && component.named("dimmer"),
+            "a table component should expose its descriptor");
+    require(component.resolve("label") == 2 && component.resolve("x") == aeth::INVALID_COMPONENT_METHOD,
+            "methods should resolve to their table index");
+
+    const std::vector<aeth::Value> setArgs = {aeth::Value(static_cast<int64_t>(5)), aeth::Value(true)};
+    auto set = component.call(1, setArgs);
+    require(set.isOk() && set.value().toInt() == 105 && dimmer.level_ == 105, "set should run on the bound instance");
+    auto label = component.invoke("label", {aeth::Value(std::string("on"))});
+    require(label.isOk() && label.value().toString() == "on!", "vector-taking members should still be callable");
+
+    auto missing = component.call(1, {});
+    require(missing.isError() && missing.error() == "dimmer.set: expects at least 1 argument",
+            "a missing required argument should be rejected: " + missing.error());
+    auto extra = component.call(0, setArgs);
+    require(extra.isError() && extra.error() == "dimmer.level: takes no arguments", "extra arguments should be rejected");
+    auto wrongType = component.invoke("label", {aeth::Value(static_cast<int64_t>(1))});
+    require(wrongType.isError() && dimmer.level_ == 105, "a wrongly typed argument should not reach the member");
+    require(component.methods() == std::vector<std::string>({"level", "set", "label"}) && component.name() == "dimmer",
+            "names should come from the table");
+    pass("static_component_calls_through_its_table");
+}
+
+void testActuationBufferCoalescesPerTick() {
+    // Records what reaches the board
+    class RecordingHardware final : public IHardwareService {
+    public:
+        Result<void> gpioMode(int, const std::string&) override { return Result<void>::ok(); }
+        Result<int64_t> gpioRead(int) override { return Result<int64_t>::ok(0); }
+        Result<void> pwmAttach(int, int, int, int) override { return Result<void>::ok(); }
+        Result<int64_t> adcRead(int) override { return Result<int64_t>::ok(0); }
+        Result<int64_t> adcReadMilliVolts(int) override { return Result<int64_t>::ok(0); }
+        Result<void> dacWrite(int, int) override { return Result<void>::ok(); }
+        Result<void> i2cOpen(int, int, int, int) override { return Result<void>::ok(); }
+        Result<std::vector<int>> i2cScan(int) override { return Result<std::vector<int>>::ok({}); }
+        std::vector<std::string> componentNames() const override { return {}; }
+        IComponent* component(const std::string&) override { return nullptr; }
+        Result<void> gpioWrite(int pin, bool high) override {
+            log.push_back("gpio " + std::to_string(pin) + "=" + (high ? "1" : "0"));
+            return Result<void>::ok();
+        }
+        Result<void> pwmWrite(int channel, int duty) override {
+            log.push_back("pwm " + std::to_string(channel) + "=" + std::to_string(duty));
+            return Result<void>::ok();
+        }
+        Result<void> i2cWrite(int bus, int address, const std::vector<uint8_t>& data) override {
+            log.push_back("i2c " + std::to_string(bus) + ":" + std::to_string(address) + "=" + std::to_string(data.at(0)));
+            return Result<void>::ok();
+        }
+        std::vector<std::string> log;
+    };
+
+    RecordingHardware board;
+    BufferedHardwareService buffered(board);
+    buffered.gpioWrite(2, true);
+    buffered.gpioWrite(2, false);
+    buffered.pwmWrite(0, 10);
+    buffered.gpioWrite(2, true);
+    buffered.pwmWrite(0, 20);
+    buffered.i2cWrite(0, 0x21, {1});
+    buffered.i2cWrite(0, 0x20, {7});
+    buffered.i2cWrite(0, 0x21, {1});
+    buffered.i2cWrite(0, 0x21, {2});
+    require(board.log.empty() && buffered.pendingWrites() == 5, "writes should be staged");
+    require(buffered.gpioRead(2).value() == 1, "reads should see the staged level");
+
+    require(buffered.flush().isOk(), "flush failed");
+    const std::vector<std::string> expected = {"gpio 2=1", "pwm 0=20", "i2c 0:32=7", "i2c 0:33=1", "i2c 0:33=2"};
+    require(board.log == expected, "one write per pin and channel, I2C grouped by device");
+    require(buffered.stats().staged == 9 && buffered.stats().coalesced == 4 && buffered.stats().applied == 5,
+            "stats should count staged, coalesced and applied writes");
+
+    // The runtime flushes after start and after every tick; bodies run on the VM
+    board.log.clear();
+    Automata machine = makeLevelAutomata();
+    machine.states.at(1).onEnter = guard("gpio.write(4, 0)");
+    machine.states.at(1).onEnter.kind = CodeKind::Statement;
+    machine.states.at(1).body = guard("gpio.write(4, 1) pwm.write(1, level) gpio.write(4, 0) pwm.write(1, level + 1)");
+    machine.states.at(1).body.kind = CodeKind::Statement;
+    auto clock = std::make_unique<ManualClock>();
+    ManualClock* clockPtr = clock.get();
+    Runtime runtime(std::move(clock), std::make_unique<StdRandomSource>(1), std::make_unique<SimpleScriptEngine>());
+    setHardwareService(&buffered);
+    require(runtime.load(machine).isOk() && runtime.start().isOk(), "load/start failed");
+    require(board.log == std::vector<std::string>{"gpio 4=0"}, "onEnter writes should go out at start");
+    require(runtime.setInput("level", Value(3)).isOk(), "set level failed");
+    clockPtr->advance(1);
+    runtime.tick();
+    setHardwareService(nullptr);
+    const std::vector<std::string> ticked = {"gpio 4=0", "gpio 4=0", "pwm 1=4"};
+    require(board.log == ticked && buffered.pendingWrites() == 0, "a tick should apply its last writes once");
+    pass("actuation_buffer_coalesces_per_tick");
+}
+
+void testDeployCompilerLowersToBytecode() {
+    Automata automata = makeLevelAutomata();
+    automata.addVariable(VariableSpec(3, "out", ValueType::Float64, VariableDirection::Output, Value(0.0)));
+    automata.states.at(2).onEnter = guard("out = level * 2");
+    Transition back(3, "back", 2, 1);
+    back.type = TransitionType::Timed;
+    back.timedConfig.mode = TimedMode::Timeout;
+    back.timedConfig.delayMs = 250;
+    automata.addTransition(back);
+
+    auto program = engineBytecodeFromAutomata(automata);
+    require(program.isOk(), "level automata should lower");
+    const auto& p = program.value();
+    require(p.states.size() == 2 && p.states[0].id == 1 && p.states[1].onEnterSource == "out = level * 2",
+            "states should come out in id order with their sources");
+    require(p.transitions.size() == 3 && p.transitions[0].kind == ir::BytecodeTransitionKind::ClassicCondition &&
+                p.transitions[0].conditionExpression == "level > 10" &&
+                p.transitions[2].kind == ir::BytecodeTransitionKind::TimedTimeout && p.transitions[2].delayMs == 250,
+            "transition kinds and guards should carry over");
+
+    // The clocked guard calls now(), outside the VM subset: sources travel alone
+    auto artifact = compileDeployArtifact(automata, "level.yaml");
+    require(artifact.isOk() && artifact.value().payloadKind == ir::PayloadKind::EngineBytecode,
+            "deploy artifact should carry engine bytecode");
+    auto decoded = ir::deserializeEngineBytecodeProgram(artifact.value().payloadBytes);
+    require(decoded.isOk() && decoded.value().transitions.size() == 3 && decoded.value().luaChunks.empty(),
+            "artifact should decode back to the program");
+
+    automata.transitions.erase(2);
+    auto vm = compileDeployArtifact(automata);
+    decoded = ir::deserializeEngineBytecodeProgram(vm.value().payloadBytes);
+    require(decoded.isOk() && decoded.value().luaTarget == SCRIPT_VM_TARGET && decoded.value().luaChunks.size() == 2,
+            "VM chunks should be attached when every block compiles");
+
+    automata.transitions.at(3).timedConfig.mode = TimedMode::Every;
+    require(engineBytecodeFromAutomata(automata).isError(), "periodic timing is not representable");
+    pass("deploy_compiler_lowers_to_bytecode");
+}
+
+void testDeployArtifactKeepsGuardKinds() {
+    Automata automata = makeLevelAutomata();
+    automata.transitions.erase(2);  // Clocked guard: outside the VM subset
+    automata.transitions.at(1).classicConfig.condition = guard("local hot = level > 10\nreturn hot");
+    automata.transitions.at(1).classicConfig.condition.kind = CodeKind::Statement;
+
+    auto artifact = compileDeployArtifact(automata);
+    require(artifact.isOk(), "statement guard should lower");
+    auto decoded = ir::deserializeEngineBytecodeProgram(artifact.value().payloadBytes);
+    require(decoded.isOk() && decoded.value().versionMinor >= ir::BYTECODE_CODE_KINDS_MINOR &&
+                decoded.value().transitions[0].conditionKind == CodeKind::Statement,
+            "the guard kind should survive the stream format");
+    require(decoded.value().luaChunks.size() == 1, "a statement guard should compile for the VM as a statement");
+
+    auto indexed = ir::serializeIndexedBytecodeProgram(decoded.value());
+    require(indexed.isOk(), "indexed encode failed");
+    auto mapped = ir::MappedBytecodeProgram::open(indexed.value().data(), indexed.value().size());
+    require(mapped.isOk() && mapped.value().transitions[0].conditionKind == CodeKind::Statement,
+            "the guard kind should survive the indexed format");
+
+    automata.states.at(1).onEnter = guard("level");
+    automata.states.at(1).onEnter.kind = CodeKind::Expression;
+    require(engineBytecodeFromAutomata(automata).isError(), "an expression-kind hook should be rejected, not dropped");
+    pass("deploy_artifact_keeps_guard_kinds");
+}
+
+void testDeployArtifactKeepsTelemetryPolicy() {
+    Automata automata = makeLevelAutomata();
+    VariableSpec out(3, "out", ValueType::Float64, VariableDirection::Output, Value(0.0));
+    out.telemetry.windowMs = 1000;
+    out.telemetry.slideMs = 250;
+    out.telemetry.deadband = 0.5;
+    automata.addVariable(std::move(out));
+
+    auto artifact = compileDeployArtifact(automata);
+    require(artifact.isOk(), "compile failed");
+    auto decoded = ir::deserializeEngineBytecodeProgram(artifact.value().payloadBytes);
+    require(decoded.isOk() && decoded.value().versionMinor >= ir::BYTECODE_TELEMETRY_MINOR,
+            "a policy should bump the minor version");
+    const auto& policy = decoded.value().variables[2].telemetry;
+    require(policy.windowMs == 1000 && policy.slideMs == 250 && policy.deadband == 0.5 && policy.minIntervalMs == 0,
+            "the policy should survive the stream format");
+    require(!decoded.value().variables[0].telemetry.enabled(), "inputs keep the default policy");
+
+    auto indexed = ir::serializeIndexedBytecodeProgram(decoded.value());
+    require(indexed.isOk(), "indexed encode failed");
+    auto mapped = ir::MappedBytecodeProgram::open(indexed.value().data(), indexed.value().size());
+    require(mapped.isOk(), "indexed open failed");
+    const auto mappedOut = mapped.value().variables[2];
+    require(mappedOut.name == "out" && mappedOut.telemetry.windowMs == 1000 && mappedOut.telemetry.slideMs == 250 &&
+                mappedOut.telemetry.deadband == 0.5,
+            "the policy should survive the indexed format");
+    pass("deploy_artifact_keeps_telemetry_policy");
+}
+
+void testNestedChildRunsUnderParentState() {
+    // Parent: Idle -> Working on `go`, Working -> Idle once the child reports `done`
+    Automata parent;
+    parent.config.name = "parent";
+    parent.addVariable(VariableSpec(1, "go", ValueType::Bool, VariableDirection::Input, Value(false)));
+    parent.addVariable(VariableSpec(2, "level", ValueType::Int32, VariableDirection::Input, Value(0)));
+    parent.addVariable(VariableSpec(3, "done", ValueType::Bool, VariableDirection::Internal, Value(false)));
+    parent.addState(State(1, "Idle"));
+    parent.addState(State(2, "Working"));
+    parent.initialState = 1;
+    Transition start(1, "start", 1, 2);
+    start.classicConfig.condition = guard("go");
+    parent.addTransition(start);
+    Transition finish(2, "finish", 2, 1);
+    finish.classicConfig.condition = guard("done");
+    parent.addTransition(finish);
+
+    // Child: Waiting -> Reached when the bound level passes 5; Reached reports back
+    Automata child;
+    child.config.name = "worker";
+    child.addVariable(VariableSpec(1, "level", ValueType::Int32, VariableDirection::Input, Value(0)));
+    child.addVariable(VariableSpec(2, "finished", ValueType::Bool, VariableDirection::Output, Value(false)));
+    child.addState(State(1, "Waiting"));
+    child.addState(State(2, "Reached"));
+    child.initialState = 1;
+    child.states.at(2).onEnter = guard("finished = true");
+    child.states.at(2).onEnter.kind = CodeKind::Statement;
+    Transition reach(1, "reach", 1, 2);
+    reach.classicConfig.condition = guard("level > 5");
+    child.addTransition(reach);
+    Transition linger(2, "linger", 1, 1);
+    linger.type = TransitionType::Timed;
+    linger.timedConfig.mode = TimedMode::After;
+    linger.timedConfig.delayMs = 40;
+    child.addTransition(linger);
+
+    auto clock = std::make_unique<ManualClock>();
+    ManualClock* clockPtr = clock.get();
+    Runtime runtime(std::move(clock), std::make_unique<StdRandomSource>(1), std::make_unique<SimpleScriptEngine>());
+    require(runtime.load(parent).isOk(), "parent load failed");
+    require(runtime.addChild(2, child, {{"level", "level"}, {"done", "finished"}}).isOk(), "addChild failed");
+    require(runtime.addChild(2, child, {{"go", "level"}}).isError(), "mismatched binding types must be rejected");
+    require(runtime.childCount() == 1, "a failed addChild should not leave a child behind");
+    require(runtime.start().isOk(), "parent start failed");
+    require(!runtime.msUntilNextTimer().has_value(), "no timer is pending while the child is inactive");
+
+    Runtime* worker = runtime.child(0);
+    for (int i = 0; i < 3; ++i) {
+        clockPtr->advance(1);
+        runtime.tick();
+    }
+    require(runtime.activeChildCount() == 0 && !worker->isRunning() && worker->context().tickCount == 0,
+            "a child of an inactive state should not run");
+
+    require(runtime.setInput("go", Value(true)).isOk(), "set go failed");
+    clockPtr->advance(1);
+    runtime.tick();
+    require(runtime.currentState() == 2 && worker->isRunning() && worker->currentState() == 1,
+            "entering the parent state should start the child");
+    const auto wait = runtime.msUntilNextTimer();
+    require(wait && *wait == 40, "the child's timer should be part of the parent's schedule");
+
+    require(runtime.setInput("level", Value(7)).isOk(), "set level failed");
+    clockPtr->advance(1);
+    runtime.tick();
+    require(worker->currentState() == 2 && runtime.getOutput("done") == Value(true),
+            "child output should reach the parent through the binding");
+    require(runtime.currentState() == 1 && !worker->isRunning() && runtime.activeChildCount() == 0,
+            "the parent should react in the same tick and stop the child on exit");
+
+    // Re-entry starts the child over
+    require(runtime.setVariable("done", Value(false)).isOk(), "clear done failed");
+    clockPtr->advance(1);
+    runtime.tick();
+    require(runtime.currentState() == 2 && worker->isRunning() && worker->currentState() == 1,
+            "re-entry should restart the child from its initial state");
+    pass("nested_child_runs_under_parent_state");
+}
+
+void testValueInlineAndSharedStorage() {
+    require(sizeof(Value) == 16, "value should be 16 bytes");
+
+    const Value tag("running");
+    require(!tag.isShared() && tag.str() == "running", "short strings should be inline");
+    const Value copy = tag;
+    require(copy == tag && copy.get<std::string>() == "running", "inline copy should compare equal");
+
+    const std::string longText(64, 'x');
+    const Value big(longText);
+    require(big.isShared() && big.str() == longText, "long strings should use a shared blob");
+    Value shared = big;
+    require(shared.str().data() == big.str().data(), "copies of a long string should share the blob");
+    require(shared == Value(longText), "blob equality should compare contents");
+    Value moved = std::move(shared);
+    require(shared.isVoid() && moved.str() == longText, "move should leave the source void");
+    moved = Value(int32_t{7});
+    require(big.str() == longText && moved.toInt() == 7, "releasing a copy should keep the blob alive");
+
+    const std::vector<uint8_t> raw = {1, 2, 3};
+    const Value bin(raw);
+    require(!bin.isShared() && bin.bytes().toVector() == raw, "small binaries should be inline");
+    require(Value(std::vector<uint8_t>(40, 9)).bytes().size == 40, "large binaries should round-trip");
+
+    require(Value(1.5f) == Value(1.5f) && Value(int32_t{1}) != Value(int64_t{1}), "scalars compare by type and value");
+    require(!Value(int32_t{1}).tryGet<float>(), "tryGet should reject other types");
+    pass("value_inline_and_shared_storage");
+}
+
+void testVariableStoreDenseColumns() {
+    VariableStore store;
+    store.addVariable(VariableSpec(70, "late", ValueType::Int32, VariableDirection::Output, Value(int32_t{0})));
+    store.addVariable(VariableSpec(1, "in", ValueType::Bool, VariableDirection::Input, Value(false)));
+    store.addVariable(VariableSpec(3, "mid", ValueType::Int32, VariableDirection::Internal, Value(int32_t{0})));
+    store.addVariable(VariableSpec(2, "out", ValueType::Int32, VariableDirection::Output, Value(int32_t{0})));
+
+    require(store.size() == 4 && !store.get(0) && !store.get(69), "gaps in the id range should stay empty");
+    const auto& outs = store.outputs();
+    require(outs.size() == 2 && outs[0]->id() == 2 && outs[1]->id() == 70, "direction views should be in id order");
+    require(store.inputs().size() == 1 && store.internals().size() == 1 && store.all().size() == 4,
+            "every variable should land in one direction view");
+
+    require(!store.setValue(1, Value(true)), "code should not write inputs");
+    require(!store.setExternalValue(2, Value(int32_t{1})), "external writes should not reach outputs");
+    require(store.setValue(70, Value(int32_t{5})) && store.setExternalValue("in", Value(true)),
+            "writes by id and name should apply");
+    std::vector<VariableId> changed;
+    store.forEachChanged([&](const Variable& var) { changed.push_back(var.id()); });
+    require(changed == std::vector<VariableId>({1, 70}), "changed scan should visit set bits in id order");
+    require(store.get(70)->previousValue() == Value(int32_t{0}), "previous value should be kept");
+    store.clearAllChanged();
+    require(store.getChanged().empty() && !store.get(1)->hasChanged(), "clearAllChanged should reset the bitset");
+
+    VariableStore moved;
+    std::swap(moved, store);
+    const Variable* late = moved.getByName("late");
+    require(late && late->value() == Value(int32_t{5}) && store.empty(), "swap should move the columns");
+    require(moved.setValue(3, Value(int32_t{9})) && moved.get(3)->value().toInt() == 9,
+            "views of a moved store should read its columns");
+    pass("variable_store_dense_columns");
+}
+
+void testCheckpointRestoresTheWholeRun() {
+    Automata automata;
+    automata.config.name = "checkpoint-smoke";
+    automata.addVariable(VariableSpec(1, "level", ValueType::Int32, VariableDirection::Input, Value(0)));
+    automata.addState(State(1, "Choose"));
+    automata.addState(State(2, "Left"));
+    automata.addState(State(3, "Right"));
+    automata.initialState = 1;
+    Transition left(1, "left", 1, 2);
+    left.type = TransitionType::Probabilistic;
+    left.probConfig.weight = 50;
+    automata.addTransition(left);
+    Transition right(2, "right", 1, 3);
+    right.type = TransitionType::Probabilistic;
+    right.probConfig.weight = 50;
+    automata.addTransition(right);
+    for (TransitionId id : {TransitionId{3}, TransitionId{4}}) {
+        Transition back(id, "back" + std::to_string(id), static_cast<StateId>(id - 1), 1);
+        back.type = TransitionType::Timed;
+        back.timedConfig.mode = TimedMode::After;
+        back.timedConfig.delayMs = id == 3 ? 300 : 500;
+        back.timedConfig.jitterMs = 100;  // Draws from the random source too
+        automata.addTransition(back);
+    }
+
+    auto clock = std::make_unique<ManualClock>();
+    ManualClock* clockPtr = clock.get();
+    Runtime runtime(std::move(clock), std::make_unique<StdRandomSource>(9),
+                    std::make_unique<CountingScriptEngine>());
+    require(runtime.load(automata).isOk(), "load failed");
+    require(runtime.start().isOk(), "start failed");
+    auto run = [&](int ticks) {
+        std::vector<StateId> states;
+        for (int i = 0; i < ticks; ++i) {
+            clockPtr->advance(50);
+            runtime.tick();
+            states.push_back(runtime.currentState());
+        }
+        return states;
+    };
+    run(37);
+    require(runtime.setInput("level", Value(7)).isOk(), "set level failed");
+
+    auto taken = runtime.checkpoint();
+    require(taken.isOk(), "checkpoint failed: " + taken.error());
+    const RuntimeCheckpoint checkpoint = taken.value();
+    const auto pendingTimer = runtime.msUntilNextTimer();
+    const uint64_t ticks = runtime.context().tickCount;
+    const size_t randomBytes = StdRandomSource(9).saveState().size();
+    require(checkpoint.bytes.size() < 256 + randomBytes, "checkpoint should be compact besides the generator state");
+
+    const auto first = run(80);
+    require(runtime.setInput("level", Value(99)).isOk(), "set level failed");
+    clockPtr->advance(12345);  // Restores onto any clock
+
+    auto corrupt = checkpoint;
+    corrupt.bytes.resize(corrupt.bytes.size() - 3);
+    require(runtime.restoreCheckpoint(corrupt).isError(), "a truncated checkpoint should be refused");
+    require(runtime.context().variables.getValue("level") == Value(99), "a refused checkpoint changes nothing");
+
+    auto restored = runtime.restoreCheckpoint(checkpoint);
+    require(restored.isOk(), "restore failed: " + restored.error());
+    require(runtime.isRunning() && runtime.context().tickCount == ticks, "counters should come back");
+    require(runtime.context().variables.getValue("level") == Value(7), "variables should come back");
+    require(runtime.msUntilNextTimer() == pendingTimer, "timers should keep their remaining time");
+    require(run(80) == first, "the run should continue exactly as before, random draws included");
+
+    CheckpointRing ring(2);
+    for (Timestamp at : {Timestamp{10}, Timestamp{20}, Timestamp{30}}) {
+        RuntimeCheckpoint entry;
+        entry.at = at;
+        ring.push(entry);
+    }
+    require(ring.size() == 2 && ring.nearest(25) && ring.nearest(25)->at == 20 && !ring.nearest(15),
+            "ring should keep the newest and find the nearest earlier checkpoint");
+    ring.dropAfter(20);
+    require(ring.size() == 1 && ring.entries().back().at == 20, "dropAfter should forget later checkpoints");
+
+    pass("checkpoint_restores_the_whole_run");
+}
+
+void testRandomStateRestoresAfterManyDraws() {
+    StdRandomSource random(3);
+    for (int i = 0; i < 5000000; ++i) {
+        random.random();
+    }
+    const auto saved = random.saveState();
+    require(saved.size() > 16, "the generator state should be saved, not just the draw count");
+    std::vector<double> next;
+    for (int i = 0; i < 16; ++i) {
+        next.push_back(random.random());
+    }
+
+    StdRandomSource restored(11);
+    require(restored.restoreState(saved.data(), saved.size()), "restore failed");
+    for (double expected : next) {
+        require(restored.random() == expected, "the sequence should continue where it was saved");
+    }
+    require(restored.saveState().size() == saved.size(), "a restored source should save the same layout");
+
+    // Seed-and-count states from before the full state was saved still replay
+    std::vector<uint8_t> legacy(saved.begin(), saved.begin() + 16);
+    StdRandomSource replayed(11);
+    require(replayed.restoreState(legacy.data(), legacy.size()) && replayed.random() == next[0],
+            "a 16-byte state should restore by replaying the draws");
+    pass("random_state_restores_after_many_draws");
+}
+
+void testChangeJournalPublishesOncePerTick() {
+    VariableStore store;
+    store.addVariable(VariableSpec(4, "b", ValueType::Int32, VariableDirection::Output, Value(int32_t{0})));
+    store.addVariable(VariableSpec(2, "a", ValueType::Int32, VariableDirection::Output, Value(int32_t{0})));
+    store.setValue(4, Value(int32_t{1}));
+    store.setValue(2, Value(int32_t{1}));
+    store.setValue(4, Value(int32_t{0}));
+    store.clearAllChanged();
+    require(store.changeJournal() == std::vector<VariableId>({4, 2}), "journal should keep first-change order once per id");
+    require(store.journalReverted(4) && !store.journalReverted(2), "a write back to the base value should read as reverted");
+    store.clearJournal();
+    require(store.changeJournal().empty() && !store.journalReverted(4), "clearJournal should start a new window");
+
+    Automata automata = makeLevelAutomata();
+    automata.addVariable(VariableSpec(3, "out", ValueType::Int32, VariableDirection::Output, Value(int32_t{0})));
+    automata.addVariable(VariableSpec(4, "blink", ValueType::Int32, VariableDirection::Output, Value(int32_t{0})));
+    automata.states.at(1).body = guard("out = level blink = 1 blink = 0");
+    automata.states.at(1).body.kind = CodeKind::Statement;
+    auto clock = std::make_unique<ManualClock>();
+    ManualClock* clockPtr = clock.get();
+    Runtime runtime(std::move(clock), std::make_unique<StdRandomSource>(1), std::make_unique<SimpleScriptEngine>());
+    std::vector<std::vector<std::string>> batches;
+    uint32_t perWrite = 0;
+    RuntimeCallbacks callbacks;
+    callbacks.onOutputChange = [&](const Variable&) { ++perWrite; };
+    callbacks.onOutputBatch = [&](const std::vector<const Variable*>& outputs) {
+        std::vector<std::string> names;
+        for (const Variable* var : outputs) {
+            names.push_back(var->name());
+        }
+        batches.push_back(names);
+    };
+    runtime.setCallbacks(callbacks);
+    require(runtime.load(automata).isOk() && runtime.start().isOk(), "load/start failed");
+    require(runtime.setInput("level", Value(3)).isOk(), "set level failed");
+    clockPtr->advance(1);
+    runtime.tick();
+    require(batches.size() == 1 && batches[0] == std::vector<std::string>({"out", "blink"}),
+            "one batch per tick with each changed output once");
+    require(perWrite == 3, "per-write callbacks should still see every change");
+
+    runtime.setSuppressOutputFlips(true);
+    require(runtime.setInput("level", Value(4)).isOk(), "set level failed");
+    clockPtr->advance(1);
+    runtime.tick();
+    require(batches.size() == 2 && batches[1] == std::vector<std::string>({"out"}),
+            "an output back at its pre-tick value should be suppressed");
+    clockPtr->advance(1);
+    runtime.tick();
+    require(batches.size() == 2, "a tick where only flips happen should publish nothing");
+
+    protocol::OutputBatchMessage frame;
+    frame.runId = 7;
+    frame.timestamp = 99;
+    frame.outputs.push_back(VariableUpdate{3, Value(int32_t{4})});
+    frame.outputs.push_back(VariableUpdate{4, Value(true)});
+    const auto bytes = frame.serialize();
+    require(bytes.size() == frame.serializedSize(), "serializedSize should be exact");
+    auto decoded = protocol::MessageFactory::deserialize(bytes.data(), bytes.size());
+    require(decoded && decoded->type() == protocol::MessageType::OutputBatch, "output batch should decode");
+    const auto& back = static_cast<const protocol::OutputBatchMessage&>(*decoded);
+    require(back.runId == 7 && back.outputs.size() == 2 && back.outputs[1].id == 4 &&
+                back.outputs[1].value == Value(true),
+            "output batch should round-trip");
+    pass("change_journal_publishes_once_per_tick");
+}
+
+void testTransitionEvaluatorsSpecializedAtLoad() {
+    Automata automata;
+    automata.config.name = "evaluator-smoke";
+    automata.addVariable(VariableSpec(1, "a", ValueType::Bool, VariableDirection::Input, Value(false)));
+    automata.addVariable(VariableSpec(2, "b", ValueType::Bool, VariableDirection::Input, Value(false)));
+    automata.addVariable(VariableSpec(3, "temp", ValueType::Float64, VariableDirection::Input, Value(0.0)));
+    automata.addVariable(VariableSpec(4, "mode", ValueType::String, VariableDirection::Input, Value("idle")));
+    for (StateId id = 1; id <= 5; ++id) {
+        automata.addState(State(id, "S" + std::to_string(id)));
+    }
+    automata.initialState = 1;
+    auto trigger = [](const std::string& signal, EventTrigger type) {
+        SignalTrigger t;
+        t.signalName = signal;
+        t.triggerType = type;
+        return t;
+    };
+    Transition anyRise(1, "any_rise", 1, 2);
+    anyRise.type = TransitionType::Event;
+    anyRise.eventConfig.triggers = {trigger("a", EventTrigger::OnRise), trigger("b", EventTrigger::OnRise)};
+    automata.addTransition(anyRise);
+    Transition allChange(2, "all_change", 2, 3);
+    allChange.type = TransitionType::Event;
+    allChange.eventConfig.requireAll = true;
+    allChange.eventConfig.triggers = {trigger("a", EventTrigger::OnChange), trigger("b", EventTrigger::OnChange)};
+    automata.addTransition(allChange);
+    Transition ghost(3, "ghost", 3, 1);
+    ghost.type = TransitionType::Event;
+    ghost.eventConfig.triggers = {trigger("missing", EventTrigger::OnChange)};
+    automata.addTransition(ghost);
+    Transition hot(4, "hot", 3, 4);
+    hot.type = TransitionType::Event;
+    hot.eventConfig.triggers = {trigger("temp", EventTrigger::OnThreshold)};
+    hot.eventConfig.triggers[0].threshold = ThresholdConfig{CompareOp::Gt, Value(30.0), false};
+    automata.addTransition(hot);
+    Transition go(5, "go", 4, 5);
+    go.type = TransitionType::Event;
+    go.eventConfig.triggers = {trigger("mode", EventTrigger::OnMatch)};
+    go.eventConfig.triggers[0].pattern = "go";
+    automata.addTransition(go);
+    Transition window(6, "window", 5, 1);
+    window.type = TransitionType::Timed;
+    window.timedConfig.mode = TimedMode::Window;
+    window.timedConfig.delayMs = 100;
+    window.timedConfig.windowEndMs = 200;
+    automata.addTransition(window);
+
+    const auto errors = automata.validate();
+    require(errors.size() == 1 && errors[0].find("unknown signal missing") != std::string::npos,
+            "an unknown event signal should fail validation at load");
+
+    CompiledAutomata compiled;
+    compiled.build(automata);
+    const auto& ghostEntry = compiled.transitionAt(compiled.transitionIndex(3));
+    require(compiled.triggers(ghostEntry).size() == 1 &&
+                compiled.triggers(ghostEntry)[0].signal == INVALID_VARIABLE,
+            "an unknown signal should compile to no variable");
+    const auto& hotEntry = compiled.transitionAt(compiled.transitionIndex(4));
+    require(compiled.triggers(hotEntry)[0].threshold == 30.0, "threshold constants should be converted once");
+    const auto& anyEntry = compiled.transitionAt(compiled.transitionIndex(1));
+    require(compiled.triggers(anyEntry)[1].signal == 2 && anyEntry.evaluate != ghostEntry.evaluate,
+            "signals should resolve to ids and evaluators differ per trigger join");
+
+    ManualClock clock;
+    StdRandomSource random(1);
+    CountingScriptEngine script;
+    TimerManager timers(&clock);
+    ExecutionContext context;
+    for (const auto& spec : automata.variables) {
+        context.variables.addVariable(spec);
+    }
+    context.tickCount = 10;
+    TransitionResolver resolver(&script, &random, &timers, &context.variables, &context);
+    resolver.reserve(compiled.maxGroupSize());
+    auto firesFrom = [&](StateId state) {
+        const Transition* t = resolver.resolve(compiled, state);
+        context.variables.clearAllChanged();
+        return t ? t->id : TransitionId{0};
+    };
+
+    context.variables.setExternalValue("b", Value(true));
+    require(firesFrom(1) == 1, "any-of should fire on one rising trigger");
+    context.variables.setExternalValue("a", Value(true));
+    require(firesFrom(2) == 0, "all-of should wait for every trigger");
+    context.variables.setExternalValue("a", Value(false));
+    context.variables.setExternalValue("b", Value(false));
+    require(firesFrom(2) == 2, "all-of should fire once every signal changed");
+    context.variables.setExternalValue("temp", Value(25.0));
+    require(firesFrom(3) == 0, "below the threshold nothing fires");
+    context.variables.setExternalValue("temp", Value(31.0));
+    require(firesFrom(3) == 4, "crossing the threshold should fire");
+    context.variables.setExternalValue("mode", Value("stop"));
+    require(firesFrom(4) == 0, "a different string should not match");
+    context.variables.setExternalValue("mode", Value("go"));
+    require(firesFrom(4) == 5, "the pattern should match");
+    context.stateEntryTime = clock.now();
+    clock.advance(50);
+    require(firesFrom(5) == 0, "before the window nothing fires");
+    clock.advance(100);
+    require(firesFrom(5) == 6, "inside the window the transition fires");
+    clock.advance(100);
+    require(firesFrom(5) == 0, "after the window nothing fires");
+    require(script.conditions == 0, "no guard means no script call");
+    pass("transition_evaluators_specialized_at_load");
+}
+
+void testFleetResolvesInstancesInBatches() {
+    Automata automata;
+    automata.config.name = "fleet-smoke";
+    automata.addVariable(VariableSpec(1, "level", ValueType::Int32, VariableDirection::Input, Value(0)));
+    automata.addState(State(1, "Idle"));
+    automata.addState(State(2, "High"));
+    automata.addState(State(3, "Cool"));
+    automata.addState(State(4, "Done"));
+    automata.initialState = 1;
+    Transition high(1, "high", 1, 2);
+    high.type = TransitionType::Classic;
+    high.classicConfig.condition = guard("level > 10");
+    automata.addTransition(high);
+    Transition low(2, "low", 2, 3);
+    low.type = TransitionType::Event;
+    SignalTrigger below;
+    below.signalName = "level";
+    below.triggerType = EventTrigger::OnThreshold;
+    below.threshold = ThresholdConfig{CompareOp::Lt, Value(5), false};
+    low.eventConfig.triggers = {below};
+    automata.addTransition(low);
+    Transition rest(3, "rest", 3, 1);
+    rest.type = TransitionType::Timed;
+    rest.timedConfig.mode = TimedMode::After;
+    rest.timedConfig.delayMs = 50;
+    automata.addTransition(rest);
+    Transition done(4, "done", 3, 4);
+    done.type = TransitionType::Classic;
+    done.classicConfig.condition = guard("level >= 20");
+    automata.addTransition(done);
+
+    // Instances see different inputs, so they spread over the states; a
+    // few of them are replayed on their own Runtime for comparison.
+    constexpr size_t kInstances = 600;
+    auto levelAt = [](size_t instance, int tick) { return static_cast<int32_t>((instance * 7 + tick * (2 + instance % 3)) % 23); };
+    Fleet fleet;
+    require(fleet.load(automata, kInstances).isOk(), "fleet load failed");
+    require(!fleet.usesScripts(), "native guards and triggers need no script engine");
+    require(fleet.start(1000).isOk(), "fleet start failed");
+
+    const std::vector<size_t> sampled = {0, 1, 17, 299, 599};
+    std::vector<std::unique_ptr<Runtime>> runtimes;
+    std::vector<ManualClock*> clocks;
+    for (size_t i = 0; i < sampled.size(); ++i) {
+        auto clock = std::make_unique<ManualClock>();
+        clocks.push_back(clock.get());
+        runtimes.push_back(std::make_unique<Runtime>(std::move(clock), std::make_unique<StdRandomSource>(1),
+                                                     std::make_unique<CountingScriptEngine>()));
+        require(runtimes.back()->load(automata).isOk() && runtimes.back()->start().isOk(), "runtime start failed");
+    }
+
+    size_t changes = 0;
+    fleet.onStateChange([&](size_t, StateId, StateId, TransitionId) { ++changes; });
+    Timestamp now = 1000;
+    for (int tick = 1; tick <= 60; ++tick) {
+        now += 10;
+        for (size_t i = 0; i < kInstances; ++i) {
+            fleet.setValue(i, 1, Value(levelAt(i, tick)));
+        }
+        fleet.tick(now);
+        for (size_t k = 0; k < sampled.size(); ++k) {
+            require(runtimes[k]->setInput("level", Value(levelAt(sampled[k], tick))).isOk(), "set level failed");
+            clocks[k]->advance(10);
+            runtimes[k]->tick();
+            require(fleet.state(sampled[k]) == runtimes[k]->currentState(),
+                    "a fleet instance should follow the same states as its own runtime");
+            require(fleet.running(sampled[k]) == runtimes[k]->isRunning(), "terminal states should stop both");
+        }
+    }
+    std::array<size_t, 5> perState{};
+    for (size_t i = 0; i < kInstances; ++i) {
+        ++perState[fleet.state(i)];
+    }
+    require(perState[4] > 0 && perState[4] < kInstances, "instances should diverge by value");
+    require(fleet.runningCount() == kInstances - perState[4], "instances in Done should have stopped");
+    require(changes == fleet.stats().transitions && changes > kInstances, "every fired transition is reported");
+    require(fleet.stats().scriptCalls == 0, "nothing should have run on a script engine");
+    require(!fleet.setValue(0, 1, Value("high")) && !fleet.setValue(kInstances, 1, Value(3)),
+            "strings and unknown instances should be refused");
+
+    // A guard outside the native subset runs on a per-instance engine.
+    Automata scripted = makeLevelAutomata();
+    Fleet mixed;
+    require(mixed.load(scripted, 8).isError(), "a script guard without an engine should fail to load");
+    require(mixed.load(scripted, 8, std::make_unique<CountingScriptEngine>()).isOk(), "mixed load failed");
+    require(mixed.usesScripts() && mixed.start(1000).isOk(), "mixed start failed");
+    mixed.setValue(3, 1, Value(11));
+    require(mixed.tick(1010) == 1 && mixed.state(3) == 2 && mixed.state(2) == 1,
+            "the native guard should fire for the raised instance only");
+    require(mixed.stats().scriptInstances == 8 && mixed.stats().scriptCalls == 8,
+            "the opaque guard shares the group, so every instance asks its own engine once");
+
+    Automata jittered = automata;
+    jittered.transitions.at(3).timedConfig.jitterMs = 5;
+    require(Fleet().load(jittered, 4).isError(), "timed jitter is not modelled and should be refused");
+    pass("fleet_resolves_instances_in_batches");
+}
+
+void testStaticAnalysisFindsGraphDefects() {
+    Automata automata = makeLevelAutomata();
+    automata.transitions.clear();
+    for (const char* name : {"Stuck", "Orphan", "LoopA", "LoopB", "End"}) {
+        automata.addState(State(automata.nextStateId(), name));
+    }
+    auto add = [&](TransitionId id, StateId from, StateId to, TransitionType type, const char* condition,
+                   uint8_t priority = 0) -> Transition& {
+        Transition t(id, "t" + std::to_string(id), from, to);
+        t.type = type;
+        t.priority = priority;
+        if (type == TransitionType::Classic) {
+            t.classicConfig.condition = guard(condition);
+        }
+        automata.addTransition(t);
+        return automata.transitions.at(id);
+    };
+    add(1, 1, 2, TransitionType::Classic, "level > 10");
+    add(2, 1, 7, TransitionType::Classic, "level > 5");   // Overlaps t1
+    add(3, 1, 2, TransitionType::Classic, "level < 6");   // Disjoint from t2 for an integer
+    add(4, 1, 3, TransitionType::Classic, "mode == 1", 1);
+    Transition& window = add(5, 1, 2, TransitionType::Timed, "", 2);
+    window.timedConfig.mode = TimedMode::Window;
+    window.timedConfig.delayMs = 100;
+    window.timedConfig.windowEndMs = 50;
+    add(6, 3, 2, TransitionType::Classic, "false");       // Stuck can never leave
+    add(7, 2, 5, TransitionType::Immediate, "");
+    add(8, 2, 7, TransitionType::Classic, "level > 1", 1);  // Behind an immediate
+    add(9, 5, 6, TransitionType::Timed, "").timedConfig.delayMs = 10;
+    add(10, 6, 5, TransitionType::Timed, "").timedConfig.delayMs = 10;
+    add(11, 5, 7, TransitionType::Classic, "level == 3", 1);  // Held back by t9
+    add(12, 4, 7, TransitionType::Immediate, "");
+    require(automata.validate().empty(), "analysis fixture should validate");
+
+    const AutomataAnalysis analysis = analyzeAutomata(automata);
+    require(analysis.states == 7 && analysis.reachableStates == 6 && analysis.components == 5,
+            "Orphan is the one unreachable state; LoopA and LoopB form one component");
+    auto has = [&](FindingKind kind, StateId state, TransitionId transition) {
+        return std::any_of(analysis.findings.begin(), analysis.findings.end(), [&](const AnalysisFinding& f) {
+            return f.kind == kind && f.state == state && (transition == INVALID_TRANSITION || f.transition == transition);
+        });
+    };
+    require(analysis.count(FindingKind::UnreachableState) == 1 && has(FindingKind::UnreachableState, 4, INVALID_TRANSITION),
+            "Orphan should be unreachable");
+    require(analysis.count(FindingKind::DeadState) == 1 && has(FindingKind::DeadState, 3, INVALID_TRANSITION),
+            "Stuck only has a constant-false way out");
+    require(analysis.count(FindingKind::Trap) == 1 && has(FindingKind::Trap, 5, INVALID_TRANSITION),
+            "LoopA and LoopB never lead anywhere else");
+    require(analysis.count(FindingKind::UnreachableTransition) == 4 && has(FindingKind::UnreachableTransition, 1, 5) &&
+                has(FindingKind::UnreachableTransition, 3, 6) && has(FindingKind::UnreachableTransition, 2, 8) &&
+                has(FindingKind::UnreachableTransition, 5, 11),
+            "empty window, false guard, shadowed and held-back transitions are unreachable");
+    const AnalysisFinding& overlap = analysis.findings.back();
+    require(analysis.count(FindingKind::Nondeterminism) == 1 && overlap.transition + overlap.other == 3,
+            "only t1 and t2 overlap, in whichever order resolution takes them");
+
+    AnalysisCache cache;
+    CompiledAutomata compiled;
+    compiled.build(automata);
+    const auto first = cache.analyze(automata, compiled);
+    require(cache.analyze(automata, compiled) == first && cache.hits() == 1 && cache.misses() == 1,
+            "an unchanged automata should be answered from the cache");
+    automata.transitions.at(2).classicConfig.condition = guard("level > 5 and level < 10");
+    compiled.build(automata);
+    const auto second = cache.analyze(automata, compiled);
+    require(second != first && second->hash != first->hash && second->count(FindingKind::Nondeterminism) == 0,
+            "a changed guard should be analyzed again");
+
+    // A generated graph: a ring of states with disjoint guards, one exit
+    Automata large;
+    large.addVariable(VariableSpec(1, "level", ValueType::Int32, VariableDirection::Input, Value(0)));
+    constexpr StateId kStates = 10000;
+    for (StateId id = 1; id <= kStates + 1; ++id) {
+        large.addState(State(id, "S" + std::to_string(id)));
+    }
+    large.initialState = 1;
+    TransitionId next = 1;
+    for (StateId id = 1; id < kStates; ++id) {
+        Transition up(next, "up" + std::to_string(next), id, id + 1);
+        up.classicConfig.condition = guard("level > 10");
+        large.addTransition(up);
+        ++next;
+        Transition back(next, "back" + std::to_string(next), id, (id * 7) % kStates + 1);
+        back.classicConfig.condition = guard("level < 5");
+        large.addTransition(back);
+        ++next;
+        Transition stay(next, "stay" + std::to_string(next), id, id);
+        stay.type = TransitionType::Timed;
+        stay.timedConfig.delayMs = 100;
+        stay.priority = 1;
+        large.addTransition(stay);
+        ++next;
+    }
+    AnalysisOptions serial;
+    serial.workers = 1;
+    AnalysisOptions parallel;
+    parallel.workers = 4;
+    parallel.parallelTransitions = 1;
+    const AutomataAnalysis one = analyzeAutomata(large, serial);
+    const AutomataAnalysis many = analyzeAutomata(large, parallel);
+    require(one.findings.size() == 1 && one.findings[0].kind == FindingKind::UnreachableState &&
+                one.findings[0].state == kStates + 1,
+            "the generated ring should only report its detached state");
+    require(many.findings.size() == one.findings.size() && many.reachableStates == kStates &&
+                many.components == one.components && many.hash == one.hash,
+            "the pool should not change the analysis");
+    pass("static_analysis_finds_graph_defects");
+}
+
+int main() {
+    testGuardDependencyAnalysis();
+    testReactiveModeSkipsUnchangedGuards();
+    testPollingModeEvaluatesEveryTick();
+    testTimerHeapOrderingAndCancel();
+    testTimerHeapMatchesReference();
+    testTickSchedulerSlotsAndDeadlines();
+    testTickPacerFollowsActivityBatteryAndCost();
+    testRuntimeReportsNextTimer();
+    testRuntimeHotSwapKeepsMatchingStateAndValues();
+    testSpareScriptEnginesAndResetInPlace();
+    testWorkStealingPoolRunsEveryTask();
+    testSpscRingPreservesOrderAcrossThreads();
+    testLoadAutomataRoundTripsChunkFields();
+    testPooledMessagesReuseBlocksAndWriter();
+    testByteWriterBigEndianAndSizes();
+    testTelemetryDeltaTrackerKeyframeThenDeltas();
+    testSymbolTableRoundtripAndIdOnlyOutput();
+    testCompactValueEncodingIsSmallerAndLossless();
+    testTelemetryLogHubRingAcrossProducers();
+    testTelemetryLogHubAsyncStreams();
+    testTickProfileHistogramsAndPhases();
+    testScriptCostPerCodeBlock();
+    testGcPolicyKeepsFullCollectsOffTheTickPath();
+    testLuaArenaPoolsAndBudget();
+    testNativeGuardsSkipTheScript();
+    testScriptVmRunsCompiledBlocks();
+    testFlashRuntimeRunsFromTables();
+    testSerialRingParsesFramesInPlace();
+    testFrameBatcherPacksUpToMtu();
+    testComponentMethodsResolveOnceAndCallByIndex();
+    testStaticComponentCallsThroughItsTable();
+    testActuationBufferCoalescesPerTick();
+    testDeployCompilerLowersToBytecode();
+    testDeployArtifactKeepsGuardKinds();
+    testDeployArtifactKeepsTelemetryPolicy();
+    testNestedChildRunsUnderParentState();
+    testValueInlineAndSharedStorage();
+    testVariableStoreDenseColumns();
+    testCheckpointRestoresTheWholeRun();
+    testRandomStateRestoresAfterManyDraws();
+    testChangeJournalPublishesOncePerTick();
+    testTransitionEvaluatorsSpecializedAtLoad();
+    testFleetResolvesInstancesInBatches();
+    testStaticAnalysisFindsGraphDefects();
+    return 0;
+}